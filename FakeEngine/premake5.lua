@@ -62,6 +62,28 @@ project "FakeEngine"
 		"%{librarydir.assimp}"
 		}
 		
+	filter "options:vulkan"
+		defines "FAKE_RENDERER_VULKAN"
+		
+		includedirs
+			{
+			"%{includedir.shaderc}"
+			}
+			
+		links
+			{
+			"%{librarydir.shaderc}",
+			"%{librarydir.shaderc_util}",
+			"%{librarydir.glslang}",
+			"%{librarydir.glslang_MachineIndependent}",
+			"%{librarydir.glslang_SPIRV}",
+			"%{librarydir.glslang_OGLCompiler}",
+			"%{librarydir.glslang_OSDependent}",
+			"%{librarydir.glslang_GenericCodeGen}",
+			"%{librarydir.SPIRV_Tools}",
+			"%{librarydir.SPIRV_Tools_opt}"
+			}
+			
 	filter "system:macosx"
 		systemversion "latest"
 		
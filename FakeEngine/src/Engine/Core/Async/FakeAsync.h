@@ -0,0 +1,372 @@
+/*****************************************************************
+ * \file   FakeAsync.h
+ * \brief  
+ * 
+ * \author Can Karka
+ * \date   February 2021
+ * 
+ * Copyright (C) 2021 Can Karka
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *********************************************************************/
+
+#pragma once
+
+#include "Engine/Core/Async/FakeTask.h"
+
+#ifdef FAKE_HAS_COROUTINES
+
+#include <thread>
+#include <cstring>
+
+#include "Engine/Core/FakeApplication.h"
+#include "Engine/Core/FakeVirtualFileSystem.h"
+#include "Engine/Core/Jobs/FakeJobSystem.h"
+#include "Engine/Renderer/FakeImage.h"
+#include "Engine/Renderer/FakeTexture2D.h"
+#include "Engine/Renderer/FakeShader.h"
+
+namespace FakeTaskDetail
+	{
+	template<typename T>
+	using FakeResultSlot = std::optional<std::conditional_t<std::is_void_v<T>, bool, T>>;
+
+	struct FakeJobSystemAwaiter
+		{
+		bool await_ready() const noexcept
+			{
+			return false;
+			}
+
+		void await_suspend(std::coroutine_handle<> handle) const
+			{
+			FakeJobSystem::Run([handle]() { handle.resume(); });
+			}
+
+		void await_resume() const noexcept
+			{
+			}
+		};
+
+	struct FakeMainThreadAwaiter
+		{
+		bool await_ready() const noexcept
+			{
+			return FakeJobSystem::GetThreadIndex() == 0;
+			}
+
+		void await_suspend(std::coroutine_handle<> handle) const
+			{
+			FakeApplication::Get().SubmitToMainThread([handle]() { handle.resume(); });
+			}
+
+		void await_resume() const noexcept
+			{
+			}
+		};
+
+	struct FakeWhenAllLatch
+		{
+		// One extra reference is held by the awaiter until all tasks have been started
+		std::atomic<uint32> Count;
+		std::coroutine_handle<> Continuation;
+
+		explicit FakeWhenAllLatch(uint32 count)
+			: Count(count + 1)
+			{
+			}
+
+		bool Release()
+			{
+			return Count.fetch_sub(1, std::memory_order_acq_rel) == 1;
+			}
+		};
+
+	template<typename T>
+	inline FakeDetachedTask fake_when_all_item(FakeTask<T> &task, FakeResultSlot<T> &result, FakeWhenAllLatch &latch)
+		{
+		if constexpr (std::is_void_v<T>)
+			{
+			co_await task;
+			result.emplace(true);
+			}
+		else
+			{
+			result.emplace(co_await task);
+			}
+
+		if (latch.Release())
+			latch.Continuation.resume();
+		}
+
+	template<typename T>
+	struct FakeWhenAllAwaiter
+		{
+		std::vector<FakeTask<T>> &Tasks;
+		std::vector<FakeResultSlot<T>> &Results;
+		FakeWhenAllLatch Latch;
+
+		FakeWhenAllAwaiter(std::vector<FakeTask<T>> &tasks, std::vector<FakeResultSlot<T>> &results)
+			: Tasks(tasks), Results(results), Latch((uint32)tasks.size())
+			{
+			}
+
+		bool await_ready() const noexcept
+			{
+			return Tasks.empty();
+			}
+
+		bool await_suspend(std::coroutine_handle<> handle)
+			{
+			Latch.Continuation = handle;
+			for (size_t i = 0; i < Tasks.size(); ++i)
+				fake_when_all_item<T>(Tasks[i], Results[i], Latch);
+
+			// Keep running if every task already finished synchronously
+			return !Latch.Release();
+			}
+
+		void await_resume() const noexcept
+			{
+			}
+		};
+
+	template<typename T>
+	inline FakeDetachedTask fake_sync_wait_item(FakeTask<T> &task, FakeResultSlot<T> &result, FakeJobCounter &counter)
+		{
+		if constexpr (std::is_void_v<T>)
+			{
+			co_await task;
+			result.emplace(true);
+			}
+		else
+			{
+			result.emplace(co_await task);
+			}
+
+		counter.Value.fetch_sub(1, std::memory_order_acq_rel);
+		}
+
+	template<typename T>
+	inline FakeDetachedTask fake_spawn(FakeTask<T> task)
+		{
+		co_await std::move(task);
+		}
+	}
+
+/**
+ *
+ * Coroutine based asynchronous loading on top of the FakeJobSystem.
+ *
+ * File reads and image decoding run on the job system, everything that touches the renderer resumes on the main thread.
+ * Many loads can be started at once with WhenAll, so I/O of one asset overlaps with the decoding of another.
+ *
+ * @attention Only available if the including project is compiled with coroutine support (see FAKE_HAS_COROUTINES).
+ *
+ * ### Usage
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~.cpp
+ * FakeTask<> LoadLevel()
+ *     {
+ *     std::vector<FakeTask<FakeRef<FakeTexture2D>>> loads;
+ *     loads.push_back(FakeAsync::LoadTexture2D("assets/textures/Logo.png"));
+ *     loads.push_back(FakeAsync::LoadTexture2D("assets/textures/Checkerboard.png"));
+ *
+ *     std::vector<FakeRef<FakeTexture2D>> textures = co_await FakeAsync::WhenAll(std::move(loads));
+ *     FakeRef<FakeShader> shader = co_await FakeAsync::LoadShader("assets/shaders/FakeTextureShader.glsl");
+ *     }
+ *
+ * // Inside FakeLayer::OnAttach
+ * FakeAsync::Spawn(LoadLevel());
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+class FakeAsync
+	{
+	public:
+
+		/**
+		 *
+		 * Continues the awaiting coroutine on a worker of the job system.
+		 *
+		 * @return Returns the awaitable.
+		 */
+		static FakeTaskDetail::FakeJobSystemAwaiter ResumeOnJobSystem()
+			{
+			return {};
+			}
+
+		/**
+		 *
+		 * Continues the awaiting coroutine on the main thread at the beginning of the next frame.
+		 * Does not suspend if the coroutine already runs on the main thread.
+		 *
+		 * @return Returns the awaitable.
+		 */
+		static FakeTaskDetail::FakeMainThreadAwaiter ResumeOnMainThread()
+			{
+			return {};
+			}
+
+		/**
+		 *
+		 * Starts a task from a regular function. The task destroys itself when it has finished.
+		 *
+		 * @param task The task to start.
+		 */
+		template<typename T>
+		static void Spawn(FakeTask<T> task)
+			{
+			FakeTaskDetail::fake_spawn<T>(std::move(task));
+			}
+
+		/**
+		 *
+		 * Runs a task to completion and blocks the calling thread.
+		 * The calling thread executes jobs (and the main thread queue if it is the main thread) while waiting.
+		 *
+		 * @param task The task to run.
+		 * @return Returns the result of the task.
+		 */
+		template<typename T>
+		static T SyncWait(FakeTask<T> task)
+			{
+			FakeJobCounter counter;
+			counter.Value = 1;
+
+			FakeTaskDetail::FakeResultSlot<T> result;
+			FakeTaskDetail::fake_sync_wait_item<T>(task, result, counter);
+
+			while (!counter.IsDone())
+				{
+				if (FakeJobSystem::HelpOnce())
+					continue;
+
+				if (FakeJobSystem::GetThreadIndex() == 0)
+					FakeApplication::Get().ExecuteMainThreadQueue();
+
+				std::this_thread::yield();
+				}
+
+			if constexpr (!std::is_void_v<T>)
+				return std::move(*result);
+			}
+
+		/**
+		 *
+		 * Starts all tasks at once and resumes when every one of them has finished.
+		 *
+		 * @param tasks The tasks to run in parallel.
+		 * @return Returns a task which produces the results in the same order as the input.
+		 */
+		template<typename T>
+		static FakeTask<std::conditional_t<std::is_void_v<T>, void, std::vector<T>>> WhenAll(std::vector<FakeTask<T>> tasks)
+			{
+			std::vector<FakeTaskDetail::FakeResultSlot<T>> results(tasks.size());
+			co_await FakeTaskDetail::FakeWhenAllAwaiter<T>(tasks, results);
+
+			if constexpr (!std::is_void_v<T>)
+				{
+				std::vector<T> values;
+				values.reserve(results.size());
+				for (auto &result : results)
+					values.push_back(std::move(*result));
+
+				co_return values;
+				}
+			}
+
+		/**
+		 *
+		 * Reads a file from the virtual file system on a worker thread.
+		 *
+		 * @param path The virtual path to the file.
+		 * @return Returns the file contents, the caller owns the data (delete[]). Data is nullptr if the file could not be read.
+		 */
+		static FakeTask<FakeAllocator> ReadFile(FakeString path)
+			{
+			co_await ResumeOnJobSystem();
+
+			int64 size = 0;
+			Byte *data = FakeVirtualFileSystem::Get()->ReadFile(path, &size);
+			co_return FakeAllocator(data, data ? (uint32)size : 0);
+			}
+
+		/**
+		 *
+		 * Reads a text file from the virtual file system on a worker thread.
+		 *
+		 * @param path The virtual path to the file.
+		 * @return Returns the file contents.
+		 */
+		static FakeTask<FakeString> ReadTextFile(FakeString path)
+			{
+			co_await ResumeOnJobSystem();
+			co_return FakeVirtualFileSystem::Get()->ReadTextFile(path);
+			}
+
+		/**
+		 *
+		 * Reads and decodes an image on a worker thread and creates the texture on the main thread.
+		 *
+		 * @param path The virtual path to the image.
+		 * @param wrap The wrapping mode of the texture.
+		 * @return Returns the texture or an empty reference if the image could not be loaded.
+		 */
+		static FakeTask<FakeRef<FakeTexture2D>> LoadTexture2D(FakeString path, FakeTextureWrap wrap = FakeTextureWrap::Clamp)
+			{
+			co_await ResumeOnJobSystem();
+
+			int64 size = 0;
+			Byte *data = FakeVirtualFileSystem::Get()->ReadFile(path, &size);
+
+			FakeImage image;
+			bool decoded = FakeImage::Decode(data, size, image);
+			delete[] data;
+
+			co_await ResumeOnMainThread();
+
+			if (!decoded)
+				{
+				FAKE_LOG_ERROR("Could not load texture %s", *path);
+				co_return FakeRef<FakeTexture2D>();
+				}
+
+			FakeRef<FakeTexture2D> texture = FakeTexture2D::Create(image.Format, image.Width, image.Height, wrap);
+			texture->Lock();
+			FakeAllocator buffer = texture->GetWriteableBuffer();
+			memcpy(buffer.Data, image.Pixels, image.Size);
+			texture->Unlock();
+
+			image.Release();
+			co_return texture;
+			}
+
+		/**
+		 *
+		 * Reads a shader source on a worker thread and creates the shader on the main thread.
+		 *
+		 * @param path The virtual path to the shader.
+		 * @return Returns the shader.
+		 */
+		static FakeTask<FakeRef<FakeShader>> LoadShader(FakeString path)
+			{
+			co_await ResumeOnJobSystem();
+
+			FakeString source = FakeVirtualFileSystem::Get()->ReadTextFile(path);
+			FakeString name = FakeVirtualFileSystem::Get()->GetFileNameFromPath(path);
+
+			co_await ResumeOnMainThread();
+			co_return FakeShader::CreateFromSource(name, source);
+			}
+	};
+
+#endif
@@ -0,0 +1,301 @@
+/*****************************************************************
+ * \file   FakeTask.h
+ * \brief  
+ * 
+ * \author Can Karka
+ * \date   February 2021
+ * 
+ * Copyright (C) 2021 Can Karka
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *********************************************************************/
+
+#pragma once
+
+#include "Engine/Core/FakeCore.h"
+
+/**
+ *
+ * Coroutines need C++20. The bundled premake only knows cppdialect "C++latest", which is C++17 on gcc and clang,
+ * so projects using them also add buildoptions "-std=c++20" there, like tests/BenchmarkTest.
+ * The engine itself is built as C++17, so everything in here is only available to translation units which enable them.
+ *
+ */
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+	#define FAKE_HAS_COROUTINES
+#endif
+
+#ifdef FAKE_HAS_COROUTINES
+
+#include <coroutine>
+#include <optional>
+#include <exception>
+
+template<typename T>
+class FakeTask;
+
+namespace FakeTaskDetail
+	{
+	struct FakeFinalAwaiter
+		{
+		bool await_ready() const noexcept
+			{
+			return false;
+			}
+
+		template<typename Promise>
+		std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept
+			{
+			// Symmetric transfer to whoever is awaiting this task
+			std::coroutine_handle<> continuation = handle.promise().Continuation;
+			return continuation ? continuation : std::noop_coroutine();
+			}
+
+		void await_resume() const noexcept
+			{
+			}
+		};
+
+	struct FakePromiseBase
+		{
+		std::coroutine_handle<> Continuation;
+
+		std::suspend_always initial_suspend() const noexcept
+			{
+			return {};
+			}
+
+		FakeFinalAwaiter final_suspend() const noexcept
+			{
+			return {};
+			}
+
+		void unhandled_exception()
+			{
+			FAKE_ASSERT(false, "Unhandled exception inside a FakeTask!");
+			std::terminate();
+			}
+		};
+
+	template<typename T>
+	struct FakePromise : public FakePromiseBase
+		{
+		std::optional<T> Value;
+
+		FakeTask<T> get_return_object() noexcept;
+
+		template<typename U>
+		void return_value(U &&value)
+			{
+			Value.emplace(std::forward<U>(value));
+			}
+		};
+
+	template<>
+	struct FakePromise<void> : public FakePromiseBase
+		{
+		FakeTask<void> get_return_object() noexcept;
+
+		void return_void() const noexcept
+			{
+			}
+		};
+	}
+
+/**
+ *
+ * A lazily started coroutine which produces a value of type T.
+ *
+ * The task starts running when it is awaited and resumes the awaiting coroutine once it has finished.
+ * Use FakeAsync::ResumeOnJobSystem() and FakeAsync::ResumeOnMainThread() inside the coroutine to switch threads.
+ *
+ * ### Usage
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~.cpp
+ * FakeTask<FakeRef<FakeTexture2D>> LoadLevel()
+ *     {
+ *     auto textures = co_await FakeAsync::WhenAll(std::move(textureLoads));
+ *     co_return textures[0];
+ *     }
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+template<typename T = void>
+class FakeTask
+	{
+	public:
+		using promise_type = FakeTaskDetail::FakePromise<T>;
+
+	private:
+		std::coroutine_handle<promise_type> Handle;
+
+	public:
+
+		struct Awaiter
+			{
+			std::coroutine_handle<promise_type> Handle;
+
+			bool await_ready() const noexcept
+				{
+				return !Handle || Handle.done();
+				}
+
+			std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+				{
+				Handle.promise().Continuation = awaiting;
+				return Handle;
+				}
+
+			T await_resume()
+				{
+				if constexpr (!std::is_void_v<T>)
+					return std::move(*Handle.promise().Value);
+				}
+			};
+
+		/**
+		 *
+		 * Creates an empty task.
+		 *
+		 */
+		FakeTask() = default;
+
+		/**
+		 *
+		 * Takes ownership of a coroutine handle.
+		 *
+		 * @param handle The coroutine handle.
+		 */
+		explicit FakeTask(std::coroutine_handle<promise_type> handle)
+			: Handle(handle)
+			{
+			}
+
+		FakeTask(const FakeTask&) = delete;
+		FakeTask &operator=(const FakeTask&) = delete;
+
+		FakeTask(FakeTask &&other) noexcept
+			: Handle(other.Handle)
+			{
+			other.Handle = nullptr;
+			}
+
+		FakeTask &operator=(FakeTask &&other) noexcept
+			{
+			if (this != &other)
+				{
+				if (Handle)
+					Handle.destroy();
+
+				Handle = other.Handle;
+				other.Handle = nullptr;
+				}
+
+			return *this;
+			}
+
+		/**
+		 *
+		 * Destroys the coroutine frame.
+		 *
+		 */
+		~FakeTask()
+			{
+			if (Handle)
+				Handle.destroy();
+			}
+
+		/**
+		 *
+		 * Returns true if the task has run to completion.
+		 *
+		 * @return Returns true if the task has run to completion.
+		 */
+		bool IsDone() const
+			{
+			return !Handle || Handle.done();
+			}
+
+		/**
+		 *
+		 * Returns the result of a finished task.
+		 *
+		 * @return Returns the result of a finished task.
+		 */
+		template<typename U = T, typename = std::enable_if_t<!std::is_void_v<U>>>
+		U &GetResult()
+			{
+			FAKE_ASSERT(IsDone(), "Task has not finished yet!");
+			return *Handle.promise().Value;
+			}
+
+		Awaiter operator co_await() && noexcept
+			{
+			return Awaiter{ Handle };
+			}
+
+		Awaiter operator co_await() & noexcept
+			{
+			return Awaiter{ Handle };
+			}
+	};
+
+namespace FakeTaskDetail
+	{
+	template<typename T>
+	inline FakeTask<T> FakePromise<T>::get_return_object() noexcept
+		{
+		return FakeTask<T>(std::coroutine_handle<FakePromise<T>>::from_promise(*this));
+		}
+
+	inline FakeTask<void> FakePromise<void>::get_return_object() noexcept
+		{
+		return FakeTask<void>(std::coroutine_handle<FakePromise<void>>::from_promise(*this));
+		}
+
+	/**
+	 *
+	 * Eagerly started coroutine which destroys itself when it finishes. Used to start tasks from regular functions.
+	 *
+	 */
+	struct FakeDetachedTask
+		{
+		struct promise_type
+			{
+			FakeDetachedTask get_return_object() const noexcept
+				{
+				return {};
+				}
+
+			std::suspend_never initial_suspend() const noexcept
+				{
+				return {};
+				}
+
+			std::suspend_never final_suspend() const noexcept
+				{
+				return {};
+				}
+
+			void return_void() const noexcept
+				{
+				}
+
+			void unhandled_exception()
+				{
+				FAKE_ASSERT(false, "Unhandled exception inside a FakeTask!");
+				std::terminate();
+				}
+			};
+		};
+	}
+
+#endif
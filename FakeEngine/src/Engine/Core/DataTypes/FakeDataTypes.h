@@ -33,6 +33,7 @@
 #include "FakeDictionary.h"
 
 #include "FakeHashFunctions.h"
+#include "FakeRadixSort.h"
 #include "FakeThreadSafeStack.h"
 #include "FakeThreadSafeQueue.h"
 
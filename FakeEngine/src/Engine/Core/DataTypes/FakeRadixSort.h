@@ -0,0 +1,87 @@
+/*****************************************************************
+ * \file   FakeRadixSort.h
+ * \brief  
+ * 
+ * \author Can Karka
+ * \date   February 2021
+ * 
+ * Copyright (C) 2021 Can Karka
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *********************************************************************/
+
+#pragma once
+
+#include "FakePch.h"
+
+/**
+ *
+ * A 64 bit sort key with a payload, usually the index of the sorted element.
+ *
+ */
+struct FakeSortItem
+	{
+	uint64 Key;
+	uint32 Value;
+	};
+
+/**
+ *
+ * Sorts items ascending by key with a stable LSD radix sort over 8 bit digits.
+ * Digits which are equal for all keys are skipped, so narrow keys only pay for the bytes they use.
+ *
+ * @param items The items to sort, they are sorted in place.
+ * @param scratch Temporary storage for at least count items.
+ * @param count The amount of items.
+ */
+inline void fake_radix_sort(FakeSortItem *items, FakeSortItem *scratch, uint32 count)
+	{
+	if (count < 2)
+		return;
+
+	// All eight histograms are built in a single pass over the keys
+	uint32 histograms[8][256] = {};
+	for (uint32 i = 0; i < count; ++i)
+		{
+		uint64 key = items[i].Key;
+		for (uint32 digit = 0; digit < 8; ++digit)
+			++histograms[digit][(key >> (digit * 8)) & 0xFF];
+		}
+
+	FakeSortItem *source = items;
+	FakeSortItem *destination = scratch;
+	for (uint32 digit = 0; digit < 8; ++digit)
+		{
+		uint32 *histogram = histograms[digit];
+		uint32 shift = digit * 8;
+
+		if (histogram[(source[0].Key >> shift) & 0xFF] == count)
+			continue;
+
+		uint32 offset = 0;
+		for (uint32 bucket = 0; bucket < 256; ++bucket)
+			{
+			uint32 size = histogram[bucket];
+			histogram[bucket] = offset;
+			offset += size;
+			}
+
+		for (uint32 i = 0; i < count; ++i)
+			destination[histogram[(source[i].Key >> shift) & 0xFF]++] = source[i];
+
+		std::swap(source, destination);
+		}
+
+	if (source != items)
+		memcpy(items, source, count * sizeof(FakeSortItem));
+	}
@@ -3,6 +3,7 @@
 
 #include "Engine/Core/FakeTimer.h"
 #include "Engine/Core/FakeVirtualFileSystem.h"
+#include "Engine/Core/Jobs/FakeJobSystem.h"
 #include "Engine/Core/Window/FakeInput.h"
 #include "Engine/Renderer/FakeRenderer.h"
 #include "Engine/Renderer/FakeFramebufferPool.h"
@@ -46,6 +47,9 @@ FakeApplication::FakeApplication()
 
 	// Virtuelles Dateisystem initialisieren
 	FakeVirtualFileSystem::Init();
+
+	// Job System initialisieren
+	FakeJobSystem::Init();
 	}
 
 FakeApplication::FakeApplication(const FakeString &title, uint32 width, uint32 height)
@@ -62,6 +66,9 @@ FakeApplication::FakeApplication(const FakeString &title, uint32 width, uint32 h
 	// Virtuelles Dateisystem initialisieren
 	FakeVirtualFileSystem::Init();
 
+	// Job System initialisieren
+	FakeJobSystem::Init();
+
 	// Renderer erstellen
 	FakeRenderer::Init();
 	FakeRenderer::Render();
@@ -72,6 +79,7 @@ FakeApplication::~FakeApplication()
 	if (EnableRendering)
 		FakeRenderer::Shutdown();
 
+	FakeJobSystem::Shutdown();
 	FakeVirtualFileSystem::Shutdown();
 	}
 
@@ -120,6 +128,8 @@ void FakeApplication::Run()
 	double t = 0.0;
 	while (Running)
 		{
+		ExecuteMainThreadQueue();
+
 		if (EnableRendering)
 			{
 			FakeRenderer::SetClearColor({ 0.1f, 0.1f, 0.1f, 1.0f });
@@ -174,6 +184,26 @@ void FakeApplication::CloseApplication()
 	Running = false;
 	}
 
+void FakeApplication::SubmitToMainThread(const std::function<void()> &function)
+	{
+	std::scoped_lock lock(MainThreadQueueMutex);
+	MainThreadQueue.emplace_back(function);
+	}
+
+void FakeApplication::ExecuteMainThreadQueue()
+	{
+	std::vector<std::function<void()>> queue;
+
+	// Functions may submit new work, so the lock is not held while executing
+		{
+		std::scoped_lock lock(MainThreadQueueMutex);
+		queue.swap(MainThreadQueue);
+		}
+
+	for (auto &function : queue)
+		function();
+	}
+
 FakeApplication &FakeApplication::Get()
 	{
 	return *Self;
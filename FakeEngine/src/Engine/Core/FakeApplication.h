@@ -22,6 +22,8 @@
 
 #pragma once
 
+#include <mutex>
+
 #include "Engine/Core/Events/FakeEventsBase.h"
 #include "Engine/Core/FakeLayer.h"
 #include "Engine/Core/FakeLayerStack.h"
@@ -51,6 +53,9 @@ class FakeApplication
 		FakeLayerStack LayerStack;									/**< Contains all Layers implmented by the CLIENT. */
 		Scope<FakeWindow> Window;									/**< The Main Window of the Application. */
 
+		std::mutex MainThreadQueueMutex;
+		std::vector<std::function<void()>> MainThreadQueue;			/**< Functions which have been submitted from other threads. */
+
 		/**
 		 *
 		 * EventCallback which is going to be called when the main Window closes
@@ -80,7 +85,7 @@ class FakeApplication
 
 		/**
 		 *
-		 * The Constructor initializes the Window, VirtualFileSystem and the Renderer.
+		 * The Constructor initializes the Window, VirtualFileSystem, JobSystem and the Renderer.
 		 *
 		 * @param title The Window title.
 		 * @param width The Window width.
@@ -90,7 +95,7 @@ class FakeApplication
 		
 		/**
 		 *
-		 * The Destructor destroys the Renderer and the VirtualFileSystem in this order.
+		 * The Destructor destroys the Renderer, the JobSystem and the VirtualFileSystem in this order.
 		 *
 		 */
 		virtual ~FakeApplication();
@@ -165,6 +170,23 @@ class FakeApplication
 		 */
 		void CloseApplication();
 
+		/**
+		 *
+		 * Queues a function which is executed on the main thread at the beginning of the next frame.
+		 * Can be called from any thread.
+		 *
+		 * @param function The function to execute.
+		 */
+		void SubmitToMainThread(const std::function<void()> &function);
+
+		/**
+		 *
+		 * Executes all functions which have been submitted to the main thread.
+		 * This function is being called automatically once per frame.
+		 *
+		 */
+		void ExecuteMainThreadQueue();
+
 		/**
 		 *
 		 * Returns a Handle to the Application Class as a Reference.
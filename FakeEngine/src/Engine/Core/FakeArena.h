@@ -0,0 +1,163 @@
+/*****************************************************************
+ * \file   FakeArena.h
+ * \brief  
+ * 
+ * \author Can Karka
+ * \date   February 2021
+ * 
+ * Copyright (C) 2021 Can Karka
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *********************************************************************/
+
+#pragma once
+
+#include <cstddef>
+
+#include "Engine/Core/FakeCore.h"
+
+/**
+ *
+ * Linear (bump) allocator for many small, short lived objects which are all released at once.
+ *
+ * Memory is taken from fixed size blocks, objects with non-trivial destructors are destroyed in reverse order on Reset().
+ *
+ * ### Usage
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~.cpp
+ * FakeArena arena;
+ * MyType *object = arena.New<MyType>(42);
+ * arena.Reset(); // destroys object and recycles the memory
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+class FakeArena
+	{
+	private:
+
+		struct Block
+			{
+			Byte *Data;
+			uint32 Size;
+			};
+
+		struct Destructor
+			{
+			void (*Function)(void*);
+			void *Object;
+			};
+
+		std::vector<Block> Blocks;
+		std::vector<Destructor> Destructors;
+		uint32 CurrentBlock = 0;
+		uint32 Offset = 0;
+		uint32 BlockSize;
+
+		Byte *AllocateFromBlock(uint32 size, uint32 alignment)
+			{
+			while (CurrentBlock < Blocks.size())
+				{
+				Block &block = Blocks[CurrentBlock];
+				uint64 address = (uint64)(block.Data + Offset);
+				uint32 padding = (uint32)((alignment - (address & (alignment - 1))) & (alignment - 1));
+				if (Offset + padding + size <= block.Size)
+					{
+					Byte *result = block.Data + Offset + padding;
+					Offset += padding + size;
+					return result;
+					}
+
+				++CurrentBlock;
+				Offset = 0;
+				}
+
+			// Oversized allocations get a block of their own
+			uint32 newSize = FAKE_MAX(BlockSize, size + alignment);
+			Blocks.push_back({ new Byte[newSize], newSize });
+			CurrentBlock = (uint32)Blocks.size() - 1;
+			Offset = 0;
+			return AllocateFromBlock(size, alignment);
+			}
+
+	public:
+
+		/**
+		 *
+		 * Creates an empty arena, no memory is allocated until the first allocation.
+		 *
+		 * @param blockSize The size of a single memory block.
+		 */
+		FakeArena(uint32 blockSize = 16 * 1024)
+			: BlockSize(blockSize)
+			{
+			}
+
+		FakeArena(const FakeArena&) = delete;
+		FakeArena &operator=(const FakeArena&) = delete;
+
+		/**
+		 *
+		 * Destroys all objects and frees all blocks.
+		 *
+		 */
+		~FakeArena()
+			{
+			Reset();
+
+			for (Block &block : Blocks)
+				delete[] block.Data;
+			}
+
+		/**
+		 *
+		 * Allocates raw memory.
+		 *
+		 * @param size The size in bytes.
+		 * @param alignment The alignment, must be a power of two.
+		 * @return Returns the allocated memory.
+		 */
+		void *Allocate(uint32 size, uint32 alignment = alignof(std::max_align_t))
+			{
+			return AllocateFromBlock(size, alignment);
+			}
+
+		/**
+		 *
+		 * Constructs a new object inside the arena.
+		 *
+		 * @param args The constructor arguments.
+		 * @return Returns the new object, it must not be deleted manually.
+		 */
+		template<typename T, typename... Args>
+		T *New(Args&&... args)
+			{
+			T *object = new (AllocateFromBlock(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+			if constexpr (!std::is_trivially_destructible_v<T>)
+				Destructors.push_back({ [](void *p) { ((T*)p)->~T(); }, object });
+
+			return object;
+			}
+
+		/**
+		 *
+		 * Destroys all objects and keeps the blocks for reuse.
+		 *
+		 */
+		void Reset()
+			{
+			for (auto it = Destructors.rbegin(); it != Destructors.rend(); ++it)
+				it->Function(it->Object);
+
+			Destructors.clear();
+			CurrentBlock = 0;
+			Offset = 0;
+			}
+	};
@@ -0,0 +1,72 @@
+/*****************************************************************
+ * \file   FakeMappedFile.h
+ * \brief  
+ * 
+ * \author Can Karka
+ * \date   February 2021
+ * 
+ * Copyright (C) 2021 Can Karka
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *********************************************************************/
+
+#pragma once
+
+#include "Engine/Core/FakeCore.h"
+#include "Engine/Core/DataTypes/FakeString.h"
+
+/**
+ *
+ * A read only view of a whole file, mapped into memory by the operating system.
+ * Pages are loaded on first access, so opening even a huge file is cheap.
+ *
+ */
+class FAKE_API FakeMappedFile
+	{
+	private:
+		const Byte *Data = nullptr;
+		uint64 Size = 0;
+
+		// Platform handles of the file and the mapping, unused on some platforms
+		void *FileHandle = nullptr;
+		void *MappingHandle = nullptr;
+
+	public:
+
+		FakeMappedFile() = default;
+		FakeMappedFile(const FakeString &path);
+		~FakeMappedFile();
+
+		FakeMappedFile(const FakeMappedFile &) = delete;
+		FakeMappedFile &operator=(const FakeMappedFile &) = delete;
+
+		/**
+		 *
+		 * Maps the file into memory, a previously opened file is closed first.
+		 *
+		 * @param path The physical path to a file on the disk.
+		 * @return Returns true if the file has been mapped.
+		 */
+		bool Open(const FakeString &path);
+
+		/**
+		 *
+		 * Unmaps the file, all pointers returned by GetData() become invalid.
+		 *
+		 */
+		void Close();
+
+		bool IsOpen() const { return Data != nullptr; }
+		const Byte *GetData() const { return Data; }
+		uint64 GetSize() const { return Size; }
+	};
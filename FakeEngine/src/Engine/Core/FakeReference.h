@@ -22,6 +22,8 @@
 
 #pragma once
 
+#include <atomic>
+
 #include "Engine/Core/FakeCore.h"
 
 // ONLY NECESSARY IN PRE COMPILED HEADER FILES
@@ -55,10 +57,23 @@
 class FAKE_API FakeRefCounted
 	{
 	private:
-		mutable uint32 RefCount = 0;
+		// Atomic, references are copied and released on the workers of the job system as well
+		mutable std::atomic<uint32> RefCount { 0 };
 
 	public:
 
+		FakeRefCounted() = default;
+
+		// A copy is a new object, nobody references it yet
+		FakeRefCounted(const FakeRefCounted&)
+			{
+			}
+
+		FakeRefCounted &operator=(const FakeRefCounted&)
+			{
+			return *this;
+			}
+
 		/**
 		 *
 		 * Increments the RefCounter of the extending class.
@@ -66,17 +81,18 @@ class FAKE_API FakeRefCounted
 		 */
 		void IncrementRefCount() const
 			{
-			RefCount++;
+			RefCount.fetch_add(1, std::memory_order_relaxed);
 			}
 
 		/**
 		 *
 		 * Decrements the RefCounter of the extending class.
 		 *
+		 * @return Returns the Reference Counter value after the decrement.
 		 */
-		void DecrementRefCount() const
+		uint32 DecrementRefCount() const
 			{
-			RefCount--;
+			return RefCount.fetch_sub(1, std::memory_order_acq_rel) - 1;
 			}
 
 		/**
@@ -87,7 +103,7 @@ class FAKE_API FakeRefCounted
 		 */
 		uint32 GetRefCount() const
 			{
-			return RefCount;
+			return RefCount.load(std::memory_order_acquire);
 			}
 	};
 
@@ -134,8 +150,8 @@ class FAKE_API FakeRef
 			{
 			if (Instance)
 				{
-				Instance->DecrementRefCount();
-				if (Instance->GetRefCount() == 0)
+				// Only the thread which releases the last reference sees 0
+				if (Instance->DecrementRefCount() == 0)
 					{
 					delete Instance;
 					}
@@ -0,0 +1,360 @@
+#include "FakePch.h"
+#include "FakeJobSystem.h"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+
+#include "FakeWorkStealingQueue.h"
+
+static const uint32 MaxJobsPerThread = 4096;
+static const uint32 InvalidThreadIndex = ~0u;
+static const uint32 SpinCountBeforeSleep = 64;
+
+struct FakeJob
+	{
+	FakeJobFunction Function;
+	FakeJobCounter *Counter = nullptr;
+
+	// ParallelFor ranges are stored inline, so splitting does not allocate
+	const FakeJobRangeFunction *Range = nullptr;
+	uint32 Begin = 0;
+	uint32 End = 0;
+	uint32 Grain = 0;
+
+	std::atomic<bool> Pending = false;
+	bool HeapAllocated = false;
+	};
+
+struct FakeWorkerData
+	{
+	FakeWorkStealingQueue<FakeJob, MaxJobsPerThread> Queue;
+	FakeJob Jobs[MaxJobsPerThread];
+	uint32 NextJob = 0;
+	uint32 RandomState = 0;
+	};
+
+struct FakeJobSystemData
+	{
+	std::vector<Scope<FakeWorkerData>> Workers;
+	std::vector<std::thread> Threads;
+	std::atomic<bool> Running = false;
+
+	// Jobs scheduled by threads which are not owned by the Job System
+	std::mutex ExternalMutex;
+	std::deque<FakeJob*> ExternalJobs;
+	std::atomic<uint32> ExternalJobCount = 0;
+
+	std::mutex WakeMutex;
+	std::condition_variable WakeCondition;
+	std::atomic<uint32> SleepingWorkers = 0;
+	};
+
+static FakeJobSystemData *Data = nullptr;
+static FAKE_THREADLOCAL uint32 ThreadIndex = InvalidThreadIndex;
+
+namespace Utils
+	{
+	static uint32 fake_next_random(uint32 &state)
+		{
+		// xorshift32
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		return state;
+		}
+
+	static FakeJob *fake_allocate_job()
+		{
+		if (ThreadIndex != InvalidThreadIndex)
+			{
+			FakeWorkerData &worker = *Data->Workers[ThreadIndex];
+			FakeJob *job = &worker.Jobs[worker.NextJob++ & (MaxJobsPerThread - 1)];
+
+			// The ring slot is still in flight, fall back to the heap
+			if (!job->Pending.load(std::memory_order_acquire))
+				{
+				job->Pending.store(true, std::memory_order_relaxed);
+				job->HeapAllocated = false;
+				return job;
+				}
+			}
+
+		FakeJob *job = new FakeJob();
+		job->Pending.store(true, std::memory_order_relaxed);
+		job->HeapAllocated = true;
+		return job;
+		}
+
+	static void fake_execute(FakeJob *job);
+
+	static void fake_wake_worker()
+		{
+		if (Data->SleepingWorkers.load(std::memory_order_relaxed) > 0)
+			Data->WakeCondition.notify_one();
+		}
+
+	static void fake_schedule(FakeJob *job)
+		{
+		if (job->Counter)
+			job->Counter->Value.fetch_add(1, std::memory_order_relaxed);
+
+		if (ThreadIndex != InvalidThreadIndex && Data->Workers[ThreadIndex]->Queue.Push(job))
+			{
+			fake_wake_worker();
+			return;
+			}
+
+		if (ThreadIndex != InvalidThreadIndex)
+			{
+			// Local queue is full, execute the job immediately instead of blocking
+			fake_execute(job);
+			return;
+			}
+
+		std::scoped_lock lock(Data->ExternalMutex);
+		Data->ExternalJobs.push_back(job);
+		Data->ExternalJobCount.fetch_add(1, std::memory_order_release);
+		fake_wake_worker();
+		}
+
+	static void fake_split_range(const FakeJobRangeFunction *range, uint32 begin, uint32 end, uint32 grain, FakeJobCounter *counter)
+		{
+		// Hand the upper half to the queue until the rest fits into one grain
+		while (end - begin > grain)
+			{
+			uint32 mid = begin + (end - begin) / 2;
+
+			FakeJob *job = fake_allocate_job();
+			job->Range = range;
+			job->Begin = mid;
+			job->End = end;
+			job->Grain = grain;
+			job->Counter = counter;
+			fake_schedule(job);
+
+			end = mid;
+			}
+
+		(*range)(begin, end);
+		}
+
+	static void fake_execute(FakeJob *job)
+		{
+		FakeJobCounter *counter = job->Counter;
+
+		if (job->Range)
+			fake_split_range(job->Range, job->Begin, job->End, job->Grain, counter);
+		else
+			job->Function();
+
+		job->Function = nullptr;
+		job->Range = nullptr;
+		job->Counter = nullptr;
+
+		bool heap = job->HeapAllocated;
+		job->Pending.store(false, std::memory_order_release);
+		if (heap)
+			delete job;
+
+		if (counter)
+			counter->Value.fetch_sub(1, std::memory_order_acq_rel);
+		}
+
+	static FakeJob *fake_find_job()
+		{
+		uint32 index = ThreadIndex;
+		if (index != InvalidThreadIndex)
+			{
+			if (FakeJob *job = Data->Workers[index]->Queue.Pop())
+				return job;
+			}
+
+		if (Data->ExternalJobCount.load(std::memory_order_acquire) > 0)
+			{
+			std::scoped_lock lock(Data->ExternalMutex);
+			if (!Data->ExternalJobs.empty())
+				{
+				FakeJob *job = Data->ExternalJobs.front();
+				Data->ExternalJobs.pop_front();
+				Data->ExternalJobCount.fetch_sub(1, std::memory_order_relaxed);
+				return job;
+				}
+			}
+
+		// Steal from a random victim first, then sweep the others
+		uint32 workerCount = (uint32)Data->Workers.size();
+		uint32 start = 0;
+		if (index != InvalidThreadIndex)
+			start = fake_next_random(Data->Workers[index]->RandomState) % workerCount;
+
+		for (uint32 i = 0; i < workerCount; ++i)
+			{
+			uint32 victim = (start + i) % workerCount;
+			if (victim == index)
+				continue;
+
+			if (FakeJob *job = Data->Workers[victim]->Queue.Steal())
+				return job;
+			}
+
+		return nullptr;
+		}
+
+	static void fake_worker_main(uint32 index)
+		{
+		ThreadIndex = index;
+
+		uint32 idleCount = 0;
+		while (Data->Running.load(std::memory_order_acquire))
+			{
+			if (FakeJob *job = fake_find_job())
+				{
+				fake_execute(job);
+				idleCount = 0;
+				continue;
+				}
+
+			if (++idleCount < SpinCountBeforeSleep)
+				{
+				std::this_thread::yield();
+				continue;
+				}
+
+			// The timeout bounds the latency of a missed wake up
+			std::unique_lock<std::mutex> lock(Data->WakeMutex);
+			Data->SleepingWorkers.fetch_add(1, std::memory_order_relaxed);
+			Data->WakeCondition.wait_for(lock, std::chrono::milliseconds(1));
+			Data->SleepingWorkers.fetch_sub(1, std::memory_order_relaxed);
+			idleCount = 0;
+			}
+
+		ThreadIndex = InvalidThreadIndex;
+		}
+	}
+
+void FakeJobSystem::Init(uint32 threadCount)
+	{
+	FAKE_ASSERT(!Data, "JobSystem already initialized!");
+
+	if (threadCount == 0)
+		threadCount = std::thread::hardware_concurrency();
+
+	if (threadCount == 0)
+		threadCount = 1;
+
+	Data = new FakeJobSystemData();
+	Data->Running.store(true, std::memory_order_release);
+
+	Data->Workers.reserve(threadCount);
+	for (uint32 i = 0; i < threadCount; ++i)
+		{
+		Data->Workers.push_back(CreateScope<FakeWorkerData>());
+		Data->Workers.back()->RandomState = 0x9E3779B9u * (i + 1);
+		}
+
+	// The calling thread is worker 0
+	ThreadIndex = 0;
+
+	Data->Threads.reserve(threadCount - 1);
+	for (uint32 i = 1; i < threadCount; ++i)
+		Data->Threads.emplace_back(Utils::fake_worker_main, i);
+
+	FAKE_LOG_INFO("JobSystem initialized with %d threads", threadCount);
+	}
+
+void FakeJobSystem::Shutdown()
+	{
+	if (!Data)
+		return;
+
+	// Finish everything that is still queued
+	while (HelpOnce());
+
+	Data->Running.store(false, std::memory_order_release);
+	Data->WakeCondition.notify_all();
+
+	for (auto &thread : Data->Threads)
+		thread.join();
+
+	while (HelpOnce());
+
+	ThreadIndex = InvalidThreadIndex;
+	delete Data;
+	Data = nullptr;
+	}
+
+void FakeJobSystem::Run(const FakeJobFunction &job, FakeJobCounter *counter)
+	{
+	FAKE_ASSERT(Data, "JobSystem not initialized!");
+
+	FakeJob *j = Utils::fake_allocate_job();
+	j->Function = job;
+	j->Counter = counter;
+	Utils::fake_schedule(j);
+	}
+
+void FakeJobSystem::ParallelFor(uint32 count, uint32 grainSize, const FakeJobRangeFunction &job)
+	{
+	FAKE_ASSERT(Data, "JobSystem not initialized!");
+
+	if (count == 0)
+		return;
+
+	if (grainSize == 0)
+		{
+		// Roughly four chunks per thread leaves room for stealing without drowning in tiny jobs
+		grainSize = count / (GetThreadCount() * 4);
+		if (grainSize == 0)
+			grainSize = 1;
+		}
+
+	if (count <= grainSize || GetThreadCount() == 1)
+		{
+		job(0, count);
+		return;
+		}
+
+	FakeJobCounter counter;
+	Utils::fake_split_range(&job, 0, count, grainSize, &counter);
+	Wait(&counter);
+	}
+
+void FakeJobSystem::Wait(FakeJobCounter *counter)
+	{
+	FAKE_ASSERT(Data, "JobSystem not initialized!");
+
+	while (!counter->IsDone())
+		{
+		if (!HelpOnce())
+			std::this_thread::yield();
+		}
+	}
+
+bool FakeJobSystem::HelpOnce()
+	{
+	FAKE_ASSERT(Data, "JobSystem not initialized!");
+
+	FakeJob *job = Utils::fake_find_job();
+	if (!job)
+		return false;
+
+	Utils::fake_execute(job);
+	return true;
+	}
+
+bool FakeJobSystem::IsInitialized()
+	{
+	return Data != nullptr;
+	}
+
+uint32 FakeJobSystem::GetThreadCount()
+	{
+	return Data ? (uint32)Data->Workers.size() : 1;
+	}
+
+uint32 FakeJobSystem::GetThreadIndex()
+	{
+	return ThreadIndex;
+	}
@@ -0,0 +1,156 @@
+/*****************************************************************
+ * \file   FakeJobSystem.h
+ * \brief  
+ * 
+ * \author Can Karka
+ * \date   February 2021
+ * 
+ * Copyright (C) 2021 Can Karka
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *********************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+
+#include "Engine/Core/FakeCore.h"
+
+/**
+ *
+ * A counter which tracks the number of unfinished Jobs attached to it.
+ * Use it to express dependencies: wait on the counter before starting dependent work.
+ *
+ */
+struct FAKE_API FakeJobCounter
+	{
+	std::atomic<uint32> Value = 0;
+
+	/**
+	 *
+	 * Returns true if all attached Jobs have finished.
+	 *
+	 * @return Returns true if all attached Jobs have finished.
+	 */
+	bool IsDone() const
+		{
+		return Value.load(std::memory_order_acquire) == 0;
+		}
+	};
+
+typedef std::function<void()> FakeJobFunction;
+typedef std::function<void(uint32, uint32)> FakeJobRangeFunction;
+
+/**
+ *
+ * Work-stealing Job System.
+ *
+ * One worker thread is spawned per additional hardware core, the thread that calls Init() becomes worker 0.
+ * Every worker owns a Chase-Lev deque, idle workers steal from the others.
+ *
+ * @warning The JobSystem is being instantiated and shut down by the FakeApplication.
+ *
+ * ### Usage
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~.cpp
+ * FakeJobCounter counter;
+ * FakeJobSystem::Run([]() { DecodeTexture(); }, &counter);
+ * FakeJobSystem::ParallelFor(entityCount, 256, [](uint32 begin, uint32 end) { UpdateEntities(begin, end); });
+ *
+ * // The calling thread executes pending Jobs until the counter reaches zero
+ * FakeJobSystem::Wait(&counter);
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+class FAKE_API FakeJobSystem
+	{
+	public:
+
+		/**
+		 *
+		 * Initializes the Job System and spawns the worker threads.
+		 * This function is being called automatically by the Engine.
+		 *
+		 * @param threadCount The total number of threads including the calling thread, 0 uses all hardware cores.
+		 */
+		static void Init(uint32 threadCount = 0);
+
+		/**
+		 *
+		 * Finishes all pending Jobs and joins the worker threads.
+		 * This function is being called automatically by the Engine.
+		 *
+		 */
+		static void Shutdown();
+
+		/**
+		 *
+		 * Schedules a Job.
+		 *
+		 * @param job The function to execute.
+		 * @param counter Optional counter, incremented now and decremented once the Job has finished.
+		 */
+		static void Run(const FakeJobFunction &job, FakeJobCounter *counter = nullptr);
+
+		/**
+		 *
+		 * Splits the range [0, count) into chunks of at most grainSize elements and executes them in parallel.
+		 * The range is split recursively, so idle workers steal large chunks first.
+		 * This call blocks until the whole range has been processed, the calling thread takes part in the work.
+		 *
+		 * @param count The number of elements.
+		 * @param grainSize The maximum number of elements per Job, 0 picks a size based on the thread count.
+		 * @param job The function which receives the half-open range [begin, end).
+		 */
+		static void ParallelFor(uint32 count, uint32 grainSize, const FakeJobRangeFunction &job);
+
+		/**
+		 *
+		 * Blocks until the counter reaches zero.
+		 * The calling thread executes pending Jobs while waiting instead of sleeping.
+		 *
+		 * @param counter The counter to wait on.
+		 */
+		static void Wait(FakeJobCounter *counter);
+
+		/**
+		 *
+		 * Executes a single pending Job on the calling thread if there is one.
+		 *
+		 * @return Returns true if a Job has been executed.
+		 */
+		static bool HelpOnce();
+
+		/**
+		 *
+		 * Returns true if the Job System has been initialized.
+		 *
+		 * @return Returns true if the Job System has been initialized.
+		 */
+		static bool IsInitialized();
+
+		/**
+		 *
+		 * Returns the total number of threads including the main thread.
+		 *
+		 * @return Returns the thread count.
+		 */
+		static uint32 GetThreadCount();
+
+		/**
+		 *
+		 * Returns the index of the calling thread, 0 is the main thread.
+		 *
+		 * @return Returns the thread index or ~0 if the calling thread is not owned by the Job System.
+		 */
+		static uint32 GetThreadIndex();
+	};
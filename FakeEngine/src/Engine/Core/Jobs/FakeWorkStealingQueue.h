@@ -0,0 +1,153 @@
+/*****************************************************************
+ * \file   FakeWorkStealingQueue.h
+ * \brief  
+ * 
+ * \author Can Karka
+ * \date   February 2021
+ * 
+ * Copyright (C) 2021 Can Karka
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *********************************************************************/
+
+#pragma once
+
+#include <atomic>
+
+#include "Engine/Core/FakeCore.h"
+
+/**
+ *
+ * Lock-free Chase-Lev work-stealing deque with a fixed capacity.
+ *
+ * The owning thread pushes and pops at the bottom (LIFO), every other thread may steal from the top (FIFO).
+ * Only pointers are stored, the queue never owns the pointed-to objects.
+ *
+ * @tparam T The element type, the queue stores T*.
+ * @tparam Capacity The maximum number of elements, must be a power of two.
+ */
+template<typename T, uint32 Capacity>
+class FakeWorkStealingQueue
+	{
+	private:
+		static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two!");
+		static constexpr int64 Mask = Capacity - 1;
+
+		alignas(64) std::atomic<int64> Top = 0;
+		alignas(64) std::atomic<int64> Bottom = 0;
+		std::atomic<T*> Buffer[Capacity];
+
+	public:
+
+		/**
+		 *
+		 * Pushes a new element to the bottom of the queue.
+		 * @attention Must only be called by the owning thread.
+		 *
+		 * @param item The element to push.
+		 * @return Returns false if the queue is full.
+		 */
+		bool Push(T *item)
+			{
+			int64 b = Bottom.load(std::memory_order_relaxed);
+			int64 t = Top.load(std::memory_order_acquire);
+			if (b - t >= (int64)Capacity)
+				return false;
+
+			Buffer[b & Mask].store(item, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_release);
+			Bottom.store(b + 1, std::memory_order_relaxed);
+			return true;
+			}
+
+		/**
+		 *
+		 * Pops the most recently pushed element from the bottom of the queue.
+		 * @attention Must only be called by the owning thread.
+		 *
+		 * @return Returns the element or nullptr if the queue is empty or the last element has been stolen.
+		 */
+		T *Pop()
+			{
+			int64 b = Bottom.load(std::memory_order_relaxed) - 1;
+			Bottom.store(b, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			int64 t = Top.load(std::memory_order_relaxed);
+
+			if (t > b)
+				{
+				// Queue was already empty
+				Bottom.store(b + 1, std::memory_order_relaxed);
+				return nullptr;
+				}
+
+			T *item = Buffer[b & Mask].load(std::memory_order_relaxed);
+			if (t == b)
+				{
+				// Last element, race against concurrent steals
+				if (!Top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+					item = nullptr;
+
+				Bottom.store(b + 1, std::memory_order_relaxed);
+				}
+
+			return item;
+			}
+
+		/**
+		 *
+		 * Steals the oldest element from the top of the queue.
+		 * Can be called from any thread.
+		 *
+		 * @return Returns the element or nullptr if the queue is empty or another thread won the race.
+		 */
+		T *Steal()
+			{
+			int64 t = Top.load(std::memory_order_acquire);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			int64 b = Bottom.load(std::memory_order_acquire);
+
+			if (t >= b)
+				return nullptr;
+
+			T *item = Buffer[t & Mask].load(std::memory_order_relaxed);
+			if (!Top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+				return nullptr;
+
+			return item;
+			}
+
+		/**
+		 *
+		 * Returns an approximation of the current element count.
+		 *
+		 * @return Returns the element count.
+		 */
+		uint32 Size() const
+			{
+			int64 b = Bottom.load(std::memory_order_relaxed);
+			int64 t = Top.load(std::memory_order_relaxed);
+			return b >= t ? (uint32)(b - t) : 0;
+			}
+
+		/**
+		 *
+		 * Returns true if the queue is (approximately) empty.
+		 *
+		 * @return Returns true if the queue is empty.
+		 */
+		bool IsEmpty() const
+			{
+			return Size() == 0;
+			}
+	};
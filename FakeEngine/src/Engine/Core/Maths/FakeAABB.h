@@ -22,3 +22,139 @@
 
 #pragma once
 
+#include "FakeMathFunctions.h"
+
+template<typename T>
+struct FakeVector3;
+
+template<typename T>
+struct FakeMatrix4x4;
+
+/**
+ *
+ * Axis aligned bounding box, stored as its minimum and maximum corner.
+ *
+ */
+template<typename T>
+struct FakeBoundingBox
+	{
+	FakeVector3<T> Min;
+	FakeVector3<T> Max;
+
+	FakeBoundingBox()
+		: Min(static_cast<T>(0)), Max(static_cast<T>(0))
+		{
+		}
+
+	FakeBoundingBox(const FakeVector3<T> &min, const FakeVector3<T> &max)
+		: Min(min), Max(max)
+		{
+		}
+
+	FakeVector3<T> GetCenter() const
+		{
+		return (Min + Max) * static_cast<T>(0.5);
+		}
+
+	FakeVector3<T> GetExtents() const
+		{
+		return (Max - Min) * static_cast<T>(0.5);
+		}
+
+	FakeVector3<T> GetSize() const
+		{
+		return Max - Min;
+		}
+
+	/// Half of the surface area, the cost metric of the surface area heuristic
+	T GetPerimeter() const
+		{
+		FakeVector3<T> size = Max - Min;
+		return size.X * size.Y + size.Y * size.Z + size.Z * size.X;
+		}
+
+	bool IsValid() const
+		{
+		return Min.X <= Max.X && Min.Y <= Max.Y && Min.Z <= Max.Z;
+		}
+
+	bool Contains(const FakeVector3<T> &point) const
+		{
+		return point.X >= Min.X && point.X <= Max.X
+			&& point.Y >= Min.Y && point.Y <= Max.Y
+			&& point.Z >= Min.Z && point.Z <= Max.Z;
+		}
+
+	bool Contains(const FakeBoundingBox &other) const
+		{
+		return other.Min.X >= Min.X && other.Max.X <= Max.X
+			&& other.Min.Y >= Min.Y && other.Max.Y <= Max.Y
+			&& other.Min.Z >= Min.Z && other.Max.Z <= Max.Z;
+		}
+
+	bool Intersects(const FakeBoundingBox &other) const
+		{
+		return Min.X <= other.Max.X && Max.X >= other.Min.X
+			&& Min.Y <= other.Max.Y && Max.Y >= other.Min.Y
+			&& Min.Z <= other.Max.Z && Max.Z >= other.Min.Z;
+		}
+
+	bool IntersectsSphere(const FakeVector3<T> &center, T radius) const
+		{
+		return DistanceSquared(center) <= radius * radius;
+		}
+
+	/// Squared distance from the point to the closest point of the box, 0 if the point is inside
+	T DistanceSquared(const FakeVector3<T> &point) const
+		{
+		FakeVector3<T> closest = FakeVector3<T>::Clamp(point, Min, Max);
+		return FakeVector3<T>::DistanceSquared(point, closest);
+		}
+
+	static FakeBoundingBox Merge(const FakeBoundingBox &a, const FakeBoundingBox &b)
+		{
+		return FakeBoundingBox(FakeVector3<T>::Min(a.Min, b.Min), FakeVector3<T>::Max(a.Max, b.Max));
+		}
+
+	static FakeBoundingBox Expand(const FakeBoundingBox &box, T margin)
+		{
+		FakeVector3<T> m(margin);
+		return FakeBoundingBox(box.Min - m, box.Max + m);
+		}
+
+	/// Bounds of the transformed box, the result encloses all 8 transformed corners
+	static FakeBoundingBox Transform(const FakeBoundingBox &box, const FakeMatrix4x4<T> &transform)
+		{
+		// Arvo: per output axis, pick the smaller and larger product of each matrix row with the box range
+		FakeVector3<T> min(transform.M41, transform.M42, transform.M43);
+		FakeVector3<T> max = min;
+
+		const T *rows[3] = { &transform.M11, &transform.M21, &transform.M31 };
+		for (uint32 i = 0; i < 3; ++i)
+			{
+			for (uint32 j = 0; j < 3; ++j)
+				{
+				T a = rows[i][j] * box.Min[i];
+				T b = rows[i][j] * box.Max[i];
+				min[j] += a < b ? a : b;
+				max[j] += a < b ? b : a;
+				}
+			}
+
+		return FakeBoundingBox(min, max);
+		}
+
+	bool operator==(const FakeBoundingBox &other) const
+		{
+		return Min == other.Min && Max == other.Max;
+		}
+
+	bool operator!=(const FakeBoundingBox &other) const
+		{
+		return !(*this == other);
+		}
+	};
+
+typedef FakeBoundingBox<float> FakeAABB;
+typedef FakeBoundingBox<double> FakeAABBd;
+
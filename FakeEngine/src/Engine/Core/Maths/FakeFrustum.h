@@ -0,0 +1,139 @@
+/*****************************************************************
+ * \file   FakeFrustum.h
+ * \brief  
+ * 
+ * \author Can Karka
+ * \date   February 2021
+ * 
+ * Copyright (C) 2021 Can Karka
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *********************************************************************/
+
+#pragma once
+
+#include "FakeMathFunctions.h"
+#include "FakeAABB.h"
+
+/**
+ *
+ * The six planes of a view volume, extracted from a view projection matrix.
+ * Plane normals point inwards, a point p is inside a plane if Dot(Normal, p) + Distance >= 0.
+ *
+ */
+template<typename T>
+struct FakeViewFrustum
+	{
+	enum PlaneIndex { Left = 0, Right, Bottom, Top, Near, Far, PlaneCount };
+
+	FakeVector4<T> Planes[PlaneCount];
+
+	FakeViewFrustum() = default;
+
+	FakeViewFrustum(const FakeMatrix4x4<T> &viewProjection)
+		{
+		SetViewProjection(viewProjection);
+		}
+
+	/**
+	 *
+	 * Extracts the planes of a row vector view * projection matrix with a depth range of [0, 1].
+	 *
+	 * @param m The view projection matrix, for example FakeMat4f::Inverse(cameraTransform) * camera.GetProjectionMatrix().
+	 */
+	void SetViewProjection(const FakeMatrix4x4<T> &m)
+		{
+		// Gribb / Hartmann, clip = p * m, so each plane is a combination of matrix columns
+		FakeVector4<T> c1(m.M11, m.M21, m.M31, m.M41);
+		FakeVector4<T> c2(m.M12, m.M22, m.M32, m.M42);
+		FakeVector4<T> c3(m.M13, m.M23, m.M33, m.M43);
+		FakeVector4<T> c4(m.M14, m.M24, m.M34, m.M44);
+
+		Planes[Left] = c4 + c1;
+		Planes[Right] = c4 - c1;
+		Planes[Bottom] = c4 + c2;
+		Planes[Top] = c4 - c2;
+		Planes[Near] = c3;
+		Planes[Far] = c4 - c3;
+
+		for (uint32 i = 0; i < PlaneCount; ++i)
+			{
+			FakeVector4<T> &p = Planes[i];
+			T length = fake_sqrt(p.X * p.X + p.Y * p.Y + p.Z * p.Z);
+			if (length > FAKE_ZERO_TOLERANCE)
+				p = p / length;
+			}
+		}
+
+	bool Contains(const FakeVector3<T> &point) const
+		{
+		for (uint32 i = 0; i < PlaneCount; ++i)
+			{
+			const FakeVector4<T> &p = Planes[i];
+			if (p.X * point.X + p.Y * point.Y + p.Z * point.Z + p.W < static_cast<T>(0))
+				return false;
+			}
+
+		return true;
+		}
+
+	/// True if the box lies completely inside of the frustum
+	bool Contains(const FakeBoundingBox<T> &box) const
+		{
+		for (uint32 i = 0; i < PlaneCount; ++i)
+			{
+			// The corner furthest against the plane normal decides
+			const FakeVector4<T> &p = Planes[i];
+			T x = p.X >= static_cast<T>(0) ? box.Min.X : box.Max.X;
+			T y = p.Y >= static_cast<T>(0) ? box.Min.Y : box.Max.Y;
+			T z = p.Z >= static_cast<T>(0) ? box.Min.Z : box.Max.Z;
+			if (p.X * x + p.Y * y + p.Z * z + p.W < static_cast<T>(0))
+				return false;
+			}
+
+		return true;
+		}
+
+	/// Conservative test, boxes close to a frustum corner may be reported as visible
+	bool Intersects(const FakeBoundingBox<T> &box) const
+		{
+		for (uint32 i = 0; i < PlaneCount; ++i)
+			{
+			// Only the corner furthest along the plane normal has to be tested
+			const FakeVector4<T> &p = Planes[i];
+			T x = p.X >= static_cast<T>(0) ? box.Max.X : box.Min.X;
+			T y = p.Y >= static_cast<T>(0) ? box.Max.Y : box.Min.Y;
+			T z = p.Z >= static_cast<T>(0) ? box.Max.Z : box.Min.Z;
+			if (p.X * x + p.Y * y + p.Z * z + p.W < static_cast<T>(0))
+				return false;
+			}
+
+		return true;
+		}
+
+	bool Intersects(const FakeVector3<T> &center, T radius) const
+		{
+		for (uint32 i = 0; i < PlaneCount; ++i)
+			{
+			const FakeVector4<T> &p = Planes[i];
+			if (p.X * center.X + p.Y * center.Y + p.Z * center.Z + p.W < -radius)
+				return false;
+			}
+
+		return true;
+		}
+	};
+
+typedef FakeViewFrustum<float> FakeFrustum;
+typedef FakeViewFrustum<double> FakeFrustumd;
+
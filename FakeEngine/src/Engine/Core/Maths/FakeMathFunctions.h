@@ -495,7 +495,7 @@ static float fake_floor_select(float comparand, float valueGEZero, float valueLT
 template<typename T>
 static T fake_radians(T degrees)
 	{
-	return degrees * static_cast<T>(FAKE_PI * 180.0f);
+	return degrees * static_cast<T>(FAKE_PI / 180.0f);
 	}
 
 template<typename T>
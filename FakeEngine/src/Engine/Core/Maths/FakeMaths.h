@@ -37,5 +37,6 @@
 
 #include "FakeAABB.h"
 #include "FakeRay.h"
+#include "FakeFrustum.h"
 #include "FakeColor.h"
 
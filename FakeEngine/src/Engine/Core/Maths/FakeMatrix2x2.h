@@ -558,7 +558,7 @@ struct FakeMatrix2x2
 
 	T &operator[](uint32 index)
 		{
-		if (index > 0 && index < 4)
+		if (index < 4)
 			{
 			return Raw[index];
 			}
@@ -570,7 +570,7 @@ struct FakeMatrix2x2
 
 	const T &operator[](uint32 index) const
 		{
-		if (index > 0 && index < 4)
+		if (index < 4)
 			{
 			return Raw[index];
 			}
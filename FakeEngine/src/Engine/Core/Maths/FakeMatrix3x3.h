@@ -856,7 +856,7 @@ struct FakeMatrix3x3
 
 	T &operator[](uint32 index)
 		{
-		if (index > 0 && index < 9)
+		if (index < 9)
 			{
 			return Raw[index];
 			}
@@ -868,7 +868,7 @@ struct FakeMatrix3x3
 
 	const T &operator[](uint32 index) const
 		{
-		if (index > 0 && index < 9)
+		if (index < 9)
 			{
 			return Raw[index];
 			}
@@ -661,13 +661,6 @@ struct FakeMatrix4x4
 			return;
 			}
 
-		// Drehmatrix   Spiegel / Drehspiegelmatrix
-		if (det == static_cast<T>(1) || det == static_cast<T>(-1)) // Matrix ist orthogonal
-			{
-			Transpose(m, result);
-			return;
-			}
-
 		// Inverse of determinant
 		det = static_cast<T>(1) / det;
 
@@ -1928,7 +1921,7 @@ struct FakeMatrix4x4
 
 	T &operator[](uint32 index)
 		{
-		if (index > 0 && index < 16)
+		if (index < 16)
 			{
 			return Raw[index];
 			}
@@ -1940,7 +1933,7 @@ struct FakeMatrix4x4
 
 	const T &operator[](uint32 index) const
 		{
-		if (index > 0 && index < 16)
+		if (index < 16)
 			{
 			return Raw[index];
 			}
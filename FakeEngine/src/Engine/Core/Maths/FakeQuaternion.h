@@ -956,7 +956,7 @@ struct FakeQuaternion
 
 	T &operator[](uint32 index)
 		{
-		if (index > 0 && index < 4)
+		if (index < 4)
 			{
 			return Raw[index];
 			}
@@ -968,7 +968,7 @@ struct FakeQuaternion
 
 	const T &operator[](uint32 index) const
 		{
-		if (index > 0 && index < 4)
+		if (index < 4)
 			{
 			return Raw[index];
 			}
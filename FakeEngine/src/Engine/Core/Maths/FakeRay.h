@@ -22,3 +22,100 @@
 
 #pragma once
 
+#include "FakeMathFunctions.h"
+#include "FakeAABB.h"
+
+/**
+ *
+ * Half-infinite line, Origin + Direction * t for t >= 0.
+ *
+ */
+template<typename T>
+struct FakeRay3
+	{
+	FakeVector3<T> Origin;
+	FakeVector3<T> Direction;
+
+	FakeRay3()
+		: Origin(static_cast<T>(0)), Direction(static_cast<T>(0), static_cast<T>(0), static_cast<T>(1))
+		{
+		}
+
+	FakeRay3(const FakeVector3<T> &origin, const FakeVector3<T> &direction)
+		: Origin(origin), Direction(direction)
+		{
+		}
+
+	FakeVector3<T> GetPoint(T distance) const
+		{
+		return Origin + Direction * distance;
+		}
+
+	/**
+	 *
+	 * Slab test against a box.
+	 *
+	 * @param box The box to test.
+	 * @param outDistance Receives the distance along the ray to the entry point, 0 if the origin lies inside.
+	 * @return Returns true if the ray hits the box.
+	 */
+	bool Intersects(const FakeBoundingBox<T> &box, T &outDistance) const
+		{
+		T tMin = static_cast<T>(0);
+		T tMax = std::numeric_limits<T>::max();
+
+		for (uint32 i = 0; i < 3; ++i)
+			{
+			if (FAKE_ABS(Direction[i]) < FAKE_ZERO_TOLERANCE)
+				{
+				if (Origin[i] < box.Min[i] || Origin[i] > box.Max[i])
+					return false;
+
+				continue;
+				}
+
+			T inverse = static_cast<T>(1) / Direction[i];
+			T t1 = (box.Min[i] - Origin[i]) * inverse;
+			T t2 = (box.Max[i] - Origin[i]) * inverse;
+			if (t1 > t2)
+				std::swap(t1, t2);
+
+			tMin = t1 > tMin ? t1 : tMin;
+			tMax = t2 < tMax ? t2 : tMax;
+			if (tMin > tMax)
+				return false;
+			}
+
+		outDistance = tMin;
+		return true;
+		}
+
+	/**
+	 *
+	 * Creates a picking ray through a pixel of the viewport.
+	 *
+	 * @param x The horizontal pixel coordinate, 0 is the left edge.
+	 * @param y The vertical pixel coordinate, 0 is the top edge.
+	 * @param width The viewport width in pixels.
+	 * @param height The viewport height in pixels.
+	 * @param inverseViewProjection The inverse of view * projection.
+	 * @return Returns a ray from the near plane through the pixel, with a normalized direction.
+	 */
+	static FakeRay3 FromScreen(T x, T y, T width, T height, const FakeMatrix4x4<T> &inverseViewProjection)
+		{
+		T ndcX = x / width * static_cast<T>(2) - static_cast<T>(1);
+		T ndcY = static_cast<T>(1) - y / height * static_cast<T>(2);
+
+		FakeVector3<T> nearPoint, farPoint;
+		FakeVector3<T>::TransformCoordinate(FakeVector3<T>(ndcX, ndcY, static_cast<T>(0)), inverseViewProjection, nearPoint);
+		FakeVector3<T>::TransformCoordinate(FakeVector3<T>(ndcX, ndcY, static_cast<T>(1)), inverseViewProjection, farPoint);
+
+		FakeVector3<T> direction;
+		FakeVector3<T>::Normalize(farPoint - nearPoint, direction);
+		return FakeRay3(nearPoint, direction);
+		}
+	};
+
+typedef FakeRay3<float> FakeRay;
+typedef FakeRay3<double> FakeRayd;
+
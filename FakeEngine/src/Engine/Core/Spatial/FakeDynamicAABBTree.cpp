@@ -0,0 +1,460 @@
+#include "FakePch.h"
+#include "FakeDynamicAABBTree.h"
+
+FakeDynamicAABBTree::FakeDynamicAABBTree(float margin, float displacementMultiplier)
+	: Margin(margin), DisplacementMultiplier(displacementMultiplier)
+	{
+	}
+
+int32 FakeDynamicAABBTree::CreateProxy(const FakeAABB &box, uint32 userData)
+	{
+	int32 proxyId = AllocateNode();
+	Node &node = Nodes[proxyId];
+	node.Box = FakeAABB::Expand(box, Margin);
+	node.UserData = userData;
+	node.Height = 0;
+
+	InsertLeaf(proxyId);
+	++ProxyCount;
+	return proxyId;
+	}
+
+void FakeDynamicAABBTree::CreateProxies(const FakeAABB *boxes, const uint32 *userData, uint32 count, int32 *outProxyIds)
+	{
+	// Inserting one by one is cheaper while the batch is small compared to the tree
+	bool rebuild = count > ProxyCount;
+
+	for (uint32 i = 0; i < count; ++i)
+		{
+		int32 proxyId = AllocateNode();
+		Node &node = Nodes[proxyId];
+		node.Box = FakeAABB::Expand(boxes[i], Margin);
+		node.UserData = userData[i];
+		node.Height = 0;
+
+		if (!rebuild)
+			InsertLeaf(proxyId);
+
+		outProxyIds[i] = proxyId;
+		}
+
+	ProxyCount += count;
+
+	if (rebuild)
+		Rebuild();
+	}
+
+void FakeDynamicAABBTree::DestroyProxy(int32 proxyId)
+	{
+	FAKE_ASSERT(proxyId >= 0 && proxyId < (int32)Nodes.size() && Nodes[proxyId].IsLeaf());
+
+	RemoveLeaf(proxyId);
+	FreeNode(proxyId);
+	--ProxyCount;
+	}
+
+bool FakeDynamicAABBTree::MoveProxy(int32 proxyId, const FakeAABB &box, const FakeVec3f &displacement)
+	{
+	FAKE_ASSERT(proxyId >= 0 && proxyId < (int32)Nodes.size() && Nodes[proxyId].IsLeaf());
+
+	FakeAABB fatBox = FakeAABB::Expand(box, Margin);
+
+	// Extend the box in the direction of motion, so the proxy stays valid for a few frames
+	FakeVec3f d = displacement * DisplacementMultiplier;
+	for (uint32 i = 0; i < 3; ++i)
+		{
+		if (d[i] < 0.0f)
+			fatBox.Min[i] += d[i];
+		else
+			fatBox.Max[i] += d[i];
+		}
+
+	const FakeAABB &treeBox = Nodes[proxyId].Box;
+	if (treeBox.Contains(box))
+		{
+		// Still inside, unless the fat box has become much too large, for example after a fast object has stopped
+		FakeAABB hugeBox = FakeAABB::Expand(fatBox, Margin * 4.0f);
+		if (hugeBox.Contains(treeBox))
+			return false;
+		}
+
+	RemoveLeaf(proxyId);
+	Nodes[proxyId].Box = fatBox;
+	InsertLeaf(proxyId);
+	return true;
+	}
+
+void FakeDynamicAABBTree::Rebuild()
+	{
+	std::vector<BuildEntry> leaves;
+	leaves.reserve(ProxyCount);
+
+	// Leaves keep their index, inner nodes are thrown away
+	for (int32 i = 0; i < (int32)Nodes.size(); ++i)
+		{
+		Node &node = Nodes[i];
+		if (node.Height < 0)
+			continue;
+
+		if (node.IsLeaf())
+			leaves.push_back({ node.Box, i });
+		else
+			FreeNode(i);
+		}
+
+	Root = leaves.empty() ? NullNode : BuildRange(leaves.data(), (uint32)leaves.size());
+	if (Root != NullNode)
+		Nodes[Root].Parent = NullNode;
+	}
+
+void FakeDynamicAABBTree::Clear()
+	{
+	Nodes.clear();
+	Root = NullNode;
+	FreeList = NullNode;
+	ProxyCount = 0;
+	}
+
+float FakeDynamicAABBTree::GetAreaRatio() const
+	{
+	if (Root == NullNode)
+		return 0.0f;
+
+	float rootArea = Nodes[Root].Box.GetPerimeter();
+	float totalArea = 0.0f;
+	for (const Node &node : Nodes)
+		{
+		if (node.Height > 0)
+			totalArea += node.Box.GetPerimeter();
+		}
+
+	return rootArea > 0.0f ? totalArea / rootArea : 0.0f;
+	}
+
+int32 FakeDynamicAABBTree::AllocateNode()
+	{
+	if (FreeList == NullNode)
+		{
+		Nodes.emplace_back();
+		return (int32)Nodes.size() - 1;
+		}
+
+	int32 index = FreeList;
+	FreeList = Nodes[index].Parent;
+	Nodes[index] = Node();
+	return index;
+	}
+
+void FakeDynamicAABBTree::FreeNode(int32 index)
+	{
+	Nodes[index].Parent = FreeList;
+	Nodes[index].Height = -1;
+	FreeList = index;
+	}
+
+void FakeDynamicAABBTree::InsertLeaf(int32 leaf)
+	{
+	if (Root == NullNode)
+		{
+		Root = leaf;
+		Nodes[leaf].Parent = NullNode;
+		return;
+		}
+
+	// Descend towards the sibling with the lowest surface area cost
+	FakeAABB leafBox = Nodes[leaf].Box;
+	int32 index = Root;
+	while (!Nodes[index].IsLeaf())
+		{
+		const Node &node = Nodes[index];
+		float area = node.Box.GetPerimeter();
+		float combinedArea = FakeAABB::Merge(node.Box, leafBox).GetPerimeter();
+
+		// Cost of a new parent for this node and the leaf
+		float cost = 2.0f * combinedArea;
+
+		// Minimum cost of pushing the leaf further down, every ancestor grows by this much
+		float inheritanceCost = 2.0f * (combinedArea - area);
+
+		auto childCost = [&](int32 child)
+			{
+			const Node &c = Nodes[child];
+			float merged = FakeAABB::Merge(c.Box, leafBox).GetPerimeter();
+			return c.IsLeaf() ? merged + inheritanceCost : merged - c.Box.GetPerimeter() + inheritanceCost;
+			};
+
+		float cost1 = childCost(node.Child1);
+		float cost2 = childCost(node.Child2);
+
+		if (cost < cost1 && cost < cost2)
+			break;
+
+		index = cost1 < cost2 ? node.Child1 : node.Child2;
+		}
+
+	int32 sibling = index;
+	int32 oldParent = Nodes[sibling].Parent;
+
+	// AllocateNode() may grow the node array, no references across this call
+	int32 newParent = AllocateNode();
+	Node &parent = Nodes[newParent];
+	parent.Parent = oldParent;
+	parent.Box = FakeAABB::Merge(leafBox, Nodes[sibling].Box);
+	parent.Height = Nodes[sibling].Height + 1;
+	parent.Child1 = sibling;
+	parent.Child2 = leaf;
+
+	if (oldParent != NullNode)
+		{
+		if (Nodes[oldParent].Child1 == sibling)
+			Nodes[oldParent].Child1 = newParent;
+		else
+			Nodes[oldParent].Child2 = newParent;
+		}
+	else
+		{
+		Root = newParent;
+		}
+
+	Nodes[sibling].Parent = newParent;
+	Nodes[leaf].Parent = newParent;
+
+	Refit(Nodes[leaf].Parent);
+	}
+
+void FakeDynamicAABBTree::RemoveLeaf(int32 leaf)
+	{
+	if (leaf == Root)
+		{
+		Root = NullNode;
+		return;
+		}
+
+	int32 parent = Nodes[leaf].Parent;
+	int32 grandParent = Nodes[parent].Parent;
+	int32 sibling = Nodes[parent].Child1 == leaf ? Nodes[parent].Child2 : Nodes[parent].Child1;
+
+	if (grandParent != NullNode)
+		{
+		// Replace the parent with the sibling
+		if (Nodes[grandParent].Child1 == parent)
+			Nodes[grandParent].Child1 = sibling;
+		else
+			Nodes[grandParent].Child2 = sibling;
+
+		Nodes[sibling].Parent = grandParent;
+		FreeNode(parent);
+		Refit(grandParent);
+		}
+	else
+		{
+		Root = sibling;
+		Nodes[sibling].Parent = NullNode;
+		FreeNode(parent);
+		}
+
+	Nodes[leaf].Parent = NullNode;
+	}
+
+int32 FakeDynamicAABBTree::BuildRange(BuildEntry *leaves, uint32 count)
+	{
+	if (count == 1)
+		return leaves[0].Index;
+
+	const uint32 binCount = 16;
+
+	// Twice the centers, halving them is not needed for comparisons
+	FakeVec3f centerMin = leaves[0].Box.Min + leaves[0].Box.Max;
+	FakeVec3f centerMax = centerMin;
+	for (uint32 i = 1; i < count; ++i)
+		{
+		FakeVec3f center = leaves[i].Box.Min + leaves[i].Box.Max;
+		for (uint32 j = 0; j < 3; ++j)
+			{
+			if (center[j] < centerMin[j]) centerMin[j] = center[j];
+			if (center[j] > centerMax[j]) centerMax[j] = center[j];
+			}
+		}
+
+	// Split along the axis with the largest spread of the centers
+	FakeVec3f spread = centerMax - centerMin;
+	uint32 axis = spread.X > spread.Y ? (spread.X > spread.Z ? 0 : 2) : (spread.Y > spread.Z ? 1 : 2);
+
+	uint32 splitCount = count / 2;
+	if (spread[axis] > FAKE_ZERO_TOLERANCE)
+		{
+		FakeAABB binBoxes[binCount];
+		uint32 binSizes[binCount] = {};
+		float scale = (float)binCount / spread[axis];
+
+		auto getBin = [&](const FakeAABB &box)
+			{
+			uint32 bin = (uint32)((box.Min[axis] + box.Max[axis] - centerMin[axis]) * scale);
+			return bin < binCount ? bin : binCount - 1;
+			};
+
+		for (uint32 i = 0; i < count; ++i)
+			{
+			uint32 bin = getBin(leaves[i].Box);
+			const FakeAABB &box = leaves[i].Box;
+			binBoxes[bin] = binSizes[bin]++ ? FakeAABB::Merge(binBoxes[bin], box) : box;
+			}
+
+		// Sweep from the right to get the cost of every right side, then from the left to find the cheapest split
+		float rightCosts[binCount];
+		FakeAABB rightBox;
+		uint32 rightSize = 0;
+		for (uint32 bin = binCount - 1; bin > 0; --bin)
+			{
+			if (binSizes[bin])
+				{
+				rightBox = rightSize ? FakeAABB::Merge(rightBox, binBoxes[bin]) : binBoxes[bin];
+				rightSize += binSizes[bin];
+				}
+
+			rightCosts[bin] = rightSize ? rightBox.GetPerimeter() * (float)rightSize : 0.0f;
+			}
+
+		FakeAABB leftBox;
+		uint32 leftSize = 0;
+		uint32 bestBin = 0;
+		float bestCost = std::numeric_limits<float>::max();
+		for (uint32 bin = 0; bin < binCount - 1; ++bin)
+			{
+			if (binSizes[bin])
+				{
+				leftBox = leftSize ? FakeAABB::Merge(leftBox, binBoxes[bin]) : binBoxes[bin];
+				leftSize += binSizes[bin];
+				}
+
+			if (leftSize == 0 || leftSize == count)
+				continue;
+
+			float cost = leftBox.GetPerimeter() * (float)leftSize + rightCosts[bin + 1];
+			if (cost < bestCost)
+				{
+				bestCost = cost;
+				bestBin = bin;
+				}
+			}
+
+		auto middle = std::partition(leaves, leaves + count, [&](const BuildEntry &leaf) { return getBin(leaf.Box) <= bestBin; });
+		splitCount = (uint32)(middle - leaves);
+		}
+
+	// All centers in one bin, split in the middle
+	if (splitCount == 0 || splitCount == count)
+		{
+		splitCount = count / 2;
+		std::nth_element(leaves, leaves + splitCount, leaves + count, [axis](const BuildEntry &a, const BuildEntry &b) { return a.Box.Min[axis] + a.Box.Max[axis] < b.Box.Min[axis] + b.Box.Max[axis]; });
+		}
+
+	int32 child1 = BuildRange(leaves, splitCount);
+	int32 child2 = BuildRange(leaves + splitCount, count - splitCount);
+
+	// AllocateNode() may grow the node array, no references across this call
+	int32 index = AllocateNode();
+	Node &node = Nodes[index];
+	const Node &node1 = Nodes[child1];
+	const Node &node2 = Nodes[child2];
+	node.Child1 = child1;
+	node.Child2 = child2;
+	node.Box = FakeAABB::Merge(node1.Box, node2.Box);
+	node.Height = 1 + (node1.Height > node2.Height ? node1.Height : node2.Height);
+
+	Nodes[child1].Parent = index;
+	Nodes[child2].Parent = index;
+	return index;
+	}
+
+void FakeDynamicAABBTree::Refit(int32 index)
+	{
+	while (index != NullNode)
+		{
+		Rotate(index);
+
+		Node &node = Nodes[index];
+		const Node &child1 = Nodes[node.Child1];
+		const Node &child2 = Nodes[node.Child2];
+		node.Box = FakeAABB::Merge(child1.Box, child2.Box);
+		node.Height = 1 + (child1.Height > child2.Height ? child1.Height : child2.Height);
+
+		index = node.Parent;
+		}
+	}
+
+void FakeDynamicAABBTree::Rotate(int32 indexA)
+	{
+	//         A
+	//       /   \
+	//      B     C
+	//     / \   / \
+	//    D   E F   G
+	// Swaps a child of A with a grandchild on the other side if that shrinks the surface area
+	Node &a = Nodes[indexA];
+	if (a.Height < 2)
+		return;
+
+	int32 indexB = a.Child1;
+	int32 indexC = a.Child2;
+	Node &b = Nodes[indexB];
+	Node &c = Nodes[indexC];
+
+	enum class Rotation { None, BF, BG, CD, CE };
+	Rotation best = Rotation::None;
+
+	float areaB = b.Box.GetPerimeter();
+	float areaC = c.Box.GetPerimeter();
+	float bestCost = areaB + areaC;
+
+	if (!c.IsLeaf())
+		{
+		// B moves below C, C then encloses B and one of its former children
+		float costBF = areaB + FakeAABB::Merge(b.Box, Nodes[c.Child2].Box).GetPerimeter();
+		float costBG = areaB + FakeAABB::Merge(b.Box, Nodes[c.Child1].Box).GetPerimeter();
+		if (costBF < bestCost) { best = Rotation::BF; bestCost = costBF; }
+		if (costBG < bestCost) { best = Rotation::BG; bestCost = costBG; }
+		}
+
+	if (!b.IsLeaf())
+		{
+		float costCD = areaC + FakeAABB::Merge(c.Box, Nodes[b.Child2].Box).GetPerimeter();
+		float costCE = areaC + FakeAABB::Merge(c.Box, Nodes[b.Child1].Box).GetPerimeter();
+		if (costCD < bestCost) { best = Rotation::CD; bestCost = costCD; }
+		if (costCE < bestCost) { best = Rotation::CE; bestCost = costCE; }
+		}
+
+	// Swaps the child of A with the grandchild below the other child of A
+	auto swap = [this, indexA](int32 indexChild, int32 indexOther, bool first)
+		{
+		Node &other = Nodes[indexOther];
+		int32 indexGrandChild = first ? other.Child1 : other.Child2;
+
+		Node &parent = Nodes[indexA];
+		if (parent.Child1 == indexChild)
+			parent.Child1 = indexGrandChild;
+		else
+			parent.Child2 = indexGrandChild;
+		Nodes[indexGrandChild].Parent = indexA;
+
+		if (first)
+			other.Child1 = indexChild;
+		else
+			other.Child2 = indexChild;
+		Nodes[indexChild].Parent = indexOther;
+
+		const Node &child1 = Nodes[other.Child1];
+		const Node &child2 = Nodes[other.Child2];
+		other.Box = FakeAABB::Merge(child1.Box, child2.Box);
+		other.Height = 1 + (child1.Height > child2.Height ? child1.Height : child2.Height);
+		};
+
+	switch (best)
+		{
+		case Rotation::BF: swap(indexB, indexC, true); break;
+		case Rotation::BG: swap(indexB, indexC, false); break;
+		case Rotation::CD: swap(indexC, indexB, true); break;
+		case Rotation::CE: swap(indexC, indexB, false); break;
+		default: break;
+		}
+	}
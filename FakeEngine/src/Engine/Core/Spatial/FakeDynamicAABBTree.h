@@ -0,0 +1,294 @@
+/*****************************************************************
+ * \file   FakeDynamicAABBTree.h
+ * \brief  
+ * 
+ * \author Can Karka
+ * \date   February 2021
+ * 
+ * Copyright (C) 2021 Can Karka
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *********************************************************************/
+
+#pragma once
+
+#include "Engine/Core/FakeCore.h"
+#include "Engine/Core/Maths/FakeMaths.h"
+
+/**
+ *
+ * Traversal stack of the spatial queries, lives on the stack until the tree gets unusually deep.
+ *
+ */
+class FakeSpatialStack
+	{
+	private:
+		uint32 Inline[128];
+		std::vector<uint32> Overflow;
+		uint32 Count = 0;
+
+	public:
+
+		void Push(uint32 value)
+			{
+			if (Count < 128)
+				Inline[Count] = value;
+			else
+				Overflow.push_back(value);
+
+			++Count;
+			}
+
+		uint32 Pop()
+			{
+			--Count;
+			if (Count < 128)
+				return Inline[Count];
+
+			uint32 value = Overflow.back();
+			Overflow.pop_back();
+			return value;
+			}
+
+		bool IsEmpty() const
+			{
+			return Count == 0;
+			}
+	};
+
+/**
+ *
+ * Bounding volume hierarchy for moving objects.
+ *
+ * Every proxy is stored with a fat box, which is the real box enlarged by a margin and the predicted motion.
+ * The tree is only modified once an object leaves its fat box, so small movements cost nothing.
+ * Leaves are inserted next to the sibling with the lowest surface area cost and every ancestor is rotated
+ * afterwards if that reduces the surface area, which keeps the tree balanced without rebuilding it.
+ *
+ * ### Usage
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~.cpp
+ * FakeDynamicAABBTree tree;
+ * int32 proxy = tree.CreateProxy(box, (uint32)entity);
+ * tree.MoveProxy(proxy, movedBox, movedBox.GetCenter() - box.GetCenter());
+ *
+ * tree.Query(FakeFrustum(viewProjection), [](uint32 userData, int32 proxyId) { Draw(userData); return true; });
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+class FAKE_API FakeDynamicAABBTree
+	{
+	public:
+
+		static const int32 NullNode = -1;
+
+	private:
+
+		struct Node
+			{
+			FakeAABB Box;
+			uint32 UserData = 0;
+
+			// Next free node while the node is in the free list
+			int32 Parent = NullNode;
+			int32 Child1 = NullNode;
+			int32 Child2 = NullNode;
+
+			// Leaves are at height 0, free nodes at -1
+			int32 Height = -1;
+
+			bool IsLeaf() const
+				{
+				return Child1 == NullNode;
+				}
+			};
+
+		// Leaves are copied out of the tree for Rebuild(), so the binning does not jump around in memory
+		struct BuildEntry
+			{
+			FakeAABB Box;
+			int32 Index;
+			};
+
+		std::vector<Node> Nodes;
+		int32 Root = NullNode;
+		int32 FreeList = NullNode;
+		uint32 ProxyCount = 0;
+		float Margin;
+		float DisplacementMultiplier;
+
+		int32 AllocateNode();
+		void FreeNode(int32 index);
+
+		void InsertLeaf(int32 leaf);
+		void RemoveLeaf(int32 leaf);
+		void Refit(int32 index);
+		void Rotate(int32 index);
+		int32 BuildRange(BuildEntry *leaves, uint32 count);
+
+	public:
+
+		/**
+		 *
+		 * @param margin Added on every side of a box, objects moving less than this never touch the tree.
+		 * @param displacementMultiplier Scales the displacement passed to MoveProxy(), the fat box is extended in the direction of motion.
+		 */
+		FakeDynamicAABBTree(float margin = 0.1f, float displacementMultiplier = 4.0f);
+
+		/**
+		 *
+		 * Inserts a new object.
+		 *
+		 * @param box The bounds of the object.
+		 * @param userData Returned by the queries, usually the entity.
+		 * @return Returns the id of the proxy.
+		 */
+		int32 CreateProxy(const FakeAABB &box, uint32 userData);
+
+		/**
+		 *
+		 * Inserts many objects at once. Large batches are not inserted one by one, the whole tree is rebuilt instead.
+		 *
+		 * @param boxes The bounds of the objects.
+		 * @param userData Returned by the queries, one entry per object.
+		 * @param count The number of objects.
+		 * @param outProxyIds Receives the id of the proxy of every object.
+		 */
+		void CreateProxies(const FakeAABB *boxes, const uint32 *userData, uint32 count, int32 *outProxyIds);
+
+		void DestroyProxy(int32 proxyId);
+
+		/**
+		 *
+		 * Updates the bounds of an object. The tree is only changed if the box has left the fat box of the proxy.
+		 *
+		 * @param proxyId The id returned by CreateProxy().
+		 * @param box The new bounds of the object.
+		 * @param displacement The distance the object has moved, used to predict the next fat box.
+		 * @return Returns true if the proxy has been reinserted.
+		 */
+		bool MoveProxy(int32 proxyId, const FakeAABB &box, const FakeVec3f &displacement);
+
+		/**
+		 *
+		 * Builds the tree from scratch with a binned surface area heuristic, which gives better trees than incremental insertion.
+		 * The ids of the proxies stay valid.
+		 *
+		 */
+		void Rebuild();
+
+		void Clear();
+
+		uint32 GetUserData(int32 proxyId) const { return Nodes[proxyId].UserData; }
+		const FakeAABB &GetFatAABB(int32 proxyId) const { return Nodes[proxyId].Box; }
+		uint32 GetProxyCount() const { return ProxyCount; }
+		int32 GetHeight() const { return Root == NullNode ? 0 : Nodes[Root].Height; }
+
+		/**
+		 *
+		 * Sum of the surface areas of all inner nodes divided by the surface area of the root, lower is better.
+		 *
+		 * @return Returns the quality metric of the tree.
+		 */
+		float GetAreaRatio() const;
+
+		/**
+		 *
+		 * Calls the function for every proxy whose fat box passes the test.
+		 * The function returns false to stop the query.
+		 *
+		 * @param overlaps Called with inner and leaf boxes, returns 0 for outside, 1 for intersecting and 2 for completely inside.
+		 * @param fn Called as fn(uint32 userData, int32 proxyId).
+		 */
+		template<typename Overlap, typename Fn>
+		void Traverse(Overlap &&overlaps, Fn &&fn) const
+			{
+			if (Root == NullNode)
+				return;
+
+			// The upper bit marks subtrees which are known to be completely inside
+			const uint32 insideFlag = 0x80000000u;
+
+			FakeSpatialStack stack;
+			stack.Push((uint32)Root);
+
+			while (!stack.IsEmpty())
+				{
+				uint32 entry = stack.Pop();
+				int32 index = (int32)(entry & ~insideFlag);
+				const Node &node = Nodes[index];
+
+				uint32 inside = entry & insideFlag;
+				if (!inside)
+					{
+					int32 result = overlaps(node.Box);
+					if (result == 0)
+						continue;
+
+					if (result == 2)
+						inside = insideFlag;
+					}
+
+				if (node.IsLeaf())
+					{
+					if (!fn(node.UserData, index))
+						return;
+
+					continue;
+					}
+
+				stack.Push((uint32)node.Child1 | inside);
+				stack.Push((uint32)node.Child2 | inside);
+				}
+			}
+
+		template<typename Fn>
+		void Query(const FakeAABB &box, Fn &&fn) const
+			{
+			Traverse([&box](const FakeAABB &nodeBox) { return box.Intersects(nodeBox) ? 1 : 0; }, fn);
+			}
+
+		template<typename Fn>
+		void Query(const FakeFrustum &frustum, Fn &&fn) const
+			{
+			Traverse([&frustum](const FakeAABB &nodeBox) { return frustum.Contains(nodeBox) ? 2 : (frustum.Intersects(nodeBox) ? 1 : 0); }, fn);
+			}
+
+		template<typename Fn>
+		void QueryRadius(const FakeVec3f &center, float radius, Fn &&fn) const
+			{
+			Traverse([&center, radius](const FakeAABB &nodeBox) { return nodeBox.IntersectsSphere(center, radius) ? 1 : 0; }, fn);
+			}
+
+		/**
+		 *
+		 * Calls the function for every proxy whose fat box is hit by the ray, in no particular order.
+		 *
+		 * @param ray The ray, the direction does not have to be normalized.
+		 * @param maxDistance Hits further away than this are ignored.
+		 * @param fn Called as fn(uint32 userData, int32 proxyId) and returns the new maximum distance, 0 stops the ray.
+		 */
+		template<typename Fn>
+		void Raycast(const FakeRay &ray, float maxDistance, Fn &&fn) const
+			{
+			Traverse([&ray, &maxDistance](const FakeAABB &nodeBox)
+				{
+				float distance;
+				return ray.Intersects(nodeBox, distance) && distance <= maxDistance ? 1 : 0;
+				},
+				[&fn, &maxDistance](uint32 userData, int32 proxyId)
+				{
+				maxDistance = fn(userData, proxyId);
+				return maxDistance > 0.0f;
+				});
+			}
+	};
+
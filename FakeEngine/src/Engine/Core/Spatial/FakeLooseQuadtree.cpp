@@ -0,0 +1,165 @@
+#include "FakePch.h"
+#include "FakeLooseQuadtree.h"
+
+FakeLooseQuadtree::FakeLooseQuadtree(const FakeAABB &worldBounds, uint32 depth)
+	{
+	Reset(worldBounds, depth);
+	}
+
+void FakeLooseQuadtree::Reset(const FakeAABB &worldBounds, uint32 depth)
+	{
+	FAKE_ASSERT(depth <= MaxDepth, "Quadtree is too deep!");
+
+	WorldBounds = worldBounds;
+	FakeVec3f size = worldBounds.GetSize();
+	WorldSize = size.X > size.Y ? size.X : size.Y;
+	Depth = depth;
+
+	uint32 cellCount = 0;
+	for (uint32 level = 0; level <= depth; ++level)
+		{
+		LevelOffsets[level] = cellCount;
+		cellCount += (1u << level) * (1u << level);
+		}
+
+	Cells.assign(cellCount, Cell());
+	Objects.clear();
+	FreeList = NullObject;
+	ObjectCount = 0;
+	}
+
+int32 FakeLooseQuadtree::Insert(const FakeAABB &box, uint32 userData)
+	{
+	int32 id;
+	if (FreeList != NullObject)
+		{
+		id = FreeList;
+		FreeList = Objects[id].Next;
+		}
+	else
+		{
+		id = (int32)Objects.size();
+		Objects.emplace_back();
+		}
+
+	Object &object = Objects[id];
+	object.Box = box;
+	object.UserData = userData;
+
+	// Cells use the world depth range, grow it instead of missing objects
+	WorldBounds.Min.Z = box.Min.Z < WorldBounds.Min.Z ? box.Min.Z : WorldBounds.Min.Z;
+	WorldBounds.Max.Z = box.Max.Z > WorldBounds.Max.Z ? box.Max.Z : WorldBounds.Max.Z;
+
+	Link(id, FindCell(box));
+	++ObjectCount;
+	return id;
+	}
+
+void FakeLooseQuadtree::Remove(int32 id)
+	{
+	FAKE_ASSERT(id >= 0 && id < (int32)Objects.size());
+
+	Unlink(id);
+	Objects[id].Next = FreeList;
+	FreeList = id;
+	--ObjectCount;
+	}
+
+bool FakeLooseQuadtree::Update(int32 id, const FakeAABB &box)
+	{
+	Object &object = Objects[id];
+	object.Box = box;
+
+	WorldBounds.Min.Z = box.Min.Z < WorldBounds.Min.Z ? box.Min.Z : WorldBounds.Min.Z;
+	WorldBounds.Max.Z = box.Max.Z > WorldBounds.Max.Z ? box.Max.Z : WorldBounds.Max.Z;
+
+	uint32 cell = FindCell(box);
+	if (cell == object.Cell)
+		return false;
+
+	Unlink(id);
+	Link(id, cell);
+	return true;
+	}
+
+uint32 FakeLooseQuadtree::FindCell(const FakeAABB &box) const
+	{
+	if (box.Min.X < WorldBounds.Min.X || box.Min.Y < WorldBounds.Min.Y || box.Max.X > WorldBounds.Min.X + WorldSize || box.Max.Y > WorldBounds.Min.Y + WorldSize)
+		return 0;
+
+	// The deepest level whose cells are at least as large as the object
+	float width = box.Max.X - box.Min.X;
+	float height = box.Max.Y - box.Min.Y;
+	float size = width > height ? width : height;
+
+	uint32 level = Depth;
+	float cellSize = WorldSize / (float)(1u << level);
+	while (level > 0 && size > cellSize)
+		{
+		--level;
+		cellSize *= 2.0f;
+		}
+
+	uint32 cellsPerAxis = 1u << level;
+	FakeVec3f center = box.GetCenter();
+	uint32 x = (uint32)((center.X - WorldBounds.Min.X) / cellSize);
+	uint32 y = (uint32)((center.Y - WorldBounds.Min.Y) / cellSize);
+	x = x < cellsPerAxis ? x : cellsPerAxis - 1;
+	y = y < cellsPerAxis ? y : cellsPerAxis - 1;
+
+	return GetCellIndex(level, x, y);
+	}
+
+void FakeLooseQuadtree::Link(int32 id, uint32 cell)
+	{
+	Object &object = Objects[id];
+	object.Cell = cell;
+	object.Prev = NullObject;
+	object.Next = Cells[cell].First;
+
+	if (object.Next != NullObject)
+		Objects[object.Next].Prev = id;
+
+	Cells[cell].First = id;
+	UpdateSubtreeCounts(cell, 1);
+	}
+
+void FakeLooseQuadtree::Unlink(int32 id)
+	{
+	Object &object = Objects[id];
+
+	if (object.Prev != NullObject)
+		Objects[object.Prev].Next = object.Next;
+	else
+		Cells[object.Cell].First = object.Next;
+
+	if (object.Next != NullObject)
+		Objects[object.Next].Prev = object.Prev;
+
+	object.Next = NullObject;
+	object.Prev = NullObject;
+	UpdateSubtreeCounts(object.Cell, -1);
+	}
+
+void FakeLooseQuadtree::UpdateSubtreeCounts(uint32 cell, int32 delta)
+	{
+	// Recover level and coordinates, then walk up to the root
+	uint32 level = Depth;
+	while (LevelOffsets[level] > cell)
+		--level;
+
+	uint32 index = cell - LevelOffsets[level];
+	uint32 x = index & ((1u << level) - 1);
+	uint32 y = index >> level;
+
+	for (;;)
+		{
+		Cells[GetCellIndex(level, x, y)].SubtreeCount += delta;
+		if (level == 0)
+			break;
+
+		--level;
+		x >>= 1;
+		y >>= 1;
+		}
+	}
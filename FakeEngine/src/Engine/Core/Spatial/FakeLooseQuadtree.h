@@ -0,0 +1,234 @@
+/*****************************************************************
+ * \file   FakeLooseQuadtree.h
+ * \brief  
+ * 
+ * \author Can Karka
+ * \date   February 2021
+ * 
+ * Copyright (C) 2021 Can Karka
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *********************************************************************/
+
+#pragma once
+
+#include "Engine/Core/FakeCore.h"
+#include "Engine/Core/Maths/FakeMaths.h"
+#include "FakeDynamicAABBTree.h"
+
+/**
+ *
+ * Loose quadtree over the XY plane for 2D scenes.
+ *
+ * Every cell accepts objects up to its own size whose center lies inside of it, its bounds are doubled to hold them.
+ * An object's level and cell follow directly from its size and position, so inserting and moving never searches the tree.
+ * Objects outside of the world bounds are kept in the root cell.
+ * Queries use the same callbacks as FakeDynamicAABBTree.
+ *
+ */
+class FAKE_API FakeLooseQuadtree
+	{
+	public:
+
+		static const int32 NullObject = -1;
+		static const uint32 MaxDepth = 12;
+
+	private:
+
+		struct Object
+			{
+			FakeAABB Box;
+			uint32 UserData = 0;
+			uint32 Cell = 0;
+
+			// Next free object while the object is in the free list
+			int32 Next = NullObject;
+			int32 Prev = NullObject;
+			};
+
+		struct Cell
+			{
+			int32 First = NullObject;
+
+			// Objects in this cell and all cells below it, empty subtrees are skipped by the queries
+			uint32 SubtreeCount = 0;
+			};
+
+		std::vector<Cell> Cells;
+		uint32 LevelOffsets[MaxDepth + 1];
+		std::vector<Object> Objects;
+		int32 FreeList = NullObject;
+		uint32 ObjectCount = 0;
+
+		FakeAABB WorldBounds;
+		float WorldSize = 0.0f;
+		uint32 Depth = 0;
+
+		uint32 GetCellIndex(uint32 level, uint32 x, uint32 y) const
+			{
+			return LevelOffsets[level] + y * (1u << level) + x;
+			}
+
+		FakeAABB GetLooseCellBounds(uint32 level, uint32 x, uint32 y) const
+			{
+			float cellSize = WorldSize / (float)(1u << level);
+			FakeVec3f min(WorldBounds.Min.X + ((float)x - 0.5f) * cellSize, WorldBounds.Min.Y + ((float)y - 0.5f) * cellSize, WorldBounds.Min.Z);
+			FakeVec3f max(min.X + cellSize * 2.0f, min.Y + cellSize * 2.0f, WorldBounds.Max.Z);
+			return FakeAABB(min, max);
+			}
+
+		uint32 FindCell(const FakeAABB &box) const;
+		void Link(int32 id, uint32 cell);
+		void Unlink(int32 id);
+		void UpdateSubtreeCounts(uint32 cell, int32 delta);
+
+	public:
+
+		/**
+		 *
+		 * @param worldBounds The area covered by the tree, only X and Y are used for the subdivision.
+		 * @param depth The number of levels below the root, at most MaxDepth.
+		 */
+		FakeLooseQuadtree(const FakeAABB &worldBounds = FakeAABB(FakeVec3f(-1024.0f, -1024.0f, -1024.0f), FakeVec3f(1024.0f, 1024.0f, 1024.0f)), uint32 depth = 8);
+
+		/**
+		 *
+		 * Removes all objects and changes the subdivision.
+		 *
+		 * @param worldBounds The area covered by the tree, only X and Y are used for the subdivision.
+		 * @param depth The number of levels below the root, at most MaxDepth.
+		 */
+		void Reset(const FakeAABB &worldBounds, uint32 depth);
+
+		int32 Insert(const FakeAABB &box, uint32 userData);
+		void Remove(int32 id);
+
+		/**
+		 *
+		 * Updates the bounds of an object.
+		 *
+		 * @param id The id returned by Insert().
+		 * @param box The new bounds.
+		 * @return Returns true if the object has moved to another cell.
+		 */
+		bool Update(int32 id, const FakeAABB &box);
+
+		uint32 GetUserData(int32 id) const { return Objects[id].UserData; }
+		const FakeAABB &GetAABB(int32 id) const { return Objects[id].Box; }
+		uint32 GetObjectCount() const { return ObjectCount; }
+
+		/**
+		 *
+		 * Calls the function for every object whose box passes the test.
+		 * The function returns false to stop the query.
+		 *
+		 * @param overlaps Called with cell and object boxes, returns 0 for outside, 1 for intersecting and 2 for completely inside.
+		 * @param fn Called as fn(uint32 userData, int32 id).
+		 */
+		template<typename Overlap, typename Fn>
+		void Traverse(Overlap &&overlaps, Fn &&fn) const
+			{
+			if (Cells.empty() || Cells[0].SubtreeCount == 0)
+				return;
+
+			// Entries are packed as inside flag | level | y | x
+			const uint32 insideFlag = 0x80000000u;
+
+			FakeSpatialStack stack;
+			stack.Push(0);
+
+			while (!stack.IsEmpty())
+				{
+				uint32 entry = stack.Pop();
+				uint32 level = (entry >> 26) & 0xf;
+				uint32 y = (entry >> 13) & 0x1fff;
+				uint32 x = entry & 0x1fff;
+
+				const Cell &cell = Cells[GetCellIndex(level, x, y)];
+				if (cell.SubtreeCount == 0)
+					continue;
+
+				// The root also holds the objects outside of the world, it is always visited
+				uint32 inside = entry & insideFlag;
+				if (!inside && level > 0)
+					{
+					int32 result = overlaps(GetLooseCellBounds(level, x, y));
+					if (result == 0)
+						continue;
+
+					if (result == 2)
+						inside = insideFlag;
+					}
+
+				for (int32 id = cell.First; id != NullObject; id = Objects[id].Next)
+					{
+					const Object &object = Objects[id];
+					if ((inside || overlaps(object.Box) != 0) && !fn(object.UserData, id))
+						return;
+					}
+
+				if (level == Depth)
+					continue;
+
+				uint32 childLevel = (level + 1) << 26;
+				for (uint32 i = 0; i < 4; ++i)
+					{
+					uint32 childX = x * 2 + (i & 1);
+					uint32 childY = y * 2 + (i >> 1);
+					stack.Push(inside | childLevel | (childY << 13) | childX);
+					}
+				}
+			}
+
+		template<typename Fn>
+		void Query(const FakeAABB &box, Fn &&fn) const
+			{
+			Traverse([&box](const FakeAABB &other) { return box.Intersects(other) ? 1 : 0; }, fn);
+			}
+
+		template<typename Fn>
+		void Query(const FakeFrustum &frustum, Fn &&fn) const
+			{
+			Traverse([&frustum](const FakeAABB &other) { return frustum.Contains(other) ? 2 : (frustum.Intersects(other) ? 1 : 0); }, fn);
+			}
+
+		template<typename Fn>
+		void QueryRadius(const FakeVec3f &center, float radius, Fn &&fn) const
+			{
+			Traverse([&center, radius](const FakeAABB &other) { return other.IntersectsSphere(center, radius) ? 1 : 0; }, fn);
+			}
+
+		/**
+		 *
+		 * Calls the function for every object whose box is hit by the ray, in no particular order.
+		 *
+		 * @param ray The ray, the direction does not have to be normalized.
+		 * @param maxDistance Hits further away than this are ignored.
+		 * @param fn Called as fn(uint32 userData, int32 id) and returns the new maximum distance, 0 stops the ray.
+		 */
+		template<typename Fn>
+		void Raycast(const FakeRay &ray, float maxDistance, Fn &&fn) const
+			{
+			Traverse([&ray, &maxDistance](const FakeAABB &other)
+				{
+				float distance;
+				return ray.Intersects(other, distance) && distance <= maxDistance ? 1 : 0;
+				},
+				[&fn, &maxDistance](uint32 userData, int32 id)
+				{
+				maxDistance = fn(userData, id);
+				return maxDistance > 0.0f;
+				});
+			}
+	};
+
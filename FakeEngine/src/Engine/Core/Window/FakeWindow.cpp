@@ -1,7 +1,10 @@
 #include "FakePch.h"
 #include "FakeWindow.h"
 
-#include "Engine/Platform/Windows/FakeWindowsWindow.h"
+#ifdef FAKE_PLATFORM_WINDOWS
+	#include "Engine/Platform/Windows/FakeWindowsWindow.h"
+#endif
+
 #include "Engine/Platform/GLFW/FakeGLFWWindow.h"
 
 Scope<FakeWindow> FakeWindow::Create(const FakeString &title, uint32 width, uint32 height)
@@ -12,6 +15,8 @@ Scope<FakeWindow> FakeWindow::Create(const FakeString &title, uint32 width, uint
 		#elif FAKE_WINAPI_GLFW
 			return CreateScope<FakeGLFWWindow>(title, width, height);
 		#endif
+	#elif FAKE_WINAPI_GLFW
+		return CreateScope<FakeGLFWWindow>(title, width, height);
 	#else
 		return nullptr;
 	#endif
@@ -25,6 +30,8 @@ Scope<FakeWindow> FakeWindow::Create(const FakeWindowData &data)
 		#elif FAKE_WINAPI_GLFW
 			return CreateScope<FakeGLFWWindow>(data);
 		#endif
+	#elif FAKE_WINAPI_GLFW
+		return CreateScope<FakeGLFWWindow>(data);
 	#else
 		return nullptr;
 	#endif
@@ -0,0 +1,448 @@
+#include "FakePch.h"
+#include "FakePhysicsWorld.h"
+
+#include <box2d/box2d.h>
+
+#include "Engine/Core/Jobs/FakeJobSystem.h"
+#include "Engine/Scene/Components/FakeTransformComponent.h"
+#include "Engine/Scene/Components/FakeRigidbodyComponent.h"
+#include "Engine/Scene/Components/FakeColliderComponents.h"
+
+// Bodies per job while gathering and writing poses
+static const uint32 PoseGrainSize = 2048;
+
+static const uint8 BodyResting = 0;
+static const uint8 BodyMoving = 1;
+static const uint8 BodySettled = 2;
+
+namespace Utils
+	{
+	static void *fake_entity_to_user_data(entt::entity entity)
+		{
+		return (void*)(uintptr_t)entity;
+		}
+
+	static entt::entity fake_body_entity(const b2Body *body)
+		{
+		return (entt::entity)(uintptr_t)body->GetUserData();
+		}
+
+	static void fake_parallel_for(uint32 count, const FakeJobRangeFunction &fn)
+		{
+		if (FakeJobSystem::IsInitialized())
+			FakeJobSystem::ParallelFor(count, PoseGrainSize, fn);
+		else
+			fn(0, count);
+		}
+
+	template<typename T>
+	static b2Fixture *fake_create_fixture(b2Body *body, const T &collider, const b2Shape &shape)
+		{
+		b2FixtureDef fixtureDef;
+		fixtureDef.shape = &shape;
+		fixtureDef.density = collider.Density;
+		fixtureDef.friction = collider.Friction;
+		fixtureDef.restitution = collider.Restitution;
+		fixtureDef.isSensor = collider.IsSensor;
+		return body->CreateFixture(&fixtureDef);
+		}
+
+	static b2Fixture *fake_create_fixture(b2Body *body, const FakeBoxColliderComponent &collider, const FakeVec3f &scale)
+		{
+		b2PolygonShape shape;
+		shape.SetAsBox(collider.Size.X * scale.X, collider.Size.Y * scale.Y, b2Vec2(collider.Offset.X * scale.X, collider.Offset.Y * scale.Y), 0.0f);
+		return fake_create_fixture(body, collider, shape);
+		}
+
+	static b2Fixture *fake_create_fixture(b2Body *body, const FakeCircleColliderComponent &collider, const FakeVec3f &scale)
+		{
+		b2CircleShape shape;
+		shape.m_p.Set(collider.Offset.X * scale.X, collider.Offset.Y * scale.Y);
+		shape.m_radius = collider.Radius * (scale.X > scale.Y ? scale.X : scale.Y);
+		return fake_create_fixture(body, collider, shape);
+		}
+	}
+
+/**
+ *
+ * Queues the contacts reported by Box2D, the world is locked while they are reported.
+ *
+ */
+class FakeContactListener : public b2ContactListener
+	{
+	private:
+		std::vector<FakeContactEvent> &Events;
+
+		void Record(b2Contact *contact, FakeContactEvent::Type type)
+			{
+			FakeContactEvent &event = Events.emplace_back();
+			event.EventType = type;
+			event.EntityA = Utils::fake_body_entity(contact->GetFixtureA()->GetBody());
+			event.EntityB = Utils::fake_body_entity(contact->GetFixtureB()->GetBody());
+			}
+
+	public:
+
+		FakeContactListener(std::vector<FakeContactEvent> &events)
+			: Events(events)
+			{
+			}
+
+		void BeginContact(b2Contact *contact) override
+			{
+			Record(contact, FakeContactEvent::Type::Begin);
+			}
+
+		void EndContact(b2Contact *contact) override
+			{
+			Record(contact, FakeContactEvent::Type::End);
+			}
+	};
+
+FakePhysicsWorld::FakePhysicsWorld(entt::registry &registry, const FakeVec2f &gravity)
+	: Registry(registry)
+	{
+	World = CreateScope<b2World>(b2Vec2(gravity.X, gravity.Y));
+	ContactListener = CreateScope<FakeContactListener>(ContactEvents);
+	World->SetContactListener(ContactListener.get());
+
+	Registry.on_construct<FakeRigidbodyComponent>().connect<&FakePhysicsWorld::OnRigidbodyConstructed>(*this);
+	Registry.on_update<FakeRigidbodyComponent>().connect<&FakePhysicsWorld::OnRigidbodyUpdated>(*this);
+	Registry.on_destroy<FakeRigidbodyComponent>().connect<&FakePhysicsWorld::OnRigidbodyDestroyed>(*this);
+
+	Registry.on_construct<FakeBoxColliderComponent>().connect<&FakePhysicsWorld::OnColliderConstructed<FakeBoxColliderComponent>>(*this);
+	Registry.on_update<FakeBoxColliderComponent>().connect<&FakePhysicsWorld::OnColliderUpdated<FakeBoxColliderComponent>>(*this);
+	Registry.on_destroy<FakeBoxColliderComponent>().connect<&FakePhysicsWorld::OnColliderDestroyed<FakeBoxColliderComponent>>(*this);
+
+	Registry.on_construct<FakeCircleColliderComponent>().connect<&FakePhysicsWorld::OnColliderConstructed<FakeCircleColliderComponent>>(*this);
+	Registry.on_update<FakeCircleColliderComponent>().connect<&FakePhysicsWorld::OnColliderUpdated<FakeCircleColliderComponent>>(*this);
+	Registry.on_destroy<FakeCircleColliderComponent>().connect<&FakePhysicsWorld::OnColliderDestroyed<FakeCircleColliderComponent>>(*this);
+	}
+
+FakePhysicsWorld::~FakePhysicsWorld()
+	{
+	// The registry outlives the world, components destroyed with it must not reach the deleted bodies
+	Registry.on_construct<FakeRigidbodyComponent>().disconnect(*this);
+	Registry.on_update<FakeRigidbodyComponent>().disconnect(*this);
+	Registry.on_destroy<FakeRigidbodyComponent>().disconnect(*this);
+	Registry.on_construct<FakeBoxColliderComponent>().disconnect(*this);
+	Registry.on_update<FakeBoxColliderComponent>().disconnect(*this);
+	Registry.on_destroy<FakeBoxColliderComponent>().disconnect(*this);
+	Registry.on_construct<FakeCircleColliderComponent>().disconnect(*this);
+	Registry.on_update<FakeCircleColliderComponent>().disconnect(*this);
+	Registry.on_destroy<FakeCircleColliderComponent>().disconnect(*this);
+	}
+
+uint32 FakePhysicsWorld::Step(FakeTimeStep ts)
+	{
+	CreatePendingBodies();
+
+	Accumulator += (float)ts.GetSeconds();
+	uint32 stepCount = (uint32)(Accumulator / FixedTimeStep);
+	if (stepCount > MaxSubSteps)
+		{
+		// Drop the time which can not be caught up with, the simulation slows down instead of stalling the next frames
+		stepCount = MaxSubSteps;
+		Accumulator = FixedTimeStep * (float)MaxSubSteps + fmodf(Accumulator, FixedTimeStep);
+		}
+
+	for (uint32 i = 0; i < stepCount; ++i)
+		{
+		World->Step(FixedTimeStep, VelocityIterations, PositionIterations);
+		Accumulator -= FixedTimeStep;
+
+		// Interpolation only needs the poses of the last two steps
+		if (i + 2 >= stepCount)
+			GatherPoses();
+		}
+
+	Alpha = Accumulator / FixedTimeStep;
+	if (Alpha < 0.0f)
+		Alpha = 0.0f;
+	else if (Alpha > 1.0f)
+		Alpha = 1.0f;
+
+	WriteTransforms();
+
+	// Contacts of this frame are reported once the world is unlocked again
+	FrameContactEvents.swap(ContactEvents);
+	ContactEvents.clear();
+
+	if (ContactCallback)
+		{
+		for (const FakeContactEvent &event : FrameContactEvents)
+			ContactCallback(event);
+		}
+
+	return stepCount;
+	}
+
+void FakePhysicsWorld::Teleport(entt::entity entity, const FakeVec2f &position, float angle)
+	{
+	FakeRigidbodyComponent &rigidbody = Registry.get<FakeRigidbodyComponent>(entity);
+	if (!rigidbody.RuntimeBody)
+		{
+		// The body does not exist yet and will start at the transform
+		Registry.patch<FakeTransformComponent>(entity, [&position, angle](FakeTransformComponent &transform)
+			{
+			transform.Translation.X = position.X;
+			transform.Translation.Y = position.Y;
+			transform.Rotation.Z = angle;
+			});
+
+		return;
+		}
+
+	rigidbody.RuntimeBody->SetTransform(b2Vec2(position.X, position.Y), angle);
+
+	uint32 index = rigidbody.RuntimeIndex;
+	CurrentPoses[index] = FakeVec3f(position.X, position.Y, angle);
+	PreviousPoses[index] = CurrentPoses[index];
+
+	// Sleeping bodies are written once more by the next Step()
+	if (MovingStates[index] == BodyResting)
+		MovingStates[index] = BodySettled;
+	}
+
+void FakePhysicsWorld::SetGravity(const FakeVec2f &gravity)
+	{
+	World->SetGravity(b2Vec2(gravity.X, gravity.Y));
+	}
+
+FakeVec2f FakePhysicsWorld::GetGravity() const
+	{
+	b2Vec2 gravity = World->GetGravity();
+	return FakeVec2f(gravity.x, gravity.y);
+	}
+
+void FakePhysicsWorld::SetFixedTimeStep(float seconds, uint32 maxSubSteps)
+	{
+	FAKE_ASSERT(seconds > 0.0f, "The fixed time step must be positive!");
+
+	FixedTimeStep = seconds;
+	MaxSubSteps = maxSubSteps;
+	}
+
+void FakePhysicsWorld::SetSolverIterations(int32 velocityIterations, int32 positionIterations)
+	{
+	VelocityIterations = velocityIterations;
+	PositionIterations = positionIterations;
+	}
+
+void FakePhysicsWorld::CreatePendingBodies()
+	{
+	for (entt::entity entity : PendingBodies)
+		{
+		// Destroyed again before the first step
+		if (!Registry.valid(entity))
+			continue;
+
+		FakeRigidbodyComponent *rigidbody = Registry.try_get<FakeRigidbodyComponent>(entity);
+		if (!rigidbody || rigidbody->RuntimeBody)
+			continue;
+
+		const FakeTransformComponent &transform = Registry.get<FakeTransformComponent>(entity);
+
+		b2BodyDef bodyDef;
+		bodyDef.type = (b2BodyType)rigidbody->Type;
+		bodyDef.position.Set(transform.Translation.X, transform.Translation.Y);
+		bodyDef.angle = transform.Rotation.Z;
+		bodyDef.fixedRotation = rigidbody->FixedRotation;
+		bodyDef.bullet = rigidbody->Bullet;
+		bodyDef.gravityScale = rigidbody->GravityScale;
+		bodyDef.linearDamping = rigidbody->LinearDamping;
+		bodyDef.angularDamping = rigidbody->AngularDamping;
+		bodyDef.userData = Utils::fake_entity_to_user_data(entity);
+
+		b2Body *body = World->CreateBody(&bodyDef);
+		rigidbody->RuntimeBody = body;
+		rigidbody->RuntimeIndex = (uint32)Bodies.size();
+
+		FakeVec3f pose(transform.Translation.X, transform.Translation.Y, transform.Rotation.Z);
+		Bodies.push_back(body);
+		BodyEntities.push_back(entity);
+		PreviousPoses.push_back(pose);
+		CurrentPoses.push_back(pose);
+		MovingStates.push_back(BodyResting);
+
+		CreateFixtures(entity, body);
+		}
+
+	PendingBodies.clear();
+	}
+
+void FakePhysicsWorld::GatherPoses()
+	{
+	Utils::fake_parallel_for((uint32)Bodies.size(), [this](uint32 begin, uint32 end)
+		{
+		for (uint32 i = begin; i < end; ++i)
+			{
+			const b2Body *body = Bodies[i];
+			PreviousPoses[i] = CurrentPoses[i];
+
+			// Static bodies keep the awake flag in Box2D, but never move
+			if (body->IsAwake() && body->GetType() != b2_staticBody)
+				{
+				const b2Vec2 &position = body->GetPosition();
+				CurrentPoses[i] = FakeVec3f(position.x, position.y, body->GetAngle());
+				MovingStates[i] = BodyMoving;
+				}
+			else if (MovingStates[i] == BodyMoving)
+				{
+				// Fell asleep, the final pose still has to be written
+				MovingStates[i] = BodySettled;
+				}
+			}
+		});
+	}
+
+void FakePhysicsWorld::WriteTransforms()
+	{
+	// Sleeping and static bodies are skipped, most of a level usually rests
+	MovingBodies.clear();
+	uint32 count = (uint32)Bodies.size();
+	for (uint32 i = 0; i < count; ++i)
+		{
+		if (MovingStates[i] != BodyResting)
+			MovingBodies.push_back(i);
+		}
+
+	uint32 movingCount = (uint32)MovingBodies.size();
+	MovedEntities.resize(movingCount);
+
+	// A view does not touch the pool list of the registry, so it is safe to use from the jobs
+	auto view = Registry.view<FakeTransformComponent>();
+	float alpha = Alpha;
+
+	Utils::fake_parallel_for(movingCount, [this, &view, alpha](uint32 begin, uint32 end)
+		{
+		for (uint32 i = begin; i < end; ++i)
+			{
+			uint32 index = MovingBodies[i];
+			entt::entity entity = BodyEntities[index];
+
+			FakeVec3f pose;
+			FakeVec3f::Lerp(PreviousPoses[index], CurrentPoses[index], alpha, pose);
+
+			FakeTransformComponent &transform = view.get<FakeTransformComponent>(entity);
+			transform.Translation.X = pose.X;
+			transform.Translation.Y = pose.Y;
+			transform.Rotation.Z = pose.Z;
+
+			MovedEntities[i] = entity;
+			if (MovingStates[index] == BodySettled)
+				MovingStates[index] = BodyResting;
+			}
+		});
+	}
+
+void FakePhysicsWorld::CreateFixtures(entt::entity entity, b2Body *body)
+	{
+	const FakeVec3f &scale = Registry.get<FakeTransformComponent>(entity).Scale;
+
+	if (FakeBoxColliderComponent *box = Registry.try_get<FakeBoxColliderComponent>(entity))
+		box->RuntimeFixture = Utils::fake_create_fixture(body, *box, scale);
+
+	if (FakeCircleColliderComponent *circle = Registry.try_get<FakeCircleColliderComponent>(entity))
+		circle->RuntimeFixture = Utils::fake_create_fixture(body, *circle, scale);
+	}
+
+void FakePhysicsWorld::OnRigidbodyConstructed(entt::registry &registry, entt::entity entity)
+	{
+	// Copied components must not share the body of their source
+	FakeRigidbodyComponent &rigidbody = registry.get<FakeRigidbodyComponent>(entity);
+	rigidbody.RuntimeBody = nullptr;
+	rigidbody.RuntimeIndex = ~0u;
+
+	// Created by the next Step(), once all colliders have been added
+	PendingBodies.push_back(entity);
+	}
+
+void FakePhysicsWorld::OnRigidbodyUpdated(entt::registry &registry, entt::entity entity)
+	{
+	const FakeRigidbodyComponent &rigidbody = registry.get<FakeRigidbodyComponent>(entity);
+	b2Body *body = rigidbody.RuntimeBody;
+	if (!body)
+		return;
+
+	body->SetType((b2BodyType)rigidbody.Type);
+	body->SetFixedRotation(rigidbody.FixedRotation);
+	body->SetBullet(rigidbody.Bullet);
+	body->SetGravityScale(rigidbody.GravityScale);
+	body->SetLinearDamping(rigidbody.LinearDamping);
+	body->SetAngularDamping(rigidbody.AngularDamping);
+	}
+
+void FakePhysicsWorld::OnRigidbodyDestroyed(entt::registry &registry, entt::entity entity)
+	{
+	FakeRigidbodyComponent &rigidbody = registry.get<FakeRigidbodyComponent>(entity);
+	if (!rigidbody.RuntimeBody)
+		return;
+
+	// The fixtures are destroyed together with the body
+	if (FakeBoxColliderComponent *box = registry.try_get<FakeBoxColliderComponent>(entity))
+		box->RuntimeFixture = nullptr;
+
+	if (FakeCircleColliderComponent *circle = registry.try_get<FakeCircleColliderComponent>(entity))
+		circle->RuntimeFixture = nullptr;
+
+	World->DestroyBody(rigidbody.RuntimeBody);
+	rigidbody.RuntimeBody = nullptr;
+
+	// Move the last body into the gap to keep the arrays dense
+	uint32 index = rigidbody.RuntimeIndex;
+	uint32 last = (uint32)Bodies.size() - 1;
+	if (index != last)
+		{
+		Bodies[index] = Bodies[last];
+		BodyEntities[index] = BodyEntities[last];
+		PreviousPoses[index] = PreviousPoses[last];
+		CurrentPoses[index] = CurrentPoses[last];
+		MovingStates[index] = MovingStates[last];
+		registry.get<FakeRigidbodyComponent>(BodyEntities[index]).RuntimeIndex = index;
+		}
+
+	Bodies.pop_back();
+	BodyEntities.pop_back();
+	PreviousPoses.pop_back();
+	CurrentPoses.pop_back();
+	MovingStates.pop_back();
+	rigidbody.RuntimeIndex = ~0u;
+	}
+
+template<typename T>
+void FakePhysicsWorld::OnColliderConstructed(entt::registry &registry, entt::entity entity)
+	{
+	// Copied components must not share the fixture of their source
+	T &collider = registry.get<T>(entity);
+	collider.RuntimeFixture = nullptr;
+
+	// Without a body yet the fixture is created together with it
+	const FakeRigidbodyComponent *rigidbody = registry.try_get<FakeRigidbodyComponent>(entity);
+	if (rigidbody && rigidbody->RuntimeBody)
+		collider.RuntimeFixture = Utils::fake_create_fixture(rigidbody->RuntimeBody, collider, registry.get<FakeTransformComponent>(entity).Scale);
+	}
+
+template<typename T>
+void FakePhysicsWorld::OnColliderUpdated(entt::registry &registry, entt::entity entity)
+	{
+	// Box2D shapes can not be changed, the fixture is replaced
+	T &collider = registry.get<T>(entity);
+	if (!collider.RuntimeFixture)
+		return;
+
+	b2Body *body = collider.RuntimeFixture->GetBody();
+	body->DestroyFixture(collider.RuntimeFixture);
+	collider.RuntimeFixture = Utils::fake_create_fixture(body, collider, registry.get<FakeTransformComponent>(entity).Scale);
+	}
+
+template<typename T>
+void FakePhysicsWorld::OnColliderDestroyed(entt::registry &registry, entt::entity entity)
+	{
+	T &collider = registry.get<T>(entity);
+	if (!collider.RuntimeFixture)
+		return;
+
+	collider.RuntimeFixture->GetBody()->DestroyFixture(collider.RuntimeFixture);
+	collider.RuntimeFixture = nullptr;
+	}
@@ -0,0 +1,153 @@
+/*****************************************************************
+ * \file   FakePhysicsWorld.h
+ * \brief  
+ * 
+ * \author Can Karka
+ * \date   February 2021
+ * 
+ * Copyright (C) 2021 Can Karka
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *********************************************************************/
+
+#pragma once
+
+#include <entt/entt.hpp>
+#include "Engine/Core/FakeCore.h"
+#include "Engine/Core/FakeTimeStep.h"
+#include "Engine/Core/Maths/FakeMaths.h"
+
+class b2World;
+class b2Body;
+class FakeContactListener;
+
+struct FakeContactEvent
+	{
+	enum class Type
+		{
+		Begin = 0,
+		End
+		};
+
+	Type EventType;
+	entt::entity EntityA;
+	entt::entity EntityB;
+	};
+
+using FakeContactCallback = std::function<void(const FakeContactEvent&)>;
+
+/**
+ *
+ * Box2D world of a scene, which simulates all entities with a FakeRigidbodyComponent.
+ *
+ * The simulation runs with a fixed time step, independent of the frame rate. Every frame the poses of the
+ * last two steps are interpolated and written into the transforms of all moving bodies at once.
+ * Contacts are queued while stepping and reported after the transforms have been written, so the callback
+ * may safely create and destroy entities.
+ *
+ */
+class FAKE_API FakePhysicsWorld
+	{
+	private:
+		entt::registry &Registry;
+		Scope<b2World> World;
+		Scope<FakeContactListener> ContactListener;
+
+		float FixedTimeStep = 1.0f / 60.0f;
+		uint32 MaxSubSteps = 8;
+		int32 VelocityIterations = 8;
+		int32 PositionIterations = 3;
+		float Accumulator = 0.0f;
+		float Alpha = 0.0f;
+
+		// Per body state indexed by FakeRigidbodyComponent::RuntimeIndex, a pose is (X, Y, angle)
+		std::vector<b2Body*> Bodies;
+		std::vector<entt::entity> BodyEntities;
+		std::vector<FakeVec3f> PreviousPoses;
+		std::vector<FakeVec3f> CurrentPoses;
+		std::vector<uint8> MovingStates;
+
+		std::vector<entt::entity> PendingBodies;
+		std::vector<uint32> MovingBodies;
+		std::vector<entt::entity> MovedEntities;
+
+		std::vector<FakeContactEvent> ContactEvents;
+		std::vector<FakeContactEvent> FrameContactEvents;
+		FakeContactCallback ContactCallback;
+
+		void CreatePendingBodies();
+		void GatherPoses();
+		void WriteTransforms();
+		void CreateFixtures(entt::entity entity, b2Body *body);
+
+		void OnRigidbodyConstructed(entt::registry &registry, entt::entity entity);
+		void OnRigidbodyUpdated(entt::registry &registry, entt::entity entity);
+		void OnRigidbodyDestroyed(entt::registry &registry, entt::entity entity);
+		template<typename T>
+		void OnColliderConstructed(entt::registry &registry, entt::entity entity);
+		template<typename T>
+		void OnColliderUpdated(entt::registry &registry, entt::entity entity);
+		template<typename T>
+		void OnColliderDestroyed(entt::registry &registry, entt::entity entity);
+
+	public:
+
+		FakePhysicsWorld(entt::registry &registry, const FakeVec2f &gravity = FakeVec2f(0.0f, -9.81f));
+		~FakePhysicsWorld();
+
+		/**
+		 *
+		 * Advances the simulation by as many fixed steps as fit into the elapsed time and writes the interpolated poses.
+		 * The written entities are returned by GetMovedEntities(), their transforms are not marked dirty.
+		 *
+		 * @param ts The time since the last call.
+		 * @return Returns the number of fixed steps taken.
+		 */
+		uint32 Step(FakeTimeStep ts);
+
+		/**
+		 *
+		 * Moves a body without interpolating from its old position.
+		 *
+		 * @param entity The entity of the body.
+		 * @param position The new position.
+		 * @param angle The new rotation in radians.
+		 */
+		void Teleport(entt::entity entity, const FakeVec2f &position, float angle);
+
+		void SetGravity(const FakeVec2f &gravity);
+		FakeVec2f GetGravity() const;
+
+		/**
+		 *
+		 * @param seconds The length of one simulation step.
+		 * @param maxSubSteps The most steps per frame, any remaining time is dropped so a long frame can not stall the following ones.
+		 */
+		void SetFixedTimeStep(float seconds, uint32 maxSubSteps = 8);
+		float GetFixedTimeStep() const { return FixedTimeStep; }
+
+		void SetSolverIterations(int32 velocityIterations, int32 positionIterations);
+
+		// Fraction of a fixed step between the last two simulated poses, which has been used for the transforms
+		float GetInterpolationAlpha() const { return Alpha; }
+
+		const std::vector<entt::entity> &GetMovedEntities() const { return MovedEntities; }
+
+		// Contacts reported by the last Step()
+		const std::vector<FakeContactEvent> &GetContactEvents() const { return FrameContactEvents; }
+		void SetContactCallback(const FakeContactCallback &callback) { ContactCallback = callback; }
+
+		uint32 GetBodyCount() const { return (uint32)Bodies.size(); }
+		b2World *GetNativeWorld() { return World.get(); }
+	};
+
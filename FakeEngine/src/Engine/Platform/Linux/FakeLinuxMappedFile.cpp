@@ -0,0 +1,56 @@
+#include "FakePch.h"
+#include "Engine/Core/FakeMappedFile.h"
+
+#if defined(FAKE_PLATFORM_LINUX) || defined(FAKE_PLATFORM_MACOS)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+FakeMappedFile::FakeMappedFile(const FakeString &path)
+	{
+	Open(path);
+	}
+
+FakeMappedFile::~FakeMappedFile()
+	{
+	Close();
+	}
+
+bool FakeMappedFile::Open(const FakeString &path)
+	{
+	Close();
+
+	int file = open(*path, O_RDONLY);
+	if (file < 0)
+		return false;
+
+	struct stat info;
+	if (fstat(file, &info) != 0 || info.st_size == 0)
+		{
+		close(file);
+		return false;
+		}
+
+	// The mapping keeps its own reference to the file
+	void *view = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+	close(file);
+
+	if (view == MAP_FAILED)
+		return false;
+
+	Data = (const Byte*)view;
+	Size = (uint64)info.st_size;
+	return true;
+	}
+
+void FakeMappedFile::Close()
+	{
+	if (Data)
+		munmap((void*)Data, (size_t)Size);
+
+	Data = nullptr;
+	Size = 0;
+	}
+
+#endif
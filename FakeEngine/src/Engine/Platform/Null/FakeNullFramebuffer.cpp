@@ -0,0 +1,60 @@
+#include "FakePch.h"
+#include "FakeNullFramebuffer.h"
+
+#include "Engine/Renderer/FakeRenderer.h"
+#include "FakeNullRendererAPI.h"
+
+FakeNullFramebuffer::FakeNullFramebuffer(const FakeFramebufferSpecification &spec)
+	: Specification(spec), RendererID(FakeNullRendererAPI::CreateRendererID())
+	{
+	for (const FakeFramebufferTextureSpecification &attachment : Specification.Attachments.Attachments)
+		{
+		if (attachment.Format == FakeFramebufferTextureFormat::DEPTH32F || attachment.Format == FakeFramebufferTextureFormat::DEPTH24STENCIL8)
+			DepthAttachmentRendererID = FakeNullRendererAPI::CreateRendererID();
+		else
+			ColorAttachmentRendererIDs.push_back(FakeNullRendererAPI::CreateRendererID());
+		}
+	}
+
+void FakeNullFramebuffer::Bind() const
+	{
+	FakeRendererID rendererID = RendererID;
+	uint32 width = Specification.Width;
+	uint32 height = Specification.Height;
+	FakeRenderer::Submit([rendererID, width, height]()
+		{
+		FakeNullRendererAPI::RecordBind(FakeRecordedCommandType::BindFramebuffer, rendererID);
+		FakeNullRendererAPI::SetViewport(width, height);
+		});
+	}
+
+void FakeNullFramebuffer::Unbind() const
+	{
+	FakeRenderer::Submit([]() { FakeNullRendererAPI::RecordBind(FakeRecordedCommandType::BindFramebuffer, 0); });
+	}
+
+void FakeNullFramebuffer::Resize(uint32 width, uint32 height)
+	{
+	if (width == 0 || height == 0)
+		{
+		FAKE_LOG_WARN("Attempted to resize framebuffer to %d, %d", width, height);
+		return;
+		}
+
+	Specification.Width = width;
+	Specification.Height = height;
+	}
+
+void FakeNullFramebuffer::ReadRegionAsync(uint32 attachmentIndex, int32 x, int32 y, uint32 width, uint32 height, const FakeReadbackCallback &callback)
+	{
+	FAKE_ASSERT(attachmentIndex < ColorAttachmentRendererIDs.size());
+
+	uint32 frameIndex = FakeRenderer::GetFrameIndex();
+	FakeRenderer::Submit([width, height, frameIndex, callback]() { FakeNullRendererAPI::QueueReadback(width, height, frameIndex, callback); });
+	}
+
+FakeRendererID FakeNullFramebuffer::GetColorAttachmentRendererID(int32 index) const
+	{
+	FAKE_ASSERT(index < (int32)ColorAttachmentRendererIDs.size());
+	return ColorAttachmentRendererIDs[index];
+	}
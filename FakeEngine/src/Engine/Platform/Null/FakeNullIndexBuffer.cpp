@@ -0,0 +1,35 @@
+#include "FakePch.h"
+#include "FakeNullIndexBuffer.h"
+
+#include "Engine/Renderer/FakeRenderer.h"
+#include "FakeNullRendererAPI.h"
+
+FakeNullIndexBuffer::FakeNullIndexBuffer(void *data, uint32 size, FakeIndexFormat format)
+	: RendererID(FakeNullRendererAPI::CreateRendererID()), Size(size), Format(format)
+	{
+	SetData(data, size);
+	}
+
+FakeNullIndexBuffer::FakeNullIndexBuffer(uint32 size, FakeIndexFormat format)
+	: RendererID(FakeNullRendererAPI::CreateRendererID()), Size(size), Format(format)
+	{
+	}
+
+void FakeNullIndexBuffer::SetData(void *data, uint32 size, uint32 offset)
+	{
+	Size = size;
+
+	FakeRendererID rendererID = RendererID;
+	FakeRenderer::Submit([rendererID, size]() { FakeNullRendererAPI::RecordUpload(FakeRecordedCommandType::UploadBuffer, rendererID, size); });
+	}
+
+void FakeNullIndexBuffer::Bind() const
+	{
+	FakeRendererID rendererID = RendererID;
+	FakeRenderer::Submit([rendererID]() { FakeNullRendererAPI::RecordBind(FakeRecordedCommandType::BindIndexBuffer, rendererID); });
+	}
+
+void FakeNullIndexBuffer::Unbind() const
+	{
+	FakeRenderer::Submit([]() { FakeNullRendererAPI::RecordBind(FakeRecordedCommandType::BindIndexBuffer, 0); });
+	}
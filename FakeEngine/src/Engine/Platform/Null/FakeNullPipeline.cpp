@@ -0,0 +1,21 @@
+#include "FakePch.h"
+#include "FakeNullPipeline.h"
+
+#include "Engine/Renderer/FakeRenderer.h"
+#include "FakeNullRendererAPI.h"
+
+FakeNullPipeline::FakeNullPipeline(const FakePipelineSpecification &spec)
+	: RendererID(FakeNullRendererAPI::CreateRendererID()), Specification(spec)
+	{
+	}
+
+void FakeNullPipeline::Bind() const
+	{
+	FakeRendererID rendererID = RendererID;
+	FakeRenderer::Submit([rendererID]() { FakeNullRendererAPI::RecordBind(FakeRecordedCommandType::BindPipeline, rendererID); });
+	}
+
+void FakeNullPipeline::Unbind() const
+	{
+	FakeRenderer::Submit([]() { FakeNullRendererAPI::RecordBind(FakeRecordedCommandType::BindPipeline, 0); });
+	}
@@ -0,0 +1,379 @@
+#include "FakePch.h"
+#include "FakeNullRendererAPI.h"
+
+#include "Engine/Renderer/FakeRenderer.h"
+
+struct FakeNullReadback
+	{
+	FakeFramebufferReadback Readback;
+	FakeReadbackCallback Callback;
+	};
+
+struct FakeNullRendererAPIData
+	{
+	std::vector<FakeRecordedCommand> Commands;
+	FakeRendererID NextRendererID = 1;
+
+	std::vector<FakeNullReadback> Readbacks;
+	std::vector<Byte> ReadbackPixels;
+	};
+
+static FakeNullRendererAPIData Data;
+
+namespace Utils
+	{
+	static bool fake_is_recording()
+		{
+		return FakeRendererAPI::Current() == FakeRendererAPIType::Recording;
+		}
+
+	static uint32 fake_float_bits(float value)
+		{
+		uint32 bits;
+		memcpy(&bits, &value, sizeof(float));
+		return bits;
+		}
+
+	static float fake_bits_to_float(uint32 bits)
+		{
+		float value;
+		memcpy(&value, &bits, sizeof(float));
+		return value;
+		}
+
+	static uint8 fake_draw_flags(bool depthTest, FakeIndexFormat format)
+		{
+		uint8 flags = depthTest ? FakeRecordedCommand::DepthTestFlag : 0;
+		if (format == FakeIndexFormat::UInt16)
+			flags |= FakeRecordedCommand::UInt16IndicesFlag;
+
+		return flags;
+		}
+
+	static const char *fake_command_type_name(FakeRecordedCommandType type)
+		{
+		switch (type)
+			{
+			case FakeRecordedCommandType::Clear:                return "Clear";
+			case FakeRecordedCommandType::SetClearColor:        return "SetClearColor";
+			case FakeRecordedCommandType::SetViewport:          return "SetViewport";
+			case FakeRecordedCommandType::SetLineThickness:     return "SetLineThickness";
+			case FakeRecordedCommandType::SetBlend:             return "SetBlend";
+			case FakeRecordedCommandType::DrawIndexed:          return "DrawIndexed";
+			case FakeRecordedCommandType::DrawIndexedInstanced: return "DrawIndexedInstanced";
+			case FakeRecordedCommandType::DrawIndexedIndirect:  return "DrawIndexedIndirect";
+			case FakeRecordedCommandType::DispatchCompute:      return "DispatchCompute";
+			case FakeRecordedCommandType::StorageBarrier:       return "StorageBarrier";
+			case FakeRecordedCommandType::BindShader:           return "BindShader";
+			case FakeRecordedCommandType::BindPipeline:         return "BindPipeline";
+			case FakeRecordedCommandType::BindVertexBuffer:     return "BindVertexBuffer";
+			case FakeRecordedCommandType::BindIndexBuffer:      return "BindIndexBuffer";
+			case FakeRecordedCommandType::BindTexture:          return "BindTexture";
+			case FakeRecordedCommandType::BindFramebuffer:      return "BindFramebuffer";
+			case FakeRecordedCommandType::BindStorageBuffer:    return "BindStorageBuffer";
+			case FakeRecordedCommandType::BindIndirectBuffer:   return "BindIndirectBuffer";
+			case FakeRecordedCommandType::UploadUniforms:       return "UploadUniforms";
+			case FakeRecordedCommandType::UploadBuffer:         return "UploadBuffer";
+			case FakeRecordedCommandType::UploadTexture:        return "UploadTexture";
+			}
+
+		return "Unknown";
+		}
+	}
+
+void FakeNullRendererAPI::Init()
+	{
+	auto &caps = FakeRendererAPI::GetCapabilities();
+	caps.Vendor = "FakeEngine";
+	caps.Renderer = Utils::fake_is_recording() ? "Recording" : "Null";
+	caps.Version = "1.0";
+
+	// What a typical desktop GPU offers, so the renderers size their batches like they would on one
+	caps.MaxSamples = 8;
+	caps.MaxTextureUnits = 32;
+	caps.MaxAnisotropy = 16.0f;
+	caps.ComputeShaders = true;
+	}
+
+void FakeNullRendererAPI::Shutdown()
+	{
+	ClearRecordedCommands();
+	}
+
+void FakeNullRendererAPI::Clear()
+	{
+	if (!Utils::fake_is_recording())
+		return;
+
+	FakeRecordedCommand command;
+	command.Type = FakeRecordedCommandType::Clear;
+	Data.Commands.push_back(command);
+	}
+
+void FakeNullRendererAPI::SetClearColor(const FakeVec4f &color)
+	{
+	if (!Utils::fake_is_recording())
+		return;
+
+	FakeRecordedCommand command;
+	command.Type = FakeRecordedCommandType::SetClearColor;
+	command.Args[0] = Utils::fake_float_bits(color.X);
+	command.Args[1] = Utils::fake_float_bits(color.Y);
+	command.Args[2] = Utils::fake_float_bits(color.Z);
+	command.Args[3] = Utils::fake_float_bits(color.W);
+	Data.Commands.push_back(command);
+	}
+
+void FakeNullRendererAPI::DrawIndexed(uint32 count, FakePrimitiveType type, bool depthTest, FakeIndexFormat format, uint32 baseVertex)
+	{
+	if (!Utils::fake_is_recording())
+		return;
+
+	FakeRecordedCommand command;
+	command.Type = FakeRecordedCommandType::DrawIndexed;
+	command.Primitive = (uint8)type;
+	command.Flags = Utils::fake_draw_flags(depthTest, format);
+	command.Args[0] = count;
+	command.Args[1] = baseVertex;
+	Data.Commands.push_back(command);
+	}
+
+void FakeNullRendererAPI::DrawIndexedInstanced(uint32 count, uint32 instanceCount, uint32 firstIndex, uint32 baseInstance, FakePrimitiveType type, bool depthTest, FakeIndexFormat format)
+	{
+	if (!Utils::fake_is_recording())
+		return;
+
+	FakeRecordedCommand command;
+	command.Type = FakeRecordedCommandType::DrawIndexedInstanced;
+	command.Primitive = (uint8)type;
+	command.Flags = Utils::fake_draw_flags(depthTest, format);
+	command.Args[0] = count;
+	command.Args[1] = instanceCount;
+	command.Args[2] = firstIndex;
+	command.Args[3] = baseInstance;
+	Data.Commands.push_back(command);
+	}
+
+void FakeNullRendererAPI::DrawIndexedIndirect(uint32 commandOffset, uint32 countOffset, uint32 maxDrawCount, FakePrimitiveType type, bool depthTest, FakeIndexFormat format)
+	{
+	if (!Utils::fake_is_recording())
+		return;
+
+	FakeRecordedCommand command;
+	command.Type = FakeRecordedCommandType::DrawIndexedIndirect;
+	command.Primitive = (uint8)type;
+	command.Flags = Utils::fake_draw_flags(depthTest, format);
+	command.Args[0] = commandOffset;
+	command.Args[1] = countOffset;
+	command.Args[2] = maxDrawCount;
+	Data.Commands.push_back(command);
+	}
+
+void FakeNullRendererAPI::DispatchCompute(uint32 groupsX, uint32 groupsY, uint32 groupsZ)
+	{
+	if (!Utils::fake_is_recording())
+		return;
+
+	FakeRecordedCommand command;
+	command.Type = FakeRecordedCommandType::DispatchCompute;
+	command.Args[0] = groupsX;
+	command.Args[1] = groupsY;
+	command.Args[2] = groupsZ;
+	Data.Commands.push_back(command);
+	}
+
+void FakeNullRendererAPI::StorageBarrier()
+	{
+	if (!Utils::fake_is_recording())
+		return;
+
+	FakeRecordedCommand command;
+	command.Type = FakeRecordedCommandType::StorageBarrier;
+	Data.Commands.push_back(command);
+	}
+
+void FakeNullRendererAPI::SetViewport(uint32 width, uint32 height)
+	{
+	if (!Utils::fake_is_recording())
+		return;
+
+	FakeRecordedCommand command;
+	command.Type = FakeRecordedCommandType::SetViewport;
+	command.Args[0] = width;
+	command.Args[1] = height;
+	Data.Commands.push_back(command);
+	}
+
+void FakeNullRendererAPI::SetLineThickness(float thickness)
+	{
+	if (!Utils::fake_is_recording())
+		return;
+
+	FakeRecordedCommand command;
+	command.Type = FakeRecordedCommandType::SetLineThickness;
+	command.Args[0] = Utils::fake_float_bits(thickness);
+	Data.Commands.push_back(command);
+	}
+
+void FakeNullRendererAPI::SetBlend(bool enabled)
+	{
+	if (!Utils::fake_is_recording())
+		return;
+
+	FakeRecordedCommand command;
+	command.Type = FakeRecordedCommandType::SetBlend;
+	command.Flags = enabled ? 1 : 0;
+	Data.Commands.push_back(command);
+	}
+
+void FakeNullRendererAPI::ResolveReadbacks()
+	{
+	// Readbacks of the frame which is executed right now resolve with the next one
+	uint32 frameIndex = FakeRenderer::GetFrameIndex();
+	uint32 resolved = 0;
+	while (resolved < Data.Readbacks.size() && Data.Readbacks[resolved].Readback.FrameIndex < frameIndex)
+		{
+		FakeNullReadback &readback = Data.Readbacks[resolved++];
+		readback.Readback.Pixels = Data.ReadbackPixels.data();
+		readback.Callback(readback.Readback);
+		}
+
+	Data.Readbacks.erase(Data.Readbacks.begin(), Data.Readbacks.begin() + resolved);
+	}
+
+void FakeNullRendererAPI::QueueReadback(uint32 width, uint32 height, uint32 frameIndex, const FakeReadbackCallback &callback)
+	{
+	size_t size = (size_t)width * height * 4;
+	if (Data.ReadbackPixels.size() < size)
+		Data.ReadbackPixels.resize(size, 0);
+
+	FakeNullReadback readback;
+	readback.Readback.Width = width;
+	readback.Readback.Height = height;
+	readback.Readback.FrameIndex = frameIndex;
+	readback.Callback = callback;
+	Data.Readbacks.push_back(readback);
+	}
+
+void FakeNullRendererAPI::RecordBind(FakeRecordedCommandType type, FakeRendererID rendererID, uint32 slot)
+	{
+	if (!Utils::fake_is_recording())
+		return;
+
+	FAKE_ASSERT(type >= FakeRecordedCommandType::BindShader && type <= FakeRecordedCommandType::BindIndirectBuffer, "Not a bind command!");
+
+	FakeRecordedCommand command;
+	command.Type = type;
+	command.Args[0] = rendererID;
+	command.Args[1] = slot;
+	Data.Commands.push_back(command);
+	}
+
+void FakeNullRendererAPI::RecordUpload(FakeRecordedCommandType type, FakeRendererID rendererID, uint32 size)
+	{
+	if (!Utils::fake_is_recording())
+		return;
+
+	FAKE_ASSERT(type >= FakeRecordedCommandType::UploadUniforms, "Not an upload command!");
+
+	FakeRecordedCommand command;
+	command.Type = type;
+	command.Args[0] = rendererID;
+	command.Args[1] = size;
+	Data.Commands.push_back(command);
+	}
+
+FakeRendererID FakeNullRendererAPI::CreateRendererID()
+	{
+	return Data.NextRendererID++;
+	}
+
+const std::vector<FakeRecordedCommand> &FakeNullRendererAPI::GetRecordedCommands()
+	{
+	return Data.Commands;
+	}
+
+void FakeNullRendererAPI::ClearRecordedCommands()
+	{
+	Data.Commands.clear();
+	}
+
+void FakeNullRendererAPI::Replay(const std::vector<FakeRecordedCommand> &commands)
+	{
+	for (const FakeRecordedCommand &command : commands)
+		{
+		bool depthTest = command.Flags & FakeRecordedCommand::DepthTestFlag;
+		FakeIndexFormat format = command.Flags & FakeRecordedCommand::UInt16IndicesFlag ? FakeIndexFormat::UInt16 : FakeIndexFormat::UInt32;
+
+		switch (command.Type)
+			{
+			case FakeRecordedCommandType::Clear:
+				FakeRendererAPI::Clear();
+				break;
+
+			case FakeRecordedCommandType::SetClearColor:
+				FakeRendererAPI::SetClearColor(Utils::fake_bits_to_float(command.Args[0]), Utils::fake_bits_to_float(command.Args[1]), Utils::fake_bits_to_float(command.Args[2]), Utils::fake_bits_to_float(command.Args[3]));
+				break;
+
+			case FakeRecordedCommandType::SetViewport:
+				FakeRendererAPI::SetViewport(command.Args[0], command.Args[1]);
+				break;
+
+			case FakeRecordedCommandType::SetLineThickness:
+				FakeRendererAPI::SetLineThickness(Utils::fake_bits_to_float(command.Args[0]));
+				break;
+
+			case FakeRecordedCommandType::SetBlend:
+				FakeRendererAPI::SetBlend(command.Flags != 0);
+				break;
+
+			case FakeRecordedCommandType::DrawIndexed:
+				FakeRendererAPI::DrawIndexed(command.Args[0], (FakePrimitiveType)command.Primitive, depthTest, format, command.Args[1]);
+				break;
+
+			case FakeRecordedCommandType::DrawIndexedInstanced:
+				FakeRendererAPI::DrawIndexedInstanced(command.Args[0], command.Args[1], command.Args[2], command.Args[3], (FakePrimitiveType)command.Primitive, depthTest, format);
+				break;
+
+			case FakeRecordedCommandType::DrawIndexedIndirect:
+				FakeRendererAPI::DrawIndexedIndirect(command.Args[0], command.Args[1], command.Args[2], (FakePrimitiveType)command.Primitive, depthTest, format);
+				break;
+
+			case FakeRecordedCommandType::DispatchCompute:
+				FakeRendererAPI::DispatchCompute(command.Args[0], command.Args[1], command.Args[2]);
+				break;
+
+			case FakeRecordedCommandType::StorageBarrier:
+				FakeRendererAPI::StorageBarrier();
+				break;
+
+			default:
+				if (Utils::fake_is_recording())
+					Data.Commands.push_back(command);
+				break;
+			}
+		}
+	}
+
+uint32 FakeNullRendererAPI::FindFirstDifference(const std::vector<FakeRecordedCommand> &expected, const std::vector<FakeRecordedCommand> &actual)
+	{
+	size_t count = std::min(expected.size(), actual.size());
+	for (size_t i = 0; i < count; ++i)
+		{
+		if (expected[i] != actual[i])
+			return (uint32)i;
+		}
+
+	// One recording is the beginning of the other one
+	if (expected.size() != actual.size())
+		return (uint32)count;
+
+	return ~0u;
+	}
+
+FakeString FakeNullRendererAPI::ToString(const FakeRecordedCommand &command)
+	{
+	char line[128];
+	snprintf(line, sizeof(line), "%-20s primitive=%u flags=%u args=%u %u %u %u", Utils::fake_command_type_name(command.Type), command.Primitive, command.Flags, command.Args[0], command.Args[1], command.Args[2], command.Args[3]);
+	return line;
+	}
@@ -0,0 +1,197 @@
+/*****************************************************************
+ * \file   FakeNullRendererAPI.h
+ * \brief  
+ * 
+ * \author Can Karka
+ * \date   February 2021
+ * 
+ * Copyright (C) 2021 Can Karka
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *********************************************************************/
+
+#pragma once
+
+#include "Engine/Renderer/FakeFramebuffer.h"
+#include "Engine/Renderer/FakeRendererAPI.h"
+
+enum class FakeRecordedCommandType : uint8
+	{
+	Clear = 0,
+	SetClearColor,
+	SetViewport,
+	SetLineThickness,
+	SetBlend,
+	DrawIndexed,
+	DrawIndexedInstanced,
+	DrawIndexedIndirect,
+	DispatchCompute,
+	StorageBarrier,
+
+	// Everything from here on refers to objects by the renderer ids of the null backend
+	BindShader,
+	BindPipeline,
+	BindVertexBuffer,
+	BindIndexBuffer,
+	BindTexture,
+	BindFramebuffer,
+	BindStorageBuffer,
+	BindIndirectBuffer,
+	UploadUniforms,
+	UploadBuffer,
+	UploadTexture
+	};
+
+/**
+ *
+ * One command of a recording, 20 bytes so a frame can be kept and compared as a whole.
+ *
+ * Args of the command types:
+ * SetClearColor: the bits of red, green, blue and alpha. SetViewport: width and height. SetLineThickness: the bits of the thickness.
+ * DrawIndexed: count and base vertex. DrawIndexedInstanced: count, instance count, first index and base instance.
+ * DrawIndexedIndirect: command offset, count offset and maximum draw count. DispatchCompute: the work groups along x, y and z.
+ * Binds: the renderer id and the slot. Uploads: the renderer id and the size in bytes.
+ *
+ */
+struct FakeRecordedCommand
+	{
+	FakeRecordedCommandType Type = FakeRecordedCommandType::Clear;
+
+	// The FakePrimitiveType of draws
+	uint8 Primitive = 0;
+
+	// Depth test and 16 bit indices of draws, enabled of SetBlend
+	uint8 Flags = 0;
+	uint8 Padding = 0;
+
+	uint32 Args[4] = { 0, 0, 0, 0 };
+
+	static const uint8 DepthTestFlag = 1 << 0;
+	static const uint8 UInt16IndicesFlag = 1 << 1;
+
+	bool operator==(const FakeRecordedCommand &other) const
+		{
+		return memcmp(this, &other, sizeof(FakeRecordedCommand)) == 0;
+		}
+
+	bool operator!=(const FakeRecordedCommand &other) const
+		{
+		return !(*this == other);
+		}
+	};
+
+/**
+ *
+ * Backs the null and the recording backend. With the null backend all calls do nothing, with the recording backend
+ * every call which would have reached the driver is appended to a command stream, which can be replayed and compared.
+ *
+ * The null objects report their binds and uploads here as well, through commands of the render command queue,
+ * so the stream is in execution order.
+ *
+ * @attention All functions must be called on the render thread.
+ *
+ */
+class FakeNullRendererAPI
+	{
+	public:
+
+		static void Init();
+		static void Shutdown();
+
+		static void Clear();
+		static void SetClearColor(const FakeVec4f &color);
+
+		static void DrawIndexed(uint32 count, FakePrimitiveType type, bool depthTest, FakeIndexFormat format, uint32 baseVertex);
+		static void DrawIndexedInstanced(uint32 count, uint32 instanceCount, uint32 firstIndex, uint32 baseInstance, FakePrimitiveType type, bool depthTest, FakeIndexFormat format);
+		static void DrawIndexedIndirect(uint32 commandOffset, uint32 countOffset, uint32 maxDrawCount, FakePrimitiveType type, bool depthTest, FakeIndexFormat format);
+
+		static void DispatchCompute(uint32 groupsX, uint32 groupsY, uint32 groupsZ);
+		static void StorageBarrier();
+
+		static void SetViewport(uint32 width, uint32 height);
+		static void SetLineThickness(float thickness);
+		static void SetBlend(bool enabled);
+
+		static void ResolveReadbacks();
+
+		/**
+		 *
+		 * Queues a readback of zeroed pixels, which resolves in the next frame like one of a GPU would.
+		 *
+		 * @param width The width of the region.
+		 * @param height The height of the region.
+		 * @param frameIndex The frame which requested the readback.
+		 * @param callback Receives the pixels.
+		 */
+		static void QueueReadback(uint32 width, uint32 height, uint32 frameIndex, const FakeReadbackCallback &callback);
+
+		/**
+		 *
+		 * Records that an object has been bound, does nothing unless the recording backend is current.
+		 *
+		 * @param type One of the bind commands.
+		 * @param rendererID The renderer id of the object, 0 for unbinding.
+		 * @param slot The slot of textures.
+		 */
+		static void RecordBind(FakeRecordedCommandType type, FakeRendererID rendererID, uint32 slot = 0);
+
+		/**
+		 *
+		 * Records that data has been uploaded to an object, does nothing unless the recording backend is current.
+		 *
+		 * @param type One of the upload commands.
+		 * @param rendererID The renderer id of the object.
+		 * @param size The size of the data in bytes.
+		 */
+		static void RecordUpload(FakeRecordedCommandType type, FakeRendererID rendererID, uint32 size);
+
+		/**
+		 *
+		 * Hands out renderer ids for null objects. They are counted up from 1 in creation order,
+		 * so two runs which create the same objects record the same stream.
+		 *
+		 * @return Returns a new renderer id.
+		 */
+		static FakeRendererID CreateRendererID();
+
+		static const std::vector<FakeRecordedCommand> &GetRecordedCommands();
+		static void ClearRecordedCommands();
+
+		/**
+		 *
+		 * Issues recorded commands again through FakeRendererAPI. Binds and uploads name null objects,
+		 * so they are only appended to the recording again and skipped by other backends.
+		 *
+		 * @param commands The commands to replay.
+		 */
+		static void Replay(const std::vector<FakeRecordedCommand> &commands);
+
+		/**
+		 *
+		 * Compares two recordings.
+		 *
+		 * @param expected The reference recording.
+		 * @param actual The recording to compare with the reference.
+		 * @return Returns the index of the first command which differs, or ~0u if both are equal.
+		 */
+		static uint32 FindFirstDifference(const std::vector<FakeRecordedCommand> &expected, const std::vector<FakeRecordedCommand> &actual);
+
+		/**
+		 *
+		 * Formats a command as one line of text, for logging differences.
+		 *
+		 * @param command The command to format.
+		 * @return Returns the command as text.
+		 */
+		static FakeString ToString(const FakeRecordedCommand &command);
+	};
@@ -0,0 +1,202 @@
+#include "FakePch.h"
+#include "FakeNullShader.h"
+
+#include "Engine/Core/FakeVirtualFileSystem.h"
+#include "Engine/Renderer/FakeRenderer.h"
+#include "FakeNullRendererAPI.h"
+
+namespace Utils
+	{
+	static bool fake_is_type_string_resource(std::string_view type)
+		{
+		return type == "sampler1D" || type == "sampler2D" || type == "sampler2DMS" || type == "samplerCube" || type == "sampler2DShadow";
+		}
+
+	static bool fake_starts_with(std::string_view string, std::string_view start)
+		{
+		return string.size() >= start.size() && string.compare(0, start.size(), start) == 0;
+		}
+
+	static FakeString fake_to_string(std::string_view string)
+		{
+		return std::string(string);
+		}
+	}
+
+FakeNullShader::FakeNullShader()
+	: RendererID(FakeNullRendererAPI::CreateRendererID())
+	{
+	}
+
+FakeNullShader::FakeNullShader(const FakeString &filePath, const FakeShaderDefineList &defines)
+	: RendererID(FakeNullRendererAPI::CreateRendererID()), Defines(defines)
+	{
+	AssetPath = FakeVirtualFileSystem::Get()->GetAbsoluteFilePath(filePath);
+	Name = FakeVirtualFileSystem::Get()->GetFileNameFromPath(AssetPath);
+	Reload();
+	}
+
+FakeNullShader::FakeNullShader(const FakeString &name, const FakeString &vertexSrc, const FakeString &fragmentSrc)
+	: RendererID(FakeNullRendererAPI::CreateRendererID()), Name(name), VertexSource(*vertexSrc), FragmentSource(*fragmentSrc)
+	{
+	Parse();
+	}
+
+FakeRef<FakeNullShader> FakeNullShader::CreateFromString(const FakeString &name, const FakeString &source)
+	{
+	FakeRef<FakeNullShader> shader = FakeRef<FakeNullShader>::Create();
+	shader->Name = name;
+	shader->Load(source);
+	return shader;
+	}
+
+void FakeNullShader::Bind() const
+	{
+	FakeRendererID rendererID = RendererID;
+	FakeRenderer::Submit([rendererID]() { FakeNullRendererAPI::RecordBind(FakeRecordedCommandType::BindShader, rendererID); });
+	}
+
+void FakeNullShader::Unbind() const
+	{
+	FakeRenderer::Submit([]() { FakeNullRendererAPI::RecordBind(FakeRecordedCommandType::BindShader, 0); });
+	}
+
+void FakeNullShader::Reload()
+	{
+	if (AssetPath.IsEmpty()) return;
+
+	if (!FakeVirtualFileSystem::Get()->FileExists(AssetPath))
+		{
+		FAKE_LOG_ERROR("Shader %s not found!", *AssetPath);
+		return;
+		}
+
+	bool reloaded = !VertexSource.empty();
+	Load(FakeVirtualFileSystem::Get()->ReadTextFile(AssetPath));
+
+	if (reloaded)
+		{
+		for (auto &callback : ShaderReloadedCallbacks)
+			callback();
+		}
+	}
+
+void FakeNullShader::Load(const FakeString &source)
+	{
+	VertexSource.clear();
+	FragmentSource.clear();
+
+	std::vector<FakeShaderStageSource> stages = FakeShaderPreprocessor::Process(std::string_view(*source, source.Length()), AssetPath, Defines);
+	for (FakeShaderStageSource &stage : stages)
+		{
+		// Compute shaders have no material uniforms, there is nothing to reflect
+		if (stage.Stage == FakeShaderStage::Compute)
+			return;
+
+		if (stage.Stage == FakeShaderStage::Vertex)
+			VertexSource = std::move(stage.Source);
+		else if (stage.Stage == FakeShaderStage::Fragment)
+			FragmentSource = std::move(stage.Source);
+		}
+
+	Parse();
+	}
+
+void FakeNullShader::Parse()
+	{
+	Resources.clear();
+	Structs.clear();
+	VSRendererUniformBuffers.clear();
+	FSRendererUniformBuffers.clear();
+	VSMaterialUniformBuffer.Reset();
+	FSMaterialUniformBuffer.Reset();
+	DeclarationArena.Reset();
+
+	Reflection.Clear();
+	Reflection.Parse(VertexSource, FakeShaderDomain::Vertex);
+	Reflection.Parse(FragmentSource, FakeShaderDomain::Fragment);
+
+	const std::vector<FakeShaderReflectionEntry> &entries = Reflection.GetEntries();
+	for (uint32 i = 0; i < (uint32)entries.size(); ++i)
+		{
+		if (entries[i].Kind == FakeShaderReflectionKind::Struct)
+			ParseUniformStruct(i);
+		else if (entries[i].Kind == FakeShaderReflectionKind::Uniform)
+			ParseUniform(entries[i]);
+		}
+	}
+
+void FakeNullShader::ParseUniform(const FakeShaderReflectionEntry &entry)
+	{
+	FakeShaderDomain domain = entry.Domain;
+	FakeString name = Utils::fake_to_string(entry.Name);
+	FakeString typeString = Utils::fake_to_string(entry.Type);
+
+	if (Utils::fake_is_type_string_resource(entry.Type))
+		{
+		Resources.push_back(DeclarationArena.New<FakeOpenGLResourceDeclaration>(FakeOpenGLResourceDeclaration::StringToType(typeString), name, entry.Count));
+		return;
+		}
+
+	FakeOpenGLShaderUniformDeclaration::Type type = FakeOpenGLShaderUniformDeclaration::StringToType(typeString);
+	FakeOpenGLShaderUniformDeclaration *declaration = nullptr;
+	if (type == FakeOpenGLShaderUniformDeclaration::Type::NONE)
+		{
+		FakeShaderStruct *uniformStruct = FindStruct(typeString);
+		FAKE_ASSERT(uniformStruct, "");
+		declaration = DeclarationArena.New<FakeOpenGLShaderUniformDeclaration>(domain, uniformStruct, name, entry.Count);
+		}
+	else
+		{
+		declaration = DeclarationArena.New<FakeOpenGLShaderUniformDeclaration>(domain, type, name, entry.Count);
+		}
+
+	if (Utils::fake_starts_with(entry.Name, "r_"))
+		{
+		FakeShaderUniformBufferList &rendererBuffers = domain == FakeShaderDomain::Vertex ? VSRendererUniformBuffers : FSRendererUniformBuffers;
+		if (rendererBuffers.empty())
+			rendererBuffers.push_back(DeclarationArena.New<FakeOpenGLShaderUniformBufferDeclaration>("Renderer", domain));
+
+		((FakeOpenGLShaderUniformBufferDeclaration*)rendererBuffers.front())->PushUniform(declaration);
+		return;
+		}
+
+	FakeRef<FakeOpenGLShaderUniformBufferDeclaration> &materialBuffer = domain == FakeShaderDomain::Vertex ? VSMaterialUniformBuffer : FSMaterialUniformBuffer;
+	if (!materialBuffer)
+		materialBuffer.Reset(new FakeOpenGLShaderUniformBufferDeclaration("", domain));
+
+	materialBuffer->PushUniform(declaration);
+	}
+
+void FakeNullShader::ParseUniformStruct(uint32 index)
+	{
+	const std::vector<FakeShaderReflectionEntry> &entries = Reflection.GetEntries();
+	const FakeShaderReflectionEntry &entry = entries[index];
+
+	FakeShaderStruct *uniformStruct = DeclarationArena.New<FakeShaderStruct>(Utils::fake_to_string(entry.Name));
+	for (uint32 i = index + 1; i <= index + entry.FieldCount; ++i)
+		{
+		const FakeShaderReflectionEntry &field = entries[i];
+		FakeOpenGLShaderUniformDeclaration::Type type = FakeOpenGLShaderUniformDeclaration::StringToType(Utils::fake_to_string(field.Type));
+		uniformStruct->AddField(DeclarationArena.New<FakeOpenGLShaderUniformDeclaration>(entry.Domain, type, Utils::fake_to_string(field.Name), field.Count));
+		}
+
+	Structs.push_back(uniformStruct);
+	}
+
+FakeShaderStruct *FakeNullShader::FindStruct(const FakeString &name)
+	{
+	for (FakeShaderStruct *s : Structs)
+		{
+		if (s->GetName() == name)
+			return s;
+		}
+
+	return nullptr;
+	}
+
+void FakeNullShader::RecordUpload(uint32 size) const
+	{
+	FakeRendererID rendererID = RendererID;
+	FakeRenderer::Submit([rendererID, size]() { FakeNullRendererAPI::RecordUpload(FakeRecordedCommandType::UploadUniforms, rendererID, size); });
+	}
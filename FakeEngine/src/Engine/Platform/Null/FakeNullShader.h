@@ -0,0 +1,121 @@
+/*****************************************************************
+ * \file   FakeNullShader.h
+ * \brief  
+ * 
+ * \author Can Karka
+ * \date   February 2021
+ * 
+ * Copyright (C) 2021 Can Karka
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *********************************************************************/
+
+#pragma once
+
+#include "Engine/Core/FakeArena.h"
+#include "Engine/Renderer/FakeShader.h"
+#include "Engine/Renderer/FakeShaderReflection.h"
+#include "Engine/Platform/OpenGL/FakeOpenGLShaderUniform.h"
+
+/**
+ *
+ * A shader of the headless backends. The source is preprocessed and reflected like on OpenGL, so materials find
+ * their uniforms and textures, but nothing is compiled. Uniform uploads are recorded with their size.
+ *
+ * The uniform declarations of the OpenGL backend hold no OpenGL state, the null shader uses them to get the same layout.
+ *
+ */
+class FakeNullShader : public FakeShader
+	{
+	private:
+
+		FakeRendererID RendererID = 0;
+
+		FakeString Name = "Undefined";
+		FakeString AssetPath;
+		std::string VertexSource;
+		std::string FragmentSource;
+		std::vector<FakeShaderReloadedCallback> ShaderReloadedCallbacks;
+
+		FakeShaderUniformBufferList VSRendererUniformBuffers;
+		FakeShaderUniformBufferList FSRendererUniformBuffers;
+		FakeRef<FakeOpenGLShaderUniformBufferDeclaration> VSMaterialUniformBuffer;
+		FakeRef<FakeOpenGLShaderUniformBufferDeclaration> FSMaterialUniformBuffer;
+		FakeShaderResourceList Resources;
+		FakeShaderStructList Structs;
+
+		FakeArena DeclarationArena;
+		FakeShaderReflection Reflection;
+		FakeShaderDefineList Defines;
+
+	private:
+
+		void Load(const FakeString &source);
+		void Parse();
+		void ParseUniform(const FakeShaderReflectionEntry &entry);
+		void ParseUniformStruct(uint32 index);
+		FakeShaderStruct *FindStruct(const FakeString &name);
+
+		void RecordUpload(uint32 size) const;
+
+	public:
+
+		FakeNullShader();
+		FakeNullShader(const FakeString &filePath, const FakeShaderDefineList &defines);
+		FakeNullShader(const FakeString &name, const FakeString &vertexSrc, const FakeString &fragmentSrc);
+
+		static FakeRef<FakeNullShader> CreateFromString(const FakeString &name, const FakeString &source);
+
+		virtual void Bind() const override;
+		virtual void Unbind() const override;
+		virtual void Reload() override;
+		virtual void FinishCompilation() override {}
+
+		virtual FakeRendererID GetRendererID() const override { return RendererID; }
+		virtual const FakeString &GetName() const override { return Name; }
+		virtual void AddShaderReloadedCallback(const FakeShaderReloadedCallback &callback) override { ShaderReloadedCallbacks.push_back(callback); }
+		virtual void UploadUniformBuffer(const FakeUniformBufferBase &uniformBuffer) override { RecordUpload(uniformBuffer.GetUniformCount()); }
+
+		virtual void SetVSMaterialUniformBuffer(FakeAllocator buffer) override { RecordUpload(buffer.Size); }
+		virtual void SetFSMaterialUniformBuffer(FakeAllocator buffer) override { RecordUpload(buffer.Size); }
+		virtual void SetMaterialUniformRange(FakeShaderDomain domain, FakeAllocator buffer, uint32 begin, uint32 end) const override { RecordUpload(end - begin); }
+		virtual const FakeShaderUniformBufferList &GetVSRendererUniforms() const override { return VSRendererUniformBuffers; }
+		virtual const FakeShaderUniformBufferList &GetFSRendererUniforms() const override { return FSRendererUniformBuffers; }
+		virtual bool HasVSMaterialUniformBuffer() const override { return (bool)VSMaterialUniformBuffer; }
+		virtual bool HasFSMaterialUniformBuffer() const override { return (bool)FSMaterialUniformBuffer; }
+		virtual const FakeShaderUniformBufferDeclaration &GetVSMaterialUniformBuffer() const override { return *VSMaterialUniformBuffer; }
+		virtual const FakeShaderUniformBufferDeclaration &GetFSMaterialUniformBuffer() const override { return *FSMaterialUniformBuffer; }
+		virtual const FakeShaderResourceList &GetResources() const override { return Resources; }
+
+		virtual void SetUniform(const FakeString &name, const void *data, uint32 size) override { RecordUpload(size); }
+		virtual void SetUniform(const FakeString &name, float value) override { RecordUpload(sizeof(float)); }
+		virtual void SetUniform(const FakeString &name, int32 value) override { RecordUpload(sizeof(int32)); }
+		virtual void SetUniform(const FakeString &name, const FakeMat2f &value) override { RecordUpload(sizeof(FakeMat2f)); }
+		virtual void SetUniform(const FakeString &name, const FakeMat3f &value) override { RecordUpload(sizeof(FakeMat3f)); }
+		virtual void SetUniform(const FakeString &name, const FakeMat4f &value) override { RecordUpload(sizeof(FakeMat4f)); }
+		virtual void SetUniform(const FakeString &name, const FakeVec2f &value) override { RecordUpload(sizeof(FakeVec2f)); }
+		virtual void SetUniform(const FakeString &name, const FakeVec3f &value) override { RecordUpload(sizeof(FakeVec3f)); }
+		virtual void SetUniform(const FakeString &name, const FakeVec4f &value) override { RecordUpload(sizeof(FakeVec4f)); }
+		virtual void SetUniform(const FakeString &name, const FakeVec2i &value) override { RecordUpload(sizeof(FakeVec2i)); }
+		virtual void SetUniform(const FakeString &name, const FakeVec3i &value) override { RecordUpload(sizeof(FakeVec3i)); }
+		virtual void SetUniform(const FakeString &name, const FakeVec4i &value) override { RecordUpload(sizeof(FakeVec4i)); }
+		virtual void SetUniform(const FakeString &name, int32 *value, uint32 size) override { RecordUpload(size * sizeof(int32)); }
+		virtual void SetUniform(const FakeString &name, float *value, uint32 size) override { RecordUpload(size * sizeof(float)); }
+		virtual void SetUniform(const FakeString &name, const FakeMat4f &values, uint32 count) override { RecordUpload(count * sizeof(FakeMat4f)); }
+		virtual void SetUniform(const FakeString &name, int32 v0, int32 v1) override { RecordUpload(2 * sizeof(int32)); }
+		virtual void SetUniform(const FakeString &name, int32 v0, int32 v1, int32 v2) override { RecordUpload(3 * sizeof(int32)); }
+		virtual void SetUniform(const FakeString &name, int32 v0, int32 v1, int32 v2, int32 v3) override { RecordUpload(4 * sizeof(int32)); }
+		virtual void SetUniform(const FakeString &name, float v0, float v1) override { RecordUpload(2 * sizeof(float)); }
+		virtual void SetUniform(const FakeString &name, float v0, float v1, float v2) override { RecordUpload(3 * sizeof(float)); }
+		virtual void SetUniform(const FakeString &name, float v0, float v1, float v2, float v3) override { RecordUpload(4 * sizeof(float)); }
+	};
@@ -0,0 +1,30 @@
+#include "FakePch.h"
+#include "FakeNullStorageBuffer.h"
+
+#include "Engine/Renderer/FakeRenderer.h"
+#include "FakeNullRendererAPI.h"
+
+FakeNullStorageBuffer::FakeNullStorageBuffer(uint32 size)
+	: RendererID(FakeNullRendererAPI::CreateRendererID()), Size(size)
+	{
+	}
+
+void FakeNullStorageBuffer::SetData(const void *data, uint32 size, uint32 offset)
+	{
+	FAKE_ASSERT(offset + size <= Size, "Data does not fit into the storage buffer!");
+
+	FakeRendererID rendererID = RendererID;
+	FakeRenderer::Submit([rendererID, size]() { FakeNullRendererAPI::RecordUpload(FakeRecordedCommandType::UploadBuffer, rendererID, size); });
+	}
+
+void FakeNullStorageBuffer::Bind(uint32 binding) const
+	{
+	FakeRendererID rendererID = RendererID;
+	FakeRenderer::Submit([rendererID, binding]() { FakeNullRendererAPI::RecordBind(FakeRecordedCommandType::BindStorageBuffer, rendererID, binding); });
+	}
+
+void FakeNullStorageBuffer::BindIndirect() const
+	{
+	FakeRendererID rendererID = RendererID;
+	FakeRenderer::Submit([rendererID]() { FakeNullRendererAPI::RecordBind(FakeRecordedCommandType::BindIndirectBuffer, rendererID); });
+	}
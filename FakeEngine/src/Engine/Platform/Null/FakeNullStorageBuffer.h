@@ -0,0 +1,49 @@
+/*****************************************************************
+ * \file   FakeNullStorageBuffer.h
+ * \brief  
+ * 
+ * \author Can Karka
+ * \date   February 2021
+ * 
+ * Copyright (C) 2021 Can Karka
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *********************************************************************/
+
+#pragma once
+
+#include "Engine/Renderer/FakeStorageBuffer.h"
+
+/**
+ *
+ * A storage buffer of the headless backends. Nothing runs the shaders writing to it, so it only records its binds and uploads.
+ *
+ */
+class FakeNullStorageBuffer : public FakeStorageBuffer
+	{
+	private:
+
+		FakeRendererID RendererID = 0;
+		uint32 Size;
+
+	public:
+
+		FakeNullStorageBuffer(uint32 size);
+
+		virtual void SetData(const void *data, uint32 size, uint32 offset = 0) override;
+		virtual void Bind(uint32 binding) const override;
+		virtual void BindIndirect() const override;
+
+		virtual uint32 GetSize() const override { return Size; }
+		virtual FakeRendererID GetRendererID() const override { return RendererID; }
+	};
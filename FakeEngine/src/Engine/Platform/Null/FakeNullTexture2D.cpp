@@ -0,0 +1,76 @@
+#include "FakePch.h"
+#include "FakeNullTexture2D.h"
+
+#include <stb_image.h>
+
+#include "Engine/Renderer/FakeRenderer.h"
+#include "Engine/Core/FakeVirtualFileSystem.h"
+#include "FakeNullRendererAPI.h"
+
+FakeNullTexture2D::FakeNullTexture2D(const FakeString &path, bool srgb)
+	: RendererID(FakeNullRendererAPI::CreateRendererID()), FilePath(path)
+	{
+	Name = FakeVirtualFileSystem::Get()->GetFileNameFromPath(path);
+	Format = stbi_is_hdr(*path) ? FakeTextureFormat::Float16 : FakeTextureFormat::RGBA;
+
+	int32 width, height, channels;
+	if (!stbi_info(*path, &width, &height, &channels))
+		{
+		FAKE_LOG_ERROR("Could not read image %s!", *path);
+		return;
+		}
+
+	IsLoaded = true;
+	Width = width;
+	Height = height;
+	}
+
+FakeNullTexture2D::FakeNullTexture2D(FakeTextureFormat format, uint32 width, uint32 height)
+	: RendererID(FakeNullRendererAPI::CreateRendererID()), Format(format), Width(width), Height(height), FilePath(""), Name("Undefined")
+	{
+	ImageData.Allocate(width * height * FakeTexture::GetBPP(Format));
+	}
+
+FakeNullTexture2D::~FakeNullTexture2D()
+	{
+	delete[] ImageData.Data;
+	}
+
+void FakeNullTexture2D::Bind(uint32 slot) const
+	{
+	FakeRendererID rendererID = RendererID;
+	FakeRenderer::Submit([rendererID, slot]() { FakeNullRendererAPI::RecordBind(FakeRecordedCommandType::BindTexture, rendererID, slot); });
+	}
+
+void FakeNullTexture2D::Lock()
+	{
+	IsLocked = true;
+	}
+
+void FakeNullTexture2D::Unlock()
+	{
+	IsLocked = false;
+
+	FakeRendererID rendererID = RendererID;
+	uint32 size = ImageData.Size;
+	FakeRenderer::Submit([rendererID, size]() { FakeNullRendererAPI::RecordUpload(FakeRecordedCommandType::UploadTexture, rendererID, size); });
+	}
+
+void FakeNullTexture2D::Resize(uint32 width, uint32 height)
+	{
+	FAKE_ASSERT(IsLocked);
+	ImageData.Allocate(width * height * FakeTexture::GetBPP(Format));
+	}
+
+FakeAllocator FakeNullTexture2D::GetWriteableBuffer()
+	{
+	FAKE_ASSERT(IsLocked, "Texture must be locked!");
+	return ImageData;
+	}
+
+void FakeNullTexture2D::SetData(void *data, uint32 size)
+	{
+	FAKE_ASSERT(IsLocked, "Texture must be locked!");
+	ImageData.Allocate(size);
+	memcpy(ImageData.Data, data, size);
+	}
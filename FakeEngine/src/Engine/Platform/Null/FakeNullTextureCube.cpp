@@ -0,0 +1,36 @@
+#include "FakePch.h"
+#include "FakeNullTextureCube.h"
+
+#include <stb_image.h>
+
+#include "Engine/Renderer/FakeRenderer.h"
+#include "Engine/Core/FakeVirtualFileSystem.h"
+#include "FakeNullRendererAPI.h"
+
+FakeNullTextureCube::FakeNullTextureCube(const FakeString &path)
+	: RendererID(FakeNullRendererAPI::CreateRendererID()), Format(FakeTextureFormat::RGB), FilePath(path)
+	{
+	Name = FakeVirtualFileSystem::Get()->GetFileNameFromPath(path);
+
+	int32 width, height, channels;
+	if (!stbi_info(*path, &width, &height, &channels))
+		{
+		FAKE_LOG_ERROR("Could not read image %s!", *path);
+		return;
+		}
+
+	IsLoaded = true;
+	Width = width;
+	Height = height;
+	}
+
+FakeNullTextureCube::FakeNullTextureCube(FakeTextureFormat format, uint32 width, uint32 height)
+	: RendererID(FakeNullRendererAPI::CreateRendererID()), Format(format), Width(width), Height(height), FilePath(""), Name("Undefined")
+	{
+	}
+
+void FakeNullTextureCube::Bind(uint32 slot) const
+	{
+	FakeRendererID rendererID = RendererID;
+	FakeRenderer::Submit([rendererID, slot]() { FakeNullRendererAPI::RecordBind(FakeRecordedCommandType::BindTexture, rendererID, slot); });
+	}
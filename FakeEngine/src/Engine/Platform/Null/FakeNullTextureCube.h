@@ -0,0 +1,61 @@
+/*****************************************************************
+ * \file   FakeNullTextureCube.h
+ * \brief  
+ * 
+ * \author Can Karka
+ * \date   February 2021
+ * 
+ * Copyright (C) 2021 Can Karka
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *********************************************************************/
+
+#pragma once
+
+#include "Engine/Renderer/FakeTextureCube.h"
+
+/**
+ *
+ * A cube texture of the headless backends, only the size of the cross image is read from the file header.
+ *
+ */
+class FakeNullTextureCube : public FakeTextureCube
+	{
+	private:
+
+		FakeRendererID RendererID = 0;
+		FakeTextureFormat Format;
+		uint32 Width = 0, Height = 0;
+		bool IsLoaded = false;
+		FakeString FilePath, Name;
+
+	public:
+
+		FakeNullTextureCube(const FakeString &path);
+		FakeNullTextureCube(FakeTextureFormat format, uint32 width, uint32 height);
+
+		virtual void Bind(uint32 slot = 0) const override;
+		virtual void Unbind() const override {}
+
+		virtual bool Loaded() const override { return IsLoaded; }
+		virtual const FakeString &GetName() const override { return Name; }
+		virtual const FakeString &GetPath() const override { return FilePath; }
+		virtual FakeTextureFormat GetFormat() const override { return Format; }
+		virtual uint32 GetWidth() const override { return Width; }
+		virtual uint32 GetHeight() const override { return Height; }
+		virtual uint32 GetMipLevelCount() const override { return FakeTexture::CalculateMipLevelCount(Width, Height); }
+		virtual FakeRendererID GetRendererID() const override { return RendererID; }
+
+		virtual bool operator==(const FakeTexture &other) const override { return RendererID == other.GetRendererID(); }
+		virtual bool operator!=(const FakeTexture &other) const override { return RendererID != other.GetRendererID(); }
+	};
@@ -0,0 +1,82 @@
+#include "FakePch.h"
+#include "FakeNullVertexBuffer.h"
+
+#include "Engine/Renderer/FakeRenderer.h"
+#include "FakeNullRendererAPI.h"
+
+FakeNullVertexBuffer::FakeNullVertexBuffer(void *data, uint32 size, FakeVertexBufferUsage usage)
+	: RendererID(FakeNullRendererAPI::CreateRendererID()), Size(size), Usage(usage), Storage((const Byte*)data, (const Byte*)data + size)
+	{
+	FakeRendererID rendererID = RendererID;
+	FakeRenderer::Submit([rendererID, size]() { FakeNullRendererAPI::RecordUpload(FakeRecordedCommandType::UploadBuffer, rendererID, size); });
+	}
+
+FakeNullVertexBuffer::FakeNullVertexBuffer(uint32 size, FakeVertexBufferUsage usage)
+	: RendererID(FakeNullRendererAPI::CreateRendererID()), Size(size), Usage(usage), Storage(size)
+	{
+	}
+
+void FakeNullVertexBuffer::SetData(void *data, uint32 size, uint32 offset)
+	{
+	if (Usage == FakeVertexBufferUsage::Stream)
+		{
+		Byte *memory = (Byte*)Map(offset + size);
+		memcpy(memory + offset, data, size);
+		Unmap(offset + size);
+		return;
+		}
+
+	FAKE_ASSERT(offset + size <= Size, "Vertex data does not fit into the buffer!");
+	memcpy(Storage.data() + offset, data, size);
+
+	FakeRendererID rendererID = RendererID;
+	FakeRenderer::Submit([rendererID, size]() { FakeNullRendererAPI::RecordUpload(FakeRecordedCommandType::UploadBuffer, rendererID, size); });
+	}
+
+void *FakeNullVertexBuffer::Map(uint32 size, uint32 stride)
+	{
+	FAKE_ASSERT(Usage == FakeVertexBufferUsage::Stream, "Only stream buffers can be mapped!");
+
+	// Nothing reads the memory, so one region is enough, it starts over with every frame
+	if (StreamFrame != FakeRenderer::GetFrameIndex())
+		{
+		StreamFrame = FakeRenderer::GetFrameIndex();
+		StreamHead = 0;
+		}
+
+	uint32 offset = (StreamHead + stride - 1) / stride * stride;
+
+	// The OpenGL backend executes the recorded commands when a frame runs out of memory, so the headless backends do the same
+	if (offset + size > Size)
+		{
+		FakeRenderer::Flush();
+		offset = 0;
+		FAKE_ASSERT(size <= Size, "Stream data does not fit into one region!");
+		}
+
+	StreamOffset = offset;
+	return Storage.data() + offset;
+	}
+
+void FakeNullVertexBuffer::Unmap(uint32 usedSize)
+	{
+	StreamHead = StreamOffset + usedSize;
+	StreamFrame = FakeRenderer::GetFrameIndex();
+	}
+
+void FakeNullVertexBuffer::Bind() const
+	{
+	FakeRendererID rendererID = RendererID;
+	FakeRenderer::Submit([rendererID]() { FakeNullRendererAPI::RecordBind(FakeRecordedCommandType::BindVertexBuffer, rendererID); });
+	}
+
+void FakeNullVertexBuffer::Unbind() const
+	{
+	FakeRenderer::Submit([]() { FakeNullRendererAPI::RecordBind(FakeRecordedCommandType::BindVertexBuffer, 0); });
+	}
+
+void FakeNullVertexBuffer::BindStorage(uint32 binding) const
+	{
+	FakeRendererID rendererID = RendererID;
+	FakeRenderer::Submit([rendererID, binding]() { FakeNullRendererAPI::RecordBind(FakeRecordedCommandType::BindStorageBuffer, rendererID, binding); });
+	}
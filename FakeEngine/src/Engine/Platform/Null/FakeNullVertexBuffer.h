@@ -0,0 +1,65 @@
+/*****************************************************************
+ * \file   FakeNullVertexBuffer.h
+ * \brief  
+ * 
+ * \author Can Karka
+ * \date   February 2021
+ * 
+ * Copyright (C) 2021 Can Karka
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *********************************************************************/
+
+#pragma once
+
+#include "Engine/Renderer/FakeVertexBuffer.h"
+
+/**
+ *
+ * A vertex buffer of the headless backends. The vertices are kept in memory, stream buffers hand out memory
+ * like the OpenGL backend does, including the early Render() when the memory of a frame runs out.
+ *
+ */
+class FakeNullVertexBuffer : public FakeVertexBuffer
+	{
+	private:
+
+		FakeRendererID RendererID = 0;
+		uint32 Size;
+		FakeVertexBufferUsage Usage;
+		FakeVertexBufferLayout Layout;
+		std::vector<Byte> Storage;
+
+		uint32 StreamFrame = ~0u;
+		uint32 StreamHead = 0;
+		uint32 StreamOffset = 0;
+
+	public:
+
+		FakeNullVertexBuffer(void *data, uint32 size, FakeVertexBufferUsage usage = FakeVertexBufferUsage::Static);
+		FakeNullVertexBuffer(uint32 size, FakeVertexBufferUsage usage = FakeVertexBufferUsage::Dynamic);
+
+		virtual void SetData(void *data, uint32 size, uint32 offset = 0) override;
+		virtual void *Map(uint32 size, uint32 stride = 1) override;
+		virtual void Unmap(uint32 usedSize) override;
+		virtual void Bind() const override;
+		virtual void Unbind() const override;
+		virtual void BindStorage(uint32 binding) const override;
+
+		virtual const FakeVertexBufferLayout &GetLayout() const override { return Layout; }
+		virtual void SetLayout(const FakeVertexBufferLayout &layout) override { Layout = layout; }
+
+		virtual uint32 GetSize() const override { return Size; }
+		virtual uint32 GetStreamOffset() const override { return StreamOffset; }
+		virtual FakeRendererID GetRendererID() const override { return RendererID; }
+	};
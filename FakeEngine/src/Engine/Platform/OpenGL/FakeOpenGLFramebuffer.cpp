@@ -1,6 +1,10 @@
 #include "FakePch.h"
 #include "FakeOpenGLFramebuffer.h"
 
+#include "Engine/Renderer/FakeRenderer.h"
+#include "FakeOpenGLReadback.h"
+#include "FakeOpenGLStateCache.h"
+
 static const uint32 MaxFramebufferSize = 8192;
 
 namespace Utils
@@ -17,7 +21,7 @@ namespace Utils
 
 	static void fake_bind_texture(bool multisampled, uint32 id)
 		{
-		glBindTexture(fake_texture_target(multisampled), id);
+		FakeOpenGLStateCache::BindTexture(fake_texture_target(multisampled), id);
 		}
 
 	static void fake_attach_color_texture(uint32 id, int32 samples, GLenum internalFormat, GLenum format, uint32 width, uint32 height, int32 index)
@@ -91,8 +95,8 @@ void FakeOpenGLFramebuffer::Invalidate()
 	if (RendererID)
 		{
 		glDeleteFramebuffers(1, &RendererID);
-		glDeleteTextures((int32)ColorAttachmentRendererIDs.size(), ColorAttachmentRendererIDs.data());
-		glDeleteTextures(1, &DepthAttachmentRendererID);
+		FakeOpenGLStateCache::DeleteTextures((int32)ColorAttachmentRendererIDs.size(), ColorAttachmentRendererIDs.data());
+		FakeOpenGLStateCache::DeleteTextures(1, &DepthAttachmentRendererID);
 
 		ColorAttachmentRendererIDs.clear();
 		DepthAttachmentRendererID = 0;
@@ -169,14 +173,14 @@ FakeOpenGLFramebuffer::FakeOpenGLFramebuffer(const FakeFramebufferSpecification
 FakeOpenGLFramebuffer::~FakeOpenGLFramebuffer()
 	{
 	glDeleteFramebuffers(1, &RendererID);
-	glDeleteTextures((int32)ColorAttachmentRendererIDs.size(), ColorAttachmentRendererIDs.data());
-	glDeleteTextures(1, &DepthAttachmentRendererID);
+	FakeOpenGLStateCache::DeleteTextures((int32)ColorAttachmentRendererIDs.size(), ColorAttachmentRendererIDs.data());
+	FakeOpenGLStateCache::DeleteTextures(1, &DepthAttachmentRendererID);
 	}
 
 void FakeOpenGLFramebuffer::Bind() const
 	{
 	glBindFramebuffer(GL_FRAMEBUFFER, RendererID);
-	glViewport(0, 0, Specification.Width, Specification.Height);
+	FakeOpenGLStateCache::SetViewport(0, 0, Specification.Width, Specification.Height);
 	}
 
 void FakeOpenGLFramebuffer::Unbind() const
@@ -218,6 +222,39 @@ int32 FakeOpenGLFramebuffer::ReadPixel(uint32 attachmentIndex, int32 x, int32 y)
 	return pixelData;
 	}
 
+void FakeOpenGLFramebuffer::ReadRegionAsync(uint32 attachmentIndex, int32 x, int32 y, uint32 width, uint32 height, const FakeReadbackCallback &callback)
+	{
+	FAKE_ASSERT(attachmentIndex < ColorAttachmentRendererIDs.size());
+
+	if (Specification.Samples > 1)
+		{
+		FAKE_LOG_ERROR("Multisampled framebuffers can not be read back, resolve them first!");
+		return;
+		}
+
+	if (x < 0 || y < 0 || width == 0 || height == 0 || x + width > Specification.Width || y + height > Specification.Height)
+		{
+		FAKE_LOG_ERROR("Attempted to read region %d, %d, %d, %d outside of the framebuffer!", x, y, width, height);
+		return;
+		}
+
+	GLenum format = GL_RGBA;
+	GLenum type = GL_UNSIGNED_BYTE;
+	if (ColorAttachmentSpecification[attachmentIndex].Format == FakeFramebufferTextureFormat::RED_INTEGER)
+		{
+		format = GL_RED_INTEGER;
+		type = GL_INT;
+		}
+
+	// The copy is recorded, so it sees everything drawn into the framebuffer so far
+	FakeRef<FakeOpenGLFramebuffer> instance = this;
+	uint32 frameIndex = FakeRenderer::GetFrameIndex();
+	FakeRenderer::Submit([instance, attachmentIndex, x, y, width, height, format, type, frameIndex, callback]()
+		{
+		FakeOpenGLReadback::Read(instance->RendererID, attachmentIndex, x, y, width, height, format, type, frameIndex, callback);
+		});
+	}
+
 void FakeOpenGLFramebuffer::ClearAttachment(uint32 attachmentIndex, int32 value)
 	{
 	FAKE_ASSERT(attachmentIndex < ColorAttachmentRendererIDs.size());
@@ -114,6 +114,19 @@ class FAKE_API FakeOpenGLFramebuffer : public FakeFramebuffer
 		 */
 		virtual int32 ReadPixel(uint32 attachmentIndex, int32 x, int32 y) override;
 
+		/**
+		 *
+		 * Reads a region through a pixel pack buffer, see FakeFramebuffer::ReadRegionAsync().
+		 *
+		 * @param attachmentIndex The color attachment to read.
+		 * @param x The left edge of the region.
+		 * @param y The bottom edge of the region.
+		 * @param width The width of the region.
+		 * @param height The height of the region.
+		 * @param callback Receives the pixels.
+		 */
+		virtual void ReadRegionAsync(uint32 attachmentIndex, int32 x, int32 y, uint32 width, uint32 height, const FakeReadbackCallback &callback) override;
+
 		/**
 		 *
 		 * .
@@ -2,9 +2,10 @@
 #include "FakeOpenGLIndexBuffer.h"
 
 #include "Engine/Renderer/FakeRenderer.h"
+#include "FakeOpenGLStateCache.h"
 
-FakeOpenGLIndexBuffer::FakeOpenGLIndexBuffer(void *data, uint32 size)
-	: Size(size)
+FakeOpenGLIndexBuffer::FakeOpenGLIndexBuffer(void *data, uint32 size, FakeIndexFormat format)
+	: Size(size), Format(format)
 	{
 	LocalData = FakeAllocator::Copy(data, size);
 
@@ -16,8 +17,8 @@ FakeOpenGLIndexBuffer::FakeOpenGLIndexBuffer(void *data, uint32 size)
 		});
 	}
 
-FakeOpenGLIndexBuffer::FakeOpenGLIndexBuffer(uint32 size)
-	: Size(size)
+FakeOpenGLIndexBuffer::FakeOpenGLIndexBuffer(uint32 size, FakeIndexFormat format)
+	: Size(size), Format(format)
 	{
 	FakeRef<FakeOpenGLIndexBuffer> instance = this;
 	FakeRenderer::Submit([instance]() mutable
@@ -30,7 +31,7 @@ FakeOpenGLIndexBuffer::FakeOpenGLIndexBuffer(uint32 size)
 FakeOpenGLIndexBuffer::~FakeOpenGLIndexBuffer()
 	{
 	GLuint rendererID = RendererID;
-	FakeRenderer::Submit([rendererID]() { glDeleteBuffers(1, &rendererID); });
+	FakeRenderer::Submit([rendererID]() { FakeOpenGLStateCache::DeleteBuffer(rendererID); });
 	}
 
 void FakeOpenGLIndexBuffer::SetData(void *data, uint32 size, uint32 offset)
@@ -48,17 +49,17 @@ void FakeOpenGLIndexBuffer::SetData(void *data, uint32 size, uint32 offset)
 void FakeOpenGLIndexBuffer::Bind() const
 	{
 	FakeRef<const FakeOpenGLIndexBuffer> instance = this;
-	FakeRenderer::Submit([instance]() { glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, instance->RendererID); });
+	FakeRenderer::Submit([instance]() { FakeOpenGLStateCache::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, instance->RendererID); });
 	}
 
 void FakeOpenGLIndexBuffer::Unbind() const
 	{
-	FakeRenderer::Submit([]() { glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0); });
+	FakeRenderer::Submit([]() { FakeOpenGLStateCache::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0); });
 	}
 
 uint32 FakeOpenGLIndexBuffer::GetCount() const
 	{
-	return Size / sizeof(uint32);
+	return Size / (Format == FakeIndexFormat::UInt16 ? sizeof(uint16) : sizeof(uint32));
 	}
 
 uint32 FakeOpenGLIndexBuffer::GetSize() const
@@ -66,6 +67,11 @@ uint32 FakeOpenGLIndexBuffer::GetSize() const
 	return Size;
 	}
 
+FakeIndexFormat FakeOpenGLIndexBuffer::GetFormat() const
+	{
+	return Format;
+	}
+
 FakeRendererID FakeOpenGLIndexBuffer::GetRendererID() const
 	{
 	return RendererID;
@@ -32,6 +32,7 @@ class FAKE_API FakeOpenGLIndexBuffer : public FakeIndexBuffer
 
 		FakeRendererID RendererID = 0;
 		uint32 Size;
+		FakeIndexFormat Format;
 		FakeAllocator LocalData;
 
 	public:
@@ -42,16 +43,18 @@ class FAKE_API FakeOpenGLIndexBuffer : public FakeIndexBuffer
 		 * 
 		 * @param data
 		 * @param size
+		 * @param format
 		 */
-		FakeOpenGLIndexBuffer(void *data, uint32 size);
+		FakeOpenGLIndexBuffer(void *data, uint32 size, FakeIndexFormat format = FakeIndexFormat::UInt32);
 
 		/**
 		 * 
 		 * .
 		 * 
 		 * @param size
+		 * @param format
 		 */
-		FakeOpenGLIndexBuffer(uint32 size);
+		FakeOpenGLIndexBuffer(uint32 size, FakeIndexFormat format = FakeIndexFormat::UInt32);
 
 		/**
 		 * 
@@ -100,6 +103,14 @@ class FAKE_API FakeOpenGLIndexBuffer : public FakeIndexBuffer
 		 */
 		virtual uint32 GetSize() const override;
 
+		/**
+		 *
+		 * Returns the type of the indices.
+		 *
+		 * @return Returns the type of the indices.
+		 */
+		virtual FakeIndexFormat GetFormat() const override;
+
 		/**
 		 *
 		 * Returns the RendererID where the data is bound to.
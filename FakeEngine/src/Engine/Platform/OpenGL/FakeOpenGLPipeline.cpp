@@ -2,6 +2,7 @@
 #include "FakeOpenGLPipeline.h"
 
 #include "Engine/Renderer/FakeRenderer.h"
+#include "FakeOpenGLStateCache.h"
 
 namespace Utils
 	{
@@ -21,11 +22,48 @@ namespace Utils
 			case FakeShaderDataType::Int3:     return GL_INT;
 			case FakeShaderDataType::Int4:     return GL_INT;
 			case FakeShaderDataType::Bool:     return GL_BOOL;
+			case FakeShaderDataType::Short2:   return GL_SHORT;
+			case FakeShaderDataType::Short4:   return GL_SHORT;
+			case FakeShaderDataType::Half2:    return GL_HALF_FLOAT;
+			case FakeShaderDataType::Half4:    return GL_HALF_FLOAT;
 			}
 
 		FAKE_ASSERT(false);
 		return 0;
 		}
+
+	// Describes the attributes once in the vertex array, returns the next free attribute index, matrices take one attribute per column
+	static uint32 fake_set_vertex_attributes(GLuint vertexArray, const FakeVertexBufferLayout &layout, uint32 vertexAttribIndex, uint32 bindingIndex)
+		{
+		for (const auto &element : layout)
+			{
+			auto glBaseType = fake_shader_data_type_to_open_gl_base_type(element.Type);
+
+			uint32 columns = 1;
+			if (element.Type == FakeShaderDataType::Mat3)
+				columns = 3;
+			else if (element.Type == FakeShaderDataType::Mat4)
+				columns = 4;
+
+			uint32 componentCount = element.GetComponentCount() / columns;
+			uint32 columnSize = element.Size / columns;
+			for (uint32 column = 0; column < columns; ++column)
+				{
+				uint32 offset = element.Offset + column * columnSize;
+
+				glEnableVertexArrayAttrib(vertexArray, vertexAttribIndex);
+				if (glBaseType == GL_INT)
+					glVertexArrayAttribIFormat(vertexArray, vertexAttribIndex, componentCount, glBaseType, offset);
+				else
+					glVertexArrayAttribFormat(vertexArray, vertexAttribIndex, componentCount, glBaseType, element.Normalized ? GL_TRUE : GL_FALSE, offset);
+
+				glVertexArrayAttribBinding(vertexArray, vertexAttribIndex, bindingIndex);
+				++vertexAttribIndex;
+				}
+			}
+
+		return vertexAttribIndex;
+		}
 	}
 
 FakeOpenGLPipeline::FakeOpenGLPipeline(const FakePipelineSpecification &spec)
@@ -39,7 +77,7 @@ FakeOpenGLPipeline::~FakeOpenGLPipeline()
 	GLuint rendererID = RendererID;
 	FakeRenderer::Submit([rendererID]()
 		{
-		glDeleteVertexArrays(1, &rendererID);
+		FakeOpenGLStateCache::DeleteVertexArray(rendererID);
 		});
 	}
 
@@ -48,28 +86,17 @@ void FakeOpenGLPipeline::Bind() const
 	FakeRef<const FakeOpenGLPipeline> instance = this;
 	FakeRenderer::Submit([instance]()
 		{
-		glBindVertexArray(instance->RendererID);
+		FakeOpenGLStateCache::BindVertexArray(instance->RendererID);
 
-		const auto &layout = instance->Specification.Layout;
-		uint32 vertexAttribIndex = 0;
-		for (const auto &element : layout)
-			{
-			auto glBaseType = Utils::fake_shader_data_type_to_open_gl_base_type(element.Type);
-			glEnableVertexAttribArray(vertexAttribIndex);
-			if (glBaseType == GL_INT)
-				glVertexAttribIPointer(vertexAttribIndex, element.GetComponentCount(), glBaseType, layout.GetStride(), (const void*)(intptr_t)element.Offset);
-			else
-				glVertexAttribPointer(vertexAttribIndex, element.GetComponentCount(), glBaseType, element.Normalized ? GL_TRUE : GL_FALSE, layout.GetStride(), (const void*)(intptr_t)element.Offset);
-
-			++vertexAttribIndex;
-			}
+		// The vertices are read from the vertex buffer which is bound right now, so one pipeline serves many meshes
+		GLuint vertexBuffer = FakeOpenGLStateCache::GetBuffer(GL_ARRAY_BUFFER);
+		FakeOpenGLStateCache::BindVertexBuffer(instance->RendererID, vertexBuffer, instance->Specification.Layout.GetStride());
 		});
 	}
 
 void FakeOpenGLPipeline::Unbind() const
 	{
-	GLuint rendererID = RendererID;
-	FakeRenderer::Submit([rendererID]() { glBindVertexArray(rendererID); });
+	FakeRenderer::Submit([]() { FakeOpenGLStateCache::BindVertexArray(0); });
 	}
 
 FakeRendererID FakeOpenGLPipeline::GetRendererID() const
@@ -97,9 +124,19 @@ void FakeOpenGLPipeline::Invalidate()
 		auto &rendererID = instance->RendererID;
 
 		if (rendererID)
-			glDeleteVertexArrays(1, &rendererID);
+			FakeOpenGLStateCache::DeleteVertexArray(rendererID);
 
-		glGenVertexArrays(1, &rendererID);
+		// The layout is described once here instead of on every bind
+		glCreateVertexArrays(1, &rendererID);
+		uint32 vertexAttribIndex = Utils::fake_set_vertex_attributes(rendererID, instance->Specification.Layout, 0, 0);
+
+		const FakeRef<FakeVertexBuffer> &instanceBuffer = instance->Specification.InstanceBuffer;
+		if (instanceBuffer)
+			{
+			Utils::fake_set_vertex_attributes(rendererID, instance->Specification.InstanceLayout, vertexAttribIndex, 1);
+			glVertexArrayVertexBuffer(rendererID, 1, instanceBuffer->GetRendererID(), 0, instance->Specification.InstanceLayout.GetStride());
+			glVertexArrayBindingDivisor(rendererID, 1, 1);
+			}
 		});
 	}
 
@@ -35,7 +35,7 @@ class FAKE_API FakeOpenGLPipeline : public FakePipeline
 	private:
 
 		FakePipelineSpecification Specification;
-		FakeRendererID RendererID;
+		FakeRendererID RendererID = 0;
 
 	public:
 
@@ -0,0 +1,140 @@
+#include "FakePch.h"
+#include "FakeOpenGLReadback.h"
+
+#include "FakeOpenGLStateCache.h"
+
+// Enough for a capture of every frame while the GPU is a few frames behind
+static const uint32 MaxPendingReadbacks = 8;
+
+struct FakeOpenGLPixelBuffer
+	{
+	GLuint RendererID = 0;
+	uint32 Capacity = 0;
+	};
+
+struct FakeOpenGLPendingReadback
+	{
+	FakeOpenGLPixelBuffer Buffer;
+	GLsync Fence = nullptr;
+	uint32 Size = 0;
+	FakeFramebufferReadback Readback;
+	FakeReadbackCallback Callback;
+	};
+
+struct FakeOpenGLReadbackData
+	{
+	std::vector<FakeOpenGLPendingReadback> Pending;
+	std::vector<FakeOpenGLPixelBuffer> FreeBuffers;
+	};
+
+static FakeOpenGLReadbackData Data;
+
+namespace Utils
+	{
+	static FakeOpenGLPixelBuffer fake_acquire_pixel_buffer(uint32 size)
+		{
+		// The smallest free buffer which fits, so picking does not take the buffers of a capture
+		size_t best = Data.FreeBuffers.size();
+		for (size_t i = 0; i < Data.FreeBuffers.size(); ++i)
+			{
+			if (Data.FreeBuffers[i].Capacity >= size && (best == Data.FreeBuffers.size() || Data.FreeBuffers[i].Capacity < Data.FreeBuffers[best].Capacity))
+				best = i;
+			}
+
+		if (best < Data.FreeBuffers.size())
+			{
+			FakeOpenGLPixelBuffer buffer = Data.FreeBuffers[best];
+			Data.FreeBuffers.erase(Data.FreeBuffers.begin() + best);
+			return buffer;
+			}
+
+		FakeOpenGLPixelBuffer buffer;
+		buffer.Capacity = size;
+		glCreateBuffers(1, &buffer.RendererID);
+		glNamedBufferData(buffer.RendererID, size, nullptr, GL_STREAM_READ);
+		return buffer;
+		}
+
+	static bool fake_is_finished(GLsync fence, bool wait)
+		{
+		if (!wait)
+			{
+			GLenum result = glClientWaitSync(fence, 0, 0);
+			return result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED;
+			}
+
+		GLenum result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+		while (result == GL_TIMEOUT_EXPIRED)
+			result = glClientWaitSync(fence, 0, 1000000);
+
+		return true;
+		}
+
+	static void fake_finish_readback(FakeOpenGLPendingReadback &readback)
+		{
+		glDeleteSync(readback.Fence);
+
+		readback.Readback.Pixels = (const Byte*)glMapNamedBufferRange(readback.Buffer.RendererID, 0, readback.Size, GL_MAP_READ_BIT);
+		if (readback.Readback.Pixels)
+			readback.Callback(readback.Readback);
+		else
+			FAKE_LOG_ERROR("Could not map the pixel buffer of a readback!");
+
+		glUnmapNamedBuffer(readback.Buffer.RendererID);
+		Data.FreeBuffers.push_back(readback.Buffer);
+		}
+	}
+
+void FakeOpenGLReadback::Read(GLuint framebuffer, uint32 attachmentIndex, int32 x, int32 y, uint32 width, uint32 height, GLenum format, GLenum type, uint32 frameIndex, const FakeReadbackCallback &callback)
+	{
+	if (Data.Pending.size() >= MaxPendingReadbacks)
+		{
+		Utils::fake_is_finished(Data.Pending.front().Fence, true);
+		Utils::fake_finish_readback(Data.Pending.front());
+		Data.Pending.erase(Data.Pending.begin());
+		}
+
+	FakeOpenGLPendingReadback readback;
+	readback.Size = width * height * 4;
+	readback.Buffer = Utils::fake_acquire_pixel_buffer(readback.Size);
+	readback.Readback.Width = width;
+	readback.Readback.Height = height;
+	readback.Readback.FrameIndex = frameIndex;
+	readback.Callback = callback;
+
+	// Only the read binding changes, the framebuffer which is rendered into stays bound
+	GLint readFramebuffer = 0;
+	glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &readFramebuffer);
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+	glReadBuffer(GL_COLOR_ATTACHMENT0 + attachmentIndex);
+
+	// With a pixel pack buffer bound, glReadPixels only queues the copy and returns
+	FakeOpenGLStateCache::BindBuffer(GL_PIXEL_PACK_BUFFER, readback.Buffer.RendererID);
+	glReadPixels(x, y, width, height, format, type, nullptr);
+	FakeOpenGLStateCache::BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, (GLuint)readFramebuffer);
+
+	readback.Fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	Data.Pending.push_back(std::move(readback));
+	}
+
+void FakeOpenGLReadback::Resolve(bool wait)
+	{
+	// The fences signal in order, once one has not, the later ones have not either
+	while (!Data.Pending.empty() && Utils::fake_is_finished(Data.Pending.front().Fence, wait))
+		{
+		Utils::fake_finish_readback(Data.Pending.front());
+		Data.Pending.erase(Data.Pending.begin());
+		}
+	}
+
+void FakeOpenGLReadback::Shutdown()
+	{
+	Resolve(true);
+
+	for (const FakeOpenGLPixelBuffer &buffer : Data.FreeBuffers)
+		FakeOpenGLStateCache::DeleteBuffer(buffer.RendererID);
+
+	Data.FreeBuffers.clear();
+	}
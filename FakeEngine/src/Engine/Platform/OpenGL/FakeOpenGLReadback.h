@@ -0,0 +1,75 @@
+/*****************************************************************
+ * \file   FakeOpenGLReadback.h
+ * \brief  
+ * 
+ * \author Can Karka
+ * \date   February 2021
+ * 
+ * Copyright (C) 2021 Can Karka
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *********************************************************************/
+
+#pragma once
+
+#include <glad/glad.h>
+
+#include "Engine/Renderer/FakeFramebuffer.h"
+
+/**
+ *
+ * Reads framebuffers into pixel pack buffers and hands the pixels to a callback once a fence says the copy has finished,
+ * so reading back never waits for the GPU to catch up with the frame.
+ *
+ * The pixel buffers are pooled and reused. Readbacks resolve in the order they were issued.
+ *
+ * @attention All functions must be called on the render thread.
+ *
+ */
+class FakeOpenGLReadback
+	{
+	public:
+
+		/**
+		 *
+		 * Copies a region of a color attachment into a pixel buffer and places a fence behind the copy.
+		 * If MaxPendingReadbacks are still in flight, the oldest one is waited for first instead of being dropped.
+		 *
+		 * @param framebuffer The framebuffer to read from.
+		 * @param attachmentIndex The color attachment to read.
+		 * @param x The left edge of the region.
+		 * @param y The bottom edge of the region.
+		 * @param width The width of the region.
+		 * @param height The height of the region.
+		 * @param format GL_RGBA or GL_RED_INTEGER, every pixel has to take 4 bytes.
+		 * @param type GL_UNSIGNED_BYTE or GL_INT.
+		 * @param frameIndex The frame which requested the readback.
+		 * @param callback Receives the pixels.
+		 */
+		static void Read(GLuint framebuffer, uint32 attachmentIndex, int32 x, int32 y, uint32 width, uint32 height, GLenum format, GLenum type, uint32 frameIndex, const FakeReadbackCallback &callback);
+
+		/**
+		 *
+		 * Calls the callbacks of the finished readbacks.
+		 *
+		 * @param wait Whether to wait for all pending readbacks to finish.
+		 */
+		static void Resolve(bool wait);
+
+		/**
+		 *
+		 * Finishes all pending readbacks and deletes the pixel buffers.
+		 *
+		 */
+		static void Shutdown();
+	};
@@ -1,10 +1,29 @@
 #include "FakePch.h"
-#include "Engine/Renderer/FakeRendererAPI.h"
+#include "FakeOpenGLRendererAPI.h"
 
 #ifdef FAKE_RENDERER_OPENGL
 
 #include <glad/glad.h>
 
+#include "FakeOpenGLReadback.h"
+#include "FakeOpenGLShaderCache.h"
+#include "FakeOpenGLStateCache.h"
+
+namespace Utils
+	{
+	static GLenum fake_open_gl_primitive_type(FakePrimitiveType type)
+		{
+		switch (type)
+			{
+			case FakePrimitiveType::Triangles:  return GL_TRIANGLES;
+			case FakePrimitiveType::Lines:      return GL_LINES;
+			}
+
+		FAKE_ASSERT(false);
+		return 0;
+		}
+	}
+
 static void OpenGLLogMessage(GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length, const GLchar *message, const void *userParam)
 	{
 	switch (severity)
@@ -28,36 +47,42 @@ static void OpenGLLogMessage(GLenum source, GLenum type, GLuint id, GLenum sever
 		}
 	}
 
-void FakeRendererAPI::Init()
+void FakeOpenGLRendererAPI::Init()
 	{
 	glDebugMessageCallback(OpenGLLogMessage, nullptr);
 	glEnable(GL_DEBUG_OUTPUT);
 	glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
 
+	auto &caps = FakeRendererAPI::GetCapabilities();
+	caps.Vendor = (const char *) glGetString(GL_VENDOR);
+	caps.Renderer = (const char *) glGetString(GL_RENDERER);
+	caps.Version = (const char *) glGetString(GL_VERSION);
+
+	glGetIntegerv(GL_MAX_SAMPLES, &caps.MaxSamples);
+	glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY, &caps.MaxAnisotropy);
+
+	glGetIntegerv(GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS, &caps.MaxTextureUnits);
+	caps.ComputeShaders = GLAD_GL_VERSION_4_3 != 0;
+
+	// From here on the state is changed through the cache only
+	FakeOpenGLStateCache::Init();
+
 	unsigned int vao;
-	glGenVertexArrays(1, &vao);
-	glBindVertexArray(vao);
+	glCreateVertexArrays(1, &vao);
+	FakeOpenGLStateCache::BindVertexArray(vao);
 
-	glEnable(GL_DEPTH_TEST);
+	FakeOpenGLStateCache::SetEnabled(GL_DEPTH_TEST, true);
 	//glEnable(GL_CULL_FACE);
 	glEnable(GL_TEXTURE_CUBE_MAP_SEAMLESS);
 	glFrontFace(GL_CCW);
 
-	glEnable(GL_BLEND);
+	FakeOpenGLStateCache::SetEnabled(GL_BLEND, true);
 	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
 	glEnable(GL_MULTISAMPLE);
-	glEnable(GL_STENCIL_TEST);
+	FakeOpenGLStateCache::SetEnabled(GL_STENCIL_TEST, true);
 
-	auto &caps = FakeRendererAPI::GetCapabilities();
-	caps.Vendor = (const char *) glGetString(GL_VENDOR);
-	caps.Renderer = (const char *) glGetString(GL_RENDERER);
-	caps.Version = (const char *) glGetString(GL_VERSION);
-
-	glGetIntegerv(GL_MAX_SAMPLES, &caps.MaxSamples);
-	glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY, &caps.MaxAnisotropy);
-
-	glGetIntegerv(GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS, &caps.MaxTextureUnits);
+	FakeOpenGLShaderCache::Init();
 
 	GLenum error = glGetError();
 	while (error != GL_NO_ERROR)
@@ -68,59 +93,112 @@ void FakeRendererAPI::Init()
 
 	}
 
-void FakeRendererAPI::Shutdown()
+void FakeOpenGLRendererAPI::Shutdown()
 	{
-
+	FakeOpenGLReadback::Shutdown();
 	}
 
-void FakeRendererAPI::Clear()
+void FakeOpenGLRendererAPI::Clear()
 	{
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 	}
 
-void FakeRendererAPI::SetClearColor(float r, float g, float b, float a)
+void FakeOpenGLRendererAPI::SetClearColor(float r, float g, float b, float a)
 	{
 	glClearColor(r, g, b, a);
 	}
 
 
-void FakeRendererAPI::SetClearColor(const FakeVec4f &color)
+void FakeOpenGLRendererAPI::SetClearColor(const FakeVec4f &color)
 	{
 	glClearColor(color.X, color.Y, color.Z, color.W);
 	}
 
-void FakeRendererAPI::DrawIndexed(uint32 count, FakePrimitiveType type, bool depthTest)
+void FakeOpenGLRendererAPI::DrawIndexed(uint32 count, FakePrimitiveType type, bool depthTest, FakeIndexFormat format, uint32 baseVertex)
+	{
+	// Every draw states its depth test, so nothing has to be restored afterwards
+	FakeOpenGLStateCache::SetEnabled(GL_DEPTH_TEST, depthTest);
+
+	// The actual render call
+	glDrawElementsBaseVertex(Utils::fake_open_gl_primitive_type(type), count, format == FakeIndexFormat::UInt16 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT, nullptr, (GLint)baseVertex);
+	}
+
+void FakeOpenGLRendererAPI::DrawIndexedInstanced(uint32 count, uint32 instanceCount, uint32 firstIndex, uint32 baseInstance, FakePrimitiveType type, bool depthTest, FakeIndexFormat format)
 	{
-	if (!depthTest)
-		glDisable(GL_DEPTH_TEST);
+	FakeOpenGLStateCache::SetEnabled(GL_DEPTH_TEST, depthTest);
 
-	GLenum glPrimitiveType = 0;
-	switch (type)
+	GLenum glIndexType = GL_UNSIGNED_INT;
+	uint64 indexSize = sizeof(uint32);
+	if (format == FakeIndexFormat::UInt16)
 		{
-		case FakePrimitiveType::Triangles:
-			glPrimitiveType = GL_TRIANGLES;
-			break;
+		glIndexType = GL_UNSIGNED_SHORT;
+		indexSize = sizeof(uint16);
+		}
 
-		case FakePrimitiveType::Lines:
-			glPrimitiveType = GL_LINES;
-			break;
+	const void *indices = (const void*)(intptr_t)(firstIndex * indexSize);
+	glDrawElementsInstancedBaseInstance(Utils::fake_open_gl_primitive_type(type), count, glIndexType, indices, instanceCount, baseInstance);
+	}
+
+void FakeOpenGLRendererAPI::DrawIndexedIndirect(uint32 commandOffset, uint32 countOffset, uint32 maxDrawCount, FakePrimitiveType type, bool depthTest, FakeIndexFormat format)
+	{
+	FakeOpenGLStateCache::SetEnabled(GL_DEPTH_TEST, depthTest);
+
+	GLenum glIndexType = format == FakeIndexFormat::UInt16 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+	const void *commands = (const void*)(intptr_t)commandOffset;
+
+	if (GLAD_GL_VERSION_4_6)
+		{
+		glMultiDrawElementsIndirectCount(Utils::fake_open_gl_primitive_type(type), glIndexType, commands, (GLintptr)countOffset, maxDrawCount, sizeof(FakeDrawIndexedIndirectCommand));
+		return;
 		}
 
-	// The actual render call
-	glDrawElements(glPrimitiveType, count, GL_UNSIGNED_INT, nullptr);
+	// Without OpenGL 4.6, as on older Mesa drivers, every reserved command is issued, unused ones have to draw zero instances
+	glMultiDrawElementsIndirect(Utils::fake_open_gl_primitive_type(type), glIndexType, commands, maxDrawCount, sizeof(FakeDrawIndexedIndirectCommand));
+	}
+
+void FakeOpenGLRendererAPI::DispatchCompute(uint32 groupsX, uint32 groupsY, uint32 groupsZ)
+	{
+	glDispatchCompute(groupsX, groupsY, groupsZ);
+	}
 
-	if (!depthTest)
-		glEnable(GL_DEPTH_TEST);
+void FakeOpenGLRendererAPI::StorageBarrier()
+	{
+	glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT | GL_COMMAND_BARRIER_BIT);
 	}
 
-void FakeRendererAPI::SetViewport(uint32 width, uint32 height)
+void FakeOpenGLRendererAPI::SetViewport(uint32 width, uint32 height)
 	{
-	glViewport(0, 0, width, height);
+	FakeOpenGLStateCache::SetViewport(0, 0, width, height);
 	}
 
-void FakeRendererAPI::SetLineThickness(float thickness)
+void FakeOpenGLRendererAPI::SetLineThickness(float thickness)
 	{
 	glLineWidth(thickness);
 	}
 
+void FakeOpenGLRendererAPI::SetBlend(bool enabled)
+	{
+	FakeOpenGLStateCache::SetEnabled(GL_BLEND, enabled);
+	}
+
+void FakeOpenGLRendererAPI::ResetStats()
+	{
+	FakeOpenGLStateCache::ResetStats();
+	}
+
+FakeRenderAPIStatistics FakeOpenGLRendererAPI::GetStats()
+	{
+	FakeOpenGLStateCache::Statistics cacheStats = FakeOpenGLStateCache::GetStats();
+
+	FakeRenderAPIStatistics stats;
+	stats.StateChanges = cacheStats.Calls;
+	stats.SkippedStateChanges = cacheStats.SkippedCalls;
+	return stats;
+	}
+
+void FakeOpenGLRendererAPI::ResolveReadbacks()
+	{
+	FakeOpenGLReadback::Resolve(false);
+	}
+
 #endif
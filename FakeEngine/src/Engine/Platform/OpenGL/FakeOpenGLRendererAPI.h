@@ -0,0 +1,61 @@
+/*****************************************************************
+ * \file   FakeOpenGLRendererAPI.h
+ * \brief  
+ * 
+ * \author Can Karka
+ * \date   February 2021
+ * 
+ * Copyright (C) 2021 Can Karka
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *********************************************************************/
+
+#pragma once
+
+#include "Engine/Renderer/FakeRendererAPI.h"
+
+/**
+ *
+ * The OpenGL implementation of FakeRendererAPI, which forwards to it while OpenGL is the current backend.
+ * See FakeRendererAPI for the documentation of the functions.
+ *
+ * @attention All functions must be called on the render thread.
+ *
+ */
+class FakeOpenGLRendererAPI
+	{
+	public:
+
+		static void Init();
+		static void Shutdown();
+
+		static void Clear();
+		static void SetClearColor(float r, float g, float b, float a);
+		static void SetClearColor(const FakeVec4f &color);
+
+		static void DrawIndexed(uint32 count, FakePrimitiveType type, bool depthTest, FakeIndexFormat format, uint32 baseVertex);
+		static void DrawIndexedInstanced(uint32 count, uint32 instanceCount, uint32 firstIndex, uint32 baseInstance, FakePrimitiveType type, bool depthTest, FakeIndexFormat format);
+		static void DrawIndexedIndirect(uint32 commandOffset, uint32 countOffset, uint32 maxDrawCount, FakePrimitiveType type, bool depthTest, FakeIndexFormat format);
+
+		static void DispatchCompute(uint32 groupsX, uint32 groupsY, uint32 groupsZ);
+		static void StorageBarrier();
+
+		static void SetViewport(uint32 width, uint32 height);
+		static void SetLineThickness(float thickness);
+		static void SetBlend(bool enabled);
+
+		static void ResetStats();
+		static FakeRenderAPIStatistics GetStats();
+
+		static void ResolveReadbacks();
+	};
@@ -1,6 +1,8 @@
 #include "FakePch.h"
 #include "FakeOpenGLRenderingContext.h"
 
+#include "FakeOpenGLStateCache.h"
+
 #ifdef FAKE_PLATFORM_WINDOWS
 	#ifdef FAKE_WINAPI_WINDOWS
 		static HDC dc = nullptr;
@@ -67,7 +69,7 @@ void FakeOpenGLRenderingContext::SwapBuffers()
 
 void FakeOpenGLRenderingContext::Resize(uint32 width, uint32 height)
 	{
-	glViewport(0, 0, width, height);
+	FakeOpenGLStateCache::SetViewport(0, 0, width, height);
 	}
 
 void FakeOpenGLRenderingContext::SetSwapInterval(bool enabled)
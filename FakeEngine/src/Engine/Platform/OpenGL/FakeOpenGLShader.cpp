@@ -3,10 +3,12 @@
 
 #include "Engine/Core/FakeVirtualFileSystem.h"
 #include "Engine/Renderer/FakeRenderer.h"
+#include "FakeOpenGLShaderCache.h"
+#include "FakeOpenGLStateCache.h"
 
 namespace Utils
 	{
-	static bool fake_is_type_string_resource(const FakeString &type)
+	static bool fake_is_type_string_resource(std::string_view type)
 		{
 		if (type == "sampler1D")		return true;
 		if (type == "sampler2D")		return true;
@@ -17,110 +19,36 @@ namespace Utils
 		return false;
 		}
 
-	static const char *fake_find_token(const char *str, const FakeString &token)
+	static bool fake_starts_with(std::string_view string, std::string_view start)
 		{
-		const char *t = str;
-		while (t = strstr(t, *token))
-			{
-			bool left = str == t || isspace(t[-1]);
-			bool right = !t[token.Length()] || isspace(t[token.Length()]);
-			if (left && right)
-				return t;
-
-			t += token.Length();
-			}
-		return nullptr;
+		return string.size() >= start.size() && string.compare(0, start.size(), start) == 0;
 		}
 
-	static const char *fake_find_token(const FakeString &string, const FakeString &token)
+	static FakeString fake_to_string(std::string_view string)
 		{
-		return fake_find_token(*string, token);
+		return std::string(string);
 		}
 
-	static std::vector<FakeString> fake_split_string(const FakeString &string, const FakeString &delimiters)
+	static GLenum fake_shader_type_from_stage(FakeShaderStage stage)
 		{
-		uint32 start = 0;
-		uint32 end = string.IndexOf(delimiters);
-
-		std::vector<FakeString> result;
-
-		while (end <= FakeString::NPOS)
+		switch (stage)
 			{
-			FakeString token = string.Substr(start, end - start);
-
-			if (end == FakeString::NPOS)
-				break;
-
-			if (!token.IsEmpty())
-				result.push_back(token);
-
-			start = end + 1;
-			end = string.IndexOf(delimiters, start);
+			case FakeShaderStage::Vertex:	return GL_VERTEX_SHADER;
+			case FakeShaderStage::Fragment:	return GL_FRAGMENT_SHADER;
+			case FakeShaderStage::Compute:	return GL_COMPUTE_SHADER;
 			}
 
-		return result;
-		}
-
-	static std::vector<FakeString> fake_split_string(const FakeString &string, const char delimiter)
-		{
-		return fake_split_string(string, std::string(1, delimiter));
-		}
-
-	static std::vector<FakeString> fake_tokenize(const FakeString &string)
-		{
-		return fake_split_string(string, " \t\n\r");
-		}
-
-	static std::vector<FakeString> fake_get_lines(const FakeString &string)
-		{
-		return fake_split_string(string, "\n");
-		}
-
-	static FakeString fake_get_block(const char *str, const char **outPosition)
-		{
-		const char *end = strstr(str, "}");
-		if (!end)
-			return str;
-
-		if (outPosition)
-			*outPosition = end;
-
-		uint32 length = (uint32)(end - str + 1);
-		return std::string(str, length);
-		}
-
-	static FakeString fake_get_statement(const char *str, const char **outPosition)
-		{
-		const char *end = strstr(str, ";");
-		if (!end)
-			return str;
-
-		if (outPosition)
-			*outPosition = end;
-			
-		uint32 length = (uint32)(end - str + 1);
-		return std::string(str, length);
-		}
-
-	static bool fake_starts_with(const FakeString &string, const FakeString &start)
-		{
-		return string.IndexOf(start) == 0;
-		}
-
-	static GLenum fake_shader_type_from_string(const FakeString &type)
-		{
-		if (type == "vertex")
-			return GL_VERTEX_SHADER;
-		if (type == "fragment" || type == "pixel")
-			return GL_FRAGMENT_SHADER;
-		if (type == "compute")
-			return GL_COMPUTE_SHADER;
-
 		return GL_NONE;
 		}
 	}
 
 FakeOpenGLShader::FakeOpenGLShader(const FakeString &filePath)
+	: FakeOpenGLShader(filePath, FakeShaderDefineList())
+	{
+	}
+
+FakeOpenGLShader::FakeOpenGLShader(const FakeString &filePath, const FakeShaderDefineList &defines)
+	: Defines(defines)
 	{
 	AssetPath = FakeVirtualFileSystem::Get()->GetAbsoluteFilePath(filePath);
 	Name = FakeVirtualFileSystem::Get()->GetFileNameFromPath(AssetPath);
@@ -143,14 +71,32 @@ FakeOpenGLShader::FakeOpenGLShader(const FakeString &name, const FakeString &ver
 	Load("", false);
 	}
 
+FakeRef<FakeOpenGLShader> FakeOpenGLShader::CreateFromString(const FakeString &name, const FakeString &source)
+	{
+	FakeRef<FakeOpenGLShader> shader = FakeRef<FakeOpenGLShader>::Create();
+	shader->Name = name;
+	shader->Load(source);
+	return shader;
+	}
+
 void FakeOpenGLShader::Bind() const
 	{
-	FakeRenderer::Submit([=]() { glUseProgram(RendererID); });
+	FakeRenderer::Submit([=]()
+		{
+		// Programs are resolved lazily, so background compiles of other shaders can overlap
+		const_cast<FakeOpenGLShader*>(this)->ResolvePendingProgram();
+		FakeOpenGLStateCache::UseProgram(RendererID);
+		});
+	}
+
+void FakeOpenGLShader::FinishCompilation()
+	{
+	FakeRenderer::Submit([=]() { ResolvePendingProgram(); });
 	}
 
 void FakeOpenGLShader::Unbind() const
 	{
-	FakeRenderer::Submit([]() { glUseProgram(0); });
+	FakeRenderer::Submit([]() { FakeOpenGLStateCache::UseProgram(0); });
 	}
 
 void FakeOpenGLShader::Reload()
@@ -270,7 +216,7 @@ void FakeOpenGLShader::SetVSMaterialUniformBuffer(FakeAllocator buffer)
 	{
 	FakeRenderer::Submit([this, buffer]()
 		{
-		glUseProgram(RendererID);
+		FakeOpenGLStateCache::UseProgram(RendererID);
 		ResolveAndSetUniforms(VSMaterialUniformBuffer, buffer);
 		});
 	}
@@ -279,11 +225,34 @@ void FakeOpenGLShader::SetFSMaterialUniformBuffer(FakeAllocator buffer)
 	{
 	FakeRenderer::Submit([this, buffer]()
 		{
-		glUseProgram(RendererID);
+		FakeOpenGLStateCache::UseProgram(RendererID);
 		ResolveAndSetUniforms(FSMaterialUniformBuffer, buffer);
 		});
 	}
 
+void FakeOpenGLShader::SetMaterialUniformRange(FakeShaderDomain domain, FakeAllocator buffer, uint32 begin, uint32 end) const
+	{
+	FakeRenderer::Submit([this, domain, buffer, begin, end]()
+		{
+		FakeOpenGLShader *shader = const_cast<FakeOpenGLShader*>(this);
+		const FakeRef<FakeOpenGLShaderUniformBufferDeclaration> &decl = domain == FakeShaderDomain::Vertex ? VSMaterialUniformBuffer : FSMaterialUniformBuffer;
+
+		// Only the uniforms which overlap the changed bytes cost a call
+		const FakeShaderUniformList &uniforms = decl->GetUniformDeclarations();
+		for (size_t i = 0; i < uniforms.size(); i++)
+			{
+			FakeOpenGLShaderUniformDeclaration *uniform = (FakeOpenGLShaderUniformDeclaration*)uniforms[i];
+			if (uniform->GetOffset() >= end || uniform->GetOffset() + uniform->GetSize() <= begin)
+				continue;
+
+			if (uniform->IsArray())
+				shader->ResolveAndSetUniformArray(uniform, buffer);
+			else
+				shader->ResolveAndSetUniform(uniform, buffer);
+			}
+		});
+	}
+
 void FakeOpenGLShader::SetUniform(const FakeString &name, const void *data, uint32 size)
 	{
 	FakeRenderer::Submit([=]()
@@ -462,47 +431,30 @@ void FakeOpenGLShader::Load(const FakeString &source, bool shouldPreProcess)
 
 	FakeRenderer::Submit([=]()
 		{
+		// A reload might be issued before the previous compile has been resolved
+		ResolvePendingProgram();
+
 		if (RendererID)
-			glDeleteProgram(RendererID);
+			FakeOpenGLStateCache::DeleteProgram(RendererID);
 		
 		CompileAndUploadShader();
-		if (!IsCompute)
-			ResolveUniforms();
 
-		if (Loaded)
-			{
-			for (auto &callback : ShaderReloadedCallbacks)
-				callback();
-			}
-
-		Loaded = true;
+		// Without background compilation there is nothing to overlap, so resolve right away
+		if (!FakeOpenGLShaderCache::IsParallelCompileSupported())
+			ResolvePendingProgram();
 		});
 	}
 
 std::unordered_map<GLenum, std::string> FakeOpenGLShader::PreProcess(const FakeString &source)
 	{
-	std::unordered_map<uint32, std::string> shaderSources;
+	std::unordered_map<GLenum, std::string> shaderSources;
+	IsCompute = false;
 
-	FakeString typeToken = "#type";
-	uint32 pos = source.IndexOf(typeToken); // Start of shader type declaration line
-	while (pos != FakeString::NPOS)
+	std::vector<FakeShaderStageSource> stages = FakeShaderPreprocessor::Process(std::string_view(*source, source.Length()), AssetPath, Defines);
+	for (FakeShaderStageSource &stage : stages)
 		{
-		uint32 eol = source.IndexOf("\n", pos); // End of shader type declaration line
-		FAKE_ASSERT(eol != FakeString::NPOS, "Syntax Error!");
-
-		uint32 begin = pos + typeToken.Length() + 1; // Start of shader type name (after "#type " keyword)
-		FakeString type = source.Substr(begin, eol);
-		GLenum glType = Utils::fake_shader_type_from_string(type);
-		FAKE_ASSERT(glType, "Invalid Shader type specified!");
-
-		uint32 nextLinePos = source.FirstIndexNotOf("\n", eol); // Start of shader code after shader type declaration line
-		FAKE_ASSERT(nextLinePos != FakeString::NPOS, "Syntax Error!");
-		pos = source.IndexOf(typeToken, nextLinePos); // Start of next shader type declaration line
-
-		FakeString newSrc = (pos == FakeString::NPOS) ? source.Substr(nextLinePos) : source.Substr(nextLinePos, pos - nextLinePos + typeToken.Length() + type.Length());
-		newSrc = newSrc.Replace("\r", "");
-		newSrc = newSrc.Replace("\n\n", "\n");
-		shaderSources[glType] = *newSrc;
+		GLenum glType = Utils::fake_shader_type_from_stage(stage.Stage);
+		shaderSources[glType] = std::move(stage.Source);
 
 		if (glType == GL_COMPUTE_SHADER)
 			{
@@ -516,69 +468,38 @@ std::unordered_map<GLenum, std::string> FakeOpenGLShader::PreProcess(const FakeS
 
 void FakeOpenGLShader::Parse()
 	{
-	const char *token;
-	const char *vstr;
-	const char *fstr;
-
 	Resources.clear();
 	Structs.clear();
+	VSRendererUniformBuffers.clear();
+	FSRendererUniformBuffers.clear();
 	VSMaterialUniformBuffer.Reset();
 	FSMaterialUniformBuffer.Reset();
+	DeclarationArena.Reset();
 
-	auto &vertexSource = ShaderSources[GL_VERTEX_SHADER];
-	auto &fragmentSource = ShaderSources[GL_FRAGMENT_SHADER];
-
-	// Vertex Shader
-	vstr = vertexSource.c_str();
-	while (token = Utils::fake_find_token(vstr, "struct"))
-		ParseUniformStruct(Utils::fake_get_block(token, &vstr), FakeShaderDomain::Vertex);
-
-	vstr = vertexSource.c_str();
-	while (token = Utils::fake_find_token(vstr, "uniform"))
-		ParseUniform(Utils::fake_get_statement(token, &vstr), FakeShaderDomain::Vertex);
-
-	// Fragment Shader
-	fstr = fragmentSource.c_str();
-	while (token = Utils::fake_find_token(fstr, "struct"))
-		ParseUniformStruct(Utils::fake_get_block(token, &fstr), FakeShaderDomain::Fragment);
-
-	fstr = fragmentSource.c_str();
-	while (token = Utils::fake_find_token(fstr, "uniform"))
-		ParseUniform(Utils::fake_get_statement(token, &fstr), FakeShaderDomain::Fragment);
+	// The entries point into the sources, so both stages are parsed before anything is resolved
+	Reflection.Clear();
+	Reflection.Parse(ShaderSources[GL_VERTEX_SHADER], FakeShaderDomain::Vertex);
+	Reflection.Parse(ShaderSources[GL_FRAGMENT_SHADER], FakeShaderDomain::Fragment);
 
+	const std::vector<FakeShaderReflectionEntry> &entries = Reflection.GetEntries();
+	for (uint32 i = 0; i < (uint32)entries.size(); ++i)
+		{
+		if (entries[i].Kind == FakeShaderReflectionKind::Struct)
+			ParseUniformStruct(i);
+		else if (entries[i].Kind == FakeShaderReflectionKind::Uniform)
+			ParseUniform(entries[i]);
+		}
 	}
 
-void FakeOpenGLShader::ParseUniform(const FakeString &statement, FakeShaderDomain domain)
+void FakeOpenGLShader::ParseUniform(const FakeShaderReflectionEntry &entry)
 	{
-	std::vector<FakeString> tokens = Utils::fake_tokenize(statement);
-	uint32 index = 0;
-
-	if (tokens.size() == 0)
-		return;
-
-	index++; // "uniform"
-	FakeString typeString = tokens[index++];
-	FakeString name = tokens[index++];
-
-	// Strip ; from name if present
-	if (const char *s = strstr(*name, ";"))
-		name = std::string(*name, s - *name);
+	FakeShaderDomain domain = entry.Domain;
+	FakeString name = Utils::fake_to_string(entry.Name);
+	FakeString typeString = Utils::fake_to_string(entry.Type);
 
-	FakeString n(name);
-	int32 count = 1;
-	const char *namestr = *n;
-	if (const char *s = strstr(namestr, "["))
+	if (Utils::fake_is_type_string_resource(entry.Type))
 		{
-		name = std::string(namestr, s - namestr);
-
-		const char *end = strstr(namestr, "]");
-		std::string c(s + 1, end - s);
-		count = atoi(c.c_str());
-		}
-
-	if (Utils::fake_is_type_string_resource(typeString))
-		{
-		FakeShaderResourceDeclaration *declaration = new FakeOpenGLResourceDeclaration(FakeOpenGLResourceDeclaration::StringToType(typeString), name, count);
+		FakeShaderResourceDeclaration *declaration = DeclarationArena.New<FakeOpenGLResourceDeclaration>(FakeOpenGLResourceDeclaration::StringToType(typeString), name, entry.Count);
 		Resources.push_back(declaration);
 		}
 	else
@@ -591,19 +512,20 @@ void FakeOpenGLShader::ParseUniform(const FakeString &statement, FakeShaderDomai
 			// Find struct
 			FakeShaderStruct *s = FindStruct(typeString);
 			FAKE_ASSERT(s, "");
-			declaration = new FakeOpenGLShaderUniformDeclaration(domain, s, name, count);
+			declaration = DeclarationArena.New<FakeOpenGLShaderUniformDeclaration>(domain, s, name, entry.Count);
 			}
 		else
 			{
-			declaration = new FakeOpenGLShaderUniformDeclaration(domain, t, name, count);
+			declaration = DeclarationArena.New<FakeOpenGLShaderUniformDeclaration>(domain, t, name, entry.Count);
 			}
 
-		if (Utils::fake_starts_with(name, "r_"))
+		if (Utils::fake_starts_with(entry.Name, "r_"))
 			{
-			if (domain == FakeShaderDomain::Vertex)
-				((FakeOpenGLShaderUniformBufferDeclaration*)VSRendererUniformBuffers.front())->PushUniform(declaration);
-			else if (domain == FakeShaderDomain::Fragment)
-				((FakeOpenGLShaderUniformBufferDeclaration*)FSRendererUniformBuffers.front())->PushUniform(declaration);
+			FakeShaderUniformBufferList &rendererBuffers = domain == FakeShaderDomain::Vertex ? VSRendererUniformBuffers : FSRendererUniformBuffers;
+			if (rendererBuffers.empty())
+				rendererBuffers.push_back(DeclarationArena.New<FakeOpenGLShaderUniformBufferDeclaration>("Renderer", domain));
+
+			((FakeOpenGLShaderUniformBufferDeclaration*)rendererBuffers.front())->PushUniform(declaration);
 			}
 		else
 			{
@@ -625,39 +547,17 @@ void FakeOpenGLShader::ParseUniform(const FakeString &statement, FakeShaderDomai
 		}
 	}
 
-void FakeOpenGLShader::ParseUniformStruct(const FakeString &block, FakeShaderDomain domain)
+void FakeOpenGLShader::ParseUniformStruct(uint32 index)
 	{
-	std::vector<FakeString> tokens = Utils::fake_tokenize(block);
+	const std::vector<FakeShaderReflectionEntry> &entries = Reflection.GetEntries();
+	const FakeShaderReflectionEntry &entry = entries[index];
 
-	uint32 index = 0;
-	index++; // struct
-	FakeString name = tokens[index++];
-	FakeShaderStruct *uniformStruct = new FakeShaderStruct(name);
-	index++; // {
-	while (index < tokens.size())
+	FakeShaderStruct *uniformStruct = DeclarationArena.New<FakeShaderStruct>(Utils::fake_to_string(entry.Name));
+	for (uint32 i = index + 1; i <= index + entry.FieldCount; ++i)
 		{
-		if (tokens[index] == "}")
-			break;
-
-		FakeString type = tokens[index++];
-		FakeString name = tokens[index++];
-
-		// Strip ; from name if present
-		if (const char *s = strstr(*name, ";"))
-			name = std::string(*name, s - *name);
-
-		uint32 count = 1;
-		const char *namestr = *name;
-		if (const char *s = strstr(namestr, "["))
-			{
-			name = std::string(namestr, s - namestr);
-
-			const char *end = strstr(namestr, "]");
-			std::string c(s + 1, end - s);
-			count = atoi(c.c_str());
-			}
-		FakeShaderUniformDeclaration *field = new FakeOpenGLShaderUniformDeclaration(domain, FakeOpenGLShaderUniformDeclaration::StringToType(type), name, count);
-		uniformStruct->AddField(field);
+		const FakeShaderReflectionEntry &field = entries[i];
+		FakeOpenGLShaderUniformDeclaration::Type type = FakeOpenGLShaderUniformDeclaration::StringToType(Utils::fake_to_string(field.Type));
+		uniformStruct->AddField(DeclarationArena.New<FakeOpenGLShaderUniformDeclaration>(entry.Domain, type, Utils::fake_to_string(field.Name), field.Count));
 		}
 
 	Structs.push_back(uniformStruct);
@@ -691,7 +591,7 @@ int32 FakeOpenGLShader::GetUniformLocation(const FakeString &name) const
 
 void FakeOpenGLShader::ResolveUniforms()
 	{
-	glUseProgram(RendererID);
+	FakeOpenGLStateCache::UseProgram(RendererID);
 
 	for (size_t i = 0; i < VSRendererUniformBuffers.size(); i++)
 		{
@@ -822,74 +722,118 @@ void FakeOpenGLShader::ResolveUniforms()
 
 void FakeOpenGLShader::CompileAndUploadShader()
 	{
-	std::vector<GLuint> shaderRendererIDs;
+	CacheKey = FakeOpenGLShaderCache::ComputeKey(ShaderSources);
 
-	GLuint program = glCreateProgram();
-	for (auto &kv : ShaderSources)
+	GLuint program = 0;
+	if (FakeOpenGLShaderCache::Load(CacheKey, program))
 		{
-		GLenum type = kv.first;
-		FakeString &source = FakeString(kv.second);
+		PendingProgram = program;
+		PendingFromCache = true;
+		CompilePending = true;
+		return;
+		}
 
-		GLuint shaderRendererID = glCreateShader(type);
-		const GLchar *sourceCstr = (const GLchar*)*source;
+	program = glCreateProgram();
+	for (auto &kv : ShaderSources)
+		{
+		GLuint shaderRendererID = glCreateShader(kv.first);
+		const GLchar *sourceCstr = (const GLchar*)kv.second.c_str();
 		glShaderSource(shaderRendererID, 1, &sourceCstr, 0);
 
+		// The compile status is not queried here, so drivers with parallel compilation can work in the background
 		glCompileShader(shaderRendererID);
 
-		GLint isCompiled = 0;
-		glGetShaderiv(shaderRendererID, GL_COMPILE_STATUS, &isCompiled);
-		if (isCompiled == GL_FALSE)
+		PendingShaderIDs.push_back(shaderRendererID);
+		glAttachShader(program, shaderRendererID);
+		}
+
+	if (FakeOpenGLShaderCache::IsProgramBinarySupported())
+		glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+
+	glLinkProgram(program);
+
+	PendingProgram = program;
+	PendingFromCache = false;
+	CompilePending = true;
+	}
+
+void FakeOpenGLShader::ResolvePendingProgram()
+	{
+	if (!CompilePending)
+		return;
+
+	CompilePending = false;
+	GLuint program = PendingProgram;
+	PendingProgram = 0;
+
+	if (!PendingFromCache)
+		{
+		for (auto id : PendingShaderIDs)
+			{
+			GLint isCompiled = 0;
+			glGetShaderiv(id, GL_COMPILE_STATUS, &isCompiled);
+			if (isCompiled == GL_FALSE)
+				{
+				GLint maxLength = 0;
+				glGetShaderiv(id, GL_INFO_LOG_LENGTH, &maxLength);
+
+				// The maxLength includes the NULL character
+				std::vector<GLchar> infoLog(maxLength);
+				glGetShaderInfoLog(id, maxLength, &maxLength, &infoLog[0]);
+
+				FAKE_LOG_ERROR("Shader compilation failed %s:\n%s", *AssetPath, &infoLog[0]);
+				FAKE_ASSERT(false, "Failed");
+				}
+			}
+
+		// Note the different functions here: glGetProgram* instead of glGetShader*.
+		GLint isLinked = 0;
+		glGetProgramiv(program, GL_LINK_STATUS, (int*) &isLinked);
+		if (isLinked == GL_FALSE)
 			{
 			GLint maxLength = 0;
-			glGetShaderiv(shaderRendererID, GL_INFO_LOG_LENGTH, &maxLength);
+			glGetProgramiv(program, GL_INFO_LOG_LENGTH, &maxLength);
 
 			// The maxLength includes the NULL character
 			std::vector<GLchar> infoLog(maxLength);
-			glGetShaderInfoLog(shaderRendererID, maxLength, &maxLength, &infoLog[0]);
+			glGetProgramInfoLog(program, maxLength, &maxLength, &infoLog[0]);
+			FAKE_LOG_ERROR("Shader linking failed %s:\n%s", *AssetPath, &infoLog[0]);
 
-			FAKE_LOG_ERROR("Shader compilation failed %s:\n%s", *AssetPath, &infoLog[0]);
+			// Don't leak shaders either.
+			for (auto id : PendingShaderIDs)
+				glDeleteShader(id);
 
-			// We don't need the shader anymore.
-			glDeleteShader(shaderRendererID);
+			PendingShaderIDs.clear();
 
-			FAKE_ASSERT(false, "Failed");
-			}
+			// We don't need the program anymore.
+			glDeleteProgram(program);
 
-		shaderRendererIDs.push_back(shaderRendererID);
-		glAttachShader(program, shaderRendererID);
-		}
-
-	// Link our program
-	glLinkProgram(program);
+			return;
+			}
 
-	// Note the different functions here: glGetProgram* instead of glGetShader*.
-	GLint isLinked = 0;
-	glGetProgramiv(program, GL_LINK_STATUS, (int*) &isLinked);
-	if (isLinked == GL_FALSE)
-		{
-		GLint maxLength = 0;
-		glGetProgramiv(program, GL_INFO_LOG_LENGTH, &maxLength);
+		// Always detach shaders after a successful link.
+		for (auto id : PendingShaderIDs)
+			{
+			glDetachShader(program, id);
+			glDeleteShader(id);
+			}
 
-		// The maxLength includes the NULL character
-		std::vector<GLchar> infoLog(maxLength);
-		glGetProgramInfoLog(program, maxLength, &maxLength, &infoLog[0]);
-		FAKE_LOG_ERROR("Shader linking failed %s:\n%s", *AssetPath, &infoLog[0]);
+		PendingShaderIDs.clear();
+		FakeOpenGLShaderCache::Store(CacheKey, program);
+		}
 
-		// Don't leak shaders either.
-		for (auto id : shaderRendererIDs)
-			glDeleteShader(id);
+	RendererID = program;
 
-		// We don't need the program anymore.
-		glDeleteProgram(program);
+	if (!IsCompute)
+		ResolveUniforms();
 
-		return;
+	if (Loaded)
+		{
+		for (auto &callback : ShaderReloadedCallbacks)
+			callback();
 		}
 
-	// Always detach shaders after a successful link.
-	for (auto id : shaderRendererIDs)
-		glDetachShader(program, id);
-
-	RendererID = program;
+	Loaded = true;
 	}
 
 void FakeOpenGLShader::ResolveAndSetUniforms(const FakeRef<FakeOpenGLShaderUniformBufferDeclaration> &decl, FakeAllocator buffer)
@@ -1146,98 +1090,98 @@ void FakeOpenGLShader::UploadUniformStruct(const FakeString &name, const void *d
 
 void FakeOpenGLShader::UploadUniformInt(const FakeString &name, int32 value)
 	{
-	glUseProgram(RendererID);
+	FakeOpenGLStateCache::UseProgram(RendererID);
 	int32 location = GetUniformLocation(name);
 	UploadUniformInt(location, value);
 	}
 
 void FakeOpenGLShader::UploadUniformInt2(const FakeString &name, const FakeVec2i &values)
 	{
-	glUseProgram(RendererID);
+	FakeOpenGLStateCache::UseProgram(RendererID);
 	int32 location = GetUniformLocation(name);
 	UploadUniformInt2(location, values);
 	}
 
 void FakeOpenGLShader::UploadUniformInt3(const FakeString &name, const FakeVec3i &values)
 	{
-	glUseProgram(RendererID);
+	FakeOpenGLStateCache::UseProgram(RendererID);
 	int32 location = GetUniformLocation(name);
 	UploadUniformInt3(location, values);
 	}
 
 void FakeOpenGLShader::UploadUniformInt4(const FakeString &name, const FakeVec4i &values)
 	{
-	glUseProgram(RendererID);
+	FakeOpenGLStateCache::UseProgram(RendererID);
 	int32 location = GetUniformLocation(name);
 	UploadUniformInt4(location, values);
 	}
 
 void FakeOpenGLShader::UploadUniformIntArray(const FakeString &name, int32 *values, uint32 count)
 	{
-	glUseProgram(RendererID);
+	FakeOpenGLStateCache::UseProgram(RendererID);
 	int32 location = GetUniformLocation(name);
 	UploadUniformIntArray(location, values, count);
 	}
 
 void FakeOpenGLShader::UploadUniformFloat(const FakeString &name, float value)
 	{
-	glUseProgram(RendererID);
+	FakeOpenGLStateCache::UseProgram(RendererID);
 	int32 location = GetUniformLocation(name);
 	UploadUniformFloat(location, value);
 	}
 
 void FakeOpenGLShader::UploadUniformFloat2(const FakeString &name, const FakeVec2f &values)
 	{
-	glUseProgram(RendererID);
+	FakeOpenGLStateCache::UseProgram(RendererID);
 	int32 location = GetUniformLocation(name);
 	UploadUniformFloat2(location, values);
 	}
 
 void FakeOpenGLShader::UploadUniformFloat3(const FakeString &name, const FakeVec3f &values)
 	{
-	glUseProgram(RendererID);
+	FakeOpenGLStateCache::UseProgram(RendererID);
 	int32 location = GetUniformLocation(name);
 	UploadUniformFloat3(location, values);
 	}
 
 void FakeOpenGLShader::UploadUniformFloat4(const FakeString &name, const FakeVec4f &values)
 	{
-	glUseProgram(RendererID);
+	FakeOpenGLStateCache::UseProgram(RendererID);
 	int32 location = GetUniformLocation(name);
 	UploadUniformFloat4(location, values);
 	}
 
 void FakeOpenGLShader::UploadUniformFloatArray(const FakeString &name, float *values, uint32 count)
 	{
-	glUseProgram(RendererID);
+	FakeOpenGLStateCache::UseProgram(RendererID);
 	int32 location = GetUniformLocation(name);
 	UploadUniformFloatArray(location, values, count);
 	}
 
 void FakeOpenGLShader::UploadUniformMat2(const FakeString &name, const FakeMat2f &value)
 	{
-	glUseProgram(RendererID);
+	FakeOpenGLStateCache::UseProgram(RendererID);
 	int32 location = GetUniformLocation(name);
 	UploadUniformMat2(location, value);
 	}
 
 void FakeOpenGLShader::UploadUniformMat3(const FakeString &name, const FakeMat3f &value)
 	{
-	glUseProgram(RendererID);
+	FakeOpenGLStateCache::UseProgram(RendererID);
 	int32 location = GetUniformLocation(name);
 	UploadUniformMat3(location, value);
 	}
 
 void FakeOpenGLShader::UploadUniformMat4(const FakeString &name, const FakeMat4f &value)
 	{
-	glUseProgram(RendererID);
+	FakeOpenGLStateCache::UseProgram(RendererID);
 	int32 location = GetUniformLocation(name);
 	UploadUniformMat4(location, value);
 	}
 
 void FakeOpenGLShader::UploadUniformMat4Array(const FakeString &name, const FakeMat4f &values, uint32 count)
 	{
-	glUseProgram(RendererID);
+	FakeOpenGLStateCache::UseProgram(RendererID);
 	int32 location = GetUniformLocation(name);
 	UploadUniformMat4Array(location, values, count);
 	}
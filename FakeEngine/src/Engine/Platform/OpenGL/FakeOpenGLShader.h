@@ -25,7 +25,9 @@
 #include <glad/glad.h>
 
 #include "Engine/Core/FakeAllocator.h"
+#include "Engine/Core/FakeArena.h"
 #include "Engine/Renderer/FakeShader.h"
+#include "Engine/Renderer/FakeShaderReflection.h"
 #include "FakeOpenGLShaderUniform.h"
 
 /**
@@ -54,6 +56,18 @@ class FakeOpenGLShader : public FakeShader
 		FakeShaderResourceList Resources;
 		FakeShaderStructList Structs;
 
+		// Owns all declarations above, reset whenever the shader is parsed again
+		FakeArena DeclarationArena;
+		FakeShaderReflection Reflection;
+		FakeShaderDefineList Defines;
+
+		// Program which is still being compiled/linked by the driver
+		GLuint PendingProgram = 0;
+		std::vector<GLuint> PendingShaderIDs;
+		uint64 CacheKey = 0;
+		bool CompilePending = false;
+		bool PendingFromCache = false;
+
 	private:
 
 		void Load(const FakeString &source, bool shouldPreProccess = true);
@@ -61,12 +75,13 @@ class FakeOpenGLShader : public FakeShader
 		int32 GetUniformLocation(const FakeString &name) const;
 
 		void Parse();
-		void ParseUniform(const FakeString &statement, FakeShaderDomain domain);
-		void ParseUniformStruct(const FakeString &block, FakeShaderDomain domain);
+		void ParseUniform(const FakeShaderReflectionEntry &entry);
+		void ParseUniformStruct(uint32 index);
 		FakeShaderStruct *FindStruct(const FakeString &name);
 
 		void ResolveUniforms();
 		void CompileAndUploadShader();
+		void ResolvePendingProgram();
 
 		void ResolveAndSetUniforms(const FakeRef<FakeOpenGLShaderUniformBufferDeclaration> &decl, FakeAllocator buffer);
 		void ResolveAndSetUniform(FakeOpenGLShaderUniformDeclaration *uniform, FakeAllocator buffer);
@@ -114,12 +129,16 @@ class FakeOpenGLShader : public FakeShader
 
 		FakeOpenGLShader() = default;
 		FakeOpenGLShader(const FakeString &filePath);
+		FakeOpenGLShader(const FakeString &filePath, const FakeShaderDefineList &defines);
 		FakeOpenGLShader(const FakeString &vertexSrc, const FakeString &fragmentSrc);
 		FakeOpenGLShader(const FakeString &name, const FakeString &vertexSrc, const FakeString &fragmentSrc);
 
+		static FakeRef<FakeOpenGLShader> CreateFromString(const FakeString &name, const FakeString &source);
+
 		virtual void Bind() const override;
 		virtual void Unbind() const override;
 		virtual void Reload() override;
+		virtual void FinishCompilation() override;
 
 		virtual FakeRendererID GetRendererID() const override { return RendererID; }
 		virtual const FakeString &GetName() const override { return Name; }
@@ -128,6 +147,7 @@ class FakeOpenGLShader : public FakeShader
 
 		virtual void SetVSMaterialUniformBuffer(FakeAllocator buffer) override;
 		virtual void SetFSMaterialUniformBuffer(FakeAllocator buffer) override;
+		virtual void SetMaterialUniformRange(FakeShaderDomain domain, FakeAllocator buffer, uint32 begin, uint32 end) const override;
 		virtual const FakeShaderUniformBufferList &GetVSRendererUniforms() const override { return VSRendererUniformBuffers; }
 		virtual const FakeShaderUniformBufferList &GetFSRendererUniforms() const override { return FSRendererUniformBuffers; }
 		virtual bool HasVSMaterialUniformBuffer() const override { return (bool)VSMaterialUniformBuffer; }
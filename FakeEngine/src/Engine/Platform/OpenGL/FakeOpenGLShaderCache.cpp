@@ -0,0 +1,237 @@
+#include "FakePch.h"
+#include "FakeOpenGLShaderCache.h"
+
+#ifdef FAKE_WINAPI_GLFW
+	#include <GLFW/glfw3.h>
+#endif
+
+#include "Engine/Core/FakeFileSystem.h"
+#include "Engine/Core/FakeVirtualFileSystem.h"
+#include "Engine/Renderer/FakeRendererAPI.h"
+
+// GL_KHR_parallel_shader_compile is not part of the generated glad loader
+#define FAKE_GL_MAX_SHADER_COMPILER_THREADS_KHR 0x91B0
+#define FAKE_GL_COMPLETION_STATUS_KHR 0x91B1
+
+typedef void (APIENTRYP FakePFNGLMAXSHADERCOMPILERTHREADSKHRPROC)(GLuint count);
+
+static const uint32 ShaderCacheMagic = 0x48534B46; // "FKSH"
+static const uint32 ShaderCacheVersion = 1;
+
+struct FakeShaderCacheHeader
+	{
+	uint32 Magic;
+	uint32 Version;
+	uint64 Key;
+	uint32 Format;
+	uint32 Size;
+	};
+
+struct FakeShaderCacheData
+	{
+	bool ProgramBinary = false;
+	bool ParallelCompile = false;
+	uint64 DriverHash = 0;
+	FakePFNGLMAXSHADERCOMPILERTHREADSKHRPROC MaxShaderCompilerThreads = nullptr;
+	};
+
+static FakeShaderCacheData Data;
+
+namespace Utils
+	{
+	static uint64 fake_fnv1a(const void *data, size_t size, uint64 hash = 14695981039346656037ull)
+		{
+		const uint8 *bytes = (const uint8*)data;
+		for (size_t i = 0; i < size; ++i)
+			{
+			hash ^= bytes[i];
+			hash *= 1099511628211ull;
+			}
+
+		return hash;
+		}
+
+	static bool fake_has_extension(const char *name)
+		{
+		GLint count = 0;
+		glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+		for (GLint i = 0; i < count; ++i)
+			{
+			const char *extension = (const char*)glGetStringi(GL_EXTENSIONS, i);
+			if (extension && strcmp(extension, name) == 0)
+				return true;
+			}
+
+		return false;
+		}
+
+	static void *fake_get_proc_address(const char *name)
+		{
+		#ifdef FAKE_WINAPI_GLFW
+			return (void*)glfwGetProcAddress(name);
+		#elif defined(FAKE_WINAPI_WINDOWS)
+			return (void*)wglGetProcAddress(name);
+		#else
+			return nullptr;
+		#endif
+		}
+
+	static FakeString fake_cache_path(uint64 key)
+		{
+		char fileName[32];
+		sprintf(fileName, "%016llx.bin", (unsigned long long)key);
+		return FakeString("/shadercache/") + fileName;
+		}
+	}
+
+void FakeOpenGLShaderCache::Init()
+	{
+	GLint formatCount = 0;
+	glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+	Data.ProgramBinary = formatCount > 0;
+
+	const char *parallelFunction = nullptr;
+	if (Utils::fake_has_extension("GL_KHR_parallel_shader_compile"))
+		parallelFunction = "glMaxShaderCompilerThreadsKHR";
+	else if (Utils::fake_has_extension("GL_ARB_parallel_shader_compile"))
+		parallelFunction = "glMaxShaderCompilerThreadsARB";
+
+	if (parallelFunction)
+		Data.MaxShaderCompilerThreads = (FakePFNGLMAXSHADERCOMPILERTHREADSKHRPROC)Utils::fake_get_proc_address(parallelFunction);
+
+	if (Data.MaxShaderCompilerThreads)
+		{
+		// 0xFFFFFFFF lets the driver pick the number of threads
+		Data.MaxShaderCompilerThreads(0xFFFFFFFF);
+		Data.ParallelCompile = true;
+		}
+
+	const FakeRenderAPICapabilities &caps = FakeRendererAPI::GetCapabilities();
+	uint64 hash = Utils::fake_fnv1a(*caps.Vendor, caps.Vendor.Length());
+	hash = Utils::fake_fnv1a(*caps.Renderer, caps.Renderer.Length(), hash);
+	hash = Utils::fake_fnv1a(*caps.Version, caps.Version.Length(), hash);
+	Data.DriverHash = hash;
+
+	if (Data.ProgramBinary)
+		{
+		if (!FakeFileSystem::PathExists("cache"))
+			FakeFileSystem::CreateFolder("cache");
+
+		if (!FakeFileSystem::PathExists("cache/shaders"))
+			FakeFileSystem::CreateFolder("cache/shaders");
+
+		FakeVirtualFileSystem::Get()->Mount("shadercache", "cache/shaders/");
+		}
+
+	FAKE_LOG_INFO("Shader cache: program binaries %s, parallel compile %s", Data.ProgramBinary ? "on" : "off", Data.ParallelCompile ? "on" : "off");
+	}
+
+uint64 FakeOpenGLShaderCache::ComputeKey(const std::unordered_map<GLenum, std::string> &sources)
+	{
+	// unordered_map iteration order is not stable, so combine the stages order independently
+	uint64 key = 0;
+	for (auto &[stage, source] : sources)
+		{
+		uint64 stageHash = Utils::fake_fnv1a(&stage, sizeof(stage));
+		stageHash = Utils::fake_fnv1a(source.data(), source.size(), stageHash);
+		key ^= stageHash;
+		}
+
+	return Utils::fake_fnv1a(&Data.DriverHash, sizeof(Data.DriverHash), key);
+	}
+
+bool FakeOpenGLShaderCache::Load(uint64 key, GLuint &outProgram)
+	{
+	if (!Data.ProgramBinary)
+		return false;
+
+	FakeString path = Utils::fake_cache_path(key);
+	if (!FakeVirtualFileSystem::Get()->FileExists(path))
+		return false;
+
+	int64 size = 0;
+	Byte *buffer = FakeVirtualFileSystem::Get()->ReadFile(path, &size);
+	if (!buffer)
+		return false;
+
+	FakeShaderCacheHeader *header = (FakeShaderCacheHeader*)buffer;
+	bool valid = size >= (int64)sizeof(FakeShaderCacheHeader)
+		&& header->Magic == ShaderCacheMagic
+		&& header->Version == ShaderCacheVersion
+		&& header->Key == key
+		&& size == (int64)(sizeof(FakeShaderCacheHeader) + header->Size);
+
+	bool linked = false;
+	if (valid)
+		{
+		GLuint program = glCreateProgram();
+		glProgramBinary(program, header->Format, buffer + sizeof(FakeShaderCacheHeader), header->Size);
+
+		GLint status = GL_FALSE;
+		glGetProgramiv(program, GL_LINK_STATUS, &status);
+		linked = status == GL_TRUE;
+
+		if (linked)
+			outProgram = program;
+		else
+			glDeleteProgram(program);
+		}
+
+	delete[] buffer;
+
+	// The driver rejected the binary, drop it so it gets rebuilt
+	if (!linked)
+		FakeVirtualFileSystem::Get()->RemoveFile(path);
+
+	return linked;
+	}
+
+void FakeOpenGLShaderCache::Store(uint64 key, GLuint program)
+	{
+	if (!Data.ProgramBinary)
+		return;
+
+	GLint length = 0;
+	glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+	if (length <= 0)
+		return;
+
+	std::vector<Byte> buffer(sizeof(FakeShaderCacheHeader) + length);
+	FakeShaderCacheHeader *header = (FakeShaderCacheHeader*)buffer.data();
+
+	GLenum format = 0;
+	GLsizei written = 0;
+	glGetProgramBinary(program, length, &written, &format, buffer.data() + sizeof(FakeShaderCacheHeader));
+	if (written <= 0)
+		return;
+
+	header->Magic = ShaderCacheMagic;
+	header->Version = ShaderCacheVersion;
+	header->Key = key;
+	header->Format = format;
+	header->Size = (uint32)written;
+
+	FakeString path = Utils::fake_cache_path(key);
+	if (!FakeVirtualFileSystem::Get()->WriteFile(path, buffer.data(), sizeof(FakeShaderCacheHeader) + written))
+		FAKE_LOG_WARN("Could not write shader cache %s", *path);
+	}
+
+bool FakeOpenGLShaderCache::IsParallelCompileSupported()
+	{
+	return Data.ParallelCompile;
+	}
+
+bool FakeOpenGLShaderCache::IsProgramBinarySupported()
+	{
+	return Data.ProgramBinary;
+	}
+
+bool FakeOpenGLShaderCache::IsLinkComplete(GLuint program)
+	{
+	if (!Data.ParallelCompile)
+		return true;
+
+	GLint complete = GL_FALSE;
+	glGetProgramiv(program, FAKE_GL_COMPLETION_STATUS_KHR, &complete);
+	return complete == GL_TRUE;
+	}
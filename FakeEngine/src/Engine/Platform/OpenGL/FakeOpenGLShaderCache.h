@@ -0,0 +1,105 @@
+/*****************************************************************
+ * \file   FakeOpenGLShaderCache.h
+ * \brief  
+ * 
+ * \author Can Karka
+ * \date   February 2021
+ * 
+ * Copyright (C) 2021 Can Karka
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *********************************************************************/
+
+#pragma once
+
+#include <glad/glad.h>
+
+#include "Engine/Core/FakeCore.h"
+
+/**
+ *
+ * Persistent cache of linked program binaries (GL_ARB_get_program_binary) and access to GL_KHR_parallel_shader_compile.
+ *
+ * Binaries are keyed by a hash of all shader stage sources combined with the driver vendor, renderer and version,
+ * so a driver update invalidates the cache automatically. They are stored through the VirtualFileSystem in "/shadercache/".
+ *
+ * @attention All functions must be called on the render thread.
+ *
+ */
+class FakeOpenGLShaderCache
+	{
+	public:
+
+		/**
+		 *
+		 * Queries the driver support and mounts the cache folder.
+		 * Called by FakeRendererAPI::Init once the capabilities are known.
+		 *
+		 */
+		static void Init();
+
+		/**
+		 *
+		 * Computes the cache key of a program.
+		 *
+		 * @param sources The shader sources by stage.
+		 * @return Returns the cache key.
+		 */
+		static uint64 ComputeKey(const std::unordered_map<GLenum, std::string> &sources);
+
+		/**
+		 *
+		 * Tries to create a program from a cached binary.
+		 *
+		 * @param key The cache key of the program.
+		 * @param outProgram The linked program if the binary has been accepted by the driver.
+		 * @return Returns true on a cache hit.
+		 */
+		static bool Load(uint64 key, GLuint &outProgram);
+
+		/**
+		 *
+		 * Writes the binary of a successfully linked program to the cache.
+		 * The program must have been linked with GL_PROGRAM_BINARY_RETRIEVABLE_HINT.
+		 *
+		 * @param key The cache key of the program.
+		 * @param program The linked program.
+		 */
+		static void Store(uint64 key, GLuint program);
+
+		/**
+		 *
+		 * Returns true if the driver can compile and link in background threads.
+		 *
+		 * @return Returns true if GL_KHR_parallel_shader_compile (or the ARB variant) is supported.
+		 */
+		static bool IsParallelCompileSupported();
+
+		/**
+		 *
+		 * Returns true if program binaries can be retrieved and loaded.
+		 *
+		 * @return Returns true if program binaries are supported.
+		 */
+		static bool IsProgramBinarySupported();
+
+		/**
+		 *
+		 * Returns true if a background link has finished, without blocking.
+		 * Always returns true if parallel compilation is not supported.
+		 *
+		 * @param program The program to query.
+		 * @return Returns true if the link has finished.
+		 */
+		static bool IsLinkComplete(GLuint program);
+	};
@@ -32,6 +32,7 @@
 class FakeOpenGLResourceDeclaration : public FakeShaderResourceDeclaration
 	{
 	friend class FakeOpenGLShader;
+	friend class FakeVulkanShader;
 
 	public:
 
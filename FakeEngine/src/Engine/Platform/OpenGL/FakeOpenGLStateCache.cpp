@@ -0,0 +1,253 @@
+#include "FakePch.h"
+#include "FakeOpenGLStateCache.h"
+
+#include "Engine/Renderer/FakeRendererAPI.h"
+
+// Marks state the cache does not know, the next call always reaches the driver
+static const GLuint UnknownObject = ~0u;
+
+struct FakeOpenGLStateCacheData
+	{
+	GLuint Program = UnknownObject;
+	GLuint VertexArray = UnknownObject;
+	GLuint ArrayBuffer = UnknownObject;
+	GLuint ElementArrayBuffer = UnknownObject;
+
+	// The first vertex buffer binding of the bound vertex array
+	GLuint VertexBuffer = UnknownObject;
+	GLsizei VertexBufferStride = 0;
+
+	std::vector<GLuint> TextureUnits;
+
+	// -1 unknown, 0 disabled, 1 enabled
+	int8 Blend = -1;
+	int8 DepthTest = -1;
+	int8 StencilTest = -1;
+
+	GLint Viewport[4] = { -1, -1, -1, -1 };
+
+	FakeOpenGLStateCache::Statistics Stats;
+	};
+
+static FakeOpenGLStateCacheData Data;
+
+namespace Utils
+	{
+	// Returns true if the call can be skipped, otherwise remembers the new value
+	template<typename T>
+	static bool fake_is_redundant(T &current, T value)
+		{
+		if (current == value)
+			{
+			Data.Stats.SkippedCalls++;
+			return true;
+			}
+
+		current = value;
+		Data.Stats.Calls++;
+		return false;
+		}
+
+	static int8 *fake_capability(GLenum capability)
+		{
+		switch (capability)
+			{
+			case GL_BLEND:          return &Data.Blend;
+			case GL_DEPTH_TEST:     return &Data.DepthTest;
+			case GL_STENCIL_TEST:   return &Data.StencilTest;
+			}
+
+		return nullptr;
+		}
+
+	static void fake_forget(GLuint &current, GLuint object)
+		{
+		if (current == object)
+			current = UnknownObject;
+		}
+	}
+
+void FakeOpenGLStateCache::Init()
+	{
+	int32 textureUnits = FakeRendererAPI::GetCapabilities().MaxTextureUnits;
+	Data.TextureUnits.resize(textureUnits > 0 ? (size_t)textureUnits : 32);
+
+	Invalidate();
+	}
+
+void FakeOpenGLStateCache::Invalidate()
+	{
+	Data.Program = UnknownObject;
+	Data.VertexArray = UnknownObject;
+	Data.ArrayBuffer = UnknownObject;
+	Data.ElementArrayBuffer = UnknownObject;
+	Data.VertexBuffer = UnknownObject;
+	Data.VertexBufferStride = 0;
+	std::fill(Data.TextureUnits.begin(), Data.TextureUnits.end(), UnknownObject);
+
+	Data.Blend = -1;
+	Data.DepthTest = -1;
+	Data.StencilTest = -1;
+
+	for (GLint &value : Data.Viewport)
+		value = -1;
+	}
+
+void FakeOpenGLStateCache::UseProgram(GLuint program)
+	{
+	if (!Utils::fake_is_redundant(Data.Program, program))
+		glUseProgram(program);
+	}
+
+void FakeOpenGLStateCache::BindVertexArray(GLuint vertexArray)
+	{
+	if (Utils::fake_is_redundant(Data.VertexArray, vertexArray))
+		return;
+
+	glBindVertexArray(vertexArray);
+
+	// Both live in the vertex array
+	Data.ElementArrayBuffer = UnknownObject;
+	Data.VertexBuffer = UnknownObject;
+	}
+
+void FakeOpenGLStateCache::BindBuffer(GLenum target, GLuint buffer)
+	{
+	if (target == GL_ARRAY_BUFFER)
+		{
+		if (Utils::fake_is_redundant(Data.ArrayBuffer, buffer))
+			return;
+		}
+	else if (target == GL_ELEMENT_ARRAY_BUFFER)
+		{
+		if (Utils::fake_is_redundant(Data.ElementArrayBuffer, buffer))
+			return;
+		}
+
+	glBindBuffer(target, buffer);
+	}
+
+GLuint FakeOpenGLStateCache::GetBuffer(GLenum target)
+	{
+	GLuint &buffer = target == GL_ARRAY_BUFFER ? Data.ArrayBuffer : Data.ElementArrayBuffer;
+	if (buffer == UnknownObject)
+		{
+		GLint bound = 0;
+		glGetIntegerv(target == GL_ARRAY_BUFFER ? GL_ARRAY_BUFFER_BINDING : GL_ELEMENT_ARRAY_BUFFER_BINDING, &bound);
+		buffer = (GLuint)bound;
+		}
+
+	return buffer;
+	}
+
+void FakeOpenGLStateCache::BindVertexBuffer(GLuint vertexArray, GLuint buffer, GLsizei stride)
+	{
+	FAKE_ASSERT(vertexArray == Data.VertexArray, "The vertex array has to be bound first!");
+
+	if (buffer == Data.VertexBuffer && stride == Data.VertexBufferStride)
+		{
+		Data.Stats.SkippedCalls++;
+		return;
+		}
+
+	glVertexArrayVertexBuffer(vertexArray, 0, buffer, 0, stride);
+	Data.VertexBuffer = buffer;
+	Data.VertexBufferStride = stride;
+	Data.Stats.Calls++;
+	}
+
+void FakeOpenGLStateCache::BindTextureUnit(uint32 unit, GLuint texture)
+	{
+	if (unit >= Data.TextureUnits.size())
+		Data.TextureUnits.resize(unit + 1, UnknownObject);
+
+	if (!Utils::fake_is_redundant(Data.TextureUnits[unit], texture))
+		glBindTextureUnit(unit, texture);
+	}
+
+void FakeOpenGLStateCache::BindTexture(GLenum target, GLuint texture)
+	{
+	glBindTexture(target, texture);
+
+	// Only glBindTextureUnit is cached, so unit 0 holds something unknown now
+	if (!Data.TextureUnits.empty())
+		Data.TextureUnits[0] = UnknownObject;
+	}
+
+void FakeOpenGLStateCache::SetEnabled(GLenum capability, bool enabled)
+	{
+	int8 *current = Utils::fake_capability(capability);
+	if (current && Utils::fake_is_redundant(*current, (int8)enabled))
+		return;
+
+	if (enabled)
+		glEnable(capability);
+	else
+		glDisable(capability);
+	}
+
+void FakeOpenGLStateCache::SetViewport(GLint x, GLint y, GLsizei width, GLsizei height)
+	{
+	GLint *viewport = Data.Viewport;
+	if (viewport[0] == x && viewport[1] == y && viewport[2] == width && viewport[3] == height)
+		{
+		Data.Stats.SkippedCalls++;
+		return;
+		}
+
+	viewport[0] = x;
+	viewport[1] = y;
+	viewport[2] = width;
+	viewport[3] = height;
+	Data.Stats.Calls++;
+
+	glViewport(x, y, width, height);
+	}
+
+void FakeOpenGLStateCache::DeleteProgram(GLuint program)
+	{
+	glDeleteProgram(program);
+	Utils::fake_forget(Data.Program, program);
+	}
+
+void FakeOpenGLStateCache::DeleteVertexArray(GLuint vertexArray)
+	{
+	glDeleteVertexArrays(1, &vertexArray);
+
+	// Deleting the bound vertex array binds the default one
+	if (Data.VertexArray == vertexArray)
+		{
+		Data.VertexArray = UnknownObject;
+		Data.ElementArrayBuffer = UnknownObject;
+		Data.VertexBuffer = UnknownObject;
+		}
+	}
+
+void FakeOpenGLStateCache::DeleteBuffer(GLuint buffer)
+	{
+	glDeleteBuffers(1, &buffer);
+	Utils::fake_forget(Data.ArrayBuffer, buffer);
+	Utils::fake_forget(Data.ElementArrayBuffer, buffer);
+	Utils::fake_forget(Data.VertexBuffer, buffer);
+	}
+
+void FakeOpenGLStateCache::DeleteTextures(GLsizei count, const GLuint *textures)
+	{
+	glDeleteTextures(count, textures);
+
+	for (GLsizei i = 0; i < count; ++i)
+		{
+		for (GLuint &unit : Data.TextureUnits)
+			Utils::fake_forget(unit, textures[i]);
+		}
+	}
+
+void FakeOpenGLStateCache::ResetStats()
+	{
+	memset(&Data.Stats, 0, sizeof(Statistics));
+	}
+
+FakeOpenGLStateCache::Statistics FakeOpenGLStateCache::GetStats()
+	{
+	return Data.Stats;
+	}
@@ -0,0 +1,125 @@
+/*****************************************************************
+ * \file   FakeOpenGLStateCache.h
+ * \brief  
+ * 
+ * \author Can Karka
+ * \date   February 2021
+ * 
+ * Copyright (C) 2021 Can Karka
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *********************************************************************/
+
+#pragma once
+
+#include <glad/glad.h>
+
+#include "Engine/Core/FakeCore.h"
+
+/**
+ *
+ * Shadows the bound program, vertex array, buffers, texture units, the blend, depth and stencil tests and the viewport,
+ * and drops calls which would set what is already set.
+ *
+ * The OpenGL backend changes this state only through the cache, otherwise the shadow copy goes stale.
+ * Deleted objects have to go through the cache as well, because OpenGL hands out their names again.
+ *
+ * @attention All functions must be called on the render thread.
+ *
+ */
+class FakeOpenGLStateCache
+	{
+	public:
+
+		struct Statistics
+			{
+			uint32 Calls = 0;
+			uint32 SkippedCalls = 0;
+			};
+
+		/**
+		 *
+		 * Sizes the texture units from the capabilities and forgets all state.
+		 * Called by FakeRendererAPI::Init before the default state is set.
+		 *
+		 */
+		static void Init();
+
+		/**
+		 *
+		 * Forgets all state, for code which has changed it behind the back of the cache.
+		 *
+		 */
+		static void Invalidate();
+
+		static void UseProgram(GLuint program);
+		static void BindVertexArray(GLuint vertexArray);
+
+		/**
+		 *
+		 * Binds a buffer. The element array buffer belongs to the vertex array, so it is forgotten with every vertex array change.
+		 *
+		 * @param target GL_ARRAY_BUFFER or GL_ELEMENT_ARRAY_BUFFER, other targets are not cached.
+		 * @param buffer The buffer to bind.
+		 */
+		static void BindBuffer(GLenum target, GLuint buffer);
+
+		/**
+		 *
+		 * Returns the buffer bound to a target, pipelines read their vertices from the bound array buffer.
+		 *
+		 * @param target GL_ARRAY_BUFFER or GL_ELEMENT_ARRAY_BUFFER.
+		 * @return Returns the bound buffer.
+		 */
+		static GLuint GetBuffer(GLenum target);
+
+		/**
+		 *
+		 * Attaches a buffer to the first vertex buffer binding of the bound vertex array.
+		 *
+		 * @param vertexArray The bound vertex array.
+		 * @param buffer The buffer which holds the vertices.
+		 * @param stride The distance between two vertices in bytes.
+		 */
+		static void BindVertexBuffer(GLuint vertexArray, GLuint buffer, GLsizei stride);
+
+		static void BindTextureUnit(uint32 unit, GLuint texture);
+
+		/**
+		 *
+		 * Binds a texture to the active texture unit to create or upload it, the cache forgets what unit 0 holds.
+		 *
+		 * @param target The texture target.
+		 * @param texture The texture to bind.
+		 */
+		static void BindTexture(GLenum target, GLuint texture);
+
+		/**
+		 *
+		 * Enables or disables a capability.
+		 *
+		 * @param capability GL_BLEND, GL_DEPTH_TEST or GL_STENCIL_TEST are cached, others are passed on.
+		 * @param enabled Whether the capability should be enabled.
+		 */
+		static void SetEnabled(GLenum capability, bool enabled);
+
+		static void SetViewport(GLint x, GLint y, GLsizei width, GLsizei height);
+
+		static void DeleteProgram(GLuint program);
+		static void DeleteVertexArray(GLuint vertexArray);
+		static void DeleteBuffer(GLuint buffer);
+		static void DeleteTextures(GLsizei count, const GLuint *textures);
+
+		static void ResetStats();
+		static Statistics GetStats();
+	};
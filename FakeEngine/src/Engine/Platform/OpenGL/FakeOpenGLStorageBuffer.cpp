@@ -0,0 +1,62 @@
+#include "FakePch.h"
+#include "FakeOpenGLStorageBuffer.h"
+
+#include "Engine/Renderer/FakeRenderer.h"
+#include "FakeOpenGLStateCache.h"
+
+FakeOpenGLStorageBuffer::FakeOpenGLStorageBuffer(uint32 size)
+	: Size(size)
+	{
+	FakeRef<FakeOpenGLStorageBuffer> instance = this;
+	FakeRenderer::Submit([instance]() mutable
+		{
+		glCreateBuffers(1, &instance->RendererID);
+		glNamedBufferStorage(instance->RendererID, instance->Size, nullptr, GL_DYNAMIC_STORAGE_BIT);
+
+		// Storage starts out undefined, shaders may read parts nobody has written yet
+		uint32 zero = 0;
+		glClearNamedBufferData(instance->RendererID, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, &zero);
+		});
+	}
+
+FakeOpenGLStorageBuffer::~FakeOpenGLStorageBuffer()
+	{
+	GLuint rendererID = RendererID;
+	FakeRenderer::Submit([rendererID]()
+		{
+		FakeOpenGLStateCache::DeleteBuffer(rendererID);
+		});
+	}
+
+void FakeOpenGLStorageBuffer::SetData(const void *data, uint32 size, uint32 offset)
+	{
+	FAKE_ASSERT(offset + size <= Size, "Data does not fit into the storage buffer!");
+
+	// The command owns its copy and frees it afterwards
+	std::vector<Byte> copy((const Byte*)data, (const Byte*)data + size);
+
+	FakeRef<FakeOpenGLStorageBuffer> instance = this;
+	FakeRenderer::Submit([instance, copy = std::move(copy), offset]()
+		{
+		glNamedBufferSubData(instance->RendererID, offset, (GLsizeiptr)copy.size(), copy.data());
+		});
+	}
+
+void FakeOpenGLStorageBuffer::Bind(uint32 binding) const
+	{
+	FakeRef<const FakeOpenGLStorageBuffer> instance = this;
+	FakeRenderer::Submit([instance, binding]() { glBindBufferBase(GL_SHADER_STORAGE_BUFFER, binding, instance->RendererID); });
+	}
+
+void FakeOpenGLStorageBuffer::BindIndirect() const
+	{
+	FakeRef<const FakeOpenGLStorageBuffer> instance = this;
+	FakeRenderer::Submit([instance]()
+		{
+		FakeOpenGLStateCache::BindBuffer(GL_DRAW_INDIRECT_BUFFER, instance->RendererID);
+
+		// Draw counts are read from a buffer since OpenGL 4.6 only
+		if (GLAD_GL_VERSION_4_6)
+			FakeOpenGLStateCache::BindBuffer(GL_PARAMETER_BUFFER, instance->RendererID);
+		});
+	}
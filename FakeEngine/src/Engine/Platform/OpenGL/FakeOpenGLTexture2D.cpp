@@ -5,6 +5,7 @@
 
 #include "Engine/Renderer/FakeRenderer.h"
 #include "Engine/Core/FakeVirtualFileSystem.h"
+#include "FakeOpenGLStateCache.h"
 
 namespace Utils
 	{
@@ -68,7 +69,7 @@ FakeOpenGLTexture2D::FakeOpenGLTexture2D(const FakeString &path, bool srgb, Fake
 		else
 			{
 			glGenTextures(1, &instance->RendererID);
-			glBindTexture(GL_TEXTURE_2D, instance->RendererID);
+			FakeOpenGLStateCache::BindTexture(GL_TEXTURE_2D, instance->RendererID);
 
 			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
 			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
@@ -82,7 +83,7 @@ FakeOpenGLTexture2D::FakeOpenGLTexture2D(const FakeString &path, bool srgb, Fake
 			glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, instance->Width, instance->Height, 0, format, type, instance->ImageData.Data);
 			glGenerateMipmap(GL_TEXTURE_2D);
 
-			glBindTexture(GL_TEXTURE_2D, 0);
+			FakeOpenGLStateCache::BindTexture(GL_TEXTURE_2D, 0);
 			}
 		stbi_image_free(instance->ImageData.Data);
 		});
@@ -95,7 +96,7 @@ FakeOpenGLTexture2D::FakeOpenGLTexture2D(FakeTextureFormat format, uint32 width,
 	FakeRenderer::Submit([instance]() mutable
 		{
 		glGenTextures(1, &instance->RendererID);
-		glBindTexture(GL_TEXTURE_2D, instance->RendererID);
+		FakeOpenGLStateCache::BindTexture(GL_TEXTURE_2D, instance->RendererID);
 
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
@@ -105,7 +106,7 @@ FakeOpenGLTexture2D::FakeOpenGLTexture2D(FakeTextureFormat format, uint32 width,
 		glTextureParameterf(instance->RendererID, GL_TEXTURE_MAX_ANISOTROPY, FakeRendererAPI::GetCapabilities().MaxAnisotropy);
 
 		glTexImage2D(GL_TEXTURE_2D, 0, Utils::fake_to_open_gl_texture_format(instance->Format), instance->Width, instance->Height, 0, Utils::fake_to_open_gl_texture_format(instance->Format), GL_UNSIGNED_BYTE, nullptr);
-		glBindTexture(GL_TEXTURE_2D, 0);
+		FakeOpenGLStateCache::BindTexture(GL_TEXTURE_2D, 0);
 		});
 	
 	ImageData.Allocate(width * height * FakeTexture::GetBPP(Format));
@@ -116,7 +117,7 @@ FakeOpenGLTexture2D::~FakeOpenGLTexture2D()
 	GLuint rendererID = RendererID;
 	FakeRenderer::Submit([rendererID]()
 		{
-		glDeleteTextures(1, &rendererID);
+		FakeOpenGLStateCache::DeleteTextures(1, &rendererID);
 		});
 	}
 
@@ -125,7 +126,7 @@ void FakeOpenGLTexture2D::Bind(uint32 slot) const
 	FakeRef<const FakeOpenGLTexture2D> instance = this;
 	FakeRenderer::Submit([instance, slot]()
 		{
-		glBindTextureUnit(slot, instance->RendererID);
+		FakeOpenGLStateCache::BindTextureUnit(slot, instance->RendererID);
 		});
 	}
 
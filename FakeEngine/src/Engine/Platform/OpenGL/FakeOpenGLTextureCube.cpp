@@ -3,6 +3,7 @@
 
 #include <stb_image.h>
 #include "Engine/Renderer/FakeRenderer.h"
+#include "FakeOpenGLStateCache.h"
 
 namespace Utils
 	{
@@ -77,7 +78,7 @@ FakeOpenGLTextureCube::FakeOpenGLTextureCube(const FakeString &path)
 	FakeRenderer::Submit([instance, faceWidth, faceHeight, faces]() mutable
 		{
 		glGenTextures(1, &instance->RendererID);
-		glBindTexture(GL_TEXTURE_CUBE_MAP, instance->RendererID);
+		FakeOpenGLStateCache::BindTexture(GL_TEXTURE_CUBE_MAP, instance->RendererID);
 
 		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
 		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
@@ -98,7 +99,7 @@ FakeOpenGLTextureCube::FakeOpenGLTextureCube(const FakeString &path)
 
 		glGenerateMipmap(GL_TEXTURE_CUBE_MAP);
 
-		glBindTexture(GL_TEXTURE_2D, 0);
+		FakeOpenGLStateCache::BindTexture(GL_TEXTURE_2D, 0);
 
 		for (size_t i = 0; i < faces.size(); i++)
 			delete[] faces[i];
@@ -130,7 +131,7 @@ FakeOpenGLTextureCube::FakeOpenGLTextureCube(FakeTextureFormat format, uint32 wi
 FakeOpenGLTextureCube::~FakeOpenGLTextureCube()
 	{
 	GLuint rendererID = RendererID;
-	FakeRenderer::Submit([rendererID]() { glDeleteTextures(1, &rendererID); });
+	FakeRenderer::Submit([rendererID]() { FakeOpenGLStateCache::DeleteTextures(1, &rendererID); });
 	}
 
 void FakeOpenGLTextureCube::Bind(uint32 slot) const
@@ -138,7 +139,7 @@ void FakeOpenGLTextureCube::Bind(uint32 slot) const
 	FakeRef<const FakeOpenGLTextureCube> instance = this;
 	FakeRenderer::Submit([instance, slot]()
 		{
-		glBindTextureUnit(slot, instance->RendererID);
+		FakeOpenGLStateCache::BindTextureUnit(slot, instance->RendererID);
 		});
 	}
 
@@ -2,6 +2,7 @@
 #include "FakeOpenGLVertexBuffer.h"
 
 #include "Engine/Renderer/FakeRenderer.h"
+#include "FakeOpenGLStateCache.h"
 
 namespace Utils
 	{
@@ -11,6 +12,7 @@ namespace Utils
 			{
 			case FakeVertexBufferUsage::Static:    return GL_STATIC_DRAW;
 			case FakeVertexBufferUsage::Dynamic:   return GL_DYNAMIC_DRAW;
+			case FakeVertexBufferUsage::Stream:    return GL_STREAM_DRAW;
 			}
 
 		FAKE_ASSERT(false);
@@ -21,50 +23,173 @@ namespace Utils
 FakeOpenGLVertexBuffer::FakeOpenGLVertexBuffer(void *data, uint32 size, FakeVertexBufferUsage usage)
 	: Size(size), Usage(usage)
 	{
-	LocalData = FakeAllocator::Copy(data, size);
-	
+	// Stream buffers are mapped right away, Map() can hand out memory before the first frame has been executed
+	if (Usage == FakeVertexBufferUsage::Stream)
+		{
+		CreateStorage(data);
+		return;
+		}
+
+	// The command owns the copy and frees it once the storage has been created
+	std::vector<Byte> copy((const Byte*)data, (const Byte*)data + size);
+
 	FakeRef<FakeOpenGLVertexBuffer> instance = this;
-	FakeRenderer::Submit([instance]() mutable
+	FakeRenderer::Submit([instance, copy = std::move(copy)]() mutable
 		{
-		glCreateBuffers(1, &instance->RendererID);
-		glNamedBufferData(instance->RendererID, instance->Size, instance->LocalData.Data, Utils::fake_open_gl_usage(instance->Usage));
+		instance->CreateStorage(copy.data());
 		});
 	}
 
 FakeOpenGLVertexBuffer::FakeOpenGLVertexBuffer(uint32 size, FakeVertexBufferUsage usage)
 	: Size(size), Usage(usage)
 	{
+	if (Usage == FakeVertexBufferUsage::Stream)
+		{
+		CreateStorage(nullptr);
+		return;
+		}
+
 	FakeRef<FakeOpenGLVertexBuffer> instance = this;
 	FakeRenderer::Submit([instance]() mutable
 		{
-		glCreateBuffers(1, &instance->RendererID);
-		glNamedBufferData(instance->RendererID, instance->Size, nullptr, Utils::fake_open_gl_usage(instance->Usage));
+		instance->CreateStorage(nullptr);
 		});
 	}
 
 FakeOpenGLVertexBuffer::~FakeOpenGLVertexBuffer()
 	{
 	GLuint rendererID = RendererID;
-	FakeRenderer::Submit([rendererID]() { glDeleteBuffers(1, &rendererID); });
+	GLsync fences[StreamRegionCount];
+	memcpy(fences, StreamFences, sizeof(StreamFences));
+
+	// Deleting the buffer also unmaps it
+	FakeRenderer::Submit([rendererID, fences]()
+		{
+		for (GLsync fence : fences)
+			{
+			if (fence)
+				glDeleteSync(fence);
+			}
+
+		FakeOpenGLStateCache::DeleteBuffer(rendererID);
+		});
+	}
+
+void FakeOpenGLVertexBuffer::CreateStorage(const void *data)
+	{
+	glCreateBuffers(1, &RendererID);
+
+	if (Usage != FakeVertexBufferUsage::Stream)
+		{
+		glNamedBufferData(RendererID, Size, data, Utils::fake_open_gl_usage(Usage));
+		return;
+		}
+
+	// Coherent, so writes are visible to the GPU without a flush
+	GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+	GLsizeiptr storageSize = (GLsizeiptr)Size * StreamRegionCount;
+	glNamedBufferStorage(RendererID, storageSize, nullptr, flags);
+	MappedData = (Byte*)glMapNamedBufferRange(RendererID, 0, storageSize, flags);
+
+	if (data)
+		memcpy(MappedData, data, Size);
+	}
+
+void FakeOpenGLVertexBuffer::BeginStreamRegion()
+	{
+	// The commands of the frames which wrote the current region have all been executed, the fence follows their draws
+	if (StreamFrame != ~0u)
+		{
+		StreamFences[StreamRegion] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		StreamRegion = (StreamRegion + 1) % StreamRegionCount;
+		}
+
+	// Only blocks if the CPU is more than StreamRegionCount frames ahead of the GPU
+	GLsync fence = StreamFences[StreamRegion];
+	if (fence)
+		{
+		GLenum result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+		while (result == GL_TIMEOUT_EXPIRED)
+			result = glClientWaitSync(fence, 0, 1000000);
+
+		glDeleteSync(fence);
+		StreamFences[StreamRegion] = nullptr;
+		}
+
+	StreamFrame = FakeRenderer::GetFrameIndex();
+	StreamHead = 0;
+	}
+
+void *FakeOpenGLVertexBuffer::Map(uint32 size, uint32 stride)
+	{
+	FAKE_ASSERT(Usage == FakeVertexBufferUsage::Stream, "Only stream buffers can be mapped!");
+
+	if (StreamFrame != FakeRenderer::GetFrameIndex())
+		BeginStreamRegion();
+
+	// Offsets are multiples of the stride from the start of the buffer, so draws can address them by vertex or instance
+	uint32 regionStart = StreamRegion * Size;
+	uint32 offset = (regionStart + StreamHead + stride - 1) / stride * stride;
+
+	// The region of this frame is full, the commands recorded so far are executed and the frame goes on in the next region
+	if (offset + size > regionStart + Size)
+		{
+		FakeRenderer::Flush();
+		BeginStreamRegion();
+
+		regionStart = StreamRegion * Size;
+		offset = (regionStart + stride - 1) / stride * stride;
+		FAKE_ASSERT(offset + size <= regionStart + Size, "Stream data does not fit into one region!");
+		}
+
+	StreamOffset = offset;
+	return MappedData + offset;
+	}
+
+void FakeOpenGLVertexBuffer::Unmap(uint32 usedSize)
+	{
+	// Draws reading this memory may be recorded after a Flush() in between, so the region belongs to the current frame as well
+	StreamHead = StreamOffset + usedSize - StreamRegion * Size;
+	StreamFrame = FakeRenderer::GetFrameIndex();
 	}
 
 void FakeOpenGLVertexBuffer::SetData(void *data, uint32 size, uint32 offset)
 	{
-	LocalData = FakeAllocator::Copy(data, size);
-	Size = size;
+	if (Usage == FakeVertexBufferUsage::Stream)
+		{
+		// The mapped memory is not read before Render(), so the caller's data is copied straight into the buffer
+		Byte *memory = (Byte*)Map(offset + size);
+		memcpy(memory + offset, data, size);
+		Unmap(offset + size);
+		return;
+		}
+
+	FAKE_ASSERT(offset + size <= Size, "Vertex data does not fit into the buffer!");
+
+	// The caller may reuse its memory before the command runs, the command owns its copy and frees it afterwards
+	std::vector<Byte> copy((const Byte*)data, (const Byte*)data + size);
 
 	FakeRef<FakeOpenGLVertexBuffer> instance = this;
-	FakeRenderer::Submit([instance, offset]() { glNamedBufferSubData(instance->RendererID, offset, instance->LocalData.Size, instance->LocalData.Data); });
+	FakeRenderer::Submit([instance, copy = std::move(copy), offset]()
+		{
+		glNamedBufferSubData(instance->RendererID, offset, (GLsizeiptr)copy.size(), copy.data());
+		});
 	}
 
 void FakeOpenGLVertexBuffer::Bind() const
 	{
 	FakeRef<const FakeOpenGLVertexBuffer> instance = this;
-	FakeRenderer::Submit([instance]() { glBindBuffer(GL_ARRAY_BUFFER, instance->RendererID); });
+	FakeRenderer::Submit([instance]() { FakeOpenGLStateCache::BindBuffer(GL_ARRAY_BUFFER, instance->RendererID); });
 	}
 
 void FakeOpenGLVertexBuffer::Unbind() const
 	{
-	FakeRenderer::Submit([]() { glBindBuffer(GL_ARRAY_BUFFER, 0); });
+	FakeRenderer::Submit([]() { FakeOpenGLStateCache::BindBuffer(GL_ARRAY_BUFFER, 0); });
 	}
 
+
+void FakeOpenGLVertexBuffer::BindStorage(uint32 binding) const
+	{
+	FakeRef<const FakeOpenGLVertexBuffer> instance = this;
+	FakeRenderer::Submit([instance, binding]() { glBindBufferBase(GL_SHADER_STORAGE_BUFFER, binding, instance->RendererID); });
+	}
@@ -25,7 +25,6 @@
 #include <glad/glad.h>
 
 #include "Engine/Renderer/FakeVertexBuffer.h"
-#include "Engine/Core/FakeAllocator.h"
 
 /**
  * 
@@ -40,7 +39,19 @@ class FakeOpenGLVertexBuffer : public FakeVertexBuffer
 		uint32 Size;
 		FakeVertexBufferUsage Usage;
 		FakeVertexBufferLayout Layout;
-		FakeAllocator LocalData;
+
+		// Stream buffers only, the whole buffer stays mapped and every region is guarded by a fence.
+		// The regions follow the frames of FakeRenderer, so memory can be handed out while the frame is recorded.
+		static const uint32 StreamRegionCount = 3;
+		Byte *MappedData = nullptr;
+		uint32 StreamRegion = 0;
+		uint32 StreamFrame = ~0u;
+		uint32 StreamHead = 0;
+		uint32 StreamOffset = 0;
+		GLsync StreamFences[StreamRegionCount] = {};
+
+		void CreateStorage(const void *data);
+		void BeginStreamRegion();
 
 	public:
 
@@ -49,13 +60,17 @@ class FakeOpenGLVertexBuffer : public FakeVertexBuffer
 		virtual ~FakeOpenGLVertexBuffer();
 
 		virtual void SetData(void *data, uint32 size, uint32 offset = 0) override;
+		virtual void *Map(uint32 size, uint32 stride = 1) override;
+		virtual void Unmap(uint32 usedSize) override;
 		virtual void Bind() const override;
 		virtual void Unbind() const override;
+		virtual void BindStorage(uint32 binding) const override;
 
 		virtual const FakeVertexBufferLayout &GetLayout() const override { return Layout; }
 		virtual void SetLayout(const FakeVertexBufferLayout &layout) override { Layout = layout; }
 
 		virtual uint32 GetSize() const override { return Size; }
+		virtual uint32 GetStreamOffset() const override { return StreamOffset; }
 		virtual FakeRendererID GetRendererID() const override { return RendererID; }
 
 	};
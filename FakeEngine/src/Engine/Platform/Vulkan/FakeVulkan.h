@@ -32,7 +32,7 @@
 	VkResult res = (f);												             \
 	if (res != VK_SUCCESS)											             \
 	{																             \
-		FAKE_LOG_ERROR("VkResult is '%d' in %s:%s", res, __FILE__ , __LINE__);   \
+		FAKE_LOG_ERROR("VkResult is '%d' in %s:%d", res, __FILE__ , __LINE__);   \
 		FAKE_ASSERT(res == VK_SUCCESS);										     \
 	}																			 \
 }
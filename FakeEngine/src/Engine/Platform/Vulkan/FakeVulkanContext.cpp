@@ -0,0 +1,584 @@
+#include "FakePch.h"
+#include "FakeVulkanContext.h"
+
+#ifdef FAKE_RENDERER_VULKAN
+
+#include <deque>
+
+struct FakeVulkanDeferredDestruction
+	{
+	uint64 Value = 0;
+	std::function<void()> Destroy;
+	};
+
+struct FakeVulkanContextData
+	{
+	bool Initialized = false;
+	bool Supported = false;
+
+	VkInstance Instance = VK_NULL_HANDLE;
+	VkDebugUtilsMessengerEXT DebugMessenger = VK_NULL_HANDLE;
+	VkPhysicalDevice PhysicalDevice = VK_NULL_HANDLE;
+	VkDevice Device = VK_NULL_HANDLE;
+	VkQueue Queue = VK_NULL_HANDLE;
+	uint32 QueueFamily = 0;
+
+	VkPhysicalDeviceProperties Properties = {};
+	VkPhysicalDeviceMemoryProperties MemoryProperties = {};
+	FakeVulkanContext::Features Features;
+
+	VkSemaphore Timeline = VK_NULL_HANDLE;
+	uint64 SubmittedValue = 0;
+	uint64 CompletedValue = 0;
+
+	VkCommandPool ImmediatePool = VK_NULL_HANDLE;
+
+	std::deque<FakeVulkanDeferredDestruction> Destructions;
+	FakeRendererID NextRendererID = 1;
+	};
+
+static FakeVulkanContextData Data;
+
+namespace Utils
+	{
+	static VKAPI_ATTR VkBool32 VKAPI_CALL fake_vulkan_log_message(VkDebugUtilsMessageSeverityFlagBitsEXT severity, VkDebugUtilsMessageTypeFlagsEXT type, const VkDebugUtilsMessengerCallbackDataEXT *data, void *userData)
+		{
+		if (severity & VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT)
+			{
+			FAKE_LOG_ERROR("[Vulkan] %s", data->pMessage);
+			}
+		else if (severity & VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT)
+			{
+			FAKE_LOG_WARN("[Vulkan] %s", data->pMessage);
+			}
+
+		return VK_FALSE;
+		}
+
+	static bool fake_has_layer(const char *name)
+		{
+		uint32 count = 0;
+		vkEnumerateInstanceLayerProperties(&count, nullptr);
+		std::vector<VkLayerProperties> layers(count);
+		vkEnumerateInstanceLayerProperties(&count, layers.data());
+
+		for (const VkLayerProperties &layer : layers)
+			{
+			if (strcmp(layer.layerName, name) == 0)
+				return true;
+			}
+
+		return false;
+		}
+
+	static bool fake_has_instance_extension(const char *name)
+		{
+		uint32 count = 0;
+		vkEnumerateInstanceExtensionProperties(nullptr, &count, nullptr);
+		std::vector<VkExtensionProperties> extensions(count);
+		vkEnumerateInstanceExtensionProperties(nullptr, &count, extensions.data());
+
+		for (const VkExtensionProperties &extension : extensions)
+			{
+			if (strcmp(extension.extensionName, name) == 0)
+				return true;
+			}
+
+		return false;
+		}
+
+	// Dedicated GPUs first, software rasterizers like lavapipe last, they are still good enough for headless tests
+	static uint32 fake_device_rank(VkPhysicalDeviceType type)
+		{
+		switch (type)
+			{
+			case VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU:      return 4;
+			case VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU:    return 3;
+			case VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU:       return 2;
+			case VK_PHYSICAL_DEVICE_TYPE_CPU:               return 1;
+			}
+
+		return 0;
+		}
+
+	// Graphics queues always support transfers, compute is needed for the particles and the GPU scene
+	static bool fake_find_queue_family(VkPhysicalDevice device, uint32 &outFamily)
+		{
+		uint32 count = 0;
+		vkGetPhysicalDeviceQueueFamilyProperties(device, &count, nullptr);
+		std::vector<VkQueueFamilyProperties> families(count);
+		vkGetPhysicalDeviceQueueFamilyProperties(device, &count, families.data());
+
+		for (uint32 i = 0; i < count; ++i)
+			{
+			if ((families[i].queueFlags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT)) == (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT))
+				{
+				outFamily = i;
+				return true;
+				}
+			}
+
+		return false;
+		}
+
+	static bool fake_create_instance()
+		{
+		PFN_vkEnumerateInstanceVersion enumerateInstanceVersion = (PFN_vkEnumerateInstanceVersion)vkGetInstanceProcAddr(VK_NULL_HANDLE, "vkEnumerateInstanceVersion");
+		uint32 instanceVersion = VK_API_VERSION_1_0;
+		if (enumerateInstanceVersion)
+			enumerateInstanceVersion(&instanceVersion);
+
+		if (instanceVersion < VK_API_VERSION_1_2)
+			{
+			FAKE_LOG_ERROR("The Vulkan loader supports version %d.%d only, 1.2 is required!", VK_VERSION_MAJOR(instanceVersion), VK_VERSION_MINOR(instanceVersion));
+			return false;
+			}
+
+		VkApplicationInfo applicationInfo = {};
+		applicationInfo.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
+		applicationInfo.pApplicationName = "FakeEngine";
+		applicationInfo.pEngineName = "FakeEngine";
+		applicationInfo.engineVersion = VK_MAKE_VERSION(1, 0, 0);
+		applicationInfo.apiVersion = VK_API_VERSION_1_2;
+
+		std::vector<const char*> layers;
+		std::vector<const char*> extensions;
+
+	#ifdef FAKE_DEBUG
+		if (fake_has_layer("VK_LAYER_KHRONOS_validation"))
+			layers.push_back("VK_LAYER_KHRONOS_validation");
+		if (fake_has_instance_extension(VK_EXT_DEBUG_UTILS_EXTENSION_NAME))
+			extensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
+	#endif
+
+		VkInstanceCreateInfo instanceInfo = {};
+		instanceInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
+		instanceInfo.pApplicationInfo = &applicationInfo;
+		instanceInfo.enabledLayerCount = (uint32)layers.size();
+		instanceInfo.ppEnabledLayerNames = layers.data();
+		instanceInfo.enabledExtensionCount = (uint32)extensions.size();
+		instanceInfo.ppEnabledExtensionNames = extensions.data();
+
+		if (vkCreateInstance(&instanceInfo, nullptr, &Data.Instance) != VK_SUCCESS)
+			{
+			FAKE_LOG_ERROR("Could not create a Vulkan instance!");
+			return false;
+			}
+
+		if (!extensions.empty())
+			{
+			VkDebugUtilsMessengerCreateInfoEXT messengerInfo = {};
+			messengerInfo.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_MESSENGER_CREATE_INFO_EXT;
+			messengerInfo.messageSeverity = VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT | VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT;
+			messengerInfo.messageType = VK_DEBUG_UTILS_MESSAGE_TYPE_GENERAL_BIT_EXT | VK_DEBUG_UTILS_MESSAGE_TYPE_VALIDATION_BIT_EXT | VK_DEBUG_UTILS_MESSAGE_TYPE_PERFORMANCE_BIT_EXT;
+			messengerInfo.pfnUserCallback = fake_vulkan_log_message;
+
+			PFN_vkCreateDebugUtilsMessengerEXT createMessenger = (PFN_vkCreateDebugUtilsMessengerEXT)vkGetInstanceProcAddr(Data.Instance, "vkCreateDebugUtilsMessengerEXT");
+			if (createMessenger)
+				createMessenger(Data.Instance, &messengerInfo, nullptr, &Data.DebugMessenger);
+			}
+
+		return true;
+		}
+
+	static bool fake_pick_physical_device()
+		{
+		uint32 count = 0;
+		vkEnumeratePhysicalDevices(Data.Instance, &count, nullptr);
+		std::vector<VkPhysicalDevice> devices(count);
+		vkEnumeratePhysicalDevices(Data.Instance, &count, devices.data());
+
+		uint32 bestRank = 0;
+		for (VkPhysicalDevice device : devices)
+			{
+			VkPhysicalDeviceProperties properties;
+			vkGetPhysicalDeviceProperties(device, &properties);
+			if (properties.apiVersion < VK_API_VERSION_1_2)
+				continue;
+
+			VkPhysicalDeviceVulkan12Features features12 = {};
+			features12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+
+			VkPhysicalDeviceFeatures2 features = {};
+			features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+			features.pNext = &features12;
+			vkGetPhysicalDeviceFeatures2(device, &features);
+
+			uint32 queueFamily = 0;
+			if (!features12.timelineSemaphore || !fake_find_queue_family(device, queueFamily))
+				continue;
+
+			uint32 rank = fake_device_rank(properties.deviceType) + 1;
+			if (rank > bestRank)
+				{
+				bestRank = rank;
+				Data.PhysicalDevice = device;
+				Data.QueueFamily = queueFamily;
+				Data.Properties = properties;
+				}
+			}
+
+		if (!Data.PhysicalDevice)
+			{
+			FAKE_LOG_ERROR("There is no Vulkan 1.2 device with timeline semaphores!");
+			return false;
+			}
+
+		vkGetPhysicalDeviceMemoryProperties(Data.PhysicalDevice, &Data.MemoryProperties);
+		return true;
+		}
+
+	static bool fake_create_device()
+		{
+		VkPhysicalDeviceVulkan11Features supported11 = {};
+		supported11.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_1_FEATURES;
+
+		VkPhysicalDeviceVulkan12Features supported12 = {};
+		supported12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+		supported12.pNext = &supported11;
+
+		VkPhysicalDeviceFeatures2 supported = {};
+		supported.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+		supported.pNext = &supported12;
+		vkGetPhysicalDeviceFeatures2(Data.PhysicalDevice, &supported);
+
+		// Only what the backend uses is enabled, everything optional has a fallback
+		VkPhysicalDeviceVulkan11Features enabled11 = {};
+		enabled11.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_1_FEATURES;
+		enabled11.shaderDrawParameters = supported11.shaderDrawParameters;
+
+		VkPhysicalDeviceVulkan12Features enabled12 = {};
+		enabled12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+		enabled12.pNext = &enabled11;
+		enabled12.timelineSemaphore = VK_TRUE;
+		enabled12.drawIndirectCount = supported12.drawIndirectCount;
+
+		VkPhysicalDeviceFeatures2 enabled = {};
+		enabled.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+		enabled.pNext = &enabled12;
+		enabled.features.multiDrawIndirect = supported.features.multiDrawIndirect;
+		enabled.features.drawIndirectFirstInstance = supported.features.drawIndirectFirstInstance;
+		enabled.features.wideLines = supported.features.wideLines;
+		enabled.features.samplerAnisotropy = supported.features.samplerAnisotropy;
+		enabled.features.fragmentStoresAndAtomics = supported.features.fragmentStoresAndAtomics;
+		enabled.features.vertexPipelineStoresAndAtomics = supported.features.vertexPipelineStoresAndAtomics;
+
+		Data.Features.DrawParameters = supported11.shaderDrawParameters == VK_TRUE;
+		Data.Features.DrawIndirectCount = supported12.drawIndirectCount == VK_TRUE;
+		Data.Features.MultiDrawIndirect = supported.features.multiDrawIndirect == VK_TRUE;
+		Data.Features.WideLines = supported.features.wideLines == VK_TRUE;
+		Data.Features.SamplerAnisotropy = supported.features.samplerAnisotropy == VK_TRUE;
+
+		float priority = 1.0f;
+		VkDeviceQueueCreateInfo queueInfo = {};
+		queueInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+		queueInfo.queueFamilyIndex = Data.QueueFamily;
+		queueInfo.queueCount = 1;
+		queueInfo.pQueuePriorities = &priority;
+
+		VkDeviceCreateInfo deviceInfo = {};
+		deviceInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+		deviceInfo.pNext = &enabled;
+		deviceInfo.queueCreateInfoCount = 1;
+		deviceInfo.pQueueCreateInfos = &queueInfo;
+
+		if (vkCreateDevice(Data.PhysicalDevice, &deviceInfo, nullptr, &Data.Device) != VK_SUCCESS)
+			{
+			FAKE_LOG_ERROR("Could not create the Vulkan device!");
+			return false;
+			}
+
+		vkGetDeviceQueue(Data.Device, Data.QueueFamily, 0, &Data.Queue);
+
+		VkSemaphoreTypeCreateInfo timelineInfo = {};
+		timelineInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+		timelineInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+		timelineInfo.initialValue = 0;
+
+		VkSemaphoreCreateInfo semaphoreInfo = {};
+		semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+		semaphoreInfo.pNext = &timelineInfo;
+		FAKE_VK_CHECK_RESULT(vkCreateSemaphore(Data.Device, &semaphoreInfo, nullptr, &Data.Timeline));
+
+		VkCommandPoolCreateInfo poolInfo = {};
+		poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+		poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+		poolInfo.queueFamilyIndex = Data.QueueFamily;
+		FAKE_VK_CHECK_RESULT(vkCreateCommandPool(Data.Device, &poolInfo, nullptr, &Data.ImmediatePool));
+
+		return true;
+		}
+
+	static void fake_init()
+		{
+		if (Data.Initialized)
+			return;
+
+		Data.Initialized = true;
+		Data.Supported = fake_create_instance() && fake_pick_physical_device() && fake_create_device();
+
+		if (Data.Supported)
+			FAKE_LOG_INFO("Vulkan device: %s, API %d.%d", Data.Properties.deviceName, VK_VERSION_MAJOR(Data.Properties.apiVersion), VK_VERSION_MINOR(Data.Properties.apiVersion));
+		}
+	}
+
+bool FakeVulkanContext::IsSupported()
+	{
+	Utils::fake_init();
+	return Data.Supported;
+	}
+
+void FakeVulkanContext::Shutdown()
+	{
+	if (!Data.Initialized)
+		return;
+
+	if (Data.Device)
+		{
+		WaitIdle();
+
+		// Nothing is submitted anymore, objects waiting for the next submission are destroyed as well
+		while (!Data.Destructions.empty())
+			{
+			std::function<void()> destroy = std::move(Data.Destructions.front().Destroy);
+			Data.Destructions.pop_front();
+			destroy();
+			}
+
+		vkDestroyCommandPool(Data.Device, Data.ImmediatePool, nullptr);
+		vkDestroySemaphore(Data.Device, Data.Timeline, nullptr);
+		vkDestroyDevice(Data.Device, nullptr);
+		}
+
+	if (Data.DebugMessenger)
+		{
+		PFN_vkDestroyDebugUtilsMessengerEXT destroyMessenger = (PFN_vkDestroyDebugUtilsMessengerEXT)vkGetInstanceProcAddr(Data.Instance, "vkDestroyDebugUtilsMessengerEXT");
+		if (destroyMessenger)
+			destroyMessenger(Data.Instance, Data.DebugMessenger, nullptr);
+		}
+
+	if (Data.Instance)
+		vkDestroyInstance(Data.Instance, nullptr);
+
+	// A later frame on the Vulkan backend starts over with a new device
+	Data = FakeVulkanContextData();
+	}
+
+VkInstance FakeVulkanContext::GetInstance()
+	{
+	Utils::fake_init();
+	return Data.Instance;
+	}
+
+VkPhysicalDevice FakeVulkanContext::GetPhysicalDevice()
+	{
+	Utils::fake_init();
+	return Data.PhysicalDevice;
+	}
+
+VkDevice FakeVulkanContext::GetDevice()
+	{
+	// Resources are created before FakeRendererAPI::Init() has been executed, the first one creates the device
+	if (!Data.Initialized)
+		Utils::fake_init();
+
+	FAKE_ASSERT(Data.Supported, "There is no Vulkan device!");
+	return Data.Device;
+	}
+
+VkQueue FakeVulkanContext::GetQueue()
+	{
+	Utils::fake_init();
+	return Data.Queue;
+	}
+
+uint32 FakeVulkanContext::GetQueueFamily()
+	{
+	Utils::fake_init();
+	return Data.QueueFamily;
+	}
+
+const VkPhysicalDeviceProperties &FakeVulkanContext::GetProperties()
+	{
+	Utils::fake_init();
+	return Data.Properties;
+	}
+
+const FakeVulkanContext::Features &FakeVulkanContext::GetFeatures()
+	{
+	Utils::fake_init();
+	return Data.Features;
+	}
+
+FakeRendererID FakeVulkanContext::CreateRendererID()
+	{
+	return Data.NextRendererID++;
+	}
+
+VkDeviceMemory FakeVulkanContext::Allocate(const VkMemoryRequirements &requirements, VkMemoryPropertyFlags properties)
+	{
+	VkDevice device = GetDevice();
+
+	uint32 memoryType = ~0u;
+	for (uint32 i = 0; i < Data.MemoryProperties.memoryTypeCount; ++i)
+		{
+		if ((requirements.memoryTypeBits & (1u << i)) && (Data.MemoryProperties.memoryTypes[i].propertyFlags & properties) == properties)
+			{
+			memoryType = i;
+			break;
+			}
+		}
+
+	FAKE_ASSERT(memoryType != ~0u, "There is no memory type with the requested properties!");
+
+	VkMemoryAllocateInfo allocateInfo = {};
+	allocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+	allocateInfo.allocationSize = requirements.size;
+	allocateInfo.memoryTypeIndex = memoryType;
+
+	VkDeviceMemory memory = VK_NULL_HANDLE;
+	FAKE_VK_CHECK_RESULT(vkAllocateMemory(device, &allocateInfo, nullptr, &memory));
+	return memory;
+	}
+
+void *FakeVulkanContext::CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, VkBuffer &outBuffer, VkDeviceMemory &outMemory)
+	{
+	VkDevice device = GetDevice();
+
+	VkBufferCreateInfo bufferInfo = {};
+	bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+	bufferInfo.size = FAKE_MAX(size, (VkDeviceSize)4);
+	bufferInfo.usage = usage;
+	bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+	FAKE_VK_CHECK_RESULT(vkCreateBuffer(device, &bufferInfo, nullptr, &outBuffer));
+
+	VkMemoryRequirements requirements;
+	vkGetBufferMemoryRequirements(device, outBuffer, &requirements);
+	outMemory = Allocate(requirements, properties);
+	FAKE_VK_CHECK_RESULT(vkBindBufferMemory(device, outBuffer, outMemory, 0));
+
+	void *mapped = nullptr;
+	if (properties & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+		FAKE_VK_CHECK_RESULT(vkMapMemory(device, outMemory, 0, VK_WHOLE_SIZE, 0, &mapped));
+
+	return mapped;
+	}
+
+void FakeVulkanContext::CreateImage(const VkImageCreateInfo &info, VkImage &outImage, VkDeviceMemory &outMemory)
+	{
+	VkDevice device = GetDevice();
+	FAKE_VK_CHECK_RESULT(vkCreateImage(device, &info, nullptr, &outImage));
+
+	VkMemoryRequirements requirements;
+	vkGetImageMemoryRequirements(device, outImage, &requirements);
+	outMemory = Allocate(requirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+	FAKE_VK_CHECK_RESULT(vkBindImageMemory(device, outImage, outMemory, 0));
+	}
+
+uint64 FakeVulkanContext::Submit(uint32 count, const VkCommandBuffer *commandBuffers)
+	{
+	// uint64 is not the uint64_t of the Vulkan headers on every platform
+	uint64_t value = ++Data.SubmittedValue;
+
+	VkTimelineSemaphoreSubmitInfo timelineInfo = {};
+	timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+	timelineInfo.signalSemaphoreValueCount = 1;
+	timelineInfo.pSignalSemaphoreValues = &value;
+
+	VkSubmitInfo submitInfo = {};
+	submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+	submitInfo.pNext = &timelineInfo;
+	submitInfo.commandBufferCount = count;
+	submitInfo.pCommandBuffers = commandBuffers;
+	submitInfo.signalSemaphoreCount = 1;
+	submitInfo.pSignalSemaphores = &Data.Timeline;
+
+	FAKE_VK_CHECK_RESULT(vkQueueSubmit(Data.Queue, 1, &submitInfo, VK_NULL_HANDLE));
+	return value;
+	}
+
+void FakeVulkanContext::ImmediateSubmit(const std::function<void(VkCommandBuffer)> &record)
+	{
+	VkDevice device = GetDevice();
+
+	VkCommandBufferAllocateInfo allocateInfo = {};
+	allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+	allocateInfo.commandPool = Data.ImmediatePool;
+	allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+	allocateInfo.commandBufferCount = 1;
+
+	VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+	FAKE_VK_CHECK_RESULT(vkAllocateCommandBuffers(device, &allocateInfo, &commandBuffer));
+
+	VkCommandBufferBeginInfo beginInfo = {};
+	beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+	beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+	vkBeginCommandBuffer(commandBuffer, &beginInfo);
+	record(commandBuffer);
+	vkEndCommandBuffer(commandBuffer);
+
+	Wait(Submit(1, &commandBuffer));
+	vkFreeCommandBuffers(device, Data.ImmediatePool, 1, &commandBuffer);
+	}
+
+void FakeVulkanContext::Wait(uint64 value)
+	{
+	if (value <= Data.CompletedValue)
+		return;
+
+	VkSemaphoreWaitInfo waitInfo = {};
+	waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+	waitInfo.semaphoreCount = 1;
+	waitInfo.pSemaphores = &Data.Timeline;
+	uint64_t waitValue = value;
+	waitInfo.pValues = &waitValue;
+
+	FAKE_VK_CHECK_RESULT(vkWaitSemaphores(Data.Device, &waitInfo, UINT64_MAX));
+	Data.CompletedValue = value;
+	}
+
+void FakeVulkanContext::WaitIdle()
+	{
+	Wait(Data.SubmittedValue);
+	}
+
+uint64 FakeVulkanContext::GetSubmittedValue()
+	{
+	return Data.SubmittedValue;
+	}
+
+uint64 FakeVulkanContext::GetCompletedValue()
+	{
+	if (Data.CompletedValue < Data.SubmittedValue)
+		{
+		uint64_t completed = 0;
+		vkGetSemaphoreCounterValue(Data.Device, Data.Timeline, &completed);
+		Data.CompletedValue = completed;
+		}
+
+	return Data.CompletedValue;
+	}
+
+void FakeVulkanContext::DestroyLater(std::function<void()> &&destroy)
+	{
+	// Everything has been destroyed with the device already
+	if (!Data.Device)
+		return;
+
+	// The frame which is being captured may still reference the object, it is submitted with the next value
+	Data.Destructions.push_back({ Data.SubmittedValue + 1, std::move(destroy) });
+	}
+
+void FakeVulkanContext::CollectGarbage()
+	{
+	uint64 completed = GetCompletedValue();
+	while (!Data.Destructions.empty() && Data.Destructions.front().Value <= completed)
+		{
+		// Destroying an object can release others, which are queued behind it
+		std::function<void()> destroy = std::move(Data.Destructions.front().Destroy);
+		Data.Destructions.pop_front();
+		destroy();
+		}
+	}
+
+#endif
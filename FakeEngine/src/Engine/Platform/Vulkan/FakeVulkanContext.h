@@ -0,0 +1,183 @@
+/*****************************************************************
+ * \file   FakeVulkanContext.h
+ * \brief  
+ * 
+ * \author Can Karka
+ * \date   February 2021
+ * 
+ * Copyright (C) 2021 Can Karka
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *********************************************************************/
+
+#pragma once
+
+#include "FakeVulkan.h"
+
+#include "Engine/Core/FakeCore.h"
+
+/**
+ *
+ * Owns the instance, the device and the queue of the Vulkan backend, and the timeline semaphore every submission signals.
+ *
+ * The device is created on first use, because resources may be constructed before FakeRendererAPI::Init() has run.
+ * Objects the GPU might still read are handed to DestroyLater() and destroyed once the submission which follows has finished.
+ *
+ * @attention All functions must be called on the render thread.
+ *
+ */
+class FakeVulkanContext
+	{
+	public:
+
+		/**
+		 *
+		 * Optional device features, the backend falls back to slower paths without them.
+		 *
+		 */
+		struct Features
+			{
+			bool DrawParameters = false;		/**< gl_BaseInstanceARB, otherwise the base instance is pushed as a constant. */
+			bool DrawIndirectCount = false;		/**< The GPU reads the amount of indirect draws from a buffer. */
+			bool MultiDrawIndirect = false;		/**< One indirect call issues many draws. */
+			bool WideLines = false;				/**< Lines thicker than one pixel. */
+			bool SamplerAnisotropy = false;
+			};
+
+		/**
+		 *
+		 * Creates the device if it does not exist yet.
+		 *
+		 * @return Returns false if there is no Vulkan 1.2 device with timeline semaphores, the backend can not be used then.
+		 */
+		static bool IsSupported();
+
+		/**
+		 *
+		 * Waits for the GPU, destroys everything handed to DestroyLater() and then the device and the instance.
+		 *
+		 */
+		static void Shutdown();
+
+		static VkInstance GetInstance();
+		static VkPhysicalDevice GetPhysicalDevice();
+		static VkDevice GetDevice();
+		static VkQueue GetQueue();
+		static uint32 GetQueueFamily();
+		static const VkPhysicalDeviceProperties &GetProperties();
+		static const Features &GetFeatures();
+
+		/**
+		 *
+		 * Hands out the ids the resources report as GetRendererID(), Vulkan handles do not fit into 32 bits.
+		 *
+		 * @return Returns a new id, never 0.
+		 */
+		static FakeRendererID CreateRendererID();
+
+		/**
+		 *
+		 * Allocates memory for a buffer or an image. Every resource gets its own allocation, the engine creates few and large ones.
+		 *
+		 * @param requirements The requirements of the resource.
+		 * @param properties The properties the memory must have.
+		 * @return Returns the memory.
+		 */
+		static VkDeviceMemory Allocate(const VkMemoryRequirements &requirements, VkMemoryPropertyFlags properties);
+
+		/**
+		 *
+		 * Creates a buffer with its own memory. Host visible memory is mapped for the lifetime of the buffer.
+		 *
+		 * @param size The size of the buffer in bytes.
+		 * @param usage The usage of the buffer.
+		 * @param properties The properties the memory must have.
+		 * @param outBuffer Receives the buffer.
+		 * @param outMemory Receives the memory.
+		 * @return Returns the mapped memory of host visible buffers, nullptr otherwise.
+		 */
+		static void *CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, VkBuffer &outBuffer, VkDeviceMemory &outMemory);
+
+		/**
+		 *
+		 * Creates an image in device local memory.
+		 *
+		 * @param info The description of the image.
+		 * @param outImage Receives the image.
+		 * @param outMemory Receives the memory.
+		 */
+		static void CreateImage(const VkImageCreateInfo &info, VkImage &outImage, VkDeviceMemory &outMemory);
+
+		/**
+		 *
+		 * Submits command buffers to the queue. The submission signals the timeline semaphore with the next value.
+		 *
+		 * @param count The amount of command buffers.
+		 * @param commandBuffers The primary command buffers.
+		 * @return Returns the value the timeline semaphore reaches once the command buffers have finished.
+		 */
+		static uint64 Submit(uint32 count, const VkCommandBuffer *commandBuffers);
+
+		/**
+		 *
+		 * Records commands into a temporary command buffer, submits it and waits for it.
+		 * For the rare places which have to answer right away, like FakeFramebuffer::ReadPixel().
+		 *
+		 * @param record Records the commands.
+		 */
+		static void ImmediateSubmit(const std::function<void(VkCommandBuffer)> &record);
+
+		/**
+		 *
+		 * Blocks until the timeline semaphore has reached a value.
+		 *
+		 * @param value The value to wait for.
+		 */
+		static void Wait(uint64 value);
+
+		/**
+		 *
+		 * Blocks until everything submitted so far has finished.
+		 *
+		 */
+		static void WaitIdle();
+
+		/**
+		 *
+		 * Returns the value the last submission signals.
+		 *
+		 */
+		static uint64 GetSubmittedValue();
+
+		/**
+		 *
+		 * Returns the value the timeline semaphore has reached, without waiting.
+		 *
+		 */
+		static uint64 GetCompletedValue();
+
+		/**
+		 *
+		 * Destroys an object once the GPU is done with everything recorded so far, including the frame which is being captured.
+		 *
+		 * @param destroy Destroys the object.
+		 */
+		static void DestroyLater(std::function<void()> &&destroy);
+
+		/**
+		 *
+		 * Destroys the objects whose submissions have finished. Called once per frame.
+		 *
+		 */
+		static void CollectGarbage();
+	};
@@ -0,0 +1,328 @@
+#include "FakePch.h"
+#include "FakeVulkanFramebuffer.h"
+
+#ifdef FAKE_RENDERER_VULKAN
+
+#include "Engine/Renderer/FakeRenderer.h"
+#include "FakeVulkanContext.h"
+#include "FakeVulkanReadback.h"
+
+static const uint32 MaxFramebufferSize = 8192;
+
+namespace Utils
+	{
+	static bool fake_is_depth_format(FakeFramebufferTextureFormat format)
+		{
+		switch (format)
+			{
+			case FakeFramebufferTextureFormat::DEPTH32F:         return true;
+			case FakeFramebufferTextureFormat::DEPTH24STENCIL8:  return true;
+			}
+
+		return false;
+		}
+
+	static bool fake_supports_depth_format(VkFormat format)
+		{
+		VkFormatProperties properties;
+		vkGetPhysicalDeviceFormatProperties(FakeVulkanContext::GetPhysicalDevice(), format, &properties);
+		return properties.optimalTilingFeatures & VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT;
+		}
+
+	static VkFormat fake_texture_format_to_vulkan(FakeFramebufferTextureFormat format)
+		{
+		switch (format)
+			{
+			case FakeFramebufferTextureFormat::RGBA8:        return VK_FORMAT_R8G8B8A8_UNORM;
+			case FakeFramebufferTextureFormat::RGBA16F:      return VK_FORMAT_R16G16B16A16_SFLOAT;
+			case FakeFramebufferTextureFormat::RGBA32F:      return VK_FORMAT_R32G32B32A32_SFLOAT;
+			case FakeFramebufferTextureFormat::RG32F:        return VK_FORMAT_R32G32_SFLOAT;
+			case FakeFramebufferTextureFormat::RED_INTEGER:  return VK_FORMAT_R32_SINT;
+			case FakeFramebufferTextureFormat::DEPTH32F:     return VK_FORMAT_D32_SFLOAT;
+
+			// Not every device has a packed depth stencil format, the depth is what the engine needs
+			case FakeFramebufferTextureFormat::DEPTH24STENCIL8:
+				{
+				if (fake_supports_depth_format(VK_FORMAT_D24_UNORM_S8_UINT))
+					return VK_FORMAT_D24_UNORM_S8_UINT;
+				if (fake_supports_depth_format(VK_FORMAT_D32_SFLOAT_S8_UINT))
+					return VK_FORMAT_D32_SFLOAT_S8_UINT;
+
+				return VK_FORMAT_D32_SFLOAT;
+				}
+			}
+
+		FAKE_ASSERT(false);
+		return VK_FORMAT_UNDEFINED;
+		}
+
+	static VkImageAspectFlags fake_depth_aspect(VkFormat format)
+		{
+		if (format == VK_FORMAT_D32_SFLOAT)
+			return VK_IMAGE_ASPECT_DEPTH_BIT;
+
+		return VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
+		}
+	}
+
+void FakeVulkanFramebuffer::Invalidate()
+	{
+	VkDevice device = FakeVulkanContext::GetDevice();
+
+	if (Specification.Samples > 1)
+		{
+		FAKE_LOG_WARN("The Vulkan backend does not support multisampled framebuffers, %d samples are replaced by one!", Specification.Samples);
+		Specification.Samples = 1;
+		}
+
+	Release();
+
+	auto createAttachment = [this, device](Attachment &attachment, VkImageUsageFlags usage, VkImageAspectFlags aspect, VkImageLayout layout)
+		{
+		VkImageCreateInfo imageInfo = {};
+		imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+		imageInfo.imageType = VK_IMAGE_TYPE_2D;
+		imageInfo.format = attachment.Format;
+		imageInfo.extent = { Specification.Width, Specification.Height, 1 };
+		imageInfo.mipLevels = 1;
+		imageInfo.arrayLayers = 1;
+		imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+		imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+		imageInfo.usage = usage | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+		imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		FakeVulkanContext::CreateImage(imageInfo, attachment.Image, attachment.Memory);
+
+		VkImageViewCreateInfo viewInfo = {};
+		viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+		viewInfo.image = attachment.Image;
+		viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+		viewInfo.format = attachment.Format;
+		viewInfo.subresourceRange = { aspect, 0, 1, 0, 1 };
+		FAKE_VK_CHECK_RESULT(vkCreateImageView(device, &viewInfo, nullptr, &attachment.View));
+
+		// The attachments never leave their attachment layouts for long, render passes expect them there
+		VkImage image = attachment.Image;
+		FakeVulkanRendererAPI::Upload([image, aspect, layout](VkCommandBuffer commandBuffer)
+			{
+			FakeVulkanRendererAPI::TransitionImage(commandBuffer, image, aspect, VK_IMAGE_LAYOUT_UNDEFINED, layout);
+			});
+		};
+
+	std::vector<VkFormat> colorFormats;
+	std::vector<VkImageView> views;
+	Target = FakeVulkanRenderTarget();
+
+	ColorAttachments.resize(ColorAttachmentFormats.size());
+	for (uint32 i = 0; i < (uint32)ColorAttachments.size(); ++i)
+		{
+		Attachment &attachment = ColorAttachments[i];
+		attachment.RendererID = FakeVulkanContext::CreateRendererID();
+		attachment.Format = Utils::fake_texture_format_to_vulkan(ColorAttachmentFormats[i]);
+		createAttachment(attachment, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT, VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+
+		colorFormats.push_back(attachment.Format);
+		views.push_back(attachment.View);
+		if (ColorAttachmentFormats[i] == FakeFramebufferTextureFormat::RED_INTEGER)
+			Target.IntegerMask |= 1u << i;
+		}
+
+	VkFormat depthFormat = VK_FORMAT_UNDEFINED;
+	if (DepthAttachmentFormat != FakeFramebufferTextureFormat::None)
+		{
+		DepthAttachment.RendererID = FakeVulkanContext::CreateRendererID();
+		DepthAttachment.Format = Utils::fake_texture_format_to_vulkan(DepthAttachmentFormat);
+		createAttachment(DepthAttachment, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT, Utils::fake_depth_aspect(DepthAttachment.Format), VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL);
+
+		depthFormat = DepthAttachment.Format;
+		views.push_back(DepthAttachment.View);
+		}
+
+	Target.LoadPass = FakeVulkanRendererAPI::GetRenderPass(colorFormats, depthFormat, false);
+	Target.ClearPass = FakeVulkanRendererAPI::GetRenderPass(colorFormats, depthFormat, true);
+	Target.Extent = { Specification.Width, Specification.Height };
+	Target.ColorCount = (uint32)ColorAttachments.size();
+	Target.HasDepth = depthFormat != VK_FORMAT_UNDEFINED;
+
+	// Render passes with the same attachments are compatible, so the framebuffer serves both of them
+	VkFramebufferCreateInfo framebufferInfo = {};
+	framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+	framebufferInfo.renderPass = Target.LoadPass;
+	framebufferInfo.attachmentCount = (uint32)views.size();
+	framebufferInfo.pAttachments = views.data();
+	framebufferInfo.width = Specification.Width;
+	framebufferInfo.height = Specification.Height;
+	framebufferInfo.layers = 1;
+	FAKE_VK_CHECK_RESULT(vkCreateFramebuffer(device, &framebufferInfo, nullptr, &Target.Framebuffer));
+	}
+
+void FakeVulkanFramebuffer::Release()
+	{
+	std::vector<Attachment> attachments = ColorAttachments;
+	if (DepthAttachment.Image)
+		attachments.push_back(DepthAttachment);
+
+	VkFramebuffer framebuffer = Target.Framebuffer;
+	if (!framebuffer && attachments.empty())
+		return;
+
+	FakeVulkanContext::DestroyLater([framebuffer, attachments]()
+		{
+		VkDevice device = FakeVulkanContext::GetDevice();
+		vkDestroyFramebuffer(device, framebuffer, nullptr);
+
+		for (const Attachment &attachment : attachments)
+			{
+			vkDestroyImageView(device, attachment.View, nullptr);
+			vkDestroyImage(device, attachment.Image, nullptr);
+			vkFreeMemory(device, attachment.Memory, nullptr);
+			}
+		});
+
+	ColorAttachments.clear();
+	DepthAttachment = Attachment();
+	Target.Framebuffer = VK_NULL_HANDLE;
+	}
+
+FakeVulkanFramebuffer::FakeVulkanFramebuffer(const FakeFramebufferSpecification &spec)
+	: Specification(spec), RendererID(FakeVulkanContext::CreateRendererID())
+	{
+	for (auto spec : Specification.Attachments.Attachments)
+		{
+		if (!Utils::fake_is_depth_format(spec.Format))
+			ColorAttachmentFormats.emplace_back(spec.Format);
+		else
+			DepthAttachmentFormat = spec.Format;
+		}
+
+	Invalidate();
+	}
+
+FakeVulkanFramebuffer::~FakeVulkanFramebuffer()
+	{
+	FakeVulkanRendererAPI::ForgetRenderTarget(&Target);
+	Release();
+	}
+
+void FakeVulkanFramebuffer::Bind() const
+	{
+	FakeRef<const FakeVulkanFramebuffer> instance = this;
+	FakeRenderer::Submit([instance]() { FakeVulkanRendererAPI::BindRenderTarget(&instance->Target); });
+	}
+
+void FakeVulkanFramebuffer::Unbind() const
+	{
+	FakeRenderer::Submit([]() { FakeVulkanRendererAPI::BindRenderTarget(nullptr); });
+	}
+
+void FakeVulkanFramebuffer::Resize(uint32 width, uint32 height)
+	{
+	if (width == 0 || height == 0 || width > MaxFramebufferSize || height > MaxFramebufferSize)
+		{
+		FAKE_LOG_WARN("Attempted to rezize framebuffer to %d, %d", width, height);
+		return;
+		}
+
+	Specification.Width = width;
+	Specification.Height = height;
+
+	Invalidate();
+	}
+
+int32 FakeVulkanFramebuffer::ReadPixel(uint32 attachmentIndex, int32 x, int32 y)
+	{
+	FAKE_ASSERT(attachmentIndex < ColorAttachments.size());
+
+	// Draws are only recorded by FakeRenderer::Render(), so the pixel is the one of the last submitted frame
+	VkBuffer buffer = VK_NULL_HANDLE;
+	VkDeviceMemory memory = VK_NULL_HANDLE;
+	const int32 *pixel = (const int32*)FakeVulkanContext::CreateBuffer(sizeof(int32), VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+		VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, buffer, memory);
+
+	VkImage image = ColorAttachments[attachmentIndex].Image;
+	FakeVulkanContext::ImmediateSubmit([image, buffer, x, y](VkCommandBuffer commandBuffer)
+		{
+		FakeVulkanRendererAPI::TransitionImage(commandBuffer, image, VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+
+		VkBufferImageCopy region = {};
+		region.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
+		region.imageOffset = { x, y, 0 };
+		region.imageExtent = { 1, 1, 1 };
+		vkCmdCopyImageToBuffer(commandBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, buffer, 1, &region);
+
+		FakeVulkanRendererAPI::TransitionImage(commandBuffer, image, VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+		});
+
+	int32 pixelData = *pixel;
+
+	VkDevice device = FakeVulkanContext::GetDevice();
+	vkDestroyBuffer(device, buffer, nullptr);
+	vkFreeMemory(device, memory, nullptr);
+	return pixelData;
+	}
+
+void FakeVulkanFramebuffer::ReadRegionAsync(uint32 attachmentIndex, int32 x, int32 y, uint32 width, uint32 height, const FakeReadbackCallback &callback)
+	{
+	FAKE_ASSERT(attachmentIndex < ColorAttachments.size());
+
+	if (x < 0 || y < 0 || width == 0 || height == 0 || x + width > Specification.Width || y + height > Specification.Height)
+		{
+		FAKE_LOG_ERROR("Attempted to read region %d, %d, %d, %d outside of the framebuffer!", x, y, width, height);
+		return;
+		}
+
+	// A copy does not convert formats like glReadPixels does, only attachments with 4 bytes per pixel can be read
+	FakeFramebufferTextureFormat format = ColorAttachmentFormats[attachmentIndex];
+	if (format != FakeFramebufferTextureFormat::RGBA8 && format != FakeFramebufferTextureFormat::RED_INTEGER)
+		{
+		FAKE_LOG_ERROR("Only RGBA8 and RED_INTEGER attachments can be read back!");
+		return;
+		}
+
+	// The copy is recorded, so it sees everything drawn into the framebuffer so far
+	FakeRef<FakeVulkanFramebuffer> instance = this;
+	uint32 frameIndex = FakeRenderer::GetFrameIndex();
+	FakeRenderer::Submit([instance, attachmentIndex, x, y, width, height, frameIndex, callback]()
+		{
+		FakeVulkanReadback::Read(instance->ColorAttachments[attachmentIndex].Image, x, y, width, height, frameIndex, callback);
+		});
+	}
+
+void FakeVulkanFramebuffer::ClearColorAttachment(uint32 attachmentIndex, const VkClearColorValue &color)
+	{
+	FAKE_ASSERT(attachmentIndex < ColorAttachments.size());
+
+	FakeRef<FakeVulkanFramebuffer> instance = this;
+	FakeRenderer::Submit([instance, attachmentIndex, color]()
+		{
+		VkImage image = instance->ColorAttachments[attachmentIndex].Image;
+		FakeVulkanRendererAPI::Record([image, color](VkCommandBuffer commandBuffer)
+			{
+			VkImageSubresourceRange range = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+			FakeVulkanRendererAPI::TransitionImage(commandBuffer, image, VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+			vkCmdClearColorImage(commandBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, &color, 1, &range);
+			FakeVulkanRendererAPI::TransitionImage(commandBuffer, image, VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+			});
+		});
+	}
+
+void FakeVulkanFramebuffer::ClearAttachment(uint32 attachmentIndex, int32 value)
+	{
+	VkClearColorValue color = {};
+	color.int32[0] = value;
+	ClearColorAttachment(attachmentIndex, color);
+	}
+
+void FakeVulkanFramebuffer::ClearAttachment(uint32 attachmentIndex, float value)
+	{
+	VkClearColorValue color = {};
+	color.float32[0] = value;
+	ClearColorAttachment(attachmentIndex, color);
+	}
+
+FakeRendererID FakeVulkanFramebuffer::GetColorAttachmentRendererID(int32 index) const
+	{
+	FAKE_ASSERT(index < ColorAttachments.size());
+	return ColorAttachments[index].RendererID;
+	}
+
+#endif
@@ -0,0 +1,84 @@
+/*****************************************************************
+ * \file   FakeVulkanFramebuffer.h
+ * \brief  
+ * 
+ * \author Can Karka
+ * \date   February 2021
+ * 
+ * Copyright (C) 2021 Can Karka
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *********************************************************************/
+
+#pragma once
+
+#include "FakeVulkanRendererAPI.h"
+
+#include "Engine/Renderer/FakeFramebuffer.h"
+
+/**
+ *
+ * The Vulkan implementation of FakeFramebuffer. The attachments stay in their attachment layouts,
+ * copies and clears move them out and back again. Multisampling is not supported, such framebuffers get one sample.
+ *
+ */
+class FakeVulkanFramebuffer : public FakeFramebuffer
+	{
+	private:
+
+		struct Attachment
+			{
+			FakeRendererID RendererID = 0;
+			VkFormat Format = VK_FORMAT_UNDEFINED;
+			VkImage Image = VK_NULL_HANDLE;
+			VkDeviceMemory Memory = VK_NULL_HANDLE;
+			VkImageView View = VK_NULL_HANDLE;
+			};
+
+		FakeFramebufferSpecification Specification;
+		FakeRendererID RendererID = 0;
+		std::vector<FakeFramebufferTextureFormat> ColorAttachmentFormats;
+		FakeFramebufferTextureFormat DepthAttachmentFormat = FakeFramebufferTextureFormat::None;
+
+		std::vector<Attachment> ColorAttachments;
+		Attachment DepthAttachment;
+		FakeVulkanRenderTarget Target;
+
+		void Invalidate();
+		void Release();
+		void ClearColorAttachment(uint32 attachmentIndex, const VkClearColorValue &color);
+
+	public:
+
+		FakeVulkanFramebuffer(const FakeFramebufferSpecification &spec);
+		virtual ~FakeVulkanFramebuffer();
+
+		virtual void Bind() const override;
+		virtual void Unbind() const override;
+		virtual void Resize(uint32 width, uint32 height) override;
+
+		virtual uint32 GetWidth() const override { return Specification.Width; }
+		virtual uint32 GetHeight() const override { return Specification.Height; }
+
+		virtual int32 ReadPixel(uint32 attachmentIndex, int32 x, int32 y) override;
+		virtual void ReadRegionAsync(uint32 attachmentIndex, int32 x, int32 y, uint32 width, uint32 height, const FakeReadbackCallback &callback) override;
+		virtual void ClearAttachment(uint32 attachmentIndex, int32 value) override;
+		virtual void ClearAttachment(uint32 attachmentIndex, float value) override;
+
+		virtual FakeRendererID GetRendererID() const override { return RendererID; }
+		virtual FakeRendererID GetColorAttachmentRendererID(int32 index = 0) const override;
+		virtual FakeRendererID GetDepthAttachmentRendererID() const override { return DepthAttachment.RendererID; }
+		virtual const FakeFramebufferSpecification &GetSpecification() const override { return Specification; }
+
+		const FakeVulkanRenderTarget &GetTarget() const { return Target; }
+	};
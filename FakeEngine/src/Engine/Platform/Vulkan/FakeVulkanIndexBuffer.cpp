@@ -0,0 +1,63 @@
+#include "FakePch.h"
+#include "FakeVulkanIndexBuffer.h"
+
+#ifdef FAKE_RENDERER_VULKAN
+
+#include "Engine/Renderer/FakeRenderer.h"
+#include "FakeVulkanContext.h"
+#include "FakeVulkanRendererAPI.h"
+
+static const VkBufferUsageFlags IndexBufferUsage = VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+
+FakeVulkanIndexBuffer::FakeVulkanIndexBuffer(void *data, uint32 size, FakeIndexFormat format)
+	: Size(size), Capacity(size), Format(format)
+	{
+	RendererID = FakeVulkanContext::CreateRendererID();
+	FakeVulkanContext::CreateBuffer(Capacity, IndexBufferUsage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, Buffer, Memory);
+	FakeVulkanRendererAPI::WriteBuffer(Buffer, 0, data, size, true);
+	}
+
+FakeVulkanIndexBuffer::FakeVulkanIndexBuffer(uint32 size, FakeIndexFormat format)
+	: Size(size), Capacity(size), Format(format)
+	{
+	RendererID = FakeVulkanContext::CreateRendererID();
+	FakeVulkanContext::CreateBuffer(Capacity, IndexBufferUsage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, Buffer, Memory);
+	}
+
+FakeVulkanIndexBuffer::~FakeVulkanIndexBuffer()
+	{
+	VkBuffer buffer = Buffer;
+	VkDeviceMemory memory = Memory;
+	FakeVulkanContext::DestroyLater([buffer, memory]()
+		{
+		vkDestroyBuffer(FakeVulkanContext::GetDevice(), buffer, nullptr);
+		vkFreeMemory(FakeVulkanContext::GetDevice(), memory, nullptr);
+		});
+	}
+
+void FakeVulkanIndexBuffer::SetData(void *data, uint32 size, uint32 offset)
+	{
+	FAKE_ASSERT(offset + size <= Capacity, "Index data does not fit into the buffer!");
+	Size = size;
+
+	std::vector<Byte> copy((const Byte*)data, (const Byte*)data + size);
+
+	FakeRef<FakeVulkanIndexBuffer> instance = this;
+	FakeRenderer::Submit([instance, copy = std::move(copy), offset]()
+		{
+		FakeVulkanRendererAPI::WriteBuffer(instance->Buffer, offset, copy.data(), (uint32)copy.size(), false);
+		});
+	}
+
+void FakeVulkanIndexBuffer::Bind() const
+	{
+	FakeRef<const FakeVulkanIndexBuffer> instance = this;
+	FakeRenderer::Submit([instance]() { FakeVulkanRendererAPI::BindIndexBuffer(instance->Buffer); });
+	}
+
+void FakeVulkanIndexBuffer::Unbind() const
+	{
+	FakeRenderer::Submit([]() { FakeVulkanRendererAPI::BindIndexBuffer(VK_NULL_HANDLE); });
+	}
+
+#endif
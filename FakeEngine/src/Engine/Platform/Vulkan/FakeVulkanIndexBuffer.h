@@ -0,0 +1,61 @@
+/*****************************************************************
+ * \file   FakeVulkanIndexBuffer.h
+ * \brief  
+ * 
+ * \author Can Karka
+ * \date   February 2021
+ * 
+ * Copyright (C) 2021 Can Karka
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *********************************************************************/
+
+#pragma once
+
+#include "FakeVulkan.h"
+
+#include "Engine/Renderer/FakeIndexBuffer.h"
+
+/**
+ *
+ * The Vulkan implementation of FakeIndexBuffer, the indices live in device local memory.
+ *
+ */
+class FakeVulkanIndexBuffer : public FakeIndexBuffer
+	{
+	private:
+
+		FakeRendererID RendererID = 0;
+		uint32 Size;
+		uint32 Capacity;
+		FakeIndexFormat Format;
+		VkBuffer Buffer = VK_NULL_HANDLE;
+		VkDeviceMemory Memory = VK_NULL_HANDLE;
+
+	public:
+
+		FakeVulkanIndexBuffer(void *data, uint32 size, FakeIndexFormat format = FakeIndexFormat::UInt32);
+		FakeVulkanIndexBuffer(uint32 size, FakeIndexFormat format = FakeIndexFormat::UInt32);
+		virtual ~FakeVulkanIndexBuffer();
+
+		virtual void SetData(void *data, uint32 size, uint32 offset = 0) override;
+		virtual void Bind() const override;
+		virtual void Unbind() const override;
+
+		virtual uint32 GetCount() const override { return Size / (Format == FakeIndexFormat::UInt16 ? sizeof(uint16) : sizeof(uint32)); }
+		virtual uint32 GetSize() const override { return Size; }
+		virtual FakeIndexFormat GetFormat() const override { return Format; }
+		virtual FakeRendererID GetRendererID() const override { return RendererID; }
+
+		VkBuffer GetBuffer() const { return Buffer; }
+	};
@@ -0,0 +1,113 @@
+#include "FakePch.h"
+#include "FakeVulkanPipeline.h"
+
+#ifdef FAKE_RENDERER_VULKAN
+
+#include "Engine/Renderer/FakeRenderer.h"
+#include "FakeVulkanContext.h"
+#include "FakeVulkanRendererAPI.h"
+#include "FakeVulkanVertexBuffer.h"
+
+namespace Utils
+	{
+	static VkFormat fake_shader_data_type_to_vulkan_format(FakeShaderDataType type, bool normalized)
+		{
+		switch (type)
+			{
+			case FakeShaderDataType::Float:    return VK_FORMAT_R32_SFLOAT;
+			case FakeShaderDataType::Float2:   return VK_FORMAT_R32G32_SFLOAT;
+			case FakeShaderDataType::Float3:   return VK_FORMAT_R32G32B32_SFLOAT;
+			case FakeShaderDataType::Float4:   return VK_FORMAT_R32G32B32A32_SFLOAT;
+			case FakeShaderDataType::Mat2:     return VK_FORMAT_R32G32B32A32_SFLOAT;
+			case FakeShaderDataType::Mat3:     return VK_FORMAT_R32G32B32_SFLOAT;
+			case FakeShaderDataType::Mat4:     return VK_FORMAT_R32G32B32A32_SFLOAT;
+			case FakeShaderDataType::Int:      return VK_FORMAT_R32_SINT;
+			case FakeShaderDataType::Int2:     return VK_FORMAT_R32G32_SINT;
+			case FakeShaderDataType::Int3:     return VK_FORMAT_R32G32B32_SINT;
+			case FakeShaderDataType::Int4:     return VK_FORMAT_R32G32B32A32_SINT;
+			case FakeShaderDataType::Bool:     return VK_FORMAT_R8_UINT;
+			case FakeShaderDataType::Short2:   return normalized ? VK_FORMAT_R16G16_SNORM : VK_FORMAT_R16G16_SSCALED;
+			case FakeShaderDataType::Short4:   return normalized ? VK_FORMAT_R16G16B16A16_SNORM : VK_FORMAT_R16G16B16A16_SSCALED;
+			case FakeShaderDataType::Half2:    return VK_FORMAT_R16G16_SFLOAT;
+			case FakeShaderDataType::Half4:    return VK_FORMAT_R16G16B16A16_SFLOAT;
+			}
+
+		FAKE_ASSERT(false);
+		return VK_FORMAT_UNDEFINED;
+		}
+
+	// Same locations as the attribute indices of the OpenGL backend, matrices take one location per column
+	static uint32 fake_add_vertex_attributes(std::vector<VkVertexInputAttributeDescription> &attributes, const FakeVertexBufferLayout &layout, uint32 location, uint32 binding)
+		{
+		for (const auto &element : layout)
+			{
+			uint32 columns = 1;
+			if (element.Type == FakeShaderDataType::Mat3)
+				columns = 3;
+			else if (element.Type == FakeShaderDataType::Mat4)
+				columns = 4;
+
+			VkFormat format = fake_shader_data_type_to_vulkan_format(element.Type, element.Normalized);
+			uint32 columnSize = element.Size / columns;
+			for (uint32 column = 0; column < columns; ++column)
+				attributes.push_back({ location++, binding, format, element.Offset + column * columnSize });
+			}
+
+		return location;
+		}
+	}
+
+FakeVulkanPipeline::FakeVulkanPipeline(const FakePipelineSpecification &spec)
+	: RendererID(FakeVulkanContext::CreateRendererID()), Specification(spec)
+	{
+	Invalidate();
+	}
+
+FakeVulkanPipeline::~FakeVulkanPipeline()
+	{
+	FakeRendererID rendererID = RendererID;
+	FakeRenderer::Submit([rendererID]() { FakeVulkanRendererAPI::ForgetPipelines(rendererID); });
+	}
+
+void FakeVulkanPipeline::Bind() const
+	{
+	FakeRef<const FakeVulkanPipeline> instance = this;
+	FakeRenderer::Submit([instance]() { FakeVulkanRendererAPI::BindPipeline(instance.Raw()); });
+	}
+
+void FakeVulkanPipeline::Unbind() const
+	{
+	FakeRenderer::Submit([]() { FakeVulkanRendererAPI::BindPipeline(nullptr); });
+	}
+
+void FakeVulkanPipeline::Invalidate()
+	{
+	FAKE_ASSERT(Specification.Layout.GetElements().size());
+
+	Bindings.clear();
+	Attributes.clear();
+
+	// Binding 0 is whatever vertex buffer is bound when the pipeline is bound, binding 1 the instance buffer
+	Bindings.push_back({ 0, Specification.Layout.GetStride(), VK_VERTEX_INPUT_RATE_VERTEX });
+	uint32 location = Utils::fake_add_vertex_attributes(Attributes, Specification.Layout, 0, 0);
+
+	if (Specification.InstanceBuffer)
+		{
+		Bindings.push_back({ 1, Specification.InstanceLayout.GetStride(), VK_VERTEX_INPUT_RATE_INSTANCE });
+		Utils::fake_add_vertex_attributes(Attributes, Specification.InstanceLayout, location, 1);
+		}
+
+	// The graphics pipelines built from the old description are rebuilt on the next draw
+	FakeRendererID rendererID = RendererID;
+	FakeRenderer::Submit([rendererID]() { FakeVulkanRendererAPI::ForgetPipelines(rendererID); });
+	}
+
+VkBuffer FakeVulkanPipeline::GetInstanceBuffer() const
+	{
+	if (!Specification.InstanceBuffer)
+		return VK_NULL_HANDLE;
+
+	return ((const FakeVulkanVertexBuffer*)Specification.InstanceBuffer.Raw())->GetBuffer();
+	}
+
+#endif
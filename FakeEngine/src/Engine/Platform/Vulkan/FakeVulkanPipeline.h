@@ -0,0 +1,67 @@
+/*****************************************************************
+ * \file   FakeVulkanPipeline.h
+ * \brief  
+ * 
+ * \author Can Karka
+ * \date   February 2021
+ * 
+ * Copyright (C) 2021 Can Karka
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *********************************************************************/
+
+#pragma once
+
+#include "FakeVulkan.h"
+
+#include "Engine/Renderer/FakePipeline.h"
+
+/**
+ *
+ * The Vulkan implementation of FakePipeline. It only describes the vertex input, the graphics pipelines are built
+ * by the backend for every combination of shader, render pass and draw state it meets.
+ *
+ */
+class FakeVulkanPipeline : public FakePipeline
+	{
+	private:
+
+		FakeRendererID RendererID = 0;
+		FakePipelineSpecification Specification;
+		std::vector<VkVertexInputBindingDescription> Bindings;
+		std::vector<VkVertexInputAttributeDescription> Attributes;
+
+	public:
+
+		FakeVulkanPipeline(const FakePipelineSpecification &spec);
+		virtual ~FakeVulkanPipeline();
+
+		virtual void Bind() const override;
+		virtual void Unbind() const override;
+
+		virtual FakeRendererID GetRendererID() const override { return RendererID; }
+		virtual FakePipelineSpecification &GetSpecification() override { return Specification; }
+		virtual const FakePipelineSpecification &GetSpecification() const override { return Specification; }
+		virtual void Invalidate() override;
+
+		const std::vector<VkVertexInputBindingDescription> &GetBindings() const { return Bindings; }
+		const std::vector<VkVertexInputAttributeDescription> &GetAttributes() const { return Attributes; }
+
+		/**
+		 *
+		 * Returns the buffer of the per-instance attributes.
+		 *
+		 * @return Returns the buffer, VK_NULL_HANDLE if the pipeline has no per-instance attributes.
+		 */
+		VkBuffer GetInstanceBuffer() const;
+	};
@@ -0,0 +1,149 @@
+#include "FakePch.h"
+#include "FakeVulkanReadback.h"
+
+#ifdef FAKE_RENDERER_VULKAN
+
+#include "FakeVulkanContext.h"
+#include "FakeVulkanRendererAPI.h"
+
+// Enough for a capture of every frame while the GPU is a few frames behind
+static const uint32 MaxPendingReadbacks = 8;
+
+struct FakeVulkanPixelBuffer
+	{
+	VkBuffer Buffer = VK_NULL_HANDLE;
+	VkDeviceMemory Memory = VK_NULL_HANDLE;
+	const Byte *Mapped = nullptr;
+	uint32 Capacity = 0;
+	};
+
+struct FakeVulkanPendingReadback
+	{
+	FakeVulkanPixelBuffer Buffer;
+	uint64 Value = 0;
+	FakeFramebufferReadback Readback;
+	FakeReadbackCallback Callback;
+	};
+
+struct FakeVulkanReadbackData
+	{
+	std::vector<FakeVulkanPendingReadback> Pending;
+	std::vector<FakeVulkanPixelBuffer> FreeBuffers;
+	};
+
+static FakeVulkanReadbackData Data;
+
+namespace Utils
+	{
+	static FakeVulkanPixelBuffer fake_acquire_pixel_buffer(uint32 size)
+		{
+		// The smallest free buffer which fits, so picking does not take the buffers of a capture
+		size_t best = Data.FreeBuffers.size();
+		for (size_t i = 0; i < Data.FreeBuffers.size(); ++i)
+			{
+			if (Data.FreeBuffers[i].Capacity >= size && (best == Data.FreeBuffers.size() || Data.FreeBuffers[i].Capacity < Data.FreeBuffers[best].Capacity))
+				best = i;
+			}
+
+		if (best < Data.FreeBuffers.size())
+			{
+			FakeVulkanPixelBuffer buffer = Data.FreeBuffers[best];
+			Data.FreeBuffers.erase(Data.FreeBuffers.begin() + best);
+			return buffer;
+			}
+
+		FakeVulkanPixelBuffer buffer;
+		buffer.Capacity = size;
+		buffer.Mapped = (const Byte*)FakeVulkanContext::CreateBuffer(size, VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, buffer.Buffer, buffer.Memory);
+		return buffer;
+		}
+
+	static bool fake_is_finished(const FakeVulkanPendingReadback &readback, bool wait)
+		{
+		// Recorded into the frame which is being captured, nothing can be waited for yet
+		if (!readback.Value)
+			return false;
+
+		if (wait)
+			FakeVulkanContext::Wait(readback.Value);
+
+		return FakeVulkanContext::GetCompletedValue() >= readback.Value;
+		}
+
+	static void fake_finish_readback(FakeVulkanPendingReadback &readback)
+		{
+		readback.Readback.Pixels = readback.Buffer.Mapped;
+		readback.Callback(readback.Readback);
+		Data.FreeBuffers.push_back(readback.Buffer);
+		}
+	}
+
+void FakeVulkanReadback::Read(VkImage image, int32 x, int32 y, uint32 width, uint32 height, uint32 frameIndex, const FakeReadbackCallback &callback)
+	{
+	if (Data.Pending.size() >= MaxPendingReadbacks && Data.Pending.front().Value)
+		{
+		Utils::fake_is_finished(Data.Pending.front(), true);
+		Utils::fake_finish_readback(Data.Pending.front());
+		Data.Pending.erase(Data.Pending.begin());
+		}
+
+	FakeVulkanPendingReadback readback;
+	readback.Buffer = Utils::fake_acquire_pixel_buffer(width * height * 4);
+	readback.Readback.Width = width;
+	readback.Readback.Height = height;
+	readback.Readback.FrameIndex = frameIndex;
+	readback.Callback = callback;
+
+	// The rows of the image are stored bottom up like on OpenGL, so the copy already has the order of FakeFramebufferReadback
+	VkBuffer buffer = readback.Buffer.Buffer;
+	FakeVulkanRendererAPI::Record([image, buffer, x, y, width, height](VkCommandBuffer commandBuffer)
+		{
+		FakeVulkanRendererAPI::TransitionImage(commandBuffer, image, VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+
+		VkBufferImageCopy region = {};
+		region.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
+		region.imageOffset = { x, y, 0 };
+		region.imageExtent = { width, height, 1 };
+		vkCmdCopyImageToBuffer(commandBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, buffer, 1, &region);
+
+		FakeVulkanRendererAPI::TransitionImage(commandBuffer, image, VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+		});
+
+	Data.Pending.push_back(std::move(readback));
+	}
+
+void FakeVulkanReadback::Submitted(uint64 value)
+	{
+	for (FakeVulkanPendingReadback &readback : Data.Pending)
+		{
+		if (!readback.Value)
+			readback.Value = value;
+		}
+	}
+
+void FakeVulkanReadback::Resolve(bool wait)
+	{
+	// The frames finish in order, once one has not, the later ones have not either
+	while (!Data.Pending.empty() && Utils::fake_is_finished(Data.Pending.front(), wait))
+		{
+		Utils::fake_finish_readback(Data.Pending.front());
+		Data.Pending.erase(Data.Pending.begin());
+		}
+	}
+
+void FakeVulkanReadback::Shutdown()
+	{
+	Resolve(true);
+
+	VkDevice device = FakeVulkanContext::GetDevice();
+	for (const FakeVulkanPixelBuffer &buffer : Data.FreeBuffers)
+		{
+		vkDestroyBuffer(device, buffer.Buffer, nullptr);
+		vkFreeMemory(device, buffer.Memory, nullptr);
+		}
+
+	Data.FreeBuffers.clear();
+	}
+
+#endif
@@ -0,0 +1,80 @@
+/*****************************************************************
+ * \file   FakeVulkanReadback.h
+ * \brief  
+ * 
+ * \author Can Karka
+ * \date   February 2021
+ * 
+ * Copyright (C) 2021 Can Karka
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *********************************************************************/
+
+#pragma once
+
+#include "FakeVulkan.h"
+
+#include "Engine/Renderer/FakeFramebuffer.h"
+
+/**
+ *
+ * Copies framebuffer attachments into host visible buffers and hands the pixels to a callback once the timeline semaphore
+ * says the frame with the copy has finished, so reading back never waits for the GPU to catch up with the frame.
+ *
+ * The buffers are pooled and reused. Readbacks resolve in the order they were issued.
+ *
+ * @attention All functions must be called on the render thread.
+ *
+ */
+class FakeVulkanReadback
+	{
+	public:
+
+		/**
+		 *
+		 * Records a copy of a region of a color attachment into the frame which is being captured.
+		 * If MaxPendingReadbacks of earlier frames are still in flight, the oldest one is waited for first instead of being dropped.
+		 *
+		 * @param image The attachment, it has to be in VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL and take 4 bytes per pixel.
+		 * @param x The left edge of the region.
+		 * @param y The bottom edge of the region.
+		 * @param width The width of the region.
+		 * @param height The height of the region.
+		 * @param frameIndex The frame which requested the readback.
+		 * @param callback Receives the pixels.
+		 */
+		static void Read(VkImage image, int32 x, int32 y, uint32 width, uint32 height, uint32 frameIndex, const FakeReadbackCallback &callback);
+
+		/**
+		 *
+		 * Tells the readbacks recorded since the last call which timeline value their frame signals. Called by SubmitFrame().
+		 *
+		 * @param value The value of the submitted frame.
+		 */
+		static void Submitted(uint64 value);
+
+		/**
+		 *
+		 * Calls the callbacks of the finished readbacks.
+		 *
+		 * @param wait Whether to wait for all submitted readbacks to finish.
+		 */
+		static void Resolve(bool wait);
+
+		/**
+		 *
+		 * Finishes all submitted readbacks and destroys the buffers.
+		 *
+		 */
+		static void Shutdown();
+	};
@@ -0,0 +1,1475 @@
+#include "FakePch.h"
+#include "FakeVulkanRendererAPI.h"
+
+#ifdef FAKE_RENDERER_VULKAN
+
+#include "FakeVulkanContext.h"
+#include "FakeVulkanFramebuffer.h"
+#include "FakeVulkanPipeline.h"
+#include "FakeVulkanReadback.h"
+#include "FakeVulkanShader.h"
+#include "FakeVulkanShaderCompiler.h"
+#include "FakeVulkanTexture2D.h"
+
+#include "Engine/Core/Jobs/FakeJobSystem.h"
+
+// Passes are cut into chunks of this many draws, every chunk is recorded into its own secondary command buffer
+static const uint32 DrawsPerChunk = 256;
+
+// The staging and uniform memory of a frame grows by chunks of this size
+static const uint32 RingChunkSize = 4 * 1024 * 1024;
+
+// Every descriptor pool of a frame holds this many sets, a frame which needs more gets another pool
+static const uint32 DescriptorPoolSetCount = 1024;
+
+static const uint32 IndirectCommandStride = sizeof(FakeDrawIndexedIndirectCommand);
+
+enum class FakeVulkanDrawType : uint8
+	{
+	Indexed = 0,
+	Indirect,
+	ClearAttachments
+	};
+
+// Everything a draw needs, resolved while it is captured so the recording threads only read plain handles
+struct FakeVulkanDraw
+	{
+	FakeVulkanDrawType Type = FakeVulkanDrawType::Indexed;
+	VkPipeline Pipeline = VK_NULL_HANDLE;
+	VkPipelineLayout Layout = VK_NULL_HANDLE;
+	VkDescriptorSet Sets[2] = {};
+	uint32 SetCount = 0;
+	uint32 DynamicOffset = 0;
+	bool HasDynamicOffset = false;
+	bool PushBaseInstance = false;
+
+	VkBuffer VertexBuffers[2] = {};
+	VkBuffer IndexBuffer = VK_NULL_HANDLE;
+	VkIndexType IndexType = VK_INDEX_TYPE_UINT32;
+	VkBuffer IndirectBuffer = VK_NULL_HANDLE;
+	VkViewport Viewport = {};
+	float LineWidth = 1.0f;
+
+	uint32 Count = 0;
+	uint32 InstanceCount = 1;
+	uint32 FirstIndex = 0;
+	int32 VertexOffset = 0;
+	uint32 FirstInstance = 0;
+
+	uint32 CommandOffset = 0;
+	uint32 CountOffset = 0;
+	uint32 MaxDrawCount = 0;
+
+	VkClearColorValue ClearColor = {};
+	};
+
+struct FakeVulkanPass
+	{
+	FakeVulkanRenderTarget Target;
+	bool Clear = false;
+	VkClearColorValue ClearColor = {};
+	uint32 FirstDraw = 0;
+	uint32 DrawCount = 0;
+	};
+
+enum class FakeVulkanSegmentType : uint8
+	{
+	Pass = 0,
+	Commands
+	};
+
+// The captured frame is a list of passes and runs of commands, in the order the render command queue executed them
+struct FakeVulkanSegment
+	{
+	FakeVulkanSegmentType Type = FakeVulkanSegmentType::Pass;
+	uint32 First = 0;
+	uint32 Count = 0;
+	};
+
+struct FakeVulkanChunk
+	{
+	uint32 Pass = 0;
+	uint32 FirstDraw = 0;
+	uint32 DrawCount = 0;
+	uint32 ThreadIndex = 0;
+	uint32 StateChanges = 0;
+	uint32 SkippedStateChanges = 0;
+	};
+
+struct FakeVulkanCommandPool
+	{
+	VkCommandPool Pool = VK_NULL_HANDLE;
+	VkCommandBuffer CommandBuffer = VK_NULL_HANDLE;
+	};
+
+struct FakeVulkanRingChunk
+	{
+	VkBuffer Buffer = VK_NULL_HANDLE;
+	VkDeviceMemory Memory = VK_NULL_HANDLE;
+	Byte *Mapped = nullptr;
+	uint32 Size = 0;
+	};
+
+// Linear memory which is handed out during a frame and taken back as a whole once the frame has finished
+struct FakeVulkanRing
+	{
+	std::vector<FakeVulkanRingChunk> Chunks;
+	uint32 Current = 0;
+	uint32 Head = 0;
+	};
+
+struct FakeVulkanDescriptorSets
+	{
+	VkDescriptorSet Sets[2] = {};
+	};
+
+struct FakeVulkanFrameSlot
+	{
+	uint64 Value = 0;
+	FakeVulkanCommandPool Primary;
+	std::vector<FakeVulkanCommandPool> Secondary;
+	std::vector<VkDescriptorPool> DescriptorPools;
+	uint32 DescriptorPool = 0;
+	std::unordered_map<std::string, FakeVulkanDescriptorSets> DescriptorCache;
+	FakeVulkanRing Uniforms;
+	FakeVulkanRing Staging;
+	};
+
+struct FakeVulkanShaderSets
+	{
+	FakeRendererID Shader = 0;
+	uint64 Version = 0;
+	VkBuffer UniformBuffer = VK_NULL_HANDLE;
+	FakeVulkanDescriptorSets Sets;
+	};
+
+struct FakeVulkanPipelineKey
+	{
+	FakeRendererID Shader = 0;
+	FakeRendererID Pipeline = 0;
+	VkRenderPass RenderPass = VK_NULL_HANDLE;
+	VkPrimitiveTopology Topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+	bool DepthTest = false;
+	bool Blend = false;
+
+	bool operator==(const FakeVulkanPipelineKey &other) const
+		{
+		return Shader == other.Shader && Pipeline == other.Pipeline && RenderPass == other.RenderPass
+			&& Topology == other.Topology && DepthTest == other.DepthTest && Blend == other.Blend;
+		}
+	};
+
+struct FakeVulkanPipelineKeyHash
+	{
+	size_t operator()(const FakeVulkanPipelineKey &key) const
+		{
+		size_t hash = std::hash<uint64>()(((uint64)key.Shader << 32) | key.Pipeline);
+		hash ^= std::hash<const void*>()((const void*)key.RenderPass) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+		return hash ^ ((size_t)key.Topology << 2 | (size_t)key.DepthTest << 1 | (size_t)key.Blend);
+		}
+	};
+
+struct FakeVulkanTextureBinding
+	{
+	VkImageView View = VK_NULL_HANDLE;
+	VkSampler Sampler = VK_NULL_HANDLE;
+	};
+
+// What the engine has bound, like the state of an OpenGL context
+struct FakeVulkanBoundState
+	{
+	FakeVulkanShader *Shader = nullptr;
+	const FakeVulkanPipeline *Pipeline = nullptr;
+	VkBuffer PipelineVertexBuffer = VK_NULL_HANDLE;
+	VkBuffer VertexBuffer = VK_NULL_HANDLE;
+	VkBuffer IndexBuffer = VK_NULL_HANDLE;
+	VkBuffer IndirectBuffer = VK_NULL_HANDLE;
+	std::array<FakeVulkanTextureBinding, FakeVulkanRendererAPI::MaxTextureUnits> Textures = {};
+	std::array<VkBuffer, FakeVulkanRendererAPI::MaxStorageBindings> StorageBuffers = {};
+	const FakeVulkanRenderTarget *Target = nullptr;
+	FakeVec4f ClearColor = { 0.0f, 0.0f, 0.0f, 1.0f };
+	VkViewport Viewport = {};
+	float LineWidth = 1.0f;
+	bool Blend = true;
+	};
+
+struct FakeVulkanRendererData
+	{
+	bool Initialized = false;
+
+	std::array<FakeVulkanFrameSlot, FakeVulkanRendererAPI::FramesInFlight> Slots;
+	uint32 SlotIndex = 0;
+
+	VkPipelineCache PipelineCache = VK_NULL_HANDLE;
+	std::unordered_map<FakeVulkanPipelineKey, VkPipeline, FakeVulkanPipelineKeyHash> Pipelines;
+	std::map<std::vector<int32>, VkRenderPass> RenderPasses;
+
+	FakeRef<FakeVulkanFramebuffer> DefaultFramebuffer;
+	FakeRef<FakeVulkanTexture2D> WhiteTexture;
+	VkBuffer EmptyStorageBuffer = VK_NULL_HANDLE;
+	VkDeviceMemory EmptyStorageMemory = VK_NULL_HANDLE;
+
+	// The captured frame
+	std::vector<std::function<void(VkCommandBuffer)>> Uploads;
+	std::vector<std::function<void(VkCommandBuffer)>> Commands;
+	std::vector<FakeVulkanPass> Passes;
+	std::vector<FakeVulkanDraw> Draws;
+	std::vector<FakeVulkanSegment> Segments;
+	std::vector<FakeVulkanChunk> Chunks;
+	int32 OpenPass = -1;
+
+	FakeVulkanBoundState State;
+
+	// Changes whenever a texture or storage binding changes, so unchanged draws skip building their descriptor sets
+	uint64 BindingsVersion = 1;
+	std::unordered_map<const FakeVulkanShader*, FakeVulkanShaderSets> ShaderSets;
+	std::string DescriptorKey;
+
+	FakeRenderAPIStatistics Stats;
+	FakeVulkanRendererAPI::Statistics FrameStats;
+	};
+
+static FakeVulkanRendererData Data;
+
+namespace Utils
+	{
+	static VkPrimitiveTopology fake_vulkan_topology(FakePrimitiveType type)
+		{
+		switch (type)
+			{
+			case FakePrimitiveType::Triangles:  return VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+			case FakePrimitiveType::Lines:      return VK_PRIMITIVE_TOPOLOGY_LINE_LIST;
+			}
+
+		FAKE_ASSERT(false);
+		return VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+		}
+
+	static VkIndexType fake_vulkan_index_type(FakeIndexFormat format)
+		{
+		return format == FakeIndexFormat::UInt16 ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
+		}
+
+	static uint32 fake_align(uint32 value, uint32 alignment)
+		{
+		return (value + alignment - 1) / alignment * alignment;
+		}
+
+	static void *fake_ring_allocate(FakeVulkanRing &ring, VkBufferUsageFlags usage, uint32 alignment, uint32 size, VkBuffer &outBuffer, uint32 &outOffset)
+		{
+		for (; ring.Current < ring.Chunks.size(); ++ring.Current, ring.Head = 0)
+			{
+			const FakeVulkanRingChunk &chunk = ring.Chunks[ring.Current];
+			uint32 offset = fake_align(ring.Head, alignment);
+			if (offset + size <= chunk.Size)
+				{
+				ring.Head = offset + size;
+				outBuffer = chunk.Buffer;
+				outOffset = offset;
+				return chunk.Mapped + offset;
+				}
+			}
+
+		FakeVulkanRingChunk chunk;
+		chunk.Size = std::max(size, RingChunkSize);
+		chunk.Mapped = (Byte*)FakeVulkanContext::CreateBuffer(chunk.Size, usage, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, chunk.Buffer, chunk.Memory);
+
+		ring.Chunks.push_back(chunk);
+		ring.Current = (uint32)ring.Chunks.size() - 1;
+		ring.Head = size;
+
+		outBuffer = chunk.Buffer;
+		outOffset = 0;
+		return chunk.Mapped;
+		}
+
+	static void fake_ring_destroy(FakeVulkanRing &ring)
+		{
+		VkDevice device = FakeVulkanContext::GetDevice();
+		for (const FakeVulkanRingChunk &chunk : ring.Chunks)
+			{
+			vkDestroyBuffer(device, chunk.Buffer, nullptr);
+			vkFreeMemory(device, chunk.Memory, nullptr);
+			}
+
+		ring = FakeVulkanRing();
+		}
+
+	static FakeVulkanCommandPool fake_create_command_pool(VkCommandBufferLevel level)
+		{
+		VkDevice device = FakeVulkanContext::GetDevice();
+
+		FakeVulkanCommandPool result;
+		VkCommandPoolCreateInfo poolInfo = {};
+		poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+		poolInfo.queueFamilyIndex = FakeVulkanContext::GetQueueFamily();
+		FAKE_VK_CHECK_RESULT(vkCreateCommandPool(device, &poolInfo, nullptr, &result.Pool));
+
+		VkCommandBufferAllocateInfo allocateInfo = {};
+		allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+		allocateInfo.commandPool = result.Pool;
+		allocateInfo.level = level;
+		allocateInfo.commandBufferCount = 1;
+		FAKE_VK_CHECK_RESULT(vkAllocateCommandBuffers(device, &allocateInfo, &result.CommandBuffer));
+		return result;
+		}
+
+	static VkDescriptorPool fake_create_descriptor_pool()
+		{
+		VkDescriptorPoolSize sizes[] =
+			{
+			{ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, DescriptorPoolSetCount },
+			{ VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, DescriptorPoolSetCount * FakeVulkanRendererAPI::MaxTextureUnits },
+			{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, DescriptorPoolSetCount * 4 }
+			};
+
+		VkDescriptorPoolCreateInfo info = {};
+		info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+		info.maxSets = DescriptorPoolSetCount;
+		info.poolSizeCount = (uint32)std::size(sizes);
+		info.pPoolSizes = sizes;
+
+		VkDescriptorPool pool = VK_NULL_HANDLE;
+		FAKE_VK_CHECK_RESULT(vkCreateDescriptorPool(FakeVulkanContext::GetDevice(), &info, nullptr, &pool));
+		return pool;
+		}
+
+	static VkDescriptorSet fake_allocate_descriptor_set(VkDescriptorSetLayout layout)
+		{
+		FakeVulkanFrameSlot &slot = Data.Slots[Data.SlotIndex];
+
+		VkDescriptorSetAllocateInfo info = {};
+		info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+		info.descriptorSetCount = 1;
+		info.pSetLayouts = &layout;
+
+		for (;; ++slot.DescriptorPool)
+			{
+			if (slot.DescriptorPool == slot.DescriptorPools.size())
+				slot.DescriptorPools.push_back(fake_create_descriptor_pool());
+
+			info.descriptorPool = slot.DescriptorPools[slot.DescriptorPool];
+
+			VkDescriptorSet set = VK_NULL_HANDLE;
+			VkResult result = vkAllocateDescriptorSets(FakeVulkanContext::GetDevice(), &info, &set);
+			if (result == VK_SUCCESS)
+				return set;
+
+			// A full pool is left behind, the next one is tried
+			if (result != VK_ERROR_OUT_OF_POOL_MEMORY && result != VK_ERROR_FRAGMENTED_POOL)
+				{
+				FAKE_VK_CHECK_RESULT(result);
+				return VK_NULL_HANDLE;
+				}
+			}
+		}
+
+	template<typename T>
+	static void fake_append_key(std::string &key, const T &value)
+		{
+		key.append((const char*)&value, sizeof(T));
+		}
+
+	static VkBuffer fake_empty_storage_buffer()
+		{
+		if (!Data.EmptyStorageBuffer)
+			FakeVulkanContext::CreateBuffer(16, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, Data.EmptyStorageBuffer, Data.EmptyStorageMemory);
+
+		return Data.EmptyStorageBuffer;
+		}
+
+	// Sets with the same contents are shared by all draws of a frame, they are looked up by the handles they hold
+	static FakeVulkanDescriptorSets fake_build_descriptor_sets(FakeVulkanShader *shader, VkBuffer uniformBuffer)
+		{
+		const std::vector<FakeVulkanSamplerBinding> &samplers = shader->GetSamplers();
+		const std::vector<uint32> &storageBindings = shader->GetStorageBindings();
+		const FakeVulkanTextureBinding white = { Data.WhiteTexture->GetImageView(), Data.WhiteTexture->GetSampler() };
+
+		std::string &key = Data.DescriptorKey;
+		key.clear();
+		fake_append_key(key, shader->GetSetLayout(0));
+		fake_append_key(key, uniformBuffer);
+		for (const FakeVulkanSamplerBinding &sampler : samplers)
+			{
+			for (uint32 unit : sampler.Units)
+				{
+				FakeVulkanTextureBinding texture = unit < FakeVulkanRendererAPI::MaxTextureUnits ? Data.State.Textures[unit] : FakeVulkanTextureBinding();
+				fake_append_key(key, texture.View ? texture : white);
+				}
+			}
+
+		for (uint32 binding : storageBindings)
+			fake_append_key(key, binding < FakeVulkanRendererAPI::MaxStorageBindings ? Data.State.StorageBuffers[binding] : VK_NULL_HANDLE);
+
+		FakeVulkanFrameSlot &slot = Data.Slots[Data.SlotIndex];
+		auto it = slot.DescriptorCache.find(key);
+		if (it != slot.DescriptorCache.end())
+			return it->second;
+
+		FakeVulkanDescriptorSets result;
+		result.Sets[0] = fake_allocate_descriptor_set(shader->GetSetLayout(0));
+		if (storageBindings.size())
+			result.Sets[1] = fake_allocate_descriptor_set(shader->GetSetLayout(1));
+
+		std::vector<VkWriteDescriptorSet> writes;
+		std::vector<VkDescriptorImageInfo> imageInfos;
+		std::vector<VkDescriptorBufferInfo> bufferInfos;
+		imageInfos.reserve(FakeVulkanRendererAPI::MaxTextureUnits * samplers.size());
+		bufferInfos.reserve(storageBindings.size() + 1);
+
+		if (uniformBuffer)
+			{
+			bufferInfos.push_back({ uniformBuffer, 0, shader->GetUniformSize() });
+
+			VkWriteDescriptorSet write = {};
+			write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+			write.dstSet = result.Sets[0];
+			write.dstBinding = 0;
+			write.descriptorCount = 1;
+			write.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+			write.pBufferInfo = &bufferInfos.back();
+			writes.push_back(write);
+			}
+
+		for (const FakeVulkanSamplerBinding &sampler : samplers)
+			{
+			size_t first = imageInfos.size();
+			for (uint32 unit : sampler.Units)
+				{
+				FakeVulkanTextureBinding texture = unit < FakeVulkanRendererAPI::MaxTextureUnits ? Data.State.Textures[unit] : FakeVulkanTextureBinding();
+				if (!texture.View)
+					texture = white;
+
+				imageInfos.push_back({ texture.Sampler, texture.View, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL });
+				}
+
+			VkWriteDescriptorSet write = {};
+			write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+			write.dstSet = result.Sets[0];
+			write.dstBinding = sampler.Binding;
+			write.descriptorCount = (uint32)sampler.Units.size();
+			write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+			write.pImageInfo = &imageInfos[first];
+			writes.push_back(write);
+			}
+
+		for (uint32 binding : storageBindings)
+			{
+			VkBuffer buffer = binding < FakeVulkanRendererAPI::MaxStorageBindings ? Data.State.StorageBuffers[binding] : VK_NULL_HANDLE;
+			if (!buffer)
+				{
+				FAKE_LOG_ERROR("Shader %s reads storage binding %d, but no buffer is bound to it!", *shader->GetName(), binding);
+				buffer = fake_empty_storage_buffer();
+				}
+
+			bufferInfos.push_back({ buffer, 0, VK_WHOLE_SIZE });
+
+			VkWriteDescriptorSet write = {};
+			write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+			write.dstSet = result.Sets[1];
+			write.dstBinding = binding;
+			write.descriptorCount = 1;
+			write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+			write.pBufferInfo = &bufferInfos.back();
+			writes.push_back(write);
+			}
+
+		vkUpdateDescriptorSets(FakeVulkanContext::GetDevice(), (uint32)writes.size(), writes.data(), 0, nullptr);
+		slot.DescriptorCache.emplace(key, result);
+		return result;
+		}
+
+	static void fake_prepare_descriptor_sets(FakeVulkanShader *shader, FakeVulkanDraw &draw)
+		{
+		VkBuffer uniformBuffer = VK_NULL_HANDLE;
+		if (shader->GetUniformSize())
+			{
+			draw.DynamicOffset = shader->SnapshotUniforms(uniformBuffer);
+			draw.HasDynamicOffset = true;
+			}
+
+		// Most draws bind nothing new since the last draw with the same shader
+		FakeVulkanShaderSets &cached = Data.ShaderSets[shader];
+		if (cached.Shader != shader->GetRendererID() || cached.Version != Data.BindingsVersion || cached.UniformBuffer != uniformBuffer)
+			{
+			cached.Shader = shader->GetRendererID();
+			cached.Version = Data.BindingsVersion;
+			cached.UniformBuffer = uniformBuffer;
+			cached.Sets = fake_build_descriptor_sets(shader, uniformBuffer);
+			}
+
+		draw.Layout = shader->GetPipelineLayout();
+		draw.Sets[0] = cached.Sets.Sets[0];
+		draw.Sets[1] = cached.Sets.Sets[1];
+		draw.SetCount = cached.Sets.Sets[1] ? 2 : 1;
+		}
+
+	static VkPipeline fake_graphics_pipeline(FakeVulkanShader *shader, const FakeVulkanPipeline &pipeline, const FakeVulkanRenderTarget &target, VkPrimitiveTopology topology, bool depthTest)
+		{
+		FakeVulkanPipelineKey key;
+		key.Shader = shader->GetRendererID();
+		key.Pipeline = pipeline.GetRendererID();
+		key.RenderPass = target.LoadPass;
+		key.Topology = topology;
+		key.DepthTest = depthTest;
+		key.Blend = Data.State.Blend;
+
+		auto it = Data.Pipelines.find(key);
+		if (it != Data.Pipelines.end())
+			return it->second;
+
+		const std::vector<VkVertexInputBindingDescription> &bindings = pipeline.GetBindings();
+		const std::vector<VkVertexInputAttributeDescription> &attributes = pipeline.GetAttributes();
+
+		VkPipelineVertexInputStateCreateInfo vertexInput = {};
+		vertexInput.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+		vertexInput.vertexBindingDescriptionCount = (uint32)bindings.size();
+		vertexInput.pVertexBindingDescriptions = bindings.data();
+		vertexInput.vertexAttributeDescriptionCount = (uint32)attributes.size();
+		vertexInput.pVertexAttributeDescriptions = attributes.data();
+
+		VkPipelineInputAssemblyStateCreateInfo inputAssembly = {};
+		inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+		inputAssembly.topology = topology;
+
+		VkPipelineViewportStateCreateInfo viewport = {};
+		viewport.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+		viewport.viewportCount = 1;
+		viewport.scissorCount = 1;
+
+		// The images are not flipped, the rows are stored bottom up like on OpenGL, which turns counter clockwise into clockwise
+		VkPipelineRasterizationStateCreateInfo rasterization = {};
+		rasterization.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+		rasterization.polygonMode = VK_POLYGON_MODE_FILL;
+		rasterization.cullMode = VK_CULL_MODE_NONE;
+		rasterization.frontFace = VK_FRONT_FACE_CLOCKWISE;
+		rasterization.lineWidth = 1.0f;
+
+		VkPipelineMultisampleStateCreateInfo multisample = {};
+		multisample.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+		multisample.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+		VkPipelineDepthStencilStateCreateInfo depthStencil = {};
+		depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+		depthStencil.depthTestEnable = depthTest;
+		depthStencil.depthWriteEnable = depthTest;
+		depthStencil.depthCompareOp = VK_COMPARE_OP_LESS;
+
+		std::vector<VkPipelineColorBlendAttachmentState> blendAttachments(target.ColorCount);
+		for (uint32 i = 0; i < target.ColorCount; ++i)
+			{
+			VkPipelineColorBlendAttachmentState &attachment = blendAttachments[i];
+			attachment.blendEnable = Data.State.Blend && !(target.IntegerMask & (1u << i));
+			attachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+			attachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+			attachment.colorBlendOp = VK_BLEND_OP_ADD;
+			attachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+			attachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+			attachment.alphaBlendOp = VK_BLEND_OP_ADD;
+			attachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+			}
+
+		VkPipelineColorBlendStateCreateInfo colorBlend = {};
+		colorBlend.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+		colorBlend.attachmentCount = target.ColorCount;
+		colorBlend.pAttachments = blendAttachments.data();
+
+		std::vector<VkDynamicState> dynamicStates = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
+		if (FakeVulkanContext::GetFeatures().WideLines)
+			dynamicStates.push_back(VK_DYNAMIC_STATE_LINE_WIDTH);
+
+		VkPipelineDynamicStateCreateInfo dynamic = {};
+		dynamic.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+		dynamic.dynamicStateCount = (uint32)dynamicStates.size();
+		dynamic.pDynamicStates = dynamicStates.data();
+
+		const std::vector<VkPipelineShaderStageCreateInfo> &stages = shader->GetStages();
+
+		VkGraphicsPipelineCreateInfo info = {};
+		info.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+		info.stageCount = (uint32)stages.size();
+		info.pStages = stages.data();
+		info.pVertexInputState = &vertexInput;
+		info.pInputAssemblyState = &inputAssembly;
+		info.pViewportState = &viewport;
+		info.pRasterizationState = &rasterization;
+		info.pMultisampleState = &multisample;
+		info.pDepthStencilState = &depthStencil;
+		info.pColorBlendState = &colorBlend;
+		info.pDynamicState = &dynamic;
+		info.layout = shader->GetPipelineLayout();
+		info.renderPass = target.LoadPass;
+
+		VkPipeline result = VK_NULL_HANDLE;
+		FAKE_VK_CHECK_RESULT(vkCreateGraphicsPipelines(FakeVulkanContext::GetDevice(), Data.PipelineCache, 1, &info, nullptr, &result));
+
+		Data.Pipelines.emplace(key, result);
+		return result;
+		}
+
+	static const FakeVulkanRenderTarget &fake_current_target()
+		{
+		return Data.State.Target ? *Data.State.Target : Data.DefaultFramebuffer->GetTarget();
+		}
+
+	static uint32 fake_open_pass()
+		{
+		if (Data.OpenPass < 0)
+			{
+			FakeVulkanPass pass;
+			pass.Target = fake_current_target();
+			pass.FirstDraw = (uint32)Data.Draws.size();
+
+			Data.OpenPass = (int32)Data.Passes.size();
+			Data.Passes.push_back(pass);
+
+			FakeVulkanSegment segment;
+			segment.Type = FakeVulkanSegmentType::Pass;
+			segment.First = (uint32)Data.OpenPass;
+			segment.Count = 1;
+			Data.Segments.push_back(segment);
+			}
+
+		return (uint32)Data.OpenPass;
+		}
+
+	static VkClearColorValue fake_clear_color(const FakeVec4f &color)
+		{
+		VkClearColorValue value = {};
+		value.float32[0] = color.X;
+		value.float32[1] = color.Y;
+		value.float32[2] = color.Z;
+		value.float32[3] = color.W;
+		return value;
+		}
+
+	static FakeVulkanDraw *fake_capture_draw(FakePrimitiveType type, bool depthTest, FakeIndexFormat format)
+		{
+		FakeVulkanShader *shader = Data.State.Shader;
+		if (!shader || !shader->IsReady() || shader->IsCompute())
+			return nullptr;
+
+		if (!Data.State.Pipeline)
+			{
+			FAKE_LOG_ERROR("Draw without a bound pipeline, the vertex layout is unknown!");
+			return nullptr;
+			}
+
+		uint32 passIndex = fake_open_pass();
+		const FakeVulkanRenderTarget &target = Data.Passes[passIndex].Target;
+
+		FakeVulkanDraw draw;
+		draw.Pipeline = fake_graphics_pipeline(shader, *Data.State.Pipeline, target, fake_vulkan_topology(type), depthTest && target.HasDepth);
+		if (!draw.Pipeline)
+			return nullptr;
+
+		fake_prepare_descriptor_sets(shader, draw);
+		draw.PushBaseInstance = shader->PushesBaseInstance();
+		draw.VertexBuffers[0] = Data.State.PipelineVertexBuffer;
+		draw.VertexBuffers[1] = Data.State.Pipeline->GetInstanceBuffer();
+		draw.IndexBuffer = Data.State.IndexBuffer;
+		draw.IndexType = fake_vulkan_index_type(format);
+		draw.Viewport = Data.State.Viewport;
+		draw.LineWidth = Data.State.LineWidth;
+
+		Data.Draws.push_back(draw);
+		Data.Passes[passIndex].DrawCount++;
+		return &Data.Draws.back();
+		}
+
+	// Records draws and skips binds which would not change anything, like the state cache of the OpenGL backend
+	static void fake_record_draws(VkCommandBuffer commandBuffer, const FakeVulkanPass &pass, uint32 firstDraw, uint32 drawCount, FakeVulkanChunk &chunk)
+		{
+		const FakeVulkanContext::Features &features = FakeVulkanContext::GetFeatures();
+
+		VkRect2D scissor = { { 0, 0 }, pass.Target.Extent };
+		vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+
+		VkPipeline pipeline = VK_NULL_HANDLE;
+		VkPipelineLayout layout = VK_NULL_HANDLE;
+		VkDescriptorSet sets[2] = {};
+		uint32 dynamicOffset = ~0u;
+		VkBuffer vertexBuffers[2] = {};
+		VkBuffer indexBuffer = VK_NULL_HANDLE;
+		VkIndexType indexType = VK_INDEX_TYPE_MAX_ENUM;
+		VkViewport viewport = {};
+		float lineWidth = 1.0f;
+		int64 baseInstance = -1;
+
+		auto count = [&chunk](bool changed)
+			{
+			if (changed)
+				chunk.StateChanges++;
+			else
+				chunk.SkippedStateChanges++;
+
+			return changed;
+			};
+
+		for (uint32 i = firstDraw; i < firstDraw + drawCount; ++i)
+			{
+			const FakeVulkanDraw &draw = Data.Draws[i];
+
+			if (draw.Type == FakeVulkanDrawType::ClearAttachments)
+				{
+				VkClearAttachment attachments[9];
+				uint32 attachmentCount = 0;
+				for (uint32 a = 0; a < pass.Target.ColorCount; ++a)
+					{
+					VkClearAttachment &attachment = attachments[attachmentCount++];
+					attachment.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+					attachment.colorAttachment = a;
+					attachment.clearValue.color = (pass.Target.IntegerMask & (1u << a)) ? VkClearColorValue() : draw.ClearColor;
+					}
+
+				if (pass.Target.HasDepth)
+					{
+					VkClearAttachment &attachment = attachments[attachmentCount++];
+					attachment.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
+					attachment.colorAttachment = 0;
+					attachment.clearValue.depthStencil = { 1.0f, 0 };
+					}
+
+				VkClearRect rect = { scissor, 0, 1 };
+				vkCmdClearAttachments(commandBuffer, attachmentCount, attachments, 1, &rect);
+				continue;
+				}
+
+			if (count(draw.Pipeline != pipeline))
+				{
+				vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, draw.Pipeline);
+				pipeline = draw.Pipeline;
+				}
+
+			if (count(draw.Layout != layout || draw.Sets[0] != sets[0] || draw.Sets[1] != sets[1] || (draw.HasDynamicOffset && draw.DynamicOffset != dynamicOffset)))
+				{
+				vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, draw.Layout, 0, draw.SetCount, draw.Sets, draw.HasDynamicOffset ? 1 : 0, &draw.DynamicOffset);
+				if (draw.Layout != layout)
+					baseInstance = -1;
+
+				layout = draw.Layout;
+				sets[0] = draw.Sets[0];
+				sets[1] = draw.Sets[1];
+				dynamicOffset = draw.DynamicOffset;
+				}
+
+			if (count(draw.VertexBuffers[0] != vertexBuffers[0] || draw.VertexBuffers[1] != vertexBuffers[1]))
+				{
+				static const VkDeviceSize offsets[2] = { 0, 0 };
+				uint32 bindingCount = draw.VertexBuffers[1] ? 2 : (draw.VertexBuffers[0] ? 1 : 0);
+				if (bindingCount)
+					vkCmdBindVertexBuffers(commandBuffer, 0, bindingCount, draw.VertexBuffers, offsets);
+
+				vertexBuffers[0] = draw.VertexBuffers[0];
+				vertexBuffers[1] = draw.VertexBuffers[1];
+				}
+
+			if (count(draw.IndexBuffer != indexBuffer || draw.IndexType != indexType))
+				{
+				if (draw.IndexBuffer)
+					vkCmdBindIndexBuffer(commandBuffer, draw.IndexBuffer, 0, draw.IndexType);
+
+				indexBuffer = draw.IndexBuffer;
+				indexType = draw.IndexType;
+				}
+
+			if (count(memcmp(&draw.Viewport, &viewport, sizeof(VkViewport)) != 0))
+				{
+				vkCmdSetViewport(commandBuffer, 0, 1, &draw.Viewport);
+				viewport = draw.Viewport;
+				}
+
+			if (features.WideLines && count(draw.LineWidth != lineWidth || i == firstDraw))
+				{
+				vkCmdSetLineWidth(commandBuffer, draw.LineWidth);
+				lineWidth = draw.LineWidth;
+				}
+
+			// Without shader draw parameters gl_InstanceID is gl_InstanceIndex minus a pushed base instance
+			uint32 firstInstance = draw.Type == FakeVulkanDrawType::Indexed ? draw.FirstInstance : 0;
+			if (draw.PushBaseInstance && count(baseInstance != (int64)firstInstance))
+				{
+				vkCmdPushConstants(commandBuffer, draw.Layout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(uint32), &firstInstance);
+				baseInstance = firstInstance;
+				}
+
+			if (draw.Type == FakeVulkanDrawType::Indexed)
+				{
+				vkCmdDrawIndexed(commandBuffer, draw.Count, draw.InstanceCount, draw.FirstIndex, draw.VertexOffset, draw.FirstInstance);
+				}
+			else if (features.DrawIndirectCount)
+				{
+				vkCmdDrawIndexedIndirectCount(commandBuffer, draw.IndirectBuffer, draw.CommandOffset, draw.IndirectBuffer, draw.CountOffset, draw.MaxDrawCount, IndirectCommandStride);
+				}
+			else if (features.MultiDrawIndirect)
+				{
+				// Like on OpenGL without 4.6, every reserved command is issued, unused ones have to draw zero instances
+				vkCmdDrawIndexedIndirect(commandBuffer, draw.IndirectBuffer, draw.CommandOffset, draw.MaxDrawCount, IndirectCommandStride);
+				}
+			else
+				{
+				for (uint32 d = 0; d < draw.MaxDrawCount; ++d)
+					vkCmdDrawIndexedIndirect(commandBuffer, draw.IndirectBuffer, draw.CommandOffset + d * IndirectCommandStride, 1, IndirectCommandStride);
+				}
+			}
+		}
+
+	static void fake_record_chunk(VkCommandBuffer commandBuffer, FakeVulkanChunk &chunk)
+		{
+		const FakeVulkanPass &pass = Data.Passes[chunk.Pass];
+
+		VkCommandBufferInheritanceInfo inheritance = {};
+		inheritance.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+		inheritance.renderPass = pass.Clear ? pass.Target.ClearPass : pass.Target.LoadPass;
+		inheritance.framebuffer = pass.Target.Framebuffer;
+
+		VkCommandBufferBeginInfo beginInfo = {};
+		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+		beginInfo.flags = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT | VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+		beginInfo.pInheritanceInfo = &inheritance;
+
+		FAKE_VK_CHECK_RESULT(vkBeginCommandBuffer(commandBuffer, &beginInfo));
+		fake_record_draws(commandBuffer, pass, chunk.FirstDraw, chunk.DrawCount, chunk);
+		FAKE_VK_CHECK_RESULT(vkEndCommandBuffer(commandBuffer));
+
+		chunk.ThreadIndex = FakeJobSystem::GetThreadIndex();
+		}
+
+	static void fake_begin_render_pass(VkCommandBuffer commandBuffer, const FakeVulkanPass &pass, VkSubpassContents contents)
+		{
+		VkClearValue clearValues[9] = {};
+		uint32 clearValueCount = 0;
+		for (uint32 i = 0; i < pass.Target.ColorCount; ++i)
+			clearValues[clearValueCount++].color = (pass.Target.IntegerMask & (1u << i)) ? VkClearColorValue() : pass.ClearColor;
+
+		if (pass.Target.HasDepth)
+			clearValues[clearValueCount++].depthStencil = { 1.0f, 0 };
+
+		VkRenderPassBeginInfo beginInfo = {};
+		beginInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+		beginInfo.renderPass = pass.Clear ? pass.Target.ClearPass : pass.Target.LoadPass;
+		beginInfo.framebuffer = pass.Target.Framebuffer;
+		beginInfo.renderArea = { { 0, 0 }, pass.Target.Extent };
+		beginInfo.clearValueCount = pass.Clear ? clearValueCount : 0;
+		beginInfo.pClearValues = clearValues;
+		vkCmdBeginRenderPass(commandBuffer, &beginInfo, contents);
+		}
+
+	// Waits until the GPU is done with the next slot and hands its pools and memory to the frame which is captured next
+	static void fake_begin_slot()
+		{
+		VkDevice device = FakeVulkanContext::GetDevice();
+
+		Data.SlotIndex = (Data.SlotIndex + 1) % FakeVulkanRendererAPI::FramesInFlight;
+		FakeVulkanFrameSlot &slot = Data.Slots[Data.SlotIndex];
+		if (slot.Value)
+			FakeVulkanContext::Wait(slot.Value);
+
+		if (slot.Primary.Pool)
+			FAKE_VK_CHECK_RESULT(vkResetCommandPool(device, slot.Primary.Pool, 0));
+
+		for (const FakeVulkanCommandPool &pool : slot.Secondary)
+			FAKE_VK_CHECK_RESULT(vkResetCommandPool(device, pool.Pool, 0));
+
+		for (VkDescriptorPool pool : slot.DescriptorPools)
+			FAKE_VK_CHECK_RESULT(vkResetDescriptorPool(device, pool, 0));
+
+		slot.DescriptorPool = 0;
+		slot.DescriptorCache.clear();
+		slot.Uniforms.Current = slot.Uniforms.Head = 0;
+		slot.Staging.Current = slot.Staging.Head = 0;
+
+		Data.ShaderSets.clear();
+		Data.BindingsVersion++;
+
+		FakeVulkanContext::CollectGarbage();
+		}
+
+	static void fake_destroy_slot(FakeVulkanFrameSlot &slot)
+		{
+		VkDevice device = FakeVulkanContext::GetDevice();
+
+		if (slot.Primary.Pool)
+			vkDestroyCommandPool(device, slot.Primary.Pool, nullptr);
+
+		for (const FakeVulkanCommandPool &pool : slot.Secondary)
+			vkDestroyCommandPool(device, pool.Pool, nullptr);
+
+		for (VkDescriptorPool pool : slot.DescriptorPools)
+			vkDestroyDescriptorPool(device, pool, nullptr);
+
+		fake_ring_destroy(slot.Uniforms);
+		fake_ring_destroy(slot.Staging);
+		slot = FakeVulkanFrameSlot();
+		}
+	}
+
+void FakeVulkanRendererAPI::Init()
+	{
+	if (Data.Initialized)
+		return;
+
+	if (!FakeVulkanContext::IsSupported())
+		{
+		FAKE_LOG_ERROR("There is no Vulkan 1.2 device with timeline semaphores, the Vulkan backend can not be used!");
+		return;
+		}
+
+	const VkPhysicalDeviceProperties &properties = FakeVulkanContext::GetProperties();
+	const FakeVulkanContext::Features &features = FakeVulkanContext::GetFeatures();
+
+	auto &caps = FakeRendererAPI::GetCapabilities();
+	caps.Vendor = std::to_string(properties.vendorID);
+	caps.Renderer = properties.deviceName;
+	caps.Version = std::to_string(VK_VERSION_MAJOR(properties.apiVersion)) + "." + std::to_string(VK_VERSION_MINOR(properties.apiVersion)) + "." + std::to_string(VK_VERSION_PATCH(properties.apiVersion));
+	caps.MaxSamples = 1;
+	caps.MaxTextureUnits = (int32)MaxTextureUnits;
+	caps.MaxAnisotropy = features.SamplerAnisotropy ? properties.limits.maxSamplerAnisotropy : 1.0f;
+	caps.ComputeShaders = true;
+
+	VkPipelineCacheCreateInfo cacheInfo = {};
+	cacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+	FAKE_VK_CHECK_RESULT(vkCreatePipelineCache(FakeVulkanContext::GetDevice(), &cacheInfo, nullptr, &Data.PipelineCache));
+
+	Data.Initialized = true;
+
+	FakeFramebufferSpecification spec;
+	spec.Attachments = { FakeFramebufferTextureFormat::RGBA8, FakeFramebufferTextureFormat::DEPTH };
+	Data.DefaultFramebuffer = FakeRef<FakeVulkanFramebuffer>::Create(spec);
+
+	uint32 white = 0xffffffff;
+	Data.WhiteTexture = FakeRef<FakeVulkanTexture2D>::Create(FakeTextureFormat::RGBA, 1, 1);
+	Data.WhiteTexture->UploadPixels(&white);
+
+	Data.State = FakeVulkanBoundState();
+	Data.State.Viewport = { 0.0f, 0.0f, (float)spec.Width, (float)spec.Height, 0.0f, 1.0f };
+	}
+
+void FakeVulkanRendererAPI::Shutdown()
+	{
+	if (!Data.Initialized)
+		return;
+
+	// The captured frame is submitted, so pending readbacks can finish
+	SubmitFrame();
+	FakeVulkanReadback::Shutdown();
+	FakeVulkanContext::WaitIdle();
+
+	VkDevice device = FakeVulkanContext::GetDevice();
+	for (auto &[key, pipeline] : Data.Pipelines)
+		vkDestroyPipeline(device, pipeline, nullptr);
+
+	for (auto &[key, renderPass] : Data.RenderPasses)
+		vkDestroyRenderPass(device, renderPass, nullptr);
+
+	for (FakeVulkanFrameSlot &slot : Data.Slots)
+		Utils::fake_destroy_slot(slot);
+
+	if (Data.EmptyStorageBuffer)
+		{
+		vkDestroyBuffer(device, Data.EmptyStorageBuffer, nullptr);
+		vkFreeMemory(device, Data.EmptyStorageMemory, nullptr);
+		}
+
+	vkDestroyPipelineCache(device, Data.PipelineCache, nullptr);
+
+	// The resources of the backend hand their objects to the context, which destroys them with the device
+	Data.DefaultFramebuffer.Reset();
+	Data.WhiteTexture.Reset();
+	Data = FakeVulkanRendererData();
+
+	FakeVulkanShaderCompiler::Shutdown();
+	FakeVulkanContext::Shutdown();
+	}
+
+void FakeVulkanRendererAPI::Clear()
+	{
+	uint32 passIndex = Utils::fake_open_pass();
+	FakeVulkanPass &pass = Data.Passes[passIndex];
+
+	// A clear before the first draw is done by the render pass itself
+	if (!pass.DrawCount)
+		{
+		pass.Clear = true;
+		pass.ClearColor = Utils::fake_clear_color(Data.State.ClearColor);
+		return;
+		}
+
+	FakeVulkanDraw draw;
+	draw.Type = FakeVulkanDrawType::ClearAttachments;
+	draw.ClearColor = Utils::fake_clear_color(Data.State.ClearColor);
+	Data.Draws.push_back(draw);
+	pass.DrawCount++;
+	}
+
+void FakeVulkanRendererAPI::SetClearColor(const FakeVec4f &color)
+	{
+	Data.State.ClearColor = color;
+	}
+
+void FakeVulkanRendererAPI::DrawIndexed(uint32 count, FakePrimitiveType type, bool depthTest, FakeIndexFormat format, uint32 baseVertex)
+	{
+	FakeVulkanDraw *draw = Utils::fake_capture_draw(type, depthTest, format);
+	if (!draw)
+		return;
+
+	draw->Count = count;
+	draw->VertexOffset = (int32)baseVertex;
+	}
+
+void FakeVulkanRendererAPI::DrawIndexedInstanced(uint32 count, uint32 instanceCount, uint32 firstIndex, uint32 baseInstance, FakePrimitiveType type, bool depthTest, FakeIndexFormat format)
+	{
+	FakeVulkanDraw *draw = Utils::fake_capture_draw(type, depthTest, format);
+	if (!draw)
+		return;
+
+	draw->Count = count;
+	draw->InstanceCount = instanceCount;
+	draw->FirstIndex = firstIndex;
+	draw->FirstInstance = baseInstance;
+	}
+
+void FakeVulkanRendererAPI::DrawIndexedIndirect(uint32 commandOffset, uint32 countOffset, uint32 maxDrawCount, FakePrimitiveType type, bool depthTest, FakeIndexFormat format)
+	{
+	if (!Data.State.IndirectBuffer)
+		{
+		FAKE_LOG_ERROR("Indirect draw without a bound indirect buffer!");
+		return;
+		}
+
+	FakeVulkanDraw *draw = Utils::fake_capture_draw(type, depthTest, format);
+	if (!draw)
+		return;
+
+	draw->Type = FakeVulkanDrawType::Indirect;
+	draw->IndirectBuffer = Data.State.IndirectBuffer;
+	draw->CommandOffset = commandOffset;
+	draw->CountOffset = countOffset;
+	draw->MaxDrawCount = maxDrawCount;
+	}
+
+void FakeVulkanRendererAPI::DispatchCompute(uint32 groupsX, uint32 groupsY, uint32 groupsZ)
+	{
+	FakeVulkanShader *shader = Data.State.Shader;
+	if (!shader || !shader->IsReady() || !shader->IsCompute())
+		{
+		FAKE_LOG_ERROR("Dispatch without a bound compute shader!");
+		return;
+		}
+
+	FakeVulkanDraw draw;
+	Utils::fake_prepare_descriptor_sets(shader, draw);
+
+	VkPipeline pipeline = shader->GetComputePipeline();
+	Record([pipeline, draw, groupsX, groupsY, groupsZ](VkCommandBuffer commandBuffer)
+		{
+		vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+		vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, draw.Layout, 0, draw.SetCount, draw.Sets, draw.HasDynamicOffset ? 1 : 0, &draw.DynamicOffset);
+		vkCmdDispatch(commandBuffer, groupsX, groupsY, groupsZ);
+		});
+	}
+
+void FakeVulkanRendererAPI::StorageBarrier()
+	{
+	Record([](VkCommandBuffer commandBuffer) { FullBarrier(commandBuffer); });
+	}
+
+void FakeVulkanRendererAPI::SetViewport(uint32 width, uint32 height)
+	{
+	Data.State.Viewport = { 0.0f, 0.0f, (float)width, (float)height, 0.0f, 1.0f };
+	}
+
+void FakeVulkanRendererAPI::SetLineThickness(float thickness)
+	{
+	Data.State.LineWidth = thickness;
+	}
+
+void FakeVulkanRendererAPI::SetBlend(bool enabled)
+	{
+	Data.State.Blend = enabled;
+	}
+
+void FakeVulkanRendererAPI::ResetStats()
+	{
+	Data.Stats = FakeRenderAPIStatistics();
+	}
+
+FakeRenderAPIStatistics FakeVulkanRendererAPI::GetStats()
+	{
+	return Data.Stats;
+	}
+
+void FakeVulkanRendererAPI::ResolveReadbacks()
+	{
+	FakeVulkanReadback::Resolve(false);
+	}
+
+void FakeVulkanRendererAPI::SubmitFrame()
+	{
+	if (!Data.Initialized)
+		return;
+
+	Data.OpenPass = -1;
+
+	VkDevice device = FakeVulkanContext::GetDevice();
+	FakeVulkanFrameSlot &slot = Data.Slots[Data.SlotIndex];
+
+	auto recordStart = std::chrono::high_resolution_clock::now();
+
+	Data.Chunks.clear();
+	for (uint32 p = 0; p < (uint32)Data.Passes.size(); ++p)
+		{
+		const FakeVulkanPass &pass = Data.Passes[p];
+		for (uint32 first = 0; first < pass.DrawCount; first += DrawsPerChunk)
+			{
+			FakeVulkanChunk chunk;
+			chunk.Pass = p;
+			chunk.FirstDraw = pass.FirstDraw + first;
+			chunk.DrawCount = std::min(DrawsPerChunk, pass.DrawCount - first);
+			Data.Chunks.push_back(chunk);
+			}
+		}
+
+	// A frame which fits into one chunk is recorded right into the primary command buffer
+	const uint32 chunkCount = (uint32)Data.Chunks.size();
+	const bool secondary = chunkCount > 1 && FakeJobSystem::IsInitialized();
+	if (secondary)
+		{
+		while (slot.Secondary.size() < chunkCount)
+			slot.Secondary.push_back(Utils::fake_create_command_pool(VK_COMMAND_BUFFER_LEVEL_SECONDARY));
+
+		// Every chunk has its own command pool, so the threads never share one
+		FakeJobSystem::ParallelFor(chunkCount, 1, [&slot](uint32 begin, uint32 end)
+			{
+			for (uint32 i = begin; i < end; ++i)
+				Utils::fake_record_chunk(slot.Secondary[i].CommandBuffer, Data.Chunks[i]);
+			});
+		}
+
+	if (!slot.Primary.Pool)
+		slot.Primary = Utils::fake_create_command_pool(VK_COMMAND_BUFFER_LEVEL_PRIMARY);
+
+	VkCommandBuffer commandBuffer = slot.Primary.CommandBuffer;
+	VkCommandBufferBeginInfo beginInfo = {};
+	beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+	beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+	FAKE_VK_CHECK_RESULT(vkBeginCommandBuffer(commandBuffer, &beginInfo));
+
+	for (const auto &upload : Data.Uploads)
+		upload(commandBuffer);
+
+	bool barrier = !Data.Uploads.empty();
+	uint32 chunkIndex = 0;
+	std::vector<VkCommandBuffer> secondaryBuffers;
+	for (const FakeVulkanSegment &segment : Data.Segments)
+		{
+		if (segment.Type == FakeVulkanSegmentType::Pass)
+			{
+			const FakeVulkanPass &pass = Data.Passes[segment.First];
+			if (!pass.Clear && !pass.DrawCount)
+				continue;
+
+			if (barrier)
+				FullBarrier(commandBuffer);
+
+			if (secondary)
+				{
+				secondaryBuffers.clear();
+				for (; chunkIndex < chunkCount && Data.Chunks[chunkIndex].Pass == segment.First; ++chunkIndex)
+					secondaryBuffers.push_back(slot.Secondary[chunkIndex].CommandBuffer);
+
+				Utils::fake_begin_render_pass(commandBuffer, pass, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+				if (secondaryBuffers.size())
+					vkCmdExecuteCommands(commandBuffer, (uint32)secondaryBuffers.size(), secondaryBuffers.data());
+				}
+			else
+				{
+				Utils::fake_begin_render_pass(commandBuffer, pass, VK_SUBPASS_CONTENTS_INLINE);
+				for (; chunkIndex < chunkCount && Data.Chunks[chunkIndex].Pass == segment.First; ++chunkIndex)
+					Utils::fake_record_draws(commandBuffer, pass, Data.Chunks[chunkIndex].FirstDraw, Data.Chunks[chunkIndex].DrawCount, Data.Chunks[chunkIndex]);
+				}
+
+			vkCmdEndRenderPass(commandBuffer);
+			}
+		else
+			{
+			if (barrier)
+				FullBarrier(commandBuffer);
+
+			for (uint32 i = segment.First; i < segment.First + segment.Count; ++i)
+				Data.Commands[i](commandBuffer);
+			}
+
+		barrier = true;
+		}
+
+	FAKE_VK_CHECK_RESULT(vkEndCommandBuffer(commandBuffer));
+
+	double recordMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - recordStart).count();
+
+	slot.Value = FakeVulkanContext::Submit(1, &commandBuffer);
+	FakeVulkanReadback::Submitted(slot.Value);
+
+	std::set<uint32> threads;
+	Data.FrameStats = Statistics();
+	Data.FrameStats.Passes = (uint32)Data.Passes.size();
+	Data.FrameStats.Draws = (uint32)Data.Draws.size();
+	Data.FrameStats.SecondaryCommandBuffers = secondary ? chunkCount : 0;
+	Data.FrameStats.RecordMilliseconds = recordMilliseconds;
+	for (const FakeVulkanChunk &chunk : Data.Chunks)
+		{
+		threads.insert(secondary ? chunk.ThreadIndex : 0);
+		Data.Stats.StateChanges += chunk.StateChanges;
+		Data.Stats.SkippedStateChanges += chunk.SkippedStateChanges;
+		}
+
+	Data.FrameStats.RecordingThreads = (uint32)threads.size();
+
+	Data.Uploads.clear();
+	Data.Commands.clear();
+	Data.Passes.clear();
+	Data.Draws.clear();
+	Data.Segments.clear();
+
+	Utils::fake_begin_slot();
+	}
+
+const FakeVulkanRendererAPI::Statistics &FakeVulkanRendererAPI::GetFrameStats()
+	{
+	return Data.FrameStats;
+	}
+
+void FakeVulkanRendererAPI::BindShader(FakeVulkanShader *shader)
+	{
+	Data.State.Shader = shader;
+	}
+
+void FakeVulkanRendererAPI::BindPipeline(const FakeVulkanPipeline *pipeline)
+	{
+	// The vertices are read from the vertex buffer which is bound right now, so one pipeline serves many meshes
+	Data.State.Pipeline = pipeline;
+	Data.State.PipelineVertexBuffer = Data.State.VertexBuffer;
+	}
+
+void FakeVulkanRendererAPI::BindVertexBuffer(VkBuffer buffer)
+	{
+	Data.State.VertexBuffer = buffer;
+	}
+
+void FakeVulkanRendererAPI::BindIndexBuffer(VkBuffer buffer)
+	{
+	Data.State.IndexBuffer = buffer;
+	}
+
+void FakeVulkanRendererAPI::BindIndirectBuffer(VkBuffer buffer)
+	{
+	Data.State.IndirectBuffer = buffer;
+	}
+
+void FakeVulkanRendererAPI::BindStorageBuffer(uint32 binding, VkBuffer buffer)
+	{
+	FAKE_ASSERT(binding < MaxStorageBindings, "Storage binding out of range!");
+	if (Data.State.StorageBuffers[binding] == buffer)
+		return;
+
+	Data.State.StorageBuffers[binding] = buffer;
+	Data.BindingsVersion++;
+	}
+
+void FakeVulkanRendererAPI::BindTexture(uint32 unit, VkImageView view, VkSampler sampler)
+	{
+	FAKE_ASSERT(unit < MaxTextureUnits, "Texture unit out of range!");
+	FakeVulkanTextureBinding &binding = Data.State.Textures[unit];
+	if (binding.View == view && binding.Sampler == sampler)
+		return;
+
+	binding.View = view;
+	binding.Sampler = sampler;
+	Data.BindingsVersion++;
+	}
+
+void FakeVulkanRendererAPI::BindRenderTarget(const FakeVulkanRenderTarget *target)
+	{
+	if (target != Data.State.Target)
+		Data.OpenPass = -1;
+
+	Data.State.Target = target;
+
+	const FakeVulkanRenderTarget &current = Utils::fake_current_target();
+	Data.State.Viewport = { 0.0f, 0.0f, (float)current.Extent.width, (float)current.Extent.height, 0.0f, 1.0f };
+	}
+
+void FakeVulkanRendererAPI::ForgetRenderTarget(const FakeVulkanRenderTarget *target)
+	{
+	// The open pass keeps a copy of the target, its draws are still submitted
+	if (Data.State.Target == target)
+		Data.State.Target = nullptr;
+	}
+
+void FakeVulkanRendererAPI::InvalidateBindings()
+	{
+	Data.BindingsVersion++;
+	}
+
+void FakeVulkanRendererAPI::Record(std::function<void(VkCommandBuffer)> &&record)
+	{
+	Data.OpenPass = -1;
+
+	if (Data.Segments.empty() || Data.Segments.back().Type != FakeVulkanSegmentType::Commands)
+		{
+		FakeVulkanSegment segment;
+		segment.Type = FakeVulkanSegmentType::Commands;
+		segment.First = (uint32)Data.Commands.size();
+		Data.Segments.push_back(segment);
+		}
+
+	Data.Commands.push_back(std::move(record));
+	Data.Segments.back().Count++;
+	}
+
+void FakeVulkanRendererAPI::Upload(std::function<void(VkCommandBuffer)> &&record)
+	{
+	Data.Uploads.push_back(std::move(record));
+	}
+
+void FakeVulkanRendererAPI::WriteBuffer(VkBuffer buffer, uint32 offset, const void *data, uint32 size, bool upload)
+	{
+	if (!size)
+		return;
+
+	VkBuffer staging = VK_NULL_HANDLE;
+	VkDeviceSize stagingOffset = 0;
+	memcpy(AllocateStaging(size, staging, stagingOffset), data, size);
+
+	auto copy = [buffer, offset, size, staging, stagingOffset](VkCommandBuffer commandBuffer)
+		{
+		VkBufferCopy region = { stagingOffset, offset, size };
+		vkCmdCopyBuffer(commandBuffer, staging, buffer, 1, &region);
+		};
+
+	if (upload)
+		Upload(copy);
+	else
+		Record(copy);
+	}
+
+void *FakeVulkanRendererAPI::AllocateStaging(uint32 size, VkBuffer &outBuffer, VkDeviceSize &outOffset)
+	{
+	uint32 offset = 0;
+	void *memory = Utils::fake_ring_allocate(Data.Slots[Data.SlotIndex].Staging, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, 16, size, outBuffer, offset);
+	outOffset = offset;
+	return memory;
+	}
+
+void *FakeVulkanRendererAPI::AllocateUniforms(uint32 size, VkBuffer &outBuffer, uint32 &outOffset)
+	{
+	uint32 alignment = (uint32)std::max<VkDeviceSize>(FakeVulkanContext::GetProperties().limits.minUniformBufferOffsetAlignment, 16);
+	return Utils::fake_ring_allocate(Data.Slots[Data.SlotIndex].Uniforms, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, alignment, size, outBuffer, outOffset);
+	}
+
+VkRenderPass FakeVulkanRendererAPI::GetRenderPass(const std::vector<VkFormat> &colorFormats, VkFormat depthFormat, bool clear)
+	{
+	std::vector<int32> key = { clear ? 1 : 0, (int32)depthFormat };
+	for (VkFormat format : colorFormats)
+		key.push_back((int32)format);
+
+	auto it = Data.RenderPasses.find(key);
+	if (it != Data.RenderPasses.end())
+		return it->second;
+
+	// The attachments stay in their attachment layouts between passes, the images are moved there when they are created
+	VkAttachmentLoadOp loadOp = clear ? VK_ATTACHMENT_LOAD_OP_CLEAR : VK_ATTACHMENT_LOAD_OP_LOAD;
+	std::vector<VkAttachmentDescription> attachments;
+	std::vector<VkAttachmentReference> colorReferences;
+	for (VkFormat format : colorFormats)
+		{
+		VkAttachmentDescription attachment = {};
+		attachment.format = format;
+		attachment.samples = VK_SAMPLE_COUNT_1_BIT;
+		attachment.loadOp = loadOp;
+		attachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+		attachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+		attachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+		attachment.initialLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+		attachment.finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+		colorReferences.push_back({ (uint32)attachments.size(), VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL });
+		attachments.push_back(attachment);
+		}
+
+	VkAttachmentReference depthReference = { (uint32)attachments.size(), VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL };
+	if (depthFormat != VK_FORMAT_UNDEFINED)
+		{
+		VkAttachmentDescription attachment = {};
+		attachment.format = depthFormat;
+		attachment.samples = VK_SAMPLE_COUNT_1_BIT;
+		attachment.loadOp = loadOp;
+		attachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+		attachment.stencilLoadOp = loadOp;
+		attachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_STORE;
+		attachment.initialLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+		attachment.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+		attachments.push_back(attachment);
+		}
+
+	VkSubpassDescription subpass = {};
+	subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+	subpass.colorAttachmentCount = (uint32)colorReferences.size();
+	subpass.pColorAttachments = colorReferences.data();
+	subpass.pDepthStencilAttachment = depthFormat != VK_FORMAT_UNDEFINED ? &depthReference : nullptr;
+
+	VkRenderPassCreateInfo info = {};
+	info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+	info.attachmentCount = (uint32)attachments.size();
+	info.pAttachments = attachments.data();
+	info.subpassCount = 1;
+	info.pSubpasses = &subpass;
+
+	VkRenderPass renderPass = VK_NULL_HANDLE;
+	FAKE_VK_CHECK_RESULT(vkCreateRenderPass(FakeVulkanContext::GetDevice(), &info, nullptr, &renderPass));
+
+	Data.RenderPasses.emplace(key, renderPass);
+	return renderPass;
+	}
+
+void FakeVulkanRendererAPI::ForgetPipelines(FakeRendererID rendererID)
+	{
+	for (auto it = Data.Pipelines.begin(); it != Data.Pipelines.end();)
+		{
+		if (it->first.Shader != rendererID && it->first.Pipeline != rendererID)
+			{
+			++it;
+			continue;
+			}
+
+		VkPipeline pipeline = it->second;
+		FakeVulkanContext::DestroyLater([pipeline]() { vkDestroyPipeline(FakeVulkanContext::GetDevice(), pipeline, nullptr); });
+		it = Data.Pipelines.erase(it);
+		}
+	}
+
+void FakeVulkanRendererAPI::FullBarrier(VkCommandBuffer commandBuffer)
+	{
+	VkMemoryBarrier barrier = {};
+	barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+	barrier.srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT;
+	barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+	vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+	}
+
+void FakeVulkanRendererAPI::TransitionImage(VkCommandBuffer commandBuffer, VkImage image, VkImageAspectFlags aspect, VkImageLayout oldLayout, VkImageLayout newLayout)
+	{
+	VkImageMemoryBarrier barrier = {};
+	barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+	barrier.srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT;
+	barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+	barrier.oldLayout = oldLayout;
+	barrier.newLayout = newLayout;
+	barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.image = image;
+	barrier.subresourceRange = { aspect, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS };
+	vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+	}
+
+#endif
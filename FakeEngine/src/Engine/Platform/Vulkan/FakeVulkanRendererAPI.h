@@ -0,0 +1,245 @@
+/*****************************************************************
+ * \file   FakeVulkanRendererAPI.h
+ * \brief  
+ * 
+ * \author Can Karka
+ * \date   February 2021
+ * 
+ * Copyright (C) 2021 Can Karka
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *********************************************************************/
+
+#pragma once
+
+#include "FakeVulkan.h"
+
+#include "Engine/Renderer/FakeRendererAPI.h"
+
+class FakeVulkanShader;
+class FakeVulkanPipeline;
+
+/**
+ *
+ * The attachments a draw renders into, owned by FakeVulkanFramebuffer.
+ *
+ */
+struct FakeVulkanRenderTarget
+	{
+	VkFramebuffer Framebuffer = VK_NULL_HANDLE;
+	VkRenderPass LoadPass = VK_NULL_HANDLE;		/**< Keeps the contents of the attachments. */
+	VkRenderPass ClearPass = VK_NULL_HANDLE;	/**< Clears every attachment, for passes which start with a clear. */
+	VkExtent2D Extent = {};
+	uint32 ColorCount = 0;
+	uint32 IntegerMask = 0;						/**< The color attachments with integer formats, they are never blended. */
+	bool HasDepth = false;
+	};
+
+/**
+ *
+ * The Vulkan backend. While the render command queue executes, draws are not recorded but captured into passes,
+ * together with the state the engine has bound like on OpenGL. SubmitFrame() splits the passes into chunks of draws,
+ * records every chunk into a secondary command buffer on the job system and submits the frame with one primary command buffer.
+ *
+ * Every frame owns a slot of command pools, descriptor pools and upload memory. A slot is reused once the timeline
+ * semaphore says its frame has finished, so the CPU runs at most FramesInFlight frames ahead of the GPU.
+ *
+ * There is no swapchain, without a framebuffer bound the draws go into an offscreen target of 1280x720.
+ *
+ * @attention All functions must be called on the render thread.
+ *
+ */
+class FakeVulkanRendererAPI
+	{
+	public:
+
+		static const uint32 FramesInFlight = 2;
+		static const uint32 MaxTextureUnits = 32;
+		static const uint32 MaxStorageBindings = 16;
+
+		/**
+		 *
+		 * What the last submitted frame took, on top of FakeRenderAPIStatistics.
+		 *
+		 */
+		struct Statistics
+			{
+			uint32 Passes = 0;
+			uint32 Draws = 0;
+			uint32 SecondaryCommandBuffers = 0;
+			uint32 RecordingThreads = 0;
+			double RecordMilliseconds = 0.0;
+			};
+
+		// See FakeRendererAPI for the documentation of these
+
+		static void Init();
+		static void Shutdown();
+
+		static void Clear();
+		static void SetClearColor(const FakeVec4f &color);
+
+		static void DrawIndexed(uint32 count, FakePrimitiveType type, bool depthTest, FakeIndexFormat format, uint32 baseVertex);
+		static void DrawIndexedInstanced(uint32 count, uint32 instanceCount, uint32 firstIndex, uint32 baseInstance, FakePrimitiveType type, bool depthTest, FakeIndexFormat format);
+		static void DrawIndexedIndirect(uint32 commandOffset, uint32 countOffset, uint32 maxDrawCount, FakePrimitiveType type, bool depthTest, FakeIndexFormat format);
+
+		static void DispatchCompute(uint32 groupsX, uint32 groupsY, uint32 groupsZ);
+		static void StorageBarrier();
+
+		static void SetViewport(uint32 width, uint32 height);
+		static void SetLineThickness(float thickness);
+		static void SetBlend(bool enabled);
+
+		static void ResetStats();
+		static FakeRenderAPIStatistics GetStats();
+
+		static void ResolveReadbacks();
+
+		/**
+		 *
+		 * Records the captured frame, submits it and moves on to the next slot. Called by FakeRenderer::Render().
+		 *
+		 */
+		static void SubmitFrame();
+
+		/**
+		 *
+		 * Returns the numbers of the last submitted frame.
+		 *
+		 */
+		static const Statistics &GetFrameStats();
+
+		// The bind functions of the resources, called while the render command queue executes
+
+		static void BindShader(FakeVulkanShader *shader);
+		static void BindPipeline(const FakeVulkanPipeline *pipeline);
+		static void BindVertexBuffer(VkBuffer buffer);
+		static void BindIndexBuffer(VkBuffer buffer);
+		static void BindIndirectBuffer(VkBuffer buffer);
+		static void BindStorageBuffer(uint32 binding, VkBuffer buffer);
+		static void BindTexture(uint32 unit, VkImageView view, VkSampler sampler);
+
+		/**
+		 *
+		 * Makes a framebuffer the target of the following draws and sets the viewport to its size.
+		 *
+		 * @param target The target, nullptr for the offscreen default target.
+		 */
+		static void BindRenderTarget(const FakeVulkanRenderTarget *target);
+
+		/**
+		 *
+		 * Falls back to the default target if a framebuffer which is being destroyed is bound.
+		 *
+		 * @param target The target of the framebuffer.
+		 */
+		static void ForgetRenderTarget(const FakeVulkanRenderTarget *target);
+
+		/**
+		 *
+		 * Forgets the descriptor sets built for the bound textures and storage buffers, when a shader changes its sampler units.
+		 *
+		 */
+		static void InvalidateBindings();
+
+		/**
+		 *
+		 * Captures commands which run outside of render passes, in order with the draws, like copies and clears of single attachments.
+		 *
+		 * @param record Records the commands, it runs in SubmitFrame().
+		 */
+		static void Record(std::function<void(VkCommandBuffer)> &&record);
+
+		/**
+		 *
+		 * Records commands at the start of the next submitted frame, before everything captured.
+		 * For resources which upload their contents when they are created.
+		 *
+		 * @param record Records the commands.
+		 */
+		static void Upload(std::function<void(VkCommandBuffer)> &&record);
+
+		/**
+		 *
+		 * Copies data into a buffer through staging memory, the caller may reuse its memory right away.
+		 *
+		 * @param buffer The buffer to write.
+		 * @param offset The offset in bytes inside the buffer.
+		 * @param data The data.
+		 * @param size The size of the data in bytes.
+		 * @param upload Whether the copy runs at the start of the next frame like Upload(), or in order with the draws like Record().
+		 */
+		static void WriteBuffer(VkBuffer buffer, uint32 offset, const void *data, uint32 size, bool upload);
+
+		/**
+		 *
+		 * Hands out host visible memory to copy from, it stays valid until the frame which is being captured has finished.
+		 *
+		 * @param size The size in bytes.
+		 * @param outBuffer Receives the buffer to copy from.
+		 * @param outOffset Receives the offset of the memory in the buffer.
+		 * @return Returns the mapped memory.
+		 */
+		static void *AllocateStaging(uint32 size, VkBuffer &outBuffer, VkDeviceSize &outOffset);
+
+		/**
+		 *
+		 * Hands out memory of the uniform ring of the frame which is being captured.
+		 *
+		 * @param size The size in bytes.
+		 * @param outBuffer Receives the uniform buffer.
+		 * @param outOffset Receives the dynamic offset of the memory.
+		 * @return Returns the mapped memory.
+		 */
+		static void *AllocateUniforms(uint32 size, VkBuffer &outBuffer, uint32 &outOffset);
+
+		/**
+		 *
+		 * Returns a render pass for a set of attachments, render passes with the same attachments are shared.
+		 *
+		 * @param colorFormats The formats of the color attachments.
+		 * @param depthFormat The format of the depth attachment, VK_FORMAT_UNDEFINED if there is none.
+		 * @param clear Whether the render pass clears the attachments or keeps them.
+		 * @return Returns the render pass, the backend destroys it on shutdown.
+		 */
+		static VkRenderPass GetRenderPass(const std::vector<VkFormat> &colorFormats, VkFormat depthFormat, bool clear);
+
+		/**
+		 *
+		 * Destroys the pipelines which were built for a shader or a FakeVulkanPipeline, when it is reloaded or destroyed.
+		 *
+		 * @param rendererID The id of the shader or the pipeline.
+		 */
+		static void ForgetPipelines(FakeRendererID rendererID);
+
+		/**
+		 *
+		 * Makes every write recorded so far visible to every later command. Used after copies, the captured frame
+		 * places the same barrier between its passes and commands anyway.
+		 *
+		 * @param commandBuffer The command buffer to record into.
+		 */
+		static void FullBarrier(VkCommandBuffer commandBuffer);
+
+		/**
+		 *
+		 * Moves all mip levels and layers of an image from one layout to another, behind a full barrier.
+		 *
+		 * @param commandBuffer The command buffer to record into.
+		 * @param image The image.
+		 * @param aspect The aspects of the image.
+		 * @param oldLayout The current layout, VK_IMAGE_LAYOUT_UNDEFINED discards the contents.
+		 * @param newLayout The layout the image has afterwards.
+		 */
+		static void TransitionImage(VkCommandBuffer commandBuffer, VkImage image, VkImageAspectFlags aspect, VkImageLayout oldLayout, VkImageLayout newLayout);
+	};
@@ -0,0 +1,1043 @@
+#include "FakePch.h"
+#include "FakeVulkanShader.h"
+
+#ifdef FAKE_RENDERER_VULKAN
+
+#include "Engine/Core/FakeVirtualFileSystem.h"
+#include "Engine/Renderer/FakeRenderer.h"
+#include "FakeVulkanContext.h"
+#include "FakeVulkanRendererAPI.h"
+#include "FakeVulkanShaderCompiler.h"
+
+// A replacement of a range of the source, an insertion if the range is empty
+struct FakeVulkanSourceEdit
+	{
+	size_t Begin = 0;
+	size_t End = 0;
+	std::string Text;
+	};
+
+namespace Utils
+	{
+	static bool fake_is_type_string_resource(std::string_view type)
+		{
+		return type == "sampler1D" || type == "sampler2D" || type == "sampler2DMS" || type == "samplerCube" || type == "sampler2DShadow";
+		}
+
+	static bool fake_is_qualifier(std::string_view token)
+		{
+		return token == "highp" || token == "mediump" || token == "lowp" || token == "const"
+			|| token == "flat" || token == "smooth" || token == "noperspective"
+			|| token == "readonly" || token == "writeonly" || token == "coherent" || token == "volatile" || token == "restrict";
+		}
+
+	static bool fake_starts_with(std::string_view string, std::string_view start)
+		{
+		return string.size() >= start.size() && string.compare(0, start.size(), start) == 0;
+		}
+
+	static FakeString fake_to_string(std::string_view string)
+		{
+		return std::string(string);
+		}
+
+	static uint32 fake_align(uint32 value, uint32 alignment)
+		{
+		return (value + alignment - 1) / alignment * alignment;
+		}
+
+	static FakeShaderDomain fake_domain_from_stage(FakeShaderStage stage)
+		{
+		switch (stage)
+			{
+			case FakeShaderStage::Vertex:   return FakeShaderDomain::Vertex;
+			case FakeShaderStage::Fragment: return FakeShaderDomain::Fragment;
+			}
+
+		return FakeShaderDomain::None;
+		}
+
+	static VkShaderStageFlagBits fake_vulkan_stage(FakeShaderStage stage)
+		{
+		switch (stage)
+			{
+			case FakeShaderStage::Vertex:   return VK_SHADER_STAGE_VERTEX_BIT;
+			case FakeShaderStage::Fragment: return VK_SHADER_STAGE_FRAGMENT_BIT;
+			case FakeShaderStage::Compute:  return VK_SHADER_STAGE_COMPUTE_BIT;
+			}
+
+		FAKE_ASSERT(false, "Unknown shader stage!");
+		return VK_SHADER_STAGE_ALL;
+		}
+
+	// Fills in the shape of a basic GLSL type, returns false for structs and unknown types
+	static bool fake_uniform_field(std::string_view type, FakeVulkanUniformField &field)
+		{
+		field.Components = 1;
+		field.Columns = 1;
+		field.Boolean = type == "bool";
+
+		if (type == "float" || type == "int" || type == "uint" || type == "bool")
+			{
+			}
+		else if (type.size() == 4 && (fake_starts_with(type, "vec") || fake_starts_with(type, "mat")) && type[3] >= '2' && type[3] <= '4')
+			{
+			field.Components = type[3] - '0';
+			field.Columns = type[0] == 'm' ? field.Components : 1;
+			}
+		else if (type.size() == 5 && (type[0] == 'i' || type[0] == 'u') && fake_starts_with(type.substr(1), "vec") && type[4] >= '2' && type[4] <= '4')
+			{
+			field.Components = type[4] - '0';
+			}
+		else
+			{
+			return false;
+			}
+
+		// The engine passes bools as single bytes, like the OpenGL uniform declarations
+		field.PackedSize = field.Boolean ? 1 : field.Components * field.Columns * (uint32)sizeof(float);
+		return true;
+		}
+
+	// The base alignment and the size of a field in the std140 layout, matrix columns are vec4 aligned
+	static uint32 fake_std140_alignment(const FakeVulkanUniformField &field)
+		{
+		if (field.Columns > 1 || field.Components > 2)
+			return 16;
+
+		return field.Components * 4;
+		}
+
+	static uint32 fake_std140_size(const FakeVulkanUniformField &field)
+		{
+		return field.Columns > 1 ? field.Columns * 16 : field.Components * 4;
+		}
+
+	static void fake_write_element(Byte *destination, const Byte *source, const FakeVulkanUniformField &field)
+		{
+		if (field.Boolean)
+			{
+			int32 value = *(const bool*)source ? 1 : 0;
+			memcpy(destination, &value, sizeof(int32));
+			return;
+			}
+
+		uint32 columnSize = field.Components * (uint32)sizeof(float);
+		for (uint32 column = 0; column < field.Columns; ++column)
+			memcpy(destination + column * 16, source + column * columnSize, columnSize);
+		}
+
+	static uint32 fake_location_count(std::string_view type)
+		{
+		if (type.size() == 4 && fake_starts_with(type, "mat") && type[3] >= '2' && type[3] <= '4')
+			return type[3] - '0';
+
+		return 1;
+		}
+
+	static uint32 fake_parse_number(std::string_view token)
+		{
+		uint32 result = 0;
+		for (char c : token)
+			{
+			if (c < '0' || c > '9')
+				break;
+
+			result = result * 10 + (c - '0');
+			}
+
+		return result;
+		}
+
+	// Parses "<name>[N], <name>[N];" after the type and returns the position after the semicolon
+	template<typename Callback>
+	static size_t fake_parse_declarators(FakeShaderTokenizer &tokenizer, const std::string &source, Callback &&callback)
+		{
+		for (;;)
+			{
+			std::string_view name = tokenizer.Next();
+			if (name.empty())
+				return source.size();
+
+			uint32 count = 1;
+			if (tokenizer.Peek() == "[")
+				{
+				tokenizer.Next();
+				count = std::max(fake_parse_number(tokenizer.Next()), 1u);
+				while (!tokenizer.Peek().empty() && tokenizer.Next() != "]");
+				}
+
+			callback(name, count);
+
+			// Initializers are skipped up to the next declarator
+			std::string_view separator = tokenizer.Next();
+			while (!separator.empty() && separator != "," && separator != ";")
+				separator = tokenizer.Next();
+
+			if (separator != ",")
+				return separator.empty() ? source.size() : (size_t)(separator.data() - source.data()) + 1;
+			}
+		}
+
+	static void fake_skip_balanced(FakeShaderTokenizer &tokenizer, char open, char close)
+		{
+		uint32 depth = 1;
+		for (std::string_view token = tokenizer.Next(); !token.empty(); token = tokenizer.Next())
+			{
+			if (token[0] == open)
+				++depth;
+			else if (token[0] == close && --depth == 0)
+				return;
+			}
+		}
+	}
+
+FakeVulkanShader::FakeVulkanShader(const FakeString &filePath, const FakeShaderDefineList &defines)
+	: Defines(defines)
+	{
+	AssetPath = FakeVirtualFileSystem::Get()->GetAbsoluteFilePath(filePath);
+	Name = FakeVirtualFileSystem::Get()->GetFileNameFromPath(AssetPath);
+	Reload();
+	}
+
+FakeVulkanShader::FakeVulkanShader(const FakeString &name, const FakeString &vertexSrc, const FakeString &fragmentSrc)
+	: Name(name)
+	{
+	Sources.push_back({ FakeShaderStage::Vertex, *vertexSrc });
+	Sources.push_back({ FakeShaderStage::Fragment, *fragmentSrc });
+	LoadStages();
+	}
+
+FakeVulkanShader::~FakeVulkanShader()
+	{
+	Release();
+	}
+
+FakeRef<FakeVulkanShader> FakeVulkanShader::CreateFromString(const FakeString &name, const FakeString &source)
+	{
+	FakeRef<FakeVulkanShader> shader = FakeRef<FakeVulkanShader>::Create();
+	shader->Name = name;
+	shader->Load(source);
+	return shader;
+	}
+
+void FakeVulkanShader::Bind() const
+	{
+	FakeRef<const FakeVulkanShader> instance = this;
+	FakeRenderer::Submit([instance]() { FakeVulkanRendererAPI::BindShader(const_cast<FakeVulkanShader*>(instance.Raw())); });
+	}
+
+void FakeVulkanShader::Unbind() const
+	{
+	FakeRenderer::Submit([]() { FakeVulkanRendererAPI::BindShader(nullptr); });
+	}
+
+void FakeVulkanShader::Reload()
+	{
+	if (AssetPath.IsEmpty()) return;
+
+	if (!FakeVirtualFileSystem::Get()->FileExists(AssetPath))
+		{
+		FAKE_LOG_ERROR("Shader %s not found!", *AssetPath);
+		return;
+		}
+
+	bool reloaded = !Sources.empty();
+	Load(FakeVirtualFileSystem::Get()->ReadTextFile(AssetPath));
+
+	if (reloaded)
+		{
+		for (auto &callback : ShaderReloadedCallbacks)
+			callback();
+		}
+	}
+
+void FakeVulkanShader::UploadUniformBuffer(const FakeUniformBufferBase &uniformBuffer)
+	{
+	for (uint32 i = 0; i < uniformBuffer.GetUniformCount(); i++)
+		{
+		const FakeUniformDecl &decl = uniformBuffer.GetUniforms()[i];
+		const Byte *data = uniformBuffer.GetBuffer() + decl.Offset;
+		switch (decl.Type)
+			{
+			case FakeUniformType::Float:     SubmitUniform(decl.Name, data, sizeof(float)); break;
+			case FakeUniformType::Float2:    SubmitUniform(decl.Name, data, sizeof(FakeVec2f)); break;
+			case FakeUniformType::Float3:    SubmitUniform(decl.Name, data, sizeof(FakeVec3f)); break;
+			case FakeUniformType::Float4:    SubmitUniform(decl.Name, data, sizeof(FakeVec4f)); break;
+			case FakeUniformType::Matrix2x2: SubmitUniform(decl.Name, data, sizeof(FakeMat2f)); break;
+			case FakeUniformType::Matrix3x3: SubmitUniform(decl.Name, data, sizeof(FakeMat3f)); break;
+			case FakeUniformType::Matrix4x4: SubmitUniform(decl.Name, data, sizeof(FakeMat4f)); break;
+			case FakeUniformType::Int32:     SubmitUniform(decl.Name, data, sizeof(int32)); break;
+			case FakeUniformType::Uint32:    SubmitUniform(decl.Name, data, sizeof(uint32)); break;
+			}
+		}
+	}
+
+void FakeVulkanShader::SetVSMaterialUniformBuffer(FakeAllocator buffer)
+	{
+	SetMaterialUniformRange(FakeShaderDomain::Vertex, buffer, 0, buffer.Size);
+	}
+
+void FakeVulkanShader::SetFSMaterialUniformBuffer(FakeAllocator buffer)
+	{
+	SetMaterialUniformRange(FakeShaderDomain::Fragment, buffer, 0, buffer.Size);
+	}
+
+void FakeVulkanShader::SetMaterialUniformRange(FakeShaderDomain domain, FakeAllocator buffer, uint32 begin, uint32 end) const
+	{
+	// The material owns the buffer, like on OpenGL it is read when the command executes
+	FakeRef<FakeVulkanShader> instance = const_cast<FakeVulkanShader*>(this);
+	FakeRenderer::Submit([instance, domain, buffer, begin, end]() mutable
+		{
+		const FakeRef<FakeOpenGLShaderUniformBufferDeclaration> &decl = domain == FakeShaderDomain::Vertex ? instance->VSMaterialUniformBuffer : instance->FSMaterialUniformBuffer;
+		instance->StoreMaterialUniforms(decl, buffer.Data, begin, end);
+		});
+	}
+
+uint32 FakeVulkanShader::SnapshotUniforms(VkBuffer &outBuffer)
+	{
+	// Draws without a uniform change in between read the same copy
+	uint32 frame = FakeRenderer::GetFrameIndex();
+	if (!UniformsDirty && SnapshotFrame == frame)
+		{
+		outBuffer = SnapshotBuffer;
+		return SnapshotOffset;
+		}
+
+	void *memory = FakeVulkanRendererAPI::AllocateUniforms(UniformSize, SnapshotBuffer, SnapshotOffset);
+	memcpy(memory, UniformData.data(), UniformSize);
+
+	UniformsDirty = false;
+	SnapshotFrame = frame;
+	outBuffer = SnapshotBuffer;
+	return SnapshotOffset;
+	}
+
+void FakeVulkanShader::Load(const FakeString &source)
+	{
+	Sources = FakeShaderPreprocessor::Process(std::string_view(*source, source.Length()), AssetPath, Defines);
+	LoadStages();
+	}
+
+void FakeVulkanShader::LoadStages()
+	{
+	Compute = false;
+	for (const FakeShaderStageSource &stage : Sources)
+		Compute |= stage.Stage == FakeShaderStage::Compute;
+
+	Parse();
+	BuildLayout();
+	Compile();
+	}
+
+void FakeVulkanShader::Parse()
+	{
+	Resources.clear();
+	Structs.clear();
+	VSRendererUniformBuffers.clear();
+	FSRendererUniformBuffers.clear();
+	VSMaterialUniformBuffer.Reset();
+	FSMaterialUniformBuffer.Reset();
+	DeclarationArena.Reset();
+
+	Reflection.Clear();
+	for (const FakeShaderStageSource &stage : Sources)
+		Reflection.Parse(stage.Source, Utils::fake_domain_from_stage(stage.Stage));
+
+	// Compute shaders have no material uniforms, their uniforms are only laid out for the uniform block
+	if (Compute)
+		return;
+
+	const std::vector<FakeShaderReflectionEntry> &entries = Reflection.GetEntries();
+	for (uint32 i = 0; i < (uint32)entries.size(); ++i)
+		{
+		if (entries[i].Kind == FakeShaderReflectionKind::Struct)
+			ParseUniformStruct(i);
+		else if (entries[i].Kind == FakeShaderReflectionKind::Uniform)
+			ParseUniform(entries[i]);
+		}
+	}
+
+void FakeVulkanShader::ParseUniform(const FakeShaderReflectionEntry &entry)
+	{
+	FakeShaderDomain domain = entry.Domain;
+	FakeString name = Utils::fake_to_string(entry.Name);
+	FakeString typeString = Utils::fake_to_string(entry.Type);
+
+	if (Utils::fake_is_type_string_resource(entry.Type))
+		{
+		Resources.push_back(DeclarationArena.New<FakeOpenGLResourceDeclaration>(FakeOpenGLResourceDeclaration::StringToType(typeString), name, entry.Count));
+		return;
+		}
+
+	FakeOpenGLShaderUniformDeclaration::Type type = FakeOpenGLShaderUniformDeclaration::StringToType(typeString);
+	FakeOpenGLShaderUniformDeclaration *declaration = nullptr;
+	if (type == FakeOpenGLShaderUniformDeclaration::Type::NONE)
+		{
+		FakeShaderStruct *uniformStruct = FindStruct(typeString);
+		FAKE_ASSERT(uniformStruct, "");
+		declaration = DeclarationArena.New<FakeOpenGLShaderUniformDeclaration>(domain, uniformStruct, name, entry.Count);
+		}
+	else
+		{
+		declaration = DeclarationArena.New<FakeOpenGLShaderUniformDeclaration>(domain, type, name, entry.Count);
+		}
+
+	if (Utils::fake_starts_with(entry.Name, "r_"))
+		{
+		FakeShaderUniformBufferList &rendererBuffers = domain == FakeShaderDomain::Vertex ? VSRendererUniformBuffers : FSRendererUniformBuffers;
+		if (rendererBuffers.empty())
+			rendererBuffers.push_back(DeclarationArena.New<FakeOpenGLShaderUniformBufferDeclaration>("Renderer", domain));
+
+		((FakeOpenGLShaderUniformBufferDeclaration*)rendererBuffers.front())->PushUniform(declaration);
+		return;
+		}
+
+	FakeRef<FakeOpenGLShaderUniformBufferDeclaration> &materialBuffer = domain == FakeShaderDomain::Vertex ? VSMaterialUniformBuffer : FSMaterialUniformBuffer;
+	if (!materialBuffer)
+		materialBuffer.Reset(new FakeOpenGLShaderUniformBufferDeclaration("", domain));
+
+	materialBuffer->PushUniform(declaration);
+	}
+
+void FakeVulkanShader::ParseUniformStruct(uint32 index)
+	{
+	const std::vector<FakeShaderReflectionEntry> &entries = Reflection.GetEntries();
+	const FakeShaderReflectionEntry &entry = entries[index];
+
+	FakeShaderStruct *uniformStruct = DeclarationArena.New<FakeShaderStruct>(Utils::fake_to_string(entry.Name));
+	for (uint32 i = index + 1; i <= index + entry.FieldCount; ++i)
+		{
+		const FakeShaderReflectionEntry &field = entries[i];
+		FakeOpenGLShaderUniformDeclaration::Type type = FakeOpenGLShaderUniformDeclaration::StringToType(Utils::fake_to_string(field.Type));
+		uniformStruct->AddField(DeclarationArena.New<FakeOpenGLShaderUniformDeclaration>(entry.Domain, type, Utils::fake_to_string(field.Name), field.Count));
+		}
+
+	Structs.push_back(uniformStruct);
+	}
+
+FakeShaderStruct *FakeVulkanShader::FindStruct(const FakeString &name)
+	{
+	for (FakeShaderStruct *s : Structs)
+		{
+		if (s->GetName() == name)
+			return s;
+		}
+
+	return nullptr;
+	}
+
+void FakeVulkanShader::BuildLayout()
+	{
+	Uniforms.clear();
+	UniformIndices.clear();
+	Samplers.clear();
+	UniformSize = 0;
+
+	// Samplers get consecutive texture units in declaration order, the same as on OpenGL
+	uint32 unit = 0;
+	for (const FakeShaderReflectionEntry &entry : Reflection.GetEntries())
+		{
+		if (entry.Kind != FakeShaderReflectionKind::Uniform)
+			continue;
+
+		if (!Utils::fake_is_type_string_resource(entry.Type))
+			{
+			AddUniform(entry);
+			continue;
+			}
+
+		std::string name(entry.Name);
+		auto it = std::find_if(Samplers.begin(), Samplers.end(), [&name](const FakeVulkanSamplerBinding &sampler) { return sampler.Name == name; });
+		if (it != Samplers.end())
+			continue;
+
+		FakeVulkanSamplerBinding sampler;
+		sampler.Name = name;
+		sampler.Type = std::string(entry.Type);
+		sampler.Binding = 1 + (uint32)Samplers.size();
+		for (uint32 i = 0; i < entry.Count; ++i)
+			sampler.Units.push_back(unit++);
+
+		Samplers.push_back(std::move(sampler));
+		}
+
+	for (FakeShaderResourceDeclaration *resource : Resources)
+		{
+		for (const FakeVulkanSamplerBinding &sampler : Samplers)
+			{
+			if (sampler.Name == *resource->GetName())
+				((FakeOpenGLResourceDeclaration*)resource)->Register = sampler.Units.front();
+			}
+		}
+
+	UniformSize = Utils::fake_align(UniformSize, 16);
+	UniformData.assign(UniformSize, 0);
+	UniformsDirty = true;
+	}
+
+bool FakeVulkanShader::AddUniform(const FakeShaderReflectionEntry &entry)
+	{
+	std::string name(entry.Name);
+	if (UniformIndices.find(name) != UniformIndices.end())
+		return true;
+
+	FakeVulkanUniform uniform;
+	uniform.Name = name;
+	uniform.Type = std::string(entry.Type);
+	uniform.Count = entry.Count;
+
+	uint32 alignment = 0;
+	uint32 size = 0;
+
+	FakeVulkanUniformField field;
+	if (Utils::fake_uniform_field(entry.Type, field))
+		{
+		alignment = Utils::fake_std140_alignment(field);
+		size = Utils::fake_std140_size(field);
+		uniform.PackedStride = field.PackedSize;
+		uniform.Fields.push_back(field);
+		}
+	else
+		{
+		uint32 structIndex = Reflection.FindStruct(entry.Type, entry.Domain);
+		if (structIndex == FakeShaderReflection::NPOS)
+			{
+			FAKE_LOG_ERROR("Shader %s: unknown type %s of uniform %s!", *Name, uniform.Type.c_str(), name.c_str());
+			return false;
+			}
+
+		// Structs are vec4 aligned and padded to a multiple of 16 bytes
+		const std::vector<FakeShaderReflectionEntry> &entries = Reflection.GetEntries();
+		for (uint32 i = structIndex + 1; i <= structIndex + entries[structIndex].FieldCount; ++i)
+			{
+			FakeVulkanUniformField member;
+			if (!Utils::fake_uniform_field(entries[i].Type, member))
+				{
+				FAKE_LOG_ERROR("Shader %s: nested structs are not supported in uniform %s!", *Name, name.c_str());
+				return false;
+				}
+
+			member.Name = std::string(entries[i].Name);
+			member.Count = entries[i].Count;
+			member.PackedOffset = uniform.PackedStride;
+			uniform.PackedStride += member.PackedSize * member.Count;
+
+			uint32 memberAlignment = Utils::fake_std140_alignment(member);
+			uint32 memberSize = Utils::fake_std140_size(member);
+			if (member.Count > 1)
+				{
+				memberAlignment = Utils::fake_align(memberAlignment, 16);
+				member.Stride = Utils::fake_align(memberSize, 16);
+				memberSize = member.Stride * member.Count;
+				}
+
+			member.Offset = Utils::fake_align(size, memberAlignment);
+			size = member.Offset + memberSize;
+			uniform.Fields.push_back(member);
+			}
+
+		alignment = 16;
+		size = Utils::fake_align(size, 16);
+		}
+
+	// Array elements start on a vec4 boundary
+	if (uniform.Count > 1)
+		{
+		alignment = Utils::fake_align(alignment, 16);
+		size = Utils::fake_align(size, 16);
+		}
+
+	uniform.Stride = size;
+	uniform.Offset = Utils::fake_align(UniformSize, alignment);
+	UniformSize = uniform.Offset + size * uniform.Count;
+
+	UniformIndices.emplace(name, (uint32)Uniforms.size());
+	Uniforms.push_back(std::move(uniform));
+	return true;
+	}
+
+std::string FakeVulkanShader::Rewrite(const FakeShaderStageSource &stage)
+	{
+	const std::string &source = stage.Source;
+	const FakeVulkanContext::Features &features = FakeVulkanContext::GetFeatures();
+	bool vertex = stage.Stage == FakeShaderStage::Vertex;
+	bool fragment = stage.Stage == FakeShaderStage::Fragment;
+
+	std::vector<FakeVulkanSourceEdit> edits;
+	std::vector<const FakeVulkanUniform*> stageUniforms;
+	std::unordered_map<std::string_view, size_t> structEnds;
+	auto position = [&source](std::string_view token) { return (size_t)(token.data() - source.data()); };
+
+	size_t declarationStart = std::string::npos;
+	size_t layoutOpen = std::string::npos;
+	size_t blockPosition = std::string::npos;
+	size_t firstDeclaration = std::string::npos;
+	int64 layoutBinding = -1;
+	bool layoutLocation = false;
+	bool usesInstanceID = false;
+	bool hasMain = false;
+	uint32 depth = 0;
+
+	FakeShaderTokenizer tokenizer(source);
+	for (std::string_view token = tokenizer.Next(); !token.empty(); token = tokenizer.Next())
+		{
+		if (token == "gl_InstanceID" && vertex)
+			{
+			// gl_InstanceIndex counts from the base instance, gl_InstanceID from zero
+			usesInstanceID = true;
+			edits.push_back({ position(token), position(token) + token.size(), features.DrawParameters ? "(gl_InstanceIndex - gl_BaseInstanceARB)" : "(gl_InstanceIndex - FakeDrawConstants.BaseInstance)" });
+			continue;
+			}
+
+		if (token == "gl_VertexID")
+			{
+			edits.push_back({ position(token), position(token) + token.size(), "gl_VertexIndex" });
+			continue;
+			}
+
+		if (token == "{" || token == "}")
+			{
+			depth = token == "{" ? depth + 1 : depth - 1;
+			declarationStart = std::string::npos;
+			layoutOpen = std::string::npos;
+			layoutBinding = -1;
+			layoutLocation = false;
+			continue;
+			}
+
+		if (depth)
+			continue;
+
+		// The parameters of functions are no declarations of the stage interface
+		if (token == "(")
+			{
+			Utils::fake_skip_balanced(tokenizer, '(', ')');
+			continue;
+			}
+
+		if (token == ";")
+			{
+			declarationStart = std::string::npos;
+			layoutOpen = std::string::npos;
+			layoutBinding = -1;
+			layoutLocation = false;
+			continue;
+			}
+
+		if (declarationStart == std::string::npos)
+			declarationStart = position(token);
+
+		if (firstDeclaration == std::string::npos)
+			firstDeclaration = position(token);
+
+		if (token == "layout")
+			{
+			std::string_view open = tokenizer.Next();
+			if (open != "(")
+				continue;
+
+			layoutOpen = position(open);
+			for (std::string_view qualifier = tokenizer.Next(); !qualifier.empty() && qualifier != ")"; qualifier = tokenizer.Next())
+				{
+				if (qualifier == "location")
+					layoutLocation = true;
+
+				if (qualifier == "binding" && tokenizer.Next() == "=")
+					layoutBinding = Utils::fake_parse_number(tokenizer.Next());
+				}
+			}
+		else if (token == "struct")
+			{
+			std::string_view name = tokenizer.Next();
+			if (tokenizer.Peek() != "{")
+				continue;
+
+			tokenizer.Next();
+			Utils::fake_skip_balanced(tokenizer, '{', '}');
+			for (std::string_view end = tokenizer.Next(); !end.empty(); end = tokenizer.Next())
+				{
+				if (end == ";")
+					{
+					structEnds[name] = position(end) + 1;
+					break;
+					}
+				}
+
+			declarationStart = std::string::npos;
+			}
+		else if (token == "uniform")
+			{
+			std::string_view type = tokenizer.Next();
+			while (Utils::fake_is_qualifier(type))
+				type = tokenizer.Next();
+
+			// Uniform blocks are left alone
+			if (tokenizer.Peek() == "{")
+				continue;
+
+			std::string replacement;
+			bool sampler = Utils::fake_is_type_string_resource(type);
+			size_t end = Utils::fake_parse_declarators(tokenizer, source, [&](std::string_view name, uint32 count)
+				{
+				if (sampler)
+					{
+					for (const FakeVulkanSamplerBinding &binding : Samplers)
+						{
+						if (binding.Name != name)
+							continue;
+
+						replacement += "layout(set = 0, binding = " + std::to_string(binding.Binding) + ") uniform " + binding.Type + " " + binding.Name;
+						replacement += binding.Units.size() > 1 ? "[" + std::to_string(binding.Units.size()) + "];\n" : ";\n";
+						}
+
+					return;
+					}
+
+				auto it = UniformIndices.find(std::string(name));
+				if (it != UniformIndices.end())
+					stageUniforms.push_back(&Uniforms[it->second]);
+				});
+
+			edits.push_back({ declarationStart, end, replacement });
+			if (!sampler)
+				blockPosition = std::min(blockPosition, declarationStart);
+
+			declarationStart = std::string::npos;
+			layoutOpen = std::string::npos;
+			}
+		else if (token == "buffer")
+			{
+			if (layoutOpen == std::string::npos || layoutBinding < 0)
+				{
+				FAKE_LOG_ERROR("Shader %s: storage blocks need a binding!", *Name);
+				continue;
+				}
+
+			edits.push_back({ layoutOpen + 1, layoutOpen + 1, "set = 1, " });
+			if (std::find(StorageBindings.begin(), StorageBindings.end(), (uint32)layoutBinding) == StorageBindings.end())
+				StorageBindings.push_back((uint32)layoutBinding);
+			}
+		else if (((token == "out" && vertex) || (token == "in" && fragment)) && !layoutLocation)
+			{
+			std::string_view type = tokenizer.Next();
+			while (Utils::fake_is_qualifier(type))
+				type = tokenizer.Next();
+
+			if (tokenizer.Peek() == "{")
+				continue;
+
+			// The locations are assigned by name, so the outputs of the vertex stage find the inputs of the fragment stage
+			std::string layout;
+			Utils::fake_parse_declarators(tokenizer, source, [&](std::string_view name, uint32 count)
+				{
+				auto it = VaryingLocations.find(std::string(name));
+				if (it == VaryingLocations.end())
+					{
+					it = VaryingLocations.emplace(std::string(name), NextVaryingLocation).first;
+					NextVaryingLocation += Utils::fake_location_count(type) * count;
+					}
+
+				if (layout.empty())
+					layout = "layout(location = " + std::to_string(it->second) + ") ";
+				});
+
+			edits.push_back({ declarationStart, declarationStart, layout });
+			declarationStart = std::string::npos;
+			}
+		else if (token == "main" && vertex && tokenizer.Peek() == "(")
+			{
+			hasMain = true;
+			edits.push_back({ position(token), position(token) + token.size(), "fake_main" });
+			}
+		}
+
+	// The uniform block follows the structs its members use
+	if (!stageUniforms.empty())
+		{
+		for (const FakeVulkanUniform *uniform : stageUniforms)
+			{
+			auto it = structEnds.find(uniform->Type);
+			if (it != structEnds.end())
+				blockPosition = std::max(blockPosition, it->second);
+			}
+
+		std::sort(stageUniforms.begin(), stageUniforms.end(), [](const FakeVulkanUniform *a, const FakeVulkanUniform *b) { return a->Offset < b->Offset; });
+		stageUniforms.erase(std::unique(stageUniforms.begin(), stageUniforms.end()), stageUniforms.end());
+
+		std::string block = "layout(std140, set = 0, binding = 0) uniform FakeUniforms\n\t{\n";
+		for (const FakeVulkanUniform *uniform : stageUniforms)
+			{
+			block += "\tlayout(offset = " + std::to_string(uniform->Offset) + ") " + uniform->Type + " " + uniform->Name;
+			block += uniform->Count > 1 ? "[" + std::to_string(uniform->Count) + "];\n" : ";\n";
+			}
+
+		block += "\t};\n";
+		edits.push_back({ blockPosition, blockPosition, block });
+		}
+
+	if (usesInstanceID && !features.DrawParameters)
+		{
+		BaseInstancePushed = true;
+		size_t at = firstDeclaration == std::string::npos ? source.size() : firstDeclaration;
+		edits.push_back({ at, at, "layout(push_constant) uniform FakePushConstants { int BaseInstance; } FakeDrawConstants;\n" });
+		}
+
+	// Clip space depth is -w to w on OpenGL and 0 to w on Vulkan
+	if (hasMain)
+		edits.push_back({ source.size(), source.size(), "\nvoid main()\n\t{\n\tfake_main();\n\tgl_Position.z = (gl_Position.z + gl_Position.w) * 0.5;\n\t}\n" });
+
+	std::string header;
+	size_t version = source.find("#version");
+	size_t headerEnd = 0;
+	if (version == std::string::npos)
+		header = "#version 450\n";
+	else
+		headerEnd = source.find('\n', version) == std::string::npos ? source.size() : source.find('\n', version) + 1;
+
+	if (usesInstanceID && features.DrawParameters)
+		header += "#extension GL_ARB_shader_draw_parameters : require\n";
+
+	// The header goes in front of everything else inserted at the same position
+	edits.insert(edits.begin(), { headerEnd, headerEnd, header });
+
+	std::stable_sort(edits.begin(), edits.end(), [](const FakeVulkanSourceEdit &a, const FakeVulkanSourceEdit &b)
+		{
+		return a.Begin != b.Begin ? a.Begin < b.Begin : a.End < b.End;
+		});
+
+	std::string result;
+	result.reserve(source.size() + 1024);
+
+	size_t copied = 0;
+	for (const FakeVulkanSourceEdit &edit : edits)
+		{
+		result.append(source, copied, edit.Begin - copied);
+		result += edit.Text;
+		copied = edit.End;
+		}
+
+	result.append(source, copied, std::string::npos);
+	return result;
+	}
+
+void FakeVulkanShader::Compile()
+	{
+	Release();
+	RendererID = FakeVulkanContext::CreateRendererID();
+	StorageBindings.clear();
+	VaryingLocations.clear();
+	NextVaryingLocation = 0;
+	BaseInstancePushed = false;
+
+	// The vertex stage goes first, it assigns the varying locations the fragment stage looks up
+	std::vector<const FakeShaderStageSource*> order;
+	for (FakeShaderStage stage : { FakeShaderStage::Vertex, FakeShaderStage::Fragment, FakeShaderStage::Compute })
+		{
+		for (const FakeShaderStageSource &source : Sources)
+			{
+			if (source.Stage == stage)
+				order.push_back(&source);
+			}
+		}
+
+	VkDevice device = FakeVulkanContext::GetDevice();
+	for (const FakeShaderStageSource *source : order)
+		{
+		std::vector<uint32> spirv;
+		if (!FakeVulkanShaderCompiler::Compile(Rewrite(*source), source->Stage, AssetPath.IsEmpty() ? Name : AssetPath, spirv))
+			{
+			Release();
+			return;
+			}
+
+		VkShaderModuleCreateInfo moduleInfo = {};
+		moduleInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+		moduleInfo.codeSize = spirv.size() * sizeof(uint32);
+		moduleInfo.pCode = spirv.data();
+
+		VkPipelineShaderStageCreateInfo stageInfo = {};
+		stageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+		stageInfo.stage = Utils::fake_vulkan_stage(source->Stage);
+		stageInfo.pName = "main";
+		FAKE_VK_CHECK_RESULT(vkCreateShaderModule(device, &moduleInfo, nullptr, &stageInfo.module));
+		Stages.push_back(stageInfo);
+		}
+
+	std::sort(StorageBindings.begin(), StorageBindings.end());
+	CreateLayouts();
+
+	if (Compute)
+		{
+		VkComputePipelineCreateInfo pipelineInfo = {};
+		pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+		pipelineInfo.stage = Stages.front();
+		pipelineInfo.layout = PipelineLayout;
+		FAKE_VK_CHECK_RESULT(vkCreateComputePipelines(device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &ComputePipeline));
+		}
+
+	Ready = true;
+	}
+
+void FakeVulkanShader::CreateLayouts()
+	{
+	VkDevice device = FakeVulkanContext::GetDevice();
+	VkShaderStageFlags stages = Compute ? VK_SHADER_STAGE_COMPUTE_BIT : VK_SHADER_STAGE_ALL_GRAPHICS;
+
+	// Set 0 holds the uniforms and the samplers, set 1 the storage buffers
+	std::vector<VkDescriptorSetLayoutBinding> bindings;
+	if (UniformSize)
+		bindings.push_back({ 0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1, stages, nullptr });
+
+	for (const FakeVulkanSamplerBinding &sampler : Samplers)
+		bindings.push_back({ sampler.Binding, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, (uint32)sampler.Units.size(), stages, nullptr });
+
+	VkDescriptorSetLayoutCreateInfo setInfo = {};
+	setInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+	setInfo.bindingCount = (uint32)bindings.size();
+	setInfo.pBindings = bindings.data();
+	FAKE_VK_CHECK_RESULT(vkCreateDescriptorSetLayout(device, &setInfo, nullptr, &SetLayouts[0]));
+
+	bindings.clear();
+	for (uint32 binding : StorageBindings)
+		bindings.push_back({ binding, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, stages, nullptr });
+
+	setInfo.bindingCount = (uint32)bindings.size();
+	setInfo.pBindings = bindings.data();
+	FAKE_VK_CHECK_RESULT(vkCreateDescriptorSetLayout(device, &setInfo, nullptr, &SetLayouts[1]));
+
+	VkPushConstantRange pushConstants = { VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(int32) };
+
+	VkPipelineLayoutCreateInfo layoutInfo = {};
+	layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+	layoutInfo.setLayoutCount = 2;
+	layoutInfo.pSetLayouts = SetLayouts;
+	layoutInfo.pushConstantRangeCount = BaseInstancePushed ? 1 : 0;
+	layoutInfo.pPushConstantRanges = &pushConstants;
+	FAKE_VK_CHECK_RESULT(vkCreatePipelineLayout(device, &layoutInfo, nullptr, &PipelineLayout));
+	}
+
+void FakeVulkanShader::Release()
+	{
+	Ready = false;
+	if (!RendererID)
+		return;
+
+	// Pipelines of draws which are still in flight keep using the objects until the GPU is done
+	FakeVulkanRendererAPI::ForgetPipelines(RendererID);
+
+	std::vector<VkShaderModule> modules;
+	for (const VkPipelineShaderStageCreateInfo &stage : Stages)
+		modules.push_back(stage.module);
+
+	VkDescriptorSetLayout setLayouts[2] = { SetLayouts[0], SetLayouts[1] };
+	VkPipelineLayout pipelineLayout = PipelineLayout;
+	VkPipeline computePipeline = ComputePipeline;
+	FakeVulkanContext::DestroyLater([modules, setLayouts, pipelineLayout, computePipeline]()
+		{
+		VkDevice device = FakeVulkanContext::GetDevice();
+		vkDestroyPipeline(device, computePipeline, nullptr);
+		vkDestroyPipelineLayout(device, pipelineLayout, nullptr);
+		vkDestroyDescriptorSetLayout(device, setLayouts[0], nullptr);
+		vkDestroyDescriptorSetLayout(device, setLayouts[1], nullptr);
+		for (VkShaderModule module : modules)
+			vkDestroyShaderModule(device, module, nullptr);
+		});
+
+	Stages.clear();
+	SetLayouts[0] = VK_NULL_HANDLE;
+	SetLayouts[1] = VK_NULL_HANDLE;
+	PipelineLayout = VK_NULL_HANDLE;
+	ComputePipeline = VK_NULL_HANDLE;
+	}
+
+void FakeVulkanShader::SubmitUniform(const FakeString &name, const void *data, uint32 size)
+	{
+	// The value is copied now, the command writes it in order with the draws around it
+	std::vector<Byte> copy((const Byte*)data, (const Byte*)data + size);
+
+	FakeRef<FakeVulkanShader> instance = this;
+	FakeRenderer::Submit([instance, name, copy = std::move(copy)]() mutable
+		{
+		auto it = instance->UniformIndices.find(*name);
+		if (it == instance->UniformIndices.end())
+			{
+			FAKE_LOG_WARN("Could not find uniform '%s' in shader", *name);
+			return;
+			}
+
+		instance->StoreUniform(instance->Uniforms[it->second], copy.data(), (uint32)copy.size());
+		});
+	}
+
+void FakeVulkanShader::SubmitIntegers(const FakeString &name, const int32 *values, uint32 count)
+	{
+	std::vector<int32> copy(values, values + count);
+
+	FakeRef<FakeVulkanShader> instance = this;
+	FakeRenderer::Submit([instance, name, copy = std::move(copy)]() mutable
+		{
+		// Integers set on a sampler choose its texture units, like on OpenGL
+		for (FakeVulkanSamplerBinding &sampler : instance->Samplers)
+			{
+			if (sampler.Name != *name)
+				continue;
+
+			for (uint32 i = 0; i < (uint32)copy.size() && i < (uint32)sampler.Units.size(); ++i)
+				sampler.Units[i] = (uint32)copy[i];
+
+			FakeVulkanRendererAPI::InvalidateBindings();
+			return;
+			}
+
+		auto it = instance->UniformIndices.find(*name);
+		if (it == instance->UniformIndices.end())
+			{
+			FAKE_LOG_WARN("Could not find uniform '%s' in shader", *name);
+			return;
+			}
+
+		instance->StoreUniform(instance->Uniforms[it->second], (const Byte*)copy.data(), (uint32)(copy.size() * sizeof(int32)));
+		});
+	}
+
+void FakeVulkanShader::StoreUniform(const FakeVulkanUniform &uniform, const Byte *data, uint32 size)
+	{
+	// The engine passes the values tightly packed, every field moves to its std140 offset
+	for (uint32 element = 0; element < uniform.Count; ++element)
+		{
+		for (const FakeVulkanUniformField &field : uniform.Fields)
+			{
+			for (uint32 i = 0; i < field.Count; ++i)
+				{
+				uint32 source = element * uniform.PackedStride + field.PackedOffset + i * field.PackedSize;
+				if (source + field.PackedSize > size)
+					return;
+
+				Byte *destination = UniformData.data() + uniform.Offset + element * uniform.Stride + field.Offset + i * field.Stride;
+				Utils::fake_write_element(destination, data + source, field);
+				UniformsDirty = true;
+				}
+			}
+		}
+	}
+
+void FakeVulkanShader::StoreMaterialUniforms(const FakeRef<FakeOpenGLShaderUniformBufferDeclaration> &decl, const Byte *data, uint32 begin, uint32 end)
+	{
+	if (!decl)
+		return;
+
+	// Only the uniforms which overlap the changed bytes are copied
+	const FakeShaderUniformList &declarations = decl->GetUniformDeclarations();
+	for (FakeShaderUniformDeclaration *declaration : declarations)
+		{
+		if (declaration->GetOffset() >= end || declaration->GetOffset() + declaration->GetSize() <= begin)
+			continue;
+
+		auto it = UniformIndices.find(*declaration->GetName());
+		if (it != UniformIndices.end())
+			StoreUniform(Uniforms[it->second], data + declaration->GetOffset(), declaration->GetSize());
+		}
+	}
+
+#endif
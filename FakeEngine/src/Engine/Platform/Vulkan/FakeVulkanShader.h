@@ -0,0 +1,231 @@
+/*****************************************************************
+ * \file   FakeVulkanShader.h
+ * \brief  
+ * 
+ * \author Can Karka
+ * \date   February 2021
+ * 
+ * Copyright (C) 2021 Can Karka
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *********************************************************************/
+
+#pragma once
+
+#include "FakeVulkan.h"
+
+#include "Engine/Core/FakeArena.h"
+#include "Engine/Renderer/FakeShader.h"
+#include "Engine/Renderer/FakeShaderPreprocessor.h"
+#include "Engine/Renderer/FakeShaderReflection.h"
+#include "Engine/Platform/OpenGL/FakeOpenGLShaderUniform.h"
+
+/**
+ *
+ * A sampler of a shader, bound as combined image samplers to set 0.
+ *
+ */
+struct FakeVulkanSamplerBinding
+	{
+	std::string Name;
+	std::string Type;
+	uint32 Binding = 0;
+	std::vector<uint32> Units;	/**< The texture unit of every array element. */
+	};
+
+/**
+ *
+ * One value of a uniform in the std140 layout. Plain uniforms have a single field, structs one per member.
+ *
+ */
+struct FakeVulkanUniformField
+	{
+	std::string Name;
+	uint32 Offset = 0;			/**< The std140 offset in one element of the uniform. */
+	uint32 PackedOffset = 0;	/**< The offset in the tightly packed data the engine passes in. */
+	uint32 PackedSize = 0;
+	uint32 Components = 1;
+	uint32 Columns = 1;
+	uint32 Count = 1;
+	uint32 Stride = 0;
+	bool Boolean = false;
+	};
+
+/**
+ *
+ * A loose uniform of the GLSL source, which became a member of the uniform block of the shader.
+ *
+ */
+struct FakeVulkanUniform
+	{
+	std::string Name;
+	std::string Type;
+	uint32 Offset = 0;
+	uint32 Count = 1;
+	uint32 Stride = 0;
+	uint32 PackedStride = 0;
+	std::vector<FakeVulkanUniformField> Fields;
+	};
+
+/**
+ *
+ * The Vulkan implementation of FakeShader.
+ *
+ * The engine's shaders are written for OpenGL, so every stage is rewritten before shaderc compiles it:
+ * - Loose uniforms become members of one std140 block at set 0, binding 0, with the same offsets in every stage.
+ * - Samplers are bound to set 0 from binding 1 on, storage buffers keep their binding in set 1.
+ * - Varyings without a location get one by name, so the stages match.
+ * - gl_InstanceID, gl_VertexID and the clip space depth are translated to their Vulkan counterparts.
+ *
+ * Uniform values are kept on the CPU and copied into the uniform memory of the frame whenever a draw uses them.
+ *
+ */
+class FakeVulkanShader : public FakeShader
+	{
+	private:
+
+		FakeRendererID RendererID = 0;
+		bool Ready = false;
+		bool Compute = false;
+		bool BaseInstancePushed = false;
+
+		FakeString Name = "Undefined";
+		FakeString AssetPath;
+		std::vector<FakeShaderStageSource> Sources;
+		std::vector<FakeShaderReloadedCallback> ShaderReloadedCallbacks;
+
+		FakeShaderUniformBufferList VSRendererUniformBuffers;
+		FakeShaderUniformBufferList FSRendererUniformBuffers;
+		FakeRef<FakeOpenGLShaderUniformBufferDeclaration> VSMaterialUniformBuffer;
+		FakeRef<FakeOpenGLShaderUniformBufferDeclaration> FSMaterialUniformBuffer;
+		FakeShaderResourceList Resources;
+		FakeShaderStructList Structs;
+
+		FakeArena DeclarationArena;
+		FakeShaderReflection Reflection;
+		FakeShaderDefineList Defines;
+
+		std::vector<FakeVulkanUniform> Uniforms;
+		std::unordered_map<std::string, uint32> UniformIndices;
+		std::vector<FakeVulkanSamplerBinding> Samplers;
+		std::vector<uint32> StorageBindings;
+		std::unordered_map<std::string, uint32> VaryingLocations;
+		uint32 NextVaryingLocation = 0;
+
+		// The values of all uniforms in the std140 layout, the last copy is reused until they change
+		std::vector<Byte> UniformData;
+		uint32 UniformSize = 0;
+		bool UniformsDirty = true;
+		uint32 SnapshotFrame = ~0u;
+		VkBuffer SnapshotBuffer = VK_NULL_HANDLE;
+		uint32 SnapshotOffset = 0;
+
+		std::vector<VkPipelineShaderStageCreateInfo> Stages;
+		VkDescriptorSetLayout SetLayouts[2] = {};
+		VkPipelineLayout PipelineLayout = VK_NULL_HANDLE;
+		VkPipeline ComputePipeline = VK_NULL_HANDLE;
+
+	private:
+
+		void Load(const FakeString &source);
+		void LoadStages();
+		void Parse();
+		void ParseUniform(const FakeShaderReflectionEntry &entry);
+		void ParseUniformStruct(uint32 index);
+		FakeShaderStruct *FindStruct(const FakeString &name);
+
+		void BuildLayout();
+		bool AddUniform(const FakeShaderReflectionEntry &entry);
+		std::string Rewrite(const FakeShaderStageSource &stage);
+		void Compile();
+		void CreateLayouts();
+		void Release();
+
+		void SubmitUniform(const FakeString &name, const void *data, uint32 size);
+		void SubmitIntegers(const FakeString &name, const int32 *values, uint32 count);
+		void StoreUniform(const FakeVulkanUniform &uniform, const Byte *data, uint32 size);
+		void StoreMaterialUniforms(const FakeRef<FakeOpenGLShaderUniformBufferDeclaration> &decl, const Byte *data, uint32 begin, uint32 end);
+
+	public:
+
+		FakeVulkanShader() = default;
+		FakeVulkanShader(const FakeString &filePath, const FakeShaderDefineList &defines);
+		FakeVulkanShader(const FakeString &name, const FakeString &vertexSrc, const FakeString &fragmentSrc);
+		virtual ~FakeVulkanShader();
+
+		static FakeRef<FakeVulkanShader> CreateFromString(const FakeString &name, const FakeString &source);
+
+		virtual void Bind() const override;
+		virtual void Unbind() const override;
+		virtual void Reload() override;
+		virtual void FinishCompilation() override {}
+
+		virtual FakeRendererID GetRendererID() const override { return RendererID; }
+		virtual const FakeString &GetName() const override { return Name; }
+		virtual void AddShaderReloadedCallback(const FakeShaderReloadedCallback &callback) override { ShaderReloadedCallbacks.push_back(callback); }
+		virtual void UploadUniformBuffer(const FakeUniformBufferBase &uniformBuffer) override;
+
+		virtual void SetVSMaterialUniformBuffer(FakeAllocator buffer) override;
+		virtual void SetFSMaterialUniformBuffer(FakeAllocator buffer) override;
+		virtual void SetMaterialUniformRange(FakeShaderDomain domain, FakeAllocator buffer, uint32 begin, uint32 end) const override;
+		virtual const FakeShaderUniformBufferList &GetVSRendererUniforms() const override { return VSRendererUniformBuffers; }
+		virtual const FakeShaderUniformBufferList &GetFSRendererUniforms() const override { return FSRendererUniformBuffers; }
+		virtual bool HasVSMaterialUniformBuffer() const override { return (bool)VSMaterialUniformBuffer; }
+		virtual bool HasFSMaterialUniformBuffer() const override { return (bool)FSMaterialUniformBuffer; }
+		virtual const FakeShaderUniformBufferDeclaration &GetVSMaterialUniformBuffer() const override { return *VSMaterialUniformBuffer; }
+		virtual const FakeShaderUniformBufferDeclaration &GetFSMaterialUniformBuffer() const override { return *FSMaterialUniformBuffer; }
+		virtual const FakeShaderResourceList &GetResources() const override { return Resources; }
+
+		virtual void SetUniform(const FakeString &name, const void *data, uint32 size) override { SubmitUniform(name, data, size); }
+		virtual void SetUniform(const FakeString &name, float value) override { SubmitUniform(name, &value, sizeof(float)); }
+		virtual void SetUniform(const FakeString &name, int32 value) override { SubmitIntegers(name, &value, 1); }
+		virtual void SetUniform(const FakeString &name, const FakeMat2f &value) override { SubmitUniform(name, &value, sizeof(FakeMat2f)); }
+		virtual void SetUniform(const FakeString &name, const FakeMat3f &value) override { SubmitUniform(name, &value, sizeof(FakeMat3f)); }
+		virtual void SetUniform(const FakeString &name, const FakeMat4f &value) override { SubmitUniform(name, &value, sizeof(FakeMat4f)); }
+		virtual void SetUniform(const FakeString &name, const FakeVec2f &value) override { SubmitUniform(name, &value, sizeof(FakeVec2f)); }
+		virtual void SetUniform(const FakeString &name, const FakeVec3f &value) override { SubmitUniform(name, &value, sizeof(FakeVec3f)); }
+		virtual void SetUniform(const FakeString &name, const FakeVec4f &value) override { SubmitUniform(name, &value, sizeof(FakeVec4f)); }
+		virtual void SetUniform(const FakeString &name, const FakeVec2i &value) override { SubmitUniform(name, &value, sizeof(FakeVec2i)); }
+		virtual void SetUniform(const FakeString &name, const FakeVec3i &value) override { SubmitUniform(name, &value, sizeof(FakeVec3i)); }
+		virtual void SetUniform(const FakeString &name, const FakeVec4i &value) override { SubmitUniform(name, &value, sizeof(FakeVec4i)); }
+		virtual void SetUniform(const FakeString &name, int32 *value, uint32 size) override { SubmitIntegers(name, value, size); }
+		virtual void SetUniform(const FakeString &name, float *value, uint32 size) override { SubmitUniform(name, value, size * sizeof(float)); }
+		virtual void SetUniform(const FakeString &name, const FakeMat4f &values, uint32 count) override { SubmitUniform(name, &values, count * sizeof(FakeMat4f)); }
+		virtual void SetUniform(const FakeString &name, int32 v0, int32 v1) override { SetUniform(name, FakeVec2i(v0, v1)); }
+		virtual void SetUniform(const FakeString &name, int32 v0, int32 v1, int32 v2) override { SetUniform(name, FakeVec3i(v0, v1, v2)); }
+		virtual void SetUniform(const FakeString &name, int32 v0, int32 v1, int32 v2, int32 v3) override { SetUniform(name, FakeVec4i(v0, v1, v2, v3)); }
+		virtual void SetUniform(const FakeString &name, float v0, float v1) override { SetUniform(name, FakeVec2f(v0, v1)); }
+		virtual void SetUniform(const FakeString &name, float v0, float v1, float v2) override { SetUniform(name, FakeVec3f(v0, v1, v2)); }
+		virtual void SetUniform(const FakeString &name, float v0, float v1, float v2, float v3) override { SetUniform(name, FakeVec4f(v0, v1, v2, v3)); }
+
+		/**
+		 *
+		 * Copies the current uniform values into the uniform memory of the frame.
+		 *
+		 * @param outBuffer Receives the buffer the values were copied to.
+		 * @return Returns the dynamic offset of the copy.
+		 */
+		uint32 SnapshotUniforms(VkBuffer &outBuffer);
+
+		const std::vector<FakeVulkanSamplerBinding> &GetSamplers() const { return Samplers; }
+		const std::vector<uint32> &GetStorageBindings() const { return StorageBindings; }
+		const std::vector<VkPipelineShaderStageCreateInfo> &GetStages() const { return Stages; }
+		VkDescriptorSetLayout GetSetLayout(uint32 set) const { return SetLayouts[set]; }
+		VkPipelineLayout GetPipelineLayout() const { return PipelineLayout; }
+		VkPipeline GetComputePipeline() const { return ComputePipeline; }
+		uint32 GetUniformSize() const { return UniformSize; }
+
+		bool IsReady() const { return Ready; }
+		bool IsCompute() const { return Compute; }
+		bool PushesBaseInstance() const { return BaseInstancePushed; }
+	};
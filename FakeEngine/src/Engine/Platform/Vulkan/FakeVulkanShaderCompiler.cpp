@@ -0,0 +1,73 @@
+#include "FakePch.h"
+#include "FakeVulkanShaderCompiler.h"
+
+#ifdef FAKE_RENDERER_VULKAN
+
+#include <shaderc/shaderc.hpp>
+
+struct FakeVulkanShaderCompilerData
+	{
+	Scope<shaderc::Compiler> Compiler;
+	std::unordered_map<std::string, std::vector<uint32>> Cache;
+	};
+
+static FakeVulkanShaderCompilerData Data;
+
+namespace Utils
+	{
+	static shaderc_shader_kind fake_shader_kind_from_stage(FakeShaderStage stage)
+		{
+		switch (stage)
+			{
+			case FakeShaderStage::Vertex:   return shaderc_vertex_shader;
+			case FakeShaderStage::Fragment: return shaderc_fragment_shader;
+			case FakeShaderStage::Compute:  return shaderc_compute_shader;
+			}
+
+		FAKE_ASSERT(false, "Unknown shader stage!");
+		return shaderc_glsl_infer_from_source;
+		}
+	}
+
+bool FakeVulkanShaderCompiler::Compile(const std::string &source, FakeShaderStage stage, const FakeString &name, std::vector<uint32> &outSpirv)
+	{
+	// The stage is part of the key, the same source may be compiled as two stages
+	std::string key = source;
+	key.push_back((char)stage);
+
+	auto it = Data.Cache.find(key);
+	if (it != Data.Cache.end())
+		{
+		outSpirv = it->second;
+		return true;
+		}
+
+	if (!Data.Compiler)
+		Data.Compiler = CreateScope<shaderc::Compiler>();
+
+	shaderc::CompileOptions options;
+	options.SetTargetEnvironment(shaderc_target_env_vulkan, shaderc_env_version_vulkan_1_1);
+	options.SetOptimizationLevel(shaderc_optimization_level_performance);
+
+	// Vertex inputs and fragment outputs without a location, everything else has one after the rewrite
+	options.SetAutoMapLocations(true);
+
+	shaderc::SpvCompilationResult result = Data.Compiler->CompileGlslToSpv(source, Utils::fake_shader_kind_from_stage(stage), *name, options);
+	if (result.GetCompilationStatus() != shaderc_compilation_status_success)
+		{
+		FAKE_LOG_ERROR("Shader compilation failed %s:\n%s", *name, result.GetErrorMessage().c_str());
+		return false;
+		}
+
+	outSpirv.assign(result.cbegin(), result.cend());
+	Data.Cache.emplace(std::move(key), outSpirv);
+	return true;
+	}
+
+void FakeVulkanShaderCompiler::Shutdown()
+	{
+	Data.Cache.clear();
+	Data.Compiler.reset();
+	}
+
+#endif
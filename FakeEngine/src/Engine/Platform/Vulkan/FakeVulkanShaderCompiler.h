@@ -0,0 +1,57 @@
+/*****************************************************************
+ * \file   FakeVulkanShaderCompiler.h
+ * \brief  
+ * 
+ * \author Can Karka
+ * \date   February 2021
+ * 
+ * Copyright (C) 2021 Can Karka
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *********************************************************************/
+
+#pragma once
+
+#include "Engine/Renderer/FakeShaderPreprocessor.h"
+
+/**
+ *
+ * Compiles the GLSL of the Vulkan backend to SPIR-V with shaderc.
+ *
+ * Sources which were compiled before are not compiled again, shader variants and reloads of unchanged files
+ * share the SPIR-V of the first compile.
+ *
+ */
+class FakeVulkanShaderCompiler
+	{
+	public:
+
+		/**
+		 *
+		 * Compiles one stage of a shader.
+		 *
+		 * @param source The GLSL source, already rewritten for Vulkan.
+		 * @param stage The stage of the source.
+		 * @param name The name of the shader, used in error messages.
+		 * @param outSpirv Receives the SPIR-V words.
+		 * @return Returns false and logs the errors if the source does not compile.
+		 */
+		static bool Compile(const std::string &source, FakeShaderStage stage, const FakeString &name, std::vector<uint32> &outSpirv);
+
+		/**
+		 *
+		 * Frees the compiler and all cached SPIR-V.
+		 *
+		 */
+		static void Shutdown();
+	};
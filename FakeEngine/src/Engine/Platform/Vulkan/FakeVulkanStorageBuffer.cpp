@@ -0,0 +1,64 @@
+#include "FakePch.h"
+#include "FakeVulkanStorageBuffer.h"
+
+#ifdef FAKE_RENDERER_VULKAN
+
+#include "Engine/Renderer/FakeRenderer.h"
+#include "FakeVulkanContext.h"
+#include "FakeVulkanRendererAPI.h"
+
+FakeVulkanStorageBuffer::FakeVulkanStorageBuffer(uint32 size)
+	: Size(size)
+	{
+	VkBufferUsageFlags usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT
+		| VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+
+	RendererID = FakeVulkanContext::CreateRendererID();
+	FakeVulkanContext::CreateBuffer(Size, usage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, Buffer, Memory);
+
+	// Storage starts out undefined, shaders may read parts nobody has written yet
+	VkBuffer buffer = Buffer;
+	FakeVulkanRendererAPI::Upload([buffer](VkCommandBuffer commandBuffer)
+		{
+		vkCmdFillBuffer(commandBuffer, buffer, 0, VK_WHOLE_SIZE, 0);
+		});
+	}
+
+FakeVulkanStorageBuffer::~FakeVulkanStorageBuffer()
+	{
+	VkBuffer buffer = Buffer;
+	VkDeviceMemory memory = Memory;
+	FakeVulkanContext::DestroyLater([buffer, memory]()
+		{
+		vkDestroyBuffer(FakeVulkanContext::GetDevice(), buffer, nullptr);
+		vkFreeMemory(FakeVulkanContext::GetDevice(), memory, nullptr);
+		});
+	}
+
+void FakeVulkanStorageBuffer::SetData(const void *data, uint32 size, uint32 offset)
+	{
+	FAKE_ASSERT(offset + size <= Size, "Data does not fit into the storage buffer!");
+
+	// The command owns its copy and frees it afterwards
+	std::vector<Byte> copy((const Byte*)data, (const Byte*)data + size);
+
+	FakeRef<FakeVulkanStorageBuffer> instance = this;
+	FakeRenderer::Submit([instance, copy = std::move(copy), offset]()
+		{
+		FakeVulkanRendererAPI::WriteBuffer(instance->Buffer, offset, copy.data(), (uint32)copy.size(), false);
+		});
+	}
+
+void FakeVulkanStorageBuffer::Bind(uint32 binding) const
+	{
+	FakeRef<const FakeVulkanStorageBuffer> instance = this;
+	FakeRenderer::Submit([instance, binding]() { FakeVulkanRendererAPI::BindStorageBuffer(binding, instance->Buffer); });
+	}
+
+void FakeVulkanStorageBuffer::BindIndirect() const
+	{
+	FakeRef<const FakeVulkanStorageBuffer> instance = this;
+	FakeRenderer::Submit([instance]() { FakeVulkanRendererAPI::BindIndirectBuffer(instance->Buffer); });
+	}
+
+#endif
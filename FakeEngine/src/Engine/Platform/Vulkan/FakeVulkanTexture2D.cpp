@@ -0,0 +1,304 @@
+#include "FakePch.h"
+#include "FakeVulkanTexture2D.h"
+
+#ifdef FAKE_RENDERER_VULKAN
+
+#include <stb_image.h>
+
+#include "Engine/Renderer/FakeRenderer.h"
+#include "Engine/Core/FakeVirtualFileSystem.h"
+#include "FakeVulkanContext.h"
+#include "FakeVulkanRendererAPI.h"
+
+namespace Utils
+	{
+	static VkFormat fake_to_vulkan_texture_format(FakeTextureFormat format)
+		{
+		switch (format)
+			{
+			// Three channel formats are rarely supported for sampling, RGB pixels get an alpha channel on upload
+			case FakeTextureFormat::RGB:     return VK_FORMAT_R8G8B8A8_UNORM;
+			case FakeTextureFormat::RGBA:    return VK_FORMAT_R8G8B8A8_UNORM;
+			case FakeTextureFormat::Float16: return VK_FORMAT_R16G16B16A16_SFLOAT;
+			}
+
+		FAKE_ASSERT(false);
+		return VK_FORMAT_UNDEFINED;
+		}
+
+	static uint32 fake_pixel_size(VkFormat format)
+		{
+		switch (format)
+			{
+			case VK_FORMAT_R16G16B16A16_SFLOAT:  return 8;
+			case VK_FORMAT_R32G32B32A32_SFLOAT:  return 16;
+			}
+
+		return 4;
+		}
+
+	// The size of a pixel as the engine writes it, RGB pixels are expanded while they are copied
+	static uint32 fake_source_pixel_size(FakeTextureFormat format, VkFormat imageFormat)
+		{
+		return format == FakeTextureFormat::RGB ? 3 : fake_pixel_size(imageFormat);
+		}
+
+	static void fake_transition_levels(VkCommandBuffer commandBuffer, VkImage image, uint32 baseLevel, uint32 levelCount, VkImageLayout oldLayout, VkImageLayout newLayout)
+		{
+		VkImageMemoryBarrier barrier = {};
+		barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		barrier.srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+		barrier.oldLayout = oldLayout;
+		barrier.newLayout = newLayout;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.image = image;
+		barrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, baseLevel, levelCount, 0, 1 };
+		vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+		}
+	}
+
+FakeVulkanTexture2D::FakeVulkanTexture2D(const FakeString &path, bool srgb, FakeTextureWrap wrap)
+	: RendererID(FakeVulkanContext::CreateRendererID()), Wrap(wrap), FilePath(path)
+	{
+	Name = FakeVirtualFileSystem::Get()->GetFileNameFromPath(path);
+	stbi_set_flip_vertically_on_load(1);
+
+	// Always four channels, the pixels go straight into the staging memory
+	int32 width, height, channels;
+	Byte *pixels = nullptr;
+	if (stbi_is_hdr(*path))
+		{
+		FAKE_LOG_INFO("Loading HDR texture %s, srgb=%d", *path, srgb);
+		pixels = (Byte*)stbi_loadf(*path, &width, &height, &channels, STBI_rgb_alpha);
+		Format = FakeTextureFormat::Float16;
+		ImageFormat = VK_FORMAT_R32G32B32A32_SFLOAT;
+		}
+	else
+		{
+		FAKE_LOG_INFO("Loading texture %s, srgb=%d", *path, srgb);
+		pixels = stbi_load(*path, &width, &height, &channels, STBI_rgb_alpha);
+		FAKE_ASSERT(pixels, "Could not read image!");
+		Format = FakeTextureFormat::RGBA;
+		ImageFormat = srgb ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM;
+		}
+
+	if (!pixels)
+		return;
+
+	IsLoaded = true;
+	Width = width;
+	Height = height;
+	MipLevels = FakeTexture::CalculateMipLevelCount(Width, Height);
+
+	CreateImage(true);
+	RecordUpload(pixels, true);
+	stbi_image_free(pixels);
+	}
+
+FakeVulkanTexture2D::FakeVulkanTexture2D(FakeTextureFormat format, uint32 width, uint32 height, FakeTextureWrap wrap)
+	: RendererID(FakeVulkanContext::CreateRendererID()), Format(format), Wrap(wrap), Width(width), Height(height), FilePath(""), Name("Undefined")
+	{
+	ImageFormat = Utils::fake_to_vulkan_texture_format(Format);
+	CreateImage(false);
+
+	ImageData.Allocate(width * height * FakeTexture::GetBPP(Format));
+	}
+
+FakeVulkanTexture2D::~FakeVulkanTexture2D()
+	{
+	delete[] ImageData.Data;
+
+	VkImage image = Image;
+	VkDeviceMemory memory = Memory;
+	VkImageView view = View;
+	VkSampler sampler = Sampler;
+	FakeVulkanContext::DestroyLater([image, memory, view, sampler]()
+		{
+		VkDevice device = FakeVulkanContext::GetDevice();
+		vkDestroySampler(device, sampler, nullptr);
+		vkDestroyImageView(device, view, nullptr);
+		vkDestroyImage(device, image, nullptr);
+		vkFreeMemory(device, memory, nullptr);
+		});
+	}
+
+void FakeVulkanTexture2D::CreateImage(bool filtered)
+	{
+	VkDevice device = FakeVulkanContext::GetDevice();
+
+	VkImageCreateInfo imageInfo = {};
+	imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+	imageInfo.imageType = VK_IMAGE_TYPE_2D;
+	imageInfo.format = ImageFormat;
+	imageInfo.extent = { Width, Height, 1 };
+	imageInfo.mipLevels = MipLevels;
+	imageInfo.arrayLayers = 1;
+	imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+	imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+	imageInfo.usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+	imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+	FakeVulkanContext::CreateImage(imageInfo, Image, Memory);
+
+	VkImageViewCreateInfo viewInfo = {};
+	viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+	viewInfo.image = Image;
+	viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+	viewInfo.format = ImageFormat;
+	viewInfo.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, MipLevels, 0, 1 };
+	FAKE_VK_CHECK_RESULT(vkCreateImageView(device, &viewInfo, nullptr, &View));
+
+	// Same filters as the OpenGL backend, images from files are smooth, images written by the engine keep their texels
+	VkSamplerAddressMode addressMode = (filtered || Wrap == FakeTextureWrap::Clamp) ? VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE : VK_SAMPLER_ADDRESS_MODE_REPEAT;
+
+	VkSamplerCreateInfo samplerInfo = {};
+	samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+	samplerInfo.magFilter = filtered ? VK_FILTER_LINEAR : VK_FILTER_NEAREST;
+	samplerInfo.minFilter = filtered ? VK_FILTER_LINEAR : VK_FILTER_NEAREST;
+	samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+	samplerInfo.addressModeU = addressMode;
+	samplerInfo.addressModeV = addressMode;
+	samplerInfo.addressModeW = addressMode;
+	samplerInfo.maxLod = (float)MipLevels;
+	if (!filtered && FakeVulkanContext::GetFeatures().SamplerAnisotropy)
+		{
+		samplerInfo.anisotropyEnable = VK_TRUE;
+		samplerInfo.maxAnisotropy = FakeVulkanContext::GetProperties().limits.maxSamplerAnisotropy;
+		}
+
+	FAKE_VK_CHECK_RESULT(vkCreateSampler(device, &samplerInfo, nullptr, &Sampler));
+
+	// Sampling an image which has not been written yet reads undefined texels, but never from an undefined layout
+	VkImage image = Image;
+	FakeVulkanRendererAPI::Upload([image](VkCommandBuffer commandBuffer)
+		{
+		FakeVulkanRendererAPI::TransitionImage(commandBuffer, image, VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+		});
+	}
+
+void FakeVulkanTexture2D::RecordUpload(const void *pixels, bool upload)
+	{
+	uint32 pixelCount = Width * Height;
+	uint32 pixelSize = Utils::fake_pixel_size(ImageFormat);
+
+	VkBuffer staging = VK_NULL_HANDLE;
+	VkDeviceSize stagingOffset = 0;
+	Byte *memory = (Byte*)FakeVulkanRendererAPI::AllocateStaging(pixelCount * pixelSize, staging, stagingOffset);
+
+	if (Format == FakeTextureFormat::RGB)
+		{
+		const Byte *source = (const Byte*)pixels;
+		for (uint32 i = 0; i < pixelCount; ++i)
+			{
+			memcpy(memory + i * 4, source + i * 3, 3);
+			memory[i * 4 + 3] = 0xff;
+			}
+		}
+	else
+		{
+		memcpy(memory, pixels, pixelCount * pixelSize);
+		}
+
+	VkImage image = Image;
+	uint32 width = Width;
+	uint32 height = Height;
+	uint32 mipLevels = MipLevels;
+	auto record = [image, staging, stagingOffset, width, height, mipLevels](VkCommandBuffer commandBuffer)
+		{
+		FakeVulkanRendererAPI::TransitionImage(commandBuffer, image, VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+
+		VkBufferImageCopy region = {};
+		region.bufferOffset = stagingOffset;
+		region.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
+		region.imageExtent = { width, height, 1 };
+		vkCmdCopyBufferToImage(commandBuffer, staging, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+
+		// Every level is blitted from the one above, which is moved to a transfer source first
+		int32 levelWidth = (int32)width;
+		int32 levelHeight = (int32)height;
+		for (uint32 level = 1; level < mipLevels; ++level)
+			{
+			Utils::fake_transition_levels(commandBuffer, image, level - 1, 1, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+
+			VkImageBlit blit = {};
+			blit.srcSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, level - 1, 0, 1 };
+			blit.srcOffsets[1] = { levelWidth, levelHeight, 1 };
+			levelWidth = std::max(levelWidth / 2, 1);
+			levelHeight = std::max(levelHeight / 2, 1);
+			blit.dstSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, level, 0, 1 };
+			blit.dstOffsets[1] = { levelWidth, levelHeight, 1 };
+			vkCmdBlitImage(commandBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &blit, VK_FILTER_LINEAR);
+			}
+
+		if (mipLevels > 1)
+			Utils::fake_transition_levels(commandBuffer, image, 0, mipLevels - 1, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+		Utils::fake_transition_levels(commandBuffer, image, mipLevels - 1, 1, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+		};
+
+	if (upload)
+		FakeVulkanRendererAPI::Upload(record);
+	else
+		FakeVulkanRendererAPI::Record(record);
+	}
+
+void FakeVulkanTexture2D::UploadPixels(const void *pixels)
+	{
+	RecordUpload(pixels, true);
+	}
+
+void FakeVulkanTexture2D::Bind(uint32 slot) const
+	{
+	FakeRef<const FakeVulkanTexture2D> instance = this;
+	FakeRenderer::Submit([instance, slot]()
+		{
+		FakeVulkanRendererAPI::BindTexture(slot, instance->View, instance->Sampler);
+		});
+	}
+
+void FakeVulkanTexture2D::Lock()
+	{
+	IsLocked = true;
+	}
+
+void FakeVulkanTexture2D::Unlock()
+	{
+	IsLocked = false;
+	if (ImageData.Size < Width * Height * Utils::fake_source_pixel_size(Format, ImageFormat))
+		{
+		FAKE_LOG_ERROR("Texture %s holds %d bytes, too few for its %dx%d pixels!", *Name, ImageData.Size, Width, Height);
+		return;
+		}
+
+	FakeRef<FakeVulkanTexture2D> instance = this;
+	FakeRenderer::Submit([instance]() mutable
+		{
+		instance->RecordUpload(instance->ImageData.Data, false);
+		});
+	}
+
+void FakeVulkanTexture2D::Resize(uint32 width, uint32 height)
+	{
+	FAKE_ASSERT(IsLocked);
+	ImageData.Allocate(width * height * FakeTexture::GetBPP(Format));
+
+#ifdef FAKE_DEBUG
+	ImageData.ZeroInitialize();
+#endif
+	}
+
+FakeAllocator FakeVulkanTexture2D::GetWriteableBuffer()
+	{
+	FAKE_ASSERT(IsLocked, "Texture must be locked!");
+	return ImageData;
+	}
+
+void FakeVulkanTexture2D::SetData(void *data, uint32 size)
+	{
+	FAKE_ASSERT(IsLocked, "Texture must be locked!");
+	ImageData.Allocate(size);
+	memcpy(ImageData.Data, data, size);
+	}
+
+#endif
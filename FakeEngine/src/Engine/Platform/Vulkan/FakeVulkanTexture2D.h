@@ -0,0 +1,96 @@
+/*****************************************************************
+ * \file   FakeVulkanTexture2D.h
+ * \brief  
+ * 
+ * \author Can Karka
+ * \date   February 2021
+ * 
+ * Copyright (C) 2021 Can Karka
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *********************************************************************/
+
+#pragma once
+
+#include "FakeVulkan.h"
+
+#include "Engine/Renderer/FakeTexture2D.h"
+
+/**
+ *
+ * The Vulkan implementation of FakeTexture2D. The image stays in VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+ * uploads move it out and back again. Textures loaded from files get a full mip chain, blitted on the GPU.
+ *
+ */
+class FakeVulkanTexture2D : public FakeTexture2D
+	{
+	private:
+
+		FakeRendererID RendererID = 0;
+		FakeAllocator ImageData;
+		FakeTextureFormat Format;
+		FakeTextureWrap Wrap = FakeTextureWrap::Clamp;
+		uint32 Width = 0, Height = 0;
+		uint32 MipLevels = 1;
+		bool IsLocked = false;
+		bool IsLoaded = false;
+		FakeString FilePath, Name;
+
+		VkFormat ImageFormat = VK_FORMAT_UNDEFINED;
+		VkImage Image = VK_NULL_HANDLE;
+		VkDeviceMemory Memory = VK_NULL_HANDLE;
+		VkImageView View = VK_NULL_HANDLE;
+		VkSampler Sampler = VK_NULL_HANDLE;
+
+		void CreateImage(bool filtered);
+		void RecordUpload(const void *pixels, bool upload);
+
+	public:
+
+		FakeVulkanTexture2D(const FakeString &path, bool srgb = false, FakeTextureWrap wrap = FakeTextureWrap::Clamp);
+		FakeVulkanTexture2D(FakeTextureFormat format, uint32 width, uint32 height, FakeTextureWrap wrap = FakeTextureWrap::Clamp);
+		virtual ~FakeVulkanTexture2D();
+
+		virtual void Bind(uint32 slot = 0) const override;
+		virtual void Unbind() const override {}
+
+		virtual void Lock() override;
+		virtual void Unlock() override;
+		virtual void Resize(uint32 width, uint32 height) override;
+		virtual FakeAllocator GetWriteableBuffer() override;
+		virtual void SetData(void *data, uint32 size) override;
+
+		virtual bool Loaded() const override { return IsLoaded; }
+		virtual const FakeString &GetName() const override { return Name; }
+		virtual const FakeString &GetPath() const override { return FilePath; }
+		virtual FakeTextureFormat GetFormat() const override { return Format; }
+		virtual uint32 GetWidth() const override { return Width; }
+		virtual uint32 GetHeight() const override { return Height; }
+		virtual uint32 GetMipLevelCount() const override { return MipLevels; }
+		virtual FakeRendererID GetRendererID() const override { return RendererID; }
+
+		virtual bool operator==(const FakeTexture &other) const override { return RendererID == other.GetRendererID(); }
+		virtual bool operator!=(const FakeTexture &other) const override { return RendererID != other.GetRendererID(); }
+
+		/**
+		 *
+		 * Uploads all pixels at the start of the next submitted frame, without going through the render command queue.
+		 * Used by the backend itself, for textures it needs before the first frame.
+		 *
+		 * @param pixels Width * Height pixels in the format of the texture.
+		 */
+		void UploadPixels(const void *pixels);
+
+		VkImageView GetImageView() const { return View; }
+		VkSampler GetSampler() const { return Sampler; }
+	};
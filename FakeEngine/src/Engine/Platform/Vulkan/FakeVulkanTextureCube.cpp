@@ -0,0 +1,211 @@
+#include "FakePch.h"
+#include "FakeVulkanTextureCube.h"
+
+#ifdef FAKE_RENDERER_VULKAN
+
+#include <stb_image.h>
+
+#include "Engine/Renderer/FakeRenderer.h"
+#include "Engine/Core/FakeVirtualFileSystem.h"
+#include "FakeVulkanContext.h"
+#include "FakeVulkanRendererAPI.h"
+
+// The cell of every layer in the cross, in the layer order of Vulkan: +X, -X, +Y, -Y, +Z, -Z
+static const uint32 CrossCells[6][2] = { { 2, 1 }, { 0, 1 }, { 1, 0 }, { 1, 2 }, { 1, 1 }, { 3, 1 } };
+
+namespace Utils
+	{
+	static VkFormat fake_to_vulkan_cube_texture_format(FakeTextureFormat format)
+		{
+		switch (format)
+			{
+			case FakeTextureFormat::RGB:     return VK_FORMAT_R8G8B8A8_UNORM;
+			case FakeTextureFormat::RGBA:    return VK_FORMAT_R8G8B8A8_UNORM;
+			case FakeTextureFormat::Float16: return VK_FORMAT_R16G16B16A16_SFLOAT;
+			}
+
+		FAKE_ASSERT(false);
+		return VK_FORMAT_UNDEFINED;
+		}
+
+	static void fake_transition_levels(VkCommandBuffer commandBuffer, VkImage image, uint32 baseLevel, uint32 levelCount, VkImageLayout oldLayout, VkImageLayout newLayout)
+		{
+		VkImageMemoryBarrier barrier = {};
+		barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		barrier.srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+		barrier.oldLayout = oldLayout;
+		barrier.newLayout = newLayout;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.image = image;
+		barrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, baseLevel, levelCount, 0, 6 };
+		vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+		}
+	}
+
+FakeVulkanTextureCube::FakeVulkanTextureCube(const FakeString &path)
+	: RendererID(FakeVulkanContext::CreateRendererID()), Format(FakeTextureFormat::RGB), FilePath(path)
+	{
+	Name = FakeVirtualFileSystem::Get()->GetFileNameFromPath(path);
+
+	int32 width, height, channels;
+	stbi_set_flip_vertically_on_load(false);
+	Byte *pixels = stbi_load(*path, &width, &height, &channels, STBI_rgb);
+	FAKE_ASSERT(pixels, "Failed to load texture");
+
+	if (!pixels)
+		return;
+
+	IsLoaded = true;
+	Width = width;
+	Height = height;
+
+	uint32 faceSize = Width / 4;
+	FAKE_ASSERT(faceSize == Height / 3, "Non-Square faces!");
+
+	MipLevels = FakeTexture::CalculateMipLevelCount(faceSize, faceSize);
+	CreateImage(VK_FORMAT_R8G8B8A8_UNORM, faceSize);
+
+	// The faces are cut out of the cross while they are copied, with an alpha channel added
+	uint32 faceBytes = faceSize * faceSize * 4;
+	VkBuffer staging = VK_NULL_HANDLE;
+	VkDeviceSize stagingOffset = 0;
+	Byte *memory = (Byte*)FakeVulkanRendererAPI::AllocateStaging(faceBytes * 6, staging, stagingOffset);
+	for (uint32 layer = 0; layer < 6; ++layer)
+		{
+		Byte *face = memory + layer * faceBytes;
+		for (uint32 y = 0; y < faceSize; ++y)
+			{
+			const Byte *row = pixels + ((CrossCells[layer][1] * faceSize + y) * Width + CrossCells[layer][0] * faceSize) * 3;
+			for (uint32 x = 0; x < faceSize; ++x)
+				{
+				memcpy(face + (y * faceSize + x) * 4, row + x * 3, 3);
+				face[(y * faceSize + x) * 4 + 3] = 0xff;
+				}
+			}
+		}
+
+	stbi_image_free(pixels);
+
+	VkImage image = Image;
+	uint32 mipLevels = MipLevels;
+	FakeVulkanRendererAPI::Upload([image, staging, stagingOffset, faceBytes, faceSize, mipLevels](VkCommandBuffer commandBuffer)
+		{
+		Utils::fake_transition_levels(commandBuffer, image, 0, mipLevels, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+
+		VkBufferImageCopy regions[6] = {};
+		for (uint32 layer = 0; layer < 6; ++layer)
+			{
+			regions[layer].bufferOffset = stagingOffset + layer * faceBytes;
+			regions[layer].imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, layer, 1 };
+			regions[layer].imageExtent = { faceSize, faceSize, 1 };
+			}
+
+		vkCmdCopyBufferToImage(commandBuffer, staging, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 6, regions);
+
+		int32 levelSize = (int32)faceSize;
+		for (uint32 level = 1; level < mipLevels; ++level)
+			{
+			Utils::fake_transition_levels(commandBuffer, image, level - 1, 1, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+
+			VkImageBlit blit = {};
+			blit.srcSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, level - 1, 0, 6 };
+			blit.srcOffsets[1] = { levelSize, levelSize, 1 };
+			levelSize = std::max(levelSize / 2, 1);
+			blit.dstSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, level, 0, 6 };
+			blit.dstOffsets[1] = { levelSize, levelSize, 1 };
+			vkCmdBlitImage(commandBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &blit, VK_FILTER_LINEAR);
+			}
+
+		if (mipLevels > 1)
+			Utils::fake_transition_levels(commandBuffer, image, 0, mipLevels - 1, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+		Utils::fake_transition_levels(commandBuffer, image, mipLevels - 1, 1, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+		});
+	}
+
+FakeVulkanTextureCube::FakeVulkanTextureCube(FakeTextureFormat format, uint32 width, uint32 height)
+	: RendererID(FakeVulkanContext::CreateRendererID()), Format(format), Width(width), Height(height), IsLoaded(true), FilePath(""), Name("Undefined")
+	{
+	MipLevels = FakeTexture::CalculateMipLevelCount(width, height);
+	CreateImage(Utils::fake_to_vulkan_cube_texture_format(Format), std::max(width, height));
+
+	// Nothing writes the faces yet, the image only has to be in a layout shaders can read
+	VkImage image = Image;
+	FakeVulkanRendererAPI::Upload([image](VkCommandBuffer commandBuffer)
+		{
+		FakeVulkanRendererAPI::TransitionImage(commandBuffer, image, VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+		});
+	}
+
+FakeVulkanTextureCube::~FakeVulkanTextureCube()
+	{
+	VkImage image = Image;
+	VkDeviceMemory memory = Memory;
+	VkImageView view = View;
+	VkSampler sampler = Sampler;
+	FakeVulkanContext::DestroyLater([image, memory, view, sampler]()
+		{
+		VkDevice device = FakeVulkanContext::GetDevice();
+		vkDestroySampler(device, sampler, nullptr);
+		vkDestroyImageView(device, view, nullptr);
+		vkDestroyImage(device, image, nullptr);
+		vkFreeMemory(device, memory, nullptr);
+		});
+	}
+
+void FakeVulkanTextureCube::CreateImage(VkFormat format, uint32 faceSize)
+	{
+	VkDevice device = FakeVulkanContext::GetDevice();
+
+	VkImageCreateInfo imageInfo = {};
+	imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+	imageInfo.flags = VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT;
+	imageInfo.imageType = VK_IMAGE_TYPE_2D;
+	imageInfo.format = format;
+	imageInfo.extent = { faceSize, faceSize, 1 };
+	imageInfo.mipLevels = MipLevels;
+	imageInfo.arrayLayers = 6;
+	imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+	imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+	imageInfo.usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+	imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+	FakeVulkanContext::CreateImage(imageInfo, Image, Memory);
+
+	VkImageViewCreateInfo viewInfo = {};
+	viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+	viewInfo.image = Image;
+	viewInfo.viewType = VK_IMAGE_VIEW_TYPE_CUBE;
+	viewInfo.format = format;
+	viewInfo.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, MipLevels, 0, 6 };
+	FAKE_VK_CHECK_RESULT(vkCreateImageView(device, &viewInfo, nullptr, &View));
+
+	VkSamplerCreateInfo samplerInfo = {};
+	samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+	samplerInfo.magFilter = VK_FILTER_LINEAR;
+	samplerInfo.minFilter = VK_FILTER_LINEAR;
+	samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+	samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+	samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+	samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+	samplerInfo.maxLod = (float)MipLevels;
+	if (FakeVulkanContext::GetFeatures().SamplerAnisotropy)
+		{
+		samplerInfo.anisotropyEnable = VK_TRUE;
+		samplerInfo.maxAnisotropy = FakeVulkanContext::GetProperties().limits.maxSamplerAnisotropy;
+		}
+
+	FAKE_VK_CHECK_RESULT(vkCreateSampler(device, &samplerInfo, nullptr, &Sampler));
+	}
+
+void FakeVulkanTextureCube::Bind(uint32 slot) const
+	{
+	FakeRef<const FakeVulkanTextureCube> instance = this;
+	FakeRenderer::Submit([instance, slot]()
+		{
+		FakeVulkanRendererAPI::BindTexture(slot, instance->View, instance->Sampler);
+		});
+	}
+
+#endif
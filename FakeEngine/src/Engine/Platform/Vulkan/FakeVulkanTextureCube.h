@@ -0,0 +1,73 @@
+/*****************************************************************
+ * \file   FakeVulkanTextureCube.h
+ * \brief  
+ * 
+ * \author Can Karka
+ * \date   February 2021
+ * 
+ * Copyright (C) 2021 Can Karka
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *********************************************************************/
+
+#pragma once
+
+#include "FakeVulkan.h"
+
+#include "Engine/Renderer/FakeTextureCube.h"
+
+/**
+ *
+ * The Vulkan implementation of FakeTextureCube. Files hold the faces as a horizontal cross of 4x3 faces,
+ * they are cut out while the pixels are copied into staging memory.
+ *
+ */
+class FakeVulkanTextureCube : public FakeTextureCube
+	{
+	private:
+
+		FakeRendererID RendererID = 0;
+		FakeTextureFormat Format;
+		uint32 Width = 0, Height = 0;
+		uint32 MipLevels = 1;
+		bool IsLoaded = false;
+		FakeString FilePath, Name;
+
+		VkImage Image = VK_NULL_HANDLE;
+		VkDeviceMemory Memory = VK_NULL_HANDLE;
+		VkImageView View = VK_NULL_HANDLE;
+		VkSampler Sampler = VK_NULL_HANDLE;
+
+		void CreateImage(VkFormat format, uint32 faceSize);
+
+	public:
+
+		FakeVulkanTextureCube(const FakeString &path);
+		FakeVulkanTextureCube(FakeTextureFormat format, uint32 width, uint32 height);
+		virtual ~FakeVulkanTextureCube();
+
+		virtual void Bind(uint32 slot = 0) const override;
+		virtual void Unbind() const override {}
+
+		virtual bool Loaded() const override { return IsLoaded; }
+		virtual const FakeString &GetName() const override { return Name; }
+		virtual const FakeString &GetPath() const override { return FilePath; }
+		virtual FakeTextureFormat GetFormat() const override { return Format; }
+		virtual uint32 GetWidth() const override { return Width; }
+		virtual uint32 GetHeight() const override { return Height; }
+		virtual uint32 GetMipLevelCount() const override { return MipLevels; }
+		virtual FakeRendererID GetRendererID() const override { return RendererID; }
+
+		virtual bool operator==(const FakeTexture &other) const override { return RendererID == other.GetRendererID(); }
+		virtual bool operator!=(const FakeTexture &other) const override { return RendererID != other.GetRendererID(); }
+	};
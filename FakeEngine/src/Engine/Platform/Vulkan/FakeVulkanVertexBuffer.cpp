@@ -0,0 +1,148 @@
+#include "FakePch.h"
+#include "FakeVulkanVertexBuffer.h"
+
+#ifdef FAKE_RENDERER_VULKAN
+
+#include "Engine/Renderer/FakeRenderer.h"
+#include "FakeVulkanContext.h"
+#include "FakeVulkanRendererAPI.h"
+
+// Vertex buffers double as storage and indirect buffers, compute shaders write the vertices and instances of GPU driven draws
+static const VkBufferUsageFlags VertexBufferUsage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT
+	| VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+
+FakeVulkanVertexBuffer::FakeVulkanVertexBuffer(void *data, uint32 size, FakeVertexBufferUsage usage)
+	: Size(size), Usage(usage)
+	{
+	CreateStorage(data);
+	}
+
+FakeVulkanVertexBuffer::FakeVulkanVertexBuffer(uint32 size, FakeVertexBufferUsage usage)
+	: Size(size), Usage(usage)
+	{
+	CreateStorage(nullptr);
+	}
+
+FakeVulkanVertexBuffer::~FakeVulkanVertexBuffer()
+	{
+	VkBuffer buffer = Buffer;
+	VkDeviceMemory memory = Memory;
+	FakeVulkanContext::DestroyLater([buffer, memory]()
+		{
+		vkDestroyBuffer(FakeVulkanContext::GetDevice(), buffer, nullptr);
+		vkFreeMemory(FakeVulkanContext::GetDevice(), memory, nullptr);
+		});
+	}
+
+void FakeVulkanVertexBuffer::CreateStorage(const void *data)
+	{
+	// Vulkan objects are not bound to a thread, so the buffer exists right away instead of after a render command
+	RendererID = FakeVulkanContext::CreateRendererID();
+
+	if (Usage != FakeVertexBufferUsage::Stream)
+		{
+		FakeVulkanContext::CreateBuffer(Size, VertexBufferUsage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, Buffer, Memory);
+		if (data)
+			FakeVulkanRendererAPI::WriteBuffer(Buffer, 0, data, Size, true);
+
+		return;
+		}
+
+	// Coherent, so writes are visible to the GPU without a flush
+	VkDeviceSize storageSize = (VkDeviceSize)Size * StreamRegionCount;
+	MappedData = (Byte*)FakeVulkanContext::CreateBuffer(storageSize, VertexBufferUsage, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, Buffer, Memory);
+
+	if (data)
+		memcpy(MappedData, data, Size);
+	}
+
+void FakeVulkanVertexBuffer::BeginStreamRegion()
+	{
+	// The frames which wrote the current region have all been submitted, the last one tells when the region is free again
+	if (StreamFrame != ~0u)
+		{
+		StreamValues[StreamRegion] = FakeVulkanContext::GetSubmittedValue();
+		StreamRegion = (StreamRegion + 1) % StreamRegionCount;
+		}
+
+	// Only blocks if the CPU is more than StreamRegionCount frames ahead of the GPU
+	FakeVulkanContext::Wait(StreamValues[StreamRegion]);
+
+	StreamFrame = FakeRenderer::GetFrameIndex();
+	StreamHead = 0;
+	}
+
+void *FakeVulkanVertexBuffer::Map(uint32 size, uint32 stride)
+	{
+	FAKE_ASSERT(Usage == FakeVertexBufferUsage::Stream, "Only stream buffers can be mapped!");
+
+	if (StreamFrame != FakeRenderer::GetFrameIndex())
+		BeginStreamRegion();
+
+	// Offsets are multiples of the stride from the start of the buffer, so draws can address them by vertex or instance
+	uint32 regionStart = StreamRegion * Size;
+	uint32 offset = (regionStart + StreamHead + stride - 1) / stride * stride;
+
+	// The region of this frame is full, executing the recorded commands starts a new frame
+	if (offset + size > regionStart + Size)
+		{
+		FakeRenderer::Render();
+		BeginStreamRegion();
+
+		regionStart = StreamRegion * Size;
+		offset = (regionStart + stride - 1) / stride * stride;
+		FAKE_ASSERT(offset + size <= regionStart + Size, "Stream data does not fit into one region!");
+		}
+
+	StreamOffset = offset;
+	return MappedData + offset;
+	}
+
+void FakeVulkanVertexBuffer::Unmap(uint32 usedSize)
+	{
+	// Draws reading this memory may be recorded after a Render() in between, so the region belongs to the current frame as well
+	StreamHead = StreamOffset + usedSize - StreamRegion * Size;
+	StreamFrame = FakeRenderer::GetFrameIndex();
+	}
+
+void FakeVulkanVertexBuffer::SetData(void *data, uint32 size, uint32 offset)
+	{
+	if (Usage == FakeVertexBufferUsage::Stream)
+		{
+		// The mapped memory is not read before Render(), so the caller's data is copied straight into the buffer
+		Byte *memory = (Byte*)Map(offset + size);
+		memcpy(memory + offset, data, size);
+		Unmap(offset + size);
+		return;
+		}
+
+	FAKE_ASSERT(offset + size <= Size, "Vertex data does not fit into the buffer!");
+
+	// The staging copy belongs to the command, which keeps it in order with the draws before and after it
+	std::vector<Byte> copy((const Byte*)data, (const Byte*)data + size);
+
+	FakeRef<FakeVulkanVertexBuffer> instance = this;
+	FakeRenderer::Submit([instance, copy = std::move(copy), offset]()
+		{
+		FakeVulkanRendererAPI::WriteBuffer(instance->Buffer, offset, copy.data(), (uint32)copy.size(), false);
+		});
+	}
+
+void FakeVulkanVertexBuffer::Bind() const
+	{
+	FakeRef<const FakeVulkanVertexBuffer> instance = this;
+	FakeRenderer::Submit([instance]() { FakeVulkanRendererAPI::BindVertexBuffer(instance->Buffer); });
+	}
+
+void FakeVulkanVertexBuffer::Unbind() const
+	{
+	FakeRenderer::Submit([]() { FakeVulkanRendererAPI::BindVertexBuffer(VK_NULL_HANDLE); });
+	}
+
+void FakeVulkanVertexBuffer::BindStorage(uint32 binding) const
+	{
+	FakeRef<const FakeVulkanVertexBuffer> instance = this;
+	FakeRenderer::Submit([instance, binding]() { FakeVulkanRendererAPI::BindStorageBuffer(binding, instance->Buffer); });
+	}
+
+#endif
@@ -0,0 +1,79 @@
+/*****************************************************************
+ * \file   FakeVulkanVertexBuffer.h
+ * \brief  
+ * 
+ * \author Can Karka
+ * \date   February 2021
+ * 
+ * Copyright (C) 2021 Can Karka
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *********************************************************************/
+
+#pragma once
+
+#include "FakeVulkan.h"
+
+#include "Engine/Renderer/FakeVertexBuffer.h"
+
+/**
+ *
+ * The Vulkan implementation of FakeVertexBuffer. Static and dynamic buffers live in device local memory and are written
+ * through staging memory, stream buffers are host visible and keep one region per frame in flight like on OpenGL.
+ *
+ */
+class FakeVulkanVertexBuffer : public FakeVertexBuffer
+	{
+	private:
+
+		FakeRendererID RendererID = 0;
+		uint32 Size;
+		FakeVertexBufferUsage Usage;
+		FakeVertexBufferLayout Layout;
+		VkBuffer Buffer = VK_NULL_HANDLE;
+		VkDeviceMemory Memory = VK_NULL_HANDLE;
+
+		// Stream buffers only, every region remembers the timeline value of the last frame which read it
+		static const uint32 StreamRegionCount = 3;
+		Byte *MappedData = nullptr;
+		uint32 StreamRegion = 0;
+		uint32 StreamFrame = ~0u;
+		uint32 StreamHead = 0;
+		uint32 StreamOffset = 0;
+		uint64 StreamValues[StreamRegionCount] = {};
+
+		void CreateStorage(const void *data);
+		void BeginStreamRegion();
+
+	public:
+
+		FakeVulkanVertexBuffer(void *data, uint32 size, FakeVertexBufferUsage usage = FakeVertexBufferUsage::Static);
+		FakeVulkanVertexBuffer(uint32 size, FakeVertexBufferUsage usage = FakeVertexBufferUsage::Dynamic);
+		virtual ~FakeVulkanVertexBuffer();
+
+		virtual void SetData(void *data, uint32 size, uint32 offset = 0) override;
+		virtual void *Map(uint32 size, uint32 stride = 1) override;
+		virtual void Unmap(uint32 usedSize) override;
+		virtual void Bind() const override;
+		virtual void Unbind() const override;
+		virtual void BindStorage(uint32 binding) const override;
+
+		virtual const FakeVertexBufferLayout &GetLayout() const override { return Layout; }
+		virtual void SetLayout(const FakeVertexBufferLayout &layout) override { Layout = layout; }
+
+		virtual uint32 GetSize() const override { return Size; }
+		virtual uint32 GetStreamOffset() const override { return StreamOffset; }
+		virtual FakeRendererID GetRendererID() const override { return RendererID; }
+
+		VkBuffer GetBuffer() const { return Buffer; }
+	};
@@ -0,0 +1,71 @@
+#include "FakePch.h"
+#include "Engine/Core/FakeMappedFile.h"
+
+#ifdef FAKE_PLATFORM_WINDOWS
+#include <Windows.h>
+
+FakeMappedFile::FakeMappedFile(const FakeString &path)
+	{
+	Open(path);
+	}
+
+FakeMappedFile::~FakeMappedFile()
+	{
+	Close();
+	}
+
+bool FakeMappedFile::Open(const FakeString &path)
+	{
+	Close();
+
+	HANDLE file = CreateFileW(path.W_Str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+		{
+		CloseHandle(file);
+		return false;
+		}
+
+	HANDLE mapping = CreateFileMappingW(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (!mapping)
+		{
+		CloseHandle(file);
+		return false;
+		}
+
+	void *view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (!view)
+		{
+		CloseHandle(mapping);
+		CloseHandle(file);
+		return false;
+		}
+
+	Data = (const Byte*)view;
+	Size = (uint64)size.QuadPart;
+	FileHandle = file;
+	MappingHandle = mapping;
+	return true;
+	}
+
+void FakeMappedFile::Close()
+	{
+	if (Data)
+		UnmapViewOfFile(Data);
+
+	if (MappingHandle)
+		CloseHandle(MappingHandle);
+
+	if (FileHandle)
+		CloseHandle(FileHandle);
+
+	Data = nullptr;
+	Size = 0;
+	FileHandle = nullptr;
+	MappingHandle = nullptr;
+	}
+
+#endif
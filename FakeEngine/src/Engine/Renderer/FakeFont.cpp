@@ -0,0 +1,257 @@
+#include "FakePch.h"
+#include "FakeFont.h"
+
+#include <fstream>
+#include <sstream>
+#include <yaml-cpp/yaml.h>
+
+namespace Utils
+	{
+	static uint64 fake_kerning_key(uint32 first, uint32 second)
+		{
+		return ((uint64)first << 32) | (uint64)second;
+		}
+
+	// Returns the codepoint at it and moves it behind the sequence, broken sequences decode to U+FFFD
+	static uint32 fake_decode_utf8(const char *&it, const char *end)
+		{
+		uint8 lead = (uint8)*it++;
+		if (lead < 0x80)
+			return lead;
+
+		uint32 continuationCount = 0;
+		uint32 codepoint = 0;
+		if ((lead & 0xe0) == 0xc0)
+			{
+			continuationCount = 1;
+			codepoint = lead & 0x1f;
+			}
+		else if ((lead & 0xf0) == 0xe0)
+			{
+			continuationCount = 2;
+			codepoint = lead & 0x0f;
+			}
+		else if ((lead & 0xf8) == 0xf0)
+			{
+			continuationCount = 3;
+			codepoint = lead & 0x07;
+			}
+		else
+			{
+			return 0xfffd;
+			}
+
+		for (uint32 i = 0; i < continuationCount; ++i)
+			{
+			if (it == end || ((uint8)*it & 0xc0) != 0x80)
+				return 0xfffd;
+
+			codepoint = (codepoint << 6) | ((uint8)*it++ & 0x3f);
+			}
+
+		return codepoint;
+		}
+
+	static void fake_read_bounds(const YAML::Node &node, float &left, float &bottom, float &right, float &top)
+		{
+		left = node["left"].as<float>();
+		bottom = node["bottom"].as<float>();
+		right = node["right"].as<float>();
+		top = node["top"].as<float>();
+		}
+	}
+
+FakeFont::FakeFont(const FakeRef<FakeTexture2D> &atlas, const FakeFontMetrics &metrics)
+	: Atlas(atlas), Metrics(metrics)
+	{
+	HasASCIIGlyph.fill(false);
+	}
+
+void FakeFont::AddGlyph(uint32 codepoint, const FakeFontGlyph &glyph)
+	{
+	if (codepoint < ASCIIGlyphs.size())
+		{
+		ASCIIGlyphs[codepoint] = glyph;
+		HasASCIIGlyph[codepoint] = true;
+		return;
+		}
+
+	Glyphs[codepoint] = glyph;
+	}
+
+void FakeFont::AddKerning(uint32 first, uint32 second, float advance)
+	{
+	Kerning[Utils::fake_kerning_key(first, second)] = advance;
+	}
+
+const FakeFontGlyph *FakeFont::GetGlyph(uint32 codepoint) const
+	{
+	if (codepoint < ASCIIGlyphs.size())
+		return HasASCIIGlyph[codepoint] ? &ASCIIGlyphs[codepoint] : nullptr;
+
+	auto it = Glyphs.find(codepoint);
+	return it != Glyphs.end() ? &it->second : nullptr;
+	}
+
+float FakeFont::GetKerning(uint32 first, uint32 second) const
+	{
+	if (Kerning.empty())
+		return 0.0f;
+
+	auto it = Kerning.find(Utils::fake_kerning_key(first, second));
+	return it != Kerning.end() ? it->second : 0.0f;
+	}
+
+void FakeFont::Layout(const FakeString &text, FakeTextLayout &layout) const
+	{
+	layout.Glyphs.clear();
+	layout.Glyphs.reserve(text.Length());
+	layout.Width = 0.0f;
+	layout.Height = text.IsEmpty() ? 0.0f : Metrics.LineHeight;
+
+	const FakeFontGlyph *fallback = GetGlyph('?');
+	const char *it = text.C_Str();
+	const char *end = it + text.Length();
+
+	float x = 0.0f;
+	float y = 0.0f;
+	uint32 previous = 0;
+
+	while (it != end)
+		{
+		uint32 codepoint = Utils::fake_decode_utf8(it, end);
+		if (codepoint == '\r')
+			continue;
+
+		if (codepoint == '\n')
+			{
+			x = 0.0f;
+			y -= Metrics.LineHeight;
+			layout.Height += Metrics.LineHeight;
+			previous = 0;
+			continue;
+			}
+
+		const FakeFontGlyph *glyph = GetGlyph(codepoint);
+		if (!glyph)
+			{
+			glyph = fallback;
+			codepoint = '?';
+			}
+
+		if (!glyph)
+			continue;
+
+		if (previous)
+			x += GetKerning(previous, codepoint);
+
+		if (glyph->PlaneRight > glyph->PlaneLeft)
+			{
+			FakeTextGlyph &quad = layout.Glyphs.emplace_back();
+			quad.Min = { x + glyph->PlaneLeft, y + glyph->PlaneBottom };
+			quad.Max = { x + glyph->PlaneRight, y + glyph->PlaneTop };
+			quad.TexCoordMin = { glyph->AtlasLeft, glyph->AtlasBottom };
+			quad.TexCoordMax = { glyph->AtlasRight, glyph->AtlasTop };
+			}
+
+		x += glyph->Advance;
+		layout.Width = std::max(layout.Width, x);
+		previous = codepoint;
+		}
+	}
+
+uint32 FakeFont::GetGlyphCount() const
+	{
+	uint32 count = (uint32)Glyphs.size();
+	for (bool hasGlyph : HasASCIIGlyph)
+		count += hasGlyph ? 1 : 0;
+
+	return count;
+	}
+
+FakeRef<FakeFont> FakeFont::Create(const FakeString &path)
+	{
+	std::ifstream stream(*path);
+	if (!stream)
+		{
+		FAKE_LOG_ERROR("Could not open font file %s!", *path);
+		return nullptr;
+		}
+
+	std::stringstream text;
+	text << stream.rdbuf();
+
+	std::string atlasPath = *path;
+	size_t extension = atlasPath.find_last_of('.');
+	size_t separator = atlasPath.find_last_of("/\\");
+	if (extension != std::string::npos && (separator == std::string::npos || extension > separator))
+		atlasPath.erase(extension);
+
+	atlasPath += ".png";
+
+	try
+		{
+		// JSON is a subset of YAML, the layout of msdf-atlas-gen loads with the YAML parser
+		YAML::Node root = YAML::Load(text.str());
+		YAML::Node atlasNode = root["atlas"];
+		YAML::Node metricsNode = root["metrics"];
+		if (!atlasNode || !metricsNode || !root["glyphs"])
+			{
+			FAKE_LOG_ERROR("Font file %s is not a msdf-atlas-gen JSON layout!", *path);
+			return nullptr;
+			}
+
+		const float width = atlasNode["width"].as<float>();
+		const float height = atlasNode["height"].as<float>();
+		const bool yOriginTop = atlasNode["yOrigin"] && atlasNode["yOrigin"].as<std::string>() == "top";
+
+		FakeFontMetrics metrics;
+		metrics.DistanceRange = atlasNode["distanceRange"].as<float>();
+		metrics.LineHeight = metricsNode["lineHeight"].as<float>();
+		metrics.Ascender = metricsNode["ascender"].as<float>();
+		metrics.Descender = metricsNode["descender"].as<float>();
+
+		// The distance field is linear data, it must not be converted from sRGB
+		FakeRef<FakeTexture2D> atlas = FakeTexture2D::Create(atlasPath, false, FakeTextureWrap::Clamp);
+		if (!atlas->Loaded())
+			{
+			FAKE_LOG_ERROR("Could not load font atlas %s!", atlasPath.c_str());
+			return nullptr;
+			}
+
+		FakeRef<FakeFont> font = FakeRef<FakeFont>::Create(atlas, metrics);
+
+		for (const YAML::Node &glyphNode : root["glyphs"])
+			{
+			FakeFontGlyph glyph;
+			glyph.Advance = glyphNode["advance"].as<float>();
+
+			if (glyphNode["planeBounds"] && glyphNode["atlasBounds"])
+				{
+				Utils::fake_read_bounds(glyphNode["planeBounds"], glyph.PlaneLeft, glyph.PlaneBottom, glyph.PlaneRight, glyph.PlaneTop);
+				Utils::fake_read_bounds(glyphNode["atlasBounds"], glyph.AtlasLeft, glyph.AtlasBottom, glyph.AtlasRight, glyph.AtlasTop);
+
+				// Images are flipped on load, the bottom row of the atlas is at v = 0
+				glyph.AtlasLeft /= width;
+				glyph.AtlasRight /= width;
+				glyph.AtlasBottom = yOriginTop ? 1.0f - glyph.AtlasBottom / height : glyph.AtlasBottom / height;
+				glyph.AtlasTop = yOriginTop ? 1.0f - glyph.AtlasTop / height : glyph.AtlasTop / height;
+				}
+
+			font->AddGlyph(glyphNode["unicode"].as<uint32>(), glyph);
+			}
+
+		if (YAML::Node kerningNodes = root["kerning"])
+			{
+			for (const YAML::Node &kerningNode : kerningNodes)
+				font->AddKerning(kerningNode["unicode1"].as<uint32>(), kerningNode["unicode2"].as<uint32>(), kerningNode["advance"].as<float>());
+			}
+
+		return font;
+		}
+	catch (const YAML::Exception &e)
+		{
+		FAKE_LOG_ERROR("Failed to load font %s: %s", *path, e.what());
+		return nullptr;
+		}
+	}
@@ -0,0 +1,172 @@
+/*****************************************************************
+ * \file   FakeFont.h
+ * \brief  
+ * 
+ * \author Can Karka
+ * \date   February 2021
+ * 
+ * Copyright (C) 2021 Can Karka
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *********************************************************************/
+
+#pragma once
+
+#include "Engine/Core/Maths/FakeMaths.h"
+#include "Engine/Renderer/FakeTexture2D.h"
+
+/**
+ *
+ * A glyph of a signed distance field font. The plane bounds place the quad relative to the pen on the baseline
+ * in em, the atlas bounds are texture coordinates. Glyphs without a visible shape, like the space, have empty bounds.
+ *
+ */
+struct FakeFontGlyph
+	{
+	float PlaneLeft = 0.0f;
+	float PlaneBottom = 0.0f;
+	float PlaneRight = 0.0f;
+	float PlaneTop = 0.0f;
+
+	float AtlasLeft = 0.0f;
+	float AtlasBottom = 0.0f;
+	float AtlasRight = 0.0f;
+	float AtlasTop = 0.0f;
+
+	float Advance = 0.0f;
+	};
+
+struct FakeFontMetrics
+	{
+	float LineHeight = 1.0f;
+	float Ascender = 0.0f;
+	float Descender = 0.0f;
+
+	// The range of the distance field in atlas pixels, the text shader needs it to keep the edges sharp at every size
+	float DistanceRange = 2.0f;
+	};
+
+/**
+ *
+ * A glyph quad of a FakeTextLayout, the positions are in em relative to the origin of the text.
+ *
+ */
+struct FakeTextGlyph
+	{
+	FakeVec2f Min;
+	FakeVec2f Max;
+	FakeVec2f TexCoordMin;
+	FakeVec2f TexCoordMax;
+	};
+
+/**
+ *
+ * A laid out string, it stays valid as long as the font does not change and can be drawn any number of times.
+ *
+ */
+struct FakeTextLayout
+	{
+	std::vector<FakeTextGlyph> Glyphs;
+	float Width = 0.0f;
+	float Height = 0.0f;
+	};
+
+/**
+ *
+ * A multi-channel signed distance field font, generated offline by msdf-atlas-gen. The atlas texture holds the
+ * distance fields of all glyphs, the glyph metrics and the kerning table place them.
+ *
+ */
+class FAKE_API FakeFont : public FakeRefCounted
+	{
+	private:
+
+		FakeRef<FakeTexture2D> Atlas;
+		FakeFontMetrics Metrics;
+
+		// Most text is ASCII, it does not need the map
+		std::array<FakeFontGlyph, 128> ASCIIGlyphs;
+		std::array<bool, 128> HasASCIIGlyph;
+		std::unordered_map<uint32, FakeFontGlyph> Glyphs;
+		std::unordered_map<uint64, float> Kerning;
+
+	public:
+
+		/**
+		 *
+		 * Creates an empty font, the glyphs are added with AddGlyph().
+		 *
+		 * @param atlas The distance field atlas.
+		 * @param metrics The metrics of the font.
+		 */
+		FakeFont(const FakeRef<FakeTexture2D> &atlas, const FakeFontMetrics &metrics);
+
+		/**
+		 *
+		 * Adds a glyph or replaces the glyph of the codepoint.
+		 *
+		 * @param codepoint The unicode codepoint.
+		 * @param glyph The metrics of the glyph.
+		 */
+		void AddGlyph(uint32 codepoint, const FakeFontGlyph &glyph);
+
+		/**
+		 *
+		 * Adds a kerning pair, the advance is added to the advance of the first glyph when it is followed by the second one.
+		 *
+		 * @param first The codepoint of the left glyph.
+		 * @param second The codepoint of the right glyph.
+		 * @param advance The adjustment in em, usually negative.
+		 */
+		void AddKerning(uint32 first, uint32 second, float advance);
+
+		/**
+		 *
+		 * Returns the glyph of a codepoint.
+		 *
+		 * @param codepoint The unicode codepoint.
+		 * @return Returns nullptr if the font has no glyph for the codepoint.
+		 */
+		const FakeFontGlyph *GetGlyph(uint32 codepoint) const;
+
+		/**
+		 *
+		 * Returns the kerning of a pair of codepoints in em, 0 if the pair is not in the kerning table.
+		 *
+		 */
+		float GetKerning(uint32 first, uint32 second) const;
+
+		/**
+		 *
+		 * Lays out UTF-8 text. The origin is on the baseline of the first line, y points up and every line break
+		 * moves the pen down by the line height. Codepoints without a glyph are drawn as '?'.
+		 *
+		 * @param text The UTF-8 encoded text.
+		 * @param layout Receives the glyph quads.
+		 */
+		void Layout(const FakeString &text, FakeTextLayout &layout) const;
+
+		const FakeRef<FakeTexture2D> &GetAtlas() const { return Atlas; }
+		const FakeFontMetrics &GetMetrics() const { return Metrics; }
+		uint32 GetGlyphCount() const;
+
+		/**
+		 *
+		 * Loads a font generated by msdf-atlas-gen with the JSON layout. The atlas image has to be next to the JSON file
+		 * with the same name and the png extension.
+		 *
+		 * @param path The path to the JSON file.
+		 * @return Returns nullptr if the file could not be loaded.
+		 */
+		static FakeRef<FakeFont> Create(const FakeString &path);
+	};
@@ -1,11 +1,40 @@
 #include "FakePch.h"
 #include "FakeFramebuffer.h"
 
+#include "FakeRendererAPI.h"
+#include "Engine/Platform/Null/FakeNullFramebuffer.h"
 #include "Engine/Platform/OpenGL/FakeOpenGLFramebuffer.h"
 
+#ifdef FAKE_RENDERER_VULKAN
+#include "Engine/Platform/Vulkan/FakeVulkanFramebuffer.h"
+#endif
+
 FakeRef<FakeFramebuffer> FakeFramebuffer::Create(const FakeFramebufferSpecification &spec)
 	{
+	if (FakeRendererAPI::IsHeadless())
+		return FakeRef<FakeNullFramebuffer>::Create(spec);
+
+	#ifdef FAKE_RENDERER_VULKAN
+		if (FakeRendererAPI::Current() == FakeRendererAPIType::Vulkan)
+			return FakeRef<FakeVulkanFramebuffer>::Create(spec);
+	#endif
+
 	#ifdef FAKE_RENDERER_OPENGL
 		return FakeRef<FakeOpenGLFramebuffer>::Create(spec);
 	#endif
 	}
+
+void FakeFramebuffer::ReadPixelAsync(uint32 attachmentIndex, int32 x, int32 y, const FakeReadPixelCallback &callback)
+	{
+	ReadRegionAsync(attachmentIndex, x, y, 1, 1, [callback](const FakeFramebufferReadback &readback)
+		{
+		int32 value;
+		memcpy(&value, readback.Pixels, sizeof(int32));
+		callback(value);
+		});
+	}
+
+void FakeFramebuffer::CaptureAsync(uint32 attachmentIndex, const FakeReadbackCallback &callback)
+	{
+	ReadRegionAsync(attachmentIndex, 0, 0, GetWidth(), GetHeight(), callback);
+	}
@@ -117,6 +117,24 @@ struct FAKE_API FakeFramebufferSpecification
 	bool SwapChainTarget = false;
 	};
 
+/**
+ *
+ * The result of an asynchronous readback. The pixels are only valid while the callback runs.
+ * Every pixel takes 4 bytes, RGBA8 for color attachments and an int32 for RED_INTEGER attachments.
+ * The rows are stored from bottom to top.
+ *
+ */
+struct FAKE_API FakeFramebufferReadback
+	{
+	const Byte *Pixels = nullptr;
+	uint32 Width = 0;
+	uint32 Height = 0;
+	uint32 FrameIndex = 0;	/**< The frame which requested the readback. */
+	};
+
+using FakeReadPixelCallback = std::function<void(int32 value)>;
+using FakeReadbackCallback = std::function<void(const FakeFramebufferReadback &readback)>;
+
 /**
  * 
  * .
@@ -183,6 +201,42 @@ class FAKE_API FakeFramebuffer : public FakeRefCounted
 		 */
 		virtual int32 ReadPixel(uint32 attachmentIndex, int32 x, int32 y) = 0;
 
+		/**
+		 *
+		 * Copies a region of a color attachment into a pixel buffer after the commands recorded so far, without waiting for the GPU.
+		 * The callback is called by FakeRenderer::Render() once the copy has finished, usually one or two frames later.
+		 * Readbacks finish in the order they were requested and none is dropped, if too many are pending the oldest is waited for.
+		 *
+		 * @param attachmentIndex The color attachment to read.
+		 * @param x The left edge of the region.
+		 * @param y The bottom edge of the region.
+		 * @param width The width of the region.
+		 * @param height The height of the region.
+		 * @param callback Receives the pixels.
+		 */
+		virtual void ReadRegionAsync(uint32 attachmentIndex, int32 x, int32 y, uint32 width, uint32 height, const FakeReadbackCallback &callback) = 0;
+
+		/**
+		 *
+		 * Reads one pixel of a RED_INTEGER attachment like ReadPixel(), without stalling until the GPU has caught up.
+		 *
+		 * @param attachmentIndex The color attachment to read.
+		 * @param x The x coordinate of the pixel.
+		 * @param y The y coordinate of the pixel.
+		 * @param callback Receives the value, one or two frames later.
+		 */
+		void ReadPixelAsync(uint32 attachmentIndex, int32 x, int32 y, const FakeReadPixelCallback &callback);
+
+		/**
+		 *
+		 * Reads a whole color attachment, for screenshots and video capture.
+		 * Capturing every frame delivers every frame in order, FakeFramebufferReadback::FrameIndex tells which one it is.
+		 *
+		 * @param attachmentIndex The color attachment to read.
+		 * @param callback Receives the pixels.
+		 */
+		void CaptureAsync(uint32 attachmentIndex, const FakeReadbackCallback &callback);
+
 		/**
 		 * 
 		 * .
@@ -0,0 +1,442 @@
+#include "FakePch.h"
+#include "FakeGPUScene.h"
+
+#include "FakeRenderer.h"
+
+// The bindings of the storage blocks in FakeGPUSceneCullSource
+static const uint32 InstanceBinding = 0;
+static const uint32 BatchBinding = 1;
+static const uint32 VisibleBinding = 2;
+static const uint32 IndirectBinding = 3;
+static const uint32 ParamsBinding = 4;
+
+static const uint32 CullGroupSize = 64;
+
+// Stage 0 resets the counters, stage 1 culls the instances and stage 2 writes one draw command per batch with visible instances.
+// The draw counts of the buckets are at the start of the indirect buffer, the commands follow at u_CommandBase.
+static const char *FakeGPUSceneCullSource = R"(
+#type compute
+#version 450 core
+
+layout(local_size_x = 64) in;
+
+struct Instance
+	{
+	mat4 Transform;
+	vec4 BoundsMin;
+	vec4 BoundsMax;
+	uvec4 Batch;
+	};
+
+struct Batch
+	{
+	uint IndexCount;
+	uint FirstIndex;
+	uint BaseInstance;
+	uint InstanceCount;
+	uint Bucket;
+	uint FirstCommand;
+	uvec2 Padding;
+	};
+
+layout(std430, binding = 0) readonly buffer Instances { Instance u_Instances[]; };
+layout(std430, binding = 1) buffer Batches { Batch u_Batches[]; };
+layout(std430, binding = 2) writeonly buffer Visible { mat4 u_Visible[]; };
+layout(std430, binding = 3) buffer Indirect { uint u_Indirect[]; };
+
+layout(std430, binding = 4) readonly buffer Params
+	{
+	vec4 u_Planes[6];
+	uint u_InstanceCount;
+	uint u_BatchCount;
+	uint u_BucketCount;
+	uint u_CommandBase;
+	};
+
+uniform int u_Stage;
+
+bool IsVisible(Instance instance)
+	{
+	vec3 center = (instance.BoundsMin.xyz + instance.BoundsMax.xyz) * 0.5;
+	vec3 extent = (instance.BoundsMax.xyz - instance.BoundsMin.xyz) * 0.5;
+
+	// The world space box around the transformed box
+	vec3 worldCenter = (instance.Transform * vec4(center, 1.0)).xyz;
+	vec3 worldExtent = abs(instance.Transform[0].xyz) * extent.x + abs(instance.Transform[1].xyz) * extent.y + abs(instance.Transform[2].xyz) * extent.z;
+
+	for (int i = 0; i < 6; ++i)
+		{
+		if (dot(u_Planes[i].xyz, worldCenter) + dot(abs(u_Planes[i].xyz), worldExtent) + u_Planes[i].w < 0.0)
+			return false;
+		}
+
+	return true;
+	}
+
+void main()
+	{
+	uint index = gl_GlobalInvocationID.x;
+
+	if (u_Stage == 0)
+		{
+		if (index < u_BucketCount)
+			u_Indirect[index] = 0;
+
+		// Every reserved command draws nothing until stage 2 fills it in, drivers without draw counts issue all of them
+		if (index < u_BatchCount)
+			{
+			u_Batches[index].InstanceCount = 0;
+			u_Indirect[u_CommandBase + index * 5 + 1] = 0;
+			}
+		}
+	else if (u_Stage == 1)
+		{
+		if (index >= u_InstanceCount || !IsVisible(u_Instances[index]))
+			return;
+
+		uint batch = u_Instances[index].Batch.x;
+		uint slot = atomicAdd(u_Batches[batch].InstanceCount, 1);
+		u_Visible[u_Batches[batch].BaseInstance + slot] = u_Instances[index].Transform;
+		}
+	else
+		{
+		if (index >= u_BatchCount || u_Batches[index].InstanceCount == 0)
+			return;
+
+		Batch batch = u_Batches[index];
+		uint draw = atomicAdd(u_Indirect[batch.Bucket], 1);
+		uint command = u_CommandBase + (batch.FirstCommand + draw) * 5;
+
+		u_Indirect[command + 0] = batch.IndexCount;
+		u_Indirect[command + 1] = batch.InstanceCount;
+		u_Indirect[command + 2] = batch.FirstIndex;
+		u_Indirect[command + 3] = 0;
+		u_Indirect[command + 4] = batch.BaseInstance;
+		}
+	}
+)";
+
+struct FakeGPUSceneCullParams
+	{
+	FakeVec4f Planes[FakeFrustum::PlaneCount];
+	uint32 InstanceCount;
+	uint32 BatchCount;
+	uint32 BucketCount;
+	uint32 CommandBase;
+	};
+
+namespace Utils
+	{
+	static uint32 fake_group_count(uint32 count)
+		{
+		return (count + CullGroupSize - 1) / CullGroupSize;
+		}
+
+	static uint32 fake_grow_capacity(uint32 capacity, uint32 count)
+		{
+		if (!capacity)
+			capacity = 1024;
+
+		while (capacity < count)
+			capacity *= 2;
+
+		return capacity;
+		}
+	}
+
+FakeGPUScene::FakeGPUScene()
+	{
+	CullShader = FakeShader::CreateFromSource("FakeGPUSceneCull", FakeGPUSceneCullSource);
+	ParamsBuffer = FakeStorageBuffer::Create(sizeof(FakeGPUSceneCullParams));
+	}
+
+FakeGPUSceneInstance FakeGPUScene::AddInstance(const FakeRef<FakeMesh> &mesh, uint32 submeshIndex, const FakeRef<FakeMaterial> &material, const FakeMat4f &transform)
+	{
+	FAKE_ASSERT(submeshIndex < mesh->GetSubmeshes().size(), "Submesh index out of range!");
+
+	FakeGPUSceneInstance handle = (FakeGPUSceneInstance)Slots.size();
+	if (!FreeHandles.empty())
+		{
+		handle = FreeHandles.back();
+		FreeHandles.pop_back();
+		}
+	else
+		{
+		Slots.push_back(0);
+		}
+
+	Slots[handle] = (uint32)Entries.size();
+
+	Entry entry;
+	entry.Mesh = mesh;
+	entry.Material = material;
+	entry.Submesh = submeshIndex;
+	entry.Handle = handle;
+	Entries.push_back(entry);
+
+	const FakeAABB &bounds = mesh->GetSubmeshes()[submeshIndex].Bounds;
+
+	GPUInstance instance;
+	instance.Transform = transform;
+	instance.BoundsMin = FakeVec4f(bounds.Min.X, bounds.Min.Y, bounds.Min.Z, 1.0f);
+	instance.BoundsMax = FakeVec4f(bounds.Max.X, bounds.Max.Y, bounds.Max.Z, 1.0f);
+	GPUInstances.push_back(instance);
+
+	Dirty = true;
+	return handle;
+	}
+
+void FakeGPUScene::RemoveInstance(FakeGPUSceneInstance instance)
+	{
+	FAKE_ASSERT(instance < Slots.size() && Slots[instance] != ~0u, "Instance does not exist!");
+
+	uint32 slot = Slots[instance];
+	uint32 last = (uint32)Entries.size() - 1;
+	if (slot != last)
+		{
+		Entries[slot] = std::move(Entries[last]);
+		GPUInstances[slot] = GPUInstances[last];
+		Slots[Entries[slot].Handle] = slot;
+		}
+
+	Entries.pop_back();
+	GPUInstances.pop_back();
+
+	Slots[instance] = ~0u;
+	FreeHandles.push_back(instance);
+	Dirty = true;
+	}
+
+void FakeGPUScene::SetTransform(FakeGPUSceneInstance instance, const FakeMat4f &transform)
+	{
+	FAKE_ASSERT(instance < Slots.size() && Slots[instance] != ~0u, "Instance does not exist!");
+
+	uint32 slot = Slots[instance];
+	GPUInstances[slot].Transform = transform;
+
+	// A rebuild uploads all instances anyway
+	if (Dirty)
+		return;
+
+	InstanceBuffer->SetData(&transform, sizeof(FakeMat4f), slot * sizeof(GPUInstance));
+	Stats.UploadedBytes += sizeof(FakeMat4f);
+	}
+
+void FakeGPUScene::Clear()
+	{
+	Entries.clear();
+	GPUInstances.clear();
+	Slots.clear();
+	FreeHandles.clear();
+	Dirty = true;
+	}
+
+void FakeGPUScene::Reserve(uint32 instanceCount, uint32 batchCount)
+	{
+	if (instanceCount > InstanceCapacity)
+		{
+		InstanceCapacity = Utils::fake_grow_capacity(InstanceCapacity, instanceCount);
+		InstanceBuffer = FakeStorageBuffer::Create(InstanceCapacity * sizeof(GPUInstance));
+		VisibleBuffer = FakeVertexBuffer::Create(InstanceCapacity * sizeof(FakeMat4f), FakeVertexBufferUsage::Dynamic);
+
+		// The pipeline reads the transforms the culling shader has written as per-instance attributes
+		FakePipelineSpecification spec;
+		spec.Layout = FakeMesh::GetVertexLayout();
+		spec.InstanceBuffer = VisibleBuffer;
+		spec.InstanceLayout = {
+			{ FakeShaderDataType::Mat4, "a_Transform" }
+		};
+
+		Pipeline = FakePipeline::Create(spec);
+		}
+
+	if (batchCount > BatchCapacity)
+		{
+		BatchCapacity = Utils::fake_grow_capacity(BatchCapacity, batchCount);
+		BatchBuffer = FakeStorageBuffer::Create(BatchCapacity * sizeof(GPUBatch));
+
+		// A bucket holds at least one batch, so the draw counts never need more room than the batches
+		uint32 commandBase = (BatchCapacity + 3) & ~3u;
+		IndirectBuffer = FakeStorageBuffer::Create((commandBase + BatchCapacity * 5) * sizeof(uint32));
+		}
+	}
+
+void FakeGPUScene::Rebuild()
+	{
+	uint32 instanceCount = (uint32)Entries.size();
+
+	// Instances of the same batch end up next to each other, and batches of the same bucket as well
+	std::vector<uint32> order(instanceCount);
+	for (uint32 i = 0; i < instanceCount; ++i)
+		order[i] = i;
+
+	std::sort(order.begin(), order.end(), [this](uint32 a, uint32 b)
+		{
+		const Entry &left = Entries[a];
+		const Entry &right = Entries[b];
+		if (left.Material.Raw() != right.Material.Raw())
+			return left.Material.Raw() < right.Material.Raw();
+		if (left.Mesh.Raw() != right.Mesh.Raw())
+			return left.Mesh.Raw() < right.Mesh.Raw();
+		return left.Submesh < right.Submesh;
+		});
+
+	Batches.clear();
+	Buckets.clear();
+
+	const Entry *previous = nullptr;
+	for (uint32 i = 0; i < instanceCount; ++i)
+		{
+		const Entry &entry = Entries[order[i]];
+
+		bool newBucket = !previous || entry.Material.Raw() != previous->Material.Raw() || entry.Mesh.Raw() != previous->Mesh.Raw();
+		if (newBucket)
+			{
+			Bucket bucket;
+			bucket.Mesh = entry.Mesh.Raw();
+			bucket.Material = entry.Material.Raw();
+			bucket.FirstCommand = (uint32)Batches.size();
+			Buckets.push_back(bucket);
+			}
+
+		if (newBucket || entry.Submesh != previous->Submesh)
+			{
+			const FakeSubmesh &submesh = entry.Mesh->GetSubmeshes()[entry.Submesh];
+
+			// Each batch owns the region of the visible transforms its instances were sorted into
+			GPUBatch batch;
+			batch.IndexCount = submesh.IndexCount;
+			batch.FirstIndex = submesh.BaseIndex;
+			batch.BaseInstance = i;
+			batch.Bucket = (uint32)Buckets.size() - 1;
+			batch.FirstCommand = Buckets.back().FirstCommand;
+			Batches.push_back(batch);
+			Buckets.back().BatchCount++;
+			}
+
+		GPUInstances[order[i]].Batch = (uint32)Batches.size() - 1;
+		previous = &entry;
+		}
+
+	uint32 batchCount = (uint32)Batches.size();
+	Reserve(instanceCount, batchCount);
+	CommandBase = ((uint32)Buckets.size() + 3) & ~3u;
+
+	InstanceBuffer->SetData(GPUInstances.data(), instanceCount * sizeof(GPUInstance));
+	BatchBuffer->SetData(Batches.data(), batchCount * sizeof(GPUBatch));
+
+	Stats.InstanceCount = instanceCount;
+	Stats.BatchCount = batchCount;
+	Stats.BucketCount = (uint32)Buckets.size();
+	Stats.UploadedBytes += instanceCount * sizeof(GPUInstance) + batchCount * sizeof(GPUBatch);
+	Stats.RebuildCount++;
+
+	Dirty = false;
+	}
+
+void FakeGPUScene::Draw(const FakeMat4f &viewProjection)
+	{
+	if (Entries.empty())
+		return;
+
+	if (Dirty)
+		Rebuild();
+
+	FakeFrustum frustum(viewProjection);
+
+	FakeGPUSceneCullParams params;
+	for (uint32 i = 0; i < FakeFrustum::PlaneCount; ++i)
+		params.Planes[i] = frustum.Planes[i];
+
+	params.InstanceCount = Stats.InstanceCount;
+	params.BatchCount = Stats.BatchCount;
+	params.BucketCount = Stats.BucketCount;
+	params.CommandBase = CommandBase;
+	ParamsBuffer->SetData(&params, sizeof(FakeGPUSceneCullParams));
+
+	CullShader->Bind();
+	InstanceBuffer->Bind(InstanceBinding);
+	BatchBuffer->Bind(BatchBinding);
+	VisibleBuffer->BindStorage(VisibleBinding);
+	IndirectBuffer->Bind(IndirectBinding);
+	ParamsBuffer->Bind(ParamsBinding);
+
+	uint32 groupCounts[3] =
+		{
+		Utils::fake_group_count(params.BatchCount),
+		Utils::fake_group_count(params.InstanceCount),
+		Utils::fake_group_count(params.BatchCount)
+		};
+
+	for (int32 stage = 0; stage < 3; ++stage)
+		{
+		uint32 groups = groupCounts[stage];
+		CullShader->SetUniform("u_Stage", stage);
+		FakeRenderer::Submit([groups]()
+			{
+			FakeRendererAPI::DispatchCompute(groups);
+			FakeRendererAPI::StorageBarrier();
+			});
+
+		Stats.Dispatches++;
+		}
+
+	IndirectBuffer->BindIndirect();
+
+	const FakeShader *currentShader = nullptr;
+	const FakeMaterial *currentMaterial = nullptr;
+	const FakeMesh *currentMesh = nullptr;
+	FakeMaterial::ResetBindState();
+
+	for (uint32 i = 0; i < (uint32)Buckets.size(); ++i)
+		{
+		const Bucket &bucket = Buckets[i];
+
+		if (bucket.Material != currentMaterial)
+			{
+			bucket.Material->Bind();
+			currentMaterial = bucket.Material;
+
+			// Renderer uniforms are not part of the material blocks, so they survive material binds
+			FakeRef<FakeShader> shader = bucket.Material->GetShader();
+			if (shader.Raw() != currentShader)
+				{
+				shader->SetUniform("r_ViewProjection", viewProjection);
+				currentShader = shader.Raw();
+				}
+			}
+
+		if (bucket.Mesh != currentMesh)
+			{
+			bucket.Mesh->GetVertexBuffer()->Bind();
+			Pipeline->Bind();
+			bucket.Mesh->GetIndexBuffer()->Bind();
+			currentMesh = bucket.Mesh;
+			}
+
+		uint32 commandOffset = (CommandBase + bucket.FirstCommand * 5) * sizeof(uint32);
+		uint32 countOffset = i * sizeof(uint32);
+		uint32 maxDrawCount = bucket.BatchCount;
+		FakeIndexFormat format = bucket.Mesh->GetIndexFormat();
+		bool depthTest = bucket.Material->HasFlag(FakeMaterialFlags::DepthTest);
+
+		FakeRenderer::Submit([=]()
+			{
+			FakeRendererAPI::DrawIndexedIndirect(commandOffset, countOffset, maxDrawCount, FakePrimitiveType::Triangles, depthTest, format);
+			});
+
+		Stats.DrawCalls++;
+		}
+
+	// Leave the default state behind for whatever is drawn next
+	FakeMaterial::ResetBindState();
+	}
+
+void FakeGPUScene::ResetStats()
+	{
+	// The sizes of the scene stay, only the counters of the frames are reset
+	Stats.DrawCalls = 0;
+	Stats.Dispatches = 0;
+	Stats.UploadedBytes = 0;
+	Stats.RebuildCount = 0;
+	}
@@ -0,0 +1,191 @@
+/*****************************************************************
+ * \file   FakeGPUScene.h
+ * \brief  
+ * 
+ * \author Can Karka
+ * \date   February 2021
+ * 
+ * Copyright (C) 2021 Can Karka
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *********************************************************************/
+
+#pragma once
+
+#include "Engine/Core/Maths/FakeMaths.h"
+#include "Engine/Renderer/FakeMesh.h"
+#include "Engine/Renderer/FakeMaterial.h"
+#include "Engine/Renderer/FakePipeline.h"
+#include "Engine/Renderer/FakeStorageBuffer.h"
+
+/**
+ *
+ * A handle to an instance of a FakeGPUScene, valid until the instance is removed.
+ *
+ */
+using FakeGPUSceneInstance = uint32;
+static const FakeGPUSceneInstance FakeGPUSceneInvalidInstance = ~0u;
+
+/**
+ *
+ * Renders meshes whose instances live on the GPU. The transforms and bounds are uploaded once and only changed
+ * transforms are uploaded again. A compute shader culls the instances against the view frustum and writes the draw
+ * commands, the CPU issues one indirect draw per material and mesh, no matter how many instances there are.
+ *
+ * Instances of the same submesh and material are drawn together, their order is decided by the GPU. Materials with
+ * FakeMaterialFlags::Blend need their instances sorted by depth, they belong into FakeSceneRenderer.
+ *
+ * The shaders of the materials read the per-instance attribute a_Transform, like the ones of FakeSceneRenderer.
+ *
+ */
+class FAKE_API FakeGPUScene : public FakeRefCounted
+	{
+	public:
+
+		struct Statistics
+			{
+			uint32 InstanceCount = 0;
+			uint32 BatchCount = 0;
+			uint32 BucketCount = 0;
+			uint32 DrawCalls = 0;
+			uint32 Dispatches = 0;
+			uint32 UploadedBytes = 0;
+			uint32 RebuildCount = 0;
+			};
+
+	private:
+
+		// The layouts of the storage blocks of the culling shader, std430
+		struct GPUInstance
+			{
+			FakeMat4f Transform;
+			FakeVec4f BoundsMin;
+			FakeVec4f BoundsMax;
+			uint32 Batch = 0;
+			uint32 Padding[3] = { 0, 0, 0 };
+			};
+
+		struct GPUBatch
+			{
+			uint32 IndexCount = 0;
+			uint32 FirstIndex = 0;
+			uint32 BaseInstance = 0;
+			uint32 InstanceCount = 0;
+			uint32 Bucket = 0;
+			uint32 FirstCommand = 0;
+			uint32 Padding[2] = { 0, 0 };
+			};
+
+		struct Entry
+			{
+			FakeRef<FakeMesh> Mesh;
+			FakeRef<FakeMaterial> Material;
+			uint32 Submesh = 0;
+			FakeGPUSceneInstance Handle = FakeGPUSceneInvalidInstance;
+			};
+
+		// The submeshes of one mesh drawn with one material, drawn by one indirect draw
+		struct Bucket
+			{
+			const FakeMesh *Mesh = nullptr;
+			const FakeMaterial *Material = nullptr;
+			uint32 FirstCommand = 0;
+			uint32 BatchCount = 0;
+			};
+
+		// Entries and GPUInstances are indexed by slot, removing an instance moves the last one into its slot
+		std::vector<Entry> Entries;
+		std::vector<GPUInstance> GPUInstances;
+		std::vector<uint32> Slots;
+		std::vector<FakeGPUSceneInstance> FreeHandles;
+
+		std::vector<GPUBatch> Batches;
+		std::vector<Bucket> Buckets;
+		uint32 CommandBase = 0;
+
+		FakeRef<FakeShader> CullShader;
+		FakeRef<FakeStorageBuffer> InstanceBuffer;
+		FakeRef<FakeStorageBuffer> BatchBuffer;
+		FakeRef<FakeStorageBuffer> IndirectBuffer;
+		FakeRef<FakeStorageBuffer> ParamsBuffer;
+		FakeRef<FakeVertexBuffer> VisibleBuffer;
+		FakeRef<FakePipeline> Pipeline;
+		uint32 InstanceCapacity = 0;
+		uint32 BatchCapacity = 0;
+
+		bool Dirty = true;
+		Statistics Stats;
+
+		void Rebuild();
+		void Reserve(uint32 instanceCount, uint32 batchCount);
+
+	public:
+
+		FakeGPUScene();
+
+		/**
+		 *
+		 * Adds an instance of a submesh. Adding or removing instances regroups all of them in the next Draw().
+		 *
+		 * @param mesh The mesh to draw.
+		 * @param submeshIndex The index into FakeMesh::GetSubmeshes().
+		 * @param material The material the submesh is drawn with.
+		 * @param transform The world transform.
+		 * @return Returns the handle of the instance.
+		 */
+		FakeGPUSceneInstance AddInstance(const FakeRef<FakeMesh> &mesh, uint32 submeshIndex, const FakeRef<FakeMaterial> &material, const FakeMat4f &transform);
+
+		/**
+		 *
+		 * Removes an instance, its handle may be handed out again.
+		 *
+		 * @param instance The handle of the instance.
+		 */
+		void RemoveInstance(FakeGPUSceneInstance instance);
+
+		/**
+		 *
+		 * Moves an instance, only its transform is uploaded again.
+		 *
+		 * @param instance The handle of the instance.
+		 * @param transform The new world transform.
+		 */
+		void SetTransform(FakeGPUSceneInstance instance, const FakeMat4f &transform);
+
+		/**
+		 *
+		 * Removes all instances.
+		 *
+		 */
+		void Clear();
+
+		/**
+		 *
+		 * Culls the instances and draws the visible ones into the bound render pass.
+		 *
+		 * @param viewProjection The camera matrix, the frustum is extracted from it and it is uploaded as the renderer uniform r_ViewProjection.
+		 */
+		void Draw(const FakeMat4f &viewProjection);
+
+		/**
+		 *
+		 * Returns the buffer the culling shader writes the draws into. It starts with the draw count of every bucket,
+		 * the commands of the batches follow at GetCommandBase(), counted in uints.
+		 *
+		 */
+		const FakeRef<FakeStorageBuffer> &GetIndirectBuffer() const { return IndirectBuffer; }
+		uint32 GetCommandBase() const { return CommandBase; }
+
+		void ResetStats();
+		Statistics GetStats() const { return Stats; }
+	};
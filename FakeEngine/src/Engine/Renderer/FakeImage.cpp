@@ -0,0 +1,37 @@
+#include "FakePch.h"
+#include "FakeImage.h"
+
+#include <stb_image.h>
+
+bool FakeImage::Decode(const Byte *data, int64 size, FakeImage &outImage)
+	{
+	if (!data || size <= 0)
+		return false;
+
+	// Textures are flipped on load, see FakeOpenGLTexture2D
+	stbi_set_flip_vertically_on_load_thread(1);
+
+	int32 width, height, channels;
+	Byte *pixels = stbi_load_from_memory(data, (int32)size, &width, &height, &channels, STBI_rgb_alpha);
+	if (!pixels)
+		{
+		FAKE_LOG_ERROR("Could not decode image: %s", stbi_failure_reason());
+		return false;
+		}
+
+	outImage.Pixels = pixels;
+	outImage.Width = width;
+	outImage.Height = height;
+	outImage.Format = FakeTextureFormat::RGBA;
+	outImage.Size = width * height * FakeTexture::GetBPP(FakeTextureFormat::RGBA);
+	return true;
+	}
+
+void FakeImage::Release()
+	{
+	if (Pixels)
+		stbi_image_free(Pixels);
+
+	Pixels = nullptr;
+	Size = 0;
+	}
@@ -0,0 +1,58 @@
+/*****************************************************************
+ * \file   FakeImage.h
+ * \brief  
+ * 
+ * \author Can Karka
+ * \date   February 2021
+ * 
+ * Copyright (C) 2021 Can Karka
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *********************************************************************/
+
+#pragma once
+
+#include "Engine/Renderer/FakeTexture.h"
+
+/**
+ *
+ * CPU side image data decoded from an encoded file in memory (png, jpg, tga, bmp, ...).
+ * Decoding does not touch the renderer, so it can be done on any thread.
+ *
+ */
+struct FAKE_API FakeImage
+	{
+	Byte *Pixels = nullptr;
+	uint32 Size = 0;
+	uint32 Width = 0;
+	uint32 Height = 0;
+	FakeTextureFormat Format = FakeTextureFormat::None;
+
+	/**
+	 *
+	 * Decodes an encoded image to RGBA8 pixels.
+	 *
+	 * @param data The encoded file contents.
+	 * @param size The size of the encoded file contents.
+	 * @param outImage The decoded image, release it with Release().
+	 * @return Returns true if the image has been decoded successfully.
+	 */
+	static bool Decode(const Byte *data, int64 size, FakeImage &outImage);
+
+	/**
+	 *
+	 * Frees the pixel data.
+	 *
+	 */
+	void Release();
+	};
@@ -1,19 +1,41 @@
 #include "FakePch.h"
 #include "FakeIndexBuffer.h"
 
+#include "FakeRendererAPI.h"
+#include "Engine/Platform/Null/FakeNullIndexBuffer.h"
 #include "Engine/Platform/OpenGL/FakeOpenGLIndexBuffer.h"
 
-FakeRef<FakeIndexBuffer> FakeIndexBuffer::Create(void *data, uint32 size)
+#ifdef FAKE_RENDERER_VULKAN
+#include "Engine/Platform/Vulkan/FakeVulkanIndexBuffer.h"
+#endif
+
+FakeRef<FakeIndexBuffer> FakeIndexBuffer::Create(void *data, uint32 size, FakeIndexFormat format)
 	{
+	if (FakeRendererAPI::IsHeadless())
+		return FakeRef<FakeNullIndexBuffer>::Create(data, size, format);
+
+	#ifdef FAKE_RENDERER_VULKAN
+		if (FakeRendererAPI::Current() == FakeRendererAPIType::Vulkan)
+			return FakeRef<FakeVulkanIndexBuffer>::Create(data, size, format);
+	#endif
+
 	#ifdef FAKE_RENDERER_OPENGL
-		return FakeRef<FakeOpenGLIndexBuffer>::Create(data, size);
+		return FakeRef<FakeOpenGLIndexBuffer>::Create(data, size, format);
 	#endif
 	}
 
-FakeRef<FakeIndexBuffer> FakeIndexBuffer::Create(uint32 size)
+FakeRef<FakeIndexBuffer> FakeIndexBuffer::Create(uint32 size, FakeIndexFormat format)
 	{
+	if (FakeRendererAPI::IsHeadless())
+		return FakeRef<FakeNullIndexBuffer>::Create(size, format);
+
+	#ifdef FAKE_RENDERER_VULKAN
+		if (FakeRendererAPI::Current() == FakeRendererAPIType::Vulkan)
+			return FakeRef<FakeVulkanIndexBuffer>::Create(size, format);
+	#endif
+
 	#ifdef FAKE_RENDERER_OPENGL
-		return FakeRef<FakeOpenGLIndexBuffer>::Create(size);
+		return FakeRef<FakeOpenGLIndexBuffer>::Create(size, format);
 	#endif
 	}
 
@@ -23,6 +23,7 @@
 #pragma once
 
 #include "Engine/Core/FakeAllocator.h"
+#include "Engine/Renderer/FakeRendererAPI.h"
 
  /**
   *
@@ -80,6 +81,14 @@ class FAKE_API FakeIndexBuffer : public FakeRefCounted
 		 */
 		virtual uint32 GetSize() const = 0;
 
+		/**
+		 *
+		 * Returns the type of the indices, which has to be passed on to FakeRenderer::DrawIndexed().
+		 *
+		 * @return Returns the type of the indices.
+		 */
+		virtual FakeIndexFormat GetFormat() const = 0;
+
 		/**
 		 *
 		 * Returns the RendererID where the data is bound to.
@@ -94,17 +103,19 @@ class FAKE_API FakeIndexBuffer : public FakeRefCounted
 		 *
 		 * @param data The indices that should be used in the buffer.
 		 * @param size The size of the indices that should be used in the buffer.
+		 * @param format The type of the indices, 16 bit indices halve the size of meshes with less than 65536 vertices.
 		 * @return Returns a new shared instance of the IndexBuffer.
 		 */
-		static FakeRef<FakeIndexBuffer> Create(void *data, uint32 size);
+		static FakeRef<FakeIndexBuffer> Create(void *data, uint32 size, FakeIndexFormat format = FakeIndexFormat::UInt32);
 
 		/**
 		 *
 		 * Creates a new shared IndexBuffer instance.
 		 *
 		 * @param size The size of the indices that should be used in the buffer.
+		 * @param format The type of the indices.
 		 * @return Returns a new shared instance of the IndexBuffer.
 		 */
-		static FakeRef<FakeIndexBuffer> Create(uint32 size);
+		static FakeRef<FakeIndexBuffer> Create(uint32 size, FakeIndexFormat format = FakeIndexFormat::UInt32);
 	};
 
@@ -1,4 +1,330 @@
 #include "FakePch.h"
 #include "FakeMaterial.h"
 
+#include "FakeMaterialInstance.h"
+#include "FakeRenderer.h"
 
+// The uniform values a shader stage holds, uniforms stay in the program between binds
+struct FakeMaterialResidentUniforms
+	{
+	uint64 BlockID = 0;
+	std::vector<Byte> Values;
+	};
+
+// Remembers what the last bound materials submitted, so binding the same state again costs nothing
+struct FakeMaterialBindState
+	{
+	const FakeShader *Shader = nullptr;
+	std::vector<const FakeTexture*> Textures;
+	bool Blend = true;
+
+	std::unordered_map<const FakeShader*, FakeMaterialResidentUniforms> ResidentVSUniforms;
+	std::unordered_map<const FakeShader*, FakeMaterialResidentUniforms> ResidentFSUniforms;
+
+	FakeMaterial::Statistics Stats;
+	};
+
+static FakeMaterialBindState BindState;
+static uint64 NextUniformBlockID = 1;
+
+namespace Utils
+	{
+	static const FakeShaderUniformBufferDeclaration *fake_material_uniform_buffer(const FakeShader *shader, FakeShaderDomain domain)
+		{
+		if (domain == FakeShaderDomain::Vertex)
+			return shader->HasVSMaterialUniformBuffer() ? &shader->GetVSMaterialUniformBuffer() : nullptr;
+
+		return shader->HasFSMaterialUniformBuffer() ? &shader->GetFSMaterialUniformBuffer() : nullptr;
+		}
+
+	static FakeRef<FakeMaterialUniformBlock> fake_create_uniform_block(const FakeShader *shader, FakeShaderDomain domain)
+		{
+		const FakeShaderUniformBufferDeclaration *declaration = fake_material_uniform_buffer(shader, domain);
+		if (!declaration || !declaration->GetSize())
+			return nullptr;
+
+		return FakeRef<FakeMaterialUniformBlock>::Create(declaration->GetSize());
+		}
+
+	static void fake_upload_uniform_block(const FakeShader *shader, FakeShaderDomain domain, const FakeMaterialUniformBlock *block)
+		{
+		if (!block)
+			return;
+
+		std::unordered_map<const FakeShader*, FakeMaterialResidentUniforms> &residentUniforms = domain == FakeShaderDomain::Vertex ? BindState.ResidentVSUniforms : BindState.ResidentFSUniforms;
+		FakeMaterialResidentUniforms &resident = residentUniforms[shader];
+
+		const Byte *values = block->Storage.Data;
+		uint32 size = block->Storage.Size;
+		uint32 begin = block->DirtyBegin;
+		uint32 end = block->DirtyEnd;
+
+		if (resident.Values.size() != size)
+			{
+			begin = 0;
+			end = size;
+			resident.Values.resize(size);
+			}
+		else if (resident.BlockID != block->ID)
+			{
+			// Another block has been uploaded in between, materials of one shader usually differ in a few values only
+			begin = 0;
+			while (begin < size && values[begin] == resident.Values[begin])
+				++begin;
+
+			end = size;
+			while (end > begin && values[end - 1] == resident.Values[end - 1])
+				--end;
+			}
+
+		resident.BlockID = block->ID;
+		block->DirtyBegin = 0;
+		block->DirtyEnd = 0;
+		if (begin >= end)
+			return;
+
+		memcpy(resident.Values.data() + begin, values + begin, end - begin);
+
+		// The block may change again before the command runs, so the command reads a copy
+		Byte *data = (Byte*)FakeRenderer::SubmitData(values, size);
+		shader->SetMaterialUniformRange(domain, FakeAllocator(data, size), begin, end);
+
+		BindState.Stats.UniformUploads++;
+		BindState.Stats.UniformBytes += end - begin;
+		}
+	}
+
+FakeMaterialUniformBlock::FakeMaterialUniformBlock(uint32 size)
+	: ID(NextUniformBlockID++)
+	{
+	Storage.Allocate(size);
+	Storage.ZeroInitialize();
+	}
+
+FakeMaterialUniformBlock::FakeMaterialUniformBlock(const FakeMaterialUniformBlock &other)
+	: ID(NextUniformBlockID++)
+	{
+	Storage = FakeAllocator::Copy(other.Storage.Data, other.Storage.Size);
+	}
+
+FakeMaterialUniformBlock::~FakeMaterialUniformBlock()
+	{
+	delete[] Storage.Data;
+	}
+
+void FakeMaterialUniformBlock::Write(uint32 offset, const void *data, uint32 size)
+	{
+	FAKE_ASSERT(offset + size <= Storage.Size, "Material uniform out of range!");
+	memcpy(Storage.Data + offset, data, size);
+
+	if (DirtyBegin == DirtyEnd)
+		{
+		DirtyBegin = offset;
+		DirtyEnd = offset + size;
+		}
+	else
+		{
+		if (offset < DirtyBegin)
+			DirtyBegin = offset;
+		if (offset + size > DirtyEnd)
+			DirtyEnd = offset + size;
+		}
+	}
+
+FakeMaterial::FakeMaterial(const FakeRef<FakeShader> &shader, uint32 flags)
+	: Shader(shader), Flags(flags)
+	{
+	FAKE_ASSERT(shader, "A material needs a shader!");
+
+	VSUniforms = Utils::fake_create_uniform_block(shader.Raw(), FakeShaderDomain::Vertex);
+	FSUniforms = Utils::fake_create_uniform_block(shader.Raw(), FakeShaderDomain::Fragment);
+
+	uint32 slotCount = 0;
+	for (const FakeShaderResourceDeclaration *resource : shader->GetResources())
+		slotCount += resource->GetCount();
+
+	Textures.resize(slotCount);
+	}
+
+FakeMaterial::~FakeMaterial()
+	{
+	FAKE_ASSERT(Instances.empty(), "Material destroyed while instances still use it!");
+	}
+
+void FakeMaterial::SetFlag(FakeMaterialFlags flag, bool enabled)
+	{
+	if (enabled)
+		Flags |= (uint32)flag;
+	else
+		Flags &= ~(uint32)flag;
+	}
+
+const FakeShaderUniformDeclaration *FakeMaterial::FindUniform(FakeShaderDomain domain, const FakeString &name, uint32 *outIndex) const
+	{
+	const FakeShaderUniformBufferDeclaration *declaration = Utils::fake_material_uniform_buffer(Shader.Raw(), domain);
+	if (!declaration)
+		return nullptr;
+
+	const FakeShaderUniformList &uniforms = declaration->GetUniformDeclarations();
+	for (uint32 i = 0; i < (uint32)uniforms.size(); ++i)
+		{
+		if (uniforms[i]->GetName() == name)
+			{
+			if (outIndex)
+				*outIndex = i;
+
+			return uniforms[i];
+			}
+		}
+
+	return nullptr;
+	}
+
+int32 FakeMaterial::FindTextureSlot(const FakeString &name) const
+	{
+	int32 slot = 0;
+	for (const FakeShaderResourceDeclaration *resource : Shader->GetResources())
+		{
+		if (resource->GetName() == name)
+			return slot;
+
+		slot += (int32)resource->GetCount();
+		}
+
+	return -1;
+	}
+
+void FakeMaterial::WriteUniform(FakeShaderDomain domain, uint32 index, uint32 offset, const void *data, uint32 size)
+	{
+	FakeRef<FakeMaterialUniformBlock> &block = domain == FakeShaderDomain::Vertex ? VSUniforms : FSUniforms;
+	block->Write(offset, data, size);
+
+	for (FakeMaterialInstance *instance : Instances)
+		instance->OnParentUniformChanged(domain, index, offset, data, size);
+	}
+
+void FakeMaterial::WriteTexture(uint32 slot, const FakeRef<FakeTexture> &texture)
+	{
+	Textures[slot] = texture;
+
+	for (FakeMaterialInstance *instance : Instances)
+		instance->OnParentTextureChanged(slot, texture);
+	}
+
+void FakeMaterial::SetUniformData(const FakeString &name, const void *data, uint32 size)
+	{
+	bool found = false;
+
+	// A uniform with the same name may live in both stages
+	for (FakeShaderDomain domain : { FakeShaderDomain::Vertex, FakeShaderDomain::Fragment })
+		{
+		uint32 index;
+		const FakeShaderUniformDeclaration *uniform = FindUniform(domain, name, &index);
+		if (!uniform)
+			continue;
+
+		FAKE_ASSERT(size <= uniform->GetSize(), "Material uniform has a different type!");
+		WriteUniform(domain, index, uniform->GetOffset(), data, size);
+		found = true;
+		}
+
+	if (!found)
+		FAKE_LOG_WARN("Shader %s has no material uniform %s", *Shader->GetName(), *name);
+	}
+
+const void *FakeMaterial::GetUniformData(const FakeString &name) const
+	{
+	if (const FakeShaderUniformDeclaration *uniform = FindUniform(FakeShaderDomain::Vertex, name))
+		return VSUniforms->Storage.Data + uniform->GetOffset();
+
+	if (const FakeShaderUniformDeclaration *uniform = FindUniform(FakeShaderDomain::Fragment, name))
+		return FSUniforms->Storage.Data + uniform->GetOffset();
+
+	return nullptr;
+	}
+
+void FakeMaterial::SetTexture(const FakeString &name, const FakeRef<FakeTexture> &texture)
+	{
+	int32 slot = FindTextureSlot(name);
+	if (slot < 0)
+		{
+		FAKE_LOG_WARN("Shader %s has no sampler %s", *Shader->GetName(), *name);
+		return;
+		}
+
+	WriteTexture((uint32)slot, texture);
+	}
+
+void FakeMaterial::Bind() const
+	{
+	const FakeShader *shader = Shader.Raw();
+	if (shader != BindState.Shader)
+		{
+		shader->Bind();
+		BindState.Shader = shader;
+		BindState.Stats.ShaderBinds++;
+		}
+	else
+		{
+		BindState.Stats.SkippedBinds++;
+		}
+
+	Utils::fake_upload_uniform_block(shader, FakeShaderDomain::Vertex, VSUniforms.Raw());
+	Utils::fake_upload_uniform_block(shader, FakeShaderDomain::Fragment, FSUniforms.Raw());
+
+	if (BindState.Textures.size() < Textures.size())
+		BindState.Textures.resize(Textures.size(), nullptr);
+
+	for (uint32 slot = 0; slot < (uint32)Textures.size(); ++slot)
+		{
+		const FakeTexture *texture = Textures[slot].Raw();
+		if (!texture)
+			continue;
+
+		if (texture != BindState.Textures[slot])
+			{
+			texture->Bind(slot);
+			BindState.Textures[slot] = texture;
+			BindState.Stats.TextureBinds++;
+			}
+		else
+			{
+			BindState.Stats.SkippedBinds++;
+			}
+		}
+
+	bool blend = HasFlag(FakeMaterialFlags::Blend);
+	if (blend != BindState.Blend)
+		{
+		FakeRenderer::SetBlend(blend);
+		BindState.Blend = blend;
+		BindState.Stats.BlendChanges++;
+		}
+	}
+
+FakeRef<FakeMaterial> FakeMaterial::Create(const FakeRef<FakeShader> &shader, uint32 flags)
+	{
+	return FakeRef<FakeMaterial>::Create(shader, flags);
+	}
+
+void FakeMaterial::ResetBindState()
+	{
+	if (!BindState.Blend)
+		{
+		FakeRenderer::SetBlend(true);
+		BindState.Blend = true;
+		}
+
+	BindState.Shader = nullptr;
+	BindState.Textures.clear();
+	}
+
+void FakeMaterial::ResetStats()
+	{
+	memset(&BindState.Stats, 0, sizeof(Statistics));
+	}
+
+FakeMaterial::Statistics FakeMaterial::GetStats()
+	{
+	return BindState.Stats;
+	}
@@ -23,17 +23,186 @@
 #pragma once
 
 #include "FakeMaterialFlags.h"
+#include "FakeShader.h"
+#include "FakeTexture.h"
+
+class FakeMaterialInstance;
+
+/**
+ *
+ * A packed copy of the material uniforms of one shader stage, laid out like the shader reflection.
+ * A material shares its blocks with its instances until an instance overrides a value.
+ *
+ */
+struct FAKE_API FakeMaterialUniformBlock : public FakeRefCounted
+	{
+	FakeAllocator Storage;
+
+	// Never reused, so the bind filter can tell which block a shader has seen last
+	uint64 ID;
+
+	// The bytes which changed since the last upload, uploading happens in the const Bind() of the material
+	mutable uint32 DirtyBegin = 0;
+	mutable uint32 DirtyEnd = 0;
+
+	FakeMaterialUniformBlock(uint32 size);
+	FakeMaterialUniformBlock(const FakeMaterialUniformBlock &other);
+	~FakeMaterialUniformBlock();
+
+	void Write(uint32 offset, const void *data, uint32 size);
+	};
 
 /**
  * 
- * .
+ * A shader with the uniform values, textures and render state it is drawn with. FakeSceneRenderer batches submissions by material.
  * 
  */
-class FakeMaterial : public FakeRefCounted
+class FAKE_API FakeMaterial : public FakeRefCounted
 	{
 	friend class FakeMaterialInstance;
 
 	public:
 
+		struct Statistics
+			{
+			uint32 ShaderBinds = 0;
+			uint32 TextureBinds = 0;
+			uint32 BlendChanges = 0;
+			uint32 UniformUploads = 0;
+			uint32 UniformBytes = 0;
+			uint32 SkippedBinds = 0;
+			};
+
+	protected:
+
+		FakeRef<FakeShader> Shader;
+		uint32 Flags;
+
+		FakeRef<FakeMaterialUniformBlock> VSUniforms;
+		FakeRef<FakeMaterialUniformBlock> FSUniforms;
+
+		// Indexed by sampler slot, in the order the shader declares its resources
+		std::vector<FakeRef<FakeTexture>> Textures;
+
+		std::vector<FakeMaterialInstance*> Instances;
+
+		const FakeShaderUniformDeclaration *FindUniform(FakeShaderDomain domain, const FakeString &name, uint32 *outIndex = nullptr) const;
+		int32 FindTextureSlot(const FakeString &name) const;
+
+		virtual void WriteUniform(FakeShaderDomain domain, uint32 index, uint32 offset, const void *data, uint32 size);
+		virtual void WriteTexture(uint32 slot, const FakeRef<FakeTexture> &texture);
+
+	public:
+
+		/**
+		 *
+		 * Creates a material, the uniform blocks are laid out from the reflection of the shader.
+		 *
+		 * @param shader The shader the material is drawn with.
+		 * @param flags A combination of FakeMaterialFlags.
+		 */
+		FakeMaterial(const FakeRef<FakeShader> &shader, uint32 flags = (uint32)FakeMaterialFlags::DepthTest);
+
+		virtual ~FakeMaterial();
+
+		/**
+		 *
+		 * Enables or disables a flag.
+		 *
+		 * @param flag The flag to change.
+		 * @param enabled Whether the flag should be set.
+		 */
+		void SetFlag(FakeMaterialFlags flag, bool enabled = true);
+
+		/**
+		 *
+		 * Sets a uniform of either shader stage. Instances which did not override the uniform follow the change.
+		 *
+		 * @param name The name of the uniform in the shader.
+		 * @param value The new value, it has to match the type of the uniform.
+		 */
+		template<typename T>
+		void Set(const FakeString &name, const T &value)
+			{
+			SetUniformData(name, &value, sizeof(T));
+			}
+
+		/**
+		 *
+		 * Returns the value of a uniform.
+		 *
+		 * @param name The name of the uniform in the shader.
+		 * @return Returns the value of the uniform.
+		 */
+		template<typename T>
+		const T &Get(const FakeString &name) const
+			{
+			const void *data = GetUniformData(name);
+			FAKE_ASSERT(data, "Material uniform not found!");
+			return *(const T*)data;
+			}
 
+		/**
+		 *
+		 * Sets the raw bytes of a uniform of either shader stage.
+		 *
+		 * @param name The name of the uniform in the shader.
+		 * @param data The new value.
+		 * @param size The size of the new value in bytes.
+		 */
+		void SetUniformData(const FakeString &name, const void *data, uint32 size);
+
+		/**
+		 *
+		 * Returns the bytes of a uniform inside the packed block.
+		 *
+		 * @param name The name of the uniform in the shader.
+		 * @return Returns nullptr if the shader has no material uniform with this name.
+		 */
+		const void *GetUniformData(const FakeString &name) const;
+
+		/**
+		 *
+		 * Sets the texture of a sampler declared by the shader.
+		 *
+		 * @param name The name of the sampler in the shader.
+		 * @param texture The texture to bind to the sampler.
+		 */
+		void SetTexture(const FakeString &name, const FakeRef<FakeTexture> &texture);
+
+		/**
+		 *
+		 * Binds the shader, uploads the uniforms and binds the textures and blend state.
+		 * Only state which differs from the last bound material is submitted, and only the range of
+		 * uniform bytes which differs from what the shader holds is uploaded.
+		 *
+		 */
+		void Bind() const;
+
+		bool HasFlag(FakeMaterialFlags flag) const { return (Flags & (uint32)flag) != 0; }
+		uint32 GetFlags() const { return Flags; }
+		const FakeRef<FakeShader> &GetShader() const { return Shader; }
+
+		/**
+		 *
+		 * Creates a new shared material.
+		 *
+		 * @param shader The shader the material is drawn with.
+		 * @param flags A combination of FakeMaterialFlags.
+		 * @return Returns the new material.
+		 */
+		static FakeRef<FakeMaterial> Create(const FakeRef<FakeShader> &shader, uint32 flags = (uint32)FakeMaterialFlags::DepthTest);
+
+		/**
+		 *
+		 * Forgets which shader, textures and blend state are bound and restores blending, which is the renderer default.
+		 * Has to be called whenever code outside of the materials may have changed the bound state, FakeSceneRenderer does this for every scene.
+		 * The uniform values a shader holds are kept, because nothing else writes material uniforms.
+		 *
+		 */
+		static void ResetBindState();
+
+		static void ResetStats();
+		static Statistics GetStats();
 	};
+
@@ -1,3 +1,103 @@
 #include "FakePch.h"
 #include "FakeMaterialInstance.h"
 
+FakeMaterialInstance::FakeMaterialInstance(const FakeRef<FakeMaterial> &parent)
+	: FakeMaterial(parent->Shader, parent->Flags), Parent(parent)
+	{
+	VSUniforms = parent->VSUniforms;
+	FSUniforms = parent->FSUniforms;
+	Textures = parent->Textures;
+
+	if (VSUniforms)
+		OverriddenVSUniforms.resize(Shader->GetVSMaterialUniformBuffer().GetUniformDeclarations().size(), false);
+	if (FSUniforms)
+		OverriddenFSUniforms.resize(Shader->GetFSMaterialUniformBuffer().GetUniformDeclarations().size(), false);
+	OverriddenTextures.resize(Textures.size(), false);
+
+	Parent->Instances.push_back(this);
+	}
+
+FakeMaterialInstance::~FakeMaterialInstance()
+	{
+	std::vector<FakeMaterialInstance*> &siblings = Parent->Instances;
+	siblings.erase(std::find(siblings.begin(), siblings.end(), this));
+	}
+
+void FakeMaterialInstance::OnParentUniformChanged(FakeShaderDomain domain, uint32 index, uint32 offset, const void *data, uint32 size)
+	{
+	std::vector<bool> &overridden = domain == FakeShaderDomain::Vertex ? OverriddenVSUniforms : OverriddenFSUniforms;
+	if (overridden[index])
+		return;
+
+	const FakeRef<FakeMaterialUniformBlock> &block = domain == FakeShaderDomain::Vertex ? VSUniforms : FSUniforms;
+	const FakeRef<FakeMaterialUniformBlock> &parentBlock = domain == FakeShaderDomain::Vertex ? Parent->VSUniforms : Parent->FSUniforms;
+	if (block.Raw() != parentBlock.Raw())
+		{
+		FakeMaterial::WriteUniform(domain, index, offset, data, size);
+		return;
+		}
+
+	// The shared block has been written already, only instances with a copy of their own need the value
+	for (FakeMaterialInstance *instance : Instances)
+		instance->OnParentUniformChanged(domain, index, offset, data, size);
+	}
+
+void FakeMaterialInstance::OnParentTextureChanged(uint32 slot, const FakeRef<FakeTexture> &texture)
+	{
+	if (!OverriddenTextures[slot])
+		FakeMaterial::WriteTexture(slot, texture);
+	}
+
+void FakeMaterialInstance::ShareUniformBlock(FakeShaderDomain domain, const FakeMaterialUniformBlock *previous, const FakeRef<FakeMaterialUniformBlock> &block)
+	{
+	for (FakeMaterialInstance *instance : Instances)
+		{
+		FakeRef<FakeMaterialUniformBlock> &instanceBlock = domain == FakeShaderDomain::Vertex ? instance->VSUniforms : instance->FSUniforms;
+		if (instanceBlock.Raw() != previous)
+			continue;
+
+		instanceBlock = block;
+		instance->ShareUniformBlock(domain, previous, block);
+		}
+	}
+
+void FakeMaterialInstance::WriteUniform(FakeShaderDomain domain, uint32 index, uint32 offset, const void *data, uint32 size)
+	{
+	FakeRef<FakeMaterialUniformBlock> &block = domain == FakeShaderDomain::Vertex ? VSUniforms : FSUniforms;
+	const FakeRef<FakeMaterialUniformBlock> &parentBlock = domain == FakeShaderDomain::Vertex ? Parent->VSUniforms : Parent->FSUniforms;
+	if (block.Raw() == parentBlock.Raw())
+		{
+		FakeRef<FakeMaterialUniformBlock> copy = FakeRef<FakeMaterialUniformBlock>::Create(*parentBlock);
+		ShareUniformBlock(domain, block.Raw(), copy);
+		block = copy;
+		}
+
+	std::vector<bool> &overridden = domain == FakeShaderDomain::Vertex ? OverriddenVSUniforms : OverriddenFSUniforms;
+	overridden[index] = true;
+
+	FakeMaterial::WriteUniform(domain, index, offset, data, size);
+	}
+
+void FakeMaterialInstance::WriteTexture(uint32 slot, const FakeRef<FakeTexture> &texture)
+	{
+	OverriddenTextures[slot] = true;
+	FakeMaterial::WriteTexture(slot, texture);
+	}
+
+bool FakeMaterialInstance::IsOverridden(const FakeString &name) const
+	{
+	uint32 index;
+	if (FindUniform(FakeShaderDomain::Vertex, name, &index) && OverriddenVSUniforms[index])
+		return true;
+
+	if (FindUniform(FakeShaderDomain::Fragment, name, &index) && OverriddenFSUniforms[index])
+		return true;
+
+	int32 slot = FindTextureSlot(name);
+	return slot >= 0 && OverriddenTextures[slot];
+	}
+
+FakeRef<FakeMaterialInstance> FakeMaterialInstance::Create(const FakeRef<FakeMaterial> &parent)
+	{
+	return FakeRef<FakeMaterialInstance>::Create(parent);
+	}
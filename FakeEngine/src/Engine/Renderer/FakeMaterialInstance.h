@@ -26,14 +26,65 @@
 
 /**
  * 
- * .
+ * A material which shares the shader, uniforms and textures of its parent and overrides some of them.
+ * The uniform blocks of the parent are only copied when a value is overridden for the first time,
+ * values which were not overridden keep following the parent.
  * 
  */
-class FakeMaterialInstance : public FakeRefCounted
+class FAKE_API FakeMaterialInstance : public FakeMaterial
 	{
 	friend class FakeMaterial;
 
+	private:
+
+		FakeRef<FakeMaterial> Parent;
+
+		// Indexed like the uniform declarations of the stage and the texture slots
+		std::vector<bool> OverriddenVSUniforms;
+		std::vector<bool> OverriddenFSUniforms;
+		std::vector<bool> OverriddenTextures;
+
+		void OnParentUniformChanged(FakeShaderDomain domain, uint32 index, uint32 offset, const void *data, uint32 size);
+		void OnParentTextureChanged(uint32 slot, const FakeRef<FakeTexture> &texture);
+
+		// Instances further down share the block of this instance until they override a value themselves
+		void ShareUniformBlock(FakeShaderDomain domain, const FakeMaterialUniformBlock *previous, const FakeRef<FakeMaterialUniformBlock> &block);
+
+	protected:
+
+		virtual void WriteUniform(FakeShaderDomain domain, uint32 index, uint32 offset, const void *data, uint32 size) override;
+		virtual void WriteTexture(uint32 slot, const FakeRef<FakeTexture> &texture) override;
+
 	public:
 
+		/**
+		 *
+		 * Creates an instance which starts out with the values and flags of its parent.
+		 *
+		 * @param parent The material to inherit from.
+		 */
+		FakeMaterialInstance(const FakeRef<FakeMaterial> &parent);
+
+		virtual ~FakeMaterialInstance();
+
+		const FakeRef<FakeMaterial> &GetParent() const { return Parent; }
 
+		/**
+		 *
+		 * Returns true if the uniform is stored in a copy owned by this instance.
+		 *
+		 * @param name The name of the uniform in the shader.
+		 * @return Returns true if the uniform has been overridden.
+		 */
+		bool IsOverridden(const FakeString &name) const;
+
+		/**
+		 *
+		 * Creates a new instance of a material.
+		 *
+		 * @param parent The material to inherit from.
+		 * @return Returns the new instance.
+		 */
+		static FakeRef<FakeMaterialInstance> Create(const FakeRef<FakeMaterial> &parent);
 	};
+
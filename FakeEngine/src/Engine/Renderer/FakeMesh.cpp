@@ -1,3 +1,152 @@
 #include "FakePch.h"
 #include "FakeMesh.h"
 
+#include "Engine/Core/FakeMappedFile.h"
+
+static_assert(sizeof(FakeMeshVertex) == 24, "The vertex layout does not match FakeMeshVertex!");
+static_assert(sizeof(FakeMeshFileHeader) == 72, "The mesh file header must not contain padding!");
+static_assert(sizeof(FakeMeshFileSubmesh) == 44, "The mesh file submesh must not contain padding!");
+
+namespace Utils
+	{
+	static FakeAABB fake_file_bounds(const float *min, const float *max)
+		{
+		return FakeAABB(FakeVec3f(min[0], min[1], min[2]), FakeVec3f(max[0], max[1], max[2]));
+		}
+
+	static bool fake_validate_range(uint64 offset, uint64 size, uint64 fileSize)
+		{
+		return offset % 4 == 0 && offset <= fileSize && size <= fileSize - offset;
+		}
+
+	template<typename T>
+	static bool fake_validate_indices(const T *indices, uint32 count, uint32 vertexCount)
+		{
+		// Only the largest index matters, which keeps the loop free of branches
+		T maxIndex = 0;
+		for (uint32 i = 0; i < count; ++i)
+			maxIndex = std::max(maxIndex, indices[i]);
+
+		return (uint32)maxIndex < vertexCount;
+		}
+	}
+
+FakeMesh::FakeMesh(const Byte *data)
+	{
+	const FakeMeshFileHeader &header = *(const FakeMeshFileHeader*)data;
+	VertexCount = header.VertexCount;
+	IndexCount = header.IndexCount;
+	IndexFormat = (FakeIndexFormat)header.IndexFormat;
+	Bounds = Utils::fake_file_bounds(header.BoundsMin, header.BoundsMax);
+
+	const FakeMeshFileSubmesh *submeshes = (const FakeMeshFileSubmesh*)(data + header.SubmeshOffset);
+	Submeshes.resize(header.SubmeshCount);
+	for (uint32 i = 0; i < header.SubmeshCount; ++i)
+		{
+		FakeSubmesh &submesh = Submeshes[i];
+		submesh.BaseIndex = submeshes[i].BaseIndex;
+		submesh.IndexCount = submeshes[i].IndexCount;
+		submesh.BaseVertex = submeshes[i].BaseVertex;
+		submesh.VertexCount = submeshes[i].VertexCount;
+		submesh.MaterialIndex = submeshes[i].MaterialIndex;
+		submesh.Bounds = Utils::fake_file_bounds(submeshes[i].BoundsMin, submeshes[i].BoundsMax);
+		}
+
+	// Both buffers keep their own copy until the upload, the file can be unmapped right away
+	uint32 indexSize = IndexFormat == FakeIndexFormat::UInt16 ? sizeof(uint16) : sizeof(uint32);
+	VertexBuffer = FakeVertexBuffer::Create((void*)(data + header.VertexOffset), VertexCount * sizeof(FakeMeshVertex), FakeVertexBufferUsage::Static);
+	VertexBuffer->SetLayout(GetVertexLayout());
+	IndexBuffer = FakeIndexBuffer::Create((void*)(data + header.IndexOffset), IndexCount * indexSize, IndexFormat);
+	}
+
+FakeRef<FakeMesh> FakeMesh::Create(const FakeString &path)
+	{
+	FakeMappedFile file;
+	if (!file.Open(path))
+		{
+		FAKE_LOG_ERROR("Could not open mesh file %s!", *path);
+		return {};
+		}
+
+	return Create(file.GetData(), file.GetSize());
+	}
+
+FakeRef<FakeMesh> FakeMesh::Create(const Byte *data, uint64 size)
+	{
+	if (!Validate(data, size))
+		return {};
+
+	return FakeRef<FakeMesh>::Create(data);
+	}
+
+bool FakeMesh::Validate(const Byte *data, uint64 size)
+	{
+	if (size < sizeof(FakeMeshFileHeader))
+		{
+		FAKE_LOG_ERROR("Mesh file is truncated!");
+		return false;
+		}
+
+	const FakeMeshFileHeader &header = *(const FakeMeshFileHeader*)data;
+	if (header.Magic != Magic)
+		{
+		FAKE_LOG_ERROR("Not a cooked mesh file!");
+		return false;
+		}
+
+	if (header.Version != Version)
+		{
+		FAKE_LOG_ERROR("Mesh file has version %d, expected version %d!", header.Version, Version);
+		return false;
+		}
+
+	if (header.VertexCount == 0 || header.IndexCount == 0 || header.IndexCount % 3 != 0 || header.IndexFormat > (uint32)FakeIndexFormat::UInt16)
+		{
+		FAKE_LOG_ERROR("Mesh file has an invalid header!");
+		return false;
+		}
+
+	uint64 indexSize = header.IndexFormat == (uint32)FakeIndexFormat::UInt16 ? sizeof(uint16) : sizeof(uint32);
+	if (!Utils::fake_validate_range(header.VertexOffset, (uint64)header.VertexCount * sizeof(FakeMeshVertex), size)
+		|| !Utils::fake_validate_range(header.IndexOffset, (uint64)header.IndexCount * indexSize, size)
+		|| !Utils::fake_validate_range(header.SubmeshOffset, (uint64)header.SubmeshCount * sizeof(FakeMeshFileSubmesh), size))
+		{
+		FAKE_LOG_ERROR("Mesh file is truncated!");
+		return false;
+		}
+
+	const FakeMeshFileSubmesh *submeshes = (const FakeMeshFileSubmesh*)(data + header.SubmeshOffset);
+	for (uint32 i = 0; i < header.SubmeshCount; ++i)
+		{
+		const FakeMeshFileSubmesh &submesh = submeshes[i];
+		if ((uint64)submesh.BaseIndex + submesh.IndexCount > header.IndexCount || (uint64)submesh.BaseVertex + submesh.VertexCount > header.VertexCount)
+			{
+			FAKE_LOG_ERROR("Mesh file has an invalid submesh!");
+			return false;
+			}
+		}
+
+	// An index past the vertices would make the GPU read outside of the buffer
+	bool validIndices = header.IndexFormat == (uint32)FakeIndexFormat::UInt16
+		? Utils::fake_validate_indices((const uint16*)(data + header.IndexOffset), header.IndexCount, header.VertexCount)
+		: Utils::fake_validate_indices((const uint32*)(data + header.IndexOffset), header.IndexCount, header.VertexCount);
+
+	if (!validIndices)
+		{
+		FAKE_LOG_ERROR("Mesh file has indices out of range!");
+		return false;
+		}
+
+	return true;
+	}
+
+const FakeVertexBufferLayout &FakeMesh::GetVertexLayout()
+	{
+	static const FakeVertexBufferLayout layout = {
+		{ FakeShaderDataType::Float3, "a_Position" },
+		{ FakeShaderDataType::Short4, "a_Normal", true },
+		{ FakeShaderDataType::Half2, "a_TexCoord" }
+		};
+
+	return layout;
+	}
@@ -22,14 +22,143 @@
 
 #pragma once
 
+#include "Engine/Core/Maths/FakeMaths.h"
+#include "Engine/Renderer/FakeVertexBuffer.h"
+#include "Engine/Renderer/FakeIndexBuffer.h"
+
 /**
- * 
- * .
- * 
+ *
+ * A range of the index buffer which is drawn with one material.
+ *
+ */
+struct FakeSubmesh
+	{
+	uint32 BaseIndex = 0;
+	uint32 IndexCount = 0;
+
+	// The vertices used by the submesh, stored next to each other
+	uint32 BaseVertex = 0;
+	uint32 VertexCount = 0;
+
+	uint32 MaterialIndex = 0;
+	FakeAABB Bounds;
+	};
+
+/**
+ *
+ * The vertex of a cooked mesh, 24 bytes instead of 32 with float normals and texture coordinates.
+ * The shader still reads a vec3 position, a vec4 normal and a vec2 texture coordinate, see FakeMesh::GetVertexLayout().
+ *
  */
-class FakeMesh : public FakeRefCounted
+struct FakeMeshVertex
 	{
+	float Position[3];
+	int16 Normal[4];     // Signed normalized, W is always 0
+	uint16 TexCoord[2];  // Half floats, so tiled coordinates outside of [0, 1] keep working
+	};
+
+// Cooked mesh files are written by FakeMeshCooker, all offsets start at the beginning of the file
+struct FakeMeshFileHeader
+	{
+	uint32 Magic;
+	uint32 Version;
+	uint32 VertexCount;
+	uint32 IndexCount;
+	uint32 IndexFormat;
+	uint32 SubmeshCount;
+	float BoundsMin[3];
+	float BoundsMax[3];
+	uint64 VertexOffset;
+	uint64 IndexOffset;
+	uint64 SubmeshOffset;
+	};
+
+struct FakeMeshFileSubmesh
+	{
+	uint32 BaseIndex;
+	uint32 IndexCount;
+	uint32 BaseVertex;
+	uint32 VertexCount;
+	uint32 MaterialIndex;
+	float BoundsMin[3];
+	float BoundsMax[3];
+	};
+
+/**
+ *
+ * A static triangle mesh on the GPU, loaded from a file cooked by FakeMeshCooker or created by FakeMeshFactory.
+ *
+ * The cooked file already holds the final vertex and index buffers, loading maps the file into memory,
+ * validates it and uploads both buffers without converting anything.
+ *
+ */
+class FAKE_API FakeMesh : public FakeRefCounted
+	{
+	private:
+		FakeRef<FakeVertexBuffer> VertexBuffer;
+		FakeRef<FakeIndexBuffer> IndexBuffer;
+		std::vector<FakeSubmesh> Submeshes;
+		FakeAABB Bounds;
+		uint32 VertexCount = 0;
+		uint32 IndexCount = 0;
+		FakeIndexFormat IndexFormat = FakeIndexFormat::UInt32;
+
 	public:
 
+		static const uint32 Magic = 0x534D4B46; // "FKMS"
+		static const uint32 Version = 1;
+
+		/**
+		 *
+		 * Uploads a cooked mesh, use Create() instead which validates the data first.
+		 *
+		 * @param data The contents of a valid cooked mesh file.
+		 */
+		FakeMesh(const Byte *data);
+
+		/**
+		 *
+		 * Maps a cooked mesh file into memory and uploads it.
+		 *
+		 * @param path The physical path to the file on the disk.
+		 * @return Returns the new mesh or an empty reference if the file could not be loaded.
+		 */
+		static FakeRef<FakeMesh> Create(const FakeString &path);
 
+		/**
+		 *
+		 * Uploads a cooked mesh from memory.
+		 *
+		 * @param data The contents of a cooked mesh file.
+		 * @param size The size of the data in bytes.
+		 * @return Returns the new mesh or an empty reference if the data is invalid.
+		 */
+		static FakeRef<FakeMesh> Create(const Byte *data, uint64 size);
+
+		/**
+		 *
+		 * Checks the header, the submeshes and every index of a cooked mesh without touching the GPU.
+		 *
+		 * @param data The contents of a cooked mesh file.
+		 * @param size The size of the data in bytes.
+		 * @return Returns true if the data can be uploaded.
+		 */
+		static bool Validate(const Byte *data, uint64 size);
+
+		/**
+		 *
+		 * Returns the layout of FakeMeshVertex, the attributes are a_Position, a_Normal and a_TexCoord.
+		 *
+		 * @return Returns the vertex layout shared by all meshes.
+		 */
+		static const FakeVertexBufferLayout &GetVertexLayout();
+
+		const FakeRef<FakeVertexBuffer> &GetVertexBuffer() const { return VertexBuffer; }
+		const FakeRef<FakeIndexBuffer> &GetIndexBuffer() const { return IndexBuffer; }
+		const std::vector<FakeSubmesh> &GetSubmeshes() const { return Submeshes; }
+		const FakeAABB &GetBounds() const { return Bounds; }
+		uint32 GetVertexCount() const { return VertexCount; }
+		uint32 GetIndexCount() const { return IndexCount; }
+		FakeIndexFormat GetIndexFormat() const { return IndexFormat; }
 	};
+
@@ -0,0 +1,296 @@
+#include "FakePch.h"
+#include "FakeMeshCooker.h"
+
+#include <fstream>
+#include <assimp/Importer.hpp>
+#include <assimp/scene.h>
+#include <assimp/postprocess.h>
+
+#include "FakeMeshOptimizer.h"
+
+namespace Utils
+	{
+	static int16 fake_quantize_snorm16(float value)
+		{
+		value = value < -1.0f ? -1.0f : (value > 1.0f ? 1.0f : value);
+		return (int16)(value * 32767.0f + (value >= 0.0f ? 0.5f : -0.5f));
+		}
+
+	static uint16 fake_quantize_half(float value)
+		{
+		uint32 bits;
+		memcpy(&bits, &value, sizeof(float));
+
+		uint32 sign = (bits >> 16) & 0x8000;
+		uint32 magnitude = bits & 0x7fffffff;
+
+		// Rebias the exponent from 127 to 15 and round the mantissa to nearest
+		uint32 half = (magnitude - (112 << 23) + (1 << 12)) >> 13;
+
+		// Too small for a normalized half, texture coordinates never need denormals
+		if (magnitude < (113 << 23))
+			half = 0;
+
+		if (magnitude >= (143 << 23))
+			half = 0x7c00;
+
+		if (magnitude > (255 << 23))
+			half = 0x7e00;
+
+		return (uint16)(sign | half);
+		}
+
+	static FakeMeshVertex fake_quantize_vertex(const FakeMeshSourceVertex &source)
+		{
+		FakeVec3f normal = source.Normal.GetNormalized();
+
+		FakeMeshVertex vertex;
+		vertex.Position[0] = source.Position.X;
+		vertex.Position[1] = source.Position.Y;
+		vertex.Position[2] = source.Position.Z;
+		vertex.Normal[0] = fake_quantize_snorm16(normal.X);
+		vertex.Normal[1] = fake_quantize_snorm16(normal.Y);
+		vertex.Normal[2] = fake_quantize_snorm16(normal.Z);
+		vertex.Normal[3] = 0;
+		vertex.TexCoord[0] = fake_quantize_half(source.TexCoord.X);
+		vertex.TexCoord[1] = fake_quantize_half(source.TexCoord.Y);
+		return vertex;
+		}
+
+	static void fake_write_bounds(const FakeAABB &bounds, float *min, float *max)
+		{
+		min[0] = bounds.Min.X;
+		min[1] = bounds.Min.Y;
+		min[2] = bounds.Min.Z;
+		max[0] = bounds.Max.X;
+		max[1] = bounds.Max.Y;
+		max[2] = bounds.Max.Z;
+		}
+
+	static uint64 fake_align(uint64 offset)
+		{
+		return (offset + 15) & ~(uint64)15;
+		}
+	}
+
+bool FakeMeshCooker::Import(const FakeString &path, FakeMeshSource &outSource)
+	{
+	const uint32 flags = aiProcess_Triangulate
+		| aiProcess_JoinIdenticalVertices
+		| aiProcess_GenSmoothNormals
+		| aiProcess_PreTransformVertices
+		| aiProcess_SortByPType
+		| aiProcess_FindInvalidData
+		| aiProcess_ValidateDataStructure;
+
+	Assimp::Importer importer;
+	const aiScene *scene = importer.ReadFile(*path, flags);
+	if (!scene || !scene->HasMeshes())
+		{
+		FAKE_LOG_ERROR("Could not import mesh %s: %s", *path, importer.GetErrorString());
+		return false;
+		}
+
+	outSource.Vertices.clear();
+	outSource.Indices.clear();
+	outSource.Submeshes.clear();
+
+	for (uint32 m = 0; m < scene->mNumMeshes; ++m)
+		{
+		const aiMesh *mesh = scene->mMeshes[m];
+
+		// Points and lines are sorted into meshes of their own
+		if (!(mesh->mPrimitiveTypes & aiPrimitiveType_TRIANGLE))
+			continue;
+
+		uint32 baseVertex = (uint32)outSource.Vertices.size();
+		for (uint32 i = 0; i < mesh->mNumVertices; ++i)
+			{
+			FakeMeshSourceVertex vertex;
+			vertex.Position = FakeVec3f(mesh->mVertices[i].x, mesh->mVertices[i].y, mesh->mVertices[i].z);
+			vertex.Normal = mesh->HasNormals() ? FakeVec3f(mesh->mNormals[i].x, mesh->mNormals[i].y, mesh->mNormals[i].z) : FakeVec3f(0.0f, 1.0f, 0.0f);
+			vertex.TexCoord = mesh->HasTextureCoords(0) ? FakeVec2f(mesh->mTextureCoords[0][i].x, mesh->mTextureCoords[0][i].y) : FakeVec2f(0.0f, 0.0f);
+			outSource.Vertices.push_back(vertex);
+			}
+
+		FakeSubmesh submesh;
+		submesh.BaseIndex = (uint32)outSource.Indices.size();
+		submesh.MaterialIndex = mesh->mMaterialIndex;
+
+		for (uint32 i = 0; i < mesh->mNumFaces; ++i)
+			{
+			const aiFace &face = mesh->mFaces[i];
+			if (face.mNumIndices != 3)
+				continue;
+
+			outSource.Indices.push_back(baseVertex + face.mIndices[0]);
+			outSource.Indices.push_back(baseVertex + face.mIndices[1]);
+			outSource.Indices.push_back(baseVertex + face.mIndices[2]);
+			}
+
+		submesh.IndexCount = (uint32)outSource.Indices.size() - submesh.BaseIndex;
+		outSource.Submeshes.push_back(submesh);
+		}
+
+	if (outSource.Indices.empty())
+		{
+		FAKE_LOG_ERROR("Mesh %s does not contain any triangles!", *path);
+		return false;
+		}
+
+	return true;
+	}
+
+void FakeMeshCooker::Cook(const FakeMeshSource &source, std::vector<Byte> &outData, const FakeMeshCookOptions &options)
+	{
+	std::vector<FakeSubmesh> sourceSubmeshes = source.Submeshes;
+	if (sourceSubmeshes.empty())
+		{
+		FakeSubmesh all;
+		all.IndexCount = (uint32)source.Indices.size();
+		sourceSubmeshes.push_back(all);
+		}
+
+	std::vector<FakeMeshVertex> vertices;
+	std::vector<uint32> indices;
+	std::vector<FakeMeshFileSubmesh> submeshes;
+	vertices.reserve(source.Vertices.size());
+	indices.reserve(source.Indices.size());
+
+	FakeAABB meshBounds(FakeVec3f(std::numeric_limits<float>::max()), FakeVec3f(-std::numeric_limits<float>::max()));
+
+	// Scratch memory reused by every submesh, the remap table is reset after each one
+	std::vector<uint32> localRemap(source.Vertices.size(), ~0u);
+	std::vector<uint32> localVertices;
+	std::vector<uint32> localIndices;
+	std::vector<uint32> optimized;
+	std::vector<uint32> fetchRemap;
+	std::vector<FakeVec3f> positions;
+
+	for (const FakeSubmesh &sourceSubmesh : sourceSubmeshes)
+		{
+		FAKE_ASSERT(sourceSubmesh.IndexCount % 3 == 0);
+
+		// Number the vertices of the submesh from zero, so the passes only see its own vertices
+		uint32 indexCount = sourceSubmesh.IndexCount;
+		localVertices.clear();
+		localIndices.resize(indexCount);
+		for (uint32 i = 0; i < indexCount; ++i)
+			{
+			uint32 vertex = source.Indices[sourceSubmesh.BaseIndex + i];
+			if (localRemap[vertex] == ~0u)
+				{
+				localRemap[vertex] = (uint32)localVertices.size();
+				localVertices.push_back(vertex);
+				}
+
+			localIndices[i] = localRemap[vertex];
+			}
+
+		for (uint32 vertex : localVertices)
+			localRemap[vertex] = ~0u;
+
+		uint32 vertexCount = (uint32)localVertices.size();
+		optimized.resize(indexCount);
+
+		if (options.OptimizeVertexCache)
+			{
+			FakeMeshOptimizer::OptimizeVertexCache(optimized.data(), localIndices.data(), indexCount, vertexCount, options.CacheSize);
+			localIndices.swap(optimized);
+			}
+
+		if (options.OptimizeOverdraw)
+			{
+			positions.resize(vertexCount);
+			for (uint32 i = 0; i < vertexCount; ++i)
+				positions[i] = source.Vertices[localVertices[i]].Position;
+
+			FakeMeshOptimizer::OptimizeOverdraw(optimized.data(), localIndices.data(), indexCount, positions.data(), vertexCount, options.OverdrawThreshold, options.CacheSize);
+			localIndices.swap(optimized);
+			}
+
+		if (options.OptimizeVertexFetch)
+			{
+			fetchRemap.resize(vertexCount);
+			FakeMeshOptimizer::OptimizeVertexFetch(fetchRemap.data(), localIndices.data(), indexCount, vertexCount);
+
+			// Every local vertex is used, so the remap is a permutation
+			optimized.resize(vertexCount);
+			FakeMeshOptimizer::RemapVertices(optimized.data(), localVertices.data(), vertexCount, fetchRemap.data());
+			localVertices.swap(optimized);
+			}
+
+		FakeMeshFileSubmesh submesh;
+		submesh.BaseIndex = (uint32)indices.size();
+		submesh.IndexCount = indexCount;
+		submesh.BaseVertex = (uint32)vertices.size();
+		submesh.VertexCount = vertexCount;
+		submesh.MaterialIndex = sourceSubmesh.MaterialIndex;
+
+		FakeAABB bounds(FakeVec3f(std::numeric_limits<float>::max()), FakeVec3f(-std::numeric_limits<float>::max()));
+		for (uint32 vertex : localVertices)
+			{
+			const FakeMeshSourceVertex &sourceVertex = source.Vertices[vertex];
+			bounds = FakeAABB(FakeVec3f::Min(bounds.Min, sourceVertex.Position), FakeVec3f::Max(bounds.Max, sourceVertex.Position));
+			vertices.push_back(Utils::fake_quantize_vertex(sourceVertex));
+			}
+
+		for (uint32 index : localIndices)
+			indices.push_back(submesh.BaseVertex + index);
+
+		Utils::fake_write_bounds(bounds, submesh.BoundsMin, submesh.BoundsMax);
+		submeshes.push_back(submesh);
+		meshBounds = FakeAABB::Merge(meshBounds, bounds);
+		}
+
+	bool shortIndices = vertices.size() <= 65536;
+	uint64 indexSize = shortIndices ? sizeof(uint16) : sizeof(uint32);
+
+	FakeMeshFileHeader header;
+	header.Magic = FakeMesh::Magic;
+	header.Version = FakeMesh::Version;
+	header.VertexCount = (uint32)vertices.size();
+	header.IndexCount = (uint32)indices.size();
+	header.IndexFormat = (uint32)(shortIndices ? FakeIndexFormat::UInt16 : FakeIndexFormat::UInt32);
+	header.SubmeshCount = (uint32)submeshes.size();
+	Utils::fake_write_bounds(meshBounds, header.BoundsMin, header.BoundsMax);
+	header.VertexOffset = Utils::fake_align(sizeof(FakeMeshFileHeader));
+	header.IndexOffset = Utils::fake_align(header.VertexOffset + vertices.size() * sizeof(FakeMeshVertex));
+	header.SubmeshOffset = Utils::fake_align(header.IndexOffset + indices.size() * indexSize);
+
+	outData.assign(header.SubmeshOffset + submeshes.size() * sizeof(FakeMeshFileSubmesh), 0);
+	memcpy(outData.data(), &header, sizeof(FakeMeshFileHeader));
+	memcpy(outData.data() + header.VertexOffset, vertices.data(), vertices.size() * sizeof(FakeMeshVertex));
+	memcpy(outData.data() + header.SubmeshOffset, submeshes.data(), submeshes.size() * sizeof(FakeMeshFileSubmesh));
+
+	if (shortIndices)
+		{
+		uint16 *destination = (uint16*)(outData.data() + header.IndexOffset);
+		for (uint32 i = 0; i < (uint32)indices.size(); ++i)
+			destination[i] = (uint16)indices[i];
+		}
+	else
+		{
+		memcpy(outData.data() + header.IndexOffset, indices.data(), indices.size() * sizeof(uint32));
+		}
+	}
+
+bool FakeMeshCooker::CookFile(const FakeString &sourcePath, const FakeString &cookedPath, const FakeMeshCookOptions &options)
+	{
+	FakeMeshSource source;
+	if (!Import(sourcePath, source))
+		return false;
+
+	std::vector<Byte> data;
+	Cook(source, data, options);
+
+	std::ofstream stream(*cookedPath, std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!stream)
+		{
+		FAKE_LOG_ERROR("Could not open mesh file %s for writing!", *cookedPath);
+		return false;
+		}
+
+	stream.write((const char*)data.data(), (std::streamsize)data.size());
+	return stream.good();
+	}
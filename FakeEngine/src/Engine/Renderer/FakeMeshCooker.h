@@ -0,0 +1,104 @@
+/*****************************************************************
+ * \file   FakeMeshCooker.h
+ * \brief  
+ * 
+ * \author Can Karka
+ * \date   February 2021
+ * 
+ * Copyright (C) 2021 Can Karka
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *********************************************************************/
+
+#pragma once
+
+#include "Engine/Core/Maths/FakeMaths.h"
+#include "Engine/Renderer/FakeMesh.h"
+
+struct FakeMeshSourceVertex
+	{
+	FakeVec3f Position;
+	FakeVec3f Normal;
+	FakeVec2f TexCoord;
+	};
+
+/**
+ *
+ * An uncooked mesh with full precision vertices and 32 bit indices into one vertex array.
+ * Only BaseIndex, IndexCount and MaterialIndex of the submeshes are used, without submeshes all indices form one.
+ *
+ */
+struct FakeMeshSource
+	{
+	std::vector<FakeMeshSourceVertex> Vertices;
+	std::vector<uint32> Indices;
+	std::vector<FakeSubmesh> Submeshes;
+	};
+
+struct FakeMeshCookOptions
+	{
+	bool OptimizeVertexCache = true;
+	bool OptimizeOverdraw = true;
+	bool OptimizeVertexFetch = true;
+
+	// How much the ACMR may grow to allow a better draw order, see FakeMeshOptimizer::OptimizeOverdraw()
+	float OverdrawThreshold = 1.05f;
+	uint32 CacheSize = 16;
+	};
+
+/**
+ *
+ * Converts meshes into the cooked format loaded by FakeMesh, meant to run offline in tools and the editor.
+ *
+ * Every submesh is optimized on its own with FakeMeshOptimizer, its vertices are stored next to each other in
+ * the order they are used. Normals are quantized to 16 bit signed integers and texture coordinates to half floats.
+ * The indices are stored with 16 bits whenever the whole mesh has less than 65537 vertices.
+ *
+ */
+class FAKE_API FakeMeshCooker
+	{
+	public:
+
+		/**
+		 *
+		 * Imports all meshes of a model file with assimp, the node transforms are applied to the vertices.
+		 * Every mesh of the file becomes one submesh, faces are triangulated and missing normals are generated.
+		 *
+		 * @param path The physical path to the model, any format supported by assimp.
+		 * @param outSource Receives the imported mesh, previous contents are replaced.
+		 * @return Returns true if the model has been imported.
+		 */
+		static bool Import(const FakeString &path, FakeMeshSource &outSource);
+
+		/**
+		 *
+		 * Optimizes and quantizes a mesh and writes it in the cooked format.
+		 *
+		 * @param source The mesh to cook.
+		 * @param outData Receives the contents of the cooked file, previous contents are replaced.
+		 * @param options Selects the optimization passes.
+		 */
+		static void Cook(const FakeMeshSource &source, std::vector<Byte> &outData, const FakeMeshCookOptions &options = FakeMeshCookOptions());
+
+		/**
+		 *
+		 * Imports a model and writes the cooked mesh to a file, an existing file is replaced.
+		 *
+		 * @param sourcePath The physical path to the model.
+		 * @param cookedPath The physical path to the cooked file.
+		 * @param options Selects the optimization passes.
+		 * @return Returns true if the cooked file has been written.
+		 */
+		static bool CookFile(const FakeString &sourcePath, const FakeString &cookedPath, const FakeMeshCookOptions &options = FakeMeshCookOptions());
+	};
+
@@ -1,17 +1,149 @@
 #include "FakePch.h"
 #include "FakeMeshFactory.h"
 
+namespace Utils
+	{
+	static FakeRef<FakeMesh> fake_cook_mesh(const FakeMeshSource &source)
+		{
+		std::vector<Byte> data;
+		FakeMeshCooker::Cook(source, data);
+		return FakeMesh::Create(data.data(), data.size());
+		}
+
+	/**
+	 *
+	 * Sweeps rings of a sphere around the Y axis. Every ring is given by its polar angle and a vertical offset,
+	 * so a capsule is a sphere whose upper and lower half are moved apart.
+	 *
+	 */
+	static void fake_build_lathe(const std::vector<std::pair<float, float>> &rings, float radius, uint32 segments, float height, FakeMeshSource &outSource)
+		{
+		outSource.Vertices.clear();
+		outSource.Indices.clear();
+		outSource.Submeshes.clear();
+
+		// The first and last column share their positions, the texture coordinates wrap around
+		uint32 columns = segments + 1;
+		for (const auto &[phi, offset] : rings)
+			{
+			float ringRadius = fake_sin(phi);
+			float y = fake_cos(phi);
+
+			for (uint32 s = 0; s < columns; ++s)
+				{
+				float theta = 2.0f * FAKE_PI * (float)s / (float)segments;
+
+				FakeMeshSourceVertex vertex;
+				vertex.Normal = FakeVec3f(ringRadius * fake_cos(theta), y, ringRadius * fake_sin(theta));
+				vertex.Position = vertex.Normal * radius + FakeVec3f(0.0f, offset, 0.0f);
+				vertex.TexCoord = FakeVec2f((float)s / (float)segments, vertex.Position.Y / height + 0.5f);
+				outSource.Vertices.push_back(vertex);
+				}
+			}
+
+		uint32 rowCount = (uint32)rings.size();
+		for (uint32 r = 0; r + 1 < rowCount; ++r)
+			{
+			// The triangles touching a pole collapse to a line and are left out
+			bool topPole = r == 0;
+			bool bottomPole = r + 2 == rowCount;
+
+			for (uint32 s = 0; s < segments; ++s)
+				{
+				uint32 a = r * columns + s;
+				uint32 b = a + columns;
+
+				if (!topPole)
+					outSource.Indices.insert(outSource.Indices.end(), { a, a + 1, b });
+
+				if (!bottomPole)
+					outSource.Indices.insert(outSource.Indices.end(), { a + 1, b + 1, b });
+				}
+			}
+		}
+	}
+
 FakeRef<FakeMesh> FakeMeshFactory::Cube(const FakeVec3f &size)
 	{
-	return FakeRef<FakeMesh>();
+	FakeMeshSource source;
+	CubeSource(size, source);
+	return Utils::fake_cook_mesh(source);
 	}
 
 FakeRef<FakeMesh> FakeMeshFactory::Sphere(float radius)
 	{
-	return FakeRef<FakeMesh>();
+	FakeMeshSource source;
+	SphereSource(radius, 32, 16, source);
+	return Utils::fake_cook_mesh(source);
 	}
 
 FakeRef<FakeMesh> FakeMeshFactory::Capsule(float radius, float height)
 	{
-	return FakeRef<FakeMesh>();
+	FakeMeshSource source;
+	CapsuleSource(radius, height, 32, 16, source);
+	return Utils::fake_cook_mesh(source);
+	}
+
+void FakeMeshFactory::CubeSource(const FakeVec3f &size, FakeMeshSource &outSource)
+	{
+	// Normal, U and V axis of every face, U x V points outwards so the corners are counter clockwise
+	static const FakeVec3f faces[6][3] = {
+		{ {  1.0f,  0.0f,  0.0f }, {  0.0f,  0.0f, -1.0f }, { 0.0f, 1.0f,  0.0f } },
+		{ { -1.0f,  0.0f,  0.0f }, {  0.0f,  0.0f,  1.0f }, { 0.0f, 1.0f,  0.0f } },
+		{ {  0.0f,  1.0f,  0.0f }, {  1.0f,  0.0f,  0.0f }, { 0.0f, 0.0f, -1.0f } },
+		{ {  0.0f, -1.0f,  0.0f }, {  1.0f,  0.0f,  0.0f }, { 0.0f, 0.0f,  1.0f } },
+		{ {  0.0f,  0.0f,  1.0f }, {  1.0f,  0.0f,  0.0f }, { 0.0f, 1.0f,  0.0f } },
+		{ {  0.0f,  0.0f, -1.0f }, { -1.0f,  0.0f,  0.0f }, { 0.0f, 1.0f,  0.0f } }
+		};
+
+	static const FakeVec2f corners[4] = { { -1.0f, -1.0f }, { 1.0f, -1.0f }, { 1.0f, 1.0f }, { -1.0f, 1.0f } };
+
+	outSource.Vertices.clear();
+	outSource.Indices.clear();
+	outSource.Submeshes.clear();
+
+	FakeVec3f halfSize = size * 0.5f;
+	for (const auto &face : faces)
+		{
+		uint32 first = (uint32)outSource.Vertices.size();
+		for (const FakeVec2f &corner : corners)
+			{
+			FakeMeshSourceVertex vertex;
+			vertex.Position = (face[0] + face[1] * corner.X + face[2] * corner.Y) * halfSize;
+			vertex.Normal = face[0];
+			vertex.TexCoord = FakeVec2f(corner.X * 0.5f + 0.5f, corner.Y * 0.5f + 0.5f);
+			outSource.Vertices.push_back(vertex);
+			}
+
+		outSource.Indices.insert(outSource.Indices.end(), { first, first + 1, first + 2, first, first + 2, first + 3 });
+		}
+	}
+
+void FakeMeshFactory::SphereSource(float radius, uint32 segments, uint32 rings, FakeMeshSource &outSource)
+	{
+	FAKE_ASSERT(segments >= 3 && rings >= 2);
+
+	std::vector<std::pair<float, float>> rows;
+	for (uint32 r = 0; r <= rings; ++r)
+		rows.push_back({ FAKE_PI * (float)r / (float)rings, 0.0f });
+
+	Utils::fake_build_lathe(rows, radius, segments, 2.0f * radius, outSource);
+	}
+
+void FakeMeshFactory::CapsuleSource(float radius, float height, uint32 segments, uint32 rings, FakeMeshSource &outSource)
+	{
+	FAKE_ASSERT(segments >= 3 && rings >= 2);
+
+	rings += rings % 2;
+	float halfCylinder = std::max(height * 0.5f - radius, 0.0f);
+
+	// The equator is added twice, once for each half sphere, the band between them is the cylinder
+	std::vector<std::pair<float, float>> rows;
+	for (uint32 r = 0; r <= rings / 2; ++r)
+		rows.push_back({ FAKE_PI * (float)r / (float)rings, halfCylinder });
+
+	for (uint32 r = rings / 2; r <= rings; ++r)
+		rows.push_back({ FAKE_PI * (float)r / (float)rings, -halfCylinder });
+
+	Utils::fake_build_lathe(rows, radius, segments, 2.0f * (halfCylinder + radius), outSource);
 	}
@@ -12,10 +12,11 @@
 
 #include "Engine/Core/Maths/FakeMaths.h"
 #include "Engine/Renderer/FakeMesh.h"
+#include "Engine/Renderer/FakeMeshCooker.h"
 
 /**
  * 
- * .
+ * Creates simple meshes centered at the origin, cooked and optimized like imported ones.
  * 
  */
 class FAKE_API FakeMeshFactory
@@ -24,29 +25,61 @@ class FAKE_API FakeMeshFactory
 
 		/**
 		 * 
-		 * .
+		 * Creates a box, every face has its own vertices so the edges stay sharp.
 		 * 
-		 * @param size
-		 * @return 
+		 * @param size The edge lengths of the box.
+		 * @return Returns the new mesh.
 		 */
 		static FakeRef<FakeMesh> Cube(const FakeVec3f &size);
 
 		/**
 		 * 
-		 * .
+		 * Creates a sphere with 32 segments around the Y axis and 16 rings.
 		 * 
-		 * @param radius
-		 * @return 
+		 * @param radius The radius of the sphere.
+		 * @return Returns the new mesh.
 		 */
 		static FakeRef<FakeMesh> Sphere(float radius);
 
 		/**
 		 * 
-		 * .
+		 * Creates a capsule along the Y axis, a cylinder with a half sphere at each end.
 		 * 
-		 * @param radius
-		 * @param height
-		 * @return 
+		 * @param radius The radius of the cylinder and the half spheres.
+		 * @param height The total height including the half spheres, at least twice the radius.
+		 * @return Returns the new mesh.
 		 */
 		static FakeRef<FakeMesh> Capsule(float radius, float height);
+
+		/**
+		 * 
+		 * Builds the uncooked vertices and indices of Cube().
+		 * 
+		 * @param size The edge lengths of the box.
+		 * @param outSource Receives the mesh, previous contents are replaced.
+		 */
+		static void CubeSource(const FakeVec3f &size, FakeMeshSource &outSource);
+
+		/**
+		 * 
+		 * Builds the uncooked vertices and indices of a sphere.
+		 * 
+		 * @param radius The radius of the sphere.
+		 * @param segments The number of vertices around the Y axis.
+		 * @param rings The number of rings from pole to pole.
+		 * @param outSource Receives the mesh, previous contents are replaced.
+		 */
+		static void SphereSource(float radius, uint32 segments, uint32 rings, FakeMeshSource &outSource);
+
+		/**
+		 * 
+		 * Builds the uncooked vertices and indices of a capsule.
+		 * 
+		 * @param radius The radius of the cylinder and the half spheres.
+		 * @param height The total height including the half spheres.
+		 * @param segments The number of vertices around the Y axis.
+		 * @param rings The number of rings from pole to pole, rounded up to an even number.
+		 * @param outSource Receives the mesh, previous contents are replaced.
+		 */
+		static void CapsuleSource(float radius, float height, uint32 segments, uint32 rings, FakeMeshSource &outSource);
 	};
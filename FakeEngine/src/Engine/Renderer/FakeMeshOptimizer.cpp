@@ -0,0 +1,286 @@
+#include "FakePch.h"
+#include "FakeMeshOptimizer.h"
+
+namespace Utils
+	{
+	/**
+	 *
+	 * Adds the vertices of a triangle to a simulated FIFO cache and returns how many of them had to be transformed.
+	 * A vertex is cached while less than cacheSize vertices have been added after it, so the cache is a single
+	 * timestamp per vertex and can be flushed by advancing the timestamp by cacheSize + 1.
+	 *
+	 */
+	static uint32 fake_update_vertex_cache(const uint32 *triangle, uint32 *timestamps, uint32 &timestamp, uint32 cacheSize)
+		{
+		uint32 misses = 0;
+		for (uint32 i = 0; i < 3; ++i)
+			{
+			uint32 vertex = triangle[i];
+			if (timestamp - timestamps[vertex] > cacheSize)
+				{
+				timestamps[vertex] = timestamp++;
+				++misses;
+				}
+			}
+
+		return misses;
+		}
+
+	static uint32 fake_next_dead_end_vertex(std::vector<uint32> &deadEnd, const std::vector<uint32> &liveTriangles, uint32 &cursor)
+		{
+		// Recently emitted vertices with triangles left are likely still cached
+		while (!deadEnd.empty())
+			{
+			uint32 vertex = deadEnd.back();
+			deadEnd.pop_back();
+
+			if (liveTriangles[vertex] > 0)
+				return vertex;
+			}
+
+		// Otherwise continue with the next untouched part of the mesh
+		for (; cursor < (uint32)liveTriangles.size(); ++cursor)
+			{
+			if (liveTriangles[cursor] > 0)
+				return cursor;
+			}
+
+		return ~0u;
+		}
+	}
+
+FakeVertexCacheStatistics FakeMeshOptimizer::AnalyzeVertexCache(const uint32 *indices, uint32 indexCount, uint32 vertexCount, uint32 cacheSize)
+	{
+	FAKE_ASSERT(indexCount % 3 == 0);
+
+	FakeVertexCacheStatistics result;
+	if (indexCount == 0)
+		return result;
+
+	std::vector<uint32> timestamps(vertexCount, 0);
+	uint32 timestamp = cacheSize + 1;
+
+	for (uint32 i = 0; i < indexCount; i += 3)
+		result.VerticesTransformed += Utils::fake_update_vertex_cache(indices + i, timestamps.data(), timestamp, cacheSize);
+
+	// Every referenced vertex has been transformed at least once and holds a timestamp
+	uint32 uniqueVertices = 0;
+	for (uint32 vertexTimestamp : timestamps)
+		uniqueVertices += vertexTimestamp != 0;
+
+	result.ACMR = (float)result.VerticesTransformed / (float)(indexCount / 3);
+	result.ATVR = (float)result.VerticesTransformed / (float)uniqueVertices;
+	return result;
+	}
+
+void FakeMeshOptimizer::OptimizeVertexCache(uint32 *destination, const uint32 *indices, uint32 indexCount, uint32 vertexCount, uint32 cacheSize)
+	{
+	FAKE_ASSERT(indexCount % 3 == 0);
+	FAKE_ASSERT(destination != indices);
+
+	// The triangles around every vertex, stored as one array with an offset per vertex
+	std::vector<uint32> liveTriangles(vertexCount, 0);
+	for (uint32 i = 0; i < indexCount; ++i)
+		liveTriangles[indices[i]]++;
+
+	std::vector<uint32> offsets(vertexCount + 1, 0);
+	for (uint32 i = 0; i < vertexCount; ++i)
+		offsets[i + 1] = offsets[i] + liveTriangles[i];
+
+	std::vector<uint32> adjacency(indexCount);
+	std::vector<uint32> fill(offsets.begin(), offsets.end() - 1);
+	for (uint32 i = 0; i < indexCount; ++i)
+		adjacency[fill[indices[i]]++] = i / 3;
+
+	std::vector<uint32> timestamps(vertexCount, 0);
+	std::vector<uint8> emitted(indexCount / 3, 0);
+	std::vector<uint32> deadEnd;
+	std::vector<uint32> candidates;
+	deadEnd.reserve(indexCount);
+
+	uint32 timestamp = cacheSize + 1;
+	uint32 cursor = 0;
+	uint32 outputCount = 0;
+
+	uint32 fanning = Utils::fake_next_dead_end_vertex(deadEnd, liveTriangles, cursor);
+	while (fanning != ~0u)
+		{
+		// Emit all remaining triangles around the fanning vertex
+		candidates.clear();
+		for (uint32 i = offsets[fanning]; i < offsets[fanning + 1]; ++i)
+			{
+			uint32 triangle = adjacency[i];
+			if (emitted[triangle])
+				continue;
+
+			const uint32 *vertices = indices + triangle * 3;
+			for (uint32 k = 0; k < 3; ++k)
+				{
+				uint32 vertex = vertices[k];
+				destination[outputCount++] = vertex;
+				deadEnd.push_back(vertex);
+				candidates.push_back(vertex);
+				liveTriangles[vertex]--;
+
+				if (timestamp - timestamps[vertex] > cacheSize)
+					timestamps[vertex] = timestamp++;
+				}
+
+			emitted[triangle] = 1;
+			}
+
+		// Continue with the oldest candidate whose remaining triangles still fit into the cache
+		uint32 next = ~0u;
+		int32 bestPriority = -1;
+		for (uint32 vertex : candidates)
+			{
+			if (liveTriangles[vertex] == 0)
+				continue;
+
+			int32 priority = 0;
+			uint32 age = timestamp - timestamps[vertex];
+			if (age + 2 * liveTriangles[vertex] <= cacheSize)
+				priority = (int32)age;
+
+			if (priority > bestPriority)
+				{
+				bestPriority = priority;
+				next = vertex;
+				}
+			}
+
+		if (next == ~0u)
+			next = Utils::fake_next_dead_end_vertex(deadEnd, liveTriangles, cursor);
+
+		fanning = next;
+		}
+
+	FAKE_ASSERT(outputCount == indexCount);
+	}
+
+void FakeMeshOptimizer::OptimizeOverdraw(uint32 *destination, const uint32 *indices, uint32 indexCount, const FakeVec3f *positions, uint32 vertexCount, float threshold, uint32 cacheSize)
+	{
+	FAKE_ASSERT(indexCount % 3 == 0);
+	FAKE_ASSERT(destination != indices);
+
+	uint32 triangleCount = indexCount / 3;
+	if (triangleCount == 0)
+		return;
+
+	std::vector<uint32> timestamps(vertexCount, 0);
+	uint32 timestamp = cacheSize + 1;
+
+	// A triangle without any cached vertex starts a new hard cluster, reordering there costs nothing
+	std::vector<uint32> hardClusters;
+	for (uint32 i = 0; i < triangleCount; ++i)
+		{
+		if (Utils::fake_update_vertex_cache(indices + i * 3, timestamps.data(), timestamp, cacheSize) == 3 || i == 0)
+			hardClusters.push_back(i);
+		}
+
+	hardClusters.push_back(triangleCount);
+
+	// Soft boundaries split the hard clusters further, as long as each part stays within the allowed ACMR
+	std::vector<uint32> clusters;
+	for (uint32 h = 0; h + 1 < (uint32)hardClusters.size(); ++h)
+		{
+		uint32 start = hardClusters[h];
+		uint32 end = hardClusters[h + 1];
+
+		timestamp += cacheSize + 1;
+		uint32 clusterMisses = 0;
+		for (uint32 i = start; i < end; ++i)
+			clusterMisses += Utils::fake_update_vertex_cache(indices + i * 3, timestamps.data(), timestamp, cacheSize);
+
+		float target = threshold * (float)clusterMisses / (float)(end - start);
+
+		// The cache is flushed at every boundary, the clusters are drawn in a different order afterwards
+		timestamp += cacheSize + 1;
+		clusters.push_back(start);
+
+		uint32 runningMisses = 0;
+		uint32 runningTriangles = 0;
+		for (uint32 i = start; i + 1 < end; ++i)
+			{
+			runningMisses += Utils::fake_update_vertex_cache(indices + i * 3, timestamps.data(), timestamp, cacheSize);
+			runningTriangles++;
+
+			if ((float)runningMisses <= target * (float)runningTriangles)
+				{
+				clusters.push_back(i + 1);
+				timestamp += cacheSize + 1;
+				runningMisses = 0;
+				runningTriangles = 0;
+				}
+			}
+		}
+
+	uint32 clusterCount = (uint32)clusters.size();
+	clusters.push_back(triangleCount);
+
+	FakeVec3f meshCentroid(0.0f, 0.0f, 0.0f);
+	for (uint32 i = 0; i < indexCount; ++i)
+		meshCentroid += positions[indices[i]];
+
+	meshCentroid /= (float)indexCount;
+
+	// Clusters facing away from the center of the mesh are on the outside and should be drawn first
+	std::vector<std::pair<float, uint32>> order(clusterCount);
+	for (uint32 c = 0; c < clusterCount; ++c)
+		{
+		FakeVec3f centroid(0.0f, 0.0f, 0.0f);
+		FakeVec3f normal(0.0f, 0.0f, 0.0f);
+		float area = 0.0f;
+
+		for (uint32 i = clusters[c]; i < clusters[c + 1]; ++i)
+			{
+			const FakeVec3f &p0 = positions[indices[i * 3 + 0]];
+			const FakeVec3f &p1 = positions[indices[i * 3 + 1]];
+			const FakeVec3f &p2 = positions[indices[i * 3 + 2]];
+
+			FakeVec3f weightedNormal = FakeVec3f::Cross(p1 - p0, p2 - p0);
+			float triangleArea = weightedNormal.Length();
+
+			centroid += (p0 + p1 + p2) * (triangleArea / 3.0f);
+			normal += weightedNormal;
+			area += triangleArea;
+			}
+
+		if (area > 0.0f)
+			centroid /= area;
+
+		normal.Normalize();
+		order[c] = { -FakeVec3f::Dot(centroid - meshCentroid, normal), c };
+		}
+
+	std::stable_sort(order.begin(), order.end(), [](const auto &a, const auto &b) { return a.first < b.first; });
+
+	uint32 outputCount = 0;
+	for (const auto &[key, c] : order)
+		{
+		uint32 first = clusters[c] * 3;
+		uint32 last = clusters[c + 1] * 3;
+		memcpy(destination + outputCount, indices + first, (last - first) * sizeof(uint32));
+		outputCount += last - first;
+		}
+
+	FAKE_ASSERT(outputCount == indexCount);
+	}
+
+uint32 FakeMeshOptimizer::OptimizeVertexFetch(uint32 *remap, uint32 *indices, uint32 indexCount, uint32 vertexCount)
+	{
+	for (uint32 i = 0; i < vertexCount; ++i)
+		remap[i] = ~0u;
+
+	uint32 nextVertex = 0;
+	for (uint32 i = 0; i < indexCount; ++i)
+		{
+		uint32 &newIndex = remap[indices[i]];
+		if (newIndex == ~0u)
+			newIndex = nextVertex++;
+
+		indices[i] = newIndex;
+		}
+
+	return nextVertex;
+	}
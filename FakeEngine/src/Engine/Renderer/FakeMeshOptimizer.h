@@ -0,0 +1,127 @@
+/*****************************************************************
+ * \file   FakeMeshOptimizer.h
+ * \brief  
+ * 
+ * \author Can Karka
+ * \date   February 2021
+ * 
+ * Copyright (C) 2021 Can Karka
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *********************************************************************/
+
+#pragma once
+
+#include "Engine/Core/Maths/FakeMaths.h"
+
+/**
+ *
+ * Describes how well an index buffer uses the post transform vertex cache of the GPU.
+ *
+ */
+struct FakeVertexCacheStatistics
+	{
+	uint32 VerticesTransformed = 0;
+
+	// Average cache miss ratio, transformed vertices per triangle. 0.5 is the optimum for large regular meshes, 3 the worst case
+	float ACMR = 0.0f;
+
+	// Average transform to vertex ratio, transformed vertices per unique vertex. 1 is the optimum
+	float ATVR = 0.0f;
+	};
+
+/**
+ *
+ * CPU passes which reorder the triangles and vertices of indexed triangle lists for faster rendering.
+ *
+ * The usual order is OptimizeVertexCache(), then OptimizeOverdraw() and finally OptimizeVertexFetch(), each pass
+ * keeps the gains of the previous ones. All passes work on 32 bit indices, the result can be narrowed afterwards.
+ *
+ */
+class FAKE_API FakeMeshOptimizer
+	{
+	public:
+
+		/**
+		 *
+		 * Simulates a FIFO vertex cache of the given size and counts the vertices which had to be transformed.
+		 *
+		 * @param indices The triangle list.
+		 * @param indexCount The number of indices, a multiple of three.
+		 * @param vertexCount The number of vertices referenced by the indices.
+		 * @param cacheSize The number of vertices in the simulated cache.
+		 * @return Returns the ACMR and ATVR of the index buffer.
+		 */
+		static FakeVertexCacheStatistics AnalyzeVertexCache(const uint32 *indices, uint32 indexCount, uint32 vertexCount, uint32 cacheSize = 16);
+
+		/**
+		 *
+		 * Reorders the triangles for the post transform vertex cache with Tipsify (Sander et al. 2007).
+		 * Runs in linear time and produces clusters of triangles which OptimizeOverdraw() can sort.
+		 *
+		 * @param destination Receives the reordered indices, must not overlap the source.
+		 * @param indices The triangle list.
+		 * @param indexCount The number of indices, a multiple of three.
+		 * @param vertexCount The number of vertices referenced by the indices.
+		 * @param cacheSize The cache size to optimize for, 16 suits most GPUs.
+		 */
+		static void OptimizeVertexCache(uint32 *destination, const uint32 *indices, uint32 indexCount, uint32 vertexCount, uint32 cacheSize = 16);
+
+		/**
+		 *
+		 * Reorders clusters of a cache optimized index buffer, so triangles facing outwards are drawn first and
+		 * hide the ones behind them. The clusters are split only while their ACMR stays below the threshold.
+		 *
+		 * @param destination Receives the reordered indices, must not overlap the source.
+		 * @param indices The triangle list, usually the result of OptimizeVertexCache().
+		 * @param indexCount The number of indices, a multiple of three.
+		 * @param positions The positions of the vertices.
+		 * @param vertexCount The number of vertices referenced by the indices.
+		 * @param threshold How much the ACMR may grow, 1.05 allows 5% more transformed vertices.
+		 * @param cacheSize The cache size the indices have been optimized for.
+		 */
+		static void OptimizeOverdraw(uint32 *destination, const uint32 *indices, uint32 indexCount, const FakeVec3f *positions, uint32 vertexCount, float threshold = 1.05f, uint32 cacheSize = 16);
+
+		/**
+		 *
+		 * Numbers the vertices in the order they are first used by the triangles, so the vertex fetch reads memory linearly.
+		 * Vertices which are not referenced are dropped.
+		 *
+		 * @param remap Receives the new index of every vertex, or ~0u for unused ones. Needs space for vertexCount entries.
+		 * @param indices The triangle list, it is rewritten to the new vertex indices.
+		 * @param indexCount The number of indices.
+		 * @param vertexCount The number of vertices referenced by the indices.
+		 * @return Returns the number of vertices left.
+		 */
+		static uint32 OptimizeVertexFetch(uint32 *remap, uint32 *indices, uint32 indexCount, uint32 vertexCount);
+
+		/**
+		 *
+		 * Moves the vertices to the positions computed by OptimizeVertexFetch().
+		 *
+		 * @param destination Receives the reordered vertices, must not overlap the source.
+		 * @param vertices The vertices in their old order.
+		 * @param vertexCount The number of old vertices.
+		 * @param remap The remap table returned by OptimizeVertexFetch().
+		 */
+		template<typename T>
+		static void RemapVertices(T *destination, const T *vertices, uint32 vertexCount, const uint32 *remap)
+			{
+			for (uint32 i = 0; i < vertexCount; ++i)
+				{
+				if (remap[i] != ~0u)
+					destination[remap[i]] = vertices[i];
+				}
+			}
+	};
+
@@ -0,0 +1,539 @@
+#include "FakePch.h"
+#include "FakeParticleSystem.h"
+
+#include "FakeRenderer.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+	#include <emmintrin.h>
+	#define FAKE_PARTICLE_SIMD
+#endif
+
+// The bindings of the storage blocks in FakeParticleSimulationSource and FakeParticleVertexGPUSource
+static const uint32 SourceBinding = 0;
+static const uint32 DestinationBinding = 1;
+static const uint32 IndirectBinding = 2;
+static const uint32 ParticleBinding = 0;
+
+static const uint32 SimulationGroupSize = 256;
+
+// A particle on the GPU is two vec4, position and age, velocity and life time
+static const uint32 GPUParticleSize = 2 * sizeof(FakeVec4f);
+
+// A particle instance of the CPU simulation is its position and the part of its life which has passed
+static const uint32 CPUParticleSize = sizeof(FakeVec4f);
+
+// The indirect buffer starts with the draw count of glMultiDrawElementsIndirectCount, one command per particle buffer follows.
+// The instance count of a command is the number of particles in its buffer.
+static const uint32 IndirectCommandBase = 4;
+
+// Stage 0 resets the particle count of the destination, stage 1 moves the living particles of the source into the
+// destination, stage 2 appends the new particles and stage 3 drops the ones which did not fit.
+static const char *FakeParticleSimulationSource = R"(
+#type compute
+#version 450 core
+
+layout(local_size_x = 256) in;
+
+struct Particle
+	{
+	vec4 PositionAge;
+	vec4 VelocityLifeTime;
+	};
+
+layout(std430, binding = 0) readonly buffer Source { Particle u_Source[]; };
+layout(std430, binding = 1) writeonly buffer Destination { Particle u_Destination[]; };
+layout(std430, binding = 2) buffer Indirect { uint u_Indirect[]; };
+
+uniform int u_Stage;
+uniform int u_SourceCount;
+uniform int u_DestinationCount;
+uniform int u_Capacity;
+uniform int u_EmitCount;
+uniform int u_Seed;
+
+uniform float u_Timestep;
+uniform float u_Drag;
+uniform vec3 u_Acceleration;
+
+uniform vec3 u_Position;
+uniform vec3 u_PositionVariance;
+uniform vec3 u_Velocity;
+uniform vec3 u_VelocityVariance;
+uniform float u_LifeTime;
+uniform float u_LifeTimeVariance;
+
+uint Hash(uint x)
+	{
+	x ^= x >> 16;
+	x *= 0x7feb352du;
+	x ^= x >> 15;
+	x *= 0x846ca68bu;
+	x ^= x >> 16;
+	return x;
+	}
+
+float Random(inout uint state)
+	{
+	state = Hash(state);
+	return float(state >> 8) * (1.0 / 16777216.0);
+	}
+
+vec3 RandomSigned(inout uint state)
+	{
+	float x = Random(state);
+	float y = Random(state);
+	float z = Random(state);
+	return vec3(x, y, z) * 2.0 - 1.0;
+	}
+
+void main()
+	{
+	uint index = gl_GlobalInvocationID.x;
+
+	if (u_Stage == 0)
+		{
+		if (index == 0)
+			u_Indirect[u_DestinationCount] = 0;
+		}
+	else if (u_Stage == 1)
+		{
+		if (index >= u_Indirect[u_SourceCount])
+			return;
+
+		Particle particle = u_Source[index];
+		particle.PositionAge.w += u_Timestep;
+		if (particle.PositionAge.w >= particle.VelocityLifeTime.w)
+			return;
+
+		particle.VelocityLifeTime.xyz = particle.VelocityLifeTime.xyz * u_Drag + u_Acceleration * u_Timestep;
+		particle.PositionAge.xyz += particle.VelocityLifeTime.xyz * u_Timestep;
+
+		uint slot = atomicAdd(u_Indirect[u_DestinationCount], 1u);
+		u_Destination[slot] = particle;
+		}
+	else if (u_Stage == 2)
+		{
+		if (index >= uint(u_EmitCount))
+			return;
+
+		uint slot = atomicAdd(u_Indirect[u_DestinationCount], 1u);
+		if (slot >= uint(u_Capacity))
+			return;
+
+		uint state = Hash(index ^ Hash(uint(u_Seed)));
+		vec3 position = u_Position + RandomSigned(state) * u_PositionVariance;
+		vec3 velocity = u_Velocity + RandomSigned(state) * u_VelocityVariance;
+		float lifeTime = max(u_LifeTime + (Random(state) * 2.0 - 1.0) * u_LifeTimeVariance, 0.001);
+
+		u_Destination[slot] = Particle(vec4(position, 0.0), vec4(velocity, lifeTime));
+		}
+	else if (index == 0)
+		{
+		u_Indirect[u_DestinationCount] = min(u_Indirect[u_DestinationCount], uint(u_Capacity));
+		}
+	}
+)";
+
+// The vertex shaders of both simulations end in EmitParticle(), they only differ in where the particles come from
+static const char *FakeParticleVertexCommonSource = R"(
+#type vertex
+#version 450 core
+
+layout(location = 0) in vec2 a_Corner;
+
+uniform mat4 u_ViewProjection;
+uniform vec3 u_CameraRight;
+uniform vec3 u_CameraUp;
+uniform float u_SizeBegin;
+uniform float u_SizeEnd;
+uniform vec4 u_ColorBegin;
+uniform vec4 u_ColorEnd;
+
+out vec4 v_Color;
+out vec2 v_Corner;
+
+void EmitParticle(vec3 position, float t)
+	{
+	float size = mix(u_SizeBegin, u_SizeEnd, t) * 0.5;
+	position += (u_CameraRight * a_Corner.x + u_CameraUp * a_Corner.y) * size;
+
+	v_Color = mix(u_ColorBegin, u_ColorEnd, t);
+	v_Corner = a_Corner;
+
+	gl_Position = u_ViewProjection * vec4(position, 1.0);
+	}
+)";
+
+static const char *FakeParticleVertexGPUSource = R"(
+struct Particle
+	{
+	vec4 PositionAge;
+	vec4 VelocityLifeTime;
+	};
+
+layout(std430, binding = 0) readonly buffer Particles { Particle u_Particles[]; };
+
+void main()
+	{
+	Particle particle = u_Particles[gl_InstanceID];
+	EmitParticle(particle.PositionAge.xyz, clamp(particle.PositionAge.w / particle.VelocityLifeTime.w, 0.0, 1.0));
+	}
+)";
+
+static const char *FakeParticleVertexCPUSource = R"(
+layout(location = 1) in vec4 a_PositionAge;
+
+void main()
+	{
+	EmitParticle(a_PositionAge.xyz, a_PositionAge.w);
+	}
+)";
+
+static const char *FakeParticleFragmentSource = R"(
+#type fragment
+#version 450 core
+
+layout(location = 0) out vec4 Color;
+layout(location = 1) out int ObjectID;
+
+in vec4 v_Color;
+in vec2 v_Corner;
+
+void main()
+	{
+	// Soft round particles
+	float alpha = 1.0 - smoothstep(0.5, 1.0, length(v_Corner));
+	if (alpha == 0.0)
+		discard;
+
+	Color = vec4(v_Color.rgb, v_Color.a * alpha);
+	ObjectID = -1;
+	}
+)";
+
+namespace Utils
+	{
+	static uint32 fake_simulation_group_count(uint32 count)
+		{
+		return (count + SimulationGroupSize - 1) / SimulationGroupSize;
+		}
+
+	// One axis of all particles, the structure of arrays lets four particles move with one instruction
+	static void fake_integrate_axis(float *position, float *velocity, uint32 count, float acceleration, float timestep, float drag)
+		{
+		uint32 i = 0;
+
+	#ifdef FAKE_PARTICLE_SIMD
+		const __m128 deltaVelocity = _mm_set1_ps(acceleration * timestep);
+		const __m128 dt = _mm_set1_ps(timestep);
+		const __m128 dragFactor = _mm_set1_ps(drag);
+
+		for (; i + 4 <= count; i += 4)
+			{
+			__m128 v = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(velocity + i), dragFactor), deltaVelocity);
+			_mm_storeu_ps(velocity + i, v);
+			_mm_storeu_ps(position + i, _mm_add_ps(_mm_loadu_ps(position + i), _mm_mul_ps(v, dt)));
+			}
+	#endif
+
+		for (; i < count; ++i)
+			{
+			velocity[i] = velocity[i] * drag + acceleration * timestep;
+			position[i] += velocity[i] * timestep;
+			}
+		}
+
+	static void fake_advance_age(float *age, uint32 count, float timestep)
+		{
+		uint32 i = 0;
+
+	#ifdef FAKE_PARTICLE_SIMD
+		const __m128 dt = _mm_set1_ps(timestep);
+		for (; i + 4 <= count; i += 4)
+			_mm_storeu_ps(age + i, _mm_add_ps(_mm_loadu_ps(age + i), dt));
+	#endif
+
+		for (; i < count; ++i)
+			age[i] += timestep;
+		}
+
+	static void fake_set_render_uniforms(const FakeRef<FakeShader> &renderShader, const FakeParticleEmitter &emitter, const FakeMat4f &view, const FakeMat4f &projection)
+		{
+		FakeMat4f viewProjection;
+		FakeMat4f::Multiply(view, projection, viewProjection);
+
+		// The columns of the view rotation are the axes of the camera
+		FakeRef<FakeShader> shader = renderShader;
+		shader->Bind();
+		shader->SetUniform("u_ViewProjection", viewProjection);
+		shader->SetUniform("u_CameraRight", FakeVec3f(view.M11, view.M21, view.M31));
+		shader->SetUniform("u_CameraUp", FakeVec3f(view.M12, view.M22, view.M32));
+		shader->SetUniform("u_SizeBegin", emitter.SizeBegin);
+		shader->SetUniform("u_SizeEnd", emitter.SizeEnd);
+		shader->SetUniform("u_ColorBegin", emitter.ColorBegin);
+		shader->SetUniform("u_ColorEnd", emitter.ColorEnd);
+		}
+	}
+
+FakeParticleSystem::FakeParticleSystem(const FakeParticleEmitter &emitter, FakeParticleSimulation simulation)
+	: Emitter(emitter), Simulation(simulation)
+	{
+	const bool computeShaders = FakeRendererAPI::GetCapabilities().ComputeShaders;
+	if (Simulation == FakeParticleSimulation::Auto)
+		{
+		Simulation = computeShaders ? FakeParticleSimulation::GPU : FakeParticleSimulation::CPU;
+		}
+	else if (Simulation == FakeParticleSimulation::GPU && !computeShaders)
+		{
+		FAKE_LOG_WARN("The renderer does not support compute shaders, the particles are simulated on the CPU!");
+		Simulation = FakeParticleSimulation::CPU;
+		}
+
+	FakeVec2f corners[4] = { { -1.0f, -1.0f }, { 1.0f, -1.0f }, { 1.0f, 1.0f }, { -1.0f, 1.0f } };
+	uint32 indices[6] = { 0, 1, 2, 2, 3, 0 };
+	CornerBuffer = FakeVertexBuffer::Create(corners, sizeof(corners));
+	IndexBuffer = FakeIndexBuffer::Create(indices, sizeof(indices));
+
+	FakePipelineSpecification spec;
+	spec.Layout = {
+		{ FakeShaderDataType::Float2, "a_Corner" }
+	};
+
+	spec.VertexBuffer = CornerBuffer;
+	spec.IndexBuffer = IndexBuffer;
+
+	const uint32 capacity = Emitter.MaxParticles;
+	if (Simulation == FakeParticleSimulation::GPU)
+		{
+		SimulationShader = FakeShader::CreateFromSource("FakeParticleSimulation", FakeParticleSimulationSource);
+		RenderShader = FakeShader::CreateFromSource("FakeParticleGPU", FakeString(FakeParticleVertexCommonSource) + FakeParticleVertexGPUSource + FakeParticleFragmentSource);
+
+		ParticleBuffers[0] = FakeStorageBuffer::Create(capacity * GPUParticleSize);
+		ParticleBuffers[1] = FakeStorageBuffer::Create(capacity * GPUParticleSize);
+		IndirectBuffer = FakeStorageBuffer::Create((IndirectCommandBase + 10) * sizeof(uint32));
+		Clear();
+		}
+	else
+		{
+		RenderShader = FakeShader::CreateFromSource("FakeParticleCPU", FakeString(FakeParticleVertexCommonSource) + FakeParticleVertexCPUSource + FakeParticleFragmentSource);
+
+		for (std::vector<float> *array : { &PositionX, &PositionY, &PositionZ, &VelocityX, &VelocityY, &VelocityZ, &Age, &LifeTime })
+			array->resize(capacity);
+
+		InstanceBuffer = FakeVertexBuffer::Create(capacity * CPUParticleSize, FakeVertexBufferUsage::Stream);
+		spec.InstanceBuffer = InstanceBuffer;
+		spec.InstanceLayout = {
+			{ FakeShaderDataType::Float4, "a_PositionAge" }
+		};
+		}
+
+	Pipeline = FakePipeline::Create(spec);
+	}
+
+float FakeParticleSystem::Random()
+	{
+	RandomState ^= RandomState << 13;
+	RandomState ^= RandomState >> 17;
+	RandomState ^= RandomState << 5;
+	return (float)(RandomState >> 8) * (1.0f / 16777216.0f);
+	}
+
+void FakeParticleSystem::Update(FakeTimeStep ts)
+	{
+	const float timestep = (float)ts.GetSeconds();
+
+	// A long frame must not emit more particles than fit
+	EmissionDebt = std::min(EmissionDebt + Emitter.EmissionRate * timestep, (float)Emitter.MaxParticles);
+	uint32 emitCount = (uint32)EmissionDebt;
+	EmissionDebt -= (float)emitCount;
+
+	if (Simulation == FakeParticleSimulation::GPU)
+		UpdateGPU(timestep, emitCount);
+	else
+		UpdateCPU(timestep, emitCount);
+	}
+
+void FakeParticleSystem::UpdateGPU(float timestep, uint32 emitCount)
+	{
+	const uint32 source = Side;
+	const uint32 destination = 1 - Side;
+
+	SimulationShader->Bind();
+	ParticleBuffers[source]->Bind(SourceBinding);
+	ParticleBuffers[destination]->Bind(DestinationBinding);
+	IndirectBuffer->Bind(IndirectBinding);
+
+	SimulationShader->SetUniform("u_SourceCount", (int32)(IndirectCommandBase + source * 5 + 1));
+	SimulationShader->SetUniform("u_DestinationCount", (int32)(IndirectCommandBase + destination * 5 + 1));
+	SimulationShader->SetUniform("u_Capacity", (int32)Emitter.MaxParticles);
+	SimulationShader->SetUniform("u_EmitCount", (int32)emitCount);
+	SimulationShader->SetUniform("u_Seed", (int32)(Random() * 16777216.0f));
+	SimulationShader->SetUniform("u_Timestep", timestep);
+	SimulationShader->SetUniform("u_Drag", std::max(0.0f, 1.0f - Emitter.Drag * timestep));
+	SimulationShader->SetUniform("u_Acceleration", Emitter.Acceleration);
+	SimulationShader->SetUniform("u_Position", Emitter.Position);
+	SimulationShader->SetUniform("u_PositionVariance", Emitter.PositionVariance);
+	SimulationShader->SetUniform("u_Velocity", Emitter.Velocity);
+	SimulationShader->SetUniform("u_VelocityVariance", Emitter.VelocityVariance);
+	SimulationShader->SetUniform("u_LifeTime", Emitter.LifeTime);
+	SimulationShader->SetUniform("u_LifeTimeVariance", Emitter.LifeTimeVariance);
+
+	uint32 groupCounts[4] = { 1, Utils::fake_simulation_group_count(Emitter.MaxParticles), Utils::fake_simulation_group_count(emitCount), 1 };
+	for (int32 stage = 0; stage < 4; ++stage)
+		{
+		uint32 groups = groupCounts[stage];
+		if (!groups)
+			continue;
+
+		SimulationShader->SetUniform("u_Stage", stage);
+		FakeRenderer::Submit([groups]()
+			{
+			FakeRendererAPI::DispatchCompute(groups);
+			FakeRendererAPI::StorageBarrier();
+			});
+
+		Stats.Dispatches++;
+		}
+
+	// The GPU drops what does not fit, the count is an upper bound
+	Stats.EmittedCount += emitCount;
+	Side = destination;
+	}
+
+void FakeParticleSystem::UpdateCPU(float timestep, uint32 emitCount)
+	{
+	const float drag = std::max(0.0f, 1.0f - Emitter.Drag * timestep);
+
+	Utils::fake_advance_age(Age.data(), AliveCount, timestep);
+	Utils::fake_integrate_axis(PositionX.data(), VelocityX.data(), AliveCount, Emitter.Acceleration.X, timestep, drag);
+	Utils::fake_integrate_axis(PositionY.data(), VelocityY.data(), AliveCount, Emitter.Acceleration.Y, timestep, drag);
+	Utils::fake_integrate_axis(PositionZ.data(), VelocityZ.data(), AliveCount, Emitter.Acceleration.Z, timestep, drag);
+
+	// Dead particles are replaced by the last living one, the order of particles does not matter
+	uint32 i = 0;
+	while (i < AliveCount)
+		{
+		if (Age[i] < LifeTime[i])
+			{
+			++i;
+			continue;
+			}
+
+		const uint32 last = --AliveCount;
+		PositionX[i] = PositionX[last];
+		PositionY[i] = PositionY[last];
+		PositionZ[i] = PositionZ[last];
+		VelocityX[i] = VelocityX[last];
+		VelocityY[i] = VelocityY[last];
+		VelocityZ[i] = VelocityZ[last];
+		Age[i] = Age[last];
+		LifeTime[i] = LifeTime[last];
+		}
+
+	emitCount = std::min(emitCount, Emitter.MaxParticles - AliveCount);
+	for (uint32 n = 0; n < emitCount; ++n)
+		{
+		const uint32 index = AliveCount++;
+		PositionX[index] = Emitter.Position.X + (Random() * 2.0f - 1.0f) * Emitter.PositionVariance.X;
+		PositionY[index] = Emitter.Position.Y + (Random() * 2.0f - 1.0f) * Emitter.PositionVariance.Y;
+		PositionZ[index] = Emitter.Position.Z + (Random() * 2.0f - 1.0f) * Emitter.PositionVariance.Z;
+		VelocityX[index] = Emitter.Velocity.X + (Random() * 2.0f - 1.0f) * Emitter.VelocityVariance.X;
+		VelocityY[index] = Emitter.Velocity.Y + (Random() * 2.0f - 1.0f) * Emitter.VelocityVariance.Y;
+		VelocityZ[index] = Emitter.Velocity.Z + (Random() * 2.0f - 1.0f) * Emitter.VelocityVariance.Z;
+		Age[index] = 0.0f;
+		LifeTime[index] = std::max(Emitter.LifeTime + (Random() * 2.0f - 1.0f) * Emitter.LifeTimeVariance, 0.001f);
+		}
+
+	Stats.EmittedCount += emitCount;
+	Stats.AliveCount = AliveCount;
+	}
+
+void FakeParticleSystem::Draw(const FakeMat4f &view, const FakeMat4f &projection)
+	{
+	if (Simulation == FakeParticleSimulation::GPU)
+		{
+		Utils::fake_set_render_uniforms(RenderShader, Emitter, view, projection);
+		ParticleBuffers[Side]->Bind(ParticleBinding);
+
+		CornerBuffer->Bind();
+		Pipeline->Bind();
+		IndexBuffer->Bind();
+		IndirectBuffer->BindIndirect();
+
+		uint32 commandOffset = GetIndirectCommandOffset();
+		FakeRenderer::Submit([commandOffset]()
+			{
+			FakeRendererAPI::DrawIndexedIndirect(commandOffset, 0, 1, FakePrimitiveType::Triangles);
+			});
+
+		Stats.DrawCalls++;
+		return;
+		}
+
+	if (!AliveCount)
+		return;
+
+	// The instances go straight into the mapped stream buffer
+	const uint32 count = AliveCount;
+	float *instances = (float*)InstanceBuffer->Map(count * CPUParticleSize, CPUParticleSize);
+	for (uint32 i = 0; i < count; ++i)
+		{
+		instances[0] = PositionX[i];
+		instances[1] = PositionY[i];
+		instances[2] = PositionZ[i];
+		instances[3] = std::min(Age[i] / LifeTime[i], 1.0f);
+		instances += 4;
+		}
+
+	InstanceBuffer->Unmap(count * CPUParticleSize);
+	uint32 baseInstance = InstanceBuffer->GetStreamOffset() / CPUParticleSize;
+
+	Utils::fake_set_render_uniforms(RenderShader, Emitter, view, projection);
+	CornerBuffer->Bind();
+	Pipeline->Bind();
+	IndexBuffer->Bind();
+
+	FakeRenderer::Submit([count, baseInstance]()
+		{
+		FakeRendererAPI::DrawIndexedInstanced(6, count, 0, baseInstance, FakePrimitiveType::Triangles);
+		});
+
+	Stats.DrawCalls++;
+	Stats.UploadedBytes += count * CPUParticleSize;
+	}
+
+uint32 FakeParticleSystem::GetIndirectCommandOffset() const
+	{
+	return (IndirectCommandBase + Side * 5) * sizeof(uint32);
+	}
+
+void FakeParticleSystem::Clear()
+	{
+	AliveCount = 0;
+	EmissionDebt = 0.0f;
+	Stats.AliveCount = 0;
+
+	if (Simulation == FakeParticleSimulation::GPU)
+		{
+		// One draw per command, six indices of one quad and no particles yet
+		uint32 indirect[IndirectCommandBase + 10] = { 1, 0, 0, 0, 6, 0, 0, 0, 0, 6, 0, 0, 0, 0 };
+		IndirectBuffer->SetData(indirect, sizeof(indirect));
+		}
+	}
+
+void FakeParticleSystem::SetEmitter(const FakeParticleEmitter &emitter)
+	{
+	// The buffers have been allocated for the first emitter
+	const uint32 capacity = Emitter.MaxParticles;
+	Emitter = emitter;
+	Emitter.MaxParticles = capacity;
+	}
+
+void FakeParticleSystem::ResetStats()
+	{
+	// The particle count stays, only the counters of the frames are reset
+	Stats.EmittedCount = 0;
+	Stats.Dispatches = 0;
+	Stats.DrawCalls = 0;
+	Stats.UploadedBytes = 0;
+	}
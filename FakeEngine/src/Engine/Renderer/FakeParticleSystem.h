@@ -0,0 +1,182 @@
+/*****************************************************************
+ * \file   FakeParticleSystem.h
+ * \brief  
+ * 
+ * \author Can Karka
+ * \date   February 2021
+ * 
+ * Copyright (C) 2021 Can Karka
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *********************************************************************/
+
+#pragma once
+
+#include "Engine/Core/FakeTimeStep.h"
+#include "Engine/Core/Maths/FakeMaths.h"
+#include "Engine/Renderer/FakePipeline.h"
+#include "Engine/Renderer/FakeStorageBuffer.h"
+
+/**
+ *
+ * Describes the particles of a FakeParticleSystem. The values are read every update, changing them changes the
+ * particles emitted from then on.
+ *
+ */
+struct FakeParticleEmitter
+	{
+	uint32 MaxParticles = 10000;
+	float EmissionRate = 1000.0f; // Particles per second
+
+	FakeVec3f Position;
+	FakeVec3f PositionVariance; // Half the extent of the box the particles spawn in
+	FakeVec3f Velocity;
+	FakeVec3f VelocityVariance;
+	FakeVec3f Acceleration;
+	float Drag = 0.0f; // The part of the velocity lost per second
+
+	float LifeTime = 1.0f;
+	float LifeTimeVariance = 0.0f;
+
+	float SizeBegin = 1.0f;
+	float SizeEnd = 0.0f;
+	FakeVec4f ColorBegin = { 1.0f, 1.0f, 1.0f, 1.0f };
+	FakeVec4f ColorEnd = { 1.0f, 1.0f, 1.0f, 0.0f };
+	};
+
+enum class FakeParticleSimulation
+	{
+	Auto = 0, // GPU if the renderer supports compute shaders, CPU otherwise
+	GPU = 1,
+	CPU = 2
+	};
+
+/**
+ *
+ * Emits, simulates and draws camera facing particles.
+ *
+ * The GPU simulation keeps the particles in storage buffers, compute shaders move them and compact the living ones
+ * into the other buffer, which is drawn by an indirect instanced draw. The CPU never sees the particles, the cost of
+ * a frame does not depend on their count.
+ *
+ * The CPU simulation keeps the particles as a structure of arrays and moves four of them at once with SIMD, the
+ * living ones are drawn as instances. It runs without compute shaders and on the headless backends.
+ *
+ */
+class FAKE_API FakeParticleSystem : public FakeRefCounted
+	{
+	public:
+
+		struct Statistics
+			{
+			uint32 EmittedCount = 0;
+			uint32 AliveCount = 0; // Only known to the CPU simulation
+			uint32 Dispatches = 0;
+			uint32 DrawCalls = 0;
+			uint32 UploadedBytes = 0;
+			};
+
+	private:
+
+		FakeParticleEmitter Emitter;
+		FakeParticleSimulation Simulation;
+		float EmissionDebt = 0.0f;
+		uint32 RandomState = 0x9e3779b9u;
+
+		FakeRef<FakeVertexBuffer> CornerBuffer;
+		FakeRef<FakeIndexBuffer> IndexBuffer;
+		FakeRef<FakePipeline> Pipeline;
+		FakeRef<FakeShader> RenderShader;
+
+		// GPU, the particles of the last update are in ParticleBuffers[Side]
+		FakeRef<FakeShader> SimulationShader;
+		FakeRef<FakeStorageBuffer> ParticleBuffers[2];
+		FakeRef<FakeStorageBuffer> IndirectBuffer;
+		uint32 Side = 0;
+
+		// CPU, structure of arrays, the first AliveCount entries are living particles
+		std::vector<float> PositionX, PositionY, PositionZ;
+		std::vector<float> VelocityX, VelocityY, VelocityZ;
+		std::vector<float> Age, LifeTime;
+		uint32 AliveCount = 0;
+		FakeRef<FakeVertexBuffer> InstanceBuffer;
+
+		Statistics Stats;
+
+		float Random();
+		void UpdateGPU(float timestep, uint32 emitCount);
+		void UpdateCPU(float timestep, uint32 emitCount);
+
+	public:
+
+		/**
+		 *
+		 * Creates a particle system, the particle buffers are allocated for FakeParticleEmitter::MaxParticles.
+		 *
+		 * @param emitter The description of the particles.
+		 * @param simulation Where the particles are simulated.
+		 */
+		FakeParticleSystem(const FakeParticleEmitter &emitter, FakeParticleSimulation simulation = FakeParticleSimulation::Auto);
+
+		/**
+		 *
+		 * Emits new particles and moves the existing ones.
+		 *
+		 * @param ts The time since the last update.
+		 */
+		void Update(FakeTimeStep ts);
+
+		/**
+		 *
+		 * Draws the particles into the bound render pass.
+		 *
+		 * @param view The view matrix of the camera, the particles face the camera.
+		 * @param projection The projection matrix of the camera.
+		 */
+		void Draw(const FakeMat4f &view, const FakeMat4f &projection);
+
+		/**
+		 *
+		 * Removes all particles.
+		 *
+		 */
+		void Clear();
+
+		/**
+		 *
+		 * Replaces the emitter, MaxParticles can not be changed after the creation.
+		 *
+		 */
+		void SetEmitter(const FakeParticleEmitter &emitter);
+		const FakeParticleEmitter &GetEmitter() const { return Emitter; }
+
+		FakeParticleSimulation GetSimulation() const { return Simulation; }
+
+		/**
+		 *
+		 * Returns the buffer the GPU simulation writes its indirect draws into, the CPU simulation has none.
+		 * The instance count of the draw at GetIndirectCommandOffset() is the number of living particles.
+		 *
+		 */
+		const FakeRef<FakeStorageBuffer> &GetIndirectBuffer() const { return IndirectBuffer; }
+
+		/**
+		 *
+		 * Returns the offset in bytes of the draw of the particles of the last update inside GetIndirectBuffer().
+		 *
+		 */
+		uint32 GetIndirectCommandOffset() const;
+
+		void ResetStats();
+		Statistics GetStats() const { return Stats; }
+	};
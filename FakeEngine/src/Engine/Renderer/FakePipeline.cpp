@@ -1,10 +1,24 @@
 #include "FakePch.h"
 #include "FakePipeline.h"
 
+#include "FakeRendererAPI.h"
+#include "Engine/Platform/Null/FakeNullPipeline.h"
 #include "Engine/Platform/OpenGL/FakeOpenGLPipeline.h"
 
+#ifdef FAKE_RENDERER_VULKAN
+#include "Engine/Platform/Vulkan/FakeVulkanPipeline.h"
+#endif
+
 FakeRef<FakePipeline> FakePipeline::Create(const FakePipelineSpecification &spec)
 	{
+	if (FakeRendererAPI::IsHeadless())
+		return FakeRef<FakeNullPipeline>::Create(spec);
+
+	#ifdef FAKE_RENDERER_VULKAN
+		if (FakeRendererAPI::Current() == FakeRendererAPIType::Vulkan)
+			return FakeRef<FakeVulkanPipeline>::Create(spec);
+	#endif
+
 	#ifdef FAKE_RENDERER_OPENGL
 		return FakeRef<FakeOpenGLPipeline>::Create(spec);
 	#endif
@@ -37,6 +37,10 @@ struct FAKE_API FakePipelineSpecification
 	FakeRef<FakeVertexBuffer> VertexBuffer;
 	FakeRef<FakeIndexBuffer> IndexBuffer;
 	FakeVertexBufferLayout Layout;
+
+	// Optional per-instance attributes, they follow the attributes of Layout and advance once per instance
+	FakeRef<FakeVertexBuffer> InstanceBuffer;
+	FakeVertexBufferLayout InstanceLayout;
 	};
 
 /**
@@ -0,0 +1,458 @@
+#include "FakePch.h"
+#include "FakeRenderGraph.h"
+
+#include "FakeRenderer.h"
+
+namespace Utils
+	{
+	static bool fake_is_same_layout(const FakeFramebufferSpecification &spec, const FakeRenderGraphFramebufferDesc &desc, float scale)
+		{
+		const std::vector<FakeFramebufferTextureSpecification> &attachments = spec.Attachments.Attachments;
+		if (spec.Samples != desc.Samples || scale != desc.Scale || attachments.size() != desc.Attachments.Attachments.size())
+			return false;
+
+		for (size_t i = 0; i < attachments.size(); ++i)
+			{
+			if (attachments[i].Format != desc.Attachments.Attachments[i].Format)
+				return false;
+			}
+
+		return true;
+		}
+
+	static uint32 fake_scale_size(uint32 size, float scale)
+		{
+		return std::max((uint32)((float)size * scale), 1u);
+		}
+
+	static void fake_add_unique(std::vector<uint32> &list, uint32 value)
+		{
+		if (std::find(list.begin(), list.end(), value) == list.end())
+			list.push_back(value);
+		}
+	}
+
+FakeRenderGraphResource FakeRenderGraphBuilder::Create(const FakeString &name, const FakeRenderGraphFramebufferDesc &desc)
+	{
+	FakeRenderGraph::Resource resource;
+	resource.Name = name;
+	resource.Desc = desc;
+	Graph->Resources.push_back(resource);
+
+	FakeRenderGraphResource handle = (FakeRenderGraphResource)Graph->Resources.size() - 1;
+	Write(handle);
+	Graph->Passes[PassIndex].ClearTarget = true;
+	return handle;
+	}
+
+FakeRenderGraphResource FakeRenderGraphBuilder::Read(FakeRenderGraphResource resource)
+	{
+	FAKE_ASSERT(resource < Graph->Resources.size(), "Invalid render graph resource!");
+	Utils::fake_add_unique(Graph->Passes[PassIndex].Reads, resource);
+	return resource;
+	}
+
+FakeRenderGraphResource FakeRenderGraphBuilder::Write(FakeRenderGraphResource resource)
+	{
+	FAKE_ASSERT(resource < Graph->Resources.size(), "Invalid render graph resource!");
+
+	FakeRenderGraph::Pass &pass = Graph->Passes[PassIndex];
+	if (pass.Target != FakeRenderGraphInvalidResource && pass.Target != resource)
+		{
+		FAKE_LOG_ERROR("Pass %s renders into %s and %s, a pass can only render into one framebuffer!", *pass.Name, *Graph->Resources[pass.Target].Name, *Graph->Resources[resource].Name);
+		return resource;
+		}
+
+	pass.Target = resource;
+	Utils::fake_add_unique(pass.Writes, resource);
+	return resource;
+	}
+
+void FakeRenderGraphBuilder::SetSideEffect()
+	{
+	Graph->Passes[PassIndex].SideEffect = true;
+	}
+
+void FakeRenderGraph::AddPass(const FakeString &name, const std::function<void(FakeRenderGraphBuilder &builder)> &setup, const FakeRenderGraphExecuteFn &execute)
+	{
+	Pass pass;
+	pass.Name = name;
+	pass.Execute = execute;
+	Passes.push_back(pass);
+
+	FakeRenderGraphBuilder builder(this, (uint32)Passes.size() - 1);
+	setup(builder);
+	Dirty = true;
+	}
+
+FakeRenderGraphResource FakeRenderGraph::ImportFramebuffer(const FakeString &name, const FakeRef<FakeFramebuffer> &framebuffer)
+	{
+	FAKE_ASSERT(framebuffer, "Framebuffer can not be null!");
+
+	FakeRenderPassSpecification spec;
+	spec.TargetFramebuffer = framebuffer;
+
+	Resource resource;
+	resource.Name = name;
+	resource.Imported = framebuffer;
+	resource.ImportedRenderPass = FakeRenderPass::Create(spec);
+	resource.Output = true;
+	Resources.push_back(resource);
+
+	Dirty = true;
+	return (FakeRenderGraphResource)Resources.size() - 1;
+	}
+
+void FakeRenderGraph::MarkOutput(FakeRenderGraphResource resource)
+	{
+	FAKE_ASSERT(resource < Resources.size(), "Invalid render graph resource!");
+	Resources[resource].Output = true;
+	Dirty = true;
+	}
+
+void FakeRenderGraph::Reset()
+	{
+	Passes.clear();
+	Resources.clear();
+	Order.clear();
+	Dirty = true;
+	}
+
+bool FakeRenderGraph::Execute(uint32 width, uint32 height)
+	{
+	// A minimized window, keep the framebuffers until it comes back
+	if (width == 0 || height == 0)
+		return false;
+
+	if (Dirty || width != Width || height != Height)
+		{
+		Width = width;
+		Height = height;
+		Dirty = false;
+		Compiled = Compile();
+		}
+
+	if (!Compiled)
+		return false;
+
+	for (uint32 index : Order)
+		{
+		const Pass &pass = Passes[index];
+		if (pass.Target == FakeRenderGraphInvalidResource)
+			{
+			pass.Execute(*this);
+			continue;
+			}
+
+		const Resource &target = Resources[pass.Target];
+		const FakeRef<FakeRenderPass> &renderPass = target.Imported ? target.ImportedRenderPass : Framebuffers[target.Physical].RenderPass;
+		FakeRenderer::BeginRenderPass(renderPass, false);
+
+		// Aliased resources share a framebuffer but not its clear color, so the graph clears on its own
+		if (pass.ClearTarget)
+			{
+			FakeVec4f clearColor = target.Desc.ClearColor;
+			FakeRenderer::Submit([clearColor]()
+				{
+				FakeRendererAPI::SetClearColor(clearColor);
+				FakeRendererAPI::Clear();
+				});
+			}
+
+		pass.Execute(*this);
+		FakeRenderer::EndRenderPass();
+		}
+
+	return true;
+	}
+
+const FakeRef<FakeFramebuffer> &FakeRenderGraph::GetFramebuffer(FakeRenderGraphResource resource) const
+	{
+	FAKE_ASSERT(resource < Resources.size(), "Invalid render graph resource!");
+
+	const Resource &r = Resources[resource];
+	if (r.Imported)
+		return r.Imported;
+
+	FAKE_ASSERT(r.Physical < Framebuffers.size(), "Resource is only used by culled passes!");
+	return Framebuffers[r.Physical].Framebuffer;
+	}
+
+bool FakeRenderGraph::IsCulled(const FakeString &name) const
+	{
+	for (const Pass &pass : Passes)
+		{
+		if (pass.Name == name)
+			return pass.Culled;
+		}
+
+	return true;
+	}
+
+bool FakeRenderGraph::Compile()
+	{
+	// Passes can only use resources declared before them, so every dependency points to an earlier pass
+	std::vector<std::vector<uint32>> dependencies(Passes.size());
+	std::vector<std::vector<uint32>> producers(Passes.size());
+	std::vector<uint32> lastWriter(Resources.size(), ~0u);
+	std::vector<std::vector<uint32>> readers(Resources.size());
+
+	for (uint32 i = 0; i < (uint32)Passes.size(); ++i)
+		{
+		const Pass &pass = Passes[i];
+		for (FakeRenderGraphResource resource : pass.Reads)
+			{
+			if (std::find(pass.Writes.begin(), pass.Writes.end(), resource) != pass.Writes.end())
+				{
+				FAKE_LOG_ERROR("Pass %s reads the framebuffer %s it renders into!", *pass.Name, *Resources[resource].Name);
+				return false;
+				}
+
+			if (lastWriter[resource] == ~0u)
+				{
+				if (!Resources[resource].Imported)
+					{
+					FAKE_LOG_ERROR("Pass %s reads %s before a pass has written it!", *pass.Name, *Resources[resource].Name);
+					return false;
+					}
+				}
+			else
+				{
+				Utils::fake_add_unique(producers[i], lastWriter[resource]);
+				Utils::fake_add_unique(dependencies[i], lastWriter[resource]);
+				}
+
+			readers[resource].push_back(i);
+			}
+
+		for (FakeRenderGraphResource resource : pass.Writes)
+			{
+			// Rendering on top of what an earlier pass has written needs that pass
+			if (!pass.ClearTarget && lastWriter[resource] != ~0u)
+				Utils::fake_add_unique(producers[i], lastWriter[resource]);
+
+			if (lastWriter[resource] != ~0u)
+				Utils::fake_add_unique(dependencies[i], lastWriter[resource]);
+
+			// Passes which read the previous content have to run before it is overwritten
+			for (uint32 reader : readers[resource])
+				Utils::fake_add_unique(dependencies[i], reader);
+
+			lastWriter[resource] = i;
+			readers[resource].clear();
+			}
+		}
+
+	Cull(producers);
+	Sort(dependencies);
+	Allocate();
+
+	Stats.PassCount = (uint32)Passes.size();
+	Stats.CulledPassCount = (uint32)(Passes.size() - Order.size());
+	Stats.FramebufferCount = (uint32)Framebuffers.size();
+	Stats.CompileCount++;
+
+	FAKE_LOG_TRACE("Compiled render graph: %d of %d passes, %d transient framebuffers in %d framebuffers", (uint32)Order.size(), Stats.PassCount, Stats.TransientCount, Stats.FramebufferCount);
+	return true;
+	}
+
+void FakeRenderGraph::Cull(const std::vector<std::vector<uint32>> &producers)
+	{
+	std::vector<uint32> lastWriter(Resources.size(), ~0u);
+	for (uint32 i = 0; i < (uint32)Passes.size(); ++i)
+		{
+		Passes[i].Culled = true;
+		for (FakeRenderGraphResource resource : Passes[i].Writes)
+			lastWriter[resource] = i;
+		}
+
+	std::vector<uint32> stack;
+	for (uint32 i = 0; i < (uint32)Passes.size(); ++i)
+		{
+		if (Passes[i].SideEffect)
+			stack.push_back(i);
+		}
+
+	// What remains in an output is what the last pass writing it has left there
+	for (uint32 i = 0; i < (uint32)Resources.size(); ++i)
+		{
+		if (Resources[i].Output && lastWriter[i] != ~0u)
+			stack.push_back(lastWriter[i]);
+		}
+
+	while (!stack.empty())
+		{
+		uint32 index = stack.back();
+		stack.pop_back();
+		if (!Passes[index].Culled)
+			continue;
+
+		Passes[index].Culled = false;
+		for (uint32 producer : producers[index])
+			stack.push_back(producer);
+		}
+	}
+
+void FakeRenderGraph::Sort(const std::vector<std::vector<uint32>> &dependencies)
+	{
+	Order.clear();
+
+	std::vector<uint32> position(Passes.size(), ~0u);
+	std::vector<uint32> ready;
+	for (uint32 i = 0; i < (uint32)Passes.size(); ++i)
+		{
+		if (!Passes[i].Culled)
+			ready.push_back(i);
+		}
+
+	while (!ready.empty())
+		{
+		// Among the passes whose dependencies have run, take the one which depends on the most recent pass.
+		// Consumers run right after their producers, which keeps lifetimes short and lets more resources alias.
+		size_t best = ready.size();
+		int64 bestScore = -2;
+		for (size_t i = 0; i < ready.size(); ++i)
+			{
+			int64 score = -1;
+			bool runnable = true;
+			for (uint32 dependency : dependencies[ready[i]])
+				{
+				if (Passes[dependency].Culled)
+					continue;
+
+				if (position[dependency] == ~0u)
+					{
+					runnable = false;
+					break;
+					}
+
+				score = std::max(score, (int64)position[dependency]);
+				}
+
+			if (runnable && score > bestScore)
+				{
+				best = i;
+				bestScore = score;
+				}
+			}
+
+		// Dependencies always point to earlier passes, so the earliest waiting pass is runnable
+		FAKE_ASSERT(best < ready.size(), "Render graph has a cycle!");
+
+		position[ready[best]] = (uint32)Order.size();
+		Order.push_back(ready[best]);
+		ready.erase(ready.begin() + best);
+		}
+	}
+
+void FakeRenderGraph::Allocate()
+	{
+	std::vector<uint32> first(Resources.size(), ~0u);
+	std::vector<uint32> last(Resources.size(), 0);
+	for (uint32 i = 0; i < (uint32)Order.size(); ++i)
+		{
+		const Pass &pass = Passes[Order[i]];
+		for (FakeRenderGraphResource resource : pass.Reads)
+			{
+			first[resource] = std::min(first[resource], i);
+			last[resource] = std::max(last[resource], i);
+			}
+
+		for (FakeRenderGraphResource resource : pass.Writes)
+			{
+			first[resource] = std::min(first[resource], i);
+			last[resource] = std::max(last[resource], i);
+			}
+		}
+
+	Stats.TransientCount = 0;
+	for (uint32 i = 0; i < (uint32)Resources.size(); ++i)
+		{
+		Resources[i].Physical = ~0u;
+		if (Resources[i].Output)
+			last[i] = (uint32)Order.size();
+		if (!Resources[i].Imported && first[i] != ~0u)
+			Stats.TransientCount++;
+		}
+
+	// Walk the passes in order, a framebuffer becomes free after the last pass using it
+	std::vector<bool> used(Framebuffers.size(), false);
+	for (uint32 i = 0; i < (uint32)Order.size(); ++i)
+		{
+		for (uint32 r = 0; r < (uint32)Resources.size(); ++r)
+			{
+			if (Resources[r].Physical != ~0u && last[r] < i)
+				used[Resources[r].Physical] = false;
+			}
+
+		for (uint32 r = 0; r < (uint32)Resources.size(); ++r)
+			{
+			if (first[r] == i && !Resources[r].Imported)
+				Resources[r].Physical = AcquireFramebuffer(Resources[r], used);
+			}
+		}
+
+	// Drop the framebuffers of an earlier compilation which are not needed anymore
+	std::vector<uint32> remap(Framebuffers.size(), ~0u);
+	std::vector<PhysicalFramebuffer> framebuffers;
+	for (const Resource &resource : Resources)
+		{
+		if (resource.Physical == ~0u || remap[resource.Physical] != ~0u)
+			continue;
+
+		remap[resource.Physical] = (uint32)framebuffers.size();
+		framebuffers.push_back(Framebuffers[resource.Physical]);
+		}
+
+	for (Resource &resource : Resources)
+		{
+		if (resource.Physical != ~0u)
+			resource.Physical = remap[resource.Physical];
+		}
+
+	Framebuffers = std::move(framebuffers);
+
+	for (PhysicalFramebuffer &framebuffer : Framebuffers)
+		{
+		uint32 width = Utils::fake_scale_size(Width, framebuffer.Scale);
+		uint32 height = Utils::fake_scale_size(Height, framebuffer.Scale);
+
+		if (!framebuffer.Framebuffer)
+			{
+			framebuffer.Specification.Width = width;
+			framebuffer.Specification.Height = height;
+			framebuffer.Framebuffer = FakeFramebuffer::Create(framebuffer.Specification);
+
+			FakeRenderPassSpecification spec;
+			spec.TargetFramebuffer = framebuffer.Framebuffer;
+			framebuffer.RenderPass = FakeRenderPass::Create(spec);
+			}
+		else if (framebuffer.Framebuffer->GetWidth() != width || framebuffer.Framebuffer->GetHeight() != height)
+			{
+			framebuffer.Framebuffer->Resize(width, height);
+			}
+		}
+	}
+
+uint32 FakeRenderGraph::AcquireFramebuffer(const Resource &resource, std::vector<bool> &used)
+	{
+	for (uint32 i = 0; i < (uint32)Framebuffers.size(); ++i)
+		{
+		if (!used[i] && Utils::fake_is_same_layout(Framebuffers[i].Specification, resource.Desc, Framebuffers[i].Scale))
+			{
+			used[i] = true;
+			return i;
+			}
+		}
+
+	// The framebuffer is created once all resources have been placed
+	PhysicalFramebuffer framebuffer;
+	framebuffer.Specification.Attachments = resource.Desc.Attachments;
+	framebuffer.Specification.Samples = resource.Desc.Samples;
+	framebuffer.Specification.ClearColor = resource.Desc.ClearColor;
+	framebuffer.Specification.NoResize = true;
+	framebuffer.Scale = resource.Desc.Scale;
+	Framebuffers.push_back(framebuffer);
+	used.push_back(true);
+	return (uint32)Framebuffers.size() - 1;
+	}
@@ -0,0 +1,255 @@
+/*****************************************************************
+ * \file   FakeRenderGraph.h
+ * \brief  
+ * 
+ * \author Can Karka
+ * \date   February 2021
+ * 
+ * Copyright (C) 2021 Can Karka
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *********************************************************************/
+
+#pragma once
+
+#include "FakeFramebuffer.h"
+#include "FakeRenderPass.h"
+
+class FakeRenderGraph;
+
+/**
+ *
+ * A handle to a framebuffer of a render graph, valid until FakeRenderGraph::Reset().
+ *
+ */
+using FakeRenderGraphResource = uint32;
+static const FakeRenderGraphResource FakeRenderGraphInvalidResource = ~0u;
+
+/**
+ *
+ * Describes a transient framebuffer. Its size follows the resolution the graph is executed with.
+ *
+ */
+struct FAKE_API FakeRenderGraphFramebufferDesc
+	{
+	FakeFramebufferAttachmentSpecification Attachments;
+	uint32 Samples = 1;
+	float Scale = 1.0f;
+
+	FakeVec4f ClearColor = { 0.0f, 0.0f, 0.0f, 1.0f };
+	};
+
+using FakeRenderGraphExecuteFn = std::function<void(const FakeRenderGraph &graph)>;
+
+/**
+ *
+ * Declares what a pass reads and writes, handed to the setup function of FakeRenderGraph::AddPass().
+ *
+ */
+class FAKE_API FakeRenderGraphBuilder
+	{
+	friend class FakeRenderGraph;
+
+	private:
+
+		FakeRenderGraph *Graph;
+		uint32 PassIndex;
+
+		FakeRenderGraphBuilder(FakeRenderGraph *graph, uint32 passIndex)
+			: Graph(graph), PassIndex(passIndex)
+			{
+			}
+
+	public:
+
+		/**
+		 *
+		 * Creates a transient framebuffer which the pass renders into. It is cleared when the pass begins.
+		 *
+		 * @param name The name of the framebuffer, for logging.
+		 * @param desc The attachments and the size of the framebuffer.
+		 * @return Returns the handle of the new framebuffer.
+		 */
+		FakeRenderGraphResource Create(const FakeString &name, const FakeRenderGraphFramebufferDesc &desc);
+
+		/**
+		 *
+		 * Declares that the pass samples the attachments of a framebuffer, which orders the pass after the passes writing it.
+		 *
+		 * @param resource The framebuffer to read.
+		 * @return Returns the resource.
+		 */
+		FakeRenderGraphResource Read(FakeRenderGraphResource resource);
+
+		/**
+		 *
+		 * Declares that the pass renders into a framebuffer which earlier passes have written, without clearing it.
+		 *
+		 * @param resource The framebuffer to render into.
+		 * @return Returns the resource.
+		 */
+		FakeRenderGraphResource Write(FakeRenderGraphResource resource);
+
+		/**
+		 *
+		 * Keeps the pass even if nothing reads what it writes, for passes which read pixels back or write outside of the graph.
+		 *
+		 */
+		void SetSideEffect();
+	};
+
+/**
+ *
+ * Orders and culls render passes and allocates their framebuffers.
+ *
+ * The passes are declared once with AddPass() and the graph is compiled on the first Execute().
+ * It is only compiled again when passes are added or the resolution changes.
+ * Passes which do not contribute to an imported framebuffer, an output or a side effect are culled.
+ * Transient framebuffers whose lifetimes do not overlap share one framebuffer if their attachments and size match,
+ * so a graph needs far fewer framebuffers than it declares and a resize only reallocates the shared ones.
+ *
+ * Every pass renders into at most one framebuffer, which is bound around its execute function.
+ *
+ */
+class FAKE_API FakeRenderGraph : public FakeRefCounted
+	{
+	friend class FakeRenderGraphBuilder;
+
+	public:
+
+		struct Statistics
+			{
+			uint32 PassCount = 0;
+			uint32 CulledPassCount = 0;
+			uint32 TransientCount = 0;
+			uint32 FramebufferCount = 0;
+			uint32 CompileCount = 0;
+			};
+
+	private:
+
+		struct Pass
+			{
+			FakeString Name;
+			FakeRenderGraphExecuteFn Execute;
+			std::vector<FakeRenderGraphResource> Reads;
+			std::vector<FakeRenderGraphResource> Writes;
+			FakeRenderGraphResource Target = FakeRenderGraphInvalidResource;
+			bool ClearTarget = false;
+			bool SideEffect = false;
+			bool Culled = false;
+			};
+
+		struct Resource
+			{
+			FakeString Name;
+			FakeRenderGraphFramebufferDesc Desc;
+			FakeRef<FakeFramebuffer> Imported;
+			FakeRef<FakeRenderPass> ImportedRenderPass;
+			bool Output = false;
+			uint32 Physical = ~0u;
+			};
+
+		struct PhysicalFramebuffer
+			{
+			FakeFramebufferSpecification Specification;
+			float Scale = 1.0f;
+			FakeRef<FakeFramebuffer> Framebuffer;
+			FakeRef<FakeRenderPass> RenderPass;
+			};
+
+		std::vector<Pass> Passes;
+		std::vector<Resource> Resources;
+		std::vector<PhysicalFramebuffer> Framebuffers;
+		std::vector<uint32> Order;
+
+		uint32 Width = 0;
+		uint32 Height = 0;
+		bool Dirty = true;
+		bool Compiled = false;
+		Statistics Stats;
+
+		bool Compile();
+		void Cull(const std::vector<std::vector<uint32>> &producers);
+		void Sort(const std::vector<std::vector<uint32>> &dependencies);
+		void Allocate();
+		uint32 AcquireFramebuffer(const Resource &resource, std::vector<bool> &used);
+
+	public:
+
+		/**
+		 *
+		 * Adds a pass. The setup function is called right away and declares the resources of the pass.
+		 *
+		 * @param name The name of the pass, for logging.
+		 * @param setup Declares what the pass reads and writes.
+		 * @param execute Records the draw calls of the pass, called by Execute() while the target of the pass is bound.
+		 */
+		void AddPass(const FakeString &name, const std::function<void(FakeRenderGraphBuilder &builder)> &setup, const FakeRenderGraphExecuteFn &execute);
+
+		/**
+		 *
+		 * Makes a framebuffer which lives outside of the graph, like the editor viewport, available to the passes.
+		 * Imported framebuffers are outputs of the graph, the graph neither resizes nor aliases them.
+		 *
+		 * @param name The name of the framebuffer, for logging.
+		 * @param framebuffer The framebuffer to import.
+		 * @return Returns the handle of the framebuffer.
+		 */
+		FakeRenderGraphResource ImportFramebuffer(const FakeString &name, const FakeRef<FakeFramebuffer> &framebuffer);
+
+		/**
+		 *
+		 * Keeps a transient framebuffer alive until the end of the graph, so it can be read after Execute().
+		 *
+		 * @param resource The framebuffer to keep.
+		 */
+		void MarkOutput(FakeRenderGraphResource resource);
+
+		/**
+		 *
+		 * Removes all passes and resources. The framebuffers are kept and reused by the next compilation.
+		 *
+		 */
+		void Reset();
+
+		/**
+		 *
+		 * Compiles the graph if passes have been added or the resolution has changed, and records all passes which are not culled.
+		 *
+		 * @param width The resolution transient framebuffers are scaled from.
+		 * @param height The resolution transient framebuffers are scaled from.
+		 * @return Returns false if the graph could not be compiled, nothing is recorded then.
+		 */
+		bool Execute(uint32 width, uint32 height);
+
+		/**
+		 *
+		 * Returns the framebuffer behind a handle. Only valid while the graph executes, or for outputs after it.
+		 *
+		 * @param resource The handle of the framebuffer.
+		 * @return Returns the framebuffer.
+		 */
+		const FakeRef<FakeFramebuffer> &GetFramebuffer(FakeRenderGraphResource resource) const;
+
+		/**
+		 *
+		 * Returns whether a pass was culled by the last compilation.
+		 *
+		 * @param name The name of the pass.
+		 * @return Returns true if the pass is culled or does not exist.
+		 */
+		bool IsCulled(const FakeString &name) const;
+
+		Statistics GetStats() const { return Stats; }
+	};
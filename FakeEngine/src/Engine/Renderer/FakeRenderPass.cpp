@@ -1,10 +1,24 @@
 #include "FakePch.h"
 #include "FakeRenderPass.h"
 
+#include "FakeRendererAPI.h"
+#include "Engine/Platform/Null/FakeNullRenderPass.h"
 #include "Engine/Platform/OpenGL/FakeOpenGLRenderPass.h"
 
+#ifdef FAKE_RENDERER_VULKAN
+#include "Engine/Platform/Vulkan/FakeVulkanRenderPass.h"
+#endif
+
 FakeRef<FakeRenderPass> FakeRenderPass::Create(const FakeRenderPassSpecification &spec)
 	{
+	if (FakeRendererAPI::IsHeadless())
+		return FakeRef<FakeNullRenderPass>::Create(spec);
+
+	#ifdef FAKE_RENDERER_VULKAN
+		if (FakeRendererAPI::Current() == FakeRendererAPIType::Vulkan)
+			return FakeRef<FakeVulkanRenderPass>::Create(spec);
+	#endif
+
 	#ifdef FAKE_RENDERER_OPENGL
 		return FakeRef<FakeOpenGLRenderPass>::Create(spec);
 	#endif
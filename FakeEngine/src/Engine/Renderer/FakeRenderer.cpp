@@ -3,14 +3,14 @@
 
 #include "FakeShader.h"
 #include "FakeRenderer2D.h"
-
-FakeRendererAPIType FakeRendererAPI::CurrentRendererAPI = FakeRendererAPIType::OpenGL;
+#include "FakeSceneRenderer.h"
 
 struct FakeRendererData
 	{
 	FakeRef<FakeRenderPass> ActiveRenderPass;
 	FakeRef<FakeShaderLibrary> ShaderLibrary;
 	FakeRenderCommandQueue CommandQueue;
+	uint32 FrameIndex = 0;
 	};
 
 static FakeRendererData Data;
@@ -25,14 +25,18 @@ void FakeRenderer::Init()
 	Data.ShaderLibrary = FakeRef<FakeShaderLibrary>::Create();
 	FakeRenderer::Submit([]() { FakeRendererAPI::Init(); });
 
-	Data.ShaderLibrary->Load("assets/shaders/FakeFlatColorShader.glsl");
-	Data.ShaderLibrary->Load("assets/shaders/FakeTextureShader.glsl");
+	// The flat color shader is the FLAT_COLOR variant of the texture shader
+	uint32 textureShader = Data.ShaderLibrary->LoadVariants("assets/shaders/FakeTextureShader.glsl");
+	Data.ShaderLibrary->Prewarm(textureShader, { 0, Data.ShaderLibrary->GetVariantKey(textureShader, { "FLAT_COLOR" }) });
+	Data.ShaderLibrary->FinishCompilation();
 
 	FakeRenderer2D::Init();
+	FakeSceneRenderer::Init();
 	}
 
 void FakeRenderer::Shutdown()
 	{
+	FakeSceneRenderer::Shutdown();
 	FakeRenderer2D::Shutdown();
 	
 
@@ -58,9 +62,14 @@ void FakeRenderer::SetLineThickness(float thickness)
 	FakeRenderer::Submit([=]() { FakeRendererAPI::SetLineThickness(thickness); });
 	}
 
-void FakeRenderer::DrawIndexed(uint32 count, FakePrimitiveType type, bool depthTest)
+void FakeRenderer::SetBlend(bool enabled)
+	{
+	FakeRenderer::Submit([=]() { FakeRendererAPI::SetBlend(enabled); });
+	}
+
+void FakeRenderer::DrawIndexed(uint32 count, FakePrimitiveType type, bool depthTest, FakeIndexFormat format, uint32 baseVertex)
 	{
-	FakeRenderer::Submit([=]() { FakeRendererAPI::DrawIndexed(count, type, depthTest); });
+	FakeRenderer::Submit([=]() { FakeRendererAPI::DrawIndexed(count, type, depthTest, format, baseVertex); });
 	}
 
 void FakeRenderer::SetViewport(uint32 width, uint32 height)
@@ -68,9 +77,33 @@ void FakeRenderer::SetViewport(uint32 width, uint32 height)
 	FakeRenderer::Submit([=]() { FakeRendererAPI::SetViewport(width, height); });
 	}
 
+void *FakeRenderer::SubmitData(const void *data, uint32 size)
+	{
+	// An empty command whose storage holds the copy
+	void *memory = GetRenderCommandQueue().Allocate([](void*) {}, size);
+	memcpy(memory, data, size);
+	return memory;
+	}
+
 void FakeRenderer::Render()
 	{
+	FakeRendererAPI::ResetStats();
 	Data.CommandQueue.Execute();
+	FakeRendererAPI::SubmitFrame();
+
+	// Readbacks requested by this frame are not finished yet, but those of earlier frames usually are
+	FakeRendererAPI::ResolveReadbacks();
+	Data.FrameIndex++;
+	}
+
+void FakeRenderer::Flush()
+	{
+	Data.CommandQueue.Execute();
+	}
+
+uint32 FakeRenderer::GetFrameIndex()
+	{
+	return Data.FrameIndex;
 	}
 
 void FakeRenderer::BeginRenderPass(FakeRef<FakeRenderPass> renderPass, bool shouldClear)
@@ -65,7 +65,8 @@ class FakeRenderer
 		static void SetClearColor(float r, float g, float b, float a);
 		static void SetClearColor(const FakeVec4f &color);
 		static void SetLineThickness(float thickness);
-		static void DrawIndexed(uint32 count, FakePrimitiveType type, bool depthTest = true);
+		static void SetBlend(bool enabled);
+		static void DrawIndexed(uint32 count, FakePrimitiveType type, bool depthTest = true, FakeIndexFormat format = FakeIndexFormat::UInt32, uint32 baseVertex = 0);
 		static void SetViewport(uint32 width, uint32 height);
 
 		/**
@@ -75,6 +76,23 @@ class FakeRenderer
 		 */
 		static void Render();
 
+		/**
+		 *
+		 * Executes the commands recorded so far without ending the frame.
+		 * The statistics, the frame index and the readbacks are left alone, the frame goes on with the next command.
+		 *
+		 */
+		static void Flush();
+
+		/**
+		 *
+		 * Returns the index of the frame which is currently recorded, it increases with every Render().
+		 * Commands recorded with the same index are executed together.
+		 *
+		 * @return Returns the index of the current frame.
+		 */
+		static uint32 GetFrameIndex();
+
 		/**
 		 * 
 		 * .
@@ -93,6 +111,17 @@ class FakeRenderer
 
 		static FakeShaderLibrary &GetShaderLibrary();
 
+		/**
+		 *
+		 * Copies data into the command queue. The copy stays valid until the queue has been executed,
+		 * so commands can read data which changes again before they run.
+		 *
+		 * @param data The data to copy.
+		 * @param size The size of the data in bytes.
+		 * @return Returns the copy.
+		 */
+		static void *SubmitData(const void *data, uint32 size);
+
 		/**
 		 * 
 		 * .
@@ -1,12 +1,246 @@
 #include "FakePch.h"
 #include "FakeRenderer2D.h"
 
+#include <string_view>
+
 #include "FakeRenderer.h"
+#include "FakeRendererAPI.h"
 #include "FakeShader.h"
 #include "FakeVertexBuffer.h"
 #include "FakeIndexBuffer.h"
 #include "FakePipeline.h"
 
+// Multi-channel signed distance field text, the median of the channels is the distance to the edge of the glyph
+static const char *FakeRenderer2DTextSource = R"(
+#type vertex
+#version 450 core
+
+layout(location = 0) in vec3 a_Position;
+layout(location = 1) in vec4 a_Color;
+layout(location = 2) in vec2 a_TexCoord;
+
+uniform mat4 u_ViewProjection;
+
+out vec4 v_Color;
+out vec2 v_TexCoord;
+
+void main()
+	{
+	v_Color = a_Color;
+	v_TexCoord = a_TexCoord;
+
+	gl_Position = u_ViewProjection * vec4(a_Position, 1.0);
+	}
+
+#type fragment
+#version 450 core
+
+layout(location = 0) out vec4 Color;
+layout(location = 1) out int ObjectID;
+
+in vec4 v_Color;
+in vec2 v_TexCoord;
+
+uniform sampler2D u_FontAtlas;
+uniform float u_DistanceRange;
+
+float Median(float r, float g, float b)
+	{
+	return max(min(r, g), min(max(r, g), b));
+	}
+
+void main()
+	{
+	// The distance range in screen pixels keeps the edge about one pixel wide at every text size
+	vec2 unitRange = vec2(u_DistanceRange) / vec2(textureSize(u_FontAtlas, 0));
+	vec2 screenTexSize = vec2(1.0) / fwidth(v_TexCoord);
+	float screenPxRange = max(0.5 * dot(unitRange, screenTexSize), 1.0);
+
+	vec3 distances = texture(u_FontAtlas, v_TexCoord).rgb;
+	float screenPxDistance = screenPxRange * (Median(distances.r, distances.g, distances.b) - 0.5);
+	float opacity = clamp(screenPxDistance + 0.5, 0.0, 1.0);
+	if (opacity == 0.0)
+		discard;
+
+	Color = vec4(v_Color.rgb, v_Color.a * opacity);
+	ObjectID = -1;
+	}
+)";
+
+// Lines, circles and rounded rectangles are one instance each, the vertex shader expands the instance to a quad
+// around the shape and the fragment shader cuts the shape out of it by its signed distance.
+static const char *FakeRenderer2DLineSource = R"(
+#type vertex
+#version 450 core
+
+layout(location = 0) in vec2 a_Corner;
+layout(location = 1) in vec3 a_Start;
+layout(location = 2) in vec3 a_End;
+layout(location = 3) in vec4 a_Color;
+layout(location = 4) in float a_Thickness;
+
+uniform mat4 u_ViewProjection;
+
+out vec4 v_Color;
+out vec2 v_Local;
+out flat float v_Length;
+out flat float v_HalfThickness;
+
+void main()
+	{
+	vec2 direction = a_End.xy - a_Start.xy;
+	float len = length(direction);
+	direction = len > 0.0 ? direction / len : vec2(1.0, 0.0);
+	vec2 normal = vec2(-direction.y, direction.x);
+
+	// The quad covers the round caps at both ends
+	float halfThickness = a_Thickness * 0.5;
+	float t = a_Corner.x * 0.5 + 0.5;
+	vec3 position = mix(a_Start, a_End, t);
+	position.xy += direction * (a_Corner.x * halfThickness) + normal * (a_Corner.y * halfThickness);
+
+	v_Color = a_Color;
+	v_Local = vec2(mix(-halfThickness, len + halfThickness, t), a_Corner.y * halfThickness);
+	v_Length = len;
+	v_HalfThickness = halfThickness;
+
+	gl_Position = u_ViewProjection * vec4(position, 1.0);
+	}
+
+#type fragment
+#version 450 core
+
+layout(location = 0) out vec4 Color;
+layout(location = 1) out int ObjectID;
+
+in vec4 v_Color;
+in vec2 v_Local;
+in flat float v_Length;
+in flat float v_HalfThickness;
+
+void main()
+	{
+	float distance = length(vec2(v_Local.x - clamp(v_Local.x, 0.0, v_Length), v_Local.y)) - v_HalfThickness;
+	float alpha = clamp(0.5 - distance / max(fwidth(distance), 0.00001), 0.0, 1.0);
+	if (alpha == 0.0)
+		discard;
+
+	Color = vec4(v_Color.rgb, v_Color.a * alpha);
+	ObjectID = -1;
+	}
+)";
+
+static const char *FakeRenderer2DCircleSource = R"(
+#type vertex
+#version 450 core
+
+layout(location = 0) in vec2 a_Corner;
+layout(location = 1) in vec3 a_Center;
+layout(location = 2) in float a_Radius;
+layout(location = 3) in vec4 a_Color;
+layout(location = 4) in float a_Thickness;
+
+uniform mat4 u_ViewProjection;
+
+out vec4 v_Color;
+out vec2 v_Local;
+out flat float v_Radius;
+out flat float v_Thickness;
+
+void main()
+	{
+	v_Color = a_Color;
+	v_Local = a_Corner * a_Radius;
+	v_Radius = a_Radius;
+	v_Thickness = a_Thickness;
+
+	gl_Position = u_ViewProjection * vec4(a_Center + vec3(v_Local, 0.0), 1.0);
+	}
+
+#type fragment
+#version 450 core
+
+layout(location = 0) out vec4 Color;
+layout(location = 1) out int ObjectID;
+
+in vec4 v_Color;
+in vec2 v_Local;
+in flat float v_Radius;
+in flat float v_Thickness;
+
+void main()
+	{
+	float distance = length(v_Local) - v_Radius;
+	if (v_Thickness > 0.0)
+		distance = abs(distance + v_Thickness * 0.5) - v_Thickness * 0.5;
+
+	float alpha = clamp(0.5 - distance / max(fwidth(distance), 0.00001), 0.0, 1.0);
+	if (alpha == 0.0)
+		discard;
+
+	Color = vec4(v_Color.rgb, v_Color.a * alpha);
+	ObjectID = -1;
+	}
+)";
+
+static const char *FakeRenderer2DRectSource = R"(
+#type vertex
+#version 450 core
+
+layout(location = 0) in vec2 a_Corner;
+layout(location = 1) in vec3 a_Center;
+layout(location = 2) in vec2 a_HalfSize;
+layout(location = 3) in float a_Radius;
+layout(location = 4) in vec4 a_Color;
+layout(location = 5) in float a_Thickness;
+
+uniform mat4 u_ViewProjection;
+
+out vec4 v_Color;
+out vec2 v_Local;
+out flat vec2 v_HalfSize;
+out flat float v_Radius;
+out flat float v_Thickness;
+
+void main()
+	{
+	v_Color = a_Color;
+	v_Local = a_Corner * a_HalfSize;
+	v_HalfSize = a_HalfSize;
+	v_Radius = a_Radius;
+	v_Thickness = a_Thickness;
+
+	gl_Position = u_ViewProjection * vec4(a_Center + vec3(v_Local, 0.0), 1.0);
+	}
+
+#type fragment
+#version 450 core
+
+layout(location = 0) out vec4 Color;
+layout(location = 1) out int ObjectID;
+
+in vec4 v_Color;
+in vec2 v_Local;
+in flat vec2 v_HalfSize;
+in flat float v_Radius;
+in flat float v_Thickness;
+
+void main()
+	{
+	vec2 q = abs(v_Local) - v_HalfSize + v_Radius;
+	float distance = length(max(q, 0.0)) + min(max(q.x, q.y), 0.0) - v_Radius;
+	if (v_Thickness > 0.0)
+		distance = abs(distance + v_Thickness * 0.5) - v_Thickness * 0.5;
+
+	float alpha = clamp(0.5 - distance / max(fwidth(distance), 0.00001), 0.0, 1.0);
+	if (alpha == 0.0)
+		discard;
+
+	Color = vec4(v_Color.rgb, v_Color.a * alpha);
+	ObjectID = -1;
+	}
+)";
+
 struct QuadVertex
 	{
 	FakeVec3f Position;
@@ -16,20 +250,60 @@ struct QuadVertex
 	float TilingFactor;
 	};
 
-struct LineVertex
+struct LineInstance
 	{
-	FakeVec3f Position;
+	FakeVec3f Start;
+	FakeVec3f End;
+	FakeVec4f Color;
+	float Thickness;
+	};
+
+struct CircleInstance
+	{
+	FakeVec3f Center;
+	float Radius;
 	FakeVec4f Color;
+	float Thickness;
 	};
 
-struct CircleVertex
+struct RectInstance
 	{
-	FakeVec3f WorldPosition;
-	FakeVec2f LocalPosition;
+	FakeVec3f Center;
+	FakeVec2f HalfSize;
+	float Radius;
 	FakeVec4f Color;
 	float Thickness;
 	};
 
+// The instances of one primitive type, written straight into the mapped instance buffer
+struct PrimitiveBatch
+	{
+	FakeRef<FakePipeline> Pipeline;
+	FakeRef<FakeShader> Shader;
+	FakeRef<FakeVertexBuffer> InstanceBuffer;
+	uint32 InstanceSize = 0;
+	uint32 MaxInstances = 0;
+
+	uint32 InstanceCount = 0;
+	Byte *InstanceBufferBase = nullptr;
+	Byte *InstanceBufferPtr = nullptr;
+	};
+
+struct TextVertex
+	{
+	FakeVec3f Position;
+	FakeVec4f Color;
+	FakeVec2f TexCoord;
+	};
+
+struct CachedTextLayout
+	{
+	FakeRef<FakeFont> Font;
+	FakeString Text;
+	FakeTextLayout Layout;
+	uint32 LastUsedFrame = 0;
+	};
+
 struct FakeRenderer2DData
 	{
 	static const uint32 MaxQuads = 20000;
@@ -37,32 +311,44 @@ struct FakeRenderer2DData
 	static const uint32 MaxIndices = MaxQuads * 6;
 	static const uint32 MaxTextureSlots = 32;
 
+	// Quad vertices are written straight into the mapped stream buffer, a frame holds this many full batches before it is executed early
+	static const uint32 MaxQuadBatchesPerFrame = 2;
+
 	static const uint32 MaxLines = 10000;
-	static const uint32 MaxLineVertices = MaxLines * 2;
-	static const uint32 MaxLineIndices = MaxLines * 6;
+	static const uint32 MaxCircles = 10000;
+	static const uint32 MaxRects = 10000;
 
 	FakeRef<FakePipeline> QuadPipeline;
-	FakeRef<FakePipeline> CirclePipeline;
-	FakeRef<FakePipeline> LinePipeline;
+	FakeRef<FakePipeline> TextPipeline;
 
 	FakeRef<FakeTexture2D> WhiteTexture;
 	FakeVec4f QuadVertexPositions[4];
 
 	FakeRef<FakeShader> TextureShader;
-	FakeRef<FakeShader> CircleShader;
-	FakeRef<FakeShader> LineShader;
+	FakeRef<FakeShader> TextShader;
 
 	uint32 QuadIndexCount = 0;
+	FakeRef<FakeVertexBuffer> QuadVertexBuffer;
 	QuadVertex *QuadVertexBufferBase = nullptr;
 	QuadVertex *QuadVertexBufferPtr = nullptr;
 
-	uint32 CircleIndexCount = 0;
-	CircleVertex *CircleVertexBufferBase = nullptr;
-	CircleVertex *CircleVertexBufferPtr = nullptr;
+	// Text has its own batch, all glyphs of a batch come from the atlas of TextFont
+	uint32 TextIndexCount = 0;
+	FakeRef<FakeVertexBuffer> TextVertexBuffer;
+	TextVertex *TextVertexBufferBase = nullptr;
+	TextVertex *TextVertexBufferPtr = nullptr;
+	FakeRef<FakeFont> TextFont;
 
-	uint32 LineIndexCount = 0;
-	LineVertex *LineVertexBufferBase = nullptr;
-	LineVertex *LineVertexBufferPtr = nullptr;
+	// Layouts of strings which have not been drawn for this many frames are dropped
+	static const uint32 TextLayoutLifetime = 60;
+	std::unordered_map<uint64, CachedTextLayout> TextLayoutCache;
+	uint32 LastTextLayoutSweep = 0;
+
+	// The corners of the quad every primitive instance is expanded to
+	FakeRef<FakeVertexBuffer> PrimitiveVertexBuffer;
+	PrimitiveBatch LineBatch;
+	PrimitiveBatch CircleBatch;
+	PrimitiveBatch RectBatch;
 
 	std::array<FakeRef<FakeTexture2D>, MaxTextureSlots> TextureSlots;
 	uint32 TextureSlotIndex = 1; // 0 = White Texture
@@ -74,17 +360,172 @@ struct FakeRenderer2DData
 
 static FakeRenderer2DData *Data;
 
-void FakeRenderer2D::FlushAndReset()
+namespace Utils
 	{
-	EndScene();
+	static void fake_create_primitive_batch(PrimitiveBatch &batch, const FakeString &name, const char *source, const FakeVertexBufferLayout &instanceLayout, uint32 instanceSize, uint32 maxInstances, const FakeRef<FakeIndexBuffer> &indexBuffer)
+		{
+		batch.Shader = FakeShader::CreateFromSource(name, source);
+		batch.InstanceSize = instanceSize;
+		batch.MaxInstances = maxInstances;
+		batch.InstanceBuffer = FakeVertexBuffer::Create(FakeRenderer2DData::MaxQuadBatchesPerFrame * maxInstances * instanceSize, FakeVertexBufferUsage::Stream);
+
+		FakePipelineSpecification spec;
+		spec.Layout = {
+			{ FakeShaderDataType::Float2, "a_Corner" }
+		};
+
+		spec.VertexBuffer = Data->PrimitiveVertexBuffer;
+		spec.IndexBuffer = indexBuffer;
+		spec.InstanceBuffer = batch.InstanceBuffer;
+		spec.InstanceLayout = instanceLayout;
+		batch.Pipeline = FakePipeline::Create(spec);
+		}
+
+	static void fake_start_primitive_batch(PrimitiveBatch &batch)
+		{
+		batch.InstanceCount = 0;
+		batch.InstanceBufferBase = (Byte*)batch.InstanceBuffer->Map(batch.MaxInstances * batch.InstanceSize, batch.InstanceSize);
+		batch.InstanceBufferPtr = batch.InstanceBufferBase;
+		}
+
+	static void fake_draw_primitive_batch(PrimitiveBatch &batch)
+		{
+		uint32 dataSize = (uint32)(batch.InstanceBufferPtr - batch.InstanceBufferBase);
+		if (batch.InstanceBufferBase)
+			{
+			batch.InstanceBuffer->Unmap(dataSize);
+			batch.InstanceBufferBase = nullptr;
+			batch.InstanceBufferPtr = nullptr;
+			}
 
+		if (!dataSize)
+			return;
+
+		uint32 instanceCount = batch.InstanceCount;
+		uint32 baseInstance = batch.InstanceBuffer->GetStreamOffset() / batch.InstanceSize;
+
+		batch.Shader->Bind();
+		batch.Shader->SetUniform("u_ViewProjection", Data->CameraViewProjection);
+
+		Data->PrimitiveVertexBuffer->Bind();
+		batch.Pipeline->Bind();
+		batch.Pipeline->GetSpecification().IndexBuffer->Bind();
+
+		// The first six indices of the quad index buffer are one quad
+		FakeRenderer::Submit([=]()
+			{
+			FakeRendererAPI::DrawIndexedInstanced(6, instanceCount, 0, baseInstance, FakePrimitiveType::Triangles, false);
+			});
+
+		Data->Stats.DrawCalls++;
+		}
+
+	template<typename T>
+	static T *fake_push_primitive(PrimitiveBatch &batch)
+		{
+		T *instance = (T*)batch.InstanceBufferPtr;
+		batch.InstanceBufferPtr += sizeof(T);
+		batch.InstanceCount++;
+		return instance;
+		}
+	}
+
+void FakeRenderer2D::StartQuadBatch()
+	{
 	Data->QuadIndexCount = 0;
+	Data->QuadVertexBufferBase = (QuadVertex*)Data->QuadVertexBuffer->Map(FakeRenderer2DData::MaxVertices * sizeof(QuadVertex), sizeof(QuadVertex));
 	Data->QuadVertexBufferPtr = Data->QuadVertexBufferBase;
+	}
+
+void FakeRenderer2D::FlushAndReset()
+	{
+	EndScene();
+	StartQuadBatch();
+	StartTextBatch();
+	Utils::fake_start_primitive_batch(Data->LineBatch);
+	Utils::fake_start_primitive_batch(Data->CircleBatch);
+	Utils::fake_start_primitive_batch(Data->RectBatch);
+
 	Data->TextureSlotIndex = 1;
 	}
 
 void FakeRenderer2D::FlushAndResetLines()
 	{
+	Utils::fake_draw_primitive_batch(Data->LineBatch);
+	Utils::fake_start_primitive_batch(Data->LineBatch);
+	}
+
+void FakeRenderer2D::FlushAndResetCircles()
+	{
+	Utils::fake_draw_primitive_batch(Data->CircleBatch);
+	Utils::fake_start_primitive_batch(Data->CircleBatch);
+	}
+
+void FakeRenderer2D::FlushAndResetRects()
+	{
+	Utils::fake_draw_primitive_batch(Data->RectBatch);
+	Utils::fake_start_primitive_batch(Data->RectBatch);
+	}
+
+void FakeRenderer2D::StartTextBatch()
+	{
+	Data->TextIndexCount = 0;
+	Data->TextVertexBufferBase = (TextVertex*)Data->TextVertexBuffer->Map(FakeRenderer2DData::MaxVertices * sizeof(TextVertex), sizeof(TextVertex));
+	Data->TextVertexBufferPtr = Data->TextVertexBufferBase;
+	}
+
+void FakeRenderer2D::DrawTextBatch()
+	{
+	uint32 dataSize = (uint8*)Data->TextVertexBufferPtr - (uint8*)Data->TextVertexBufferBase;
+	if (Data->TextVertexBufferBase)
+		{
+		Data->TextVertexBuffer->Unmap(dataSize);
+		Data->TextVertexBufferBase = nullptr;
+		Data->TextVertexBufferPtr = nullptr;
+		}
+
+	if (!dataSize)
+		return;
+
+	uint32 baseVertex = Data->TextVertexBuffer->GetStreamOffset() / sizeof(TextVertex);
+
+	Data->TextShader->Bind();
+	Data->TextShader->SetUniform("u_ViewProjection", Data->CameraViewProjection);
+	Data->TextShader->SetUniform("u_FontAtlas", 0);
+	Data->TextShader->SetUniform("u_DistanceRange", Data->TextFont->GetMetrics().DistanceRange);
+	Data->TextFont->GetAtlas()->Bind(0);
+
+	Data->TextVertexBuffer->Bind();
+	Data->TextPipeline->Bind();
+	Data->TextPipeline->GetSpecification().IndexBuffer->Bind();
+	FakeRenderer::DrawIndexed(Data->TextIndexCount, FakePrimitiveType::Triangles, Data->DepthTest, FakeIndexFormat::UInt32, baseVertex);
+	Data->Stats.DrawCalls++;
+	}
+
+void FakeRenderer2D::FlushAndResetText()
+	{
+	DrawTextBatch();
+	StartTextBatch();
+	}
+
+float FakeRenderer2D::GetTextureIndex(FakeTexture2D *texture)
+	{
+	if (!texture)
+		return 0.0f;
+
+	for (uint32 i = 1; i < Data->TextureSlotIndex; ++i)
+		{
+		if (Data->TextureSlots[i].Raw() == texture || *Data->TextureSlots[i].Raw() == *texture)
+			return (float)i;
+		}
+
+	if (Data->TextureSlotIndex >= FakeRenderer2DData::MaxTextureSlots)
+		FlushAndReset();
+
+	float textureIndex = (float)Data->TextureSlotIndex;
+	Data->TextureSlots[Data->TextureSlotIndex] = texture;
+	Data->TextureSlotIndex++;
+	return textureIndex;
 	}
 
 void FakeRenderer2D::Init()
@@ -92,9 +533,9 @@ void FakeRenderer2D::Init()
 	Data = new FakeRenderer2DData;
 
 	// SHADERS
-	Data->TextureShader = FakeRenderer::GetShaderLibrary().Get("FakeTextureShader");
-	Data->LineShader = nullptr;
-	Data->CircleShader = nullptr;
+	FakeShaderLibrary &library = FakeRenderer::GetShaderLibrary();
+	Data->TextureShader = library.GetVariant(library.GetVariantFamily("FakeTextureShader"), 0);
+	Data->TextShader = FakeShader::CreateFromSource("FakeRenderer2DText", FakeRenderer2DTextSource);
 
 	// QUADS
 	FakePipelineSpecification quadVertexBufferPipeline;
@@ -106,8 +547,8 @@ void FakeRenderer2D::Init()
 		{ FakeShaderDataType::Float, "a_TilingFactor" }
 	};
 
-	Data->QuadVertexBufferBase = new QuadVertex[Data->MaxVertices];
-	quadVertexBufferPipeline.VertexBuffer = FakeVertexBuffer::Create(Data->MaxVertices * sizeof(QuadVertex));
+	Data->QuadVertexBuffer = FakeVertexBuffer::Create(FakeRenderer2DData::MaxQuadBatchesPerFrame * FakeRenderer2DData::MaxVertices * sizeof(QuadVertex), FakeVertexBufferUsage::Stream);
+	quadVertexBufferPipeline.VertexBuffer = Data->QuadVertexBuffer;
 
 	uint32 *quadIndices = new uint32[Data->MaxIndices];
 	uint32 offset = 0;
@@ -124,10 +565,24 @@ void FakeRenderer2D::Init()
 		offset += 4;
 		}
 
-	quadVertexBufferPipeline.IndexBuffer = FakeIndexBuffer::Create(quadIndices, Data->MaxIndices);
+	quadVertexBufferPipeline.IndexBuffer = FakeIndexBuffer::Create(quadIndices, Data->MaxIndices * sizeof(uint32));
 	delete[] quadIndices;
 	Data->QuadPipeline = FakePipeline::Create(quadVertexBufferPipeline);
 
+	// TEXT
+	FakePipelineSpecification textVertexBufferPipeline;
+	textVertexBufferPipeline.Layout = {
+		{ FakeShaderDataType::Float3, "a_Position" },
+		{ FakeShaderDataType::Float4, "a_Color" },
+		{ FakeShaderDataType::Float2, "a_TexCoord" }
+	};
+
+	// Glyphs are quads, they share the index buffer of the quads
+	Data->TextVertexBuffer = FakeVertexBuffer::Create(FakeRenderer2DData::MaxQuadBatchesPerFrame * FakeRenderer2DData::MaxVertices * sizeof(TextVertex), FakeVertexBufferUsage::Stream);
+	textVertexBufferPipeline.VertexBuffer = Data->TextVertexBuffer;
+	textVertexBufferPipeline.IndexBuffer = quadVertexBufferPipeline.IndexBuffer;
+	Data->TextPipeline = FakePipeline::Create(textVertexBufferPipeline);
+
 	// TEXTURE
 	Data->WhiteTexture = FakeTexture2D::Create(FakeTextureFormat::RGBA, 1, 1);
 	uint32 whiteTextureData = 0xffffffff;
@@ -141,36 +596,31 @@ void FakeRenderer2D::Init()
 	Data->QuadVertexPositions[2] = {  0.5f,  0.5f, 0.0f, 1.0f };
 	Data->QuadVertexPositions[3] = { -0.5f,  0.5f, 0.0f, 1.0f };
 
-	// LINES
-	FakePipelineSpecification lineVertexBufferPipeline;
-	lineVertexBufferPipeline.Layout = {
-		{ FakeShaderDataType::Float3, "a_Position" },
-		{ FakeShaderDataType::Float4, "a_Color" }
-	};
-
-	Data->LineVertexBufferBase = new LineVertex[Data->MaxLineVertices];
-	lineVertexBufferPipeline.VertexBuffer = FakeVertexBuffer::Create(Data->MaxLineVertices * sizeof(LineVertex));
-
-	uint32 *lineIndices = new uint32[Data->MaxLineIndices];
-	for (uint32 i = 0; i < Data->MaxLineIndices; ++i)
-		lineIndices[i] = i;
+	// LINES, CIRCLES AND ROUNDED RECTANGLES
+	FakeVec2f corners[4] = { { -1.0f, -1.0f }, { 1.0f, -1.0f }, { 1.0f, 1.0f }, { -1.0f, 1.0f } };
+	Data->PrimitiveVertexBuffer = FakeVertexBuffer::Create(corners, sizeof(corners));
 
-	lineVertexBufferPipeline.IndexBuffer = FakeIndexBuffer::Create(lineIndices, Data->MaxLineIndices);
-	delete[] lineIndices;
-	Data->LinePipeline = FakePipeline::Create(lineVertexBufferPipeline);
+	Utils::fake_create_primitive_batch(Data->LineBatch, "FakeRenderer2DLine", FakeRenderer2DLineSource, {
+		{ FakeShaderDataType::Float3, "a_Start" },
+		{ FakeShaderDataType::Float3, "a_End" },
+		{ FakeShaderDataType::Float4, "a_Color" },
+		{ FakeShaderDataType::Float, "a_Thickness" }
+	}, sizeof(LineInstance), FakeRenderer2DData::MaxLines, quadVertexBufferPipeline.IndexBuffer);
 
-	// CIRCLES
-	FakePipelineSpecification circleVertexBufferPipeline;
-	circleVertexBufferPipeline.Layout = {
-		{ FakeShaderDataType::Float3, "a_WorldPosition" },
-		{ FakeShaderDataType::Float, "a_Thickness" },
-		{ FakeShaderDataType::Float2, "a_LocalPosition" },
+	Utils::fake_create_primitive_batch(Data->CircleBatch, "FakeRenderer2DCircle", FakeRenderer2DCircleSource, {
+		{ FakeShaderDataType::Float3, "a_Center" },
+		{ FakeShaderDataType::Float, "a_Radius" },
 		{ FakeShaderDataType::Float4, "a_Color" },
-	};
+		{ FakeShaderDataType::Float, "a_Thickness" }
+	}, sizeof(CircleInstance), FakeRenderer2DData::MaxCircles, quadVertexBufferPipeline.IndexBuffer);
 
-	Data->CircleVertexBufferBase = new CircleVertex[Data->MaxVertices];
-	circleVertexBufferPipeline.VertexBuffer = FakeVertexBuffer::Create(Data->MaxVertices * sizeof(CircleVertex));
-	Data->CirclePipeline = FakePipeline::Create(circleVertexBufferPipeline);
+	Utils::fake_create_primitive_batch(Data->RectBatch, "FakeRenderer2DRect", FakeRenderer2DRectSource, {
+		{ FakeShaderDataType::Float3, "a_Center" },
+		{ FakeShaderDataType::Float2, "a_HalfSize" },
+		{ FakeShaderDataType::Float, "a_Radius" },
+		{ FakeShaderDataType::Float4, "a_Color" },
+		{ FakeShaderDataType::Float, "a_Thickness" }
+	}, sizeof(RectInstance), FakeRenderer2DData::MaxRects, quadVertexBufferPipeline.IndexBuffer);
     }
 
 void FakeRenderer2D::Shutdown()
@@ -201,24 +651,45 @@ void FakeRenderer2D::BeginScene(const FakeMat4f &viewProjection, bool depthTest)
 	Data->TextureShader->Bind();
 	Data->TextureShader->SetUniform("u_ViewProjection", Data->CameraViewProjection);
 
-	Data->QuadIndexCount = 0;
-	Data->QuadVertexBufferPtr = Data->QuadVertexBufferBase;
-
-	Data->LineIndexCount = 0;
-	Data->LineVertexBufferPtr = Data->LineVertexBufferBase;
+	StartQuadBatch();
+	StartTextBatch();
+	Data->TextFont = nullptr;
 
-	Data->CircleIndexCount = 0;
-	Data->CircleVertexBufferPtr = Data->CircleVertexBufferBase;
+	Utils::fake_start_primitive_batch(Data->LineBatch);
+	Utils::fake_start_primitive_batch(Data->CircleBatch);
+	Utils::fake_start_primitive_batch(Data->RectBatch);
 
 	Data->TextureSlotIndex = 1;
+
+	// Drop the layouts of strings which are no longer drawn, once every lifetime is enough
+	uint32 frameIndex = FakeRenderer::GetFrameIndex();
+	if (frameIndex - Data->LastTextLayoutSweep >= FakeRenderer2DData::TextLayoutLifetime)
+		{
+		for (auto it = Data->TextLayoutCache.begin(); it != Data->TextLayoutCache.end();)
+			{
+			if (frameIndex - it->second.LastUsedFrame >= FakeRenderer2DData::TextLayoutLifetime)
+				it = Data->TextLayoutCache.erase(it);
+			else
+				++it;
+			}
+
+		Data->LastTextLayoutSweep = frameIndex;
+		}
 	}
 
 void FakeRenderer2D::EndScene()
 	{
 	uint32 dataSize = (uint8*)Data->QuadVertexBufferPtr - (uint8*)Data->QuadVertexBufferBase;
+	if (Data->QuadVertexBufferBase)
+		{
+		Data->QuadVertexBuffer->Unmap(dataSize);
+		Data->QuadVertexBufferBase = nullptr;
+		Data->QuadVertexBufferPtr = nullptr;
+		}
+
 	if (dataSize)
 		{
-		Data->QuadPipeline->GetSpecification().VertexBuffer->SetData(Data->QuadVertexBufferBase, dataSize);
+		uint32 baseVertex = Data->QuadVertexBuffer->GetStreamOffset() / sizeof(QuadVertex);
 
 		Data->TextureShader->Bind();
 		Data->TextureShader->SetUniform("u_ViewProjection", Data->CameraViewProjection);
@@ -226,43 +697,18 @@ void FakeRenderer2D::EndScene()
 		for (uint32 i = 0; i < Data->TextureSlotIndex; ++i)
 			Data->TextureSlots[i]->Bind(i);
 
-		Data->QuadPipeline->GetSpecification().VertexBuffer->Bind();
+		Data->QuadVertexBuffer->Bind();
 		Data->QuadPipeline->Bind();
 		Data->QuadPipeline->GetSpecification().IndexBuffer->Bind();
-		FakeRenderer::DrawIndexed(Data->QuadIndexCount, FakePrimitiveType::Triangles, Data->DepthTest);
-		Data->Stats.DrawCalls++;
-		}
-
-	dataSize = (uint8*)Data->LineVertexBufferPtr - (uint8*)Data->LineVertexBufferBase;
-	if (dataSize)
-		{
-		Data->LinePipeline->GetSpecification().VertexBuffer->SetData(Data->LineVertexBufferBase, dataSize);
-
-		Data->LineShader->Bind();
-		Data->LineShader->SetUniform("u_ViewProjection", Data->CameraViewProjection);
-
-		Data->LinePipeline->GetSpecification().VertexBuffer->Bind();
-		Data->LinePipeline->Bind();
-		Data->LinePipeline->GetSpecification().IndexBuffer->Bind();
-		FakeRenderer::SetLineThickness(2.0f);
-		FakeRenderer::DrawIndexed(Data->LineIndexCount, FakePrimitiveType::Lines, false);
+		FakeRenderer::DrawIndexed(Data->QuadIndexCount, FakePrimitiveType::Triangles, Data->DepthTest, FakeIndexFormat::UInt32, baseVertex);
 		Data->Stats.DrawCalls++;
 		}
 
-	dataSize = (uint8*)Data->CircleVertexBufferPtr - (uint8*)Data->CircleVertexBufferBase;
-	if (dataSize)
-		{
-		Data->CirclePipeline->GetSpecification().VertexBuffer->SetData(Data->CircleVertexBufferBase, dataSize);
-
-		Data->CircleShader->Bind();
-		Data->CircleShader->SetUniform("u_ViewProjection", Data->CameraViewProjection);
-
-		Data->CirclePipeline->GetSpecification().VertexBuffer->Bind();
-		Data->CirclePipeline->Bind();
-		Data->CirclePipeline->GetSpecification().IndexBuffer->Bind();
-		FakeRenderer::DrawIndexed(Data->CircleIndexCount, FakePrimitiveType::Triangles, false);
-		Data->Stats.DrawCalls++;
-		}
+	// Every primitive type has its own batch, text is drawn last so it stays on top
+	Utils::fake_draw_primitive_batch(Data->RectBatch);
+	Utils::fake_draw_primitive_batch(Data->CircleBatch);
+	Utils::fake_draw_primitive_batch(Data->LineBatch);
+	DrawTextBatch();
 	}
 
 void FakeRenderer2D::Flush()
@@ -291,9 +737,10 @@ void FakeRenderer2D::DrawQuad(const FakeMat4f &transform, const FakeVec4f &color
 
 	for (size_t i = 0; i < quadVertexCount; ++i)
 		{
-		Data->QuadVertexBufferPtr->Position = transform * Data->QuadVertexPositions[i];
+		Data->QuadVertexBufferPtr->Position = FakeVec3f::Transform(FakeVec3f(Data->QuadVertexPositions[i].X, Data->QuadVertexPositions[i].Y, Data->QuadVertexPositions[i].Z), transform);
 		Data->QuadVertexBufferPtr->Color = color;
 		Data->QuadVertexBufferPtr->TexCoord = textureCoords[i];
+		Data->QuadVertexBufferPtr->TexIndex = textureIndex;
 		Data->QuadVertexBufferPtr->TilingFactor = tilingFactor;
 		Data->QuadVertexBufferPtr++;
 		}
@@ -358,28 +805,28 @@ void FakeRenderer2D::DrawTexture(const FakeMat4f &transform, const FakeRef<FakeT
 		Data->TextureSlotIndex++;
 		}
 
-	Data->QuadVertexBufferPtr->Position = transform * Data->QuadVertexPositions[0];
+	Data->QuadVertexBufferPtr->Position = FakeVec3f::Transform(FakeVec3f(Data->QuadVertexPositions[0].X, Data->QuadVertexPositions[0].Y, Data->QuadVertexPositions[0].Z), transform);
 	Data->QuadVertexBufferPtr->Color = color;
 	Data->QuadVertexBufferPtr->TexCoord = { 0.0f, 0.0f };
 	Data->QuadVertexBufferPtr->TexIndex = textureIndex;
 	Data->QuadVertexBufferPtr->TilingFactor = tilingFactor;
 	Data->QuadVertexBufferPtr++;
 
-	Data->QuadVertexBufferPtr->Position = transform * Data->QuadVertexPositions[1];
+	Data->QuadVertexBufferPtr->Position = FakeVec3f::Transform(FakeVec3f(Data->QuadVertexPositions[1].X, Data->QuadVertexPositions[1].Y, Data->QuadVertexPositions[1].Z), transform);
 	Data->QuadVertexBufferPtr->Color = color;
 	Data->QuadVertexBufferPtr->TexCoord = { 1.0f, 0.0f };
 	Data->QuadVertexBufferPtr->TexIndex = textureIndex;
 	Data->QuadVertexBufferPtr->TilingFactor = tilingFactor;
 	Data->QuadVertexBufferPtr++;
 
-	Data->QuadVertexBufferPtr->Position = transform * Data->QuadVertexPositions[2];
+	Data->QuadVertexBufferPtr->Position = FakeVec3f::Transform(FakeVec3f(Data->QuadVertexPositions[2].X, Data->QuadVertexPositions[2].Y, Data->QuadVertexPositions[2].Z), transform);
 	Data->QuadVertexBufferPtr->Color = color;
 	Data->QuadVertexBufferPtr->TexCoord = { 1.0f, 1.0f };
 	Data->QuadVertexBufferPtr->TexIndex = textureIndex;
 	Data->QuadVertexBufferPtr->TilingFactor = tilingFactor;
 	Data->QuadVertexBufferPtr++;
 
-	Data->QuadVertexBufferPtr->Position = transform * Data->QuadVertexPositions[3];
+	Data->QuadVertexBufferPtr->Position = FakeVec3f::Transform(FakeVec3f(Data->QuadVertexPositions[3].X, Data->QuadVertexPositions[3].Y, Data->QuadVertexPositions[3].Z), transform);
 	Data->QuadVertexBufferPtr->Color = color;
 	Data->QuadVertexBufferPtr->TexCoord = { 0.0f, 1.0f };
 	Data->QuadVertexBufferPtr->TexIndex = textureIndex;
@@ -454,3 +901,171 @@ void FakeRenderer2D::DrawTexture(const FakeVec3f &position, const FakeVec2f &siz
 	Data->Stats.QuadCount++;
 	}
 
+void FakeRenderer2D::DrawSprites(const Sprite *sprites, uint32 count)
+	{
+	static const FakeVec2f textureCoords[] = { { 0.0f, 0.0f }, { 1.0f, 0.0f }, { 1.0f, 1.0f }, { 0.0f, 1.0f } };
+
+	FakeTexture2D *currentTexture = nullptr;
+	float textureIndex = 0.0f;
+
+	for (uint32 i = 0; i < count; ++i)
+		{
+		const Sprite &sprite = sprites[i];
+
+		if (Data->QuadIndexCount >= FakeRenderer2DData::MaxIndices)
+			{
+			FlushAndReset();
+			currentTexture = nullptr;
+			textureIndex = 0.0f;
+			}
+
+		if (sprite.Texture != currentTexture)
+			{
+			textureIndex = GetTextureIndex(sprite.Texture);
+			currentTexture = sprite.Texture;
+			}
+
+		// The unit quad corners are +-0.5 along the first two rows of the transform
+		const FakeMat4f &m = *sprite.Transform;
+		const FakeVec3f right = { m.M11 * 0.5f, m.M12 * 0.5f, m.M13 * 0.5f };
+		const FakeVec3f up = { m.M21 * 0.5f, m.M22 * 0.5f, m.M23 * 0.5f };
+		const FakeVec3f center = { m.M41, m.M42, m.M43 };
+
+		QuadVertex *vertex = Data->QuadVertexBufferPtr;
+		vertex[0].Position = { center.X - right.X - up.X, center.Y - right.Y - up.Y, center.Z - right.Z - up.Z };
+		vertex[1].Position = { center.X + right.X - up.X, center.Y + right.Y - up.Y, center.Z + right.Z - up.Z };
+		vertex[2].Position = { center.X + right.X + up.X, center.Y + right.Y + up.Y, center.Z + right.Z + up.Z };
+		vertex[3].Position = { center.X - right.X + up.X, center.Y - right.Y + up.Y, center.Z - right.Z + up.Z };
+
+		for (uint32 v = 0; v < 4; ++v)
+			{
+			vertex[v].Color = *sprite.Color;
+			vertex[v].TexCoord = textureCoords[v];
+			vertex[v].TexIndex = textureIndex;
+			vertex[v].TilingFactor = sprite.TilingFactor;
+			}
+
+		Data->QuadVertexBufferPtr += 4;
+		Data->QuadIndexCount += 6;
+		}
+
+	Data->Stats.QuadCount += count;
+	}
+
+void FakeRenderer2D::DrawLine(const FakeVec3f &start, const FakeVec3f &end, const FakeVec4f &color, float thickness)
+	{
+	if (Data->LineBatch.InstanceCount >= FakeRenderer2DData::MaxLines)
+		FlushAndResetLines();
+
+	LineInstance *line = Utils::fake_push_primitive<LineInstance>(Data->LineBatch);
+	line->Start = start;
+	line->End = end;
+	line->Color = color;
+	line->Thickness = thickness;
+
+	Data->Stats.LineCount++;
+	}
+
+void FakeRenderer2D::DrawLine(const FakeVec2f &start, const FakeVec2f &end, const FakeVec4f &color, float thickness)
+	{
+	DrawLine({ start.X, start.Y, 0.0f }, { end.X, end.Y, 0.0f }, color, thickness);
+	}
+
+void FakeRenderer2D::DrawCircle(const FakeVec3f &center, float radius, const FakeVec4f &color, float thickness)
+	{
+	if (Data->CircleBatch.InstanceCount >= FakeRenderer2DData::MaxCircles)
+		FlushAndResetCircles();
+
+	CircleInstance *circle = Utils::fake_push_primitive<CircleInstance>(Data->CircleBatch);
+	circle->Center = center;
+	circle->Radius = radius;
+	circle->Color = color;
+	circle->Thickness = thickness;
+
+	Data->Stats.CircleCount++;
+	}
+
+void FakeRenderer2D::DrawCircle(const FakeVec2f &center, float radius, const FakeVec4f &color, float thickness)
+	{
+	DrawCircle({ center.X, center.Y, 0.0f }, radius, color, thickness);
+	}
+
+void FakeRenderer2D::DrawRoundedRect(const FakeVec3f &center, const FakeVec2f &size, float cornerRadius, const FakeVec4f &color, float thickness)
+	{
+	if (Data->RectBatch.InstanceCount >= FakeRenderer2DData::MaxRects)
+		FlushAndResetRects();
+
+	const FakeVec2f halfSize = { size.X * 0.5f, size.Y * 0.5f };
+
+	RectInstance *rect = Utils::fake_push_primitive<RectInstance>(Data->RectBatch);
+	rect->Center = center;
+	rect->HalfSize = halfSize;
+	rect->Radius = std::max(0.0f, std::min(cornerRadius, std::min(halfSize.X, halfSize.Y)));
+	rect->Color = color;
+	rect->Thickness = thickness;
+
+	Data->Stats.RectCount++;
+	}
+
+void FakeRenderer2D::DrawRoundedRect(const FakeVec2f &center, const FakeVec2f &size, float cornerRadius, const FakeVec4f &color, float thickness)
+	{
+	DrawRoundedRect({ center.X, center.Y, 0.0f }, size, cornerRadius, color, thickness);
+	}
+
+void FakeRenderer2D::DrawString(const FakeString &text, const FakeRef<FakeFont> &font, const FakeMat4f &transform, const FakeVec4f &color)
+	{
+	uint64 key = std::hash<std::string_view>()(std::string_view(text.C_Str(), text.Length()));
+	key ^= (uint64)(size_t)font.Raw() * 0x9e3779b97f4a7c15ull;
+
+	CachedTextLayout &cached = Data->TextLayoutCache[key];
+	if (cached.Font.Raw() != font.Raw() || cached.Text != text)
+		{
+		cached.Font = font;
+		cached.Text = text;
+		font->Layout(text, cached.Layout);
+		Data->Stats.TextLayoutCount++;
+		}
+
+	cached.LastUsedFrame = FakeRenderer::GetFrameIndex();
+	DrawString(cached.Layout, font, transform, color);
+	}
+
+void FakeRenderer2D::DrawString(const FakeTextLayout &layout, const FakeRef<FakeFont> &font, const FakeMat4f &transform, const FakeVec4f &color)
+	{
+	// The text shader samples one atlas, text in another font starts a new batch
+	if (Data->TextFont.Raw() != font.Raw())
+		{
+		if (Data->TextFont)
+			FlushAndResetText();
+
+		Data->TextFont = font;
+		}
+
+	const FakeMat4f &m = transform;
+	const FakeVec3f right = { m.M11, m.M12, m.M13 };
+	const FakeVec3f up = { m.M21, m.M22, m.M23 };
+	const FakeVec3f origin = { m.M41, m.M42, m.M43 };
+
+	for (const FakeTextGlyph &glyph : layout.Glyphs)
+		{
+		if (Data->TextIndexCount >= FakeRenderer2DData::MaxIndices)
+			FlushAndResetText();
+
+		const FakeVec2f corners[4] = { { glyph.Min.X, glyph.Min.Y }, { glyph.Max.X, glyph.Min.Y }, { glyph.Max.X, glyph.Max.Y }, { glyph.Min.X, glyph.Max.Y } };
+		const FakeVec2f textureCoords[4] = { { glyph.TexCoordMin.X, glyph.TexCoordMin.Y }, { glyph.TexCoordMax.X, glyph.TexCoordMin.Y }, { glyph.TexCoordMax.X, glyph.TexCoordMax.Y }, { glyph.TexCoordMin.X, glyph.TexCoordMax.Y } };
+
+		TextVertex *vertex = Data->TextVertexBufferPtr;
+		for (uint32 v = 0; v < 4; ++v)
+			{
+			const FakeVec2f &corner = corners[v];
+			vertex[v].Position = { origin.X + right.X * corner.X + up.X * corner.Y, origin.Y + right.Y * corner.X + up.Y * corner.Y, origin.Z + right.Z * corner.X + up.Z * corner.Y };
+			vertex[v].Color = color;
+			vertex[v].TexCoord = textureCoords[v];
+			}
+
+		Data->TextVertexBufferPtr += 4;
+		Data->TextIndexCount += 6;
+		}
+
+	Data->Stats.GlyphCount += (uint32)layout.Glyphs.size();
+	}
@@ -24,13 +24,21 @@
 
 #include "Engine/Core/Maths/FakeMaths.h"
 #include "Engine/Renderer/FakeTexture2D.h"
+#include "Engine/Renderer/FakeFont.h"
 
 class FakeRenderer2D
 	{
 	private:
 
+		static void StartQuadBatch();
 		static void FlushAndReset();
 		static void FlushAndResetLines();
+		static void FlushAndResetCircles();
+		static void FlushAndResetRects();
+		static void StartTextBatch();
+		static void DrawTextBatch();
+		static void FlushAndResetText();
+		static float GetTextureIndex(FakeTexture2D *texture);
 
 	public:
 
@@ -39,18 +47,36 @@ class FakeRenderer2D
 			uint32 DrawCalls = 0;
 			uint32 QuadCount = 0;
 			uint32 LineCount = 0;
+			uint32 CircleCount = 0;
+			uint32 RectCount = 0;
+			uint32 GlyphCount = 0;
+			uint32 TextLayoutCount = 0; // Strings which were not in the layout cache
 
+			// Lines, circles and rectangles are instances, the vertex shader expands each of them to a quad
 			uint32 GetTotalVertexCount()
 				{
-				return QuadCount * 4 + LineCount * 2;
+				return (QuadCount + LineCount + CircleCount + RectCount + GlyphCount) * 4;
 				}
 
 			uint32 GetTotalIndexCount()
 				{
-				return QuadCount * 6 + LineCount * 2;
+				return (QuadCount + LineCount + CircleCount + RectCount + GlyphCount) * 6;
 				}
 			};
 
+		/**
+		 *
+		 * A quad for DrawSprites(), the referenced data has to stay alive until DrawSprites() returns.
+		 *
+		 */
+		struct Sprite
+			{
+			const FakeMat4f *Transform;
+			const FakeVec4f *Color;
+			FakeTexture2D *Texture; // nullptr draws with the white texture
+			float TilingFactor;
+			};
+
 		static void Init();
 		static void Shutdown();
 
@@ -69,4 +95,67 @@ class FakeRenderer2D
 		static void DrawTexture(const FakeMat4f &transform, const FakeRef<FakeTexture2D> &texture, float tilingFactor = 1.0f, const FakeVec4f &tintColor = FakeVec4f(1.0f, 1.0f, 1.0f, 1.0f));
 		static void DrawTexture(const FakeVec2f &position, const FakeVec2f &size, const FakeRef<FakeTexture2D> &texture, float tilingFactor = 1.0f, const FakeVec4f &tintColor = FakeVec4f(1.0f, 1.0f, 1.0f, 1.0f));
 		static void DrawTexture(const FakeVec3f &position, const FakeVec2f &size, const FakeRef<FakeTexture2D> &texture, float tilingFactor = 1.0f, const FakeVec4f &tintColor = FakeVec4f(1.0f, 1.0f, 1.0f, 1.0f));
+
+		// Draws many quads in one pass, sort them by texture first to keep texture slot lookups rare
+		static void DrawSprites(const Sprite *sprites, uint32 count);
+
+		/**
+		 *
+		 * Draws an antialiased line with round caps. The line lies in the XY plane, the thickness is in world units.
+		 *
+		 * @param start The first end point.
+		 * @param end The second end point.
+		 * @param color The color of the line.
+		 * @param thickness The width of the line.
+		 */
+		static void DrawLine(const FakeVec3f &start, const FakeVec3f &end, const FakeVec4f &color, float thickness = 1.0f);
+		static void DrawLine(const FakeVec2f &start, const FakeVec2f &end, const FakeVec4f &color, float thickness = 1.0f);
+
+		/**
+		 *
+		 * Draws an antialiased circle in the XY plane.
+		 *
+		 * @param center The center of the circle.
+		 * @param radius The outer radius.
+		 * @param color The color of the circle.
+		 * @param thickness The width of the ring inside the radius, 0 fills the circle.
+		 */
+		static void DrawCircle(const FakeVec3f &center, float radius, const FakeVec4f &color, float thickness = 0.0f);
+		static void DrawCircle(const FakeVec2f &center, float radius, const FakeVec4f &color, float thickness = 0.0f);
+
+		/**
+		 *
+		 * Draws an antialiased rectangle with rounded corners in the XY plane.
+		 *
+		 * @param center The center of the rectangle.
+		 * @param size The width and height.
+		 * @param cornerRadius The radius of the corners, it is limited to half the smaller side.
+		 * @param color The color of the rectangle.
+		 * @param thickness The width of the outline inside the rectangle, 0 fills the rectangle.
+		 */
+		static void DrawRoundedRect(const FakeVec3f &center, const FakeVec2f &size, float cornerRadius, const FakeVec4f &color, float thickness = 0.0f);
+		static void DrawRoundedRect(const FakeVec2f &center, const FakeVec2f &size, float cornerRadius, const FakeVec4f &color, float thickness = 0.0f);
+
+		/**
+		 *
+		 * Draws UTF-8 text with a signed distance field font. The layout of a string is cached, drawing the same string
+		 * again in the next frames only writes its vertices. All text of one font is drawn with one draw call.
+		 *
+		 * @param text The UTF-8 encoded text, line breaks start a new line.
+		 * @param font The font.
+		 * @param transform Places the text, one unit is one em. The origin is on the baseline of the first line.
+		 * @param color The color of the text.
+		 */
+		static void DrawString(const FakeString &text, const FakeRef<FakeFont> &font, const FakeMat4f &transform, const FakeVec4f &color = FakeVec4f(1.0f, 1.0f, 1.0f, 1.0f));
+
+		/**
+		 *
+		 * Draws text which has been laid out with FakeFont::Layout(), for text which changes every frame.
+		 *
+		 * @param layout The layout, it has to be made with the same font.
+		 * @param font The font.
+		 * @param transform Places the text, one unit is one em.
+		 * @param color The color of the text.
+		 */
+		static void DrawString(const FakeTextLayout &layout, const FakeRef<FakeFont> &font, const FakeMat4f &transform, const FakeVec4f &color = FakeVec4f(1.0f, 1.0f, 1.0f, 1.0f));
 	};
@@ -0,0 +1,251 @@
+#include "FakePch.h"
+#include "FakeRendererAPI.h"
+
+#include "Engine/Platform/Null/FakeNullRendererAPI.h"
+#include "Engine/Platform/OpenGL/FakeOpenGLRendererAPI.h"
+
+#ifdef FAKE_RENDERER_VULKAN
+#include "Engine/Platform/Vulkan/FakeVulkanRendererAPI.h"
+#endif
+
+FakeRendererAPIType FakeRendererAPI::CurrentRendererAPI = FakeRendererAPIType::OpenGL;
+
+void FakeRendererAPI::Init()
+	{
+	if (IsHeadless())
+		return FakeNullRendererAPI::Init();
+
+	#ifdef FAKE_RENDERER_VULKAN
+		if (Current() == FakeRendererAPIType::Vulkan)
+			return FakeVulkanRendererAPI::Init();
+	#endif
+
+	#ifdef FAKE_RENDERER_OPENGL
+		FakeOpenGLRendererAPI::Init();
+	#endif
+	}
+
+void FakeRendererAPI::Shutdown()
+	{
+	if (IsHeadless())
+		return FakeNullRendererAPI::Shutdown();
+
+	#ifdef FAKE_RENDERER_VULKAN
+		if (Current() == FakeRendererAPIType::Vulkan)
+			return FakeVulkanRendererAPI::Shutdown();
+	#endif
+
+	#ifdef FAKE_RENDERER_OPENGL
+		FakeOpenGLRendererAPI::Shutdown();
+	#endif
+	}
+
+void FakeRendererAPI::Clear()
+	{
+	if (IsHeadless())
+		return FakeNullRendererAPI::Clear();
+
+	#ifdef FAKE_RENDERER_VULKAN
+		if (Current() == FakeRendererAPIType::Vulkan)
+			return FakeVulkanRendererAPI::Clear();
+	#endif
+
+	#ifdef FAKE_RENDERER_OPENGL
+		FakeOpenGLRendererAPI::Clear();
+	#endif
+	}
+
+void FakeRendererAPI::SetClearColor(float r, float g, float b, float a)
+	{
+	SetClearColor(FakeVec4f(r, g, b, a));
+	}
+
+void FakeRendererAPI::SetClearColor(const FakeVec4f &color)
+	{
+	if (IsHeadless())
+		return FakeNullRendererAPI::SetClearColor(color);
+
+	#ifdef FAKE_RENDERER_VULKAN
+		if (Current() == FakeRendererAPIType::Vulkan)
+			return FakeVulkanRendererAPI::SetClearColor(color);
+	#endif
+
+	#ifdef FAKE_RENDERER_OPENGL
+		FakeOpenGLRendererAPI::SetClearColor(color);
+	#endif
+	}
+
+void FakeRendererAPI::DrawIndexed(uint32 count, FakePrimitiveType type, bool depthTest, FakeIndexFormat format, uint32 baseVertex)
+	{
+	if (IsHeadless())
+		return FakeNullRendererAPI::DrawIndexed(count, type, depthTest, format, baseVertex);
+
+	#ifdef FAKE_RENDERER_VULKAN
+		if (Current() == FakeRendererAPIType::Vulkan)
+			return FakeVulkanRendererAPI::DrawIndexed(count, type, depthTest, format, baseVertex);
+	#endif
+
+	#ifdef FAKE_RENDERER_OPENGL
+		FakeOpenGLRendererAPI::DrawIndexed(count, type, depthTest, format, baseVertex);
+	#endif
+	}
+
+void FakeRendererAPI::DrawIndexedInstanced(uint32 count, uint32 instanceCount, uint32 firstIndex, uint32 baseInstance, FakePrimitiveType type, bool depthTest, FakeIndexFormat format)
+	{
+	if (IsHeadless())
+		return FakeNullRendererAPI::DrawIndexedInstanced(count, instanceCount, firstIndex, baseInstance, type, depthTest, format);
+
+	#ifdef FAKE_RENDERER_VULKAN
+		if (Current() == FakeRendererAPIType::Vulkan)
+			return FakeVulkanRendererAPI::DrawIndexedInstanced(count, instanceCount, firstIndex, baseInstance, type, depthTest, format);
+	#endif
+
+	#ifdef FAKE_RENDERER_OPENGL
+		FakeOpenGLRendererAPI::DrawIndexedInstanced(count, instanceCount, firstIndex, baseInstance, type, depthTest, format);
+	#endif
+	}
+
+void FakeRendererAPI::DrawIndexedIndirect(uint32 commandOffset, uint32 countOffset, uint32 maxDrawCount, FakePrimitiveType type, bool depthTest, FakeIndexFormat format)
+	{
+	if (IsHeadless())
+		return FakeNullRendererAPI::DrawIndexedIndirect(commandOffset, countOffset, maxDrawCount, type, depthTest, format);
+
+	#ifdef FAKE_RENDERER_VULKAN
+		if (Current() == FakeRendererAPIType::Vulkan)
+			return FakeVulkanRendererAPI::DrawIndexedIndirect(commandOffset, countOffset, maxDrawCount, type, depthTest, format);
+	#endif
+
+	#ifdef FAKE_RENDERER_OPENGL
+		FakeOpenGLRendererAPI::DrawIndexedIndirect(commandOffset, countOffset, maxDrawCount, type, depthTest, format);
+	#endif
+	}
+
+void FakeRendererAPI::DispatchCompute(uint32 groupsX, uint32 groupsY, uint32 groupsZ)
+	{
+	if (IsHeadless())
+		return FakeNullRendererAPI::DispatchCompute(groupsX, groupsY, groupsZ);
+
+	#ifdef FAKE_RENDERER_VULKAN
+		if (Current() == FakeRendererAPIType::Vulkan)
+			return FakeVulkanRendererAPI::DispatchCompute(groupsX, groupsY, groupsZ);
+	#endif
+
+	#ifdef FAKE_RENDERER_OPENGL
+		FakeOpenGLRendererAPI::DispatchCompute(groupsX, groupsY, groupsZ);
+	#endif
+	}
+
+void FakeRendererAPI::StorageBarrier()
+	{
+	if (IsHeadless())
+		return FakeNullRendererAPI::StorageBarrier();
+
+	#ifdef FAKE_RENDERER_VULKAN
+		if (Current() == FakeRendererAPIType::Vulkan)
+			return FakeVulkanRendererAPI::StorageBarrier();
+	#endif
+
+	#ifdef FAKE_RENDERER_OPENGL
+		FakeOpenGLRendererAPI::StorageBarrier();
+	#endif
+	}
+
+void FakeRendererAPI::SetViewport(uint32 width, uint32 height)
+	{
+	if (IsHeadless())
+		return FakeNullRendererAPI::SetViewport(width, height);
+
+	#ifdef FAKE_RENDERER_VULKAN
+		if (Current() == FakeRendererAPIType::Vulkan)
+			return FakeVulkanRendererAPI::SetViewport(width, height);
+	#endif
+
+	#ifdef FAKE_RENDERER_OPENGL
+		FakeOpenGLRendererAPI::SetViewport(width, height);
+	#endif
+	}
+
+void FakeRendererAPI::SetLineThickness(float thickness)
+	{
+	if (IsHeadless())
+		return FakeNullRendererAPI::SetLineThickness(thickness);
+
+	#ifdef FAKE_RENDERER_VULKAN
+		if (Current() == FakeRendererAPIType::Vulkan)
+			return FakeVulkanRendererAPI::SetLineThickness(thickness);
+	#endif
+
+	#ifdef FAKE_RENDERER_OPENGL
+		FakeOpenGLRendererAPI::SetLineThickness(thickness);
+	#endif
+	}
+
+void FakeRendererAPI::SetBlend(bool enabled)
+	{
+	if (IsHeadless())
+		return FakeNullRendererAPI::SetBlend(enabled);
+
+	#ifdef FAKE_RENDERER_VULKAN
+		if (Current() == FakeRendererAPIType::Vulkan)
+			return FakeVulkanRendererAPI::SetBlend(enabled);
+	#endif
+
+	#ifdef FAKE_RENDERER_OPENGL
+		FakeOpenGLRendererAPI::SetBlend(enabled);
+	#endif
+	}
+
+void FakeRendererAPI::ResetStats()
+	{
+	// The headless backends drop no state changes, there is nothing to count
+	if (IsHeadless())
+		return;
+
+	#ifdef FAKE_RENDERER_VULKAN
+		if (Current() == FakeRendererAPIType::Vulkan)
+			return FakeVulkanRendererAPI::ResetStats();
+	#endif
+
+	#ifdef FAKE_RENDERER_OPENGL
+		FakeOpenGLRendererAPI::ResetStats();
+	#endif
+	}
+
+FakeRenderAPIStatistics FakeRendererAPI::GetStats()
+	{
+	#ifdef FAKE_RENDERER_VULKAN
+		if (Current() == FakeRendererAPIType::Vulkan)
+			return FakeVulkanRendererAPI::GetStats();
+	#endif
+
+	#ifdef FAKE_RENDERER_OPENGL
+		if (!IsHeadless())
+			return FakeOpenGLRendererAPI::GetStats();
+	#endif
+
+	return FakeRenderAPIStatistics();
+	}
+
+void FakeRendererAPI::ResolveReadbacks()
+	{
+	if (IsHeadless())
+		return FakeNullRendererAPI::ResolveReadbacks();
+
+	#ifdef FAKE_RENDERER_VULKAN
+		if (Current() == FakeRendererAPIType::Vulkan)
+			return FakeVulkanRendererAPI::ResolveReadbacks();
+	#endif
+
+	#ifdef FAKE_RENDERER_OPENGL
+		FakeOpenGLRendererAPI::ResolveReadbacks();
+	#endif
+	}
+
+void FakeRendererAPI::SubmitFrame()
+	{
+	// OpenGL and the headless backends execute every command right away
+	#ifdef FAKE_RENDERER_VULKAN
+		if (Current() == FakeRendererAPIType::Vulkan)
+			FakeVulkanRendererAPI::SubmitFrame();
+	#endif
+	}
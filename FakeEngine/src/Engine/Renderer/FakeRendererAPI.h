@@ -34,6 +34,10 @@ enum class FakeRendererAPIType
 	Vulkan,
 	Metal,
 
+	// Headless backends, resources only keep what the CPU side needs and nothing reaches a GPU
+	Null,
+	Recording,
+
 	None = OpenGL,
 	};
 
@@ -44,6 +48,12 @@ enum class FakePrimitiveType
 	Lines
 	};
 
+enum class FakeIndexFormat
+	{
+	UInt32 = 0,
+	UInt16
+	};
+
 /**
  * 
  * .
@@ -58,6 +68,34 @@ struct FakeRenderAPICapabilities
 	int32 MaxSamples = 0;
 	int32 MaxTextureUnits = 0;
 	float MaxAnisotropy = 0.0f;
+
+	// Compute shaders and shader storage buffers, OpenGL 4.3
+	bool ComputeShaders = false;
+	};
+
+/**
+ *
+ * The layout of one draw of an indirect buffer, as the GPU reads it, see FakeRendererAPI::DrawIndexedIndirect().
+ *
+ */
+struct FakeDrawIndexedIndirectCommand
+	{
+	uint32 Count = 0;
+	uint32 InstanceCount = 0;
+	uint32 FirstIndex = 0;
+	int32 BaseVertex = 0;
+	uint32 BaseInstance = 0;
+	};
+
+/**
+ *
+ * Counts the state changes the backend has passed on to the driver and the ones it dropped because nothing would change.
+ *
+ */
+struct FakeRenderAPIStatistics
+	{
+	uint32 StateChanges = 0;
+	uint32 SkippedStateChanges = 0;
 	};
 
 /**
@@ -119,8 +157,56 @@ class FakeRendererAPI
 		 * @param count
 		 * @param type
 		 * @param depthTest
+		 * @param format
+		 * @param baseVertex The value added to every index, for vertices written somewhere inside a stream buffer.
 		 */
-		static void DrawIndexed(uint32 count, FakePrimitiveType type, bool depthTest = true);
+		static void DrawIndexed(uint32 count, FakePrimitiveType type, bool depthTest = true, FakeIndexFormat format = FakeIndexFormat::UInt32, uint32 baseVertex = 0);
+
+		/**
+		 *
+		 * Draws instanceCount instances of a range of the bound index buffer.
+		 * Per-instance attributes start at baseInstance, so many batches can share one instance buffer.
+		 *
+		 * @param count The amount of indices per instance.
+		 * @param instanceCount The amount of instances.
+		 * @param firstIndex The first index to read from the bound index buffer.
+		 * @param baseInstance The first element read from the per-instance attributes.
+		 * @param type The primitive type.
+		 * @param depthTest Whether the depth test is enabled for this draw.
+		 * @param format The element type of the bound index buffer.
+		 */
+		static void DrawIndexedInstanced(uint32 count, uint32 instanceCount, uint32 firstIndex, uint32 baseInstance, FakePrimitiveType type, bool depthTest = true, FakeIndexFormat format = FakeIndexFormat::UInt32);
+
+		/**
+		 *
+		 * Issues the draws of the bound indirect buffer, see FakeStorageBuffer::BindIndirect(). The GPU reads the amount of draws
+		 * from the same buffer, so a compute shader can decide what is drawn without the CPU waiting for it.
+		 *
+		 * @param commandOffset The offset in bytes of the first FakeDrawIndexedIndirectCommand.
+		 * @param countOffset The offset in bytes of the uint32 which holds the amount of draws.
+		 * @param maxDrawCount The amount of draws is clamped to this, it is the amount of commands reserved at commandOffset.
+		 * @param type The primitive type.
+		 * @param depthTest Whether the depth test is enabled for these draws.
+		 * @param format The element type of the bound index buffer.
+		 */
+		static void DrawIndexedIndirect(uint32 commandOffset, uint32 countOffset, uint32 maxDrawCount, FakePrimitiveType type, bool depthTest = true, FakeIndexFormat format = FakeIndexFormat::UInt32);
+
+		/**
+		 *
+		 * Runs the bound compute shader.
+		 *
+		 * @param groupsX The amount of work groups along x.
+		 * @param groupsY The amount of work groups along y.
+		 * @param groupsZ The amount of work groups along z.
+		 */
+		static void DispatchCompute(uint32 groupsX, uint32 groupsY = 1, uint32 groupsZ = 1);
+
+		/**
+		 *
+		 * Makes the storage buffer writes of earlier dispatches visible to later dispatches, vertex fetches and indirect draws.
+		 *
+		 */
+		static void StorageBarrier();
 
 		/**
 		 * 
@@ -139,6 +225,44 @@ class FakeRendererAPI
 		 */
 		static void SetLineThickness(float thickness);
 
+		/**
+		 *
+		 * Enables or disables alpha blending, it is enabled by default.
+		 *
+		 * @param enabled Whether blending should be enabled.
+		 */
+		static void SetBlend(bool enabled);
+
+		/**
+		 *
+		 * Resets the state change counters, FakeRenderer::Render() does this before it executes the commands of a frame.
+		 *
+		 */
+		static void ResetStats();
+
+		/**
+		 *
+		 * Returns the state change counters of the commands which have been executed since the last ResetStats().
+		 *
+		 * @return Returns the state change counters.
+		 */
+		static FakeRenderAPIStatistics GetStats();
+
+		/**
+		 *
+		 * Calls the callbacks of the framebuffer readbacks the GPU has finished, FakeRenderer::Render() does this after every frame.
+		 *
+		 */
+		static void ResolveReadbacks();
+
+		/**
+		 *
+		 * Hands the commands recorded since the last call to the GPU, FakeRenderer::Render() does this after every frame.
+		 * Only backends which record command buffers do anything here.
+		 *
+		 */
+		static void SubmitFrame();
+
 		/**
 		 * 
 		 * .
@@ -172,4 +296,15 @@ class FakeRendererAPI
 			{
 			return CurrentRendererAPI;
 			}
+
+		/**
+		 *
+		 * Returns whether the current backend renders without a GPU, the factories create null objects then.
+		 *
+		 * @return Returns true for the null and the recording backend.
+		 */
+		static bool IsHeadless()
+			{
+			return CurrentRendererAPI == FakeRendererAPIType::Null || CurrentRendererAPI == FakeRendererAPIType::Recording;
+			}
 	};
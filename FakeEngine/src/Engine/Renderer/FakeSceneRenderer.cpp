@@ -1,3 +1,270 @@
 #include "FakePch.h"
 #include "FakeSceneRenderer.h"
 
+#include "Engine/Core/DataTypes/FakeRadixSort.h"
+
+#include "FakeRenderer.h"
+#include "FakePipeline.h"
+
+namespace Utils
+	{
+	// The bits of a positive float sort like the float, the 18 bits below the sign keep the exponent and 10 bits of mantissa
+	static uint64 fake_depth_key(float distanceSquared)
+		{
+		uint32 bits;
+		memcpy(&bits, &distanceSquared, sizeof(uint32));
+		return (bits >> 13) & 0x3FFFF;
+		}
+	}
+
+// Ranks are handed out in submission order and only decide the order of the draw list, so overflowing the key bits is harmless
+struct FakeSceneRendererRanks
+	{
+	std::unordered_map<const void*, uint32> Ranks;
+	const void *Last = nullptr;
+	uint32 LastRank = 0;
+
+	uint32 Get(const void *object)
+		{
+		if (object != Last)
+			{
+			LastRank = Ranks.emplace(object, (uint32)Ranks.size()).first->second;
+			Last = object;
+			}
+
+		return LastRank;
+		}
+
+	void Reset()
+		{
+		Ranks.clear();
+		Last = nullptr;
+		}
+	};
+
+struct FakeSceneDrawCommand
+	{
+	const FakeMesh *Mesh;
+	const FakeMaterial *Material;
+	uint32 Submesh;
+	};
+
+struct FakeSceneRendererData
+	{
+	// Instances per region of the instance buffer, larger draw lists are drawn in several chunks
+	static const uint32 MaxInstances = 65536;
+
+	FakeRef<FakeVertexBuffer> InstanceBuffer;
+	FakeRef<FakePipeline> Pipeline;
+
+	FakeMat4f ViewProjection;
+	FakeVec3f CameraPosition;
+
+	std::vector<FakeSceneDrawCommand> Commands;
+	std::vector<FakeMat4f> Transforms;
+	std::vector<FakeSortItem> Order;
+	std::vector<FakeSortItem> OrderScratch;
+
+	FakeSceneRendererRanks ShaderRanks;
+	FakeSceneRendererRanks MaterialRanks;
+	FakeSceneRendererRanks MeshRanks;
+
+	// The state of the last draw, shaders are only bound when they change
+	const FakeShader *CurrentShader = nullptr;
+	const FakeMaterial *CurrentMaterial = nullptr;
+	const FakeMesh *CurrentMesh = nullptr;
+
+	// The shader commands only capture a pointer, so the shaders are kept alive until the commands have been executed
+	std::vector<FakeRef<FakeShader>> UsedShaders;
+
+	FakeSceneRenderer::Statistics Stats;
+	};
+
+static FakeSceneRendererData *Data;
+
+void FakeSceneRenderer::Init()
+	{
+	Data = new FakeSceneRendererData;
+	Data->InstanceBuffer = FakeVertexBuffer::Create(FakeSceneRendererData::MaxInstances * sizeof(FakeMat4f), FakeVertexBufferUsage::Stream);
+
+	FakePipelineSpecification spec;
+	spec.Layout = FakeMesh::GetVertexLayout();
+	spec.InstanceBuffer = Data->InstanceBuffer;
+	spec.InstanceLayout = {
+		{ FakeShaderDataType::Mat4, "a_Transform" }
+	};
+
+	Data->Pipeline = FakePipeline::Create(spec);
+	}
+
+void FakeSceneRenderer::Shutdown()
+	{
+	delete Data;
+	}
+
+void FakeSceneRenderer::BeginScene(const FakeMat4f &viewProjection, const FakeVec3f &cameraPosition)
+	{
+	Data->ViewProjection = viewProjection;
+	Data->CameraPosition = cameraPosition;
+
+	Data->Commands.clear();
+	Data->Transforms.clear();
+	Data->Order.clear();
+	Data->ShaderRanks.Reset();
+	Data->MaterialRanks.Reset();
+	Data->MeshRanks.Reset();
+
+	// The commands of the last frame have been executed by now
+	Data->UsedShaders.clear();
+	}
+
+void FakeSceneRenderer::SubmitMesh(const FakeRef<FakeMesh> &mesh, const FakeRef<FakeMaterial> &material, const FakeMat4f &transform)
+	{
+	uint32 submeshCount = (uint32)mesh->GetSubmeshes().size();
+	for (uint32 i = 0; i < submeshCount; ++i)
+		SubmitSubmesh(mesh, i, material, transform);
+	}
+
+void FakeSceneRenderer::SubmitSubmesh(const FakeRef<FakeMesh> &mesh, uint32 submeshIndex, const FakeRef<FakeMaterial> &material, const FakeMat4f &transform)
+	{
+	FAKE_ASSERT(submeshIndex < mesh->GetSubmeshes().size(), "Submesh index out of range!");
+
+	FakeVec3f offset = FakeVec3f(transform.M41, transform.M42, transform.M43) - Data->CameraPosition;
+	uint64 depth = Utils::fake_depth_key(FakeVec3f::Dot(offset, offset));
+
+	// Shader 12 bits, material 16 bits, mesh 12 bits and submesh 4 bits
+	uint64 shader = Data->ShaderRanks.Get(material->GetShader().Raw()) & 0xFFF;
+	uint64 materialRank = Data->MaterialRanks.Get(material.Raw()) & 0xFFFF;
+	uint64 meshRank = ((uint64)(Data->MeshRanks.Get(mesh.Raw()) & 0xFFF) << 4) | (submeshIndex & 0xF);
+	uint64 state = (shader << 32) | (materialRank << 16) | meshRank;
+
+	// Opaque:      pass | state | depth
+	// Transparent: pass | inverted depth | state
+	uint64 key;
+	if (material->HasFlag(FakeMaterialFlags::Blend))
+		key = (1ull << 62) | ((~depth & 0x3FFFF) << 44) | state;
+	else
+		key = (state << 18) | depth;
+
+	FakeSortItem item;
+	item.Key = key;
+	item.Value = (uint32)Data->Commands.size();
+	Data->Order.push_back(item);
+
+	Data->Commands.push_back({ mesh.Raw(), material.Raw(), submeshIndex });
+	Data->Transforms.push_back(transform);
+	}
+
+void FakeSceneRenderer::DrawRun(uint32 command, uint32 firstInstance, uint32 instanceCount)
+	{
+	const FakeSceneDrawCommand &draw = Data->Commands[command];
+
+	if (draw.Material != Data->CurrentMaterial)
+		{
+		draw.Material->Bind();
+		Data->CurrentMaterial = draw.Material;
+		Data->Stats.MaterialChanges++;
+
+		// Renderer uniforms are not part of the material blocks, so they survive material binds
+		const FakeRef<FakeShader> &shader = draw.Material->GetShader();
+		if (shader.Raw() != Data->CurrentShader)
+			{
+			FakeRef<FakeShader> usedShader = shader;
+			usedShader->SetUniform("r_ViewProjection", Data->ViewProjection);
+			Data->UsedShaders.push_back(usedShader);
+
+			Data->CurrentShader = shader.Raw();
+			Data->Stats.ShaderChanges++;
+			}
+		}
+
+	const FakeMesh *mesh = draw.Mesh;
+	if (mesh != Data->CurrentMesh)
+		{
+		mesh->GetVertexBuffer()->Bind();
+		Data->Pipeline->Bind();
+		mesh->GetIndexBuffer()->Bind();
+		Data->CurrentMesh = mesh;
+		Data->Stats.MeshChanges++;
+		}
+
+	const FakeSubmesh &submesh = mesh->GetSubmeshes()[draw.Submesh];
+	uint32 indexCount = submesh.IndexCount;
+	uint32 firstIndex = submesh.BaseIndex;
+	FakeIndexFormat format = mesh->GetIndexFormat();
+	bool depthTest = draw.Material->HasFlag(FakeMaterialFlags::DepthTest);
+
+	FakeRenderer::Submit([=]()
+		{
+		FakeRendererAPI::DrawIndexedInstanced(indexCount, instanceCount, firstIndex, firstInstance, FakePrimitiveType::Triangles, depthTest, format);
+		});
+
+	Data->Stats.DrawCalls++;
+	Data->Stats.InstanceCount += instanceCount;
+	}
+
+void FakeSceneRenderer::EndScene()
+	{
+	uint32 count = (uint32)Data->Commands.size();
+	if (!count)
+		return;
+
+	Data->OrderScratch.resize(count);
+	fake_radix_sort(Data->Order.data(), Data->OrderScratch.data(), count);
+
+	Data->CurrentShader = nullptr;
+	Data->CurrentMaterial = nullptr;
+	Data->CurrentMesh = nullptr;
+	FakeMaterial::ResetBindState();
+
+	const FakeSortItem *order = Data->Order.data();
+	const FakeSceneDrawCommand *commands = Data->Commands.data();
+
+	for (uint32 first = 0; first < count; first += FakeSceneRendererData::MaxInstances)
+		{
+		uint32 chunkSize = count - first;
+		if (chunkSize > FakeSceneRendererData::MaxInstances)
+			chunkSize = FakeSceneRendererData::MaxInstances;
+
+		// The transforms go straight into the mapped instance buffer in draw order
+		FakeMat4f *instances = (FakeMat4f*)Data->InstanceBuffer->Map(chunkSize * sizeof(FakeMat4f), sizeof(FakeMat4f));
+		for (uint32 i = 0; i < chunkSize; ++i)
+			instances[i] = Data->Transforms[order[first + i].Value];
+
+		Data->InstanceBuffer->Unmap(chunkSize * sizeof(FakeMat4f));
+		uint32 baseInstance = Data->InstanceBuffer->GetStreamOffset() / sizeof(FakeMat4f);
+
+		// Neighbours with the same mesh, submesh and material are drawn together
+		uint32 runStart = 0;
+		while (runStart < chunkSize)
+			{
+			const FakeSceneDrawCommand &head = commands[order[first + runStart].Value];
+
+			uint32 runEnd = runStart + 1;
+			while (runEnd < chunkSize)
+				{
+				const FakeSceneDrawCommand &next = commands[order[first + runEnd].Value];
+				if (next.Mesh != head.Mesh || next.Material != head.Material || next.Submesh != head.Submesh)
+					break;
+
+				++runEnd;
+				}
+
+			DrawRun(order[first + runStart].Value, baseInstance + runStart, runEnd - runStart);
+			runStart = runEnd;
+			}
+		}
+
+	// Leave the default state behind for whatever is drawn next
+	FakeMaterial::ResetBindState();
+	}
+
+void FakeSceneRenderer::ResetStats()
+	{
+	memset(&Data->Stats, 0, sizeof(Statistics));
+	}
+
+FakeSceneRenderer::Statistics FakeSceneRenderer::GetStats()
+	{
+	return Data->Stats;
+	}
@@ -22,18 +22,83 @@
 
 #pragma once
 
+#include "Engine/Core/Maths/FakeMaths.h"
+#include "Engine/Renderer/FakeMesh.h"
+#include "Engine/Renderer/FakeMaterial.h"
+
 /**
  * 
- * .
+ * Renders meshes with instancing. Submissions are collected into a draw list which is sorted by
+ * pass, shader, material, mesh and depth in EndScene(). Runs of the same mesh and material become one instanced draw.
+ * 
+ * Opaque materials are sorted front to back, materials with FakeMaterialFlags::Blend are drawn afterwards from back to front.
  * 
  */
 class FAKE_API FakeSceneRenderer
 	{
 	private:
 
-
+		static void DrawRun(uint32 command, uint32 firstInstance, uint32 instanceCount);
 
 	public:
 
+		struct Statistics
+			{
+			uint32 DrawCalls = 0;
+			uint32 InstanceCount = 0;
+			uint32 ShaderChanges = 0;
+			uint32 MaterialChanges = 0;
+			uint32 MeshChanges = 0;
+
+			uint32 GetStateChanges()
+				{
+				return ShaderChanges + MaterialChanges + MeshChanges;
+				}
+			};
+
+		static void Init();
+		static void Shutdown();
 
+		/**
+		 *
+		 * Starts a new draw list.
+		 *
+		 * @param viewProjection The camera matrix, uploaded as the renderer uniform r_ViewProjection to every shader.
+		 * @param cameraPosition The position the submissions are sorted by distance to.
+		 */
+		static void BeginScene(const FakeMat4f &viewProjection, const FakeVec3f &cameraPosition);
+
+		/**
+		 *
+		 * Sorts the draw list and submits the instanced draws.
+		 *
+		 */
+		static void EndScene();
+
+		/**
+		 *
+		 * Adds every submesh of a mesh to the draw list.
+		 * The mesh and the material have to stay alive until EndScene() returns.
+		 *
+		 * @param mesh The mesh to draw.
+		 * @param material The material every submesh is drawn with.
+		 * @param transform The world transform, it is passed to the shader as the per-instance attribute a_Transform.
+		 */
+		static void SubmitMesh(const FakeRef<FakeMesh> &mesh, const FakeRef<FakeMaterial> &material, const FakeMat4f &transform);
+
+		/**
+		 *
+		 * Adds one submesh of a mesh to the draw list.
+		 * The mesh and the material have to stay alive until EndScene() returns.
+		 *
+		 * @param mesh The mesh to draw.
+		 * @param submeshIndex The index into FakeMesh::GetSubmeshes().
+		 * @param material The material the submesh is drawn with.
+		 * @param transform The world transform, it is passed to the shader as the per-instance attribute a_Transform.
+		 */
+		static void SubmitSubmesh(const FakeRef<FakeMesh> &mesh, uint32 submeshIndex, const FakeRef<FakeMaterial> &material, const FakeMat4f &transform);
+
+		static void ResetStats();
+		static Statistics GetStats();
 	};
+
@@ -1,17 +1,54 @@
 #include "FakePch.h"
 #include "FakeShader.h"
 
+#include "FakeRendererAPI.h"
+#include "Engine/Platform/Null/FakeNullShader.h"
 #include "Engine/Platform/OpenGL/FakeOpenGLShader.h"
 
+#ifdef FAKE_RENDERER_VULKAN
+#include "Engine/Platform/Vulkan/FakeVulkanShader.h"
+#endif
+
 FakeRef<FakeShader> FakeShader::Create(const FakeString &filePath)
 	{
+	if (FakeRendererAPI::IsHeadless())
+		return FakeRef<FakeNullShader>::Create(filePath, FakeShaderDefineList());
+
+	#ifdef FAKE_RENDERER_VULKAN
+		if (FakeRendererAPI::Current() == FakeRendererAPIType::Vulkan)
+			return FakeRef<FakeVulkanShader>::Create(filePath, FakeShaderDefineList());
+	#endif
+
 	#ifdef FAKE_RENDERER_OPENGL
 		return FakeRef<FakeOpenGLShader>::Create(filePath);
 	#endif
 	}
 
+FakeRef<FakeShader> FakeShader::Create(const FakeString &filePath, const FakeShaderDefineList &defines)
+	{
+	if (FakeRendererAPI::IsHeadless())
+		return FakeRef<FakeNullShader>::Create(filePath, defines);
+
+	#ifdef FAKE_RENDERER_VULKAN
+		if (FakeRendererAPI::Current() == FakeRendererAPIType::Vulkan)
+			return FakeRef<FakeVulkanShader>::Create(filePath, defines);
+	#endif
+
+	#ifdef FAKE_RENDERER_OPENGL
+		return FakeRef<FakeOpenGLShader>::Create(filePath, defines);
+	#endif
+	}
+
 FakeRef<FakeShader> FakeShader::Create(const FakeString &vertexShaderSource, const FakeString &fragmentShaderSource)
 	{
+	if (FakeRendererAPI::IsHeadless())
+		return FakeRef<FakeNullShader>::Create("Undefined", vertexShaderSource, fragmentShaderSource);
+
+	#ifdef FAKE_RENDERER_VULKAN
+		if (FakeRendererAPI::Current() == FakeRendererAPIType::Vulkan)
+			return FakeRef<FakeVulkanShader>::Create("Undefined", vertexShaderSource, fragmentShaderSource);
+	#endif
+
 	#ifdef FAKE_RENDERER_OPENGL
 		return FakeRef<FakeOpenGLShader>::Create(vertexShaderSource, fragmentShaderSource);
 	#endif
@@ -19,8 +56,30 @@ FakeRef<FakeShader> FakeShader::Create(const FakeString &vertexShaderSource, con
 
 FakeRef<FakeShader> FakeShader::Create(const FakeString &name, const FakeString &vertexShaderSource, const FakeString &fragmentShaderSource)
 	{
+	if (FakeRendererAPI::IsHeadless())
+		return FakeRef<FakeNullShader>::Create(name, vertexShaderSource, fragmentShaderSource);
+
+	#ifdef FAKE_RENDERER_VULKAN
+		if (FakeRendererAPI::Current() == FakeRendererAPIType::Vulkan)
+			return FakeRef<FakeVulkanShader>::Create(name, vertexShaderSource, fragmentShaderSource);
+	#endif
+
 	#ifdef FAKE_RENDERER_OPENGL
 		return FakeRef<FakeOpenGLShader>::Create(name, vertexShaderSource, fragmentShaderSource);
 	#endif
 	}
 
+FakeRef<FakeShader> FakeShader::CreateFromSource(const FakeString &name, const FakeString &source)
+	{
+	if (FakeRendererAPI::IsHeadless())
+		return FakeNullShader::CreateFromString(name, source);
+
+	#ifdef FAKE_RENDERER_VULKAN
+		if (FakeRendererAPI::Current() == FakeRendererAPIType::Vulkan)
+			return FakeVulkanShader::CreateFromString(name, source);
+	#endif
+
+	#ifdef FAKE_RENDERER_OPENGL
+		return FakeOpenGLShader::CreateFromString(name, source);
+	#endif
+	}
@@ -23,6 +23,7 @@
 #pragma once
 
 #include "FakeShaderUniform.h"
+#include "FakeShaderPreprocessor.h"
 #include "Engine/Core/FakeAllocator.h"
 #include "Engine/Core/Maths/FakeVector2.h"
 #include "Engine/Core/Maths/FakeVector3.h"
@@ -200,6 +201,15 @@ class FAKE_API FakeShader : public FakeRefCounted
 		 */
 		virtual void Reload() = 0;
 
+		/**
+		 *
+		 * Makes sure the shader has finished compiling before it is used.
+		 * Shaders which are loaded back to back compile in parallel if the driver supports it,
+		 * calling this once after loading a batch resolves all of them.
+		 *
+		 */
+		virtual void FinishCompilation() = 0;
+
 		/**
 		 *
 		 * Returns the current RendererID.
@@ -234,6 +244,19 @@ class FAKE_API FakeShader : public FakeRefCounted
 
 		virtual void SetVSMaterialUniformBuffer(FakeAllocator buffer) = 0;
 		virtual void SetFSMaterialUniformBuffer(FakeAllocator buffer) = 0;
+
+		/**
+		 *
+		 * Uploads the material uniforms of one stage which overlap a byte range of the packed block.
+		 * The shader has to be bound, and the buffer is read when the command executes.
+		 *
+		 * @param domain The stage the block belongs to.
+		 * @param buffer The packed block, laid out like the material uniform buffer of the stage.
+		 * @param begin The first byte which changed.
+		 * @param end One past the last byte which changed.
+		 */
+		virtual void SetMaterialUniformRange(FakeShaderDomain domain, FakeAllocator buffer, uint32 begin, uint32 end) const = 0;
+
 		virtual const FakeShaderUniformBufferList &GetVSRendererUniforms() const = 0;
 		virtual const FakeShaderUniformBufferList &GetFSRendererUniforms() const = 0;
 		virtual bool HasVSMaterialUniformBuffer() const = 0;
@@ -456,6 +479,16 @@ class FAKE_API FakeShader : public FakeRefCounted
 		 */
 		static FakeRef<FakeShader> Create(const FakeString &filePath);
 
+		/**
+		 *
+		 * Creates a new shader permutation from a file. The defines are injected into every stage.
+		 *
+		 * @param filePath The virtual path to the shader.
+		 * @param defines The defines of the permutation.
+		 * @return Returns a new shader instance.
+		 */
+		static FakeRef<FakeShader> Create(const FakeString &filePath, const FakeShaderDefineList &defines);
+
 		/**
 		 *
 		 * Creates a new shader instance. The shader is being created from strings.
@@ -476,5 +509,16 @@ class FAKE_API FakeShader : public FakeRefCounted
 		 * @return Returns a new shader instance.
 		 */
 		static FakeRef<FakeShader> Create(const FakeString &name, const FakeString &vertexShaderSource, const FakeString &fragmentShaderSource);
+
+		/**
+		 *
+		 * Creates a new shader instance from a combined source which contains #type blocks, as if it had been read from a file.
+		 * Use this if the source has already been loaded, e.g. asynchronously.
+		 *
+		 * @param name The name of the Shader.
+		 * @param source The combined shader source.
+		 * @return Returns a new shader instance.
+		 */
+		static FakeRef<FakeShader> CreateFromSource(const FakeString &name, const FakeString &source);
 	};
 
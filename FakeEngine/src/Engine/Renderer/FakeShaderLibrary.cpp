@@ -1,6 +1,12 @@
 #include "FakePch.h"
 #include "FakeShaderLibrary.h"
 
+#include "Engine/Core/FakeVirtualFileSystem.h"
+#include "Engine/Core/Jobs/FakeJobSystem.h"
+
+static const uint32 MaxVariantKeywords = 48;
+static const uint32 MinVariantTableSize = 64;
+
 FakeShaderLibrary::FakeShaderLibrary()
 	{
 	}
@@ -36,3 +42,216 @@ const FakeRef<FakeShader> &FakeShaderLibrary::Get(const FakeString &name) const
 	return Shaders.at(*name);
 	}
 
+void FakeShaderLibrary::FinishCompilation()
+	{
+	for (auto &[name, shader] : Shaders)
+		shader->FinishCompilation();
+
+	for (uint32 i = 0; i < (uint32)VariantKeys.size(); ++i)
+		{
+		if (VariantKeys[i] != EmptyVariantKey && VariantShaders[i])
+			VariantShaders[i]->FinishCompilation();
+		}
+	}
+
+uint32 FakeShaderLibrary::LoadVariants(const FakeString &path)
+	{
+	return LoadVariants(FakeVirtualFileSystem::Get()->GetFileNameFromPath(path), path);
+	}
+
+uint32 FakeShaderLibrary::LoadVariants(const FakeString &name, const FakeString &path)
+	{
+	FAKE_ASSERT(VariantFamilyIndices.find(*name) == VariantFamilyIndices.end());
+
+	FakeShaderVariantFamily family;
+	family.Name = name;
+	family.Path = path;
+	family.Source = FakeVirtualFileSystem::Get()->ReadTextFile(path);
+	family.Keywords = FakeShaderPreprocessor::ParseKeywords(std::string_view(*family.Source, family.Source.Length()));
+
+	if (family.Source.IsEmpty())
+		FAKE_LOG_ERROR("Shader %s not found!", *path);
+
+	if (family.Keywords.size() > MaxVariantKeywords)
+		{
+		FAKE_LOG_ERROR("Shader %s declares %d keywords, only %d are supported!", *path, (uint32)family.Keywords.size(), MaxVariantKeywords);
+		family.Keywords.resize(MaxVariantKeywords);
+		}
+
+	uint32 index = (uint32)VariantFamilies.size();
+	FAKE_ASSERT(index < (1u << 16), "Too many shader variant families!");
+
+	VariantFamilies.push_back(family);
+	VariantFamilyIndices[*name] = index;
+	return index;
+	}
+
+uint32 FakeShaderLibrary::GetVariantFamily(const FakeString &name) const
+	{
+	FAKE_ASSERT(VariantFamilyIndices.find(*name) != VariantFamilyIndices.end());
+	return VariantFamilyIndices.at(*name);
+	}
+
+FakeShaderVariantKey FakeShaderLibrary::GetVariantKey(uint32 family, const std::vector<FakeString> &keywords) const
+	{
+	const std::vector<FakeString> &declared = VariantFamilies[family].Keywords;
+	FakeShaderVariantKey key = 0;
+
+	for (const FakeString &keyword : keywords)
+		{
+		auto it = std::find(declared.begin(), declared.end(), keyword);
+		if (it == declared.end())
+			{
+			FAKE_LOG_WARN("Shader %s has no keyword %s", *VariantFamilies[family].Name, *keyword);
+			continue;
+			}
+
+		key |= 1ull << (it - declared.begin());
+		}
+
+	return key;
+	}
+
+void FakeShaderLibrary::Prewarm(uint32 family, const std::vector<FakeShaderVariantKey> &keys)
+	{
+	FAKE_ASSERT(family < VariantFamilies.size(), "Unknown shader variant family!");
+
+	std::vector<FakeShaderVariantKey> missing;
+	for (FakeShaderVariantKey key : keys)
+		{
+		FAKE_ASSERT(key < (1ull << VariantFamilies[family].Keywords.size()), "Shader variant key uses undeclared keywords!");
+		uint64 fullKey = ((uint64)family << 48) | key;
+		bool exists = false;
+
+		if (VariantCount)
+			{
+			uint32 mask = (uint32)VariantKeys.size() - 1;
+			for (uint32 slot = GetVariantSlot(fullKey); VariantKeys[slot] != EmptyVariantKey && !exists; slot = (slot + 1) & mask)
+				exists = VariantKeys[slot] == fullKey;
+			}
+
+		if (!exists && std::find(missing.begin(), missing.end(), key) == missing.end())
+			missing.push_back(key);
+		}
+
+	// Preprocessing does not touch the renderer, so it can run on the workers
+	const FakeShaderVariantFamily &f = VariantFamilies[family];
+	std::vector<std::vector<FakeShaderStageSource>> stages(missing.size());
+	auto preprocess = [&](uint32 begin, uint32 end)
+		{
+		for (uint32 i = begin; i < end; ++i)
+			stages[i] = FakeShaderPreprocessor::Process(std::string_view(*f.Source, f.Source.Length()), f.Path, GetVariantDefines(family, missing[i]));
+		};
+
+	if (FakeJobSystem::IsInitialized())
+		FakeJobSystem::ParallelFor((uint32)missing.size(), 1, preprocess);
+	else
+		preprocess(0, (uint32)missing.size());
+
+	// All programs are submitted before any of them is resolved, so the driver can compile them in parallel
+	for (uint32 i = 0; i < (uint32)missing.size(); ++i)
+		{
+		FakeRef<FakeShader> shader = CreateVariant(family, missing[i], stages[i]);
+		if (shader)
+			InsertVariant(((uint64)family << 48) | missing[i], shader);
+		}
+	}
+
+FakeRef<FakeShader> FakeShaderLibrary::CompileVariant(uint32 family, FakeShaderVariantKey key)
+	{
+	const FakeShaderVariantFamily &f = VariantFamilies[family];
+	FAKE_ASSERT(key < (1ull << f.Keywords.size()), "Shader variant key uses undeclared keywords!");
+
+	std::vector<FakeShaderStageSource> stages = FakeShaderPreprocessor::Process(std::string_view(*f.Source, f.Source.Length()), f.Path, GetVariantDefines(family, key));
+	FakeRef<FakeShader> shader = CreateVariant(family, key, stages);
+	InsertVariant(((uint64)family << 48) | key, shader);
+	return shader;
+	}
+
+void FakeShaderLibrary::InsertVariant(uint64 key, const FakeRef<FakeShader> &shader)
+	{
+	// Keep the load factor at or below one half, so lookups almost always hit the first slot
+	if ((VariantCount + 1) * 2 > (uint32)VariantKeys.size())
+		{
+		std::vector<uint64> oldKeys = std::move(VariantKeys);
+		std::vector<FakeRef<FakeShader>> oldShaders = std::move(VariantShaders);
+
+		uint32 size = FAKE_MAX(MinVariantTableSize, (uint32)oldKeys.size() * 2);
+		VariantKeys.assign(size, EmptyVariantKey);
+		VariantShaders.clear();
+		VariantShaders.resize(size);
+
+		VariantShift = 64;
+		for (uint32 s = size; s > 1; s >>= 1)
+			--VariantShift;
+
+		VariantCount = 0;
+		for (uint32 i = 0; i < (uint32)oldKeys.size(); ++i)
+			{
+			if (oldKeys[i] != EmptyVariantKey)
+				InsertVariant(oldKeys[i], oldShaders[i]);
+			}
+		}
+
+	uint32 mask = (uint32)VariantKeys.size() - 1;
+	uint32 slot = GetVariantSlot(key);
+	while (VariantKeys[slot] != EmptyVariantKey && VariantKeys[slot] != key)
+		slot = (slot + 1) & mask;
+
+	if (VariantKeys[slot] == EmptyVariantKey)
+		++VariantCount;
+
+	VariantKeys[slot] = key;
+	VariantShaders[slot] = shader;
+	}
+
+FakeRef<FakeShader> FakeShaderLibrary::CreateVariant(uint32 family, FakeShaderVariantKey key, std::vector<FakeShaderStageSource> &stages)
+	{
+	const FakeShaderVariantFamily &f = VariantFamilies[family];
+
+	std::string name = *f.Name;
+	name += '[';
+	for (uint32 i = 0; i < (uint32)f.Keywords.size(); ++i)
+		{
+		if (key & (1ull << i))
+			{
+			if (name.back() != '[')
+				name += ',';
+			name += *f.Keywords[i];
+			}
+		}
+	name += ']';
+
+	const std::string *vertexSource = nullptr;
+	const std::string *fragmentSource = nullptr;
+	for (const FakeShaderStageSource &stage : stages)
+		{
+		if (stage.Stage == FakeShaderStage::Vertex)
+			vertexSource = &stage.Source;
+		else if (stage.Stage == FakeShaderStage::Fragment)
+			fragmentSource = &stage.Source;
+		}
+
+	if (!vertexSource || !fragmentSource)
+		{
+		FAKE_LOG_ERROR("Shader variant %s needs a vertex and a fragment stage!", name.c_str());
+		return nullptr;
+		}
+
+	FAKE_LOG_TRACE("Compiling shader variant %s", name.c_str());
+	return FakeShader::Create(name, *vertexSource, *fragmentSource);
+	}
+
+FakeShaderDefineList FakeShaderLibrary::GetVariantDefines(uint32 family, FakeShaderVariantKey key) const
+	{
+	const FakeShaderVariantFamily &f = VariantFamilies[family];
+
+	FakeShaderDefineList defines;
+	for (uint32 i = 0; i < (uint32)f.Keywords.size(); ++i)
+		{
+		if (key & (1ull << i))
+			defines.push_back({ f.Keywords[i], "1" });
+		}
+
+	return defines;
+	}
@@ -24,6 +24,26 @@
 
 #include "FakeShader.h"
 
+/**
+ *
+ * Bitmask of enabled keywords, bit i enables the i-th keyword declared in the shader file.
+ *
+ */
+typedef uint64 FakeShaderVariantKey;
+
+/**
+ *
+ * A shader file whose permutations are compiled on demand.
+ *
+ */
+struct FakeShaderVariantFamily
+	{
+	FakeString Name;
+	FakeString Path;
+	FakeString Source;
+	std::vector<FakeString> Keywords;
+	};
+
 /**
  * 
  * .
@@ -36,6 +56,28 @@ class FakeShaderLibrary : public FakeRefCounted
 		// we can't use FakeString here because the FakeString is currently missing a hash function implementation to use it as a key in std's libs.
 		std::unordered_map<std::string, FakeRef<FakeShader>> Shaders;
 
+		std::vector<FakeShaderVariantFamily> VariantFamilies;
+		std::unordered_map<std::string, uint32> VariantFamilyIndices;
+
+		// Open addressing table with linear probing, the key is (family << 48 | keyword mask)
+		std::vector<uint64> VariantKeys;
+		std::vector<FakeRef<FakeShader>> VariantShaders;
+		uint32 VariantCount = 0;
+		uint32 VariantShift = 64;
+
+		static constexpr uint64 EmptyVariantKey = ~0ull;
+
+		inline uint32 GetVariantSlot(uint64 key) const
+			{
+			// Fibonacci hashing spreads the mostly sequential keys over the whole table
+			return (uint32)((key * 0x9E3779B97F4A7C15ull) >> VariantShift);
+			}
+
+		FakeRef<FakeShader> CompileVariant(uint32 family, FakeShaderVariantKey key);
+		void InsertVariant(uint64 key, const FakeRef<FakeShader> &shader);
+		FakeRef<FakeShader> CreateVariant(uint32 family, FakeShaderVariantKey key, std::vector<FakeShaderStageSource> &stages);
+		FakeShaderDefineList GetVariantDefines(uint32 family, FakeShaderVariantKey key) const;
+
 	public:
 
 		/**
@@ -85,4 +127,96 @@ class FakeShaderLibrary : public FakeRefCounted
 		 * @return 
 		 */
 		const FakeRef<FakeShader> &Get(const FakeString &name) const;
+
+		/**
+		 * 
+		 * Resolves the compilation of all shaders in the library.
+		 * Load all shaders first and call this afterwards, so the driver can compile them in parallel.
+		 * 
+		 */
+		void FinishCompilation();
+
+		/**
+		 *
+		 * Registers a shader file with variant keywords, declared as `#keywords A B C` in the file.
+		 * Nothing is compiled until a variant is requested or prewarmed.
+		 *
+		 * @param path The virtual path to the shader.
+		 * @return Returns the index of the variant family.
+		 */
+		uint32 LoadVariants(const FakeString &path);
+
+		/**
+		 *
+		 * Registers a shader file with variant keywords under a custom name.
+		 *
+		 * @param name The name of the variant family.
+		 * @param path The virtual path to the shader.
+		 * @return Returns the index of the variant family.
+		 */
+		uint32 LoadVariants(const FakeString &name, const FakeString &path);
+
+		/**
+		 *
+		 * Returns the index of a variant family, look it up once and keep it.
+		 *
+		 * @param name The name of the variant family.
+		 * @return Returns the index of the variant family.
+		 */
+		uint32 GetVariantFamily(const FakeString &name) const;
+
+		/**
+		 *
+		 * Builds the key of a variant from keyword names, unknown keywords are ignored with a warning.
+		 *
+		 * @param family The index of the variant family.
+		 * @param keywords The enabled keywords.
+		 * @return Returns the key of the variant.
+		 */
+		FakeShaderVariantKey GetVariantKey(uint32 family, const std::vector<FakeString> &keywords) const;
+
+		/**
+		 *
+		 * Returns a variant and compiles it on first use.
+		 * The shader is returned by value, compiling a variant can grow the table and move the stored references.
+		 *
+		 * @param family The index of the variant family.
+		 * @param key The enabled keywords.
+		 * @return Returns the shader of the variant.
+		 */
+		inline FakeRef<FakeShader> GetVariant(uint32 family, FakeShaderVariantKey key)
+			{
+			FAKE_ASSERT(family < VariantFamilies.size(), "Unknown shader variant family!");
+			uint64 fullKey = ((uint64)family << 48) | key;
+
+			if (VariantCount)
+				{
+				uint32 mask = (uint32)VariantKeys.size() - 1;
+				for (uint32 slot = GetVariantSlot(fullKey); VariantKeys[slot] != EmptyVariantKey; slot = (slot + 1) & mask)
+					{
+					if (VariantKeys[slot] == fullKey)
+						return VariantShaders[slot];
+					}
+				}
+
+			return CompileVariant(family, key);
+			}
+
+		/**
+		 *
+		 * Compiles a list of variants up front. Preprocessing runs on the job system,
+		 * compilation overlaps in the driver if it supports parallel shader compilation.
+		 *
+		 * @param family The index of the variant family.
+		 * @param keys The variants to compile, variants which already exist are skipped.
+		 */
+		void Prewarm(uint32 family, const std::vector<FakeShaderVariantKey> &keys);
+
+		/**
+		 *
+		 * Returns the amount of compiled variants of all families.
+		 *
+		 * @return Returns the amount of compiled variants.
+		 */
+		inline uint32 GetVariantCount() const { return VariantCount; }
 	};
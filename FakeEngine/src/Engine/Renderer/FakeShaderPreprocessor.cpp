@@ -0,0 +1,278 @@
+#include "FakePch.h"
+#include "FakeShaderPreprocessor.h"
+
+#include "Engine/Core/FakeVirtualFileSystem.h"
+
+static const uint32 MaxIncludeDepth = 16;
+
+struct FakeShaderPreprocessorContext
+	{
+	std::vector<FakeShaderStageSource> Stages;
+	const FakeShaderDefineList *Defines = nullptr;
+
+	// Files which have already been inlined into the current stage
+	std::vector<std::string> Included;
+	bool DefinesInjected = false;
+	};
+
+namespace Utils
+	{
+	static bool fake_is_space(char c)
+		{
+		return c == ' ' || c == '\t' || c == '\r';
+		}
+
+	static std::string_view fake_trim(std::string_view str)
+		{
+		size_t begin = 0;
+		size_t end = str.size();
+
+		while (begin < end && fake_is_space(str[begin]))
+			++begin;
+
+		while (end > begin && fake_is_space(str[end - 1]))
+			--end;
+
+		return str.substr(begin, end - begin);
+		}
+
+	static std::string_view fake_next_line(std::string_view &source)
+		{
+		size_t eol = source.find('\n');
+		std::string_view line = source.substr(0, eol);
+		source.remove_prefix(eol == std::string_view::npos ? source.size() : eol + 1);
+		return line;
+		}
+
+	// Matches "#<directive>" followed by whitespace or the end of the line and returns the remaining arguments
+	static bool fake_match_directive(std::string_view line, std::string_view directive, std::string_view &outArgs)
+		{
+		if (line.empty() || line[0] != '#')
+			return false;
+
+		line = fake_trim(line.substr(1));
+		if (line.size() < directive.size() || line.compare(0, directive.size(), directive) != 0)
+			return false;
+
+		if (line.size() > directive.size() && !fake_is_space(line[directive.size()]))
+			return false;
+
+		outArgs = fake_trim(line.substr(directive.size()));
+		return true;
+		}
+
+	static std::string fake_resolve_include(std::string_view includePath, const FakeString &currentFile)
+		{
+		std::string path(includePath);
+		if (path.empty() || path[0] == '/' || currentFile.IsEmpty())
+			return path;
+
+		// Relative to the including file, if it exists there
+		std::string_view current(*currentFile, currentFile.Length());
+		size_t slash = current.find_last_of('/');
+		if (slash == std::string_view::npos)
+			return path;
+
+		std::string relative = std::string(current.substr(0, slash + 1)) + path;
+		if (FakeVirtualFileSystem::Get()->FileExists(relative))
+			return relative;
+
+		return path;
+		}
+
+	// The next line is reported as the given line of the given source string, 0 is the processed file and n its n-th include
+	static void fake_emit_line(FakeShaderPreprocessorContext &context, uint32 line, uint32 sourceIndex)
+		{
+		std::string &out = context.Stages.back().Source;
+		out += "#line ";
+		out += std::to_string(line);
+		out += ' ';
+		out += std::to_string(sourceIndex);
+		out += '\n';
+		}
+
+	static void fake_inject_defines(FakeShaderPreprocessorContext &context, uint32 nextLine, uint32 sourceIndex)
+		{
+		std::string &out = context.Stages.back().Source;
+		for (const FakeShaderDefine &define : *context.Defines)
+			{
+			out += "#define ";
+			out.append(*define.Name, define.Name.Length());
+			if (!define.Value.IsEmpty())
+				{
+				out += ' ';
+				out.append(*define.Value, define.Value.Length());
+				}
+			out += '\n';
+			}
+
+		// The #version line may not be the first line of the file, and the defines add lines of their own
+		fake_emit_line(context, nextLine, sourceIndex);
+		context.DefinesInjected = true;
+		}
+
+	// Removed directives leave an empty line behind, so the lines of the stage stay the lines of the file
+	static void fake_remove_line(FakeShaderPreprocessorContext &context)
+		{
+		if (!context.Stages.empty())
+			context.Stages.back().Source += '\n';
+		}
+
+	static void fake_process(FakeShaderPreprocessorContext &context, std::string_view source, const FakeString &filePath, uint32 sourceIndex, uint32 depth)
+		{
+		uint32 lineNumber = 0;
+		while (!source.empty())
+			{
+			std::string_view rawLine = fake_next_line(source);
+			std::string_view line = fake_trim(rawLine);
+			++lineNumber;
+
+			// Blank lines are kept, otherwise the compiler reports errors in the wrong lines
+			if (line.empty())
+				{
+				fake_remove_line(context);
+				continue;
+				}
+
+			std::string_view args;
+			if (line[0] == '#')
+				{
+				if (fake_match_directive(line, "type", args))
+					{
+					FakeShaderStage stage = FakeShaderPreprocessor::StageFromString(args);
+					FAKE_ASSERT(stage != FakeShaderStage::None, "Invalid Shader type specified!");
+
+					context.Stages.push_back({ stage, std::string() });
+					context.Stages.back().Source.reserve(source.size());
+					context.Included.clear();
+					context.DefinesInjected = false;
+					continue;
+					}
+
+				// Everything in front of the first #type is ignored
+				if (context.Stages.empty())
+					continue;
+
+				if (fake_match_directive(line, "include", args))
+					{
+					if (args.size() < 2 || !((args.front() == '"' && args.back() == '"') || (args.front() == '<' && args.back() == '>')))
+						{
+						FAKE_LOG_ERROR("Malformed #include in shader %s: %.*s", *filePath, (int32)line.size(), line.data());
+						fake_remove_line(context);
+						continue;
+						}
+
+					if (depth >= MaxIncludeDepth)
+						{
+						FAKE_LOG_ERROR("Shader include depth exceeded in %s", *filePath);
+						fake_remove_line(context);
+						continue;
+						}
+
+					std::string includePath = fake_resolve_include(args.substr(1, args.size() - 2), filePath);
+					if (std::find(context.Included.begin(), context.Included.end(), includePath) != context.Included.end())
+						{
+						fake_remove_line(context);
+						continue;
+						}
+
+					context.Included.push_back(includePath);
+
+					FakeString includeFile = includePath;
+					FakeString includeSource = FakeVirtualFileSystem::Get()->ReadTextFile(includeFile);
+					if (includeSource.IsEmpty())
+						{
+						FAKE_LOG_ERROR("Could not include shader file %s in %s", *includeFile, *filePath);
+						fake_remove_line(context);
+						continue;
+						}
+
+					fake_emit_line(context, 1, (uint32)context.Included.size());
+					fake_process(context, std::string_view(*includeSource, includeSource.Length()), includeFile, (uint32)context.Included.size(), depth + 1);
+					fake_emit_line(context, lineNumber + 1, sourceIndex);
+					continue;
+					}
+
+				// Variant keywords are only read by the shader library
+				if (fake_match_directive(line, "keywords", args))
+					{
+					fake_remove_line(context);
+					continue;
+					}
+
+				if (fake_match_directive(line, "version", args))
+					{
+					std::string &out = context.Stages.back().Source;
+					out.append(line.data(), line.size());
+					out += '\n';
+
+					if (!context.DefinesInjected)
+						fake_inject_defines(context, lineNumber + 1, sourceIndex);
+
+					continue;
+					}
+				}
+
+			if (context.Stages.empty())
+				continue;
+
+			// Shaders without a #version line get their defines in front of the first statement
+			if (!context.DefinesInjected)
+				fake_inject_defines(context, lineNumber, sourceIndex);
+
+			std::string &out = context.Stages.back().Source;
+			rawLine = rawLine.substr(0, rawLine.find_last_not_of('\r') + 1);
+			out.append(rawLine.data(), rawLine.size());
+			out += '\n';
+			}
+		}
+	}
+
+std::vector<FakeShaderStageSource> FakeShaderPreprocessor::Process(std::string_view source, const FakeString &filePath, const FakeShaderDefineList &defines)
+	{
+	FakeShaderPreprocessorContext context;
+	context.Defines = &defines;
+
+	Utils::fake_process(context, source, filePath, 0, 0);
+	return std::move(context.Stages);
+	}
+
+std::vector<FakeString> FakeShaderPreprocessor::ParseKeywords(std::string_view source)
+	{
+	std::vector<FakeString> keywords;
+
+	while (!source.empty())
+		{
+		std::string_view args;
+		std::string_view line = Utils::fake_trim(Utils::fake_next_line(source));
+		if (!Utils::fake_match_directive(line, "keywords", args))
+			continue;
+
+		while (!args.empty())
+			{
+			size_t end = 0;
+			while (end < args.size() && !Utils::fake_is_space(args[end]))
+				++end;
+
+			FakeString keyword = std::string(args.substr(0, end));
+			if (std::find(keywords.begin(), keywords.end(), keyword) == keywords.end())
+				keywords.push_back(keyword);
+
+			args = Utils::fake_trim(args.substr(end));
+			}
+		}
+
+	return keywords;
+	}
+
+FakeShaderStage FakeShaderPreprocessor::StageFromString(std::string_view type)
+	{
+	if (type == "vertex")
+		return FakeShaderStage::Vertex;
+	if (type == "fragment" || type == "pixel")
+		return FakeShaderStage::Fragment;
+	if (type == "compute")
+		return FakeShaderStage::Compute;
+
+	return FakeShaderStage::None;
+	}
@@ -0,0 +1,110 @@
+/*****************************************************************
+ * \file   FakeShaderPreprocessor.h
+ * \brief  
+ * 
+ * \author Can Karka
+ * \date   February 2021
+ * 
+ * Copyright (C) 2021 Can Karka
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *********************************************************************/
+
+#pragma once
+
+#include <string_view>
+
+#include "Engine/Core/FakeCore.h"
+#include "Engine/Core/DataTypes/FakeString.h"
+
+/**
+ *
+ * A single #define which is injected into every shader stage, used to build shader permutations.
+ *
+ */
+struct FakeShaderDefine
+	{
+	FakeString Name;
+	FakeString Value;
+	};
+
+typedef std::vector<FakeShaderDefine> FakeShaderDefineList;
+
+enum class FakeShaderStage : uint8
+	{
+	None = 0,
+	Vertex,
+	Fragment,
+	Compute
+	};
+
+/**
+ *
+ * The preprocessed source of one shader stage.
+ *
+ */
+struct FakeShaderStageSource
+	{
+	FakeShaderStage Stage = FakeShaderStage::None;
+	std::string Source;
+	};
+
+/**
+ *
+ * Splits a combined shader source into its stages in a single pass over the source.
+ *
+ * Supported directives:
+ * - `#type vertex|fragment|pixel|compute` starts a new stage.
+ * - `#include "path"` inlines another file through the virtual file system. Relative paths are resolved
+ *   next to the including file, every file is included at most once per stage.
+ * - `#keywords A B C` declares the variant keywords of the file, see FakeShaderLibrary::LoadVariants(). The line is removed.
+ * - The defines are injected right after the `#version` line of each stage.
+ *
+ * All other lines are copied unchanged without their '\r', removed directives leave an empty line behind.
+ * `#line` directives after the defines and around includes keep the line numbers of compile errors those of the file,
+ * the source string number is 0 for the file itself and n for the n-th include of the stage.
+ *
+ */
+class FakeShaderPreprocessor
+	{
+	public:
+
+		/**
+		 *
+		 * Preprocesses a combined shader source.
+		 *
+		 * @param source The combined shader source containing #type blocks.
+		 * @param filePath The path of the source, used to resolve relative includes. May be empty.
+		 * @param defines The defines which should be injected into every stage.
+		 * @return Returns the preprocessed stages in the order they appear in the source.
+		 */
+		static std::vector<FakeShaderStageSource> Process(std::string_view source, const FakeString &filePath = "", const FakeShaderDefineList &defines = {});
+
+		/**
+		 *
+		 * Collects the keywords of all `#keywords` lines in declaration order, duplicates are removed.
+		 *
+		 * @param source The combined shader source.
+		 * @return Returns the declared keywords.
+		 */
+		static std::vector<FakeString> ParseKeywords(std::string_view source);
+
+		/**
+		 *
+		 * Converts the name used in a #type directive to a shader stage.
+		 *
+		 * @param type The type name.
+		 * @return Returns the shader stage or FakeShaderStage::None if the name is unknown.
+		 */
+		static FakeShaderStage StageFromString(std::string_view type);
+	};
@@ -0,0 +1,316 @@
+#include "FakePch.h"
+#include "FakeShaderReflection.h"
+
+namespace Utils
+	{
+	static bool fake_is_identifier_start(char c)
+		{
+		return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+		}
+
+	static bool fake_is_digit(char c)
+		{
+		return c >= '0' && c <= '9';
+		}
+
+	static bool fake_is_qualifier(std::string_view token)
+		{
+		return token == "highp" || token == "mediump" || token == "lowp" || token == "const"
+			|| token == "flat" || token == "smooth" || token == "noperspective"
+			|| token == "readonly" || token == "writeonly" || token == "coherent" || token == "volatile" || token == "restrict";
+		}
+
+	static bool fake_is_space(char c)
+		{
+		return c == ' ' || c == '\t' || c == '\r';
+		}
+
+	static std::string_view fake_trim(std::string_view str)
+		{
+		while (!str.empty() && fake_is_space(str.front()))
+			str.remove_prefix(1);
+
+		while (!str.empty() && fake_is_space(str.back()))
+			str.remove_suffix(1);
+
+		return str;
+		}
+
+	// Array sizes are numbers or macros which expand to one, the reflection can not evaluate constant expressions
+	static uint32 fake_parse_count(FakeShaderTokenizer &tokenizer)
+		{
+		std::string_view token = tokenizer.Next();
+
+		// Unsized arrays only appear in storage blocks, which are not reflected
+		if (token == "]")
+			return 1;
+
+		std::string_view size = token;
+		for (uint32 depth = 0; depth < 8 && !size.empty() && fake_is_identifier_start(size[0]); ++depth)
+			size = tokenizer.GetDefine(size);
+
+		if (!size.empty() && (size.back() == 'u' || size.back() == 'U'))
+			size.remove_suffix(1);
+
+		uint32 result = 0;
+		bool valid = !size.empty();
+		for (char c : size)
+			{
+			if (!fake_is_digit(c))
+				{
+				valid = false;
+				break;
+				}
+
+			result = result * 10 + (c - '0');
+			}
+
+		if (tokenizer.Next() != "]")
+			{
+			valid = false;
+			while (!tokenizer.Peek().empty() && tokenizer.Next() != "]");
+			}
+
+		if (!valid || !result)
+			{
+			FAKE_LOG_ERROR("Shader array size %.*s is no number or macro of a number, it is reflected as 1!", (int32)token.size(), token.data());
+			return 1;
+			}
+
+		return result;
+		}
+
+	static void fake_skip_balanced(FakeShaderTokenizer &tokenizer, char open, char close)
+		{
+		uint32 depth = 1;
+		for (std::string_view token = tokenizer.Next(); !token.empty(); token = tokenizer.Next())
+			{
+			if (token[0] == open)
+				++depth;
+			else if (token[0] == close && --depth == 0)
+				return;
+			}
+		}
+
+	// Parses "<type> <name>[N], <name>[N];" and calls the callback for every declared name
+	template<typename Callback>
+	static void fake_parse_declaration(FakeShaderTokenizer &tokenizer, std::string_view type, Callback &&callback)
+		{
+		for (;;)
+			{
+			std::string_view name = tokenizer.Next();
+			if (name.empty() || !fake_is_identifier_start(name[0]))
+				return;
+
+			uint32 count = 1;
+			if (tokenizer.Peek() == "[")
+				{
+				tokenizer.Next();
+				count = fake_parse_count(tokenizer);
+				}
+
+			callback(type, name, count);
+
+			std::string_view separator = tokenizer.Next();
+			if (separator != ",")
+				return;
+			}
+		}
+	}
+
+std::string_view FakeShaderTokenizer::Next()
+	{
+	const char *data = Source.data();
+	size_t size = Source.size();
+
+	for (;;)
+		{
+		while (Position < size && (data[Position] == ' ' || data[Position] == '\t' || data[Position] == '\r' || data[Position] == '\n'))
+			++Position;
+
+		if (Position >= size)
+			return std::string_view();
+
+		char c = data[Position];
+		if (c == '/' && Position + 1 < size && data[Position + 1] == '/')
+			{
+			while (Position < size && data[Position] != '\n')
+				++Position;
+			continue;
+			}
+
+		if (c == '/' && Position + 1 < size && data[Position + 1] == '*')
+			{
+			size_t end = Source.find("*/", Position + 2);
+			Position = end == std::string_view::npos ? size : end + 2;
+			continue;
+			}
+
+		if (c == '#')
+			{
+			// Preprocessor lines, including line continuations
+			size_t start = Position;
+			while (Position < size && data[Position] != '\n')
+				{
+				if (data[Position] == '\\' && Position + 1 < size && data[Position + 1] == '\n')
+					++Position;
+				++Position;
+				}
+
+			if (start >= DefinesEnd)
+				{
+				RecordDefine(Source.substr(start + 1, Position - start - 1));
+				DefinesEnd = Position;
+				}
+			continue;
+			}
+
+		break;
+		}
+
+	size_t start = Position;
+	char c = data[Position];
+	if (Utils::fake_is_identifier_start(c))
+		{
+		while (Position < size && (Utils::fake_is_identifier_start(data[Position]) || Utils::fake_is_digit(data[Position])))
+			++Position;
+		}
+	else if (Utils::fake_is_digit(c))
+		{
+		while (Position < size && (Utils::fake_is_identifier_start(data[Position]) || Utils::fake_is_digit(data[Position]) || data[Position] == '.'))
+			++Position;
+		}
+	else
+		{
+		++Position;
+		}
+
+	return Source.substr(start, Position - start);
+	}
+
+std::string_view FakeShaderTokenizer::Peek()
+	{
+	size_t position = Position;
+	std::string_view token = Next();
+	Position = position;
+	return token;
+	}
+
+void FakeShaderReflection::Parse(std::string_view source, FakeShaderDomain domain)
+	{
+	FakeShaderTokenizer tokenizer(source);
+
+	for (std::string_view token = tokenizer.Next(); !token.empty(); token = tokenizer.Next())
+		{
+		if (token == "{")
+			{
+			// Function bodies and anything else in braces can not declare global uniforms
+			Utils::fake_skip_balanced(tokenizer, '{', '}');
+			}
+		else if (token == "layout")
+			{
+			if (tokenizer.Next() == "(")
+				Utils::fake_skip_balanced(tokenizer, '(', ')');
+			}
+		else if (token == "struct")
+			{
+			std::string_view name = tokenizer.Next();
+			if (tokenizer.Next() != "{")
+				continue;
+
+			uint32 structIndex = (uint32)Entries.size();
+			FakeShaderReflectionEntry entry;
+			entry.Kind = FakeShaderReflectionKind::Struct;
+			entry.Domain = domain;
+			entry.Name = name;
+			Entries.push_back(entry);
+
+			for (std::string_view type = tokenizer.Next(); !type.empty() && type != "}"; type = tokenizer.Next())
+				{
+				if (Utils::fake_is_qualifier(type))
+					continue;
+
+				Utils::fake_parse_declaration(tokenizer, type, [&](std::string_view fieldType, std::string_view fieldName, uint32 count)
+					{
+					FakeShaderReflectionEntry field;
+					field.Kind = FakeShaderReflectionKind::Field;
+					field.Domain = domain;
+					field.Type = fieldType;
+					field.Name = fieldName;
+					field.Count = count;
+					Entries.push_back(field);
+					});
+				}
+
+			Entries[structIndex].FieldCount = (uint32)Entries.size() - structIndex - 1;
+			}
+		else if (token == "uniform")
+			{
+			std::string_view type = tokenizer.Next();
+			while (Utils::fake_is_qualifier(type))
+				type = tokenizer.Next();
+
+			// Uniform blocks are bound by the renderer, not reflected
+			if (tokenizer.Peek() == "{")
+				{
+				tokenizer.Next();
+				Utils::fake_skip_balanced(tokenizer, '{', '}');
+				continue;
+				}
+
+			Utils::fake_parse_declaration(tokenizer, type, [&](std::string_view uniformType, std::string_view uniformName, uint32 count)
+				{
+				FakeShaderReflectionEntry uniform;
+				uniform.Kind = FakeShaderReflectionKind::Uniform;
+				uniform.Domain = domain;
+				uniform.Type = uniformType;
+				uniform.Name = uniformName;
+				uniform.Count = count;
+				Entries.push_back(uniform);
+				});
+			}
+		}
+	}
+
+std::string_view FakeShaderTokenizer::GetDefine(std::string_view name) const
+	{
+	for (auto it = Defines.rbegin(); it != Defines.rend(); ++it)
+		{
+		if (it->first == name)
+			return it->second;
+		}
+
+	return std::string_view();
+	}
+
+void FakeShaderTokenizer::RecordDefine(std::string_view line)
+	{
+	line = Utils::fake_trim(line);
+	if (line.size() < 7 || line.compare(0, 6, "define") != 0 || !Utils::fake_is_space(line[6]))
+		return;
+
+	line = Utils::fake_trim(line.substr(6));
+	size_t end = 0;
+	while (end < line.size() && (Utils::fake_is_identifier_start(line[end]) || Utils::fake_is_digit(line[end])))
+		++end;
+
+	// Function-like macros can not be array sizes
+	if (end == 0 || (end < line.size() && line[end] == '('))
+		return;
+
+	std::string_view value = line.substr(end);
+	value = Utils::fake_trim(value.substr(0, value.find("//")));
+	Defines.emplace_back(line.substr(0, end), value);
+	}
+
+uint32 FakeShaderReflection::FindStruct(std::string_view name, FakeShaderDomain domain) const
+	{
+	for (uint32 i = 0; i < (uint32)Entries.size(); i += Entries[i].FieldCount + 1)
+		{
+		const FakeShaderReflectionEntry &entry = Entries[i];
+		if (entry.Kind == FakeShaderReflectionKind::Struct && entry.Domain == domain && entry.Name == name)
+			return i;
+		}
+
+	return NPOS;
+	}
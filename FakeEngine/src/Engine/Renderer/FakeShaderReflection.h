@@ -0,0 +1,151 @@
+/*****************************************************************
+ * \file   FakeShaderReflection.h
+ * \brief  
+ * 
+ * \author Can Karka
+ * \date   February 2021
+ * 
+ * Copyright (C) 2021 Can Karka
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *********************************************************************/
+
+#pragma once
+
+#include <string_view>
+#include <vector>
+
+#include "FakeShaderUniform.h"
+
+/**
+ *
+ * Splits GLSL source into tokens without copying. Whitespace, comments and preprocessor lines are skipped,
+ * the object-like macros of skipped #define lines are remembered so array sizes can be resolved.
+ *
+ */
+class FakeShaderTokenizer
+	{
+	private:
+
+		std::string_view Source;
+		size_t Position = 0;
+
+		// Peek() scans lines twice, a #define is only recorded the first time
+		std::vector<std::pair<std::string_view, std::string_view>> Defines;
+		size_t DefinesEnd = 0;
+
+		void RecordDefine(std::string_view line);
+
+	public:
+
+		FakeShaderTokenizer(std::string_view source)
+			: Source(source)
+			{
+			}
+
+		/**
+		 *
+		 * Returns the next token, which is an identifier, a number or a single punctuation character.
+		 *
+		 * @return Returns the next token or an empty view at the end of the source.
+		 */
+		std::string_view Next();
+
+		/**
+		 *
+		 * Returns the next token without consuming it.
+		 *
+		 * @return Returns the next token or an empty view at the end of the source.
+		 */
+		std::string_view Peek();
+
+		/**
+		 *
+		 * Returns the value of an object-like macro defined in front of the current position.
+		 *
+		 * @param name The name of the macro.
+		 * @return Returns the value of the latest #define of the macro or an empty view if it was not defined.
+		 */
+		std::string_view GetDefine(std::string_view name) const;
+	};
+
+enum class FakeShaderReflectionKind : uint8
+	{
+	Struct = 0,
+	Field,
+	Uniform
+	};
+
+/**
+ *
+ * One entry of the reflection table. Type and Name point into the parsed source, which has to outlive the table.
+ *
+ */
+struct FakeShaderReflectionEntry
+	{
+	FakeShaderReflectionKind Kind = FakeShaderReflectionKind::Uniform;
+	FakeShaderDomain Domain = FakeShaderDomain::None;
+	uint32 Count = 1;
+	std::string_view Type;
+	std::string_view Name;
+
+	// Structs only, the fields directly follow their struct in the table
+	uint32 FieldCount = 0;
+	};
+
+/**
+ *
+ * Flat table of all structs and global uniforms declared in a set of shader stages.
+ *
+ * Entries are stored contiguously in declaration order, a struct entry is followed by its fields.
+ * Uniform blocks, function bodies and other declarations are skipped.
+ *
+ */
+class FakeShaderReflection
+	{
+	private:
+
+		std::vector<FakeShaderReflectionEntry> Entries;
+
+	public:
+
+		/**
+		 *
+		 * Appends all declarations of a single stage to the table.
+		 *
+		 * @param source The preprocessed stage source.
+		 * @param domain The domain of the stage.
+		 */
+		void Parse(std::string_view source, FakeShaderDomain domain);
+
+		/**
+		 *
+		 * Removes all entries, the memory is kept for the next parse.
+		 *
+		 */
+		void Clear() { Entries.clear(); }
+
+		/**
+		 *
+		 * Returns the struct entry with the given name in the given domain.
+		 *
+		 * @param name The name of the struct.
+		 * @param domain The domain the struct was declared in.
+		 * @return Returns the index of the struct entry or FakeShaderReflection::NPOS.
+		 */
+		uint32 FindStruct(std::string_view name, FakeShaderDomain domain) const;
+
+		inline const std::vector<FakeShaderReflectionEntry> &GetEntries() const { return Entries; }
+
+		static constexpr uint32 NPOS = ~0u;
+	};
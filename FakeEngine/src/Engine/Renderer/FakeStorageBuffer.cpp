@@ -0,0 +1,24 @@
+#include "FakePch.h"
+#include "FakeStorageBuffer.h"
+
+#include "Engine/Platform/Null/FakeNullStorageBuffer.h"
+#include "Engine/Platform/OpenGL/FakeOpenGLStorageBuffer.h"
+
+#ifdef FAKE_RENDERER_VULKAN
+#include "Engine/Platform/Vulkan/FakeVulkanStorageBuffer.h"
+#endif
+
+FakeRef<FakeStorageBuffer> FakeStorageBuffer::Create(uint32 size)
+	{
+	if (FakeRendererAPI::IsHeadless())
+		return FakeRef<FakeNullStorageBuffer>::Create(size);
+
+	#ifdef FAKE_RENDERER_VULKAN
+		if (FakeRendererAPI::Current() == FakeRendererAPIType::Vulkan)
+			return FakeRef<FakeVulkanStorageBuffer>::Create(size);
+	#endif
+
+	#ifdef FAKE_RENDERER_OPENGL
+		return FakeRef<FakeOpenGLStorageBuffer>::Create(size);
+	#endif
+	}
@@ -0,0 +1,93 @@
+/*****************************************************************
+ * \file   FakeStorageBuffer.h
+ * \brief  
+ * 
+ * \author Can Karka
+ * \date   February 2021
+ * 
+ * Copyright (C) 2021 Can Karka
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *********************************************************************/
+
+#pragma once
+
+#include "Engine/Renderer/FakeRendererAPI.h"
+
+/**
+ *
+ * A buffer shaders read and write as a shader storage block. Compute shaders use them for their inputs and outputs,
+ * an indirect buffer is a storage buffer a compute shader has written draw commands into.
+ *
+ */
+class FAKE_API FakeStorageBuffer : public FakeRefCounted
+	{
+	public:
+
+		/**
+		 *
+		 * default destructor.
+		 *
+		 */
+		virtual ~FakeStorageBuffer() = default;
+
+		/**
+		 *
+		 * Uploads data into the buffer, the data is copied so the caller can reuse its memory right away.
+		 *
+		 * @param data The data to upload.
+		 * @param size The size of the data in bytes.
+		 * @param offset The offset in bytes inside the buffer.
+		 */
+		virtual void SetData(const void *data, uint32 size, uint32 offset = 0) = 0;
+
+		/**
+		 *
+		 * Binds the buffer to the storage block with the given binding, layout(std430, binding = n) in GLSL.
+		 *
+		 * @param binding The binding point of the storage block.
+		 */
+		virtual void Bind(uint32 binding) const = 0;
+
+		/**
+		 *
+		 * Binds the buffer as the source of the commands and the draw count of FakeRendererAPI::DrawIndexedIndirect().
+		 *
+		 */
+		virtual void BindIndirect() const = 0;
+
+		/**
+		 *
+		 * Returns the size of the buffer in bytes.
+		 *
+		 * @return Returns the size of the buffer in bytes.
+		 */
+		virtual uint32 GetSize() const = 0;
+
+		/**
+		 *
+		 * Returns the RendererID where the data is bound to.
+		 *
+		 * @return Returns the RendererID where the data is bound to.
+		 */
+		virtual FakeRendererID GetRendererID() const = 0;
+
+		/**
+		 *
+		 * Creates a new shared StorageBuffer instance, the contents are zeroed.
+		 *
+		 * @param size The size of the buffer in bytes.
+		 * @return Returns a new shared instance of the StorageBuffer.
+		 */
+		static FakeRef<FakeStorageBuffer> Create(uint32 size);
+	};
@@ -1,10 +1,24 @@
 #include "FakePch.h"
 #include "FakeTexture2D.h"
 
+#include "FakeRendererAPI.h"
+#include "Engine/Platform/Null/FakeNullTexture2D.h"
 #include "Engine/Platform/OpenGL/FakeOpenGLTexture2D.h"
 
+#ifdef FAKE_RENDERER_VULKAN
+#include "Engine/Platform/Vulkan/FakeVulkanTexture2D.h"
+#endif
+
 FakeRef<FakeTexture2D> FakeTexture2D::Create(const FakeString &path, bool srgb, FakeTextureWrap wrap)
     {
+	if (FakeRendererAPI::IsHeadless())
+		return FakeRef<FakeNullTexture2D>::Create(path, srgb);
+
+	#ifdef FAKE_RENDERER_VULKAN
+		if (FakeRendererAPI::Current() == FakeRendererAPIType::Vulkan)
+			return FakeRef<FakeVulkanTexture2D>::Create(path, srgb, wrap);
+	#endif
+
 	#ifdef FAKE_RENDERER_OPENGL
 		return FakeRef<FakeOpenGLTexture2D>::Create(path, srgb, wrap);
 	#endif
@@ -12,6 +26,14 @@ FakeRef<FakeTexture2D> FakeTexture2D::Create(const FakeString &path, bool srgb,
 
 FakeRef<FakeTexture2D> FakeTexture2D::Create(FakeTextureFormat format, uint32 width, uint32 height, FakeTextureWrap wrap)
     {
+	if (FakeRendererAPI::IsHeadless())
+		return FakeRef<FakeNullTexture2D>::Create(format, width, height);
+
+	#ifdef FAKE_RENDERER_VULKAN
+		if (FakeRendererAPI::Current() == FakeRendererAPIType::Vulkan)
+			return FakeRef<FakeVulkanTexture2D>::Create(format, width, height, wrap);
+	#endif
+
 	#ifdef FAKE_RENDERER_OPENGL
 		return FakeRef<FakeOpenGLTexture2D>::Create(format, width, height, wrap);
 	#endif
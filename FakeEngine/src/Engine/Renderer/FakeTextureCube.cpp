@@ -1,10 +1,24 @@
 #include "FakePch.h"
 #include "FakeTextureCube.h"
 
+#include "FakeRendererAPI.h"
+#include "Engine/Platform/Null/FakeNullTextureCube.h"
 #include "Engine/Platform/OpenGL/FakeOpenGLTextureCube.h"
 
+#ifdef FAKE_RENDERER_VULKAN
+#include "Engine/Platform/Vulkan/FakeVulkanTextureCube.h"
+#endif
+
 FakeRef<FakeTextureCube> FakeTextureCube::Create(const FakeString &path)
     {
+	if (FakeRendererAPI::IsHeadless())
+		return FakeRef<FakeNullTextureCube>::Create(path);
+
+	#ifdef FAKE_RENDERER_VULKAN
+		if (FakeRendererAPI::Current() == FakeRendererAPIType::Vulkan)
+			return FakeRef<FakeVulkanTextureCube>::Create(path);
+	#endif
+
 	#ifdef FAKE_RENDERER_OPENGL
 		return FakeRef<FakeOpenGLTextureCube>::Create(path);
 	#endif
@@ -12,6 +26,14 @@ FakeRef<FakeTextureCube> FakeTextureCube::Create(const FakeString &path)
 
 FakeRef<FakeTextureCube> FakeTextureCube::Create(FakeTextureFormat format, uint32 width, uint32 height)
     {
+	if (FakeRendererAPI::IsHeadless())
+		return FakeRef<FakeNullTextureCube>::Create(format, width, height);
+
+	#ifdef FAKE_RENDERER_VULKAN
+		if (FakeRendererAPI::Current() == FakeRendererAPIType::Vulkan)
+			return FakeRef<FakeVulkanTextureCube>::Create(format, width, height);
+	#endif
+
 	#ifdef FAKE_RENDERER_OPENGL
 		return FakeRef<FakeOpenGLTextureCube>::Create(format, width, height);
 	#endif
@@ -1,10 +1,24 @@
 #include "FakePch.h"
 #include "FakeVertexBuffer.h"
 
+#include "FakeRendererAPI.h"
+#include "Engine/Platform/Null/FakeNullVertexBuffer.h"
 #include "Engine/Platform/OpenGL/FakeOpenGLVertexBuffer.h"
 
+#ifdef FAKE_RENDERER_VULKAN
+#include "Engine/Platform/Vulkan/FakeVulkanVertexBuffer.h"
+#endif
+
 FakeRef<FakeVertexBuffer> FakeVertexBuffer::Create(void *data, uint32 size, FakeVertexBufferUsage usage)
 	{
+	if (FakeRendererAPI::IsHeadless())
+		return FakeRef<FakeNullVertexBuffer>::Create(data, size, usage);
+
+	#ifdef FAKE_RENDERER_VULKAN
+		if (FakeRendererAPI::Current() == FakeRendererAPIType::Vulkan)
+			return FakeRef<FakeVulkanVertexBuffer>::Create(data, size, usage);
+	#endif
+
 	#ifdef FAKE_RENDERER_OPENGL
 		return FakeRef<FakeOpenGLVertexBuffer>::Create(data, size, usage);
 	#endif
@@ -12,6 +26,14 @@ FakeRef<FakeVertexBuffer> FakeVertexBuffer::Create(void *data, uint32 size, Fake
 
 FakeRef<FakeVertexBuffer> FakeVertexBuffer::Create(uint32 size, FakeVertexBufferUsage usage)
 	{
+	if (FakeRendererAPI::IsHeadless())
+		return FakeRef<FakeNullVertexBuffer>::Create(size, usage);
+
+	#ifdef FAKE_RENDERER_VULKAN
+		if (FakeRendererAPI::Current() == FakeRendererAPIType::Vulkan)
+			return FakeRef<FakeVulkanVertexBuffer>::Create(size, usage);
+	#endif
+
 	#ifdef FAKE_RENDERER_OPENGL
 		return FakeRef<FakeOpenGLVertexBuffer>::Create(size, usage);
 	#endif
@@ -28,7 +28,11 @@ enum class FakeVertexBufferUsage
 	{
 	None = 0,
 	Static = 1,
-	Dynamic = 2
+	Dynamic = 2,
+
+	// Rewritten every frame, the buffer keeps one region per frame in flight so the GPU can still read the previous ones.
+	// Map() hands out memory of the region of the current frame, vertices are written without an intermediate copy.
+	Stream = 3
 	};
 
 /**
@@ -57,6 +61,26 @@ class FAKE_API FakeVertexBuffer : public FakeRefCounted
 		 */
 		virtual void SetData(void *data, uint32 size, uint32 offset = 0) = 0;
 
+		/**
+		 *
+		 * Reserves memory in the region of the current frame of a stream buffer. The memory is the mapped buffer itself,
+		 * everything written to it has to be complete before FakeRenderer::Render() executes the draws reading it.
+		 * If the region of this frame is full, the commands recorded so far are executed early and the next region is used.
+		 *
+		 * @param size The maximum amount of bytes which will be written.
+		 * @param stride The offset of the memory is a multiple of stride, so draws can address it by vertex or instance.
+		 * @return Returns the mapped memory, GetStreamOffset() returns its offset inside the buffer.
+		 */
+		virtual void *Map(uint32 size, uint32 stride = 1) = 0;
+
+		/**
+		 *
+		 * Finishes the last Map(), the memory behind the written bytes is handed out by the next Map().
+		 *
+		 * @param usedSize The amount of bytes which have actually been written.
+		 */
+		virtual void Unmap(uint32 usedSize) = 0;
+
 		/**
 		 *
 		 * Binds the current VertexBuffer instance.
@@ -71,6 +95,14 @@ class FAKE_API FakeVertexBuffer : public FakeRefCounted
 		 */
 		virtual void Unbind() const = 0;
 
+		/**
+		 *
+		 * Binds the buffer to a storage block as well, so a compute shader can write the vertices or instances a draw reads.
+		 *
+		 * @param binding The binding point of the storage block.
+		 */
+		virtual void BindStorage(uint32 binding) const = 0;
+
 		/**
 		 *
 		 * Returns the Layout used to interpret the Layout of the vertices.
@@ -95,6 +127,14 @@ class FAKE_API FakeVertexBuffer : public FakeRefCounted
 		 */
 		virtual uint32 GetSize() const = 0;
 
+		/**
+		 *
+		 * Returns the offset of the memory which has been handed out by the last Map() or SetData() of a stream buffer.
+		 *
+		 * @return Returns the offset in bytes, always 0 for static and dynamic buffers.
+		 */
+		virtual uint32 GetStreamOffset() const = 0;
+
 		/**
 		 *
 		 * Returns the RendererID where the data is bound to.
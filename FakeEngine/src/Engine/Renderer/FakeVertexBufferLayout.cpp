@@ -12,10 +12,14 @@ namespace Utils
 
 			case FakeShaderDataType::Int:
 			case FakeShaderDataType::Float:
+			case FakeShaderDataType::Short2:
+			case FakeShaderDataType::Half2:
 				return 4;
 
 			case FakeShaderDataType::Int2:
 			case FakeShaderDataType::Float2:
+			case FakeShaderDataType::Short4:
+			case FakeShaderDataType::Half4:
 				return 4 * 2;
 
 			case FakeShaderDataType::Int3:
@@ -57,6 +61,8 @@ uint32 FakeVertexBufferElement::GetComponentCount() const
 
 		case FakeShaderDataType::Float2:
 		case FakeShaderDataType::Int2:
+		case FakeShaderDataType::Short2:
+		case FakeShaderDataType::Half2:
 			return 2;
 
 		case FakeShaderDataType::Float3:
@@ -65,6 +71,8 @@ uint32 FakeVertexBufferElement::GetComponentCount() const
 
 		case FakeShaderDataType::Float4:
 		case FakeShaderDataType::Int4:
+		case FakeShaderDataType::Short4:
+		case FakeShaderDataType::Half4:
 			return 4;
 
 		case FakeShaderDataType::Mat2:
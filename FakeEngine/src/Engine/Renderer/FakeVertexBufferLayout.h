@@ -28,6 +28,11 @@ enum class FakeShaderDataType
 	Float, Float2, Float3, Float4,
 	Int, Int2, Int3, Int4,
 	Mat2, Mat3, Mat4,
+
+	// Compact vertex formats, read as floats by the shader. Shorts are mapped to [-1, 1] when the element is normalized
+	Short2, Short4,
+	Half2, Half4,
+
 	Bool
 	};
 
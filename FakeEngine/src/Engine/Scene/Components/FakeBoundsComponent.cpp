@@ -0,0 +1,7 @@
+#include "FakePch.h"
+#include "FakeBoundsComponent.h"
+
+FakeBoundsComponent::FakeBoundsComponent(const FakeAABB &localBounds)
+	: LocalBounds(localBounds)
+	{
+	}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "Engine/Core/Maths/FakeMaths.h"
+
+/**
+ *
+ * Registers the entity in the spatial index of the scene, so it can be found by FakeScene::QueryBox(), QueryRadius(), QueryFrustum() and Raycast().
+ * WorldBounds and ProxyId are maintained by the scene whenever the transform changes.
+ *
+ */
+struct FakeBoundsComponent
+	{
+	// Defaults to the unit quad drawn for sprites
+	FakeAABB LocalBounds = FakeAABB(FakeVec3f(-0.5f, -0.5f, 0.0f), FakeVec3f(0.5f, 0.5f, 0.0f));
+
+	FakeAABB WorldBounds;
+	int32 ProxyId = -1;
+
+	FakeBoundsComponent() = default;
+	FakeBoundsComponent(const FakeBoundsComponent &) = default;
+	FakeBoundsComponent(const FakeAABB &localBounds);
+	};
+
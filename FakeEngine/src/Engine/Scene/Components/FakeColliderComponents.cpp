@@ -0,0 +1,12 @@
+#include "FakePch.h"
+#include "FakeColliderComponents.h"
+
+FakeBoxColliderComponent::FakeBoxColliderComponent(const FakeVec2f &size, const FakeVec2f &offset)
+	: Offset(offset), Size(size)
+	{
+	}
+
+FakeCircleColliderComponent::FakeCircleColliderComponent(float radius, const FakeVec2f &offset)
+	: Offset(offset), Radius(radius)
+	{
+	}
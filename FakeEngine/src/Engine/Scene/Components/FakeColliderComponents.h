@@ -0,0 +1,54 @@
+#pragma once
+
+#include "Engine/Core/Maths/FakeMaths.h"
+
+class b2Fixture;
+
+/**
+ *
+ * Box shape of a FakeRigidbodyComponent, scaled by the transform of the entity.
+ *
+ */
+struct FakeBoxColliderComponent
+	{
+	FakeVec2f Offset = { 0.0f, 0.0f };
+
+	// Half extents, the default matches the unit quad of a sprite
+	FakeVec2f Size = { 0.5f, 0.5f };
+
+	float Density = 1.0f;
+	float Friction = 0.5f;
+	float Restitution = 0.0f;
+	bool IsSensor = false;
+
+	// Set by FakePhysicsWorld once the fixture has been created
+	b2Fixture *RuntimeFixture = nullptr;
+
+	FakeBoxColliderComponent() = default;
+	FakeBoxColliderComponent(const FakeBoxColliderComponent &) = default;
+	FakeBoxColliderComponent(const FakeVec2f &size, const FakeVec2f &offset = FakeVec2f(0.0f, 0.0f));
+	};
+
+/**
+ *
+ * Circle shape of a FakeRigidbodyComponent, the radius is scaled by the larger axis of the transform.
+ *
+ */
+struct FakeCircleColliderComponent
+	{
+	FakeVec2f Offset = { 0.0f, 0.0f };
+	float Radius = 0.5f;
+
+	float Density = 1.0f;
+	float Friction = 0.5f;
+	float Restitution = 0.0f;
+	bool IsSensor = false;
+
+	// Set by FakePhysicsWorld once the fixture has been created
+	b2Fixture *RuntimeFixture = nullptr;
+
+	FakeCircleColliderComponent() = default;
+	FakeCircleColliderComponent(const FakeCircleColliderComponent &) = default;
+	FakeCircleColliderComponent(float radius, const FakeVec2f &offset = FakeVec2f(0.0f, 0.0f));
+	};
+
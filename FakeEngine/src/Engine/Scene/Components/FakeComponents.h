@@ -2,6 +2,10 @@
 
 #include "FakeTagComponent.h"
 #include "FakeTransformComponent.h"
+#include "FakeHierarchyComponent.h"
+#include "FakeBoundsComponent.h"
 #include "FakeCameraComponent.h"
 #include "FakeSpriteComponent.h"
+#include "FakeRigidbodyComponent.h"
+#include "FakeColliderComponents.h"
 
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <entt/entt.hpp>
+
+/**
+ *
+ * Intrusive parent / child links of an entity. Children form a singly linked list
+ * through NextSibling, so attaching and detaching never allocates.
+ * Use FakeScene::SetParent() to modify the links, it keeps Depth and the cached world transforms valid.
+ *
+ */
+struct FakeHierarchyComponent
+	{
+	entt::entity Parent = entt::null;
+	entt::entity FirstChild = entt::null;
+	entt::entity NextSibling = entt::null;
+	uint32 Depth = 0;
+
+	FakeHierarchyComponent() = default;
+	FakeHierarchyComponent(const FakeHierarchyComponent &) = default;
+	};
+
@@ -0,0 +1,7 @@
+#include "FakePch.h"
+#include "FakeRigidbodyComponent.h"
+
+FakeRigidbodyComponent::FakeRigidbodyComponent(FakeRigidbodyType type)
+	: Type(type)
+	{
+	}
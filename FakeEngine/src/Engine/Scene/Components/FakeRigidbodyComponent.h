@@ -0,0 +1,39 @@
+#pragma once
+
+#include "Engine/Core/FakeCore.h"
+
+class b2Body;
+
+// Same order as b2BodyType
+enum class FakeRigidbodyType
+	{
+	Static = 0,
+	Kinematic,
+	Dynamic
+	};
+
+/**
+ *
+ * Simulates the entity in the FakePhysicsWorld of the scene, the shape comes from the collider components.
+ * The body starts at the translation and the Z rotation of the transform, rigidbodies should not have a parent.
+ * Changes through FakeEntity::PatchComponent() are applied to the body.
+ *
+ */
+struct FakeRigidbodyComponent
+	{
+	FakeRigidbodyType Type = FakeRigidbodyType::Static;
+	bool FixedRotation = false;
+	bool Bullet = false;
+	float GravityScale = 1.0f;
+	float LinearDamping = 0.0f;
+	float AngularDamping = 0.0f;
+
+	// Set by FakePhysicsWorld once the body has been created
+	b2Body *RuntimeBody = nullptr;
+	uint32 RuntimeIndex = ~0u;
+
+	FakeRigidbodyComponent() = default;
+	FakeRigidbodyComponent(const FakeRigidbodyComponent &) = default;
+	FakeRigidbodyComponent(FakeRigidbodyType type);
+	};
+
@@ -6,3 +6,8 @@ FakeSpriteComponent::FakeSpriteComponent(const FakeVec4f &color)
     {
     }
 
+
+FakeSpriteComponent::FakeSpriteComponent(const FakeRef<FakeTexture2D> &texture, const FakeVec4f &tintColor)
+    : Color(tintColor), Texture(texture)
+    {
+    }
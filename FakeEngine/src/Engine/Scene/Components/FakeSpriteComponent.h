@@ -1,14 +1,18 @@
 #pragma once
 
 #include "Engine/Core/Maths/FakeMaths.h"
+#include "Engine/Renderer/FakeTexture2D.h"
 
 struct FakeSpriteComponent
 	{
 	FakeVec4f Color{ 1.0f, 1.0f, 1.0f, 1.0f };
+	FakeRef<FakeTexture2D> Texture;
+	float TilingFactor = 1.0f;
 
 	FakeSpriteComponent() = default;
 	FakeSpriteComponent(const FakeSpriteComponent &) = default;
 	FakeSpriteComponent(const FakeVec4f &color);
+	FakeSpriteComponent(const FakeRef<FakeTexture2D> &texture, const FakeVec4f &tintColor = FakeVec4f(1.0f, 1.0f, 1.0f, 1.0f));
 
 	};
 
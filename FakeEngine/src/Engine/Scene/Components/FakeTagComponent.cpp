@@ -2,6 +2,20 @@
 #include "FakeTagComponent.h"
 
 FakeTagComponent::FakeTagComponent(const FakeString &tag)
-	: Tag(tag)
+	: Shared(FakeRef<SharedTag>::Create(tag))
 	{
 	}
+
+const FakeString &FakeTagComponent::GetTag() const
+	{
+	static const FakeString empty;
+	return Shared ? Shared->Name : empty;
+	}
+
+void FakeTagComponent::SetTag(const FakeString &tag)
+	{
+	if (Shared && !IsShared())
+		Shared->Name = tag;
+	else
+		Shared = FakeRef<SharedTag>::Create(tag);
+	}
@@ -1,11 +1,40 @@
 #pragma once
 
+#include "Engine/Core/FakeReference.h"
+
+/**
+ *
+ * The name of an entity. Copies share the string until one of them is renamed,
+ * so entities spawned from the same FakePrefab do not allocate a name each.
+ *
+ */
 struct FakeTagComponent
 	{
-	FakeString Tag;
+	private:
+		struct SharedTag : public FakeRefCounted
+			{
+			FakeString Name;
+
+			SharedTag(const FakeString &name)
+				: Name(name)
+				{
+				}
+			};
+
+		FakeRef<SharedTag> Shared;
+
+	public:
 
-	FakeTagComponent() = default;
-	FakeTagComponent(const FakeTagComponent &) = default;
-	FakeTagComponent(const FakeString &tag);
+		FakeTagComponent() = default;
+		FakeTagComponent(const FakeTagComponent &) = default;
+		FakeTagComponent(const FakeString &tag);
 
+		const FakeString &GetTag() const;
+
+		// Renames only this entity, the shared string is copied first if other entities still use it.
+		// The reference count is atomic, but renaming one entity while another thread copies the same component still races.
+		void SetTag(const FakeString &tag);
+
+		bool IsShared() const { return Shared && Shared->GetRefCount() > 1; }
 	};
+
@@ -8,7 +8,23 @@ FakeTransformComponent::FakeTransformComponent(const FakeVec3f &translation)
 
 FakeMat4f FakeTransformComponent::GetTransform() const
 	{
-	FakeMat4f rotation = FakeQuatf::ToMatrix4(FakeQuatf(Rotation));
-	FakeMat4f transform = FakeMat4f::Translate(Translation) * rotation * FakeMat4f::Scale(Scale);
+	FakeMat4f transform;
+	GetTransforms(this, 1, &transform);
 	return transform;
 	}
+
+void FakeTransformComponent::GetTransforms(const FakeTransformComponent *components, uint32 count, FakeMat4f *outTransforms)
+	{
+	// Row vector convention: Scale * Rotation * Translate, written directly instead of two full matrix products
+	for (uint32 i = 0; i < count; ++i)
+		{
+		const FakeTransformComponent &c = components[i];
+		FakeMat3f rotation = FakeQuatf::ToMatrix3(FakeQuatf(c.Rotation));
+		FakeMat4f &m = outTransforms[i];
+
+		m.M11 = rotation.M11 * c.Scale.X; m.M12 = rotation.M21 * c.Scale.X; m.M13 = rotation.M31 * c.Scale.X; m.M14 = 0.0f;
+		m.M21 = rotation.M12 * c.Scale.Y; m.M22 = rotation.M22 * c.Scale.Y; m.M23 = rotation.M32 * c.Scale.Y; m.M24 = 0.0f;
+		m.M31 = rotation.M13 * c.Scale.Z; m.M32 = rotation.M23 * c.Scale.Z; m.M33 = rotation.M33 * c.Scale.Z; m.M34 = 0.0f;
+		m.M41 = c.Translation.X;          m.M42 = c.Translation.Y;          m.M43 = c.Translation.Z;          m.M44 = 1.0f;
+		}
+	}
@@ -8,10 +8,21 @@ struct FakeTransformComponent
 	FakeVec3f Rotation = { 0.0f, 0.0f, 0.0f };
 	FakeVec3f Scale = { 1.0f, 1.0f, 1.0f };
 
+	// Cached by FakeScene::UpdateTransforms(), WorldTransform includes all parents
+	FakeMat4f LocalTransform;
+	FakeMat4f WorldTransform;
+
+	// Set when the component has been modified through FakeEntity::PatchComponent() or FakeScene::MarkTransformDirty()
+	bool Dirty = true;
+
 	FakeTransformComponent() = default;
 	FakeTransformComponent(const FakeTransformComponent &) = default;
 	FakeTransformComponent(const FakeVec3f &translation);
 
+	// Computes the local transform from Translation, Rotation and Scale, ignores the cache
 	FakeMat4f GetTransform() const;
+
+	// Computes the transforms of many components at once, same result as GetTransform()
+	static void GetTransforms(const FakeTransformComponent *components, uint32 count, FakeMat4f *outTransforms);
 	};
 
@@ -58,6 +58,8 @@ class FAKE_API FakeCamera
 		const FakeMat4f &GetProjectionMatrix() const { return ProjectionMatrix; }
 		void SetProjectionMatrix(const FakeMat4f & projectionMatrix) { ProjectionMatrix = projectionMatrix; }
 
+		ProjectionType GetProjectionType() const { return Type; }
+
 		float GetExposure() const { return Exposure; }
 		float &GetExposure() { return Exposure; }
 
@@ -5,3 +5,13 @@ FakeEntity::FakeEntity(entt::entity handle, FakeScene *scene)
     : EntityHandle(handle), Scene(scene)
     {
     }
+
+void FakeEntity::SetParent(FakeEntity parent)
+	{
+	Scene->SetParent(*this, parent);
+	}
+
+FakeEntity FakeEntity::GetParent()
+	{
+	return Scene->GetParent(*this);
+	}
@@ -58,6 +58,21 @@ class FakeEntity
 			return Scene->Registry.get<T>(EntityHandle);
 			}
 
+		/**
+		 *
+		 * Modifies a component in place and notifies the scene, use this instead of GetComponent() for
+		 * FakeTransformComponent so the cached world transforms are updated.
+		 *
+		 * @param func Functions called with a reference to the component.
+		 * @return Returns the modified component.
+		 */
+		template<typename T, typename... Func>
+		T &PatchComponent(Func&&... func)
+			{
+			FAKE_ASSERT(HasComponent<T>());
+			return Scene->Registry.patch<T>(EntityHandle, std::forward<Func>(func)...);
+			}
+
 		template<typename T>
 		bool HasComponent()
 			{
@@ -71,6 +86,9 @@ class FakeEntity
 			Scene->Registry.remove<T>(EntityHandle);
 			}
 
+		void SetParent(FakeEntity parent);
+		FakeEntity GetParent();
+
 		operator bool() const
 			{
 			return EntityHandle != entt::null;
@@ -96,3 +114,9 @@ class FakeEntity
 			return !(*this == other);
 			}
 	};
+
+template<typename T>
+void FakeScene::OnComponentAdded(FakeEntity entity, T &component)
+	{
+	}
+
@@ -0,0 +1,64 @@
+#include "FakePch.h"
+#include "FakePrefab.h"
+
+#include "FakeSceneBinarySerializer.h"
+
+namespace Utils
+	{
+	template<typename T>
+	static void fake_copy_component(FakePrefab &prefab, FakeEntity source)
+		{
+		if (source.HasComponent<T>())
+			prefab.AddComponent<T>(source.GetComponent<T>());
+		}
+	}
+
+FakePrefab::FakePrefab(const FakeString &name)
+	{
+	AddComponent<FakeTransformComponent>();
+	AddComponent<FakeTagComponent>(name);
+	}
+
+FakePrefab::FakePrefab(FakeEntity source)
+	{
+	FAKE_ASSERT(source);
+
+	// Same components as the scene serializers, the hierarchy is left out
+	Utils::fake_copy_component<FakeTransformComponent>(*this, source);
+	Utils::fake_copy_component<FakeTagComponent>(*this, source);
+	Utils::fake_copy_component<FakeSpriteComponent>(*this, source);
+	Utils::fake_copy_component<FakeCameraComponent>(*this, source);
+	Utils::fake_copy_component<FakeBoundsComponent>(*this, source);
+	Utils::fake_copy_component<FakeBoxColliderComponent>(*this, source);
+	Utils::fake_copy_component<FakeCircleColliderComponent>(*this, source);
+	Utils::fake_copy_component<FakeRigidbodyComponent>(*this, source);
+	}
+
+bool FakePrefab::Serialize(const FakeString &path) const
+	{
+	FakeScene scene;
+	scene.Instantiate(*this, 1);
+	return FakeSceneBinarySerializer(scene).Serialize(path);
+	}
+
+bool FakePrefab::Deserialize(const FakeString &path)
+	{
+	FakeScene scene;
+	if (!FakeSceneBinarySerializer(scene).Deserialize(path))
+		return false;
+
+	if (scene.Registry.alive() != 1)
+		{
+		FAKE_LOG_ERROR("Prefab file %s must contain exactly one entity!", *path);
+		return false;
+		}
+
+	entt::entity entity = entt::null;
+	scene.Registry.each([&entity](entt::entity e) { entity = e; });
+
+	// The temporary scene only owns copies, shared data like textures stays alive in the prefab
+	Components.clear();
+	FakePrefab loaded(FakeEntity(entity, &scene));
+	Components = std::move(loaded.Components);
+	return true;
+	}
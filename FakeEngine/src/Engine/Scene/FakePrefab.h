@@ -0,0 +1,177 @@
+/*****************************************************************
+ * \file   FakePrefab.h
+ * \brief  
+ * 
+ * \author Can Karka
+ * \date   February 2021
+ * 
+ * Copyright (C) 2021 Can Karka
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *********************************************************************/
+
+#pragma once
+
+#include <entt/entt.hpp>
+#include "FakeEntity.h"
+#include "Components/FakeComponents.h"
+
+/**
+ *
+ * A component set from which many entities can be spawned at once with FakeScene::Instantiate().
+ *
+ * The prefab holds one template of every component, each one is inserted into the registry as a single range.
+ * Components are copied into the instances, data behind a FakeRef like the texture of a sprite or the name of the
+ * FakeTagComponent is shared by all instances until one of them replaces it. Hierarchies are not part of a prefab,
+ * the instances are created without a parent.
+ *
+ * ### Usage
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~.cpp
+ * FakeRef<FakePrefab> bullet = FakeRef<FakePrefab>::Create("Bullet");
+ * bullet->AddComponent<FakeSpriteComponent>(bulletTexture);
+ * bullet->AddComponent<FakeCircleColliderComponent>(0.1f);
+ * bullet->AddComponent<FakeRigidbodyComponent>(FakeRigidbodyType::Dynamic).Bullet = true;
+ *
+ * scene.Instantiate(*bullet, count, transforms);
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+class FAKE_API FakePrefab : public FakeRefCounted
+	{
+	private:
+
+		struct ComponentTemplate
+			{
+			entt::id_type Type;
+
+			ComponentTemplate(entt::id_type type)
+				: Type(type)
+				{
+				}
+
+			virtual ~ComponentTemplate() = default;
+			virtual void Insert(FakeScene &scene, const entt::entity *entities, uint32 count) const = 0;
+			};
+
+		template<typename T>
+		struct TypedComponentTemplate : public ComponentTemplate
+			{
+			T Component;
+
+			template<typename... Args>
+			TypedComponentTemplate(Args&&... args)
+				: ComponentTemplate(entt::type_info<T>::id()), Component(std::forward<Args>(args)...)
+				{
+				}
+
+			void Insert(FakeScene &scene, const entt::entity *entities, uint32 count) const override
+				{
+				scene.Registry.insert<T>(entities, entities + count, Component);
+
+				// Empty for most components, the loop is optimized away
+				for (uint32 i = 0; i < count; ++i)
+					scene.OnComponentAdded<T>({ entities[i], &scene }, scene.Registry.get<T>(entities[i]));
+				}
+			};
+
+		// Inserted in the order they have been added
+		std::vector<Scope<ComponentTemplate>> Components;
+
+		friend class FakeScene;
+
+		template<typename T>
+		int32 FindComponent() const
+			{
+			for (uint32 i = 0; i < (uint32)Components.size(); ++i)
+				{
+				if (Components[i]->Type == entt::type_info<T>::id())
+					return (int32)i;
+				}
+
+			return -1;
+			}
+
+	public:
+
+		/**
+		 *
+		 * Creates a prefab with a default FakeTransformComponent and a FakeTagComponent, like FakeScene::CreateEntity().
+		 *
+		 * @param name The name shared by all instances.
+		 */
+		FakePrefab(const FakeString &name = "Entity");
+
+		/**
+		 *
+		 * Creates a prefab from the components of an existing entity, the entity is not modified.
+		 *
+		 * @param source The entity to copy the components from.
+		 */
+		FakePrefab(FakeEntity source);
+
+		FakePrefab(const FakePrefab &) = delete;
+		FakePrefab &operator=(const FakePrefab &) = delete;
+
+		template<typename T, typename... Args>
+		T &AddComponent(Args&&... args)
+			{
+			FAKE_ASSERT(!HasComponent<T>());
+			Components.push_back(CreateScope<TypedComponentTemplate<T>>(std::forward<Args>(args)...));
+			return GetComponent<T>();
+			}
+
+		template<typename T>
+		T &GetComponent()
+			{
+			FAKE_ASSERT(HasComponent<T>());
+			return ((TypedComponentTemplate<T>*)Components[FindComponent<T>()].get())->Component;
+			}
+
+		template<typename T>
+		const T &GetComponent() const
+			{
+			FAKE_ASSERT(HasComponent<T>());
+			return ((const TypedComponentTemplate<T>*)Components[FindComponent<T>()].get())->Component;
+			}
+
+		template<typename T>
+		bool HasComponent() const
+			{
+			return FindComponent<T>() >= 0;
+			}
+
+		template<typename T>
+		void RemoveComponent()
+			{
+			FAKE_ASSERT(HasComponent<T>());
+			Components.erase(Components.begin() + FindComponent<T>());
+			}
+
+		/**
+		 *
+		 * Writes the components of the prefab to a file in the format of FakeSceneBinarySerializer.
+		 *
+		 * @param path The physical path to the file on the disk.
+		 * @return Returns true if the file has been written.
+		 */
+		bool Serialize(const FakeString &path) const;
+
+		/**
+		 *
+		 * Replaces the components of the prefab with the single entity stored in a binary scene file.
+		 *
+		 * @param path The physical path to the file on the disk.
+		 * @return Returns true if the file has been loaded.
+		 */
+		bool Deserialize(const FakeString &path);
+	};
+
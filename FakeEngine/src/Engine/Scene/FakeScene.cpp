@@ -2,56 +2,545 @@
 #include "FakeScene.h"
 
 #include "FakeEntity.h"
+#include "FakePrefab.h"
 #include "Components/FakeComponents.h"
 
 FakeScene::FakeScene()
+	: Physics(Registry)
 	{
+	Registry.on_construct<FakeTransformComponent>().connect<&FakeScene::OnTransformConstructed>(*this);
+	Registry.on_update<FakeTransformComponent>().connect<&FakeScene::OnTransformUpdated>(*this);
+	Registry.on_construct<FakeBoundsComponent>().connect<&FakeScene::OnBoundsConstructed>(*this);
+	Registry.on_update<FakeBoundsComponent>().connect<&FakeScene::OnBoundsUpdated>(*this);
+	Registry.on_destroy<FakeBoundsComponent>().connect<&FakeScene::OnBoundsDestroyed>(*this);
 	}
 
 FakeScene::FakeScene(uint32 width, uint32 height)
-	: ViewportWidth(width), ViewportHeight(height)
+	: FakeScene()
 	{
+	ViewportWidth = width;
+	ViewportHeight = height;
 	}
 
 FakeScene::~FakeScene()
 	{
+	// The spatial index is destroyed before the registry
+	Registry.on_destroy<FakeBoundsComponent>().disconnect(*this);
 	}
 
 FakeEntity FakeScene::CreateEntity(const FakeString &name)
 	{
 	FakeEntity entity = { Registry.create(), this };
 	entity.AddComponent<FakeTransformComponent>();
-	auto &tag = entity.AddComponent<FakeTagComponent>();
-	tag.Tag = name.IsEmpty() ? "Entity" : name;
+	entity.AddComponent<FakeTagComponent>(name.IsEmpty() ? "Entity" : name);
 	return entity;
 	}
 
 void FakeScene::DestroyEntity(FakeEntity entity)
 	{
+	// Children are destroyed together with their parent, each one unlinks itself
+	for (;;)
+		{
+		FakeHierarchyComponent *hierarchy = Registry.try_get<FakeHierarchyComponent>(entity);
+		if (!hierarchy || hierarchy->FirstChild == entt::null)
+			break;
+
+		DestroyEntity({ hierarchy->FirstChild, this });
+		}
+
+	DetachFromParent(entity);
 	Registry.destroy(entity);
 	}
 
+void FakeScene::Instantiate(const FakePrefab &prefab, uint32 count, const FakeTransformComponent *transforms, std::vector<FakeEntity> *outEntities)
+	{
+	SpawnedEntities.resize(count);
+	Registry.create(SpawnedEntities.begin(), SpawnedEntities.end());
+
+	const entt::entity *first = SpawnedEntities.data();
+	if (transforms)
+		Registry.insert<FakeTransformComponent>(first, first + count, transforms, transforms + count);
+
+	for (const auto &component : prefab.Components)
+		{
+		if (transforms && component->Type == entt::type_info<FakeTransformComponent>::id())
+			continue;
+
+		component->Insert(*this, first, count);
+		}
+
+	if (outEntities)
+		{
+		outEntities->reserve(outEntities->size() + count);
+		for (entt::entity entity : SpawnedEntities)
+			outEntities->emplace_back(entity, this);
+		}
+	}
+
+void FakeScene::SetParent(FakeEntity child, FakeEntity parent)
+	{
+	FAKE_ASSERT(child);
+
+	DetachFromParent(child);
+
+	// Emplace both first, adding to the pool may move the other component
+	Registry.get_or_emplace<FakeHierarchyComponent>(child);
+	if (parent)
+		Registry.get_or_emplace<FakeHierarchyComponent>(parent);
+
+	FakeHierarchyComponent &childHierarchy = Registry.get<FakeHierarchyComponent>(child);
+	uint32 depth = 0;
+
+	if (parent)
+		{
+		FakeHierarchyComponent &parentHierarchy = Registry.get<FakeHierarchyComponent>(parent);
+
+	#ifdef FAKE_DEBUG
+		for (entt::entity ancestor = parent; ancestor != entt::null; ancestor = Registry.get<FakeHierarchyComponent>(ancestor).Parent)
+			FAKE_ASSERT(ancestor != (entt::entity)child, "An entity can not be parented to its own child!");
+	#endif
+
+		childHierarchy.Parent = parent;
+		childHierarchy.NextSibling = parentHierarchy.FirstChild;
+		parentHierarchy.FirstChild = child;
+		depth = parentHierarchy.Depth + 1;
+		}
+
+	UpdateSubtreeDepth(child, depth);
+	HierarchyChanged = true;
+	MarkTransformDirty(child);
+	}
+
+FakeEntity FakeScene::GetParent(FakeEntity entity)
+	{
+	FakeHierarchyComponent *hierarchy = Registry.try_get<FakeHierarchyComponent>(entity);
+	if (!hierarchy || hierarchy->Parent == entt::null)
+		return {};
+
+	return { hierarchy->Parent, this };
+	}
+
+void FakeScene::MarkTransformDirty(FakeEntity entity)
+	{
+	// patch() without a function only fires on_update
+	Registry.patch<FakeTransformComponent>(entity);
+	}
+
+void FakeScene::UpdateTransforms()
+	{
+	// Nothing moved, static geometry costs nothing
+	if (DirtyTransforms.empty())
+		return;
+
+	if (HierarchyChanged)
+		{
+		// Breadth first order, parents are stored before their children and siblings next to each other
+		Registry.sort<FakeHierarchyComponent>([](const FakeHierarchyComponent &a, const FakeHierarchyComponent &b)
+			{
+			return a.Depth < b.Depth || (a.Depth == b.Depth && a.Parent < b.Parent);
+			});
+
+		// The walk below reads both pools, the transforms follow the same order
+		Registry.sort<FakeTransformComponent, FakeHierarchyComponent>();
+
+		HierarchyChanged = false;
+		}
+
+	// Process the dirty entities from the root downwards, so a subtree is only visited once
+	uint32 count = (uint32)DirtyTransforms.size();
+	DirtyOrder.resize(count);
+	DirtyOrderScratch.resize(count);
+	for (uint32 i = 0; i < count; ++i)
+		{
+		entt::entity entity = DirtyTransforms[i];
+		const FakeHierarchyComponent *hierarchy = Registry.valid(entity) ? Registry.try_get<FakeHierarchyComponent>(entity) : nullptr;
+		DirtyOrder[i].Key = hierarchy ? hierarchy->Depth : 0;
+		DirtyOrder[i].Value = i;
+		}
+
+	fake_radix_sort(DirtyOrder.data(), DirtyOrderScratch.data(), count);
+
+	for (uint32 i = 0; i < count; ++i)
+		{
+		entt::entity root = DirtyTransforms[DirtyOrder[i].Value];
+		if (!Registry.valid(root))
+			continue;
+
+		// Already updated as part of a dirty parent
+		const FakeTransformComponent *rootTransform = Registry.try_get<FakeTransformComponent>(root);
+		if (!rootTransform || !rootTransform->Dirty)
+			continue;
+
+		const FakeMat4f *parentWorld = nullptr;
+		const FakeHierarchyComponent *rootHierarchy = Registry.try_get<FakeHierarchyComponent>(root);
+		if (rootHierarchy && rootHierarchy->Parent != entt::null)
+			{
+			if (const FakeTransformComponent *parentTransform = Registry.try_get<FakeTransformComponent>(rootHierarchy->Parent))
+				parentWorld = &parentTransform->WorldTransform;
+			}
+
+		TransformQueue.clear();
+		TransformQueue.emplace_back(root, parentWorld);
+
+		// Breadth first walk of the subtree, the queue is never shrunk while walking
+		for (size_t head = 0; head < TransformQueue.size(); ++head)
+			{
+			auto [entity, parent] = TransformQueue[head];
+
+			FakeTransformComponent *transform = Registry.try_get<FakeTransformComponent>(entity);
+			if (!transform)
+				continue;
+
+			if (transform->Dirty)
+				{
+				FakeTransformComponent::GetTransforms(transform, 1, &transform->LocalTransform);
+				transform->Dirty = false;
+				}
+
+			if (parent)
+				FakeMat4f::Multiply(transform->LocalTransform, *parent, transform->WorldTransform);
+			else
+				transform->WorldTransform = transform->LocalTransform;
+
+			if (FakeBoundsComponent *bounds = Registry.try_get<FakeBoundsComponent>(entity))
+				UpdateBounds(entity, *bounds, transform->WorldTransform);
+
+			if (const FakeHierarchyComponent *hierarchy = Registry.try_get<FakeHierarchyComponent>(entity))
+				{
+				for (entt::entity child = hierarchy->FirstChild; child != entt::null; child = Registry.get<FakeHierarchyComponent>(child).NextSibling)
+					TransformQueue.emplace_back(child, &transform->WorldTransform);
+				}
+			}
+		}
+
+	DirtyTransforms.clear();
+	CreatePendingProxies();
+	}
+
+void FakeScene::OnTransformConstructed(entt::registry &registry, entt::entity entity)
+	{
+	FakeTransformComponent &transform = registry.get<FakeTransformComponent>(entity);
+
+	std::scoped_lock lock(DirtyTransformsMutex);
+	transform.Dirty = true;
+	DirtyTransforms.push_back(entity);
+	}
+
+void FakeScene::OnTransformUpdated(entt::registry &registry, entt::entity entity)
+	{
+	// Workers of the job system patch transforms too, the flag is tested and set under the lock like in MarkTransformsDirty()
+	FakeTransformComponent &transform = registry.get<FakeTransformComponent>(entity);
+
+	std::scoped_lock lock(DirtyTransformsMutex);
+	if (transform.Dirty)
+		return;
+
+	transform.Dirty = true;
+	DirtyTransforms.push_back(entity);
+	}
+
+void FakeScene::OnBoundsConstructed(entt::registry &registry, entt::entity entity)
+	{
+	// Copied components must not share the proxy of their source
+	registry.get<FakeBoundsComponent>(entity).ProxyId = -1;
+
+	if (registry.has<FakeTransformComponent>(entity))
+		registry.patch<FakeTransformComponent>(entity);
+	}
+
+void FakeScene::OnBoundsUpdated(entt::registry &registry, entt::entity entity)
+	{
+	// The world bounds are recomputed together with the transform
+	if (registry.has<FakeTransformComponent>(entity))
+		registry.patch<FakeTransformComponent>(entity);
+	}
+
+void FakeScene::OnBoundsDestroyed(entt::registry &registry, entt::entity entity)
+	{
+	FakeBoundsComponent &bounds = registry.get<FakeBoundsComponent>(entity);
+	if (bounds.ProxyId == -1)
+		return;
+
+	if (SpatialIndexType == FakeSpatialIndexType::AABBTree)
+		SpatialTree.DestroyProxy(bounds.ProxyId);
+	else
+		SpatialQuadtree.Remove(bounds.ProxyId);
+
+	bounds.ProxyId = -1;
+	}
+
+void FakeScene::UpdateBounds(entt::entity entity, FakeBoundsComponent &bounds, const FakeMat4f &worldTransform)
+	{
+	FakeAABB worldBounds = FakeAABB::Transform(bounds.LocalBounds, worldTransform);
+	FakeVec3f displacement = worldBounds.GetCenter() - bounds.WorldBounds.GetCenter();
+	bounds.WorldBounds = worldBounds;
+
+	if (SpatialIndexType == FakeSpatialIndexType::AABBTree)
+		{
+		if (bounds.ProxyId == -1)
+			{
+			// Queued at most once, the transform is not dirty again until the proxy exists
+			NewProxyEntities.push_back(entity);
+			NewProxyBoxes.push_back(worldBounds);
+			}
+		else
+			{
+			SpatialTree.MoveProxy(bounds.ProxyId, worldBounds, displacement);
+			}
+		}
+	else
+		{
+		if (bounds.ProxyId == -1)
+			bounds.ProxyId = SpatialQuadtree.Insert(worldBounds, (uint32)entity);
+		else
+			SpatialQuadtree.Update(bounds.ProxyId, worldBounds);
+		}
+	}
+
+void FakeScene::CreatePendingProxies()
+	{
+	if (NewProxyEntities.empty())
+		return;
+
+	uint32 count = (uint32)NewProxyEntities.size();
+	NewProxyIds.resize(count);
+
+	// entt::entity is a plain 32 bit identifier, it is stored as the user data of the proxy
+	static_assert(sizeof(entt::entity) == sizeof(uint32));
+	SpatialTree.CreateProxies(NewProxyBoxes.data(), (const uint32*)NewProxyEntities.data(), count, NewProxyIds.data());
+
+	for (uint32 i = 0; i < count; ++i)
+		Registry.get<FakeBoundsComponent>(NewProxyEntities[i]).ProxyId = NewProxyIds[i];
+
+	NewProxyEntities.clear();
+	NewProxyBoxes.clear();
+	}
+
+void FakeScene::SetSpatialIndex(FakeSpatialIndexType type, const FakeAABB &worldBounds, uint32 quadtreeDepth)
+	{
+	SpatialTree.Clear();
+	SpatialQuadtree.Reset(worldBounds, quadtreeDepth);
+	SpatialIndexType = type;
+
+	// Entities which are still dirty get their proxy in the next UpdateTransforms()
+	auto view = Registry.view<FakeBoundsComponent>();
+	for (auto entity : view)
+		{
+		FakeBoundsComponent &bounds = view.get<FakeBoundsComponent>(entity);
+		if (bounds.ProxyId == -1)
+			continue;
+
+		if (type == FakeSpatialIndexType::AABBTree)
+			{
+			NewProxyEntities.push_back(entity);
+			NewProxyBoxes.push_back(bounds.WorldBounds);
+			}
+		else
+			{
+			bounds.ProxyId = SpatialQuadtree.Insert(bounds.WorldBounds, (uint32)entity);
+			}
+		}
+
+	// The tree is built in one go instead of inserting every proxy
+	CreatePendingProxies();
+	}
+
+void FakeScene::QueryBox(const FakeAABB &box, std::vector<FakeEntity> &outEntities)
+	{
+	auto collect = [this, &box, &outEntities](uint32 userData, int32)
+		{
+		entt::entity entity = (entt::entity)userData;
+		if (Registry.get<FakeBoundsComponent>(entity).WorldBounds.Intersects(box))
+			outEntities.emplace_back(entity, this);
+
+		return true;
+		};
+
+	if (SpatialIndexType == FakeSpatialIndexType::AABBTree)
+		SpatialTree.Query(box, collect);
+	else
+		SpatialQuadtree.Query(box, collect);
+	}
+
+void FakeScene::QueryRadius(const FakeVec3f &center, float radius, std::vector<FakeEntity> &outEntities)
+	{
+	auto collect = [this, &center, radius, &outEntities](uint32 userData, int32)
+		{
+		entt::entity entity = (entt::entity)userData;
+		if (Registry.get<FakeBoundsComponent>(entity).WorldBounds.IntersectsSphere(center, radius))
+			outEntities.emplace_back(entity, this);
+
+		return true;
+		};
+
+	if (SpatialIndexType == FakeSpatialIndexType::AABBTree)
+		SpatialTree.QueryRadius(center, radius, collect);
+	else
+		SpatialQuadtree.QueryRadius(center, radius, collect);
+	}
+
+void FakeScene::QueryFrustum(const FakeFrustum &frustum, std::vector<FakeEntity> &outEntities)
+	{
+	auto collect = [this, &frustum, &outEntities](uint32 userData, int32)
+		{
+		entt::entity entity = (entt::entity)userData;
+		if (frustum.Intersects(Registry.get<FakeBoundsComponent>(entity).WorldBounds))
+			outEntities.emplace_back(entity, this);
+
+		return true;
+		};
+
+	if (SpatialIndexType == FakeSpatialIndexType::AABBTree)
+		SpatialTree.Query(frustum, collect);
+	else
+		SpatialQuadtree.Query(frustum, collect);
+	}
+
+FakeEntity FakeScene::Raycast(const FakeRay &ray, float maxDistance, float *outDistance)
+	{
+	FakeEntity closestEntity;
+	float closestDistance = maxDistance;
+
+	// Every hit shortens the ray, so further subtrees are skipped
+	auto hit = [this, &ray, &closestEntity, &closestDistance](uint32 userData, int32)
+		{
+		entt::entity entity = (entt::entity)userData;
+		float distance;
+		if (ray.Intersects(Registry.get<FakeBoundsComponent>(entity).WorldBounds, distance) && distance <= closestDistance)
+			{
+			closestDistance = distance;
+			closestEntity = { entity, this };
+			}
+
+		return closestDistance;
+		};
+
+	if (SpatialIndexType == FakeSpatialIndexType::AABBTree)
+		SpatialTree.Raycast(ray, maxDistance, hit);
+	else
+		SpatialQuadtree.Raycast(ray, maxDistance, hit);
+
+	if (outDistance && closestEntity)
+		*outDistance = closestDistance;
+
+	return closestEntity;
+	}
+
+FakeEntity FakeScene::PickEntity(float x, float y, const FakeMat4f &viewProjection)
+	{
+	FakeRay ray = FakeRay::FromScreen(x, y, (float)ViewportWidth, (float)ViewportHeight, FakeMat4f::Inverse(viewProjection));
+	return Raycast(ray);
+	}
+
+void FakeScene::MarkTransformsDirty(const std::vector<entt::entity> &entities)
+	{
+	if (entities.empty())
+		return;
+
+	std::scoped_lock lock(DirtyTransformsMutex);
+	for (entt::entity entity : entities)
+		{
+		FakeTransformComponent &transform = Registry.get<FakeTransformComponent>(entity);
+		if (transform.Dirty)
+			continue;
+
+		transform.Dirty = true;
+		DirtyTransforms.push_back(entity);
+		}
+	}
+
+void FakeScene::UpdateSubtreeDepth(entt::entity root, uint32 depth)
+	{
+	FakeHierarchyComponent &hierarchy = Registry.get<FakeHierarchyComponent>(root);
+	hierarchy.Depth = depth;
+
+	for (entt::entity child = hierarchy.FirstChild; child != entt::null; child = Registry.get<FakeHierarchyComponent>(child).NextSibling)
+		UpdateSubtreeDepth(child, depth + 1);
+	}
+
+void FakeScene::DetachFromParent(entt::entity entity)
+	{
+	FakeHierarchyComponent *hierarchy = Registry.try_get<FakeHierarchyComponent>(entity);
+	if (!hierarchy || hierarchy->Parent == entt::null)
+		return;
+
+	FakeHierarchyComponent &parentHierarchy = Registry.get<FakeHierarchyComponent>(hierarchy->Parent);
+	if (parentHierarchy.FirstChild == entity)
+		{
+		parentHierarchy.FirstChild = hierarchy->NextSibling;
+		}
+	else
+		{
+		entt::entity sibling = parentHierarchy.FirstChild;
+		while (sibling != entt::null)
+			{
+			FakeHierarchyComponent &siblingHierarchy = Registry.get<FakeHierarchyComponent>(sibling);
+			if (siblingHierarchy.NextSibling == entity)
+				{
+				siblingHierarchy.NextSibling = hierarchy->NextSibling;
+				break;
+				}
+
+			sibling = siblingHierarchy.NextSibling;
+			}
+		}
+
+	hierarchy->Parent = entt::null;
+	hierarchy->NextSibling = entt::null;
+	HierarchyChanged = true;
+	}
+
 void FakeScene::OnRenderRuntime(FakeTimeStep ts)
 	{
 	// TODO:
 	// - Update scripts
-	// - Update physics
-	// - Get Camera instance and it's transform
-	// - Render 2D
-	// - 
+
+	Systems.Run(Registry, ts);
+
+	// The physics writes the interpolated poses directly, they are queued for the update all at once
+	Physics.Step(ts);
+	MarkTransformsDirty(Physics.GetMovedEntities());
+
+	UpdateTransforms();
+
+	FakeCamera *mainCamera = nullptr;
+	FakeMat4f cameraTransform;
+
+	auto view = Registry.view<FakeTransformComponent, FakeCameraComponent>();
+	for (auto entity : view)
+		{
+		auto [transform, camera] = view.get<FakeTransformComponent, FakeCameraComponent>(entity);
+		if (camera.Primary)
+			{
+			mainCamera = &camera.Camera;
+			cameraTransform = transform.WorldTransform;
+			break;
+			}
+		}
+
+	if (!mainCamera)
+		return;
+
+	RenderSprites(FakeMat4f::Inverse(cameraTransform) * mainCamera->GetProjectionMatrix());
 	}
 
 void FakeScene::OnRenderEditor(FakeTimeStep ts)
 	{
-	OnRenderEditor(ts, GetPrimaryCamera());
+	// The primary camera looks from the world transform of its entity
+	UpdateTransforms();
+
+	FakeEntity cameraEntity = GetPrimaryCameraEntity();
+	const FakeMat4f &cameraTransform = cameraEntity.GetComponent<FakeTransformComponent>().WorldTransform;
+	OnRenderEditor(ts, cameraEntity.GetComponent<FakeCameraComponent>().Camera, FakeMat4f::Inverse(cameraTransform));
 	}
 
-void FakeScene::OnRenderEditor(FakeTimeStep ts, FakeCamera &camera)
+void FakeScene::OnRenderEditor(FakeTimeStep ts, const FakeCamera &camera, const FakeMat4f &viewMatrix)
 	{
 	// TODO:
 	// - Update Physics
-	// - Render 2D
-	// - 
+
+	UpdateTransforms();
+	RenderSprites(viewMatrix * camera.GetProjectionMatrix());
 	}
 
 void FakeScene::OnViewportResize(uint32 width, uint32 height)
@@ -70,6 +559,64 @@ void FakeScene::OnViewportResize(uint32 width, uint32 height)
 		}
 	}
 
+void FakeScene::RenderSprites(const FakeMat4f &viewProjection)
+	{
+	// Expects UpdateTransforms() to have run, the cached world transforms are used as they are
+	// A full owning group keeps both components packed in the same order
+	auto group = Registry.group<FakeTransformComponent, FakeSpriteComponent>();
+	uint32 count = (uint32)group.size();
+
+	FakeRenderer2D::BeginScene(viewProjection);
+
+	if (count)
+		{
+		const FakeTransformComponent *transforms = group.raw<FakeTransformComponent>();
+		FakeSpriteComponent *sprites = group.raw<FakeSpriteComponent>();
+
+		SpriteOrder.resize(count);
+		SpriteOrderScratch.resize(count);
+		SpriteDrawList.resize(count);
+		SpriteTextureRanks.clear();
+
+		// Key: texture rank in the upper 32 bits, depth in the lower 32 bits
+		FakeTexture2D *lastTexture = nullptr;
+		uint64 lastRank = 0;
+		for (uint32 i = 0; i < count; ++i)
+			{
+			FakeTexture2D *texture = sprites[i].Texture.Raw();
+			if (texture != lastTexture)
+				{
+				lastRank = texture ? SpriteTextureRanks.emplace(texture, (uint32)SpriteTextureRanks.size() + 1).first->second : 0;
+				lastTexture = texture;
+				}
+
+			// Flip the bits of the float so the unsigned order matches the float order
+			uint32 depth;
+			memcpy(&depth, &transforms[i].WorldTransform.M43, sizeof(uint32));
+			depth = (depth & 0x80000000u) ? ~depth : (depth | 0x80000000u);
+
+			SpriteOrder[i].Key = (lastRank << 32) | depth;
+			SpriteOrder[i].Value = i;
+			}
+
+		fake_radix_sort(SpriteOrder.data(), SpriteOrderScratch.data(), count);
+
+		for (uint32 i = 0; i < count; ++i)
+			{
+			uint32 index = SpriteOrder[i].Value;
+			FakeRenderer2D::Sprite &sprite = SpriteDrawList[i];
+			sprite.Transform = &transforms[index].WorldTransform;
+			sprite.Color = &sprites[index].Color;
+			sprite.Texture = sprites[index].Texture.Raw();
+			sprite.TilingFactor = sprites[index].TilingFactor;
+			}
+
+		FakeRenderer2D::DrawSprites(SpriteDrawList.data(), count);
+		}
+
+	FakeRenderer2D::EndScene();
+	}
+
 FakeEntity FakeScene::GetPrimaryCameraEntity()
 	{
 	auto view = Registry.view<FakeCameraComponent>();
@@ -90,29 +637,9 @@ FakeCamera &FakeScene::GetPrimaryCamera()
 	return GetPrimaryCameraEntity().GetComponent<FakeCameraComponent>().Camera;
 	}
 
-template<typename T>
-void FakeScene::OnComponentAdded(FakeEntity entity, T &component)
-	{
-	}
-
-template<>
-void FakeScene::OnComponentAdded(FakeEntity entity, FakeTagComponent &component)
-	{
-	}
-
-template<>
-void FakeScene::OnComponentAdded(FakeEntity entity, FakeTransformComponent &component)
-	{
-	}
-
 template<>
 void FakeScene::OnComponentAdded(FakeEntity entity, FakeCameraComponent &component)
 	{
 	component.Camera.SetViewport(ViewportWidth, ViewportHeight);
 	}
 
-template<>
-void FakeScene::OnComponentAdded(FakeEntity entity, FakeSpriteComponent &component)
-	{
-	}
-
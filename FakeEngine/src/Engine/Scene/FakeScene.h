@@ -22,11 +22,27 @@
 
 #pragma once
 
+#include <mutex>
 #include <entt/entt.hpp>
 #include "Engine/Core/FakeTimeStep.h"
+#include "Engine/Core/DataTypes/FakeRadixSort.h"
+#include "Engine/Core/Spatial/FakeDynamicAABBTree.h"
+#include "Engine/Core/Spatial/FakeLooseQuadtree.h"
+#include "Engine/Renderer/FakeRenderer2D.h"
+#include "Engine/Physics/FakePhysicsWorld.h"
 #include "FakeCamera.h"
+#include "FakeSystemScheduler.h"
 
 class FakeEntity;
+class FakePrefab;
+struct FakeBoundsComponent;
+struct FakeTransformComponent;
+
+enum class FakeSpatialIndexType
+	{
+	AABBTree = 0,
+	LooseQuadtree
+	};
 
 /**
  * 
@@ -40,8 +56,56 @@ class FAKE_API FakeScene
 		uint32 ViewportWidth = 0;
 		uint32 ViewportHeight = 0;
 
+		FakeSystemScheduler Systems;
+		FakePhysicsWorld Physics;
+
+		// Transforms modified since the last UpdateTransforms(), each entity is queued at most once.
+		// Systems patch transforms from worker threads, so the queue is guarded.
+		std::mutex DirtyTransformsMutex;
+		std::vector<entt::entity> DirtyTransforms;
+		std::vector<FakeSortItem> DirtyOrder;
+		std::vector<FakeSortItem> DirtyOrderScratch;
+		std::vector<std::pair<entt::entity, const FakeMat4f*>> TransformQueue;
+		bool HierarchyChanged = false;
+
+		// Entities with a FakeBoundsComponent, kept in sync by UpdateTransforms()
+		FakeSpatialIndexType SpatialIndexType = FakeSpatialIndexType::AABBTree;
+		FakeDynamicAABBTree SpatialTree;
+		FakeLooseQuadtree SpatialQuadtree;
+
+		// Entities which need a new proxy in the AABB tree, inserted together after the transforms
+		std::vector<entt::entity> NewProxyEntities;
+		std::vector<FakeAABB> NewProxyBoxes;
+		std::vector<int32> NewProxyIds;
+
+		// Per frame scratch memory of the sprite pass, kept to avoid reallocations
+		std::vector<FakeSortItem> SpriteOrder;
+		std::vector<FakeSortItem> SpriteOrderScratch;
+		std::vector<FakeRenderer2D::Sprite> SpriteDrawList;
+		std::unordered_map<FakeTexture2D*, uint32> SpriteTextureRanks;
+
+		// Entities created by the last Instantiate()
+		std::vector<entt::entity> SpawnedEntities;
+
 		friend class FakeEntity;
+		friend class FakePrefab;
+		friend class FakeSceneSerializer;
+		friend class FakeSceneBinarySerializer;
+
+		void RenderSprites(const FakeMat4f &viewProjection);
 
+		void OnTransformConstructed(entt::registry &registry, entt::entity entity);
+		void OnTransformUpdated(entt::registry &registry, entt::entity entity);
+		void OnBoundsConstructed(entt::registry &registry, entt::entity entity);
+		void OnBoundsUpdated(entt::registry &registry, entt::entity entity);
+		void OnBoundsDestroyed(entt::registry &registry, entt::entity entity);
+		void UpdateBounds(entt::entity entity, FakeBoundsComponent &bounds, const FakeMat4f &worldTransform);
+		void CreatePendingProxies();
+		void MarkTransformsDirty(const std::vector<entt::entity> &entities);
+		void UpdateSubtreeDepth(entt::entity root, uint32 depth);
+		void DetachFromParent(entt::entity entity);
+
+		// Defined in FakeEntity.h, specialized for components which need to know about the scene
 		template<typename T>
 		void OnComponentAdded(FakeEntity entity, T &component);
 
@@ -54,11 +118,135 @@ class FAKE_API FakeScene
 		FakeEntity CreateEntity(const FakeString &name = "");
 		void DestroyEntity(FakeEntity entity);
 
+		/**
+		 *
+		 * Creates many entities from a prefab at once, every component is inserted as a single range.
+		 * Much faster than calling CreateEntity() and AddComponent() for each entity when spawning bullets or crowds.
+		 *
+		 * @param prefab The components copied into every new entity.
+		 * @param count The number of entities to create.
+		 * @param transforms One transform per entity which replaces the transform of the prefab, can be nullptr.
+		 * @param outEntities The new entities are appended to this list, can be nullptr.
+		 */
+		void Instantiate(const FakePrefab &prefab, uint32 count, const FakeTransformComponent *transforms = nullptr, std::vector<FakeEntity> *outEntities = nullptr);
+
+		/**
+		 *
+		 * Attaches the child to the parent, the child keeps its local transform.
+		 *
+		 * @param child The entity to attach.
+		 * @param parent The new parent, an invalid entity detaches the child.
+		 */
+		void SetParent(FakeEntity child, FakeEntity parent);
+		FakeEntity GetParent(FakeEntity entity);
+
+		/**
+		 *
+		 * Queues the transform of the entity and its children for the next UpdateTransforms().
+		 * Only needed after writing to FakeTransformComponent directly instead of using FakeEntity::PatchComponent().
+		 *
+		 * @param entity The entity whose transform has been changed.
+		 */
+		void MarkTransformDirty(FakeEntity entity);
+
+		/**
+		 *
+		 * Recomputes the cached local and world transforms of all dirty entities and their children,
+		 * parents are always updated before their children. Returns immediately if nothing has changed.
+		 *
+		 */
+		void UpdateTransforms();
+
+		/**
+		 *
+		 * Selects the structure of the spatial index and moves all bounds into it.
+		 * The AABB tree adapts to any scene, the loose quadtree is cheaper to update for 2D scenes inside known bounds.
+		 *
+		 * @param type The new index structure.
+		 * @param worldBounds The area covered by the loose quadtree, ignored by the AABB tree.
+		 * @param quadtreeDepth The number of quadtree levels below the root, the smallest cells should be about the size of the smallest objects.
+		 */
+		void SetSpatialIndex(FakeSpatialIndexType type, const FakeAABB &worldBounds = FakeAABB(FakeVec3f(-1024.0f, -1024.0f, -1024.0f), FakeVec3f(1024.0f, 1024.0f, 1024.0f)), uint32 quadtreeDepth = 8);
+		FakeSpatialIndexType GetSpatialIndexType() const { return SpatialIndexType; }
+
+		/**
+		 *
+		 * Collects all entities with a FakeBoundsComponent whose world bounds overlap the box.
+		 * The spatial queries see the state of the last UpdateTransforms().
+		 *
+		 * @param box The box in world space.
+		 * @param outEntities The found entities are appended to this list.
+		 */
+		void QueryBox(const FakeAABB &box, std::vector<FakeEntity> &outEntities);
+
+		/**
+		 *
+		 * Collects all entities whose world bounds overlap the sphere.
+		 *
+		 * @param center The center of the sphere in world space.
+		 * @param radius The radius of the sphere.
+		 * @param outEntities The found entities are appended to this list.
+		 */
+		void QueryRadius(const FakeVec3f &center, float radius, std::vector<FakeEntity> &outEntities);
+
+		/**
+		 *
+		 * Collects all entities whose world bounds are at least partially inside the frustum, e.g. FakeFrustum(view * camera.GetProjectionMatrix()).
+		 *
+		 * @param frustum The frustum in world space.
+		 * @param outEntities The found entities are appended to this list.
+		 */
+		void QueryFrustum(const FakeFrustum &frustum, std::vector<FakeEntity> &outEntities);
+
+		/**
+		 *
+		 * Finds the closest entity whose world bounds are hit by the ray.
+		 *
+		 * @param ray The ray in world space.
+		 * @param maxDistance Hits further away than this are ignored.
+		 * @param outDistance Receives the distance along the ray to the hit, can be nullptr.
+		 * @return Returns the closest entity or an invalid entity if nothing was hit.
+		 */
+		FakeEntity Raycast(const FakeRay &ray, float maxDistance = std::numeric_limits<float>::max(), float *outDistance = nullptr);
+
+		/**
+		 *
+		 * Picks the entity under a position in the viewport, used by the editor for mouse selection.
+		 *
+		 * @param x The horizontal position in pixels, starting at the left.
+		 * @param y The vertical position in pixels, starting at the top.
+		 * @param viewProjection The view projection matrix the scene has been rendered with.
+		 * @return Returns the closest entity or an invalid entity if nothing was hit.
+		 */
+		FakeEntity PickEntity(float x, float y, const FakeMat4f &viewProjection);
+
+		/**
+		 *
+		 * Adds a system which runs every frame in OnRenderRuntime(), before the transforms are updated.
+		 *
+		 * @param args The arguments passed to the constructor of the system.
+		 * @return Returns the new system.
+		 */
+		template<typename T, typename... Args>
+		T &AddSystem(Args&&... args)
+			{
+			return Systems.Add<T>(std::forward<Args>(args)...);
+			}
+
+		FakeSystemScheduler &GetSystemScheduler() { return Systems; }
+		FakePhysicsWorld &GetPhysicsWorld() { return Physics; }
+
 		void OnRenderRuntime(FakeTimeStep ts);
 		void OnRenderEditor(FakeTimeStep ts);
-		void OnRenderEditor(FakeTimeStep ts, FakeCamera &camera);
+		void OnRenderEditor(FakeTimeStep ts, const FakeCamera &camera, const FakeMat4f &viewMatrix);
 		void OnViewportResize(uint32 width, uint32 height);
 
 		FakeEntity GetPrimaryCameraEntity();
 		FakeCamera &GetPrimaryCamera();
 	};
+
+struct FakeCameraComponent;
+
+template<>
+void FakeScene::OnComponentAdded(FakeEntity entity, FakeCameraComponent &component);
+
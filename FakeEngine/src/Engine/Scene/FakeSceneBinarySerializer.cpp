@@ -0,0 +1,841 @@
+#include "FakePch.h"
+#include "FakeSceneBinarySerializer.h"
+
+#include <fstream>
+
+#include "FakeScene.h"
+#include "Engine/Core/FakeMappedFile.h"
+#include "Components/FakeComponents.h"
+
+static const uint64 ChunkAlignment = 16;
+static const uint32 InvalidIndex = ~0u;
+
+// Set when the records belong to the entities 0..Count-1 in order, the chunk then has no index array
+static const uint32 ChunkDense = 1;
+
+enum class FakeSceneChunkType : uint32
+	{
+	Strings = 0,
+	Transform,
+	Tag,
+	Hierarchy,
+	Sprite,
+	Camera,
+	Bounds,
+	Rigidbody,
+	BoxCollider,
+	CircleCollider
+	};
+
+struct FakeSceneFileHeader
+	{
+	uint32 Magic;
+	uint32 Version;
+	uint32 EntityCount;
+	uint32 ChunkCount;
+	};
+
+struct FakeSceneFileChunk
+	{
+	uint32 Type;
+	uint32 Flags;
+	uint32 Count;
+	uint32 RecordSize;
+	uint64 IndexOffset;
+	uint64 DataOffset;
+	};
+
+// Strings are stored as offsets into the strings chunk, entities as indices into the entities of the file
+struct FakeTransformRecord
+	{
+	float Translation[3];
+	float Rotation[3];
+	float Scale[3];
+	};
+
+struct FakeTagRecord
+	{
+	uint32 Name;
+	};
+
+struct FakeHierarchyRecord
+	{
+	uint32 Parent;
+	uint32 FirstChild;
+	uint32 NextSibling;
+	uint32 Depth;
+	};
+
+struct FakeSpriteRecord
+	{
+	float Color[4];
+	float TilingFactor;
+	uint32 TexturePath;
+	};
+
+struct FakeCameraRecord
+	{
+	uint32 ProjectionType;
+	float PerspectiveFOV;
+	float PerspectiveNear;
+	float PerspectiveFar;
+	float OrthographicSize;
+	float OrthographicNear;
+	float OrthographicFar;
+	float Exposure;
+	uint8 Primary;
+	uint8 FixedAspectRatio;
+	uint8 Padding[2];
+	};
+
+struct FakeBoundsRecord
+	{
+	float Min[3];
+	float Max[3];
+	};
+
+struct FakeRigidbodyRecord
+	{
+	uint32 Type;
+	float GravityScale;
+	float LinearDamping;
+	float AngularDamping;
+	uint8 FixedRotation;
+	uint8 Bullet;
+	uint8 Padding[2];
+	};
+
+struct FakeBoxColliderRecord
+	{
+	float Offset[2];
+	float Size[2];
+	float Density;
+	float Friction;
+	float Restitution;
+	uint32 IsSensor;
+	};
+
+struct FakeCircleColliderRecord
+	{
+	float Offset[2];
+	float Radius;
+	float Density;
+	float Friction;
+	float Restitution;
+	uint32 IsSensor;
+	};
+
+static_assert(std::is_trivially_copyable_v<FakeTransformRecord> && sizeof(FakeTransformRecord) == 36);
+static_assert(std::is_trivially_copyable_v<FakeTagRecord> && sizeof(FakeTagRecord) == 4);
+static_assert(std::is_trivially_copyable_v<FakeHierarchyRecord> && sizeof(FakeHierarchyRecord) == 16);
+static_assert(std::is_trivially_copyable_v<FakeSpriteRecord> && sizeof(FakeSpriteRecord) == 24);
+static_assert(std::is_trivially_copyable_v<FakeCameraRecord> && sizeof(FakeCameraRecord) == 36);
+static_assert(std::is_trivially_copyable_v<FakeBoundsRecord> && sizeof(FakeBoundsRecord) == 24);
+static_assert(std::is_trivially_copyable_v<FakeRigidbodyRecord> && sizeof(FakeRigidbodyRecord) == 20);
+static_assert(std::is_trivially_copyable_v<FakeBoxColliderRecord> && sizeof(FakeBoxColliderRecord) == 32);
+static_assert(std::is_trivially_copyable_v<FakeCircleColliderRecord> && sizeof(FakeCircleColliderRecord) == 28);
+
+/**
+ *
+ * Converts records while the registry copies them into its pools, so a whole chunk is inserted as one range.
+ *
+ */
+template<typename Record, typename Convert>
+class FakeRecordIterator
+	{
+	private:
+		const Record *Current;
+		const Convert *Function;
+
+	public:
+
+		using iterator_category = std::random_access_iterator_tag;
+		using value_type = std::decay_t<std::invoke_result_t<const Convert&, const Record&>>;
+		using difference_type = std::ptrdiff_t;
+		using pointer = const value_type*;
+		using reference = value_type;
+
+		FakeRecordIterator(const Record *current, const Convert *function)
+			: Current(current), Function(function)
+			{
+			}
+
+		value_type operator*() const { return (*Function)(*Current); }
+		value_type operator[](difference_type offset) const { return (*Function)(Current[offset]); }
+
+		FakeRecordIterator &operator++() { ++Current; return *this; }
+		FakeRecordIterator operator++(int) { FakeRecordIterator result = *this; ++Current; return result; }
+		FakeRecordIterator &operator--() { --Current; return *this; }
+		FakeRecordIterator operator--(int) { FakeRecordIterator result = *this; --Current; return result; }
+
+		FakeRecordIterator &operator+=(difference_type offset) { Current += offset; return *this; }
+		FakeRecordIterator &operator-=(difference_type offset) { Current -= offset; return *this; }
+		FakeRecordIterator operator+(difference_type offset) const { return FakeRecordIterator(Current + offset, Function); }
+		FakeRecordIterator operator-(difference_type offset) const { return FakeRecordIterator(Current - offset, Function); }
+		difference_type operator-(const FakeRecordIterator &other) const { return Current - other.Current; }
+
+		bool operator==(const FakeRecordIterator &other) const { return Current == other.Current; }
+		bool operator!=(const FakeRecordIterator &other) const { return Current != other.Current; }
+		bool operator<(const FakeRecordIterator &other) const { return Current < other.Current; }
+		bool operator>(const FakeRecordIterator &other) const { return Current > other.Current; }
+		bool operator<=(const FakeRecordIterator &other) const { return Current <= other.Current; }
+		bool operator>=(const FakeRecordIterator &other) const { return Current >= other.Current; }
+	};
+
+/**
+ *
+ * Builds the chunks of a file, the offsets are relative to the first chunk until the header is known.
+ *
+ */
+class FakeSceneFileWriter
+	{
+	private:
+		entt::registry &Registry;
+		std::vector<uint32> EntityIndices;
+		uint32 EntityCount = 0;
+
+		std::vector<Byte> Body;
+		std::vector<FakeSceneFileChunk> Chunks;
+
+		std::vector<char> Strings;
+		std::unordered_map<std::string, uint32> StringOffsets;
+
+		template<typename T>
+		T *Allocate(uint32 count, uint64 &outOffset)
+			{
+			outOffset = (Body.size() + ChunkAlignment - 1) & ~(ChunkAlignment - 1);
+			Body.resize(outOffset + (uint64)count * sizeof(T));
+			return (T*)&Body[outOffset];
+			}
+
+	public:
+
+		FakeSceneFileWriter(entt::registry &registry)
+			: Registry(registry), EntityIndices(registry.size(), InvalidIndex)
+			{
+			}
+
+		uint32 AddEntity(entt::entity entity)
+			{
+			uint32 &index = EntityIndices[entt::to_integral(entity) & entt::entt_traits<std::underlying_type_t<entt::entity>>::entity_mask];
+			index = EntityCount++;
+			return index;
+			}
+
+		uint32 GetEntityIndex(entt::entity entity) const
+			{
+			if (entity == entt::null)
+				return InvalidIndex;
+
+			return EntityIndices[entt::to_integral(entity) & entt::entt_traits<std::underlying_type_t<entt::entity>>::entity_mask];
+			}
+
+		uint32 AddString(const FakeString &string)
+			{
+			std::string key = string.IsEmpty() ? std::string() : std::string(*string);
+
+			auto it = StringOffsets.find(key);
+			if (it != StringOffsets.end())
+				return it->second;
+
+			uint32 offset = (uint32)Strings.size();
+			Strings.insert(Strings.end(), key.c_str(), key.c_str() + key.size() + 1);
+			StringOffsets.emplace(std::move(key), offset);
+			return offset;
+			}
+
+		template<typename T, typename Record, typename Convert>
+		void WriteChunk(FakeSceneChunkType type, Convert convert)
+			{
+			uint32 count = (uint32)Registry.size<T>();
+			if (count == 0)
+				return;
+
+			const entt::entity *owners = Registry.data<T>();
+			const T *components = Registry.raw<T>();
+
+			FakeSceneFileChunk chunk = {};
+			chunk.Type = (uint32)type;
+			chunk.Count = count;
+			chunk.RecordSize = sizeof(Record);
+			chunk.Flags = ChunkDense;
+
+			for (uint32 i = 0; i < count; ++i)
+				{
+				if (GetEntityIndex(owners[i]) != i)
+					{
+					chunk.Flags = 0;
+					break;
+					}
+				}
+
+			if (!(chunk.Flags & ChunkDense))
+				{
+				uint32 *indices = Allocate<uint32>(count, chunk.IndexOffset);
+				for (uint32 i = 0; i < count; ++i)
+					indices[i] = GetEntityIndex(owners[i]);
+				}
+
+			Record *records = Allocate<Record>(count, chunk.DataOffset);
+			for (uint32 i = 0; i < count; ++i)
+				records[i] = convert(components[i]);
+
+			Chunks.push_back(chunk);
+			}
+
+		void Finish(std::vector<Byte> &outData)
+			{
+			if (!Strings.empty())
+				{
+				FakeSceneFileChunk chunk = {};
+				chunk.Type = (uint32)FakeSceneChunkType::Strings;
+				chunk.Flags = ChunkDense;
+				chunk.Count = (uint32)Strings.size();
+				chunk.RecordSize = 1;
+				memcpy(Allocate<char>(chunk.Count, chunk.DataOffset), Strings.data(), Strings.size());
+
+				// First in the chunk table, the other chunks reference it
+				Chunks.insert(Chunks.begin(), chunk);
+				}
+
+			uint64 base = sizeof(FakeSceneFileHeader) + Chunks.size() * sizeof(FakeSceneFileChunk);
+			base = (base + ChunkAlignment - 1) & ~(ChunkAlignment - 1);
+
+			for (FakeSceneFileChunk &chunk : Chunks)
+				{
+				chunk.DataOffset += base;
+				if (!(chunk.Flags & ChunkDense))
+					chunk.IndexOffset += base;
+				}
+
+			FakeSceneFileHeader header = {};
+			header.Magic = FakeSceneBinarySerializer::Magic;
+			header.Version = FakeSceneBinarySerializer::Version;
+			header.EntityCount = EntityCount;
+			header.ChunkCount = (uint32)Chunks.size();
+
+			outData.assign(base + Body.size(), 0);
+			memcpy(outData.data(), &header, sizeof(header));
+			memcpy(outData.data() + sizeof(header), Chunks.data(), Chunks.size() * sizeof(FakeSceneFileChunk));
+			memcpy(outData.data() + base, Body.data(), Body.size());
+			}
+	};
+
+namespace Utils
+	{
+	static uint32 fake_record_size(FakeSceneChunkType type)
+		{
+		switch (type)
+			{
+			case FakeSceneChunkType::Strings: return 1;
+			case FakeSceneChunkType::Transform: return sizeof(FakeTransformRecord);
+			case FakeSceneChunkType::Tag: return sizeof(FakeTagRecord);
+			case FakeSceneChunkType::Hierarchy: return sizeof(FakeHierarchyRecord);
+			case FakeSceneChunkType::Sprite: return sizeof(FakeSpriteRecord);
+			case FakeSceneChunkType::Camera: return sizeof(FakeCameraRecord);
+			case FakeSceneChunkType::Bounds: return sizeof(FakeBoundsRecord);
+			case FakeSceneChunkType::Rigidbody: return sizeof(FakeRigidbodyRecord);
+			case FakeSceneChunkType::BoxCollider: return sizeof(FakeBoxColliderRecord);
+			case FakeSceneChunkType::CircleCollider: return sizeof(FakeCircleColliderRecord);
+			}
+
+		return 0;
+		}
+
+	// UpdateTransforms() follows the parents and the child lists, both must end
+	static bool fake_validate_hierarchy(const Byte *data, const FakeSceneFileHeader &header, const FakeSceneFileChunk &chunk)
+		{
+		const FakeHierarchyRecord *records = (const FakeHierarchyRecord*)(data + chunk.DataOffset);
+		const uint32 *indices = (chunk.Flags & ChunkDense) ? nullptr : (const uint32*)(data + chunk.IndexOffset);
+
+		std::vector<const FakeHierarchyRecord*> hierarchies(header.EntityCount, nullptr);
+		for (uint32 i = 0; i < chunk.Count; ++i)
+			hierarchies[indices ? indices[i] : i] = &records[i];
+
+		// An entity is listed once, as a child of its own parent
+		std::vector<bool> listed(header.EntityCount);
+		for (uint32 entity = 0; entity < header.EntityCount; ++entity)
+			{
+			if (!hierarchies[entity])
+				continue;
+
+			for (uint32 child = hierarchies[entity]->FirstChild; child != InvalidIndex; child = hierarchies[child]->NextSibling)
+				{
+				if (!hierarchies[child] || hierarchies[child]->Parent != entity || listed[child])
+					return false;
+
+				listed[child] = true;
+				}
+			}
+
+		// 0 not visited yet, 1 on the current path, 2 reaches a root
+		std::vector<uint8> states(header.EntityCount, 0);
+		for (uint32 entity = 0; entity < header.EntityCount; ++entity)
+			{
+			uint32 current = entity;
+			while (current != InvalidIndex && hierarchies[current] && states[current] == 0)
+				{
+				states[current] = 1;
+				current = hierarchies[current]->Parent;
+				}
+
+			if (current != InvalidIndex && states[current] == 1)
+				return false;
+
+			for (uint32 ancestor = entity; ancestor != current; ancestor = hierarchies[ancestor]->Parent)
+				states[ancestor] = 2;
+			}
+
+		return true;
+		}
+
+	static bool fake_validate_chunk(const Byte *data, uint64 size, const FakeSceneFileHeader &header, const FakeSceneFileChunk &chunk, uint64 stringsSize)
+		{
+		if (chunk.Type > (uint32)FakeSceneChunkType::CircleCollider)
+			return false;
+
+		FakeSceneChunkType type = (FakeSceneChunkType)chunk.Type;
+		if (chunk.RecordSize != fake_record_size(type))
+			return false;
+
+		uint64 dataSize = (uint64)chunk.Count * chunk.RecordSize;
+		if (chunk.DataOffset % ChunkAlignment != 0 || chunk.DataOffset > size || dataSize > size - chunk.DataOffset)
+			return false;
+
+		if (type == FakeSceneChunkType::Strings)
+			return chunk.Count > 0 && data[chunk.DataOffset + chunk.Count - 1] == '\0';
+
+		if (chunk.Flags & ChunkDense)
+			{
+			if (chunk.Count > header.EntityCount)
+				return false;
+			}
+		else
+			{
+			uint64 indexSize = (uint64)chunk.Count * sizeof(uint32);
+			if (chunk.IndexOffset % ChunkAlignment != 0 || chunk.IndexOffset > size || indexSize > size - chunk.IndexOffset)
+				return false;
+
+			// An entity can only get a component once
+			std::vector<bool> used(header.EntityCount);
+			const uint32 *indices = (const uint32*)(data + chunk.IndexOffset);
+			for (uint32 i = 0; i < chunk.Count; ++i)
+				{
+				if (indices[i] >= header.EntityCount || used[indices[i]])
+					return false;
+
+				used[indices[i]] = true;
+				}
+			}
+
+		// Records which point into other data of the file
+		const Byte *records = data + chunk.DataOffset;
+		switch (type)
+			{
+			case FakeSceneChunkType::Tag:
+				for (uint32 i = 0; i < chunk.Count; ++i)
+					{
+					if (((const FakeTagRecord*)records)[i].Name >= stringsSize)
+						return false;
+					}
+				break;
+
+			case FakeSceneChunkType::Sprite:
+				for (uint32 i = 0; i < chunk.Count; ++i)
+					{
+					uint32 path = ((const FakeSpriteRecord*)records)[i].TexturePath;
+					if (path != InvalidIndex && path >= stringsSize)
+						return false;
+					}
+				break;
+
+			case FakeSceneChunkType::Hierarchy:
+				for (uint32 i = 0; i < chunk.Count; ++i)
+					{
+					const FakeHierarchyRecord &record = ((const FakeHierarchyRecord*)records)[i];
+					if ((record.Parent != InvalidIndex && record.Parent >= header.EntityCount)
+						|| (record.FirstChild != InvalidIndex && record.FirstChild >= header.EntityCount)
+						|| (record.NextSibling != InvalidIndex && record.NextSibling >= header.EntityCount))
+						return false;
+					}
+
+				if (!fake_validate_hierarchy(data, header, chunk))
+					return false;
+				break;
+
+			default:
+				break;
+			}
+
+		return true;
+		}
+
+	template<typename T, typename Record, typename Convert>
+	static void fake_insert_chunk(entt::registry &registry, const std::vector<entt::entity> &entities, const Byte *data, const FakeSceneFileChunk &chunk, Convert convert)
+		{
+		const Record *records = (const Record*)(data + chunk.DataOffset);
+		FakeRecordIterator<Record, Convert> first(records, &convert);
+		FakeRecordIterator<Record, Convert> last(records + chunk.Count, &convert);
+
+		if (chunk.Flags & ChunkDense)
+			{
+			registry.insert<T>(entities.begin(), entities.begin() + chunk.Count, first, last);
+			return;
+			}
+
+		auto lookup = [&entities](uint32 index) { return entities[index]; };
+		const uint32 *indices = (const uint32*)(data + chunk.IndexOffset);
+		FakeRecordIterator<uint32, decltype(lookup)> firstEntity(indices, &lookup);
+		FakeRecordIterator<uint32, decltype(lookup)> lastEntity(indices + chunk.Count, &lookup);
+		registry.insert<T>(firstEntity, lastEntity, first, last);
+		}
+	}
+
+FakeSceneBinarySerializer::FakeSceneBinarySerializer(FakeScene &scene)
+	: Scene(scene)
+	{
+	}
+
+bool FakeSceneBinarySerializer::Serialize(const FakeString &path)
+	{
+	std::vector<Byte> data;
+	Serialize(data);
+
+	std::ofstream stream(*path, std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!stream)
+		{
+		FAKE_LOG_ERROR("Could not open scene file %s for writing!", *path);
+		return false;
+		}
+
+	stream.write((const char*)data.data(), (std::streamsize)data.size());
+	return stream.good();
+	}
+
+void FakeSceneBinarySerializer::Serialize(std::vector<Byte> &outData)
+	{
+	entt::registry &registry = Scene.Registry;
+	FakeSceneFileWriter writer(registry);
+
+	// Entities in the order of the transform pool, so the largest chunks need no index array
+	const entt::entity *transformEntities = registry.data<FakeTransformComponent>();
+	for (uint32 i = 0, count = (uint32)registry.size<FakeTransformComponent>(); i < count; ++i)
+		writer.AddEntity(transformEntities[i]);
+
+	registry.each([&writer](entt::entity entity)
+		{
+		if (writer.GetEntityIndex(entity) == InvalidIndex)
+			writer.AddEntity(entity);
+		});
+
+	writer.WriteChunk<FakeTransformComponent, FakeTransformRecord>(FakeSceneChunkType::Transform, [](const FakeTransformComponent &transform)
+		{
+		return FakeTransformRecord {
+			{ transform.Translation.X, transform.Translation.Y, transform.Translation.Z },
+			{ transform.Rotation.X, transform.Rotation.Y, transform.Rotation.Z },
+			{ transform.Scale.X, transform.Scale.Y, transform.Scale.Z }
+			};
+		});
+
+	writer.WriteChunk<FakeTagComponent, FakeTagRecord>(FakeSceneChunkType::Tag, [&writer](const FakeTagComponent &tag)
+		{
+		return FakeTagRecord { writer.AddString(tag.GetTag()) };
+		});
+
+	writer.WriteChunk<FakeHierarchyComponent, FakeHierarchyRecord>(FakeSceneChunkType::Hierarchy, [&writer](const FakeHierarchyComponent &hierarchy)
+		{
+		return FakeHierarchyRecord {
+			writer.GetEntityIndex(hierarchy.Parent),
+			writer.GetEntityIndex(hierarchy.FirstChild),
+			writer.GetEntityIndex(hierarchy.NextSibling),
+			hierarchy.Depth
+			};
+		});
+
+	writer.WriteChunk<FakeSpriteComponent, FakeSpriteRecord>(FakeSceneChunkType::Sprite, [&writer](const FakeSpriteComponent &sprite)
+		{
+		return FakeSpriteRecord {
+			{ sprite.Color.X, sprite.Color.Y, sprite.Color.Z, sprite.Color.W },
+			sprite.TilingFactor,
+			sprite.Texture ? writer.AddString(sprite.Texture->GetPath()) : InvalidIndex
+			};
+		});
+
+	writer.WriteChunk<FakeCameraComponent, FakeCameraRecord>(FakeSceneChunkType::Camera, [](const FakeCameraComponent &component)
+		{
+		const FakeCamera &camera = component.Camera;
+
+		FakeCameraRecord record = {};
+		record.ProjectionType = (uint32)camera.GetProjectionType();
+		record.PerspectiveFOV = camera.GetPerspectiveFOV();
+		record.PerspectiveNear = camera.GetPerspectiveNearClip();
+		record.PerspectiveFar = camera.GetPerspectiveFar();
+		record.OrthographicSize = camera.GetOrthographicSize();
+		record.OrthographicNear = camera.GetOrthographicNear();
+		record.OrthographicFar = camera.GetOrthographicFar();
+		record.Exposure = camera.GetExposure();
+		record.Primary = component.Primary;
+		record.FixedAspectRatio = component.FixedAspectRatio;
+		return record;
+		});
+
+	writer.WriteChunk<FakeBoundsComponent, FakeBoundsRecord>(FakeSceneChunkType::Bounds, [](const FakeBoundsComponent &bounds)
+		{
+		const FakeAABB &box = bounds.LocalBounds;
+		return FakeBoundsRecord { { box.Min.X, box.Min.Y, box.Min.Z }, { box.Max.X, box.Max.Y, box.Max.Z } };
+		});
+
+	writer.WriteChunk<FakeRigidbodyComponent, FakeRigidbodyRecord>(FakeSceneChunkType::Rigidbody, [](const FakeRigidbodyComponent &rigidbody)
+		{
+		FakeRigidbodyRecord record = {};
+		record.Type = (uint32)rigidbody.Type;
+		record.GravityScale = rigidbody.GravityScale;
+		record.LinearDamping = rigidbody.LinearDamping;
+		record.AngularDamping = rigidbody.AngularDamping;
+		record.FixedRotation = rigidbody.FixedRotation;
+		record.Bullet = rigidbody.Bullet;
+		return record;
+		});
+
+	writer.WriteChunk<FakeBoxColliderComponent, FakeBoxColliderRecord>(FakeSceneChunkType::BoxCollider, [](const FakeBoxColliderComponent &box)
+		{
+		return FakeBoxColliderRecord {
+			{ box.Offset.X, box.Offset.Y },
+			{ box.Size.X, box.Size.Y },
+			box.Density, box.Friction, box.Restitution, box.IsSensor
+			};
+		});
+
+	writer.WriteChunk<FakeCircleColliderComponent, FakeCircleColliderRecord>(FakeSceneChunkType::CircleCollider, [](const FakeCircleColliderComponent &circle)
+		{
+		return FakeCircleColliderRecord {
+			{ circle.Offset.X, circle.Offset.Y },
+			circle.Radius, circle.Density, circle.Friction, circle.Restitution, circle.IsSensor
+			};
+		});
+
+	writer.Finish(outData);
+	}
+
+bool FakeSceneBinarySerializer::Deserialize(const FakeString &path)
+	{
+	FakeMappedFile file;
+	if (!file.Open(path))
+		{
+		FAKE_LOG_ERROR("Could not open scene file %s!", *path);
+		return false;
+		}
+
+	return Deserialize(file.GetData(), file.GetSize());
+	}
+
+bool FakeSceneBinarySerializer::Deserialize(const Byte *data, uint64 size)
+	{
+	if (size < sizeof(FakeSceneFileHeader))
+		{
+		FAKE_LOG_ERROR("Scene file is truncated!");
+		return false;
+		}
+
+	const FakeSceneFileHeader &header = *(const FakeSceneFileHeader*)data;
+	if (header.Magic != Magic)
+		{
+		FAKE_LOG_ERROR("Not a binary scene file!");
+		return false;
+		}
+
+	if (header.Version != Version)
+		{
+		FAKE_LOG_ERROR("Scene file has version %d, expected version %d!", header.Version, Version);
+		return false;
+		}
+
+	if ((size - sizeof(FakeSceneFileHeader)) / sizeof(FakeSceneFileChunk) < header.ChunkCount)
+		{
+		FAKE_LOG_ERROR("Scene file is truncated!");
+		return false;
+		}
+
+	// Everything is validated before the first entity is created, so a broken file leaves the scene untouched
+	const FakeSceneFileChunk *chunks = (const FakeSceneFileChunk*)(data + sizeof(FakeSceneFileHeader));
+	const char *strings = nullptr;
+	uint64 stringsSize = 0;
+
+	for (uint32 i = 0; i < header.ChunkCount; ++i)
+		{
+		if (chunks[i].Type == (uint32)FakeSceneChunkType::Strings && Utils::fake_validate_chunk(data, size, header, chunks[i], 0))
+			{
+			strings = (const char*)(data + chunks[i].DataOffset);
+			stringsSize = chunks[i].Count;
+			}
+		}
+
+	// A second chunk of a type would add its components to entities which already have them
+	uint32 chunkTypes = 0;
+	for (uint32 i = 0; i < header.ChunkCount; ++i)
+		{
+		if (!Utils::fake_validate_chunk(data, size, header, chunks[i], stringsSize))
+			{
+			FAKE_LOG_ERROR("Scene file has an invalid chunk of type %d!", chunks[i].Type);
+			return false;
+			}
+
+		if (chunkTypes & (1u << chunks[i].Type))
+			{
+			FAKE_LOG_ERROR("Scene file has more than one chunk of type %d!", chunks[i].Type);
+			return false;
+			}
+
+		chunkTypes |= 1u << chunks[i].Type;
+		}
+
+	entt::registry &registry = Scene.Registry;
+	std::vector<entt::entity> entities(header.EntityCount);
+	registry.create(entities.begin(), entities.end());
+
+	for (uint32 i = 0; i < header.ChunkCount; ++i)
+		{
+		const FakeSceneFileChunk &chunk = chunks[i];
+		switch ((FakeSceneChunkType)chunk.Type)
+			{
+			case FakeSceneChunkType::Strings:
+				break;
+
+			case FakeSceneChunkType::Transform:
+				Utils::fake_insert_chunk<FakeTransformComponent, FakeTransformRecord>(registry, entities, data, chunk, [](const FakeTransformRecord &record)
+					{
+					FakeTransformComponent transform;
+					transform.Translation = FakeVec3f(record.Translation[0], record.Translation[1], record.Translation[2]);
+					transform.Rotation = FakeVec3f(record.Rotation[0], record.Rotation[1], record.Rotation[2]);
+					transform.Scale = FakeVec3f(record.Scale[0], record.Scale[1], record.Scale[2]);
+					return transform;
+					});
+				break;
+
+			case FakeSceneChunkType::Tag:
+				{
+				// Entities with the same name share one string
+				std::unordered_map<uint32, FakeTagComponent> tags;
+				Utils::fake_insert_chunk<FakeTagComponent, FakeTagRecord>(registry, entities, data, chunk, [strings, &tags](const FakeTagRecord &record)
+					{
+					auto it = tags.find(record.Name);
+					if (it == tags.end())
+						it = tags.emplace(record.Name, FakeTagComponent(FakeString(strings + record.Name))).first;
+
+					return it->second;
+					});
+				break;
+				}
+
+			case FakeSceneChunkType::Hierarchy:
+				Utils::fake_insert_chunk<FakeHierarchyComponent, FakeHierarchyRecord>(registry, entities, data, chunk, [&entities](const FakeHierarchyRecord &record)
+					{
+					FakeHierarchyComponent hierarchy;
+					hierarchy.Parent = record.Parent != InvalidIndex ? entities[record.Parent] : entt::null;
+					hierarchy.FirstChild = record.FirstChild != InvalidIndex ? entities[record.FirstChild] : entt::null;
+					hierarchy.NextSibling = record.NextSibling != InvalidIndex ? entities[record.NextSibling] : entt::null;
+					hierarchy.Depth = record.Depth;
+					return hierarchy;
+					});
+
+				Scene.HierarchyChanged = true;
+				break;
+
+			case FakeSceneChunkType::Sprite:
+				{
+				// Sprites share few textures, each one is loaded once
+				std::unordered_map<uint32, FakeRef<FakeTexture2D>> textures;
+				Utils::fake_insert_chunk<FakeSpriteComponent, FakeSpriteRecord>(registry, entities, data, chunk, [strings, &textures](const FakeSpriteRecord &record)
+					{
+					FakeSpriteComponent sprite(FakeVec4f(record.Color[0], record.Color[1], record.Color[2], record.Color[3]));
+					sprite.TilingFactor = record.TilingFactor;
+
+					if (record.TexturePath != InvalidIndex)
+						{
+						FakeRef<FakeTexture2D> &texture = textures[record.TexturePath];
+						if (!texture)
+							texture = FakeTexture2D::Create(FakeString(strings + record.TexturePath));
+
+						sprite.Texture = texture;
+						}
+
+					return sprite;
+					});
+				break;
+				}
+
+			case FakeSceneChunkType::Camera:
+				Utils::fake_insert_chunk<FakeCameraComponent, FakeCameraRecord>(registry, entities, data, chunk, [this](const FakeCameraRecord &record)
+					{
+					FakeCameraComponent component;
+					component.Primary = record.Primary != 0;
+					component.FixedAspectRatio = record.FixedAspectRatio != 0;
+
+					FakeCamera &camera = component.Camera;
+					camera.SetPerspectiveFOV(record.PerspectiveFOV);
+					camera.SetPerspectiveNearClip(record.PerspectiveNear);
+					camera.SetPerspectiveFar(record.PerspectiveFar);
+					camera.SetOrthographicSize(record.OrthographicSize);
+					camera.SetOrthographicNear(record.OrthographicNear);
+					camera.SetOrthographicFar(record.OrthographicFar);
+					camera.GetExposure() = record.Exposure;
+
+					if (record.ProjectionType == (uint32)FakeCamera::ProjectionType::Perspective)
+						camera.SetPerspective(fake_radians(record.PerspectiveFOV), record.PerspectiveNear, record.PerspectiveFar);
+					else
+						camera.SetOrthographic(record.OrthographicSize, record.OrthographicNear, record.OrthographicFar);
+
+					// Same as FakeScene::OnComponentAdded(), which a range insert does not call
+					camera.SetViewport(Scene.ViewportWidth, Scene.ViewportHeight);
+					return component;
+					});
+				break;
+
+			case FakeSceneChunkType::Bounds:
+				Utils::fake_insert_chunk<FakeBoundsComponent, FakeBoundsRecord>(registry, entities, data, chunk, [](const FakeBoundsRecord &record)
+					{
+					return FakeBoundsComponent(FakeAABB(FakeVec3f(record.Min[0], record.Min[1], record.Min[2]), FakeVec3f(record.Max[0], record.Max[1], record.Max[2])));
+					});
+				break;
+
+			case FakeSceneChunkType::Rigidbody:
+				Utils::fake_insert_chunk<FakeRigidbodyComponent, FakeRigidbodyRecord>(registry, entities, data, chunk, [](const FakeRigidbodyRecord &record)
+					{
+					FakeRigidbodyComponent rigidbody((FakeRigidbodyType)record.Type);
+					rigidbody.GravityScale = record.GravityScale;
+					rigidbody.LinearDamping = record.LinearDamping;
+					rigidbody.AngularDamping = record.AngularDamping;
+					rigidbody.FixedRotation = record.FixedRotation != 0;
+					rigidbody.Bullet = record.Bullet != 0;
+					return rigidbody;
+					});
+				break;
+
+			case FakeSceneChunkType::BoxCollider:
+				Utils::fake_insert_chunk<FakeBoxColliderComponent, FakeBoxColliderRecord>(registry, entities, data, chunk, [](const FakeBoxColliderRecord &record)
+					{
+					FakeBoxColliderComponent box(FakeVec2f(record.Size[0], record.Size[1]), FakeVec2f(record.Offset[0], record.Offset[1]));
+					box.Density = record.Density;
+					box.Friction = record.Friction;
+					box.Restitution = record.Restitution;
+					box.IsSensor = record.IsSensor != 0;
+					return box;
+					});
+				break;
+
+			case FakeSceneChunkType::CircleCollider:
+				Utils::fake_insert_chunk<FakeCircleColliderComponent, FakeCircleColliderRecord>(registry, entities, data, chunk, [](const FakeCircleColliderRecord &record)
+					{
+					FakeCircleColliderComponent circle(record.Radius, FakeVec2f(record.Offset[0], record.Offset[1]));
+					circle.Density = record.Density;
+					circle.Friction = record.Friction;
+					circle.Restitution = record.Restitution;
+					circle.IsSensor = record.IsSensor != 0;
+					return circle;
+					});
+				break;
+			}
+		}
+
+	return true;
+	}
@@ -0,0 +1,91 @@
+/*****************************************************************
+ * \file   FakeSceneBinarySerializer.h
+ * \brief  
+ * 
+ * \author Can Karka
+ * \date   February 2021
+ * 
+ * Copyright (C) 2021 Can Karka
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *********************************************************************/
+
+#pragma once
+
+#include "Engine/Core/FakeCore.h"
+#include "Engine/Core/DataTypes/FakeString.h"
+
+class FakeScene;
+
+/**
+ *
+ * Saves and loads the entities of a scene in a versioned binary format, meant for shipping large levels.
+ *
+ * The file starts with a header and a table of chunks. Every component type is one chunk, which holds a
+ * contiguous array of trivially copyable records and the indices of the entities owning them. The array is
+ * skipped when the records belong to the first entities in order, which is the case for the transforms and
+ * tags of most scenes. Loading maps the file into memory and inserts every chunk into the registry as one range.
+ *
+ * The format is little endian, records are never reordered within a version. A new version is needed whenever
+ * a record changes, older files are rejected instead of being guessed.
+ *
+ */
+class FAKE_API FakeSceneBinarySerializer
+	{
+	private:
+		FakeScene &Scene;
+
+	public:
+
+		static const uint32 Magic = 0x43534B46; // "FKSC"
+		static const uint32 Version = 1;
+
+		FakeSceneBinarySerializer(FakeScene &scene);
+
+		/**
+		 *
+		 * Writes all entities of the scene to a binary file, an existing file is replaced.
+		 *
+		 * @param path The physical path to the file on the disk.
+		 * @return Returns true if the file has been written.
+		 */
+		bool Serialize(const FakeString &path);
+
+		/**
+		 *
+		 * Writes all entities of the scene into a buffer in the binary format.
+		 *
+		 * @param outData Receives the contents of the file, previous contents are replaced.
+		 */
+		void Serialize(std::vector<Byte> &outData);
+
+		/**
+		 *
+		 * Maps a binary scene file into memory and creates its entities, existing entities of the scene are kept.
+		 *
+		 * @param path The physical path to the file on the disk.
+		 * @return Returns true if the file has been loaded.
+		 */
+		bool Deserialize(const FakeString &path);
+
+		/**
+		 *
+		 * Creates the entities stored in a buffer in the binary format, existing entities of the scene are kept.
+		 * Nothing is created if the data is invalid.
+		 *
+		 * @param data The contents of a binary scene file.
+		 * @param size The size of the data in bytes.
+		 * @return Returns true if the data has been loaded.
+		 */
+		bool Deserialize(const Byte *data, uint64 size);
+	};
@@ -0,0 +1,462 @@
+#include "FakePch.h"
+#include "FakeSceneSerializer.h"
+
+#include <fstream>
+#include <sstream>
+#include <yaml-cpp/yaml.h>
+
+#include "FakeScene.h"
+#include "FakeEntity.h"
+#include "Components/FakeComponents.h"
+
+namespace YAML
+	{
+	template<>
+	struct convert<FakeVec2f>
+		{
+		static Node encode(const FakeVec2f &value)
+			{
+			Node node;
+			node.push_back(value.X);
+			node.push_back(value.Y);
+			return node;
+			}
+
+		static bool decode(const Node &node, FakeVec2f &value)
+			{
+			if (!node.IsSequence() || node.size() != 2)
+				return false;
+
+			value.X = node[0].as<float>();
+			value.Y = node[1].as<float>();
+			return true;
+			}
+		};
+
+	template<>
+	struct convert<FakeVec3f>
+		{
+		static Node encode(const FakeVec3f &value)
+			{
+			Node node;
+			node.push_back(value.X);
+			node.push_back(value.Y);
+			node.push_back(value.Z);
+			return node;
+			}
+
+		static bool decode(const Node &node, FakeVec3f &value)
+			{
+			if (!node.IsSequence() || node.size() != 3)
+				return false;
+
+			value.X = node[0].as<float>();
+			value.Y = node[1].as<float>();
+			value.Z = node[2].as<float>();
+			return true;
+			}
+		};
+
+	template<>
+	struct convert<FakeVec4f>
+		{
+		static Node encode(const FakeVec4f &value)
+			{
+			Node node;
+			node.push_back(value.X);
+			node.push_back(value.Y);
+			node.push_back(value.Z);
+			node.push_back(value.W);
+			return node;
+			}
+
+		static bool decode(const Node &node, FakeVec4f &value)
+			{
+			if (!node.IsSequence() || node.size() != 4)
+				return false;
+
+			value.X = node[0].as<float>();
+			value.Y = node[1].as<float>();
+			value.Z = node[2].as<float>();
+			value.W = node[3].as<float>();
+			return true;
+			}
+		};
+	}
+
+static YAML::Emitter &operator<<(YAML::Emitter &out, const FakeVec2f &value)
+	{
+	out << YAML::Flow << YAML::BeginSeq << value.X << value.Y << YAML::EndSeq;
+	return out;
+	}
+
+static YAML::Emitter &operator<<(YAML::Emitter &out, const FakeVec3f &value)
+	{
+	out << YAML::Flow << YAML::BeginSeq << value.X << value.Y << value.Z << YAML::EndSeq;
+	return out;
+	}
+
+static YAML::Emitter &operator<<(YAML::Emitter &out, const FakeVec4f &value)
+	{
+	out << YAML::Flow << YAML::BeginSeq << value.X << value.Y << value.Z << value.W << YAML::EndSeq;
+	return out;
+	}
+
+namespace Utils
+	{
+	static const char *fake_rigidbody_type_to_string(FakeRigidbodyType type)
+		{
+		switch (type)
+			{
+			case FakeRigidbodyType::Static: return "Static";
+			case FakeRigidbodyType::Kinematic: return "Kinematic";
+			case FakeRigidbodyType::Dynamic: return "Dynamic";
+			}
+
+		return "Static";
+		}
+
+	static FakeRigidbodyType fake_rigidbody_type_from_string(const std::string &type)
+		{
+		if (type == "Kinematic")
+			return FakeRigidbodyType::Kinematic;
+
+		if (type == "Dynamic")
+			return FakeRigidbodyType::Dynamic;
+
+		return FakeRigidbodyType::Static;
+		}
+
+	static void fake_serialize_entity(YAML::Emitter &out, entt::registry &registry, entt::entity entity, uint32 index, uint32 parentIndex)
+		{
+		out << YAML::BeginMap;
+		out << YAML::Key << "Entity" << YAML::Value << index;
+
+		if (const FakeTagComponent *tag = registry.try_get<FakeTagComponent>(entity))
+			{
+			out << YAML::Key << "TagComponent" << YAML::BeginMap;
+			out << YAML::Key << "Tag" << YAML::Value << (tag->GetTag().IsEmpty() ? "" : *tag->GetTag());
+			out << YAML::EndMap;
+			}
+
+		if (const FakeTransformComponent *transform = registry.try_get<FakeTransformComponent>(entity))
+			{
+			out << YAML::Key << "TransformComponent" << YAML::BeginMap;
+			out << YAML::Key << "Translation" << YAML::Value << transform->Translation;
+			out << YAML::Key << "Rotation" << YAML::Value << transform->Rotation;
+			out << YAML::Key << "Scale" << YAML::Value << transform->Scale;
+			out << YAML::EndMap;
+			}
+
+		// Only the parent is stored, the links between the children are rebuilt when loading
+		if (parentIndex != ~0u)
+			{
+			out << YAML::Key << "HierarchyComponent" << YAML::BeginMap;
+			out << YAML::Key << "Parent" << YAML::Value << parentIndex;
+			out << YAML::EndMap;
+			}
+
+		if (const FakeSpriteComponent *sprite = registry.try_get<FakeSpriteComponent>(entity))
+			{
+			out << YAML::Key << "SpriteComponent" << YAML::BeginMap;
+			out << YAML::Key << "Color" << YAML::Value << sprite->Color;
+			if (sprite->Texture)
+				out << YAML::Key << "Texture" << YAML::Value << *sprite->Texture->GetPath();
+			out << YAML::Key << "TilingFactor" << YAML::Value << sprite->TilingFactor;
+			out << YAML::EndMap;
+			}
+
+		if (const FakeCameraComponent *cameraComponent = registry.try_get<FakeCameraComponent>(entity))
+			{
+			const FakeCamera &camera = cameraComponent->Camera;
+			bool perspective = camera.GetProjectionType() == FakeCamera::ProjectionType::Perspective;
+
+			out << YAML::Key << "CameraComponent" << YAML::BeginMap;
+			out << YAML::Key << "ProjectionType" << YAML::Value << (perspective ? "Perspective" : "Orthographic");
+			out << YAML::Key << "PerspectiveFOV" << YAML::Value << camera.GetPerspectiveFOV();
+			out << YAML::Key << "PerspectiveNear" << YAML::Value << camera.GetPerspectiveNearClip();
+			out << YAML::Key << "PerspectiveFar" << YAML::Value << camera.GetPerspectiveFar();
+			out << YAML::Key << "OrthographicSize" << YAML::Value << camera.GetOrthographicSize();
+			out << YAML::Key << "OrthographicNear" << YAML::Value << camera.GetOrthographicNear();
+			out << YAML::Key << "OrthographicFar" << YAML::Value << camera.GetOrthographicFar();
+			out << YAML::Key << "Exposure" << YAML::Value << camera.GetExposure();
+			out << YAML::Key << "Primary" << YAML::Value << cameraComponent->Primary;
+			out << YAML::Key << "FixedAspectRatio" << YAML::Value << cameraComponent->FixedAspectRatio;
+			out << YAML::EndMap;
+			}
+
+		if (const FakeBoundsComponent *bounds = registry.try_get<FakeBoundsComponent>(entity))
+			{
+			out << YAML::Key << "BoundsComponent" << YAML::BeginMap;
+			out << YAML::Key << "Min" << YAML::Value << bounds->LocalBounds.Min;
+			out << YAML::Key << "Max" << YAML::Value << bounds->LocalBounds.Max;
+			out << YAML::EndMap;
+			}
+
+		if (const FakeRigidbodyComponent *rigidbody = registry.try_get<FakeRigidbodyComponent>(entity))
+			{
+			out << YAML::Key << "RigidbodyComponent" << YAML::BeginMap;
+			out << YAML::Key << "Type" << YAML::Value << fake_rigidbody_type_to_string(rigidbody->Type);
+			out << YAML::Key << "FixedRotation" << YAML::Value << rigidbody->FixedRotation;
+			out << YAML::Key << "Bullet" << YAML::Value << rigidbody->Bullet;
+			out << YAML::Key << "GravityScale" << YAML::Value << rigidbody->GravityScale;
+			out << YAML::Key << "LinearDamping" << YAML::Value << rigidbody->LinearDamping;
+			out << YAML::Key << "AngularDamping" << YAML::Value << rigidbody->AngularDamping;
+			out << YAML::EndMap;
+			}
+
+		if (const FakeBoxColliderComponent *box = registry.try_get<FakeBoxColliderComponent>(entity))
+			{
+			out << YAML::Key << "BoxColliderComponent" << YAML::BeginMap;
+			out << YAML::Key << "Offset" << YAML::Value << box->Offset;
+			out << YAML::Key << "Size" << YAML::Value << box->Size;
+			out << YAML::Key << "Density" << YAML::Value << box->Density;
+			out << YAML::Key << "Friction" << YAML::Value << box->Friction;
+			out << YAML::Key << "Restitution" << YAML::Value << box->Restitution;
+			out << YAML::Key << "IsSensor" << YAML::Value << box->IsSensor;
+			out << YAML::EndMap;
+			}
+
+		if (const FakeCircleColliderComponent *circle = registry.try_get<FakeCircleColliderComponent>(entity))
+			{
+			out << YAML::Key << "CircleColliderComponent" << YAML::BeginMap;
+			out << YAML::Key << "Offset" << YAML::Value << circle->Offset;
+			out << YAML::Key << "Radius" << YAML::Value << circle->Radius;
+			out << YAML::Key << "Density" << YAML::Value << circle->Density;
+			out << YAML::Key << "Friction" << YAML::Value << circle->Friction;
+			out << YAML::Key << "Restitution" << YAML::Value << circle->Restitution;
+			out << YAML::Key << "IsSensor" << YAML::Value << circle->IsSensor;
+			out << YAML::EndMap;
+			}
+
+		out << YAML::EndMap;
+		}
+
+	static void fake_deserialize_camera(const YAML::Node &node, FakeCameraComponent &component)
+		{
+		FakeCamera &camera = component.Camera;
+		camera.SetPerspectiveFOV(node["PerspectiveFOV"].as<float>());
+		camera.SetPerspectiveNearClip(node["PerspectiveNear"].as<float>());
+		camera.SetPerspectiveFar(node["PerspectiveFar"].as<float>());
+		camera.SetOrthographicSize(node["OrthographicSize"].as<float>());
+		camera.SetOrthographicNear(node["OrthographicNear"].as<float>());
+		camera.SetOrthographicFar(node["OrthographicFar"].as<float>());
+		camera.GetExposure() = node["Exposure"].as<float>();
+
+		// The setters of the projection type take the field of view in radians
+		if (node["ProjectionType"].as<std::string>() == "Perspective")
+			camera.SetPerspective(fake_radians(camera.GetPerspectiveFOV()), camera.GetPerspectiveNearClip(), camera.GetPerspectiveFar());
+		else
+			camera.SetOrthographic(camera.GetOrthographicSize(), camera.GetOrthographicNear(), camera.GetOrthographicFar());
+
+		component.Primary = node["Primary"].as<bool>();
+		component.FixedAspectRatio = node["FixedAspectRatio"].as<bool>();
+		}
+	}
+
+FakeSceneSerializer::FakeSceneSerializer(FakeScene &scene)
+	: Scene(scene)
+	{
+	}
+
+bool FakeSceneSerializer::Serialize(const FakeString &path)
+	{
+	std::ofstream stream(*path, std::ios::out | std::ios::trunc);
+	if (!stream)
+		{
+		FAKE_LOG_ERROR("Could not open scene file %s for writing!", *path);
+		return false;
+		}
+
+	FakeString text = SerializeToString();
+	stream.write(*text, text.Length());
+	return stream.good();
+	}
+
+bool FakeSceneSerializer::Deserialize(const FakeString &path)
+	{
+	std::ifstream stream(*path);
+	if (!stream)
+		{
+		FAKE_LOG_ERROR("Could not open scene file %s!", *path);
+		return false;
+		}
+
+	std::stringstream text;
+	text << stream.rdbuf();
+	return DeserializeFromString(text.str());
+	}
+
+FakeString FakeSceneSerializer::SerializeToString()
+	{
+	entt::registry &registry = Scene.Registry;
+
+	// Roots in the order they have been created, registry.each() iterates backwards
+	std::vector<entt::entity> stack;
+	registry.each([&](entt::entity entity)
+		{
+		const FakeHierarchyComponent *hierarchy = registry.try_get<FakeHierarchyComponent>(entity);
+		if (!hierarchy || hierarchy->Parent == entt::null)
+			stack.push_back(entity);
+		});
+
+	// Depth first, every entity follows its parent and siblings keep their order
+	std::unordered_map<entt::entity, uint32> indices;
+	std::vector<entt::entity> children;
+
+	YAML::Emitter out;
+	out << YAML::BeginMap;
+	out << YAML::Key << "Entities" << YAML::Value << YAML::BeginSeq;
+
+	while (!stack.empty())
+		{
+		entt::entity entity = stack.back();
+		stack.pop_back();
+
+		uint32 index = (uint32)indices.size();
+		indices[entity] = index;
+
+		uint32 parentIndex = ~0u;
+		if (const FakeHierarchyComponent *hierarchy = registry.try_get<FakeHierarchyComponent>(entity))
+			{
+			if (hierarchy->Parent != entt::null)
+				parentIndex = indices[hierarchy->Parent];
+
+			children.clear();
+			for (entt::entity child = hierarchy->FirstChild; child != entt::null; child = registry.get<FakeHierarchyComponent>(child).NextSibling)
+				children.push_back(child);
+
+			stack.insert(stack.end(), children.rbegin(), children.rend());
+			}
+
+		Utils::fake_serialize_entity(out, registry, entity, index, parentIndex);
+		}
+
+	out << YAML::EndSeq;
+	out << YAML::EndMap;
+	return FakeString(out.c_str());
+	}
+
+bool FakeSceneSerializer::DeserializeFromString(const FakeString &text)
+	{
+	// SetParent() is called after all entities exist, in reverse so the children end up in their stored order
+	std::unordered_map<uint64, FakeEntity> entities;
+	std::vector<std::pair<FakeEntity, uint64>> parents;
+
+	try
+		{
+		YAML::Node data = YAML::Load(text.IsEmpty() ? "" : *text);
+		YAML::Node entityNodes = data["Entities"];
+		if (!entityNodes || !entityNodes.IsSequence())
+			{
+			FAKE_LOG_ERROR("Scene file has no Entities!");
+			return false;
+			}
+
+		for (const YAML::Node &node : entityNodes)
+			{
+			uint64 id = node["Entity"].as<uint64>();
+
+			FakeString name;
+			if (YAML::Node tagNode = node["TagComponent"])
+				name = tagNode["Tag"].as<std::string>();
+
+			FakeEntity entity = Scene.CreateEntity(name);
+			entities[id] = entity;
+
+			if (YAML::Node transformNode = node["TransformComponent"])
+				{
+				FakeTransformComponent &transform = entity.GetComponent<FakeTransformComponent>();
+				transform.Translation = transformNode["Translation"].as<FakeVec3f>();
+				transform.Rotation = transformNode["Rotation"].as<FakeVec3f>();
+				transform.Scale = transformNode["Scale"].as<FakeVec3f>();
+				}
+			else
+				{
+				entity.RemoveComponent<FakeTransformComponent>();
+				}
+
+			if (YAML::Node hierarchyNode = node["HierarchyComponent"])
+				parents.emplace_back(entity, hierarchyNode["Parent"].as<uint64>());
+
+			if (YAML::Node spriteNode = node["SpriteComponent"])
+				{
+				FakeSpriteComponent sprite;
+				sprite.Color = spriteNode["Color"].as<FakeVec4f>();
+				sprite.TilingFactor = spriteNode["TilingFactor"].as<float>();
+				if (YAML::Node textureNode = spriteNode["Texture"])
+					sprite.Texture = FakeTexture2D::Create(textureNode.as<std::string>());
+
+				entity.AddComponent<FakeSpriteComponent>(sprite);
+				}
+
+			if (YAML::Node cameraNode = node["CameraComponent"])
+				{
+				// Restored before it is added, the scene then computes the projection for its viewport
+				FakeCameraComponent camera;
+				Utils::fake_deserialize_camera(cameraNode, camera);
+				entity.AddComponent<FakeCameraComponent>(camera);
+				}
+
+			if (YAML::Node boundsNode = node["BoundsComponent"])
+				{
+				FakeAABB localBounds(boundsNode["Min"].as<FakeVec3f>(), boundsNode["Max"].as<FakeVec3f>());
+				entity.AddComponent<FakeBoundsComponent>(localBounds);
+				}
+
+			if (YAML::Node boxNode = node["BoxColliderComponent"])
+				{
+				FakeBoxColliderComponent box;
+				box.Offset = boxNode["Offset"].as<FakeVec2f>();
+				box.Size = boxNode["Size"].as<FakeVec2f>();
+				box.Density = boxNode["Density"].as<float>();
+				box.Friction = boxNode["Friction"].as<float>();
+				box.Restitution = boxNode["Restitution"].as<float>();
+				box.IsSensor = boxNode["IsSensor"].as<bool>();
+				entity.AddComponent<FakeBoxColliderComponent>(box);
+				}
+
+			if (YAML::Node circleNode = node["CircleColliderComponent"])
+				{
+				FakeCircleColliderComponent circle;
+				circle.Offset = circleNode["Offset"].as<FakeVec2f>();
+				circle.Radius = circleNode["Radius"].as<float>();
+				circle.Density = circleNode["Density"].as<float>();
+				circle.Friction = circleNode["Friction"].as<float>();
+				circle.Restitution = circleNode["Restitution"].as<float>();
+				circle.IsSensor = circleNode["IsSensor"].as<bool>();
+				entity.AddComponent<FakeCircleColliderComponent>(circle);
+				}
+
+			if (YAML::Node rigidbodyNode = node["RigidbodyComponent"])
+				{
+				FakeRigidbodyComponent rigidbody(Utils::fake_rigidbody_type_from_string(rigidbodyNode["Type"].as<std::string>()));
+				rigidbody.FixedRotation = rigidbodyNode["FixedRotation"].as<bool>();
+				rigidbody.Bullet = rigidbodyNode["Bullet"].as<bool>();
+				rigidbody.GravityScale = rigidbodyNode["GravityScale"].as<float>();
+				rigidbody.LinearDamping = rigidbodyNode["LinearDamping"].as<float>();
+				rigidbody.AngularDamping = rigidbodyNode["AngularDamping"].as<float>();
+				entity.AddComponent<FakeRigidbodyComponent>(rigidbody);
+				}
+			}
+		}
+	catch (const YAML::Exception &e)
+		{
+		FAKE_LOG_ERROR("Failed to load scene: %s", e.what());
+		return false;
+		}
+
+	for (auto it = parents.rbegin(); it != parents.rend(); ++it)
+		{
+		auto parent = entities.find(it->second);
+		if (parent == entities.end())
+			{
+			FAKE_LOG_WARN("Scene file references the missing parent %llu", it->second);
+			continue;
+			}
+
+		Scene.SetParent(it->first, parent->second);
+		}
+
+	return true;
+	}
@@ -0,0 +1,79 @@
+/*****************************************************************
+ * \file   FakeSceneSerializer.h
+ * \brief  
+ * 
+ * \author Can Karka
+ * \date   February 2021
+ * 
+ * Copyright (C) 2021 Can Karka
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *********************************************************************/
+
+#pragma once
+
+#include "Engine/Core/FakeCore.h"
+#include "Engine/Core/DataTypes/FakeString.h"
+
+class FakeScene;
+
+/**
+ *
+ * Saves and loads the entities of a scene as human readable YAML, used by the LevelEditor.
+ * Large levels should be shipped with FakeSceneBinarySerializer, which loads orders of magnitude faster.
+ *
+ */
+class FAKE_API FakeSceneSerializer
+	{
+	private:
+		FakeScene &Scene;
+
+	public:
+
+		FakeSceneSerializer(FakeScene &scene);
+
+		/**
+		 *
+		 * Writes all entities of the scene to a YAML file, an existing file is replaced.
+		 *
+		 * @param path The physical path to the file on the disk.
+		 * @return Returns true if the file has been written.
+		 */
+		bool Serialize(const FakeString &path);
+
+		/**
+		 *
+		 * Creates the entities stored in a YAML file, existing entities of the scene are kept.
+		 *
+		 * @param path The physical path to the file on the disk.
+		 * @return Returns true if the file has been loaded.
+		 */
+		bool Deserialize(const FakeString &path);
+
+		/**
+		 *
+		 * Writes all entities of the scene into a YAML document.
+		 *
+		 * @return Returns the YAML text.
+		 */
+		FakeString SerializeToString();
+
+		/**
+		 *
+		 * Creates the entities stored in a YAML document, existing entities of the scene are kept.
+		 *
+		 * @param text The YAML text.
+		 * @return Returns true if the document has been loaded.
+		 */
+		bool DeserializeFromString(const FakeString &text);
+	};
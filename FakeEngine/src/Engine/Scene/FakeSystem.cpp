@@ -0,0 +1,28 @@
+#include "FakePch.h"
+#include "FakeSystem.h"
+
+bool FakeSystemAccess::Intersects(const std::vector<entt::id_type> &a, const std::vector<entt::id_type> &b)
+	{
+	// Systems touch a handful of components, a linear search beats sorting
+	for (entt::id_type id : a)
+		{
+		if (std::find(b.begin(), b.end(), id) != b.end())
+			return true;
+		}
+
+	return false;
+	}
+
+bool FakeSystemAccess::ConflictsWith(const FakeSystemAccess &other) const
+	{
+	if (Exclusive || other.Exclusive)
+		return true;
+
+	return Intersects(Writes, other.Writes) || Intersects(Writes, other.Reads) || Intersects(Reads, other.Writes);
+	}
+
+void FakeSystemAccess::PreparePools(entt::registry &registry) const
+	{
+	for (auto prepare : Pools)
+		prepare(registry);
+	}
@@ -0,0 +1,189 @@
+/*****************************************************************
+ * \file   FakeSystem.h
+ * \brief  
+ * 
+ * \author Can Karka
+ * \date   February 2021
+ * 
+ * Copyright (C) 2021 Can Karka
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *********************************************************************/
+
+#pragma once
+
+#include <entt/entt.hpp>
+#include "Engine/Core/FakeTimeStep.h"
+#include "Engine/Core/Jobs/FakeJobSystem.h"
+
+/**
+ *
+ * The components a FakeSystem reads and writes.
+ * The FakeSystemScheduler runs two systems concurrently if neither of them writes a component the other one accesses.
+ *
+ */
+class FAKE_API FakeSystemAccess
+	{
+	private:
+		std::vector<entt::id_type> Reads;
+		std::vector<entt::id_type> Writes;
+		std::vector<void(*)(entt::registry&)> Pools;
+		bool Exclusive = false;
+
+		template<typename Component>
+		void Add(std::vector<entt::id_type> &list)
+			{
+			list.push_back(entt::type_info<Component>::id());
+			Pools.push_back([](entt::registry &registry) { registry.prepare<Component>(); });
+			}
+
+		static bool Intersects(const std::vector<entt::id_type> &a, const std::vector<entt::id_type> &b);
+
+	public:
+
+		template<typename... Components>
+		FakeSystemAccess &Read()
+			{
+			(Add<Components>(Reads), ...);
+			return *this;
+			}
+
+		template<typename... Components>
+		FakeSystemAccess &Write()
+			{
+			(Add<Components>(Writes), ...);
+			return *this;
+			}
+
+		/**
+		 *
+		 * The system never runs concurrently with another system.
+		 * Required for systems which create or destroy entities or add and remove components.
+		 *
+		 */
+		FakeSystemAccess &SetExclusive()
+			{
+			Exclusive = true;
+			return *this;
+			}
+
+		/**
+		 *
+		 * Returns true if the two systems must not run at the same time.
+		 *
+		 * @param other The access of the other system.
+		 * @return Returns true if the accesses conflict.
+		 */
+		bool ConflictsWith(const FakeSystemAccess &other) const;
+
+		/**
+		 *
+		 * Creates the component pools up front, entt creates them lazily which is not thread safe.
+		 *
+		 * @param registry The registry the system runs on.
+		 */
+		void PreparePools(entt::registry &registry) const;
+	};
+
+/**
+ *
+ * A unit of per frame game logic which runs on the registry of a FakeScene.
+ *
+ * Systems are executed by the FakeSystemScheduler on the Job System, so OnUpdate() may run on any thread.
+ * A system must only touch the components it declared in DeclareAccess().
+ *
+ * ### Usage
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~.cpp
+ * class MovementSystem : public FakeSystem
+ *     {
+ *     public:
+ *         virtual const char *GetName() const override { return "Movement"; }
+ *         virtual void DeclareAccess(FakeSystemAccess &access) override { access.Write<FakeTransformComponent>().Read<VelocityComponent>(); }
+ *
+ *         virtual void OnUpdate(entt::registry &registry, FakeTimeStep ts) override
+ *             {
+ *             ParallelEach<FakeTransformComponent, VelocityComponent>(registry, 0, [&](entt::entity entity, FakeTransformComponent &transform, VelocityComponent &velocity)
+ *                 {
+ *                 registry.patch<FakeTransformComponent>(entity, [&](FakeTransformComponent &t) { t.Translation += velocity.Value * (float)ts; });
+ *                 });
+ *             }
+ *     };
+ *
+ * scene.AddSystem<MovementSystem>();
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+class FAKE_API FakeSystem
+	{
+	private:
+		std::vector<entt::entity> ChunkEntities;
+
+	protected:
+
+		/**
+		 *
+		 * Calls the function for every entity which has all of the components, split into chunks which run in parallel.
+		 * Returns once all entities have been processed.
+		 *
+		 * @param registry The registry passed to OnUpdate().
+		 * @param grainSize The maximum number of entities per chunk, 0 picks a size based on the thread count.
+		 * @param fn The function which receives the entity followed by references to its components.
+		 */
+		template<typename... Components, typename Fn>
+		void ParallelEach(entt::registry &registry, uint32 grainSize, Fn &&fn)
+			{
+			auto view = registry.view<Components...>();
+
+			const entt::entity *entities = nullptr;
+			uint32 count = 0;
+			if constexpr (sizeof...(Components) == 1)
+				{
+				entities = view.data();
+				count = (uint32)view.size();
+				}
+			else
+				{
+				// Multi component views can not be indexed, collect the matching entities first
+				ChunkEntities.assign(view.begin(), view.end());
+				entities = ChunkEntities.data();
+				count = (uint32)ChunkEntities.size();
+				}
+
+			auto chunk = [&](uint32 begin, uint32 end)
+				{
+				for (uint32 i = begin; i < end; ++i)
+					fn(entities[i], view.template get<Components>(entities[i])...);
+				};
+
+			if (FakeJobSystem::IsInitialized())
+				FakeJobSystem::ParallelFor(count, grainSize, chunk);
+			else
+				chunk(0, count);
+			}
+
+	public:
+
+		virtual ~FakeSystem() = default;
+
+		virtual const char *GetName() const = 0;
+
+		/**
+		 *
+		 * Called once when the system is added to the scheduler.
+		 *
+		 * @param access Receives the components the system reads and writes.
+		 */
+		virtual void DeclareAccess(FakeSystemAccess &access) = 0;
+
+		virtual void OnUpdate(entt::registry &registry, FakeTimeStep ts) = 0;
+	};
+
@@ -0,0 +1,130 @@
+#include "FakePch.h"
+#include "FakeSystemScheduler.h"
+
+void FakeSystemScheduler::SetEnabled(const FakeSystem &system, bool enabled)
+	{
+	for (auto &node : Nodes)
+		{
+		if (node->System.get() == &system)
+			{
+			node->Enabled = enabled;
+			return;
+			}
+		}
+
+	FAKE_ASSERT(false, "System has not been added to this scheduler!");
+	}
+
+void FakeSystemScheduler::Run(entt::registry &registry, FakeTimeStep ts)
+	{
+	if (Nodes.empty())
+		return;
+
+	CurrentRegistry = &registry;
+	CurrentTimeStep = ts;
+
+	BuildGraph();
+
+	for (auto &node : Nodes)
+		{
+		if (node->Enabled)
+			node->Access.PreparePools(registry);
+		}
+
+	if (!FakeJobSystem::IsInitialized())
+		{
+		// The order of addition is always a valid topological order
+		for (uint32 i = 0; i < (uint32)Nodes.size(); ++i)
+			{
+			if (Nodes[i]->Enabled)
+				Execute(i);
+			}
+
+		return;
+		}
+
+	FakeJobCounter counter;
+	CurrentCounter = &counter;
+
+	for (uint32 i = 0; i < (uint32)Nodes.size(); ++i)
+		{
+		if (Nodes[i]->Enabled && Nodes[i]->DependencyCount == 0)
+			FakeJobSystem::Run([this, i]() { Execute(i); }, &counter);
+		}
+
+	FakeJobSystem::Wait(&counter);
+	CurrentCounter = nullptr;
+	}
+
+void FakeSystemScheduler::Clear()
+	{
+	Nodes.clear();
+	}
+
+void FakeSystemScheduler::GetTimings(std::vector<FakeSystemTiming> &outTimings) const
+	{
+	outTimings.clear();
+	outTimings.reserve(Nodes.size());
+	for (auto &node : Nodes)
+		outTimings.push_back(node->Timing);
+	}
+
+void FakeSystemScheduler::BuildGraph()
+	{
+	uint32 count = (uint32)Nodes.size();
+	for (uint32 i = 0; i < count; ++i)
+		{
+		SystemNode &node = *Nodes[i];
+		node.Dependents.clear();
+		node.DependencyCount = 0;
+		node.Timing.Milliseconds = 0.0;
+		}
+
+	for (uint32 i = 0; i < count; ++i)
+		{
+		SystemNode &node = *Nodes[i];
+		if (!node.Enabled)
+			continue;
+
+		for (uint32 j = i + 1; j < count; ++j)
+			{
+			SystemNode &other = *Nodes[j];
+			if (other.Enabled && node.Access.ConflictsWith(other.Access))
+				{
+				node.Dependents.push_back(j);
+				++other.DependencyCount;
+				}
+			}
+		}
+
+	for (uint32 i = 0; i < count; ++i)
+		Nodes[i]->PendingDependencies.store(Nodes[i]->DependencyCount, std::memory_order_relaxed);
+	}
+
+void FakeSystemScheduler::Execute(uint32 index)
+	{
+	SystemNode &node = *Nodes[index];
+
+#ifdef FAKE_ENABLE_PROFILER
+	FakeProfilerTimer profilerTimer(node.Timing.Name);
+#endif
+
+	auto start = std::chrono::steady_clock::now();
+	node.System->OnUpdate(*CurrentRegistry, CurrentTimeStep);
+	node.Timing.Milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	node.Timing.ThreadIndex = FakeJobSystem::GetThreadIndex();
+
+#ifdef FAKE_ENABLE_PROFILER
+	profilerTimer.Stop();
+#endif
+
+	// The last finished dependency schedules the dependent system
+	for (uint32 dependent : node.Dependents)
+		{
+		if (Nodes[dependent]->PendingDependencies.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			{
+			if (CurrentCounter)
+				FakeJobSystem::Run([this, dependent]() { Execute(dependent); }, CurrentCounter);
+			}
+		}
+	}
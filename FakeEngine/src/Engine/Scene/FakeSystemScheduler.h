@@ -0,0 +1,118 @@
+/*****************************************************************
+ * \file   FakeSystemScheduler.h
+ * \brief  
+ * 
+ * \author Can Karka
+ * \date   February 2021
+ * 
+ * Copyright (C) 2021 Can Karka
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *********************************************************************/
+
+#pragma once
+
+#include "FakeSystem.h"
+
+struct FakeSystemTiming
+	{
+	const char *Name = nullptr;
+	double Milliseconds = 0.0;
+	uint32 ThreadIndex = 0;
+	};
+
+/**
+ *
+ * Runs FakeSystems on the Job System.
+ *
+ * Every frame the enabled systems form a dependency graph: a system depends on every system added before it
+ * whose component access conflicts with its own. Systems without conflicts run concurrently, the order of
+ * conflicting systems is always the order in which they have been added.
+ *
+ */
+class FAKE_API FakeSystemScheduler
+	{
+	private:
+
+		struct SystemNode
+			{
+			Scope<FakeSystem> System;
+			FakeSystemAccess Access;
+			bool Enabled = true;
+
+			// Rebuilt every frame
+			std::vector<uint32> Dependents;
+			uint32 DependencyCount = 0;
+			std::atomic<uint32> PendingDependencies = 0;
+
+			FakeSystemTiming Timing;
+			};
+
+		std::vector<Scope<SystemNode>> Nodes;
+
+		entt::registry *CurrentRegistry = nullptr;
+		FakeTimeStep CurrentTimeStep;
+		FakeJobCounter *CurrentCounter = nullptr;
+
+		void BuildGraph();
+		void Execute(uint32 index);
+
+	public:
+
+		template<typename T, typename... Args>
+		T &Add(Args&&... args)
+			{
+			static_assert(std::is_base_of<FakeSystem, T>::value, "T must derive from FakeSystem!");
+
+			Scope<SystemNode> node = CreateScope<SystemNode>();
+			node->System = CreateScope<T>(std::forward<Args>(args)...);
+			node->System->DeclareAccess(node->Access);
+			node->Timing.Name = node->System->GetName();
+
+			T &system = static_cast<T&>(*node->System);
+			Nodes.push_back(std::move(node));
+			return system;
+			}
+
+		/**
+		 *
+		 * Disabled systems are skipped and do not take part in the dependency graph.
+		 *
+		 * @param system The system returned by Add().
+		 * @param enabled True to run the system.
+		 */
+		void SetEnabled(const FakeSystem &system, bool enabled);
+
+		/**
+		 *
+		 * Runs all enabled systems once and returns after all of them have finished.
+		 * Without an initialized Job System the systems run one after another on the calling thread.
+		 *
+		 * @param registry The registry passed to the systems.
+		 * @param ts The time step passed to the systems.
+		 */
+		void Run(entt::registry &registry, FakeTimeStep ts);
+
+		void Clear();
+
+		uint32 GetSystemCount() const { return (uint32)Nodes.size(); }
+
+		/**
+		 *
+		 * Returns the timings of the last Run(), in the order the systems have been added.
+		 *
+		 * @param outTimings Receives one entry per system, disabled systems report 0.
+		 */
+		void GetTimings(std::vector<FakeSystemTiming> &outTimings) const;
+	};
+
@@ -38,10 +38,19 @@
 #include "Engine/Core/FakeTimeStep.h"
 #include "Engine/Core/FakeVersion.h"
 #include "Engine/Core/FakeFileSystem.h"
+#include "Engine/Core/FakeMappedFile.h"
 #include "Engine/Core/FakeVirtualFileSystem.h"
 
+// Jobs
+#include "Engine/Core/Jobs/FakeJobSystem.h"
+
+// Async
+#include "Engine/Core/Async/FakeTask.h"
+#include "Engine/Core/Async/FakeAsync.h"
+
 // Allocators
 #include "Engine/Core/FakeAllocator.h"
+#include "Engine/Core/FakeArena.h"
 
 // Defines
 #include "Engine/Core/Defines/FakeDefines.h"
@@ -67,38 +76,63 @@
 // Maths
 #include "Engine/Core/Maths/FakeMaths.h"
 
+// Spatial
+#include "Engine/Core/Spatial/FakeDynamicAABBTree.h"
+#include "Engine/Core/Spatial/FakeLooseQuadtree.h"
+
 // Utils
 #include "Engine/Utils/FakeUtils.h"
 
 // Renderer
 #include "Engine/Renderer/FakeRenderingContext.h"
 #include "Engine/Renderer/FakeRenderer.h"
+#include "Engine/Renderer/FakeRendererAPI.h"
 #include "Engine/Renderer/FakeRenderer2D.h"
 #include "Engine/Renderer/FakeSceneRenderer.h"
+#include "Engine/Renderer/FakeGPUScene.h"
+#include "Engine/Renderer/FakeParticleSystem.h"
 #include "Engine/Renderer/FakePipeline.h"
 #include "Engine/Renderer/FakeVertexBuffer.h"
 #include "Engine/Renderer/FakeVertexBufferLayout.h"
 #include "Engine/Renderer/FakeIndexBuffer.h"
+#include "Engine/Renderer/FakeStorageBuffer.h"
 #include "Engine/Renderer/FakeFramebuffer.h"
 #include "Engine/Renderer/FakeFramebufferPool.h"
 #include "Engine/Renderer/FakeRenderPass.h"
+#include "Engine/Renderer/FakeRenderGraph.h"
 #include "Engine/Renderer/FakeTexture2D.h"
+#include "Engine/Renderer/FakeFont.h"
+#include "Engine/Renderer/FakeImage.h"
 #include "Engine/Renderer/FakeTextureCube.h"
 #include "Engine/Renderer/FakeShader.h"
 #include "Engine/Renderer/FakeShaderLibrary.h"
+#include "Engine/Renderer/FakeShaderPreprocessor.h"
+#include "Engine/Renderer/FakeShaderReflection.h"
 #include "Engine/Renderer/FakeMesh.h"
 #include "Engine/Renderer/FakeMeshFactory.h"
+#include "Engine/Renderer/FakeMeshOptimizer.h"
+#include "Engine/Renderer/FakeMeshCooker.h"
 #include "Engine/Renderer/FakeMaterial.h"
 #include "Engine/Renderer/FakeMaterialInstance.h"
 #include "Engine/Renderer/FakeOrthographicCamera.h"
 #include "Engine/Renderer/FakeOrthographicCameraController.h"
+#include "Engine/Platform/Null/FakeNullRendererAPI.h"
 
 // Net
 #include "Engine/Net/FakeNet.h"
 
+// Physics
+#include "Engine/Physics/FakePhysics.h"
+
 // Scene
 #include "Engine/Scene/FakeCamera.h"
 #include "Engine/Scene/FakeEditorCamera.h"
 #include "Engine/Scene/FakeEntity.h"
 #include "Engine/Scene/FakeScene.h"
+#include "Engine/Scene/FakeSceneSerializer.h"
+#include "Engine/Scene/FakeSceneBinarySerializer.h"
+#include "Engine/Scene/FakePrefab.h"
+#include "Engine/Scene/FakeSystem.h"
+#include "Engine/Scene/FakeSystemScheduler.h"
+#include "Engine/Scene/Components/FakeComponents.h"
 
@@ -1,11 +1,19 @@
+#keywords FLAT_COLOR
+
 #type vertex
 #version 450 core
 
 layout(location = 0) in vec3 a_Position;
+
+#ifdef FLAT_COLOR
+uniform mat4 u_Transform;
+uniform vec4 u_Color;
+#else
 layout(location = 1) in vec4 a_Color;
 layout(location = 2) in vec2 a_TexCoord;
 layout(location = 3) in float a_TexIndex;
 layout(location = 4) in float a_TilingFactor;
+#endif
 
 uniform mat4 u_ViewProjection;
 
@@ -16,12 +24,21 @@ out float v_TilingFactor;
 
 void main()
 	{
+#ifdef FLAT_COLOR
+	v_Color = u_Color;
+	v_TexCoord = vec2(0.0);
+	v_TexIndex = -1.0;
+	v_TilingFactor = 1.0;
+	
+	gl_Position = u_ViewProjection * u_Transform * vec4(a_Position, 1.0);
+#else
 	v_Color = a_Color;
 	v_TexCoord = a_TexCoord;
 	v_TexIndex = a_TexIndex;
 	v_TilingFactor = a_TilingFactor;
 	
 	gl_Position = u_ViewProjection * vec4(a_Position, 1.0);
+#endif
 	}
 
 #type fragment
@@ -41,6 +58,7 @@ void main()
 	{
 	vec4 texColor = v_Color;
 	
+#ifndef FLAT_COLOR
 	switch (int(v_TexIndex))
 		{
 		case  0: texColor *= texture(u_Textures[ 0], v_TexCoord * v_TilingFactor); break;
@@ -76,6 +94,7 @@ void main()
 		case 30: texColor *= texture(u_Textures[30], v_TexCoord * v_TilingFactor); break;
 		case 31: texColor *= texture(u_Textures[31], v_TexCoord * v_TilingFactor); break;
 		}
+#endif
 		
 	Color = texColor;
 	ObjectID = 50; // placeholder for mouse picking
@@ -36,6 +36,12 @@ librarydir["SPIRV_Tools"]                = "%{wks.location}/FakeEngine/vendor/SP
 librarydir["SPIRV_Tools_opt"]            = "%{wks.location}/FakeEngine/vendor/SPIRV-Tools/lib/Debug/SPIRV-Tools-opt.lib"
 librarydir["Vulkan"]                     = "%{wks.location}/FakeEngine/vendor/Vulkan/1.2.148.1/Lib/vulkan-1.lib"
 
+newoption
+	{
+	trigger = "vulkan",
+	description = "Builds the Vulkan renderer backend, needs the shaderc and glslang libraries in FakeEngine/vendor"
+	}
+
 workspace "FakeEngine"
 	architecture "x64"
 	
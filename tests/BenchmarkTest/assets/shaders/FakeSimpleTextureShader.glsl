@@ -2,27 +2,33 @@
 #version 450 core
 
 layout(location = 0) in vec3 a_Position;
+layout(location = 1) in vec2 a_TexCoord;
 
 uniform mat4 u_ViewProjection;
 uniform mat4 u_Transform;
-uniform vec4 u_Color;
 
-out vec4 v_Color;
+out vec2 v_TexCoord;
 
 void main()
 	{
-	v_Color = u_Color;
+	v_TexCoord = a_TexCoord;
 	gl_Position = u_ViewProjection * u_Transform * vec4(a_Position, 1.0);
 	}
-
+	
 #type fragment
 #version 450 core
 
 layout(location = 0) out vec4 Color;
 
-in vec4 v_Color;
+in vec2 v_TexCoord;
+
+uniform vec4 u_Color;
+uniform float u_TilingFactor;
+uniform sampler2D u_Texture;
 
 void main()
 	{
-	Color = v_Color;
-	}
\ No newline at end of file
+	Color = texture(u_Texture, v_TexCoord * u_TilingFactor) * u_Color;
+	}
+	
+	
\ No newline at end of file
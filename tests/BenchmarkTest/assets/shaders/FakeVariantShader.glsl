@@ -0,0 +1,56 @@
+#keywords TEXTURED TINTED ALPHA_TEST
+
+#type vertex
+#version 450 core
+
+layout(location = 0) in vec3 a_Position;
+layout(location = 1) in vec4 a_Color;
+layout(location = 2) in vec2 a_TexCoord;
+
+uniform mat4 u_ViewProjection;
+
+out vec4 v_Color;
+out vec2 v_TexCoord;
+
+void main()
+	{
+	v_Color = a_Color;
+	v_TexCoord = a_TexCoord;
+	gl_Position = u_ViewProjection * vec4(a_Position, 1.0);
+	}
+
+#type fragment
+#version 450 core
+
+layout(location = 0) out vec4 Color;
+
+in vec4 v_Color;
+in vec2 v_TexCoord;
+
+#ifdef TEXTURED
+uniform sampler2D u_Texture;
+#endif
+
+#ifdef TINTED
+uniform vec4 u_Tint;
+#endif
+
+void main()
+	{
+	vec4 color = v_Color;
+
+#ifdef TEXTURED
+	color *= texture(u_Texture, v_TexCoord);
+#endif
+
+#ifdef TINTED
+	color *= u_Tint;
+#endif
+
+#ifdef ALPHA_TEST
+	if (color.a < 0.5)
+		discard;
+#endif
+
+	Color = color;
+	}
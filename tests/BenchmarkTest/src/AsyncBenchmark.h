@@ -0,0 +1,75 @@
+#pragma once
+
+#include "Benchmark.h"
+
+class AsyncBenchmark
+	{
+	private:
+
+		#ifdef FAKE_HAS_COROUTINES
+			static uint32 Hash(uint32 value)
+				{
+				for (uint32 i = 0; i < 256; ++i)
+					value = value * 1664525u + 1013904223u;
+
+				return value;
+				}
+
+			static FakeTask<uint32> HashOnJobSystem(uint32 value)
+				{
+				co_await FakeAsync::ResumeOnJobSystem();
+				co_return Hash(value);
+				}
+
+			// Awaits the jobs and comes back to the main thread like an asset load does
+			static FakeTask<uint32> SumOnMainThread(uint32 count, bool *resumedOnMainThread)
+				{
+				std::vector<FakeTask<uint32>> tasks;
+				tasks.reserve(count);
+				for (uint32 i = 0; i < count; ++i)
+					tasks.push_back(HashOnJobSystem(i));
+
+				std::vector<uint32> values = co_await FakeAsync::WhenAll(std::move(tasks));
+
+				co_await FakeAsync::ResumeOnMainThread();
+				*resumedOnMainThread = FakeJobSystem::GetThreadIndex() == 0;
+
+				uint32 sum = 0;
+				for (uint32 value : values)
+					sum += value;
+
+				co_return sum;
+				}
+		#endif
+
+	public:
+
+		static void Run()
+			{
+			#ifdef FAKE_HAS_COROUTINES
+				const uint32 jobCount = 10000;
+
+				uint32 expected = 0;
+				for (uint32 i = 0; i < jobCount; ++i)
+					expected += Hash(i);
+
+				bool resumedOnMainThread = false;
+				uint32 sum = FakeAsync::SyncWait(SumOnMainThread(jobCount, &resumedOnMainThread));
+
+				if (sum != expected)
+					FAKE_LOG_ERROR("Awaited jobs returned %d, expected %d!", sum, expected);
+
+				if (!resumedOnMainThread)
+					FAKE_LOG_ERROR("FakeAsync::ResumeOnMainThread() did not resume on the main thread!");
+
+				double milliseconds = Benchmark::Measure(10, [&]()
+					{
+					FakeAsync::SyncWait(SumOnMainThread(jobCount, &resumedOnMainThread));
+					});
+
+				Benchmark::Report("Await 10k jobs with WhenAll", milliseconds);
+			#else
+				FAKE_LOG_ERROR("BenchmarkTest is built without coroutines, FakeTask and FakeAsync are not tested!");
+			#endif
+			}
+	};
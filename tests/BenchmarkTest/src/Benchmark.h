@@ -0,0 +1,32 @@
+#pragma once
+
+#include <Fake.h>
+
+class Benchmark
+	{
+	public:
+
+		template<typename Fn>
+		static double Measure(uint32 iterations, Fn fn)
+			{
+			// One warm-up run so page faults and lazy initialisation do not skew the first sample
+			fn();
+
+			auto start = std::chrono::steady_clock::now();
+			for (uint32 i = 0; i < iterations; ++i)
+				fn();
+
+			auto end = std::chrono::steady_clock::now();
+			return std::chrono::duration<double, std::milli>(end - start).count() / (double)iterations;
+			}
+
+		static void Report(const char *name, double milliseconds)
+			{
+			FAKE_LOG_INFO("%-48s %10.3f ms", name, milliseconds);
+			}
+
+		static void Report(const char *name, double milliseconds, double baseline)
+			{
+			FAKE_LOG_INFO("%-48s %10.3f ms  (x%.2f)", name, milliseconds, baseline / milliseconds);
+			}
+	};
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <Fake.h>
+
+#include "AsyncBenchmark.h"
+#include "JobSystemBenchmark.h"
+#include "MaterialBenchmark.h"
+#include "MeshCookingBenchmark.h"
+#include "PhysicsBenchmark.h"
+#include "PrefabBenchmark.h"
+#include "SceneRendererBenchmark.h"
+#include "SceneSerializationBenchmark.h"
+#include "ShaderParserBenchmark.h"
+#include "ShaderVariantBenchmark.h"
+#include "SpatialIndexBenchmark.h"
+#include "SpriteBenchmark.h"
+#include "StateCacheBenchmark.h"
+#include "StreamingBenchmark.h"
+#include "SystemSchedulerBenchmark.h"
+#include "TransformHierarchyBenchmark.h"
+
+class BenchmarkTest : public FakeApplication
+	{
+	public:
+
+		BenchmarkTest()
+			{
+			}
+
+		virtual void OnInit() override
+			{
+			JobSystemBenchmark::Run();
+			AsyncBenchmark::Run();
+			ShaderParserBenchmark::Run();
+			ShaderVariantBenchmark::Run();
+			SpriteBenchmark::Run();
+			TransformHierarchyBenchmark::Run();
+			SystemSchedulerBenchmark::Run();
+			SpatialIndexBenchmark::Run();
+			PhysicsBenchmark::Run();
+			SceneSerializationBenchmark::Run();
+			PrefabBenchmark::Run();
+			MeshCookingBenchmark::Run();
+			SceneRendererBenchmark::Run();
+			MaterialBenchmark::Run();
+			StreamingBenchmark::Run();
+			StateCacheBenchmark::Run();
+
+			CloseApplication();
+			}
+
+		virtual void OnShutdown() override
+			{
+			}
+	};
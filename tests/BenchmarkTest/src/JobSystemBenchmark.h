@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cmath>
+
+#include "Benchmark.h"
+
+class JobSystemBenchmark
+	{
+	private:
+
+		static void RunParallelFor(std::vector<float> &data)
+			{
+			FakeJobSystem::ParallelFor((uint32)data.size(), 4096, [&data](uint32 begin, uint32 end)
+				{
+				for (uint32 i = begin; i < end; ++i)
+					data[i] = std::sqrt(data[i] * data[i] + 1.0f) * std::sin(data[i]);
+				});
+			}
+
+		static void RunFanOut(uint32 jobCount)
+			{
+			std::atomic<uint32> sum = 0;
+			FakeJobCounter counter;
+
+			for (uint32 i = 0; i < jobCount; ++i)
+				{
+				FakeJobSystem::Run([&sum, i]()
+					{
+					uint32 value = i;
+					for (uint32 j = 0; j < 256; ++j)
+						value = value * 1664525u + 1013904223u;
+
+					sum.fetch_add(value & 1, std::memory_order_relaxed);
+					}, &counter);
+				}
+
+			FakeJobSystem::Wait(&counter);
+			}
+
+	public:
+
+		static void Run()
+			{
+			const uint32 maxThreads = FAKE_MAX(1u, std::thread::hardware_concurrency());
+			std::vector<float> data(4 * 1024 * 1024);
+			for (uint32 i = 0; i < data.size(); ++i)
+				data[i] = (float)i * 0.001f;
+
+			FAKE_LOG_INFO("JobSystem scaling (1 - %d threads)", maxThreads);
+
+			double parallelForBaseline = 0.0;
+			double fanOutBaseline = 0.0;
+			for (uint32 threads = 1; threads <= maxThreads; ++threads)
+				{
+				FakeJobSystem::Shutdown();
+				FakeJobSystem::Init(threads);
+
+				double parallelFor = Benchmark::Measure(10, [&data]() { RunParallelFor(data); });
+				double fanOut = Benchmark::Measure(10, []() { RunFanOut(100000); });
+
+				if (threads == 1)
+					{
+					parallelForBaseline = parallelFor;
+					fanOutBaseline = fanOut;
+					}
+
+				char name[64];
+				sprintf(name, "ParallelFor 4M elements, %d threads", threads);
+				Benchmark::Report(name, parallelFor, parallelForBaseline);
+
+				sprintf(name, "Run 100k jobs, %d threads", threads);
+				Benchmark::Report(name, fanOut, fanOutBaseline);
+				}
+
+			// Restore the default configuration of the application
+			FakeJobSystem::Shutdown();
+			FakeJobSystem::Init();
+			}
+	};
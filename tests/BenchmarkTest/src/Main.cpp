@@ -0,0 +1,6 @@
+#include "BenchmarkTest.h"
+
+FakeApplication *fake_create_app()
+	{
+	return new BenchmarkTest();
+	}
@@ -0,0 +1,148 @@
+#pragma once
+
+#include "Benchmark.h"
+
+class MaterialBenchmark
+	{
+	private:
+
+		static const uint32 MaterialCount = 256;
+		static const uint32 InstancesPerMaterial = 16;
+
+		// Without materials every draw sets its uniforms by name and binds its textures again
+		static void BindNaive(const std::vector<FakeRef<FakeMaterialInstance>> &instances, const FakeRef<FakeTexture2D> *textures)
+			{
+			for (uint32 i = 0; i < (uint32)instances.size(); ++i)
+				{
+				const FakeRef<FakeMaterialInstance> &instance = instances[i];
+				FakeRef<FakeShader> shader = instance->GetShader();
+				shader->Bind();
+				shader->SetUniform("u_Color", instance->Get<FakeVec4f>("u_Color"));
+				shader->SetUniform("u_Ambient", instance->Get<float>("u_Ambient"));
+				textures[(i / InstancesPerMaterial) % 4]->Bind(0);
+				}
+			}
+
+		static void BindFiltered(const std::vector<FakeRef<FakeMaterialInstance>> &instances)
+			{
+			FakeMaterial::ResetBindState();
+			for (const FakeRef<FakeMaterialInstance> &instance : instances)
+				instance->Bind();
+			FakeMaterial::ResetBindState();
+			}
+
+		template<typename Fn>
+		static double RunFrames(std::vector<FakeRef<FakeMaterial>> &materials, Fn bind)
+			{
+			const uint32 frames = 30;
+			double total = 0.0;
+
+			for (uint32 frame = 0; frame <= frames; ++frame)
+				{
+				// A few materials are animated every frame
+				for (uint32 i = frame % 64; i < MaterialCount; i += 64)
+					materials[i]->Set("u_Ambient", 0.1f + (float)frame * 0.01f);
+
+				auto start = std::chrono::steady_clock::now();
+				bind();
+				FakeRenderer::Render();
+				auto end = std::chrono::steady_clock::now();
+
+				// Frame 0 is the warm-up
+				if (frame > 0)
+					total += std::chrono::duration<double, std::milli>(end - start).count();
+				}
+
+			return total / frames;
+			}
+
+		static bool CheckCopyOnWrite(const FakeRef<FakeMaterial> &material)
+			{
+			FakeRef<FakeMaterialInstance> shared = FakeMaterialInstance::Create(material);
+			FakeRef<FakeMaterialInstance> overridden = FakeMaterialInstance::Create(material);
+
+			// Until something is overridden the instance reads the block of its parent
+			if (shared->GetUniformData("u_Color") != material->GetUniformData("u_Color"))
+				return false;
+
+			overridden->Set("u_Color", FakeVec4f(1.0f, 0.0f, 0.0f, 1.0f));
+			if (overridden->GetUniformData("u_Color") == material->GetUniformData("u_Color") || !overridden->IsOverridden("u_Color"))
+				return false;
+
+			// Values which were not overridden follow the parent, overridden ones keep their value
+			material->Set("u_Ambient", 0.25f);
+			material->Set("u_Color", FakeVec4f(0.0f, 1.0f, 0.0f, 1.0f));
+			return overridden->Get<float>("u_Ambient") == 0.25f && shared->Get<float>("u_Ambient") == 0.25f
+				&& overridden->Get<FakeVec4f>("u_Color").X == 1.0f && shared->Get<FakeVec4f>("u_Color").Y == 1.0f
+				&& !overridden->IsOverridden("u_Ambient");
+			}
+
+	public:
+
+		static void Run()
+			{
+			FakeRef<FakeShaderLibrary> library = FakeRef<FakeShaderLibrary>::Create();
+			library->Load("FakeMeshShader", "assets/shaders/FakeMeshShader.glsl");
+			library->FinishCompilation();
+			FakeRef<FakeShader> shader = library->Get("FakeMeshShader");
+
+			FakeRef<FakeTexture2D> textures[4];
+			uint32 white = 0xffffffff;
+			for (uint32 i = 0; i < 4; ++i)
+				{
+				textures[i] = FakeTexture2D::Create(FakeTextureFormat::RGBA, 1, 1);
+				textures[i]->Lock();
+				textures[i]->SetData(&white, sizeof(uint32));
+				textures[i]->Unlock();
+				}
+
+			// Every material has its own color, every second instance overrides it again
+			std::vector<FakeRef<FakeMaterial>> materials(MaterialCount);
+			std::vector<FakeRef<FakeMaterialInstance>> instances;
+			instances.reserve(MaterialCount * InstancesPerMaterial);
+			for (uint32 i = 0; i < MaterialCount; ++i)
+				{
+				materials[i] = FakeMaterial::Create(shader);
+				materials[i]->Set("u_Color", FakeVec4f((float)(i % 8) / 8.0f, (float)(i / 8 % 8) / 8.0f, 1.0f, 1.0f));
+				materials[i]->Set("u_Ambient", 0.1f);
+				materials[i]->SetTexture("u_Albedo", textures[i % 4]);
+
+				for (uint32 j = 0; j < InstancesPerMaterial; ++j)
+					{
+					FakeRef<FakeMaterialInstance> instance = FakeMaterialInstance::Create(materials[i]);
+					if (j % 2)
+						instance->Set("u_Color", FakeVec4f(1.0f, 1.0f, (float)j / (float)InstancesPerMaterial, 1.0f));
+
+					instances.push_back(instance);
+					}
+				}
+
+			double naive = RunFrames(materials, [&]() { BindNaive(instances, textures); });
+
+			FakeMaterial::ResetStats();
+			double filtered = RunFrames(materials, [&]() { BindFiltered(instances); });
+			FakeMaterial::Statistics stats = FakeMaterial::GetStats();
+
+			uint32 binds = (uint32)instances.size() * 31;
+			FAKE_LOG_INFO("Materials: %d materials with %d instances, one shader", MaterialCount, (uint32)instances.size());
+			Benchmark::Report("Set uniforms by name and bind everything", naive);
+			Benchmark::Report("Bind materials with the state filter", filtered, naive);
+			FAKE_LOG_TRACE("%d binds: %d shader binds, %d texture binds, %d skipped, %d uniform uploads with %d bytes", binds, stats.ShaderBinds, stats.TextureBinds, stats.SkippedBinds, stats.UniformUploads, stats.UniformBytes);
+
+			// One shader bind and one texture bind per material and frame, the instances of a material are bound back to back
+			if (stats.ShaderBinds != 31 || stats.TextureBinds != MaterialCount * 31)
+				FAKE_LOG_ERROR("Material bind filter did not skip redundant state!");
+
+			// Binding the same instance twice must not upload anything
+			FakeMaterial::ResetStats();
+			instances[0]->Bind();
+			instances[0]->Bind();
+			FakeMaterial::ResetBindState();
+			FakeRenderer::Render();
+			if (FakeMaterial::GetStats().ShaderBinds != 1 || FakeMaterial::GetStats().UniformUploads > 1)
+				FAKE_LOG_ERROR("Material bind filter uploaded an unchanged block!");
+
+			if (!CheckCopyOnWrite(materials[0]))
+				FAKE_LOG_ERROR("Material instances do not copy on write!");
+			}
+	};
@@ -0,0 +1,207 @@
+#pragma once
+
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <random>
+
+class MeshCookingBenchmark
+	{
+	private:
+
+		using Triangle = std::array<float, 9>;
+
+		// Exported models rarely come in a good order, shuffling the triangles of a sphere is a fair worst case
+		static void Shuffle(FakeMeshSource &source)
+			{
+			uint32 triangleCount = (uint32)source.Indices.size() / 3;
+			std::vector<uint32> order(triangleCount);
+			for (uint32 i = 0; i < triangleCount; ++i)
+				order[i] = i;
+
+			std::shuffle(order.begin(), order.end(), std::mt19937(1337));
+
+			std::vector<uint32> indices(source.Indices.size());
+			for (uint32 i = 0; i < triangleCount; ++i)
+				{
+				for (uint32 j = 0; j < 3; ++j)
+					indices[i * 3 + j] = source.Indices[order[i] * 3 + j];
+				}
+
+			source.Indices = std::move(indices);
+			}
+
+		static void ReportCache(const char *name, const std::vector<uint32> &indices, uint32 vertexCount)
+			{
+			FakeVertexCacheStatistics fifo16 = FakeMeshOptimizer::AnalyzeVertexCache(indices.data(), (uint32)indices.size(), vertexCount, 16);
+			FakeVertexCacheStatistics fifo32 = FakeMeshOptimizer::AnalyzeVertexCache(indices.data(), (uint32)indices.size(), vertexCount, 32);
+			FAKE_LOG_INFO("%-52s ACMR %.3f / %.3f  ATVR %.3f / %.3f", name, fifo16.ACMR, fifo32.ACMR, fifo16.ATVR, fifo32.ATVR);
+			}
+
+		// Rotates every triangle so it starts with its smallest corner, the winding stays the same
+		template<typename PositionFn>
+		static std::vector<Triangle> CollectTriangles(const uint32 *indices, uint32 indexCount, PositionFn position)
+			{
+			std::vector<Triangle> triangles(indexCount / 3);
+			for (uint32 i = 0; i < indexCount; i += 3)
+				{
+				Triangle corners[3];
+				for (uint32 j = 0; j < 3; ++j)
+					{
+					for (uint32 k = 0; k < 3; ++k)
+						{
+						const float *p = position(indices[i + (j + k) % 3]);
+						corners[j][k * 3 + 0] = p[0];
+						corners[j][k * 3 + 1] = p[1];
+						corners[j][k * 3 + 2] = p[2];
+						}
+					}
+
+				triangles[i / 3] = *std::min_element(corners, corners + 3);
+				}
+
+			std::sort(triangles.begin(), triangles.end());
+			return triangles;
+			}
+
+		// The cooked mesh must contain exactly the source triangles, only their order and the vertex order may change
+		static bool CheckCooked(const FakeMeshSource &source, const std::vector<Byte> &data)
+			{
+			if (!FakeMesh::Validate(data.data(), data.size()))
+				return false;
+
+			// A source without submeshes is cooked as one submesh
+			const FakeMeshFileHeader &header = *(const FakeMeshFileHeader*)data.data();
+			uint32 submeshCount = source.Submeshes.empty() ? 1 : (uint32)source.Submeshes.size();
+			if (header.IndexCount != (uint32)source.Indices.size() || header.SubmeshCount != submeshCount)
+				return false;
+
+			const FakeMeshVertex *vertices = (const FakeMeshVertex*)(data.data() + header.VertexOffset);
+			std::vector<uint32> indices(header.IndexCount);
+			for (uint32 i = 0; i < header.IndexCount; ++i)
+				{
+				if (header.IndexFormat == (uint32)FakeIndexFormat::UInt16)
+					indices[i] = ((const uint16*)(data.data() + header.IndexOffset))[i];
+				else
+					indices[i] = ((const uint32*)(data.data() + header.IndexOffset))[i];
+				}
+
+			std::vector<Triangle> expected = CollectTriangles(source.Indices.data(), (uint32)source.Indices.size(), [&source](uint32 index)
+				{
+				return &source.Vertices[index].Position.X;
+				});
+
+			std::vector<Triangle> cooked = CollectTriangles(indices.data(), (uint32)indices.size(), [vertices](uint32 index)
+				{
+				return vertices[index].Position;
+				});
+
+			return cooked == expected;
+			}
+
+		static void RunMesh(const char *name, FakeMeshSource &source, bool shuffle)
+			{
+			if (shuffle)
+				Shuffle(source);
+
+			uint32 vertexCount = (uint32)source.Vertices.size();
+			uint32 indexCount = (uint32)source.Indices.size();
+
+			std::vector<FakeVec3f> positions(vertexCount);
+			for (uint32 i = 0; i < vertexCount; ++i)
+				positions[i] = source.Vertices[i].Position;
+
+			FAKE_LOG_INFO("Mesh cooking: %s (%d vertices, %d triangles)", name, vertexCount, indexCount / 3);
+
+			std::vector<uint32> cacheOptimized(indexCount);
+			std::vector<uint32> overdrawOptimized(indexCount);
+
+			double cache = Benchmark::Measure(3, [&]()
+				{
+				FakeMeshOptimizer::OptimizeVertexCache(cacheOptimized.data(), source.Indices.data(), indexCount, vertexCount);
+				});
+
+			double overdraw = Benchmark::Measure(3, [&]()
+				{
+				FakeMeshOptimizer::OptimizeOverdraw(overdrawOptimized.data(), cacheOptimized.data(), indexCount, positions.data(), vertexCount);
+				});
+
+			std::vector<uint32> remap(vertexCount);
+			std::vector<uint32> fetchOptimized;
+			double fetch = Benchmark::Measure(3, [&]()
+				{
+				fetchOptimized = overdrawOptimized;
+				FakeMeshOptimizer::OptimizeVertexFetch(remap.data(), fetchOptimized.data(), indexCount, vertexCount);
+				});
+
+			std::vector<Byte> data;
+			double cook = Benchmark::Measure(3, [&]()
+				{
+				FakeMeshCooker::Cook(source, data);
+				});
+
+			double validate = Benchmark::Measure(10, [&data]()
+				{
+				FakeMesh::Validate(data.data(), data.size());
+				});
+
+			// The load path of FakeMesh::Create() without the upload, which needs a context
+			const char *path = "MeshCookingBenchmark.fakemesh";
+			FILE *file = std::fopen(path, "wb");
+			if (file)
+				{
+				std::fwrite(data.data(), 1, data.size(), file);
+				std::fclose(file);
+				}
+
+			double mapped = Benchmark::Measure(10, [path]()
+				{
+				FakeMappedFile mappedFile;
+				if (mappedFile.Open(path))
+					FakeMesh::Validate(mappedFile.GetData(), mappedFile.GetSize());
+				});
+
+			std::remove(path);
+
+			ReportCache("Source order", source.Indices, vertexCount);
+			ReportCache("Vertex cache optimized", cacheOptimized, vertexCount);
+			ReportCache("Vertex cache and overdraw optimized", overdrawOptimized, vertexCount);
+
+			Benchmark::Report("Vertex cache optimization", cache);
+			Benchmark::Report("Overdraw optimization", overdraw);
+			Benchmark::Report("Vertex fetch optimization", fetch);
+			Benchmark::Report("Cook everything", cook);
+			Benchmark::Report("Validate cooked mesh", validate);
+			Benchmark::Report("Validate cooked mesh from mapped file", mapped);
+
+			uint64 uncooked = (uint64)vertexCount * sizeof(FakeMeshSourceVertex) + (uint64)indexCount * sizeof(uint32);
+			FAKE_LOG_TRACE("Cooked size %.2f MB, uncooked %.2f MB", (double)data.size() / (1024.0 * 1024.0), (double)uncooked / (1024.0 * 1024.0));
+
+			FakeVertexCacheStatistics before = FakeMeshOptimizer::AnalyzeVertexCache(source.Indices.data(), indexCount, vertexCount);
+			FakeVertexCacheStatistics after = FakeMeshOptimizer::AnalyzeVertexCache(cacheOptimized.data(), indexCount, vertexCount);
+			if (shuffle && after.ACMR >= before.ACMR)
+				FAKE_LOG_ERROR("Vertex cache optimization did not lower the ACMR!");
+
+			if (!CheckCooked(source, data))
+				FAKE_LOG_ERROR("Cooked mesh does not match the source!");
+			}
+
+	public:
+
+		static void Run()
+			{
+			FakeMeshSource source;
+
+			FakeMeshFactory::SphereSource(1.0f, 256, 128, source);
+			RunMesh("sphere", source, false);
+
+			FakeMeshFactory::SphereSource(1.0f, 256, 128, source);
+			RunMesh("shuffled sphere", source, true);
+
+			// Too many vertices for 16 bit indices
+			FakeMeshFactory::CapsuleSource(0.5f, 2.0f, 512, 256, source);
+			RunMesh("shuffled capsule", source, true);
+			}
+	};
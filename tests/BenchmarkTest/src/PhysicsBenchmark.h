@@ -0,0 +1,102 @@
+#pragma once
+
+#include "Benchmark.h"
+
+class PhysicsBenchmark
+	{
+	private:
+
+		static void RunScene(uint32 bodyCount)
+			{
+			const uint32 columns = 100;
+			const float frameTime = 1.0f / 60.0f;
+
+			FakeScene scene(1280, 720);
+
+			// A box open at the top, wide enough for a hundred columns
+			const FakeVec3f walls[][2] = {
+				{ {   0.0f, -1.0f, 0.0f }, { 120.0f,   1.0f, 1.0f } },
+				{ { -60.0f, 50.0f, 0.0f }, {   1.0f, 100.0f, 1.0f } },
+				{ {  60.0f, 50.0f, 0.0f }, {   1.0f, 100.0f, 1.0f } }
+				};
+
+			for (const auto &wall : walls)
+				{
+				FakeEntity entity = scene.CreateEntity("Wall");
+				FakeTransformComponent &transform = entity.GetComponent<FakeTransformComponent>();
+				transform.Translation = wall[0];
+				transform.Scale = wall[1];
+				entity.AddComponent<FakeBoxColliderComponent>();
+				entity.AddComponent<FakeRigidbodyComponent>(FakeRigidbodyType::Static);
+				}
+
+			std::vector<FakeEntity> bodies;
+			bodies.reserve(bodyCount);
+			for (uint32 i = 0; i < bodyCount; ++i)
+				{
+				FakeEntity entity = scene.CreateEntity();
+				entity.GetComponent<FakeTransformComponent>().Translation = { (float)(i % columns) * 1.1f - 55.0f, 1.0f + (float)(i / columns) * 1.1f, 0.0f };
+
+				if (i % 2)
+					entity.AddComponent<FakeBoxColliderComponent>();
+				else
+					entity.AddComponent<FakeCircleColliderComponent>();
+
+				entity.AddComponent<FakeRigidbodyComponent>(FakeRigidbodyType::Dynamic);
+				bodies.push_back(entity);
+				}
+
+			// Let the pile collapse for a second, so the measured frames have contacts
+			for (uint32 i = 0; i < 60; ++i)
+				scene.OnRenderRuntime(frameTime);
+
+			double frame = Benchmark::Measure(60, [&scene, frameTime]()
+				{
+				scene.OnRenderRuntime(frameTime);
+				});
+
+			// A frame between two fixed steps only interpolates and writes the transforms
+			double interpolate = Benchmark::Measure(60, [&scene]()
+				{
+				scene.OnRenderRuntime(0.0);
+				});
+
+			// Baseline: writing every pose back with its own update signal
+			std::vector<FakeVec3f> poses(bodyCount);
+			for (uint32 i = 0; i < bodyCount; ++i)
+				{
+				const FakeTransformComponent &transform = bodies[i].GetComponent<FakeTransformComponent>();
+				poses[i] = { transform.Translation.X, transform.Translation.Y, transform.Rotation.Z };
+				}
+
+			double perEntity = Benchmark::Measure(60, [&]()
+				{
+				for (uint32 i = 0; i < bodyCount; ++i)
+					{
+					const FakeVec3f &pose = poses[i];
+					bodies[i].PatchComponent<FakeTransformComponent>([&pose](FakeTransformComponent &t)
+						{
+						t.Translation.X = pose.X;
+						t.Translation.Y = pose.Y;
+						t.Rotation.Z = pose.Z;
+						});
+					}
+
+				scene.UpdateTransforms();
+				});
+
+			FAKE_LOG_INFO("Physics (%d bodies, %d moving)", bodyCount, (uint32)scene.GetPhysicsWorld().GetMovedEntities().size());
+			Benchmark::Report("Frame with one fixed step", frame);
+			Benchmark::Report("Sync with PatchComponent per entity", perEntity);
+			Benchmark::Report("Interpolated bulk sync between steps", interpolate, perEntity);
+			}
+
+	public:
+
+		static void Run()
+			{
+			RunScene(1000);
+			RunScene(4000);
+			RunScene(10000);
+			}
+	};
@@ -0,0 +1,122 @@
+#pragma once
+
+#include "Benchmark.h"
+
+class PrefabBenchmark
+	{
+	private:
+
+		// Every spawn needs an empty scene, creating and destroying it is not measured
+		template<typename Fn>
+		static double MeasureSpawn(uint32 iterations, Fn fn)
+			{
+			double total = 0.0;
+			for (uint32 i = 0; i <= iterations; ++i)
+				{
+				FakeScene scene(1280, 720);
+
+				auto start = std::chrono::steady_clock::now();
+				fn(scene);
+				auto end = std::chrono::steady_clock::now();
+
+				// The first spawn is a warm-up, same as in Benchmark::Measure()
+				if (i > 0)
+					total += std::chrono::duration<double, std::milli>(end - start).count();
+				}
+
+			return total / (double)iterations;
+			}
+
+		static bool CheckInstances(FakeScene &scene, FakePrefab &prefab, const std::vector<FakeTransformComponent> &transforms)
+			{
+			std::vector<FakeEntity> entities;
+			scene.Instantiate(prefab, (uint32)transforms.size(), transforms.data(), &entities);
+			if (entities.size() != transforms.size())
+				return false;
+
+			for (uint32 i = 0; i < (uint32)entities.size(); ++i)
+				{
+				FakeEntity entity = entities[i];
+				if (entity.GetComponent<FakeTransformComponent>().Translation != transforms[i].Translation)
+					return false;
+
+				if (!entity.HasComponent<FakeRigidbodyComponent>() || entity.GetComponent<FakeSpriteComponent>().Texture.Raw() != prefab.GetComponent<FakeSpriteComponent>().Texture.Raw())
+					return false;
+				}
+
+			// Renaming one instance must not rename the others
+			FakeTagComponent &first = entities[0].GetComponent<FakeTagComponent>();
+			FakeTagComponent &second = entities[1].GetComponent<FakeTagComponent>();
+			if (!first.IsShared() || &first.GetTag() != &second.GetTag())
+				return false;
+
+			first.SetTag("Renamed");
+			return first.GetTag() == "Renamed" && second.GetTag() == "Bullet";
+			}
+
+	public:
+
+		static void Run()
+			{
+			const uint32 count = 100000;
+
+			uint32 white = 0xffffffff;
+			FakeRef<FakeTexture2D> texture = FakeTexture2D::Create(FakeTextureFormat::RGBA, 1, 1);
+			texture->Lock();
+			texture->SetData(&white, sizeof(uint32));
+			texture->Unlock();
+
+			std::vector<FakeTransformComponent> transforms(count);
+			for (uint32 i = 0; i < count; ++i)
+				{
+				transforms[i].Translation = { (float)(i % 400) * 0.25f, (float)(i / 400) * 0.25f, 0.0f };
+				transforms[i].Scale = { 0.1f, 0.1f, 1.0f };
+				}
+
+			FakeRef<FakePrefab> bullet = FakeRef<FakePrefab>::Create("Bullet");
+			bullet->AddComponent<FakeSpriteComponent>(texture, FakeVec4f(1.0f, 0.8f, 0.2f, 1.0f));
+			bullet->AddComponent<FakeBoundsComponent>();
+			bullet->AddComponent<FakeCircleColliderComponent>(0.05f);
+			bullet->AddComponent<FakeRigidbodyComponent>(FakeRigidbodyType::Dynamic).Bullet = true;
+
+			// Baseline: one entity at a time, the way spawners are written without prefabs
+			double perEntity = MeasureSpawn(3, [&](FakeScene &scene)
+				{
+				for (uint32 i = 0; i < count; ++i)
+					{
+					FakeEntity entity = scene.CreateEntity("Bullet");
+					FakeTransformComponent &transform = entity.GetComponent<FakeTransformComponent>();
+					transform.Translation = transforms[i].Translation;
+					transform.Scale = transforms[i].Scale;
+
+					entity.AddComponent<FakeSpriteComponent>(texture, FakeVec4f(1.0f, 0.8f, 0.2f, 1.0f));
+					entity.AddComponent<FakeBoundsComponent>();
+					entity.AddComponent<FakeCircleColliderComponent>(0.05f);
+					entity.AddComponent<FakeRigidbodyComponent>(FakeRigidbodyType::Dynamic).Bullet = true;
+					}
+				});
+
+			double instantiate = MeasureSpawn(3, [&](FakeScene &scene)
+				{
+				scene.Instantiate(*bullet, count, transforms.data());
+				});
+
+			// Spawning in small waves, e.g. one burst of a weapon per frame
+			double waves = MeasureSpawn(3, [&](FakeScene &scene)
+				{
+				for (uint32 i = 0; i < count; i += 100)
+					scene.Instantiate(*bullet, 100, transforms.data() + i);
+				});
+
+			// The times are those of spawning all entities of a run, not of one entity
+			FAKE_LOG_INFO("Prefab instancing (%d entities per run)", count);
+			Benchmark::Report("Spawn with CreateEntity and AddComponent", perEntity);
+			Benchmark::Report("Spawn with one Instantiate", instantiate, perEntity);
+			Benchmark::Report("Spawn with Instantiate in waves of 100", waves, perEntity);
+			FAKE_LOG_INFO("Per entity: %.1f ns, %.1f ns and %.1f ns", perEntity * 1e6 / count, instantiate * 1e6 / count, waves * 1e6 / count);
+
+			FakeScene scene(1280, 720);
+			if (!CheckInstances(scene, *bullet, transforms))
+				FAKE_LOG_ERROR("Prefab instances do not match the prefab!");
+			}
+	};
@@ -0,0 +1,143 @@
+#pragma once
+
+#include "Benchmark.h"
+
+#include <set>
+#include <utility>
+
+class SceneRendererBenchmark
+	{
+	private:
+
+		struct Object
+			{
+			uint32 Mesh;
+			uint32 Material;
+			FakeMat4f Transform;
+			};
+
+		// What drawing every object on its own would cost, in submission order
+		static uint32 CountNaiveStateChanges(const std::vector<Object> &objects)
+			{
+			uint32 changes = 0;
+			uint32 lastMesh = ~0u;
+			uint32 lastMaterial = ~0u;
+			for (const Object &object : objects)
+				{
+				changes += (object.Mesh != lastMesh) + (object.Material != lastMaterial);
+				lastMesh = object.Mesh;
+				lastMaterial = object.Material;
+				}
+
+			return changes;
+			}
+
+		static double RunFrames(const std::vector<Object> &objects, const FakeRef<FakeMesh> *meshes, const FakeRef<FakeMaterial> *materials, const FakeMat4f &viewProjection, const FakeVec3f &cameraPosition, double &outExecute)
+			{
+			const uint32 frames = 30;
+			double submit = 0.0;
+			outExecute = 0.0;
+
+			for (uint32 frame = 0; frame <= frames; ++frame)
+				{
+				FakeSceneRenderer::ResetStats();
+
+				auto start = std::chrono::steady_clock::now();
+				FakeSceneRenderer::BeginScene(viewProjection, cameraPosition);
+				for (const Object &object : objects)
+					FakeSceneRenderer::SubmitMesh(meshes[object.Mesh], materials[object.Material], object.Transform);
+				FakeSceneRenderer::EndScene();
+				auto end = std::chrono::steady_clock::now();
+
+				FakeRenderer::Render();
+				auto executed = std::chrono::steady_clock::now();
+
+				// Frame 0 is the warm-up
+				if (frame > 0)
+					{
+					submit += std::chrono::duration<double, std::milli>(end - start).count();
+					outExecute += std::chrono::duration<double, std::milli>(executed - end).count();
+					}
+				}
+
+			outExecute /= frames;
+			return submit / frames;
+			}
+
+		static void RunScene(const char *name, uint32 objectCount, bool transparent, const FakeRef<FakeMesh> *meshes, FakeRef<FakeMaterial> *materials)
+			{
+			const uint32 meshCount = 3;
+			const uint32 materialCount = 8;
+
+			for (uint32 i = 0; i < materialCount; ++i)
+				materials[i]->SetFlag(FakeMaterialFlags::Blend, transparent && i == materialCount - 1);
+
+			// Objects in a grid with mesh and material interleaved, the worst case for drawing in submission order
+			std::vector<Object> objects(objectCount);
+			for (uint32 i = 0; i < objectCount; ++i)
+				{
+				objects[i].Mesh = i % meshCount;
+				objects[i].Material = (i * 7 + i / 5) % materialCount;
+				FakeMat4f::Translate((float)(i % 200) * 2.0f - 200.0f, 0.0f, -(float)(i / 200) * 2.0f, objects[i].Transform);
+				}
+
+			FakeVec3f cameraPosition(0.0f, 30.0f, 40.0f);
+			FakeMat4f view = FakeMat4f::LookAt(cameraPosition, FakeVec3f(0.0f, 0.0f, -100.0f), FakeVec3f(0.0f, 1.0f, 0.0f));
+			FakeMat4f projection, viewProjection;
+			FakeMat4f::PerspectiveFOV(fake_radians(60.0f), 16.0f / 9.0f, 0.1f, 1000.0f, projection);
+			FakeMat4f::Multiply(view, projection, viewProjection);
+
+			double execute = 0.0;
+			double submit = RunFrames(objects, meshes, materials, viewProjection, cameraPosition, execute);
+			FakeSceneRenderer::Statistics stats = FakeSceneRenderer::GetStats();
+
+			FAKE_LOG_INFO("Scene renderer: %s (%d objects)", name, objectCount);
+			Benchmark::Report("Submit, sort and record", submit);
+			Benchmark::Report("Execute render commands", execute);
+			FAKE_LOG_TRACE("%d draws for %d instances, %d state changes (%d shader, %d material, %d mesh)", stats.DrawCalls, stats.InstanceCount, stats.GetStateChanges(), stats.ShaderChanges, stats.MaterialChanges, stats.MeshChanges);
+			FAKE_LOG_TRACE("Without batching: %d draws, %d state changes", objectCount, CountNaiveStateChanges(objects));
+
+			if (stats.InstanceCount != objectCount)
+				FAKE_LOG_ERROR("Scene renderer dropped instances!");
+
+			// Opaque objects which fit into one chunk must end up in one draw per mesh and material
+			if (!transparent)
+				{
+				std::set<std::pair<uint32, uint32>> pairs;
+				for (const Object &object : objects)
+					pairs.emplace(object.Mesh, object.Material);
+
+				if (stats.DrawCalls != (uint32)pairs.size() || stats.MaterialChanges != materialCount)
+					FAKE_LOG_ERROR("Scene renderer did not merge all instances!");
+				}
+			}
+
+	public:
+
+		static void Run()
+			{
+			FakeRef<FakeShaderLibrary> library = FakeRef<FakeShaderLibrary>::Create();
+			library->Load("FakeMeshShaderA", "assets/shaders/FakeMeshShader.glsl");
+			library->Load("FakeMeshShaderB", "assets/shaders/FakeMeshShader.glsl");
+			library->FinishCompilation();
+
+			FakeRef<FakeMesh> meshes[3] =
+				{
+				FakeMeshFactory::Cube(FakeVec3f(1.0f, 1.0f, 1.0f)),
+				FakeMeshFactory::Sphere(0.5f),
+				FakeMeshFactory::Capsule(0.25f, 1.0f)
+				};
+
+			// Two shaders with four materials each
+			FakeRef<FakeMaterial> materials[8];
+			for (uint32 i = 0; i < 8; ++i)
+				{
+				materials[i] = FakeMaterial::Create(library->Get(i < 4 ? "FakeMeshShaderA" : "FakeMeshShaderB"));
+				materials[i]->Set("u_Color", FakeVec4f(1.0f, 1.0f, 1.0f, 0.8f));
+				materials[i]->Set("u_Ambient", 0.1f);
+				}
+
+			RunScene("opaque", 10000, false, meshes, materials);
+			RunScene("opaque and transparent", 50000, true, meshes, materials);
+			}
+	};
@@ -0,0 +1,261 @@
+#pragma once
+
+#include "Benchmark.h"
+
+#include <cstdio>
+
+class SceneSerializationBenchmark
+	{
+	private:
+
+		// Every load needs an empty scene, creating and destroying it is not measured
+		template<typename Fn>
+		static double MeasureLoad(uint32 iterations, Fn fn)
+			{
+			double total = 0.0;
+			for (uint32 i = 0; i <= iterations; ++i)
+				{
+				FakeScene target(1280, 720);
+
+				auto start = std::chrono::steady_clock::now();
+				fn(target);
+				auto end = std::chrono::steady_clock::now();
+
+				// The first load is a warm-up, same as in Benchmark::Measure()
+				if (i > 0)
+					total += std::chrono::duration<double, std::milli>(end - start).count();
+				}
+
+			return total / (double)iterations;
+			}
+
+		static void BuildScene(FakeScene &scene, uint32 entityCount)
+			{
+			FakeEntity camera = scene.CreateEntity("Camera");
+			camera.AddComponent<FakeCameraComponent>().Camera.SetPerspective(fake_radians(60.0f), 0.1f, 500.0f);
+
+			FakeEntity parent;
+			for (uint32 i = 1; i < entityCount; ++i)
+				{
+				FakeEntity entity = scene.CreateEntity(i % 100 ? "Tile" : "Group");
+				FakeTransformComponent &transform = entity.GetComponent<FakeTransformComponent>();
+				transform.Translation = { (float)(i % 1000) * 1.5f, (float)(i / 1000) * 1.5f, 0.0f };
+				transform.Rotation = { 0.0f, 0.0f, (float)i * 0.01f };
+
+				// Every hundredth entity starts a group, the next few are its children
+				if (i % 100 == 0)
+					parent = entity;
+				else if (i % 100 < 4)
+					scene.SetParent(entity, parent);
+
+				if (i % 2)
+					entity.AddComponent<FakeSpriteComponent>(FakeVec4f((float)(i % 7) / 7.0f, 0.5f, 1.0f, 1.0f));
+
+				if (i % 4 == 0)
+					entity.AddComponent<FakeBoundsComponent>();
+
+				if (i % 50 == 0)
+					{
+					entity.AddComponent<FakeBoxColliderComponent>(FakeVec2f(0.5f, 0.25f));
+					entity.AddComponent<FakeRigidbodyComponent>(FakeRigidbodyType::Dynamic).LinearDamping = 0.1f;
+					}
+				}
+			}
+
+		static bool RoundTripYAML(FakeScene &scene)
+			{
+			FakeString text = FakeSceneSerializer(scene).SerializeToString();
+
+			FakeScene loaded(1280, 720);
+			if (!FakeSceneSerializer(loaded).DeserializeFromString(text))
+				return false;
+
+			return FakeSceneSerializer(loaded).SerializeToString() == text;
+			}
+
+		// The layout of FakeSceneBinarySerializer.cpp, corrupt files are made by patching a valid one
+		struct FileHeader
+			{
+			uint32 Magic;
+			uint32 Version;
+			uint32 EntityCount;
+			uint32 ChunkCount;
+			};
+
+		struct FileChunk
+			{
+			uint32 Type;
+			uint32 Flags;
+			uint32 Count;
+			uint32 RecordSize;
+			uint64 IndexOffset;
+			uint64 DataOffset;
+			};
+
+		struct HierarchyRecord
+			{
+			uint32 Parent;
+			uint32 FirstChild;
+			uint32 NextSibling;
+			uint32 Depth;
+			};
+
+		static const uint32 DenseChunk = 1;
+		static const uint32 HierarchyChunk = 3;
+
+		static bool Rejects(const std::vector<Byte> &file)
+			{
+			FakeScene target(1280, 720);
+			return !FakeSceneBinarySerializer(target).Deserialize(file.data(), file.size());
+			}
+
+		// Each of these files would add a component twice or make UpdateTransforms() loop, the errors they log are expected
+		static bool RejectsCorruptFiles(const std::vector<Byte> &data)
+			{
+			const uint32 chunkCount = ((const FileHeader*)data.data())->ChunkCount;
+			bool rejected = true;
+
+				{
+				// The same chunk twice
+				std::vector<Byte> file = data;
+				FileChunk *chunks = (FileChunk*)(file.data() + sizeof(FileHeader));
+				chunks[chunkCount - 1] = chunks[chunkCount - 2];
+				rejected &= Rejects(file);
+				}
+
+				{
+				// One entity twice in a sparse chunk
+				std::vector<Byte> file = data;
+				FileChunk *chunks = (FileChunk*)(file.data() + sizeof(FileHeader));
+				for (uint32 i = 0; i < chunkCount; ++i)
+					{
+					if (!(chunks[i].Flags & DenseChunk) && chunks[i].Count > 1)
+						{
+						uint32 *indices = (uint32*)(file.data() + chunks[i].IndexOffset);
+						indices[1] = indices[0];
+						rejected &= Rejects(file);
+						break;
+						}
+					}
+				}
+
+				{
+				// A parent which is the child of its own child
+				std::vector<Byte> file = data;
+				FileChunk *chunks = (FileChunk*)(file.data() + sizeof(FileHeader));
+				for (uint32 i = 0; i < chunkCount; ++i)
+					{
+					if (chunks[i].Type != HierarchyChunk)
+						continue;
+
+					const uint32 *indices = (chunks[i].Flags & DenseChunk) ? nullptr : (const uint32*)(file.data() + chunks[i].IndexOffset);
+					HierarchyRecord *records = (HierarchyRecord*)(file.data() + chunks[i].DataOffset);
+
+					std::unordered_map<uint32, HierarchyRecord*> hierarchies;
+					for (uint32 r = 0; r < chunks[i].Count; ++r)
+						hierarchies[indices ? indices[r] : r] = &records[r];
+
+					for (auto [entity, record] : hierarchies)
+						{
+						if (record->Parent != ~0u)
+							{
+							hierarchies[record->Parent]->Parent = entity;
+							break;
+							}
+						}
+
+					rejected &= Rejects(file);
+					}
+				}
+
+			return rejected;
+			}
+
+		static bool RoundTripBinary(FakeScene &scene)
+			{
+			std::vector<Byte> data;
+			FakeSceneBinarySerializer(scene).Serialize(data);
+
+			FakeScene loaded(1280, 720);
+			if (!FakeSceneBinarySerializer(loaded).Deserialize(data.data(), data.size()))
+				return false;
+
+			std::vector<Byte> reserialized;
+			FakeSceneBinarySerializer(loaded).Serialize(reserialized);
+			if (reserialized != data)
+				return false;
+
+			// A truncated file must be rejected as a whole, the error it logs is expected
+			FakeScene truncated(1280, 720);
+			if (FakeSceneBinarySerializer(truncated).Deserialize(data.data(), data.size() / 2))
+				return false;
+
+			return RejectsCorruptFiles(data);
+			}
+
+		static void RunScene(uint32 entityCount, bool yaml)
+			{
+			FakeScene scene(1280, 720);
+			BuildScene(scene, entityCount);
+
+			FAKE_LOG_INFO("Scene serialization (%d entities)", entityCount);
+
+			if (yaml)
+				{
+				FakeString text;
+				double save = Benchmark::Measure(1, [&]()
+					{
+					text = FakeSceneSerializer(scene).SerializeToString();
+					});
+
+				double load = MeasureLoad(1, [&text](FakeScene &target)
+					{
+					FakeSceneSerializer(target).DeserializeFromString(text);
+					});
+
+				Benchmark::Report("YAML save", save);
+				Benchmark::Report("YAML load", load);
+
+				if (!RoundTripYAML(scene))
+					FAKE_LOG_ERROR("YAML round trip changed the scene!");
+				}
+
+			std::vector<Byte> data;
+			double save = Benchmark::Measure(3, [&]()
+				{
+				FakeSceneBinarySerializer(scene).Serialize(data);
+				});
+
+			double load = MeasureLoad(3, [&data](FakeScene &target)
+				{
+				FakeSceneBinarySerializer(target).Deserialize(data.data(), data.size());
+				});
+
+			const char *path = "SceneSerializationBenchmark.fakescene";
+			FakeSceneBinarySerializer(scene).Serialize(path);
+
+			double mapped = MeasureLoad(3, [path](FakeScene &target)
+				{
+				FakeSceneBinarySerializer(target).Deserialize(path);
+				});
+
+			std::remove(path);
+
+			Benchmark::Report("Binary save", save);
+			Benchmark::Report("Binary load from memory", load);
+			Benchmark::Report("Binary load from mapped file", mapped);
+			FAKE_LOG_TRACE("Binary file size %.2f MB", (double)data.size() / (1024.0 * 1024.0));
+
+			if (!RoundTripBinary(scene))
+				FAKE_LOG_ERROR("Binary round trip changed the scene!");
+			}
+
+	public:
+
+		static void Run()
+			{
+			RunScene(10000, true);
+			RunScene(100000, false);
+			RunScene(1000000, false);
+			}
+	};
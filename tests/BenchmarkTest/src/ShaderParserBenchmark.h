@@ -0,0 +1,129 @@
+#pragma once
+
+#include "Benchmark.h"
+
+class ShaderParserBenchmark
+	{
+	private:
+
+		// Builds a combined vertex/fragment source with roughly the given amount of lines
+		static std::string GenerateCorpus(uint32 lineCount)
+			{
+			std::string stages[2];
+			const char *types[2] = { "vertex", "fragment" };
+
+			for (uint32 stage = 0; stage < 2; ++stage)
+				{
+				std::string &src = stages[stage];
+				src += "#type ";
+				src += types[stage];
+				src += "\n#version 450 core\n\n";
+
+				uint32 lines = 3;
+				uint32 block = 0;
+				while (lines < lineCount / 2)
+					{
+					std::string n = std::to_string(block++);
+					src += "// Light block " + n + "\n";
+					src += "struct Light" + n + "\n\t{\n\tvec3 Position;\n\tvec3 Color;\n\tfloat Radius;\n\tfloat Intensities[4];\n\t};\n\n";
+					src += "uniform Light" + n + " u_Light" + n + ";\n";
+					src += "uniform mat4 r_ViewProjection" + n + ";\n";
+					src += "uniform vec4 u_Tint" + n + ", u_Params" + n + "[8];\n";
+					src += "uniform sampler2D u_Texture" + n + ";\n";
+					src += "layout(std140, binding = 0) uniform Camera" + n + "\n\t{\n\tmat4 View;\n\t} camera" + n + ";\n\n";
+					src += "/* Evaluates the light\n   contribution */\n";
+					src += "vec3 Shade" + n + "(vec3 p)\n\t{\n\tvec3 d = u_Light" + n + ".Position - p;\n";
+					src += "\tfloat att = clamp(1.0 - length(d) / u_Light" + n + ".Radius, 0.0, 1.0);\n";
+					src += "\treturn u_Light" + n + ".Color * att * u_Tint" + n + ".rgb;\n\t}\n\n";
+					lines += 28;
+					}
+
+				src += "void main()\n\t{\n\t}\n";
+				}
+
+			return stages[0] + stages[1];
+			}
+
+		// The line the compiler reports for the line of the stage which starts with text, following the #line directives
+		static uint32 GetReportedLine(const std::string &source, std::string_view text)
+			{
+			uint32 line = 1;
+			std::string_view rest = source;
+			while (!rest.empty())
+				{
+				size_t eol = rest.find('\n');
+				std::string_view current = rest.substr(0, eol);
+				rest.remove_prefix(eol == std::string_view::npos ? rest.size() : eol + 1);
+
+				if (current.compare(0, text.size(), text) == 0)
+					return line;
+
+				line = current.compare(0, 6, "#line ") == 0 ? (uint32)std::stoul(std::string(current.substr(6))) : line + 1;
+				}
+
+			return 0;
+			}
+
+		static bool CheckLinesAndArraySizes()
+			{
+			const char *source =
+				"#keywords SHADOWS\n"
+				"#type vertex\n"
+				"#version 450 core\n"
+				"\n"
+				"#define LIGHT_COUNT 4\n"
+				"#define LIGHT_SLOTS LIGHT_COUNT\n"
+				"\n"
+				"uniform vec4 u_Lights[LIGHT_SLOTS];\n"
+				"uniform float u_Weights[FAKE_MAX_LIGHTS];\n"
+				"\n"
+				"void main()\n"
+				"\t{\n"
+				"\t}\n";
+
+			FakeShaderDefineList defines = { { "FAKE_MAX_LIGHTS", "16" }, { "FAKE_USE_SHADOWS", "" } };
+			std::vector<FakeShaderStageSource> stages = FakeShaderPreprocessor::Process(source, "", defines);
+			if (stages.size() != 1)
+				return false;
+
+			FakeShaderReflection reflection;
+			reflection.Parse(stages[0].Source, FakeShaderDomain::Vertex);
+
+			const std::vector<FakeShaderReflectionEntry> &entries = reflection.GetEntries();
+			return GetReportedLine(stages[0].Source, "uniform vec4") == 8 && GetReportedLine(stages[0].Source, "void main") == 11
+				&& entries.size() == 2 && entries[0].Count == 4 && entries[1].Count == 16;
+			}
+
+	public:
+
+		static void Run()
+			{
+			std::string corpus = GenerateCorpus(5000);
+			uint32 lineCount = (uint32)std::count(corpus.begin(), corpus.end(), '\n');
+
+			FakeShaderDefineList defines = { { "FAKE_MAX_LIGHTS", "16" }, { "FAKE_USE_SHADOWS", "" } };
+			FAKE_LOG_INFO("Shader parser (%d lines, %d KiB)", lineCount, (uint32)(corpus.size() / 1024));
+
+			std::vector<FakeShaderStageSource> stages;
+			double preprocess = Benchmark::Measure(50, [&]()
+				{
+				stages = FakeShaderPreprocessor::Process(corpus, "", defines);
+				});
+
+			FakeShaderReflection reflection;
+			double reflect = Benchmark::Measure(50, [&]()
+				{
+				reflection.Clear();
+				for (const FakeShaderStageSource &stage : stages)
+					reflection.Parse(stage.Source, stage.Stage == FakeShaderStage::Vertex ? FakeShaderDomain::Vertex : FakeShaderDomain::Fragment);
+				});
+
+			Benchmark::Report("Preprocess 5k lines", preprocess);
+			Benchmark::Report("Reflect 5k lines", reflect);
+			Benchmark::Report("Preprocess + reflect 5k lines", preprocess + reflect);
+			FAKE_LOG_INFO("%d reflection entries, %.1f MLines/s", (uint32)reflection.GetEntries().size(), (double)lineCount / ((preprocess + reflect) * 1000.0));
+
+			if (!CheckLinesAndArraySizes())
+				FAKE_LOG_ERROR("Preprocessed shaders report the wrong lines or array sizes!");
+			}
+	};
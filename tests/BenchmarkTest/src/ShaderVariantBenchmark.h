@@ -0,0 +1,48 @@
+#pragma once
+
+#include "Benchmark.h"
+
+class ShaderVariantBenchmark
+	{
+	public:
+
+		static void Run()
+			{
+			FakeRef<FakeShaderLibrary> library = FakeRef<FakeShaderLibrary>::Create();
+			uint32 family = library->LoadVariants("assets/shaders/FakeVariantShader.glsl");
+
+			// Every combination of the three keywords
+			std::vector<FakeShaderVariantKey> keys;
+			for (FakeShaderVariantKey key = 0; key < 8; ++key)
+				keys.push_back(key);
+
+			// Measure() would only time the cached second run
+			auto start = std::chrono::steady_clock::now();
+			library->Prewarm(family, keys);
+			library->FinishCompilation();
+			double prewarm = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+			const uint32 lookups = 1000000;
+			uint64 sum = 0;
+			double variant = Benchmark::Measure(10, [&]()
+				{
+				for (uint32 i = 0; i < lookups; ++i)
+					sum += (uint64)library->GetVariant(family, i & 7).Raw();
+				});
+
+			// The same lookups through the name based map
+			library->Add(library->GetVariant(family, 0));
+			const FakeString name = library->GetVariant(family, 0)->GetName();
+			double named = Benchmark::Measure(10, [&]()
+				{
+				for (uint32 i = 0; i < lookups; ++i)
+					sum += (uint64)library->Get(name).Raw();
+				});
+
+			FAKE_LOG_INFO("Shader variants (%d compiled)", library->GetVariantCount());
+			Benchmark::Report("Prewarm 8 variants", prewarm);
+			Benchmark::Report("Get 1M shaders by name", named);
+			Benchmark::Report("Get 1M variants by key", variant, named);
+			FAKE_LOG_TRACE("Checksum %llu", sum);
+			}
+	};
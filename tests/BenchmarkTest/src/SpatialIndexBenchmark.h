@@ -0,0 +1,153 @@
+#pragma once
+
+#include "Benchmark.h"
+
+#include <random>
+
+class SpatialIndexBenchmark
+	{
+	private:
+
+		static void RunScene(uint32 entityCount)
+			{
+			const uint32 queryCount = 100;
+			const float queryRadius = 10.0f;
+
+			// Constant density, every entity has a few neighbours within the query radius
+			float worldSize = sqrtf((float)entityCount) * 4.0f;
+			float halfSize = worldSize * 0.5f;
+			FakeAABB worldBounds(FakeVec3f(-halfSize, -halfSize, -1.0f), FakeVec3f(halfSize, halfSize, 1.0f));
+
+			// Smallest quadtree cells of about two units
+			uint32 quadtreeDepth = 1;
+			while (quadtreeDepth < FakeLooseQuadtree::MaxDepth && worldSize / (float)(1u << quadtreeDepth) > 2.0f)
+				++quadtreeDepth;
+
+			std::mt19937 random(1234);
+			std::uniform_real_distribution<float> position(-halfSize, halfSize);
+			std::uniform_real_distribution<float> scale(0.5f, 2.0f);
+			std::uniform_real_distribution<float> speed(-0.25f, 0.25f);
+
+			FakeScene scene(1280, 720);
+			std::vector<FakeEntity> entities;
+			std::vector<FakeVec3f> velocities;
+			entities.reserve(entityCount);
+			velocities.reserve(entityCount);
+
+			for (uint32 i = 0; i < entityCount; ++i)
+				{
+				FakeEntity entity = scene.CreateEntity();
+				FakeTransformComponent &transform = entity.GetComponent<FakeTransformComponent>();
+				transform.Translation = { position(random), position(random), 0.0f };
+				transform.Scale = { scale(random), scale(random), 1.0f };
+				entity.AddComponent<FakeBoundsComponent>();
+				entities.push_back(entity);
+				velocities.push_back({ speed(random), speed(random), 0.0f });
+				}
+
+			scene.UpdateTransforms();
+
+			std::vector<FakeVec3f> queryCenters(queryCount);
+			for (FakeVec3f &center : queryCenters)
+				center = { position(random), position(random), 0.0f };
+
+			// A 1280x720 view at 16 pixels per unit
+			FakeFrustum cameraFrustum(FakeMat4f::OrthoOffCenter(-40.0f, 40.0f, -22.5f, 22.5f, -1.0f, 1.0f));
+
+			std::vector<FakeEntity> found;
+			found.reserve(4096);
+
+			// Baseline: test the bounds of every entity
+			double bruteRadius = Benchmark::Measure(3, [&]()
+				{
+				for (const FakeVec3f &center : queryCenters)
+					{
+					found.clear();
+					for (FakeEntity &entity : entities)
+						{
+						if (entity.GetComponent<FakeBoundsComponent>().WorldBounds.IntersectsSphere(center, queryRadius))
+							found.push_back(entity);
+						}
+					}
+				});
+
+			double bruteFrustum = Benchmark::Measure(3, [&]()
+				{
+				found.clear();
+				for (FakeEntity &entity : entities)
+					{
+					if (cameraFrustum.Intersects(entity.GetComponent<FakeBoundsComponent>().WorldBounds))
+						found.push_back(entity);
+					}
+				});
+
+			FAKE_LOG_INFO("Spatial index (%d entities)", entityCount);
+			Benchmark::Report("Brute force, 100 radius queries", bruteRadius);
+			Benchmark::Report("Brute force, camera frustum", bruteFrustum);
+
+			const char *names[] = { "AABB tree", "Loose quadtree" };
+			for (uint32 type = 0; type < 2; ++type)
+				{
+				double build = Benchmark::Measure(1, [&]()
+					{
+					scene.SetSpatialIndex((FakeSpatialIndexType)type, worldBounds, quadtreeDepth);
+					});
+
+				// 10% of the entities move along their velocity every frame
+				uint32 frame = 0;
+				auto moveEntities = [&]()
+					{
+					for (uint32 i = frame++ % 10; i < entityCount; i += 10)
+						{
+						const FakeVec3f &velocity = velocities[i];
+						entities[i].PatchComponent<FakeTransformComponent>([&velocity](FakeTransformComponent &t) { t.Translation += velocity; });
+						}
+
+					scene.UpdateTransforms();
+					};
+
+				// The first move of every proxy reinserts it with a box extended along its motion, measure the frames after that
+				for (uint32 i = 0; i < 10; ++i)
+					moveEntities();
+
+				double update = Benchmark::Measure(10, moveEntities);
+
+				double radius = Benchmark::Measure(10, [&]()
+					{
+					for (const FakeVec3f &center : queryCenters)
+						{
+						found.clear();
+						scene.QueryRadius(center, queryRadius, found);
+						}
+					});
+
+				double frustum = Benchmark::Measure(10, [&]()
+					{
+					found.clear();
+					scene.QueryFrustum(cameraFrustum, found);
+					});
+
+				double raycast = Benchmark::Measure(10, [&]()
+					{
+					for (const FakeVec3f &center : queryCenters)
+						scene.Raycast(FakeRay(FakeVec3f(center.X, center.Y, 10.0f), FakeVec3f(0.0f, 0.0f, -1.0f)));
+					});
+
+				FAKE_LOG_INFO("%s", names[type]);
+				Benchmark::Report("Build", build);
+				Benchmark::Report("Move 10% and UpdateTransforms", update);
+				Benchmark::Report("100 radius queries", radius, bruteRadius);
+				Benchmark::Report("Camera frustum", frustum, bruteFrustum);
+				Benchmark::Report("100 picking rays", raycast);
+				}
+			}
+
+	public:
+
+		static void Run()
+			{
+			RunScene(10000);
+			RunScene(100000);
+			RunScene(1000000);
+			}
+	};
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "Benchmark.h"
+
+class SpriteBenchmark
+	{
+	public:
+
+		static void Run()
+			{
+			const uint32 spriteCount = 100000;
+			FakeScene scene(1280, 720);
+
+			FakeEntity cameraEntity = scene.CreateEntity("Camera");
+			FakeCamera &camera = cameraEntity.AddComponent<FakeCameraComponent>().Camera;
+
+			// A few textures, so the sort has something to group
+			FakeRef<FakeTexture2D> textures[4] = { nullptr };
+			uint32 white = 0xffffffff;
+			for (uint32 i = 1; i < 4; ++i)
+				{
+				textures[i] = FakeTexture2D::Create(FakeTextureFormat::RGBA, 1, 1);
+				textures[i]->Lock();
+				textures[i]->SetData(&white, sizeof(uint32));
+				textures[i]->Unlock();
+				}
+
+			std::vector<FakeEntity> entities;
+			entities.reserve(spriteCount);
+			for (uint32 i = 0; i < spriteCount; ++i)
+				{
+				FakeEntity entity = scene.CreateEntity();
+				auto &transform = entity.GetComponent<FakeTransformComponent>();
+				transform.Translation = { (float)(i % 400) * 0.1f - 20.0f, (float)(i / 400) * 0.1f - 12.5f, (float)(i % 7) * 0.01f };
+				transform.Rotation = { 0.0f, 0.0f, (float)i * 0.001f };
+				transform.Scale = { 0.08f, 0.08f, 1.0f };
+
+				entity.AddComponent<FakeSpriteComponent>(textures[(i * 7) % 4], FakeVec4f(1.0f, 0.5f, 0.25f, 1.0f));
+				entities.push_back(entity);
+				}
+
+			// Render commands are executed outside of the measured region, only the CPU side is timed
+			const uint32 frames = 30;
+			double batched = 0.0;
+			for (uint32 frame = 0; frame <= frames; ++frame)
+				{
+				auto start = std::chrono::steady_clock::now();
+				scene.OnRenderEditor(FakeTimeStep(0.016), camera, FakeMat4f(1.0f));
+				double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+				FakeRenderer::Render();
+
+				// Frame 0 is the warm-up
+				if (frame > 0)
+					batched += ms;
+				}
+			batched /= frames;
+
+			// Baseline: one DrawQuad per entity with its own GetTransform()
+			double naive = 0.0;
+			for (uint32 frame = 0; frame <= frames; ++frame)
+				{
+				auto start = std::chrono::steady_clock::now();
+				FakeRenderer2D::BeginScene(camera.GetProjectionMatrix());
+				for (FakeEntity &entity : entities)
+					FakeRenderer2D::DrawQuad(entity.GetComponent<FakeTransformComponent>().GetTransform(), entity.GetComponent<FakeSpriteComponent>().Color);
+				FakeRenderer2D::EndScene();
+				double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+				FakeRenderer::Render();
+
+				if (frame > 0)
+					naive += ms;
+				}
+			naive /= frames;
+
+			FAKE_LOG_INFO("Sprites (%d entities)", spriteCount);
+			Benchmark::Report("Per entity DrawQuad, CPU per frame", naive);
+			Benchmark::Report("Scene sprite pass, CPU per frame", batched, naive);
+			}
+	};
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "Benchmark.h"
+
+class StateCacheBenchmark
+	{
+	private:
+
+		static const uint32 ObjectCount = 10000;
+		static const uint32 QuadCount = 20000;
+
+		static void DrawFrame(const FakeRef<FakeMesh> *meshes, const FakeRef<FakeMaterial> *materials, const FakeMat4f &viewProjection, const FakeVec3f &cameraPosition)
+			{
+			FakeSceneRenderer::BeginScene(viewProjection, cameraPosition);
+			for (uint32 i = 0; i < ObjectCount; ++i)
+				{
+				FakeMat4f transform;
+				FakeMat4f::Translate((float)(i % 100) * 2.0f - 100.0f, 0.0f, -(float)(i / 100) * 2.0f, transform);
+				FakeSceneRenderer::SubmitMesh(meshes[i % 3], materials[i % 4], transform);
+				}
+			FakeSceneRenderer::EndScene();
+
+			// The batches of the 2D renderer share program, vertex array and buffers
+			FakeRenderer2D::BeginScene(FakeVec2f(1280.0f, 720.0f));
+			for (uint32 i = 0; i < QuadCount; ++i)
+				FakeRenderer2D::DrawQuad(FakeVec2f((float)(i % 200) * 6.0f, (float)(i / 200) * 6.0f), FakeVec2f(4.0f, 4.0f), FakeVec4f(1.0f, 0.5f, 0.25f, 1.0f));
+			FakeRenderer2D::EndScene();
+			}
+
+	public:
+
+		static void Run()
+			{
+			FakeRef<FakeShaderLibrary> library = FakeRef<FakeShaderLibrary>::Create();
+			library->Load("FakeMeshShader", "assets/shaders/FakeMeshShader.glsl");
+			library->FinishCompilation();
+
+			FakeRef<FakeMesh> meshes[3] =
+				{
+				FakeMeshFactory::Cube(FakeVec3f(1.0f, 1.0f, 1.0f)),
+				FakeMeshFactory::Sphere(0.5f),
+				FakeMeshFactory::Capsule(0.25f, 1.0f)
+				};
+
+			FakeRef<FakeMaterial> materials[4];
+			for (uint32 i = 0; i < 4; ++i)
+				{
+				materials[i] = FakeMaterial::Create(library->Get("FakeMeshShader"));
+				materials[i]->Set("u_Color", FakeVec4f((float)i / 4.0f, 1.0f, 1.0f, 1.0f));
+				materials[i]->Set("u_Ambient", 0.1f);
+				}
+
+			FakeVec3f cameraPosition(0.0f, 30.0f, 40.0f);
+			FakeMat4f view = FakeMat4f::LookAt(cameraPosition, FakeVec3f(0.0f, 0.0f, -100.0f), FakeVec3f(0.0f, 1.0f, 0.0f));
+			FakeMat4f projection, viewProjection;
+			FakeMat4f::PerspectiveFOV(fake_radians(60.0f), 16.0f / 9.0f, 0.1f, 1000.0f, projection);
+			FakeMat4f::Multiply(view, projection, viewProjection);
+
+			const uint32 frames = 30;
+			double total = 0.0;
+			FakeRenderAPIStatistics first;
+
+			for (uint32 frame = 0; frame <= frames; ++frame)
+				{
+				DrawFrame(meshes, materials, viewProjection, cameraPosition);
+
+				auto start = std::chrono::steady_clock::now();
+				FakeRenderer::Render();
+				auto end = std::chrono::steady_clock::now();
+
+				// Frame 0 is the warm-up, it finds the state of the previous benchmark
+				if (frame == 1)
+					first = FakeRendererAPI::GetStats();
+				if (frame > 0)
+					total += std::chrono::duration<double, std::milli>(end - start).count();
+				}
+
+			FakeRenderAPIStatistics stats = FakeRendererAPI::GetStats();
+			FAKE_LOG_INFO("State cache: %d meshes, %d quads per frame", ObjectCount, QuadCount);
+			Benchmark::Report("Execute render commands", total / frames);
+			FAKE_LOG_TRACE("%d state changes reached the driver, %d were skipped", stats.StateChanges, stats.SkippedStateChanges);
+
+			if (stats.SkippedStateChanges == 0)
+				FAKE_LOG_ERROR("State cache did not skip redundant state changes!");
+
+			// Identical frames have to change identical state, otherwise the cache lost track of something
+			if (stats.StateChanges != first.StateChanges || stats.SkippedStateChanges != first.SkippedStateChanges)
+				FAKE_LOG_ERROR("State cache changed different state for identical frames!");
+			}
+	};
@@ -0,0 +1,135 @@
+#pragma once
+
+#include "Benchmark.h"
+
+class StreamingBenchmark
+	{
+	private:
+
+		// The size of the vertices of FakeRenderer2D
+		struct Vertex
+			{
+			FakeVec3f Position;
+			FakeVec4f Color;
+			FakeVec2f TexCoord;
+			float TexIndex;
+			float TilingFactor;
+			};
+
+		static const uint32 VerticesPerBatch = 80000;
+		static const uint32 BatchesPerFrame = 2;
+
+		static void WriteBatch(Vertex *vertices, uint32 frame)
+			{
+			for (uint32 i = 0; i < VerticesPerBatch; ++i)
+				{
+				vertices[i].Position = { (float)(i % 400), (float)(i / 400), 0.0f };
+				vertices[i].Color = { 1.0f, 0.5f, 0.25f, 1.0f };
+				vertices[i].TexCoord = { (float)(i & 1), (float)((i >> 1) & 1) };
+				vertices[i].TexIndex = (float)(frame % 4);
+				vertices[i].TilingFactor = 1.0f;
+				}
+			}
+
+		template<typename Fn>
+		static double RunFrames(Fn writeBatch)
+			{
+			const uint32 frames = 30;
+			double total = 0.0;
+
+			for (uint32 frame = 0; frame <= frames; ++frame)
+				{
+				auto start = std::chrono::steady_clock::now();
+				for (uint32 batch = 0; batch < BatchesPerFrame; ++batch)
+					writeBatch(frame);
+				FakeRenderer::Render();
+				auto end = std::chrono::steady_clock::now();
+
+				// Frame 0 is the warm-up
+				if (frame > 0)
+					total += std::chrono::duration<double, std::milli>(end - start).count();
+				}
+
+			return total / frames;
+			}
+
+		// Memory handed out within one frame must not overlap and has to be addressable by vertex
+		static bool CheckRegions(const FakeRef<FakeVertexBuffer> &buffer)
+			{
+			const uint32 size = 1000 * sizeof(Vertex);
+
+			FakeRenderer::Render();
+			buffer->Map(size, sizeof(Vertex));
+			uint32 first = buffer->GetStreamOffset();
+			buffer->Unmap(size - 1);
+
+			buffer->Map(size, sizeof(Vertex));
+			uint32 second = buffer->GetStreamOffset();
+			buffer->Unmap(size);
+			FakeRenderer::Render();
+
+			// The next frame starts in the next region
+			buffer->Map(size, sizeof(Vertex));
+			uint32 third = buffer->GetStreamOffset();
+			buffer->Unmap(0);
+			FakeRenderer::Render();
+
+			return second == first + size && second % sizeof(Vertex) == 0 && third / buffer->GetSize() != first / buffer->GetSize();
+			}
+
+	public:
+
+		static void Run()
+			{
+			const uint32 batchSize = VerticesPerBatch * sizeof(Vertex);
+			std::vector<Vertex> staging(VerticesPerBatch);
+
+			// Baseline: vertices are written to memory of the batcher, the command queue copies them again before the upload
+			FakeRef<FakeVertexBuffer> dynamicBuffer = FakeVertexBuffer::Create(batchSize, FakeVertexBufferUsage::Dynamic);
+			double dynamic = RunFrames([&](uint32 frame)
+				{
+				WriteBatch(staging.data(), frame);
+				dynamicBuffer->SetData(staging.data(), batchSize);
+				});
+
+			FakeRef<FakeVertexBuffer> streamBuffer = FakeVertexBuffer::Create(BatchesPerFrame * batchSize, FakeVertexBufferUsage::Stream);
+			double copied = RunFrames([&](uint32 frame)
+				{
+				WriteBatch(staging.data(), frame);
+				streamBuffer->SetData(staging.data(), batchSize);
+				});
+
+			double mapped = RunFrames([&](uint32 frame)
+				{
+				WriteBatch((Vertex*)streamBuffer->Map(batchSize, sizeof(Vertex)), frame);
+				streamBuffer->Unmap(batchSize);
+				});
+
+			FAKE_LOG_INFO("Streaming: %d batches of %d vertices per frame", BatchesPerFrame, VerticesPerBatch);
+			Benchmark::Report("Dynamic buffer, SetData", dynamic);
+			Benchmark::Report("Stream buffer, SetData", copied, dynamic);
+			Benchmark::Report("Stream buffer, written in place", mapped, dynamic);
+
+			if (!CheckRegions(streamBuffer))
+				FAKE_LOG_ERROR("Stream buffer handed out overlapping memory!");
+
+			// More quads than one frame of the stream buffer holds, the batches beyond it are executed early
+			const uint32 quadCount = 100000;
+			FakeRenderer2D::ResetStats();
+			uint32 frameIndex = FakeRenderer::GetFrameIndex();
+			FakeRenderer2D::BeginScene(FakeVec2f(1280.0f, 720.0f));
+			for (uint32 i = 0; i < quadCount; ++i)
+				FakeRenderer2D::DrawQuad(FakeVec2f((float)(i % 400) * 3.0f, (float)(i / 400) * 3.0f), FakeVec2f(2.0f, 2.0f), FakeVec4f(1.0f, 0.5f, 0.25f, 1.0f));
+			FakeRenderer2D::EndScene();
+
+			// Executing the batches early must not end the frame
+			if (FakeRenderer::GetFrameIndex() != frameIndex)
+				FAKE_LOG_ERROR("Stream buffer overflow started a new frame!");
+
+			FakeRenderer::Render();
+
+			FakeRenderer2D::Statistics stats = FakeRenderer2D::GetStats();
+			if (stats.QuadCount != quadCount || stats.DrawCalls != 5)
+				FAKE_LOG_ERROR("Renderer2D dropped quads while streaming!");
+			}
+	};
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <cmath>
+
+#include "Benchmark.h"
+
+struct BenchmarkVelocityComponent
+	{
+	FakeVec3f Value;
+	};
+
+struct BenchmarkHealthComponent
+	{
+	float Health = 0.0f;
+	float Regeneration = 1.0f;
+	};
+
+struct BenchmarkOscillatorComponent
+	{
+	float Phase = 0.0f;
+	float Value = 0.0f;
+	};
+
+class BenchmarkMovementSystem : public FakeSystem
+	{
+	public:
+
+		virtual const char *GetName() const override { return "Movement"; }
+
+		virtual void DeclareAccess(FakeSystemAccess &access) override
+			{
+			access.Write<FakeTransformComponent>().Read<BenchmarkVelocityComponent>();
+			}
+
+		virtual void OnUpdate(entt::registry &registry, FakeTimeStep ts) override
+			{
+			float dt = (float)ts;
+			ParallelEach<FakeTransformComponent, BenchmarkVelocityComponent>(registry, 0, [&registry, dt](entt::entity entity, FakeTransformComponent &transform, BenchmarkVelocityComponent &velocity)
+				{
+				registry.patch<FakeTransformComponent>(entity, [&velocity, dt](FakeTransformComponent &t) { t.Translation += velocity.Value * dt; });
+				});
+			}
+	};
+
+class BenchmarkHealthSystem : public FakeSystem
+	{
+	public:
+
+		virtual const char *GetName() const override { return "Health"; }
+
+		virtual void DeclareAccess(FakeSystemAccess &access) override
+			{
+			access.Write<BenchmarkHealthComponent>();
+			}
+
+		virtual void OnUpdate(entt::registry &registry, FakeTimeStep ts) override
+			{
+			float dt = (float)ts;
+			ParallelEach<BenchmarkHealthComponent>(registry, 0, [dt](entt::entity entity, BenchmarkHealthComponent &health)
+				{
+				health.Health = std::fmin(health.Health + health.Regeneration * dt, 100.0f);
+				});
+			}
+	};
+
+class BenchmarkOscillatorSystem : public FakeSystem
+	{
+	public:
+
+		virtual const char *GetName() const override { return "Oscillator"; }
+
+		virtual void DeclareAccess(FakeSystemAccess &access) override
+			{
+			access.Write<BenchmarkOscillatorComponent>();
+			}
+
+		virtual void OnUpdate(entt::registry &registry, FakeTimeStep ts) override
+			{
+			float dt = (float)ts;
+			ParallelEach<BenchmarkOscillatorComponent>(registry, 0, [dt](entt::entity entity, BenchmarkOscillatorComponent &oscillator)
+				{
+				oscillator.Phase += dt;
+				for (uint32 i = 0; i < 8; ++i)
+					oscillator.Value = std::sin(oscillator.Phase + oscillator.Value * 0.5f);
+				});
+			}
+	};
+
+class SystemSchedulerBenchmark
+	{
+	public:
+
+		static void Run()
+			{
+			const uint32 entityCount = 100000;
+			FakeScene scene(1280, 720);
+
+			for (uint32 i = 0; i < entityCount; ++i)
+				{
+				FakeEntity entity = scene.CreateEntity();
+				entity.AddComponent<BenchmarkVelocityComponent>(BenchmarkVelocityComponent{ { 1.0f, (float)(i % 10), 0.0f } });
+				entity.AddComponent<BenchmarkHealthComponent>();
+				entity.AddComponent<BenchmarkOscillatorComponent>();
+				}
+
+			scene.AddSystem<BenchmarkMovementSystem>();
+			scene.AddSystem<BenchmarkHealthSystem>();
+			scene.AddSystem<BenchmarkOscillatorSystem>();
+
+			// Baseline: the same frame with a single threaded Job System, systems and chunks run one after another
+			uint32 threadCount = FakeJobSystem::GetThreadCount();
+			FakeJobSystem::Shutdown();
+			FakeJobSystem::Init(1);
+
+			// No camera in the scene, so OnRenderRuntime() only runs the systems and updates the transforms
+			double serial = Benchmark::Measure(30, [&scene]()
+				{
+				scene.OnRenderRuntime(FakeTimeStep(0.016));
+				});
+
+			FakeJobSystem::Shutdown();
+			FakeJobSystem::Init(threadCount);
+
+			double scheduled = Benchmark::Measure(30, [&scene]()
+				{
+				scene.OnRenderRuntime(FakeTimeStep(0.016));
+				});
+
+			std::vector<FakeSystemTiming> timings;
+			scene.GetSystemScheduler().GetTimings(timings);
+
+			FAKE_LOG_INFO("System scheduler (%d entities, %d threads)", entityCount, threadCount);
+			for (FakeSystemTiming &timing : timings)
+				FAKE_LOG_INFO("    %-44s %10.3f ms on thread %d", timing.Name, timing.Milliseconds, timing.ThreadIndex);
+
+			Benchmark::Report("Systems in order, one thread", serial);
+			Benchmark::Report("Scheduled systems", scheduled, serial);
+			}
+	};
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "Benchmark.h"
+
+class TransformHierarchyBenchmark
+	{
+	public:
+
+		static void Run()
+			{
+			const uint32 rootCount = 1000;
+			const uint32 childrenPerRoot = 99;
+			FakeScene scene(1280, 720);
+
+			std::vector<FakeEntity> roots;
+			std::vector<FakeEntity> entities;
+			roots.reserve(rootCount);
+			entities.reserve(rootCount * (childrenPerRoot + 1));
+
+			// Chains of three levels below every root, like props attached to level geometry
+			for (uint32 i = 0; i < rootCount; ++i)
+				{
+				FakeEntity root = scene.CreateEntity();
+				root.GetComponent<FakeTransformComponent>().Translation = { (float)i, 0.0f, 0.0f };
+				roots.push_back(root);
+				entities.push_back(root);
+
+				FakeEntity parent = root;
+				for (uint32 j = 0; j < childrenPerRoot; ++j)
+					{
+					FakeEntity child = scene.CreateEntity();
+					child.GetComponent<FakeTransformComponent>().Translation = { 0.0f, 1.0f, 0.0f };
+					child.SetParent(j % 3 == 0 ? root : parent);
+					parent = child;
+					entities.push_back(child);
+					}
+				}
+
+			scene.UpdateTransforms();
+
+			double staticFrame = Benchmark::Measure(100, [&scene]()
+				{
+				scene.UpdateTransforms();
+				});
+
+			uint32 frame = 0;
+			double oneRoot = Benchmark::Measure(100, [&]()
+				{
+				roots[frame++ % rootCount].PatchComponent<FakeTransformComponent>([](FakeTransformComponent &t) { t.Rotation.Z += 0.01f; });
+				scene.UpdateTransforms();
+				});
+
+			double allRoots = Benchmark::Measure(10, [&]()
+				{
+				for (FakeEntity &root : roots)
+					root.PatchComponent<FakeTransformComponent>([](FakeTransformComponent &t) { t.Rotation.Z += 0.01f; });
+				scene.UpdateTransforms();
+				});
+
+			// Baseline: recomputing every world matrix by walking up the parents each frame
+			std::vector<FakeMat4f> worlds(entities.size());
+			double naive = Benchmark::Measure(10, [&]()
+				{
+				for (size_t i = 0; i < entities.size(); ++i)
+					{
+					FakeMat4f world = entities[i].GetComponent<FakeTransformComponent>().GetTransform();
+					for (FakeEntity parent = entities[i].GetParent(); parent; parent = parent.GetParent())
+						world = FakeMat4f::Multiply(world, parent.GetComponent<FakeTransformComponent>().GetTransform());
+
+					worlds[i] = world;
+					}
+				});
+
+			FAKE_LOG_INFO("Transform hierarchy (%d entities)", (uint32)entities.size());
+			Benchmark::Report("Recompute all world matrices", naive);
+			Benchmark::Report("UpdateTransforms, all roots moved", allRoots, naive);
+			Benchmark::Report("UpdateTransforms, one root moved", oneRoot, naive);
+			Benchmark::Report("UpdateTransforms, static scene", staticFrame, naive);
+			}
+	};
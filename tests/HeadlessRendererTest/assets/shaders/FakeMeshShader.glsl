@@ -0,0 +1,38 @@
+#type vertex
+#version 450 core
+
+layout(location = 0) in vec3 a_Position;
+layout(location = 1) in vec4 a_Normal;
+layout(location = 2) in vec2 a_TexCoord;
+layout(location = 3) in mat4 a_Transform;
+
+uniform mat4 r_ViewProjection;
+
+out vec3 v_Normal;
+out vec2 v_TexCoord;
+
+void main()
+	{
+	v_Normal = mat3(a_Transform) * a_Normal.xyz;
+	v_TexCoord = a_TexCoord;
+
+	gl_Position = r_ViewProjection * a_Transform * vec4(a_Position, 1.0);
+	}
+
+#type fragment
+#version 450 core
+
+layout(location = 0) out vec4 Color;
+
+in vec3 v_Normal;
+in vec2 v_TexCoord;
+
+uniform vec4 u_Color;
+uniform float u_Ambient;
+uniform sampler2D u_Albedo;
+
+void main()
+	{
+	float light = max(dot(normalize(v_Normal), normalize(vec3(0.3, 1.0, 0.5))), 0.0);
+	Color = texture(u_Albedo, v_TexCoord) * u_Color * vec4(vec3(u_Ambient + (1.0 - u_Ambient) * light), 1.0);
+	}
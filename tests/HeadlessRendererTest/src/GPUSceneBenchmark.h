@@ -0,0 +1,233 @@
+#pragma once
+
+#include "Benchmark.h"
+#include "OpenGLTestContext.h"
+
+class GPUSceneBenchmark
+	{
+	private:
+
+		struct FrameCommands
+			{
+			uint32 Total = 0;
+			uint32 Dispatches = 0;
+			uint32 IndirectDraws = 0;
+			};
+
+		static void CreateAssets(FakeRef<FakeMesh> *meshes, FakeRef<FakeMaterial> *materials)
+			{
+			FakeRef<FakeShaderLibrary> library = FakeRef<FakeShaderLibrary>::Create();
+			library->Load("FakeMeshShader", "assets/shaders/FakeMeshShader.glsl");
+			library->FinishCompilation();
+
+			meshes[0] = FakeMeshFactory::Cube(FakeVec3f(1.0f, 1.0f, 1.0f));
+			meshes[1] = FakeMeshFactory::Sphere(0.5f);
+			meshes[2] = FakeMeshFactory::Capsule(0.25f, 1.0f);
+
+			for (uint32 i = 0; i < 4; ++i)
+				{
+				materials[i] = FakeMaterial::Create(library->Get("FakeMeshShader"));
+				materials[i]->Set("u_Color", FakeVec4f((float)i / 4.0f, 1.0f, 1.0f, 1.0f));
+				materials[i]->Set("u_Ambient", 0.1f);
+				}
+			}
+
+		static FakeMat4f GetViewProjection()
+			{
+			FakeVec3f cameraPosition(0.0f, 30.0f, 40.0f);
+			FakeMat4f view = FakeMat4f::LookAt(cameraPosition, FakeVec3f(0.0f, 0.0f, -100.0f), FakeVec3f(0.0f, 1.0f, 0.0f));
+			FakeMat4f projection, viewProjection;
+			FakeMat4f::PerspectiveFOV(fake_radians(60.0f), 16.0f / 9.0f, 0.1f, 1000.0f, projection);
+			FakeMat4f::Multiply(view, projection, viewProjection);
+			return viewProjection;
+			}
+
+		static FakeMat4f GetTransform(uint32 instance)
+			{
+			FakeMat4f transform;
+			FakeMat4f::Translate((float)(instance % 316) * 2.0f - 316.0f, 0.0f, -(float)(instance / 316) * 2.0f, transform);
+			return transform;
+			}
+
+		static FakeRef<FakeGPUScene> CreateScene(uint32 instanceCount, const FakeRef<FakeMesh> *meshes, const FakeRef<FakeMaterial> *materials)
+			{
+			FakeRef<FakeGPUScene> scene = FakeRef<FakeGPUScene>::Create();
+			for (uint32 i = 0; i < instanceCount; ++i)
+				scene->AddInstance(meshes[i % 3], 0, materials[i % 4], GetTransform(i));
+
+			return scene;
+			}
+
+		static FrameCommands RecordFrame(const FakeRef<FakeGPUScene> &scene, const FakeMat4f &viewProjection)
+			{
+			FakeRendererAPI::SetCurrent(FakeRendererAPIType::Recording);
+			FakeNullRendererAPI::ClearRecordedCommands();
+
+			scene->Draw(viewProjection);
+			FakeRenderer::Render();
+
+			FrameCommands frame;
+			for (const FakeRecordedCommand &command : FakeNullRendererAPI::GetRecordedCommands())
+				{
+				frame.Total++;
+				if (command.Type == FakeRecordedCommandType::DispatchCompute)
+					frame.Dispatches++;
+				else if (command.Type == FakeRecordedCommandType::DrawIndexedIndirect)
+					frame.IndirectDraws++;
+				}
+
+			FakeNullRendererAPI::ClearRecordedCommands();
+			FakeRendererAPI::SetCurrent(FakeRendererAPIType::Null);
+			return frame;
+			}
+
+		static uint32 CountBits(uint32 mask)
+			{
+			uint32 count = 0;
+			for (; mask; mask &= mask - 1)
+				++count;
+
+			return count;
+			}
+
+		// The culling shader runs on a real driver, the draws it compacts have to match a frustum test on the CPU
+		static void RunOpenGL()
+			{
+			if (!OpenGLTestContext::Begin("GPUSceneBenchmark"))
+				return;
+
+				{
+				FakeRef<FakeMesh> meshes[3];
+				FakeRef<FakeMaterial> materials[4];
+				CreateAssets(meshes, materials);
+				FakeMat4f viewProjection = GetViewProjection();
+
+				const uint32 instanceCount = 10000;
+				FakeRef<FakeGPUScene> scene = CreateScene(instanceCount, meshes, materials);
+				scene->Draw(viewProjection);
+
+				FakeGPUScene::Statistics stats = scene->GetStats();
+				uint32 commandBase = scene->GetCommandBase();
+				std::vector<uint32> indirect(commandBase + stats.BatchCount * 5);
+				OpenGLTestContext::ReadBuffer(scene->GetIndirectBuffer(), indirect.data(), (uint32)indirect.size() * sizeof(uint32));
+
+				// Stage 0 clears every reserved command, so the unused ones add nothing
+				uint32 gpuDraws = 0;
+				uint32 gpuVisible = 0;
+				for (uint32 i = 0; i < stats.BucketCount; ++i)
+					gpuDraws += indirect[i];
+				for (uint32 i = 0; i < stats.BatchCount; ++i)
+					gpuVisible += indirect[commandBase + i * 5 + 1];
+
+				// Every mesh and material pair is one bucket with one batch. Boxes right on a plane may go either way
+				// on different hardware, so the CPU tests them grown and shrunk by a little.
+				FakeFrustum frustum(viewProjection);
+				uint32 minVisible = 0;
+				uint32 maxVisible = 0;
+				uint32 minBatches = 0;
+				uint32 maxBatches = 0;
+				for (uint32 i = 0; i < instanceCount; ++i)
+					{
+					FakeAABB box = FakeAABB::Transform(meshes[i % 3]->GetSubmeshes()[0].Bounds, GetTransform(i));
+					uint32 batch = 1u << ((i % 3) * 4 + i % 4);
+
+					if (frustum.Intersects(FakeAABB::Expand(box, -0.001f)))
+						{
+						minVisible++;
+						minBatches |= batch;
+						}
+
+					if (frustum.Intersects(FakeAABB::Expand(box, 0.001f)))
+						{
+						maxVisible++;
+						maxBatches |= batch;
+						}
+					}
+
+				FAKE_LOG_INFO("OpenGL GPU scene: %d of %d instances visible in %d draws, %d to %d on the CPU", gpuVisible, instanceCount, gpuDraws, minVisible, maxVisible);
+
+				if (!minVisible || maxVisible == instanceCount)
+					FAKE_LOG_ERROR("The camera of GPUSceneBenchmark has to see a part of the instances!");
+
+				if (gpuVisible < minVisible || gpuVisible > maxVisible)
+					FAKE_LOG_ERROR("The GPU culled to %d visible instances, the CPU to %d to %d!", gpuVisible, minVisible, maxVisible);
+
+				if (gpuDraws < CountBits(minBatches) || gpuDraws > CountBits(maxBatches))
+					FAKE_LOG_ERROR("The GPU compacted %d draws, the CPU expects %d to %d!", gpuDraws, CountBits(minBatches), CountBits(maxBatches));
+				}
+
+			OpenGLTestContext::End();
+			}
+
+	public:
+
+		static void Run()
+			{
+			FakeRef<FakeMesh> meshes[3];
+			FakeRef<FakeMaterial> materials[4];
+			CreateAssets(meshes, materials);
+			FakeMat4f viewProjection = GetViewProjection();
+
+			const uint32 instanceCounts[2] = { 10000, 100000 };
+			FrameCommands frames[2];
+
+			for (uint32 run = 0; run < 2; ++run)
+				{
+				FakeRef<FakeGPUScene> scene = CreateScene(instanceCounts[run], meshes, materials);
+
+				// The first frame uploads the instances, the following ones only the frustum
+				scene->Draw(viewProjection);
+				FakeRenderer::Render();
+				scene->ResetStats();
+
+				double milliseconds = Benchmark::Measure(30, [&]()
+					{
+					scene->Draw(viewProjection);
+					FakeRenderer::Render();
+					});
+
+				FakeGPUScene::Statistics stats = scene->GetStats();
+				char name[64];
+				snprintf(name, sizeof(name), "Draw %d GPU culled instances", instanceCounts[run]);
+				Benchmark::Report(name, milliseconds);
+
+				if (stats.UploadedBytes || stats.RebuildCount)
+					FAKE_LOG_ERROR("GPU scene uploaded %d bytes of unchanged instances!", stats.UploadedBytes);
+
+				frames[run] = RecordFrame(scene, viewProjection);
+				FAKE_LOG_INFO("GPU scene: %d instances in %d batches, %d indirect draws and %d dispatches per frame", stats.InstanceCount, stats.BatchCount, frames[run].IndirectDraws, frames[run].Dispatches);
+
+				if (frames[run].IndirectDraws != stats.BucketCount || frames[run].Dispatches != 3)
+					FAKE_LOG_ERROR("GPU scene did not issue one indirect draw per material and mesh!");
+
+				// Moving a few instances uploads their transforms, nothing else
+				scene->ResetStats();
+				for (uint32 i = 0; i < 100; ++i)
+					{
+					FakeMat4f transform;
+					FakeMat4f::Translate(0.0f, (float)i, 0.0f, transform);
+					scene->SetTransform(i * 7, transform);
+					}
+
+				scene->Draw(viewProjection);
+				FakeRenderer::Render();
+				if (scene->GetStats().UploadedBytes != 100 * sizeof(FakeMat4f) || scene->GetStats().RebuildCount)
+					FAKE_LOG_ERROR("GPU scene uploaded more than the moved transforms!");
+
+				// Removing an instance regroups the instances once
+				scene->ResetStats();
+				scene->RemoveInstance(0);
+				scene->Draw(viewProjection);
+				scene->Draw(viewProjection);
+				FakeRenderer::Render();
+				if (scene->GetStats().RebuildCount != 1 || scene->GetStats().InstanceCount != instanceCounts[run] - 1)
+					FAKE_LOG_ERROR("GPU scene did not regroup its instances after a removal!");
+				}
+
+			// Ten times the instances record exactly the same commands, the CPU cost does not depend on the instance count
+			if (frames[0].Total != frames[1].Total)
+				FAKE_LOG_ERROR("GPU scene recorded %d commands for %d instances but %d for %d!", frames[0].Total, instanceCounts[0], frames[1].Total, instanceCounts[1]);
+
+			RunOpenGL();
+			}
+	};
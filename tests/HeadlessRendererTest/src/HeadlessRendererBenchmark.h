@@ -0,0 +1,116 @@
+#pragma once
+
+#include "Benchmark.h"
+
+class HeadlessRendererBenchmark
+	{
+	private:
+
+		static const uint32 ObjectCount = 10000;
+		static const uint32 QuadCount = 50000;
+
+		static void DrawFrame(const FakeRef<FakeMesh> *meshes, const FakeRef<FakeMaterial> *materials, const FakeMat4f &viewProjection, const FakeVec3f &cameraPosition)
+			{
+			FakeSceneRenderer::BeginScene(viewProjection, cameraPosition);
+			for (uint32 i = 0; i < ObjectCount; ++i)
+				{
+				FakeMat4f transform;
+				FakeMat4f::Translate((float)(i % 100) * 2.0f - 100.0f, 0.0f, -(float)(i / 100) * 2.0f, transform);
+				FakeSceneRenderer::SubmitMesh(meshes[i % 3], materials[i % 4], transform);
+				}
+			FakeSceneRenderer::EndScene();
+
+			FakeRenderer2D::BeginScene(FakeVec2f(1280.0f, 720.0f));
+			for (uint32 i = 0; i < QuadCount; ++i)
+				FakeRenderer2D::DrawQuad(FakeVec2f((float)(i % 250) * 5.0f, (float)(i / 250) * 3.0f), FakeVec2f(4.0f, 4.0f), FakeVec4f(1.0f, 0.5f, 0.25f, 1.0f));
+			FakeRenderer2D::EndScene();
+			}
+
+		static std::vector<FakeRecordedCommand> RecordFrame(const FakeRef<FakeMesh> *meshes, const FakeRef<FakeMaterial> *materials, const FakeMat4f &viewProjection, const FakeVec3f &cameraPosition)
+			{
+			FakeNullRendererAPI::ClearRecordedCommands();
+			DrawFrame(meshes, materials, viewProjection, cameraPosition);
+			FakeRenderer::Render();
+			return FakeNullRendererAPI::GetRecordedCommands();
+			}
+
+		static void CheckRecording(const char *name, const std::vector<FakeRecordedCommand> &expected, const std::vector<FakeRecordedCommand> &actual)
+			{
+			uint32 index = FakeNullRendererAPI::FindFirstDifference(expected, actual);
+			if (index == ~0u)
+				return;
+
+			FAKE_LOG_ERROR("%s: command streams differ at command %d of %d!", name, index, (uint32)expected.size());
+			if (index < expected.size())
+				FAKE_LOG_ERROR("  expected %s", *FakeNullRendererAPI::ToString(expected[index]));
+			if (index < actual.size())
+				FAKE_LOG_ERROR("  actual   %s", *FakeNullRendererAPI::ToString(actual[index]));
+			}
+
+	public:
+
+		static void Run()
+			{
+			FakeRef<FakeShaderLibrary> library = FakeRef<FakeShaderLibrary>::Create();
+			library->Load("FakeMeshShader", "assets/shaders/FakeMeshShader.glsl");
+			library->FinishCompilation();
+
+			FakeRef<FakeMesh> meshes[3] =
+				{
+				FakeMeshFactory::Cube(FakeVec3f(1.0f, 1.0f, 1.0f)),
+				FakeMeshFactory::Sphere(0.5f),
+				FakeMeshFactory::Capsule(0.25f, 1.0f)
+				};
+
+			FakeRef<FakeMaterial> materials[4];
+			for (uint32 i = 0; i < 4; ++i)
+				{
+				materials[i] = FakeMaterial::Create(library->Get("FakeMeshShader"));
+				materials[i]->Set("u_Color", FakeVec4f((float)i / 4.0f, 1.0f, 1.0f, 1.0f));
+				materials[i]->Set("u_Ambient", 0.1f);
+				}
+
+			FakeVec3f cameraPosition(0.0f, 30.0f, 40.0f);
+			FakeMat4f view = FakeMat4f::LookAt(cameraPosition, FakeVec3f(0.0f, 0.0f, -100.0f), FakeVec3f(0.0f, 1.0f, 0.0f));
+			FakeMat4f projection, viewProjection;
+			FakeMat4f::PerspectiveFOV(fake_radians(60.0f), 16.0f / 9.0f, 0.1f, 1000.0f, projection);
+			FakeMat4f::Multiply(view, projection, viewProjection);
+
+			uint32 drawCalls = 0;
+			double milliseconds = Benchmark::Measure(30, [&]()
+				{
+				FakeRenderer2D::ResetStats();
+				FakeSceneRenderer::ResetStats();
+
+				DrawFrame(meshes, materials, viewProjection, cameraPosition);
+				FakeRenderer::Render();
+
+				drawCalls = FakeRenderer2D::GetStats().DrawCalls + FakeSceneRenderer::GetStats().DrawCalls;
+				});
+
+			// Without a GPU behind the backend, everything measured is the CPU side of the renderers
+			FAKE_LOG_INFO("Headless renderer: %d meshes, %d quads per frame, %d draw calls", ObjectCount, QuadCount, drawCalls);
+			Benchmark::Report("Submit and execute one frame", milliseconds);
+			FAKE_LOG_INFO("%-48s %10.3f us", "CPU cost per draw call", milliseconds * 1000.0 / (double)std::max(drawCalls, 1u));
+			FAKE_LOG_INFO("%-48s %10.3f us", "CPU cost per submitted mesh or quad", milliseconds * 1000.0 / (double)(ObjectCount + QuadCount));
+
+			// Identical frames have to record identical command streams
+			FakeRendererAPI::SetCurrent(FakeRendererAPIType::Recording);
+			std::vector<FakeRecordedCommand> first = RecordFrame(meshes, materials, viewProjection, cameraPosition);
+			std::vector<FakeRecordedCommand> second = RecordFrame(meshes, materials, viewProjection, cameraPosition);
+			FAKE_LOG_TRACE("Recorded %d commands per frame (%d bytes)", (uint32)first.size(), (uint32)(first.size() * sizeof(FakeRecordedCommand)));
+
+			if (first.empty())
+				FAKE_LOG_ERROR("Recording backend did not record anything!");
+
+			CheckRecording("Recorded frames", first, second);
+
+			// A replay of the recording records the recording again
+			FakeNullRendererAPI::ClearRecordedCommands();
+			FakeNullRendererAPI::Replay(first);
+			CheckRecording("Replayed frame", first, FakeNullRendererAPI::GetRecordedCommands());
+
+			FakeNullRendererAPI::ClearRecordedCommands();
+			FakeRendererAPI::SetCurrent(FakeRendererAPIType::Null);
+			}
+	};
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <Fake.h>
+
+#include "GPUSceneBenchmark.h"
+#include "HeadlessRendererBenchmark.h"
+#include "ParticleBenchmark.h"
+#include "PrimitiveBenchmark.h"
+#include "ReadbackBenchmark.h"
+#include "RenderGraphBenchmark.h"
+#include "TextBenchmark.h"
+#include "VulkanBenchmark.h"
+
+class HeadlessRendererTest : public FakeApplication
+	{
+	public:
+
+		HeadlessRendererTest()
+			{
+			}
+
+		virtual void OnInit() override
+			{
+			// There is no window and no GPU, the renderer runs on the null backend
+			FakeRendererAPI::SetCurrent(FakeRendererAPIType::Null);
+			FakeRenderer::Init();
+			FakeRenderer::Render();
+
+			HeadlessRendererBenchmark::Run();
+			RenderGraphBenchmark::Run();
+			ReadbackBenchmark::Run();
+			GPUSceneBenchmark::Run();
+			TextBenchmark::Run();
+			PrimitiveBenchmark::Run();
+			ParticleBenchmark::Run();
+
+			#ifdef FAKE_RENDERER_VULKAN
+				VulkanBenchmark::Run();
+			#endif
+
+			FakeRenderer::Shutdown();
+			CloseApplication();
+			}
+
+		virtual void OnShutdown() override
+			{
+			}
+	};
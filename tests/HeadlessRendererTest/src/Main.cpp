@@ -0,0 +1,6 @@
+#include "HeadlessRendererTest.h"
+
+FakeApplication *fake_create_app()
+	{
+	return new HeadlessRendererTest();
+	}
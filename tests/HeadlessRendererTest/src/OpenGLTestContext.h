@@ -0,0 +1,88 @@
+#pragma once
+
+#include "Benchmark.h"
+
+#include <glad/glad.h>
+
+/**
+ *
+ * A hidden window whose OpenGL context the GL runs of the benchmarks render with.
+ * On Linux Mesa's llvmpipe is used, the runs need an X server like Xvfb but no GPU.
+ *
+ */
+class OpenGLTestContext
+	{
+	private:
+
+		static inline Scope<FakeWindow> Window;
+
+	public:
+
+		static bool Begin(const char *name)
+			{
+			#ifdef PLATFORM_LINUX
+				if (!getenv("DISPLAY"))
+					{
+					FAKE_LOG_WARN("There is no X display, the OpenGL run of %s is skipped!", name);
+					return false;
+					}
+
+				// The results must not depend on the GPU of the machine
+				setenv("LIBGL_ALWAYS_SOFTWARE", "1", 0);
+			#endif
+
+			FakeWindowData data;
+			data.Title = name;
+			data.Width = 64;
+			data.Height = 64;
+			data.Centered = false;
+			data.Visible = false;
+			data.HasFocus = false;
+			data.EventFn = [](FakeEvent&) {};
+
+			Window = FakeWindow::Create(data);
+			if (!Window)
+				{
+				FAKE_LOG_WARN("There is no OpenGL window on this platform, the OpenGL run of %s is skipped!", name);
+				return false;
+				}
+
+			FakeRendererAPI::SetCurrent(FakeRendererAPIType::OpenGL);
+			FakeRendererAPI::Init();
+
+			const FakeRenderAPICapabilities &caps = FakeRendererAPI::GetCapabilities();
+			FAKE_LOG_INFO("OpenGL run of %s on %s, %s", name, *caps.Renderer, *caps.Version);
+
+			if (!caps.ComputeShaders)
+				{
+				FAKE_LOG_WARN("%s has no compute shaders, the OpenGL run of %s is skipped!", *caps.Renderer, name);
+				End();
+				return false;
+				}
+
+			return true;
+			}
+
+		static void End()
+			{
+			// Resources released by the run are deleted by queued commands, they need the context
+			FakeRenderer::Render();
+			glFinish();
+
+			FakeRendererAPI::Shutdown();
+			FakeRendererAPI::SetCurrent(FakeRendererAPIType::Null);
+			Window.reset();
+			}
+
+		/**
+		 *
+		 * Executes the queued commands, waits for the GPU and copies a part of a storage buffer.
+		 *
+		 */
+		static void ReadBuffer(const FakeRef<FakeStorageBuffer> &buffer, void *data, uint32 size, uint32 offset = 0)
+			{
+			FakeRenderer::Render();
+			glFinish();
+			glGetNamedBufferSubData(buffer->GetRendererID(), offset, size, data);
+			}
+	};
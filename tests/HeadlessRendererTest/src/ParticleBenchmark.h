@@ -0,0 +1,268 @@
+#pragma once
+
+#include "Benchmark.h"
+#include "OpenGLTestContext.h"
+
+class ParticleBenchmark
+	{
+	private:
+
+		static const uint32 GPUParticleCount = 1000000;
+		static const uint32 CPUParticleCount = 100000;
+		static const uint32 FrameCount = 60;
+
+		struct FrameCommands
+			{
+			uint32 Dispatches = 0;
+			uint32 IndirectDraws = 0;
+			uint32 InstancedDraws = 0;
+			uint32 Instances = 0;
+			uint32 Total = 0;
+			};
+
+		static FakeParticleEmitter CreateEmitter(uint32 maxParticles)
+			{
+			FakeParticleEmitter emitter;
+			emitter.MaxParticles = maxParticles;
+			emitter.EmissionRate = (float)maxParticles * 1.5f;
+			emitter.PositionVariance = FakeVec3f(0.5f, 0.0f, 0.5f);
+			emitter.Velocity = FakeVec3f(0.0f, 4.0f, 0.0f);
+			emitter.VelocityVariance = FakeVec3f(1.0f, 1.0f, 1.0f);
+			emitter.Acceleration = FakeVec3f(0.0f, -9.81f, 0.0f);
+			emitter.Drag = 0.1f;
+			emitter.LifeTime = 0.5f;
+			emitter.LifeTimeVariance = 0.25f;
+			return emitter;
+			}
+
+		static void DrawFrame(const FakeRef<FakeParticleSystem> &particles)
+			{
+			FakeMat4f view(1.0f);
+			FakeMat4f projection(1.0f);
+
+			FakeRef<FakeParticleSystem> system = particles;
+			system->Update(FakeTimeStep(1.0 / 60.0));
+			system->Draw(view, projection);
+			FakeRenderer::Render();
+			}
+
+		static FrameCommands RecordFrame(const FakeRef<FakeParticleSystem> &particles)
+			{
+			FakeRendererAPI::SetCurrent(FakeRendererAPIType::Recording);
+			FakeNullRendererAPI::ClearRecordedCommands();
+
+			DrawFrame(particles);
+
+			FrameCommands commands;
+			for (const FakeRecordedCommand &command : FakeNullRendererAPI::GetRecordedCommands())
+				{
+				commands.Total++;
+				if (command.Type == FakeRecordedCommandType::DispatchCompute)
+					{
+					commands.Dispatches++;
+					}
+				else if (command.Type == FakeRecordedCommandType::DrawIndexedIndirect)
+					{
+					commands.IndirectDraws++;
+					}
+				else if (command.Type == FakeRecordedCommandType::DrawIndexedInstanced)
+					{
+					commands.InstancedDraws++;
+					commands.Instances += command.Args[1];
+					}
+				}
+
+			FakeNullRendererAPI::ClearRecordedCommands();
+			FakeRendererAPI::SetCurrent(FakeRendererAPIType::Null);
+			return commands;
+			}
+
+		static void RunGPU()
+			{
+			FakeRef<FakeParticleSystem> particles = FakeRef<FakeParticleSystem>::Create(CreateEmitter(GPUParticleCount), FakeParticleSimulation::GPU);
+			if (particles->GetSimulation() != FakeParticleSimulation::GPU)
+				{
+				FAKE_LOG_ERROR("The null backend reports compute shaders, the GPU simulation was not used!");
+				return;
+				}
+
+			double milliseconds = Benchmark::Measure(FrameCount, [&]()
+				{
+				DrawFrame(particles);
+				});
+
+			// The null backend runs no shaders, the time is only what the CPU spends recording a frame of 1M particles
+			Benchmark::Report("Record a frame of 1M GPU particles", milliseconds);
+
+			// The commands of a frame do not depend on the particle count
+			FrameCommands large = RecordFrame(particles);
+
+			// The first frame of a system binds its objects, the second one is compared
+			FakeRef<FakeParticleSystem> small = FakeRef<FakeParticleSystem>::Create(CreateEmitter(1000), FakeParticleSimulation::GPU);
+			DrawFrame(small);
+			FrameCommands smallCommands = RecordFrame(small);
+
+			FAKE_LOG_INFO("GPU particles: %d dispatches, %d indirect draws and %d commands per frame", large.Dispatches, large.IndirectDraws, large.Total);
+
+			if (large.Dispatches != 4 || large.IndirectDraws != 1 || large.InstancedDraws != 0)
+				FAKE_LOG_ERROR("A GPU particle frame took %d dispatches and %d indirect draws, 4 and 1 expected!", large.Dispatches, large.IndirectDraws);
+			if (large.Total != smallCommands.Total)
+				FAKE_LOG_ERROR("1M particles took %d commands and 1000 particles %d, the count must not depend on the particles!", large.Total, smallCommands.Total);
+
+			// Without new particles the emission is skipped
+			FakeParticleEmitter emitter = particles->GetEmitter();
+			emitter.EmissionRate = 0.0f;
+			particles->SetEmitter(emitter);
+			if (RecordFrame(particles).Dispatches != 3)
+				FAKE_LOG_ERROR("A GPU particle frame without emission did not skip the emit dispatch!");
+			}
+
+		static void RunCPU()
+			{
+			FakeRef<FakeParticleSystem> particles = FakeRef<FakeParticleSystem>::Create(CreateEmitter(CPUParticleCount), FakeParticleSimulation::CPU);
+
+			// Fill the system until it emits as many particles as die
+			for (uint32 i = 0; i < 60; ++i)
+				particles->Update(FakeTimeStep(1.0 / 60.0));
+
+			double milliseconds = Benchmark::Measure(FrameCount, [&]()
+				{
+				DrawFrame(particles);
+				});
+
+			FakeParticleSystem::Statistics stats = particles->GetStats();
+			FAKE_LOG_INFO("CPU particles: %d alive, %d KB uploaded per frame", stats.AliveCount, stats.UploadedBytes / (FrameCount + 1) / 1024);
+			Benchmark::Report("Simulate 100k particles (CPU)", milliseconds);
+
+			if (!stats.AliveCount || stats.AliveCount > CPUParticleCount)
+				FAKE_LOG_ERROR("The CPU simulation has %d living particles, between 1 and %d expected!", stats.AliveCount, CPUParticleCount);
+
+			FrameCommands commands = RecordFrame(particles);
+			if (commands.InstancedDraws != 1 || commands.Dispatches != 0 || commands.Instances != particles->GetStats().AliveCount)
+				FAKE_LOG_ERROR("A CPU particle frame took %d instanced draws of %d instances, one draw of %d expected!", commands.InstancedDraws, commands.Instances, particles->GetStats().AliveCount);
+
+			// Without emission every particle dies within its life time
+			FakeParticleEmitter emitter = particles->GetEmitter();
+			emitter.EmissionRate = 0.0f;
+			particles->SetEmitter(emitter);
+			for (uint32 i = 0; i < 60; ++i)
+				particles->Update(FakeTimeStep(1.0 / 60.0));
+
+			if (particles->GetStats().AliveCount)
+				FAKE_LOG_ERROR("%d particles outlived their life time!", particles->GetStats().AliveCount);
+			}
+
+		static uint32 ReadAliveCount(const FakeRef<FakeParticleSystem> &particles)
+			{
+			FakeDrawIndexedIndirectCommand command;
+			OpenGLTestContext::ReadBuffer(particles->GetIndirectBuffer(), &command, sizeof(command), particles->GetIndirectCommandOffset());
+			return command.InstanceCount;
+			}
+
+		// Draws the particles into a small target and returns the center pixel, where all particles are
+		static uint32 CapturePixel(const FakeRef<FakeParticleSystem> &particles)
+			{
+			FakeFramebufferSpecification spec;
+			spec.Width = 64;
+			spec.Height = 64;
+			spec.ClearColor = FakeVec4f(0.0f, 0.0f, 0.0f, 0.0f);
+			spec.Attachments = { FakeFramebufferTextureFormat::RGBA8 };
+			FakeRef<FakeFramebuffer> framebuffer = FakeFramebuffer::Create(spec);
+
+			FakeRenderPassSpecification passSpec;
+			passSpec.TargetFramebuffer = framebuffer;
+			FakeRef<FakeRenderPass> pass = FakeRenderPass::Create(passSpec);
+
+			FakeRenderer::BeginRenderPass(pass);
+			particles->Draw(FakeMat4f(1.0f), FakeMat4f(1.0f));
+			FakeRenderer::EndRenderPass();
+
+			bool captured = false;
+			uint32 pixel = 0;
+			framebuffer->CaptureAsync(0, [&](const FakeFramebufferReadback &readback)
+				{
+				captured = true;
+				memcpy(&pixel, readback.Pixels + ((readback.Height / 2) * readback.Width + readback.Width / 2) * 4, sizeof(pixel));
+				});
+
+			for (uint32 i = 0; i < 4 && !captured; ++i)
+				FakeRenderer::Render();
+
+			if (!captured)
+				FAKE_LOG_ERROR("The capture of the particles never resolved!");
+
+			return pixel;
+			}
+
+		// Compiles and runs the simulation shader with Mesa's llvmpipe, the null backend never executes it
+		static void RunOpenGL()
+			{
+			if (!OpenGLTestContext::Begin("ParticleBenchmark"))
+				return;
+
+				{
+				// Without variances both simulations emit, move and kill exactly the same particles.
+				// The life time is no multiple of the time step, so no particle dies on a rounding decision.
+				FakeParticleEmitter emitter;
+				emitter.MaxParticles = 100000;
+				emitter.EmissionRate = 60000.0f;
+				emitter.LifeTime = 0.51f;
+				emitter.SizeBegin = 1.0f;
+				emitter.SizeEnd = 1.0f;
+				emitter.ColorEnd = FakeVec4f(1.0f, 1.0f, 1.0f, 1.0f);
+
+				FakeRef<FakeParticleSystem> gpu = FakeRef<FakeParticleSystem>::Create(emitter, FakeParticleSimulation::GPU);
+				FakeRef<FakeParticleSystem> cpu = FakeRef<FakeParticleSystem>::Create(emitter, FakeParticleSimulation::CPU);
+
+				for (uint32 i = 0; i < 45; ++i)
+					{
+					gpu->Update(FakeTimeStep(1.0 / 60.0));
+					cpu->Update(FakeTimeStep(1.0 / 60.0));
+					}
+
+				uint32 gpuAlive = ReadAliveCount(gpu);
+				uint32 cpuAlive = cpu->GetStats().AliveCount;
+				FAKE_LOG_INFO("OpenGL particles: %d alive on the GPU, %d on the CPU", gpuAlive, cpuAlive);
+
+				if (!cpuAlive || gpuAlive != cpuAlive)
+					FAKE_LOG_ERROR("The GPU simulation has %d living particles, the CPU simulation %d!", gpuAlive, cpuAlive);
+
+				// Every particle sits at the origin and covers the center of the target with full white
+				uint32 gpuPixel = CapturePixel(gpu);
+				uint32 cpuPixel = CapturePixel(cpu);
+				if (gpuPixel != 0xffffffff || cpuPixel != 0xffffffff)
+					FAKE_LOG_ERROR("The particles were not drawn, the center pixel is %08x on the GPU path and %08x on the CPU path!", gpuPixel, cpuPixel);
+
+				// Without emission every particle dies within its life time
+				emitter.EmissionRate = 0.0f;
+				gpu->SetEmitter(emitter);
+				for (uint32 i = 0; i < 31; ++i)
+					gpu->Update(FakeTimeStep(1.0 / 60.0));
+
+				if (uint32 alive = ReadAliveCount(gpu))
+					FAKE_LOG_ERROR("%d GPU particles outlived their life time!", alive);
+
+				// The time the GPU needs for the simulation, not only the recording
+				FakeRef<FakeParticleSystem> large = FakeRef<FakeParticleSystem>::Create(CreateEmitter(GPUParticleCount), FakeParticleSimulation::GPU);
+				double milliseconds = Benchmark::Measure(10, [&]()
+					{
+					large->Update(FakeTimeStep(1.0 / 60.0));
+					FakeRenderer::Render();
+					glFinish();
+					});
+
+				Benchmark::Report("Simulate 1M GPU particles (llvmpipe)", milliseconds);
+				}
+
+			OpenGLTestContext::End();
+			}
+
+	public:
+
+		static void Run()
+			{
+			RunGPU();
+			RunCPU();
+			RunOpenGL();
+			}
+	};
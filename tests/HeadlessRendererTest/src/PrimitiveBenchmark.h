@@ -0,0 +1,83 @@
+#pragma once
+
+#include "Benchmark.h"
+
+class PrimitiveBenchmark
+	{
+	private:
+
+		static const uint32 LineCount = 25000;
+		static const uint32 CircleCount = 10000;
+		static const uint32 RectCount = 5000;
+
+		static void DrawFrame()
+			{
+			FakeRenderer2D::BeginScene(FakeVec2f(1280.0f, 720.0f), false);
+
+			for (uint32 i = 0; i < LineCount; ++i)
+				{
+				const float x = (float)(i % 250) * 5.0f;
+				const float y = (float)(i / 250) * 7.0f;
+				FakeRenderer2D::DrawLine(FakeVec2f(x, y), FakeVec2f(x + 4.0f, y + 6.0f), FakeVec4f(1.0f, 1.0f, 1.0f, 1.0f), 1.5f);
+				}
+
+			for (uint32 i = 0; i < CircleCount; ++i)
+				FakeRenderer2D::DrawCircle(FakeVec2f((float)(i % 100) * 12.0f, (float)(i / 100) * 7.0f), 5.0f, FakeVec4f(0.25f, 0.5f, 1.0f, 1.0f), i % 2 ? 1.0f : 0.0f);
+
+			for (uint32 i = 0; i < RectCount; ++i)
+				FakeRenderer2D::DrawRoundedRect(FakeVec2f((float)(i % 50) * 25.0f, (float)(i / 50) * 7.0f), FakeVec2f(20.0f, 6.0f), 3.0f, FakeVec4f(1.0f, 0.5f, 0.25f, 1.0f));
+
+			FakeRenderer2D::EndScene();
+			}
+
+	public:
+
+		static void Run()
+			{
+			double milliseconds = Benchmark::Measure(30, [&]()
+				{
+				DrawFrame();
+				FakeRenderer::Render();
+				});
+
+			FakeRenderer2D::ResetStats();
+			FakeRendererAPI::SetCurrent(FakeRendererAPIType::Recording);
+			FakeNullRendererAPI::ClearRecordedCommands();
+
+			DrawFrame();
+			FakeRenderer::Render();
+
+			uint32 instancedDraws = 0;
+			uint32 otherDraws = 0;
+			uint32 instances = 0;
+			for (const FakeRecordedCommand &command : FakeNullRendererAPI::GetRecordedCommands())
+				{
+				if (command.Type == FakeRecordedCommandType::DrawIndexedInstanced)
+					{
+					instancedDraws++;
+					instances += command.Args[1];
+
+					// Every instance is expanded from the six indices of one quad
+					if (command.Args[0] != 6)
+						FAKE_LOG_ERROR("A primitive was drawn with %d indices instead of one quad!", command.Args[0]);
+					}
+				else if (command.Type == FakeRecordedCommandType::DrawIndexed)
+					{
+					otherDraws++;
+					}
+				}
+
+			FakeNullRendererAPI::ClearRecordedCommands();
+			FakeRendererAPI::SetCurrent(FakeRendererAPIType::Null);
+
+			FakeRenderer2D::Statistics stats = FakeRenderer2D::GetStats();
+			FAKE_LOG_INFO("Primitives: %d lines, %d circles and %d rounded rectangles in %d instanced draws", stats.LineCount, stats.CircleCount, stats.RectCount, instancedDraws);
+			Benchmark::Report("Draw 40000 SDF primitives", milliseconds);
+
+			// 10000 lines fit into one batch, the lines take three draws and only they flush early
+			if (instancedDraws != 5 || otherDraws != 0 || stats.DrawCalls != 5)
+				FAKE_LOG_ERROR("Primitives took %d instanced and %d other draws, 5 instanced draws expected!", instancedDraws, otherDraws);
+			if (instances != LineCount + CircleCount + RectCount)
+				FAKE_LOG_ERROR("Primitive draws covered %d instances, %d expected!", instances, LineCount + CircleCount + RectCount);
+			}
+	};
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "Benchmark.h"
+
+class ReadbackBenchmark
+	{
+	private:
+
+		static const uint32 FrameCount = 120;
+
+	public:
+
+		static void Run()
+			{
+			FakeFramebufferSpecification spec;
+			spec.Attachments = { FakeFramebufferTextureFormat::RGBA8, FakeFramebufferTextureFormat::RED_INTEGER, FakeFramebufferTextureFormat::DEPTH };
+			FakeRef<FakeFramebuffer> viewport = FakeFramebuffer::Create(spec);
+
+			uint32 picks = 0;
+			uint32 maxLatency = 0;
+			bool wrongSize = false;
+			std::vector<uint32> capturedFrames;
+
+			double milliseconds = Benchmark::Measure(FrameCount, [&]()
+				{
+				// Entity picking under the cursor and a video capture of every frame
+				viewport->ReadPixelAsync(1, 640, 360, [&](int32 entity)
+					{
+					++picks;
+					});
+
+				viewport->CaptureAsync(0, [&](const FakeFramebufferReadback &readback)
+					{
+					capturedFrames.push_back(readback.FrameIndex);
+					maxLatency = std::max(maxLatency, FakeRenderer::GetFrameIndex() - readback.FrameIndex);
+					wrongSize |= readback.Width != viewport->GetWidth() || readback.Height != viewport->GetHeight();
+					});
+
+				FakeRenderer::Render();
+				});
+
+			// The readbacks of the last frame resolve with the next one
+			FakeRenderer::Render();
+
+			FAKE_LOG_INFO("Readback: %d picks and %d captures resolved, at most %d frames late", picks, (uint32)capturedFrames.size(), maxLatency);
+			Benchmark::Report("Request pick and capture readbacks", milliseconds);
+
+			// Measure() runs one more time to warm up
+			if (picks != FrameCount + 1 || capturedFrames.size() != FrameCount + 1)
+				FAKE_LOG_ERROR("Readbacks were dropped!");
+
+			for (size_t i = 1; i < capturedFrames.size(); ++i)
+				{
+				if (capturedFrames[i] != capturedFrames[i - 1] + 1)
+					{
+					FAKE_LOG_ERROR("Captured frames are out of order or missing after frame %d!", capturedFrames[i - 1]);
+					break;
+					}
+				}
+
+			if (maxLatency == 0 || maxLatency > 2)
+				FAKE_LOG_ERROR("Readbacks resolved %d frames after they were requested!", maxLatency);
+			if (wrongSize)
+				FAKE_LOG_ERROR("Captures do not cover the whole framebuffer!");
+			}
+	};
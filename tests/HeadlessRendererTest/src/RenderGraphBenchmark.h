@@ -0,0 +1,161 @@
+#pragma once
+
+#include "Benchmark.h"
+
+class RenderGraphBenchmark
+	{
+	private:
+
+		struct Handles
+			{
+			FakeRenderGraphResource GBuffer;
+			FakeRenderGraphResource BloomA;
+			FakeRenderGraphResource BloomB;
+			FakeRenderGraphResource BloomC;
+			};
+
+		static FakeRenderGraphFramebufferDesc Desc(const FakeFramebufferAttachmentSpecification &attachments, float scale = 1.0f)
+			{
+			FakeRenderGraphFramebufferDesc desc;
+			desc.Attachments = attachments;
+			desc.Scale = scale;
+			return desc;
+			}
+
+		static Handles Build(FakeRenderGraph &graph, const FakeRef<FakeFramebuffer> &viewport, std::vector<FakeString> &executed)
+			{
+			Handles handles;
+			FakeRenderGraphResource shadowMap, hdr, ldr, output = graph.ImportFramebuffer("Viewport", viewport);
+
+			auto record = [&executed](const char *name)
+				{
+				return [&executed, name](const FakeRenderGraph&) { executed.push_back(name); };
+				};
+
+			graph.AddPass("GBuffer", [&](FakeRenderGraphBuilder &builder)
+				{
+				handles.GBuffer = builder.Create("GBuffer", Desc({ FakeFramebufferTextureFormat::RGBA16F, FakeFramebufferTextureFormat::RGBA16F, FakeFramebufferTextureFormat::RGBA8, FakeFramebufferTextureFormat::DEPTH }));
+				}, record("GBuffer"));
+
+			graph.AddPass("Shadows", [&](FakeRenderGraphBuilder &builder)
+				{
+				shadowMap = builder.Create("ShadowMap", Desc({ FakeFramebufferTextureFormat::DEPTH32F }));
+				}, record("Shadows"));
+
+			// Writes a view nothing reads, the graph has to cull it
+			graph.AddPass("Debug view", [&](FakeRenderGraphBuilder &builder)
+				{
+				builder.Read(handles.GBuffer);
+				builder.Create("DebugView", Desc({ FakeFramebufferTextureFormat::RGBA8 }));
+				}, record("Debug view"));
+
+			graph.AddPass("Lighting", [&](FakeRenderGraphBuilder &builder)
+				{
+				builder.Read(handles.GBuffer);
+				builder.Read(shadowMap);
+				hdr = builder.Create("HDR", Desc({ FakeFramebufferTextureFormat::RGBA16F }));
+				}, record("Lighting"));
+
+			graph.AddPass("Bloom threshold", [&](FakeRenderGraphBuilder &builder)
+				{
+				builder.Read(hdr);
+				handles.BloomA = builder.Create("BloomA", Desc({ FakeFramebufferTextureFormat::RGBA16F }, 0.5f));
+				}, record("Bloom threshold"));
+
+			graph.AddPass("Bloom blur horizontal", [&](FakeRenderGraphBuilder &builder)
+				{
+				builder.Read(handles.BloomA);
+				handles.BloomB = builder.Create("BloomB", Desc({ FakeFramebufferTextureFormat::RGBA16F }, 0.5f));
+				}, record("Bloom blur horizontal"));
+
+			graph.AddPass("Bloom blur vertical", [&](FakeRenderGraphBuilder &builder)
+				{
+				builder.Read(handles.BloomB);
+				handles.BloomC = builder.Create("BloomC", Desc({ FakeFramebufferTextureFormat::RGBA16F }, 0.5f));
+				}, record("Bloom blur vertical"));
+
+			graph.AddPass("Tonemap", [&](FakeRenderGraphBuilder &builder)
+				{
+				builder.Read(hdr);
+				builder.Read(handles.BloomC);
+				ldr = builder.Create("LDR", Desc({ FakeFramebufferTextureFormat::RGBA8 }));
+				}, record("Tonemap"));
+
+			graph.AddPass("Antialiasing", [&](FakeRenderGraphBuilder &builder)
+				{
+				builder.Read(ldr);
+				builder.Write(output);
+				}, record("Antialiasing"));
+
+			graph.AddPass("UI", [&](FakeRenderGraphBuilder &builder)
+				{
+				builder.Write(output);
+				}, record("UI"));
+
+			return handles;
+			}
+
+		static bool RunsBefore(const std::vector<FakeString> &executed, const char *first, const char *second)
+			{
+			auto a = std::find(executed.begin(), executed.end(), FakeString(first));
+			auto b = std::find(executed.begin(), executed.end(), FakeString(second));
+			return a != executed.end() && b != executed.end() && a < b;
+			}
+
+	public:
+
+		static void Run()
+			{
+			FakeFramebufferSpecification viewportSpec;
+			viewportSpec.Attachments = { FakeFramebufferTextureFormat::RGBA8 };
+			FakeRef<FakeFramebuffer> viewport = FakeFramebuffer::Create(viewportSpec);
+
+			std::vector<FakeString> executed;
+			FakeRef<FakeRenderGraph> graph = FakeRef<FakeRenderGraph>::Create();
+			Handles handles = Build(*graph, viewport, executed);
+
+			double executeTime = Benchmark::Measure(100, [&]()
+				{
+				executed.clear();
+				graph->Execute(1280, 720);
+				FakeRenderer::Render();
+				});
+
+			FakeRenderGraph::Statistics stats = graph->GetStats();
+			FAKE_LOG_INFO("Render graph: %d passes, %d culled, %d transient framebuffers in %d framebuffers", stats.PassCount, stats.CulledPassCount, stats.TransientCount, stats.FramebufferCount);
+			Benchmark::Report("Execute compiled render graph", executeTime);
+
+			if (stats.CompileCount != 1)
+				FAKE_LOG_ERROR("Render graph compiled %d times without a change!", stats.CompileCount);
+
+			if (!graph->IsCulled("Debug view") || stats.CulledPassCount != 1)
+				FAKE_LOG_ERROR("Render graph did not cull exactly the unused pass!");
+
+			if (!RunsBefore(executed, "GBuffer", "Lighting") || !RunsBefore(executed, "Shadows", "Lighting") || !RunsBefore(executed, "Bloom blur vertical", "Tonemap") || !RunsBefore(executed, "Antialiasing", "UI"))
+				FAKE_LOG_ERROR("Render graph executed passes before their inputs!");
+
+			// BloomC starts after BloomA is last read, BloomB is alive at the same time as both
+			if (graph->GetFramebuffer(handles.BloomA).Raw() != graph->GetFramebuffer(handles.BloomC).Raw())
+				FAKE_LOG_ERROR("Render graph did not alias framebuffers with disjoint lifetimes!");
+			if (graph->GetFramebuffer(handles.BloomA).Raw() == graph->GetFramebuffer(handles.BloomB).Raw())
+				FAKE_LOG_ERROR("Render graph aliased framebuffers with overlapping lifetimes!");
+
+			// A new resolution compiles again and only resizes the shared framebuffers
+			uint32 resolution = 0;
+			double compileTime = Benchmark::Measure(100, [&]()
+				{
+				++resolution;
+				graph->Execute(1280 + (resolution & 1), 720);
+				FakeRenderer::Render();
+				});
+
+			Benchmark::Report("Compile and execute render graph", compileTime);
+
+			graph->Execute(1920, 1080);
+			FakeRenderer::Render();
+			if (graph->GetFramebuffer(handles.BloomA)->GetWidth() != 960 || graph->GetFramebuffer(handles.GBuffer)->GetHeight() != 1080)
+				FAKE_LOG_ERROR("Render graph did not resize its framebuffers!");
+			if (graph->GetStats().FramebufferCount != stats.FramebufferCount)
+				FAKE_LOG_ERROR("Render graph allocated new framebuffers for a resize!");
+			}
+	};
@@ -0,0 +1,122 @@
+#pragma once
+
+#include "Benchmark.h"
+
+class TextBenchmark
+	{
+	private:
+
+		static const uint32 LineCount = 40;
+		static const uint32 FrameCount = 100;
+
+		// A monospaced font with the printable ASCII glyphs in a 16 x 6 grid of the atlas
+		static FakeRef<FakeFont> CreateFont()
+			{
+			FakeFontMetrics metrics;
+			metrics.LineHeight = 1.2f;
+			metrics.Ascender = 0.9f;
+			metrics.Descender = -0.25f;
+			metrics.DistanceRange = 4.0f;
+
+			FakeRef<FakeFont> font = FakeRef<FakeFont>::Create(FakeTexture2D::Create(FakeTextureFormat::RGBA, 256, 256), metrics);
+			for (uint32 codepoint = 32; codepoint < 127; ++codepoint)
+				{
+				FakeFontGlyph glyph;
+				glyph.Advance = 0.55f;
+
+				if (codepoint != ' ')
+					{
+					const uint32 cell = codepoint - 32;
+					glyph.PlaneLeft = 0.05f;
+					glyph.PlaneBottom = -0.1f;
+					glyph.PlaneRight = 0.5f;
+					glyph.PlaneTop = 0.7f;
+					glyph.AtlasLeft = (float)(cell % 16) / 16.0f;
+					glyph.AtlasBottom = (float)(cell / 16) / 6.0f;
+					glyph.AtlasRight = glyph.AtlasLeft + 1.0f / 16.0f;
+					glyph.AtlasTop = glyph.AtlasBottom + 1.0f / 6.0f;
+					}
+
+				font->AddGlyph(codepoint, glyph);
+				}
+
+			font->AddKerning('A', 'V', -0.1f);
+			return font;
+			}
+
+	public:
+
+		static void Run()
+			{
+			FakeRef<FakeFont> font = CreateFont();
+
+			FakeTextLayout kerned, plain, fallback;
+			font->Layout("AV", kerned);
+			font->Layout("AX", plain);
+			font->Layout("\xc3\xa9 \n?", fallback);
+
+			if (std::abs(plain.Width - kerned.Width - 0.1f) > 0.0001f)
+				FAKE_LOG_ERROR("Kerning did not move the glyphs of \"AV\" closer together!");
+			if (fallback.Glyphs.size() != 2 || std::abs(fallback.Height - 2.4f) > 0.0001f)
+				FAKE_LOG_ERROR("Missing glyphs, spaces or line breaks were laid out wrong!");
+
+			std::vector<FakeString> lines;
+			uint32 glyphsPerFrame = 0;
+			for (uint32 i = 0; i < LineCount; ++i)
+				{
+				FakeString line = "Line ";
+				line << i;
+				line += ": The quick brown fox jumps over the lazy dog, SPHINX OF BLACK QUARTZ JUDGE MY VOW";
+				lines.push_back(line);
+
+				for (uint32 c = 0; c < line.Length(); ++c)
+					glyphsPerFrame += line[c] != ' ' ? 1 : 0;
+				}
+
+			auto drawFrame = [&]()
+				{
+				FakeRenderer2D::BeginScene(FakeVec2f(1280.0f, 720.0f), false);
+				for (uint32 i = 0; i < LineCount; ++i)
+					{
+					FakeMat4f transform;
+					FakeMat4f::Translate(10.0f, 16.0f + (float)i * 17.0f, 0.0f, transform);
+					transform.M11 = 14.0f;
+					transform.M22 = -14.0f;
+					FakeRenderer2D::DrawString(lines[i], font, transform, FakeVec4f(1.0f, 1.0f, 1.0f, 1.0f));
+					}
+				FakeRenderer2D::EndScene();
+				FakeRenderer::Render();
+				};
+
+			// The first frame lays out the strings, the following ones find them in the cache
+			drawFrame();
+			FakeRenderer2D::ResetStats();
+
+			double milliseconds = Benchmark::Measure(FrameCount, drawFrame);
+			FakeRenderer2D::Statistics stats = FakeRenderer2D::GetStats();
+
+			// Measure() runs one more time to warm up
+			FAKE_LOG_INFO("Text: %d glyphs per frame, %d draw calls and %d layouts in %d frames", glyphsPerFrame, stats.DrawCalls, stats.TextLayoutCount, FrameCount + 1);
+			Benchmark::Report("Draw 40 lines of cached text", milliseconds);
+
+			if (stats.DrawCalls != FrameCount + 1)
+				FAKE_LOG_ERROR("Text took %d draw calls in %d frames, one per frame expected!", stats.DrawCalls, FrameCount + 1);
+			if (stats.GlyphCount != glyphsPerFrame * (FrameCount + 1))
+				FAKE_LOG_ERROR("Text drew %d glyphs, %d expected!", stats.GlyphCount, glyphsPerFrame * (FrameCount + 1));
+			if (stats.TextLayoutCount)
+				FAKE_LOG_ERROR("Unchanged strings were laid out again!");
+
+			// Each font has its own atlas, switching fonts starts a new batch
+			FakeRef<FakeFont> otherFont = CreateFont();
+			FakeRenderer2D::ResetStats();
+			FakeRenderer2D::BeginScene(FakeVec2f(1280.0f, 720.0f), false);
+			FakeRenderer2D::DrawString(lines[0], font, FakeMat4f(1.0f));
+			FakeRenderer2D::DrawString(lines[1], font, FakeMat4f(1.0f));
+			FakeRenderer2D::DrawString(lines[0], otherFont, FakeMat4f(1.0f));
+			FakeRenderer2D::EndScene();
+			FakeRenderer::Render();
+
+			if (FakeRenderer2D::GetStats().DrawCalls != 2 || FakeRenderer2D::GetStats().TextLayoutCount != 1)
+				FAKE_LOG_ERROR("Text of two fonts was not drawn in two batches!");
+			}
+	};
@@ -0,0 +1,167 @@
+#pragma once
+
+#ifdef FAKE_RENDERER_VULKAN
+
+#include "Benchmark.h"
+
+#include "Engine/Platform/Vulkan/FakeVulkanContext.h"
+#include "Engine/Platform/Vulkan/FakeVulkanRendererAPI.h"
+
+class VulkanBenchmark
+	{
+	private:
+
+		static const uint32 PassCount = 4;
+		static const uint32 DrawsPerPass = 2500;
+		static const uint32 FrameCount = 30;
+
+		static constexpr const char *ShaderSource = R"(
+#type vertex
+#version 450 core
+
+layout(location = 0) in vec2 a_Position;
+
+uniform vec2 u_Offset;
+uniform float u_Scale;
+
+void main()
+	{
+	gl_Position = vec4(a_Position * u_Scale + u_Offset, 0.0, 1.0);
+	}
+
+#type fragment
+#version 450 core
+
+layout(location = 0) out vec4 o_Color;
+
+uniform vec4 u_Color;
+
+void main()
+	{
+	o_Color = u_Color;
+	}
+)";
+
+		static void DrawFrame(const FakeRef<FakeRenderPass> *passes, const FakeRef<FakeShader> &shader, const FakeRef<FakePipeline> &pipeline, const FakeRef<FakeVertexBuffer> &vertexBuffer, const FakeRef<FakeIndexBuffer> &indexBuffer)
+			{
+			for (uint32 p = 0; p < PassCount; ++p)
+				{
+				FakeRenderer::BeginRenderPass(passes[p]);
+				shader->Bind();
+				vertexBuffer->Bind();
+				pipeline->Bind();
+				indexBuffer->Bind();
+
+				for (uint32 i = 0; i < DrawsPerPass; ++i)
+					{
+					shader->SetUniform("u_Offset", FakeVec2f((float)(i % 50) / 25.0f - 1.0f, (float)(i / 50) / 25.0f - 1.0f));
+					shader->SetUniform("u_Scale", 0.02f);
+					shader->SetUniform("u_Color", FakeVec4f((float)p / PassCount, (float)i / DrawsPerPass, 0.0f, 1.0f));
+					FakeRenderer::DrawIndexed(6, FakePrimitiveType::Triangles, false);
+					}
+
+				// The last draw covers the whole target, so a capture knows what to expect
+				shader->SetUniform("u_Offset", FakeVec2f(0.0f, 0.0f));
+				shader->SetUniform("u_Scale", 1.0f);
+				shader->SetUniform("u_Color", FakeVec4f(1.0f, 0.0f, 1.0f, 1.0f));
+				FakeRenderer::DrawIndexed(6, FakePrimitiveType::Triangles, false);
+
+				FakeRenderer::EndRenderPass();
+				}
+			}
+
+	public:
+
+		static void Run()
+			{
+			// Lavapipe or SwiftShader are enough, without any device the test is skipped
+			if (!FakeVulkanContext::IsSupported())
+				{
+				FAKE_LOG_WARN("There is no Vulkan device, the Vulkan benchmark is skipped!");
+				return;
+				}
+
+			FakeRendererAPI::SetCurrent(FakeRendererAPIType::Vulkan);
+			FakeRendererAPI::Init();
+
+				{
+				FakeRef<FakeShader> shader = FakeShader::CreateFromSource("VulkanBenchmark", ShaderSource);
+
+				FakeVec2f corners[4] = { { -1.0f, -1.0f }, { 1.0f, -1.0f }, { 1.0f, 1.0f }, { -1.0f, 1.0f } };
+				uint32 indices[6] = { 0, 1, 2, 2, 3, 0 };
+				FakeRef<FakeVertexBuffer> vertexBuffer = FakeVertexBuffer::Create(corners, sizeof(corners));
+				FakeRef<FakeIndexBuffer> indexBuffer = FakeIndexBuffer::Create(indices, sizeof(indices));
+
+				FakePipelineSpecification pipelineSpec;
+				pipelineSpec.Layout = {
+					{ FakeShaderDataType::Float2, "a_Position" }
+				};
+				pipelineSpec.Shader = shader;
+				pipelineSpec.VertexBuffer = vertexBuffer;
+				pipelineSpec.IndexBuffer = indexBuffer;
+				FakeRef<FakePipeline> pipeline = FakePipeline::Create(pipelineSpec);
+
+				FakeRef<FakeFramebuffer> framebuffers[PassCount];
+				FakeRef<FakeRenderPass> passes[PassCount];
+				for (uint32 p = 0; p < PassCount; ++p)
+					{
+					FakeFramebufferSpecification spec;
+					spec.Width = 256;
+					spec.Height = 256;
+					spec.Attachments = { FakeFramebufferTextureFormat::RGBA8, FakeFramebufferTextureFormat::DEPTH };
+					framebuffers[p] = FakeFramebuffer::Create(spec);
+
+					FakeRenderPassSpecification passSpec;
+					passSpec.TargetFramebuffer = framebuffers[p];
+					passes[p] = FakeRenderPass::Create(passSpec);
+					}
+
+				double milliseconds = Benchmark::Measure(FrameCount, [&]()
+					{
+					DrawFrame(passes, shader, pipeline, vertexBuffer, indexBuffer);
+					FakeRenderer::Render();
+					});
+
+				const FakeVulkanRendererAPI::Statistics &stats = FakeVulkanRendererAPI::GetFrameStats();
+				FAKE_LOG_INFO("Vulkan: %d draws in %d passes, %d secondary command buffers recorded by %d threads in %f ms",
+					stats.Draws, stats.Passes, stats.SecondaryCommandBuffers, stats.RecordingThreads, stats.RecordMilliseconds);
+				Benchmark::Report("Record and submit 10k Vulkan draws", milliseconds);
+
+				if (stats.Passes != PassCount || stats.Draws != PassCount * (DrawsPerPass + 1))
+					FAKE_LOG_ERROR("The frame had %d draws in %d passes, %d in %d expected!", stats.Draws, stats.Passes, PassCount * (DrawsPerPass + 1), PassCount);
+				if (stats.SecondaryCommandBuffers < PassCount)
+					FAKE_LOG_ERROR("The passes were recorded into %d secondary command buffers, at least one per pass expected!", stats.SecondaryCommandBuffers);
+
+				DrawFrame(passes, shader, pipeline, vertexBuffer, indexBuffer);
+
+				bool captured = false;
+				uint32 wrongPixels = 0;
+				framebuffers[PassCount - 1]->CaptureAsync(0, [&](const FakeFramebufferReadback &readback)
+					{
+					captured = true;
+					for (uint32 i = 0; i < readback.Width * readback.Height; ++i)
+						{
+						const Byte *pixel = readback.Pixels + i * 4;
+						if (pixel[0] != 0xff || pixel[1] != 0x00 || pixel[2] != 0xff)
+							++wrongPixels;
+						}
+					});
+
+				FakeRenderer::Render();
+
+				// The frames in flight have to finish before the capture resolves
+				for (uint32 i = 0; i <= FakeVulkanRendererAPI::FramesInFlight && !captured; ++i)
+					FakeRenderer::Render();
+
+				if (!captured)
+					FAKE_LOG_ERROR("The capture of the Vulkan framebuffer never resolved!");
+				if (wrongPixels)
+					FAKE_LOG_ERROR("%d pixels of the Vulkan framebuffer do not have the color of the last draw!", wrongPixels);
+				}
+
+			FakeRendererAPI::Shutdown();
+			FakeRendererAPI::SetCurrent(FakeRendererAPIType::Null);
+			}
+	};
+
+#endif
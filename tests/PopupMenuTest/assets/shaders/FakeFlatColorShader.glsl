@@ -1,28 +0,0 @@
-#type vertex
-#version 450 core
-
-layout(location = 0) in vec3 a_Position;
-
-uniform mat4 u_ViewProjection;
-uniform mat4 u_Transform;
-uniform vec4 u_Color;
-
-out vec4 v_Color;
-
-void main()
-	{
-	v_Color = u_Color;
-	gl_Position = u_ViewProjection * u_Transform * vec4(a_Position, 1.0);
-	}
-
-#type fragment
-#version 450 core
-
-layout(location = 0) out vec4 Color;
-
-in vec4 v_Color;
-
-void main()
-	{
-	Color = v_Color;
-	}
\ No newline at end of file
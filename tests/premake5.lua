@@ -2,4 +2,5 @@ include "FileMenuTest/"
 include "PopupMenuTest/"
 include "ClientTest/"
 include "ServerTest/"
-
+include "BenchmarkTest/"
+include "HeadlessRendererTest/"